@@ -0,0 +1,109 @@
+# Copyright 2018-2019 Dynatrace LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+SET(OPENKIT_BENCHMARK_RESPONSE_PARSING_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/ResponseParsingBenchmark.cxx
+)
+
+SET(OPENKIT_BENCHMARK_BEACON_SENDING_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/BeaconSendingConcurrencyBenchmark.cxx
+)
+
+SET(OPENKIT_BENCHMARK_NEW_SESSION_REQUEST_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/NewSessionRequestBenchmark.cxx
+)
+
+SET(OPENKIT_BENCHMARK_CHUNK_PIPELINING_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/ChunkPipeliningBenchmark.cxx
+)
+
+SET(OPENKIT_BENCHMARK_INGESTION_LATENCY_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/IngestionLatencyBenchmark.cxx
+)
+
+SET(OPENKIT_BENCHMARK_ALLOCATIONS_PER_ACTION_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/AllocationsPerActionBenchmark.cxx
+)
+
+SET(OPENKIT_BENCHMARK_CAPTURE_OFF_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/CaptureOffBenchmark.cxx
+)
+
+SET(OPENKIT_BENCHMARK_WEB_REQUEST_TAGGING_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/src/WebRequestTaggingBenchmark.cxx
+)
+
+include(CompilerConfiguration)
+fix_compiler_flags()
+
+function(_build_benchmark_internal target)
+    find_package(ZLIB)
+    find_package(CURL)
+
+    # benchmarks measure OpenKit internals, which are only accessible when linking the static library
+    set(BENCHMARK_INCLUDE_DIRS
+        ${ZLIB_INCLUDE_DIR}
+        ${CURL_INCLUDE_DIR}
+        ${OpenKit_SOURCE_DIR}/include
+        ${OpenKit_SOURCE_DIR}/src
+        ${OpenKit_BINARY_DIR}/include
+    )
+
+    set(BENCHMARK_LIBS
+        OpenKit
+        ${ZLIB_LIBRARY}
+        ${CURL_LIBRARY}
+    )
+
+    include(CompilerConfiguration)
+    include(BuildFunctions)
+
+    open_kit_build_executable("${target}" "${BENCHMARK_INCLUDE_DIRS}" "${BENCHMARK_LIBS}" ${ARGN})
+    enforce_cxx11_standard("${target}")
+    target_compile_definitions(${target} PRIVATE -DCURL_STATICLIB -DOPENKIT_STATIC_DEFINE)
+    set_target_properties(${target} PROPERTIES FOLDER Benchmarks)
+endfunction()
+
+function(build_open_kit_benchmarks)
+    if (BUILD_SHARED_LIBS)
+        message(INFO "OpenKit is built as shared library - skip building OpenKit benchmarks...")
+        return()
+    endif()
+
+    message("Configuring OpenKit  benchmarks... ")
+
+    _build_benchmark_internal(openkit-benchmark-response-parsing ${OPENKIT_BENCHMARK_RESPONSE_PARSING_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_RESPONSE_PARSING_SOURCES})
+
+    _build_benchmark_internal(openkit-benchmark-beacon-sending ${OPENKIT_BENCHMARK_BEACON_SENDING_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_BEACON_SENDING_SOURCES})
+
+    _build_benchmark_internal(openkit-benchmark-new-session-requests ${OPENKIT_BENCHMARK_NEW_SESSION_REQUEST_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_NEW_SESSION_REQUEST_SOURCES})
+
+    _build_benchmark_internal(openkit-benchmark-chunk-pipelining ${OPENKIT_BENCHMARK_CHUNK_PIPELINING_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_CHUNK_PIPELINING_SOURCES})
+
+    _build_benchmark_internal(openkit-benchmark-ingestion-latency ${OPENKIT_BENCHMARK_INGESTION_LATENCY_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_INGESTION_LATENCY_SOURCES})
+
+    _build_benchmark_internal(openkit-benchmark-allocations-per-action ${OPENKIT_BENCHMARK_ALLOCATIONS_PER_ACTION_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_ALLOCATIONS_PER_ACTION_SOURCES})
+
+    _build_benchmark_internal(openkit-benchmark-capture-off ${OPENKIT_BENCHMARK_CAPTURE_OFF_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_CAPTURE_OFF_SOURCES})
+
+    _build_benchmark_internal(openkit-benchmark-web-request-tagging ${OPENKIT_BENCHMARK_WEB_REQUEST_TAGGING_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_BENCHMARK_WEB_REQUEST_TAGGING_SOURCES})
+endfunction()
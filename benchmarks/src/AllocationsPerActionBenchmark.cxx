@@ -0,0 +1,141 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "caching/BeaconCache.h"
+#include "configuration/BeaconCacheConfiguration.h"
+#include "configuration/BeaconConfiguration.h"
+#include "configuration/Configuration.h"
+#include "configuration/Device.h"
+#include "core/BeaconSender.h"
+#include "core/Session.h"
+#include "core/util/DefaultLogger.h"
+#include "protocol/Beacon.h"
+#include "protocol/ssl/SSLStrictTrustManager.h"
+#include "providers/DefaultHTTPClientProvider.h"
+#include "providers/DefaultSessionIDProvider.h"
+#include "providers/DefaultThreadIDProvider.h"
+#include "providers/DefaultTimingProvider.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+
+///
+/// Counts the heap allocations of the lifecycle of one root action with a child action, entering and leaving both,
+/// optionally with a web request traced and stopped on the child action.
+/// The first pass warms up the session's arena, the figures are taken from the second pass.
+///
+/// Usage: openkit-benchmark-allocations-per-action [number of actions]
+///
+
+static std::atomic<uint64_t> gNumAllocations(0);
+
+void* operator new(std::size_t size)
+{
+	gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+	auto pointer = std::malloc(size == 0 ? 1 : size);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+static std::shared_ptr<configuration::Configuration> createConfiguration()
+{
+	auto device = std::make_shared<configuration::Device>("", "", "");
+	auto beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1);
+	auto beaconConfiguration = std::make_shared<configuration::BeaconConfiguration>();
+
+	return std::make_shared<configuration::Configuration>(device, configuration::OpenKitType::Type::DYNATRACE,
+		"benchmark", "", "benchmark", 1, "1", "http://localhost", std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(), beaconCacheConfiguration, beaconConfiguration);
+}
+
+static void runActions(std::shared_ptr<core::Session> session, int32_t numActions, bool withWebRequest)
+{
+	for (int32_t i = 0; i < numActions; i++)
+	{
+		auto rootAction = session->enterAction("root action");
+		auto childAction = rootAction->enterAction("child action");
+		if (withWebRequest)
+		{
+			childAction->traceWebRequest("https://www.example.com/api")->stop(200);
+		}
+		childAction->leaveAction();
+		rootAction->leaveAction();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int32_t numActions = 100000;
+	if (argc > 1)
+	{
+		numActions = std::atoi(argv[1]);
+	}
+	if (numActions <= 0)
+	{
+		std::cout << "number of actions must be positive" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> logger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_ERROR);
+	auto threadIDProvider = std::make_shared<providers::DefaultThreadIDProvider>();
+	auto timingProvider = std::make_shared<providers::DefaultTimingProvider>();
+
+	std::cout << numActions << " root actions, each with a child action" << std::endl;
+	for (auto captureOn : { false, true })
+	for (auto withWebRequest : { false, true })
+	{
+		auto configuration = createConfiguration();
+		if (captureOn)
+		{
+			configuration->enableCapture();
+		}
+		auto beaconSender = std::make_shared<core::BeaconSender>(logger, configuration, std::make_shared<providers::DefaultHTTPClientProvider>(), timingProvider);
+		auto beaconCache = std::make_shared<caching::BeaconCache>(logger);
+		auto beacon = std::make_shared<protocol::Beacon>(logger, beaconCache, configuration, "127.0.0.1", threadIDProvider, timingProvider);
+		auto session = std::make_shared<core::Session>(logger, beaconSender, beacon);
+
+		runActions(session, numActions, withWebRequest);
+		beaconCache->deleteCacheEntry(beacon->getSessionNumber());
+
+		auto numAllocations = gNumAllocations.load();
+		auto start = std::chrono::steady_clock::now();
+		runActions(session, numActions, withWebRequest);
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		numAllocations = gNumAllocations.load() - numAllocations;
+
+		std::cout << (captureOn ? "capture on, " : "capture off,") << (withWebRequest ? " with web request:   " : " without web request:")
+			<< " allocations per action: " << static_cast<double>(numAllocations) / numActions
+			<< " time per action: " << elapsed / numActions << " ns"
+			<< " arena chunks: " << session->getObjectArena()->getNumChunks() << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "OpenKit/DynatraceOpenKitBuilder.h"
+#include "OpenKit/IOpenKit.h"
+#include "OpenKit/IRootAction.h"
+#include "OpenKit/ISession.h"
+
+#include "../../test/protocol/LocalHTTPServer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+///
+/// Measures how long it takes to drain the beacons of many finished sessions to a collector
+/// which responds with a fixed delay, once for each number of beacon sending worker threads.
+///
+/// Usage: openkit-benchmark-beacon-sending [sessions] [response delay in ms]
+///
+
+static const char RESPONSE_BODY[] = "type=m&si=120&id=1&cp=1";
+
+static size_t countRequests(test::LocalHTTPServer& server, bool withBody)
+{
+	size_t numRequests = 0;
+	for (auto& request : server.getRequests())
+	{
+		if (request.body.empty() != withBody)
+		{
+			numRequests++;
+		}
+	}
+	return numRequests;
+}
+
+static bool waitForRequests(test::LocalHTTPServer& server, bool withBody, size_t numRequests, int64_t timeoutMillis)
+{
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMillis);
+	while (countRequests(server, withBody) < numRequests)
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+static int64_t measureDrainTime(int32_t numThreads, int32_t numSessions, int64_t responseDelay)
+{
+	test::LocalHTTPServer server;
+	if (!server.start())
+	{
+		return -1;
+	}
+	server.setResponse(200, RESPONSE_BODY);
+	server.setResponseDelay(responseDelay);
+
+	auto openKit = openkit::DynatraceOpenKitBuilder(server.getBaseURL().c_str(), "benchmark", 1)
+		.withLogLevel(openkit::LogLevel::LOG_LEVEL_WARN)
+		.withBeaconSendingConcurrency(numThreads)
+		.build();
+	openKit->waitForInitCompletion();
+
+	std::vector<std::shared_ptr<openkit::ISession>> sessions;
+	for (int32_t i = 0; i < numSessions; i++)
+	{
+		auto session = openKit->createSession("127.0.0.1");
+		session->enterAction("action")->reportValue("index", i)->leaveAction();
+		sessions.push_back(session);
+	}
+
+	// wait until all sessions are configured, new session requests are not delayed
+	// the initial status request is sent without body as well
+	waitForRequests(server, false, static_cast<size_t>(numSessions) + 1, 30000);
+
+	auto start = std::chrono::steady_clock::now();
+	for (auto& session : sessions)
+	{
+		session->end();
+	}
+	auto drained = waitForRequests(server, true, static_cast<size_t>(numSessions), 600000);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	openKit->shutdown();
+	server.stop();
+
+	return drained ? elapsed : -1;
+}
+
+int main(int argc, char** argv)
+{
+	int32_t numSessions = 64;
+	int64_t responseDelay = 50;
+	if (argc > 1)
+	{
+		numSessions = static_cast<int32_t>(std::strtol(argv[1], nullptr, 10));
+	}
+	if (argc > 2)
+	{
+		responseDelay = std::strtoll(argv[2], nullptr, 10);
+	}
+
+	std::cout << "draining " << numSessions << " sessions, collector response delay " << responseDelay << " ms" << std::endl;
+	for (auto numThreads : { 1, 2, 4, 8 })
+	{
+		auto drainTime = measureDrainTime(numThreads, numSessions, responseDelay);
+		if (drainTime < 0)
+		{
+			std::cout << "workers: " << numThreads << " failed to drain all sessions" << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::cout << "workers: " << numThreads << " drain time: " << drainTime << " ms" << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
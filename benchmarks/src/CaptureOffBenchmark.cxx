@@ -0,0 +1,150 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "caching/BeaconCache.h"
+#include "configuration/BeaconCacheConfiguration.h"
+#include "configuration/BeaconConfiguration.h"
+#include "configuration/Configuration.h"
+#include "configuration/Device.h"
+#include "core/BeaconSender.h"
+#include "core/Session.h"
+#include "core/util/DefaultLogger.h"
+#include "protocol/Beacon.h"
+#include "protocol/ssl/SSLStrictTrustManager.h"
+#include "providers/DefaultHTTPClientProvider.h"
+#include "providers/DefaultSessionIDProvider.h"
+#include "providers/DefaultThreadIDProvider.h"
+#include "providers/DefaultTimingProvider.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+
+///
+/// Measures the cost of the public API while nothing is captured, because the server turned capturing off or the
+/// data collection level is OFF, compared to capturing. Each call enters a root action, reports an event and a value,
+/// traces a web request and leaves the action again.
+///
+/// Usage: openkit-benchmark-capture-off [number of calls]
+///
+
+static std::atomic<uint64_t> gNumAllocations(0);
+
+void* operator new(std::size_t size)
+{
+	gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+	auto pointer = std::malloc(size == 0 ? 1 : size);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+static std::shared_ptr<configuration::Configuration> createConfiguration(openkit::DataCollectionLevel dataCollectionLevel)
+{
+	auto device = std::make_shared<configuration::Device>("", "", "");
+	auto beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1);
+	auto beaconConfiguration = std::make_shared<configuration::BeaconConfiguration>(configuration::BeaconConfiguration::DEFAULT_MULTIPLICITY,
+		dataCollectionLevel, openkit::CrashReportingLevel::OFF);
+
+	return std::make_shared<configuration::Configuration>(device, configuration::OpenKitType::Type::DYNATRACE,
+		"benchmark", "", "benchmark", 1, "1", "http://localhost", std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(), beaconCacheConfiguration, beaconConfiguration);
+}
+
+static void runCalls(std::shared_ptr<core::Session> session, int32_t numCalls)
+{
+	for (int32_t i = 0; i < numCalls; i++)
+	{
+		auto rootAction = session->enterAction("root action");
+		rootAction->reportEvent("event");
+		rootAction->reportValue("value", i);
+		rootAction->traceWebRequest("https://www.example.com/api")->stop(200);
+		rootAction->leaveAction();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int32_t numCalls = 100000;
+	if (argc > 1)
+	{
+		numCalls = std::atoi(argv[1]);
+	}
+	if (numCalls <= 0)
+	{
+		std::cout << "number of calls must be positive" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> logger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_ERROR);
+	auto threadIDProvider = std::make_shared<providers::DefaultThreadIDProvider>();
+	auto timingProvider = std::make_shared<providers::DefaultTimingProvider>();
+
+	struct Scenario
+	{
+		const char* name;
+		bool capture;
+		openkit::DataCollectionLevel dataCollectionLevel;
+	};
+	const Scenario scenarios[] = {
+		{ "capture on:          ", true, openkit::DataCollectionLevel::USER_BEHAVIOR },
+		{ "capture off:         ", false, openkit::DataCollectionLevel::USER_BEHAVIOR },
+		{ "data collection off: ", true, openkit::DataCollectionLevel::OFF },
+	};
+
+	std::cout << numCalls << " calls, each entering an action, reporting an event, a value and a web request" << std::endl;
+	for (const auto& scenario : scenarios)
+	{
+		auto configuration = createConfiguration(scenario.dataCollectionLevel);
+		if (scenario.capture)
+		{
+			configuration->enableCapture();
+		}
+		else
+		{
+			configuration->disableCapture();
+		}
+		auto beaconSender = std::make_shared<core::BeaconSender>(logger, configuration, std::make_shared<providers::DefaultHTTPClientProvider>(), timingProvider);
+		auto beaconCache = std::make_shared<caching::BeaconCache>(logger);
+		auto beacon = std::make_shared<protocol::Beacon>(logger, beaconCache, configuration, "127.0.0.1", threadIDProvider, timingProvider);
+		auto session = std::make_shared<core::Session>(logger, beaconSender, beacon);
+
+		auto numAllocations = gNumAllocations.load();
+		auto start = std::chrono::steady_clock::now();
+		runCalls(session, numCalls);
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		numAllocations = gNumAllocations.load() - numAllocations;
+
+		std::cout << scenario.name
+			<< " time per call: " << elapsed / numCalls << " ns"
+			<< " allocations per call: " << static_cast<double>(numAllocations) / numCalls << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "caching/BeaconCache.h"
+#include "configuration/BeaconCacheConfiguration.h"
+#include "configuration/BeaconConfiguration.h"
+#include "configuration/Configuration.h"
+#include "configuration/Device.h"
+#include "core/util/DefaultLogger.h"
+#include "protocol/Beacon.h"
+#include "protocol/BeaconProtocolConstants.h"
+#include "protocol/HTTPClient.h"
+#include "providers/DefaultHTTPClientProvider.h"
+#include "providers/DefaultSessionIDProvider.h"
+#include "providers/DefaultThreadIDProvider.h"
+#include "providers/DefaultTimingProvider.h"
+#include "protocol/ssl/SSLBlindTrustManager.h"
+
+#include "../../test/protocol/LocalHTTPServer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+///
+/// Measures the throughput of sending the beacon of a single session, which needs many chunks, to a collector
+/// which responds with a fixed delay. The pipelined Beacon::send, which assembles and compresses the next chunk
+/// while the current one is in flight, is compared with building, compressing and sending one chunk after the other.
+///
+/// Usage: openkit-benchmark-chunk-pipelining [beacon size in KiB] [response delay in ms]
+///
+
+static const char RESPONSE_BODY[] = "type=m&si=120&id=1&cp=1";
+
+static std::shared_ptr<configuration::Configuration> createConfiguration(const std::string& baseURL)
+{
+	auto device = std::make_shared<configuration::Device>("", "", "");
+	auto beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1);
+	auto beaconConfiguration = std::make_shared<configuration::BeaconConfiguration>();
+
+	auto configuration = std::make_shared<configuration::Configuration>(device, configuration::OpenKitType::Type::DYNATRACE,
+		"benchmark", "", "benchmark", 1, "1", baseURL.c_str(), std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLBlindTrustManager>(), beaconCacheConfiguration, beaconConfiguration);
+	configuration->enableCapture();
+
+	return configuration;
+}
+
+static void fillBeacon(protocol::Beacon& beacon, int64_t beaconSize)
+{
+	int64_t numBytes = 0;
+	for (int32_t i = 0; numBytes < beaconSize; i++)
+	{
+		// vary the data a little, so that it does not compress unrealistically well
+		auto name = "event" + std::to_string(i * 7919 % 100003) + "x" + std::to_string(i);
+		beacon.reportEvent(i % 16 + 1, name.c_str());
+		numBytes = beacon.getNumBytesInCache();
+	}
+}
+
+static int64_t sendSequentially(std::shared_ptr<caching::IBeaconCache> beaconCache, int32_t beaconID, std::shared_ptr<configuration::Configuration> configuration,
+	std::shared_ptr<openkit::ILogger> logger)
+{
+	protocol::HTTPClient httpClient(logger, configuration->getHTTPClientConfiguration());
+	// same length as the prefix created by the beacon
+	core::UTF8String prefix("vv=3&va=7.0.0000&ap=benchmark&an=benchmark&pt=1&tt=okc&vi=1&sn=1&ip=127.0.0.1&dl=2&cl=2&tx=1500000000000&tv=1500000000000&mp=1");
+	auto maxChunkSize = configuration->getMaxBeaconSize() - 1024;
+
+	auto start = std::chrono::steady_clock::now();
+	while (true)
+	{
+		auto chunk = beaconCache->getNextBeaconChunk(beaconID, prefix, maxChunkSize, protocol::BEACON_DATA_DELIMITER);
+		if (chunk.empty())
+		{
+			break;
+		}
+
+		auto response = httpClient.sendBeaconRequest("127.0.0.1", chunk);
+		if (response == nullptr || response->isErroneousResponse())
+		{
+			return -1;
+		}
+		beaconCache->removeChunkedData(beaconID);
+	}
+
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int64_t sendPipelined(protocol::Beacon& beacon)
+{
+	auto clientProvider = std::make_shared<providers::DefaultHTTPClientProvider>();
+
+	auto start = std::chrono::steady_clock::now();
+	auto response = beacon.send(clientProvider);
+	if (response == nullptr || response->isErroneousResponse() || !beacon.isEmpty())
+	{
+		return -1;
+	}
+
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+	int64_t beaconSize = 4096;
+	int64_t responseDelay = 5;
+	if (argc > 1)
+	{
+		beaconSize = std::strtoll(argv[1], nullptr, 10);
+	}
+	if (argc > 2)
+	{
+		responseDelay = std::strtoll(argv[2], nullptr, 10);
+	}
+
+	protocol::HTTPClient::globalInit();
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> logger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_ERROR);
+
+	test::LocalHTTPServer server;
+	if (!server.start())
+	{
+		std::cout << "failed to start the local server" << std::endl;
+		return EXIT_FAILURE;
+	}
+	server.setResponse(200, RESPONSE_BODY);
+	server.setResponseDelay(responseDelay);
+
+	auto configuration = createConfiguration(server.getBaseURL());
+	auto threadIDProvider = std::make_shared<providers::DefaultThreadIDProvider>();
+	auto timingProvider = std::make_shared<providers::DefaultTimingProvider>();
+
+	std::cout << "sending a beacon of " << beaconSize << " KiB, response delay " << responseDelay << " ms" << std::endl;
+	for (auto pipelined : { false, true })
+	{
+		auto beaconCache = std::make_shared<caching::BeaconCache>(logger);
+		protocol::Beacon beacon(logger, beaconCache, configuration, "127.0.0.1", threadIDProvider, timingProvider);
+		fillBeacon(beacon, beaconSize * 1024);
+		auto numBytes = beacon.getNumBytesInCache();
+		auto numRequests = server.getRequests().size();
+
+		auto elapsed = pipelined
+			? sendPipelined(beacon)
+			: sendSequentially(beaconCache, beacon.getSessionNumber(), configuration, logger);
+		if (elapsed <= 0)
+		{
+			std::cout << (pipelined ? "pipelined" : "sequential") << " send failed" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::cout << (pipelined ? "pipelined: " : "sequential:")
+			<< " chunks: " << (server.getRequests().size() - numRequests)
+			<< " time: " << elapsed / 1000 << " ms"
+			<< " throughput: " << (numBytes * 1000000 / elapsed / 1024) << " KiB/s" << std::endl;
+	}
+
+	server.stop();
+	protocol::HTTPClient::globalDestroy();
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "caching/BeaconCache.h"
+#include "caching/BufferedBeaconCache.h"
+#include "core/util/DefaultLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+///
+/// Measures the latency of reporting data into the beacon cache while many threads report into the same session.
+/// Inserting on the reporting thread, which serializes all threads on the session's cache entry, is compared with
+/// buffered ingestion, where each thread appends to its own buffer which is drained in the background.
+///
+/// Usage: openkit-benchmark-ingestion-latency [number of threads] [records per thread]
+///
+
+static const int32_t BEACON_ID = 1;
+
+static std::vector<int64_t> report(caching::IBeaconCache& beaconCache, int32_t numThreads, int32_t numRecords)
+{
+	std::vector<std::vector<int64_t>> latencies(numThreads);
+	std::vector<std::thread> threads;
+	for (int32_t t = 0; t < numThreads; t++)
+	{
+		threads.push_back(std::thread([&beaconCache, &latencies, t, numRecords]()
+		{
+			core::UTF8String data("et=19&na=event&it=1&pa=1&s0=1&t0=1");
+			latencies[t].reserve(numRecords);
+			for (int32_t i = 0; i < numRecords; i++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				beaconCache.addEventData(BEACON_ID, i, data);
+				latencies[t].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+			}
+		}));
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::vector<int64_t> allLatencies;
+	for (const auto& threadLatencies : latencies)
+	{
+		allLatencies.insert(allLatencies.end(), threadLatencies.begin(), threadLatencies.end());
+	}
+	std::sort(allLatencies.begin(), allLatencies.end());
+	return allLatencies;
+}
+
+static int64_t percentile(const std::vector<int64_t>& sortedValues, int32_t percent)
+{
+	return sortedValues[(sortedValues.size() - 1) * percent / 100];
+}
+
+int main(int argc, char** argv)
+{
+	int32_t numThreads = 8;
+	int32_t numRecords = 100000;
+	if (argc > 1)
+	{
+		numThreads = std::atoi(argv[1]);
+	}
+	if (argc > 2)
+	{
+		numRecords = std::atoi(argv[2]);
+	}
+	if (numThreads <= 0 || numRecords <= 0)
+	{
+		std::cout << "number of threads and records must be positive" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> logger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_ERROR);
+
+	std::cout << numThreads << " threads reporting " << numRecords << " records each into one session" << std::endl;
+	for (auto buffered : { false, true })
+	{
+		auto beaconCache = std::make_shared<caching::BeaconCache>(logger);
+		auto bufferedBeaconCache = std::make_shared<caching::BufferedBeaconCache>(logger, beaconCache, 1);
+		if (buffered)
+		{
+			bufferedBeaconCache->start();
+		}
+
+		auto latencies = buffered
+			? report(*bufferedBeaconCache, numThreads, numRecords)
+			: report(*beaconCache, numThreads, numRecords);
+		bufferedBeaconCache->stop();
+
+		// buffered ingestion drops records instead of blocking once a thread's buffer is full
+		auto numDroppedRecords = static_cast<size_t>(bufferedBeaconCache->getNumDroppedRecords());
+		if (beaconCache->getEvents(BEACON_ID).size() + numDroppedRecords != latencies.size())
+		{
+			std::cout << (buffered ? "buffered" : "direct") << " ingestion lost records" << std::endl;
+			return EXIT_FAILURE;
+		}
+
+		std::cout << (buffered ? "buffered:" : "direct:  ")
+			<< " p50: " << percentile(latencies, 50) << " ns"
+			<< " p99: " << percentile(latencies, 99) << " ns"
+			<< " max: " << latencies.back() / 1000 << " us"
+			<< " dropped: " << numDroppedRecords << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
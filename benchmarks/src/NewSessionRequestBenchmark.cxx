@@ -0,0 +1,139 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "OpenKit/DynatraceOpenKitBuilder.h"
+#include "OpenKit/IOpenKit.h"
+#include "OpenKit/IRootAction.h"
+#include "OpenKit/ISession.h"
+
+#include "../../test/protocol/LocalHTTPServer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+///
+/// Measures the time from creating a burst of sessions until the beacons of all of them arrived at a collector
+/// which answers new session requests with a fixed delay. The burst is repeated for each number of beacon
+/// sending worker threads, with and without sharing the multiplicity of a fresh new session response.
+///
+/// Usage: openkit-benchmark-new-session-requests [sessions] [new session response delay in ms]
+///
+
+static const char RESPONSE_BODY[] = "type=m&si=120&id=1&cp=1";
+
+static size_t countRequests(test::LocalHTTPServer& server, bool withBody)
+{
+	size_t numRequests = 0;
+	for (auto& request : server.getRequests())
+	{
+		if (request.body.empty() != withBody)
+		{
+			numRequests++;
+		}
+	}
+	return numRequests;
+}
+
+static bool waitForRequests(test::LocalHTTPServer& server, bool withBody, size_t numRequests, int64_t timeoutMillis)
+{
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMillis);
+	while (countRequests(server, withBody) < numRequests)
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+static int64_t measureBurstTime(int32_t numThreads, int64_t sharingWindow, int32_t numSessions, int64_t responseDelay, size_t& numNewSessionRequests)
+{
+	test::LocalHTTPServer server;
+	if (!server.start())
+	{
+		return -1;
+	}
+	server.setResponse(200, RESPONSE_BODY);
+
+	auto openKit = openkit::DynatraceOpenKitBuilder(server.getBaseURL().c_str(), "benchmark", 1)
+		.withLogLevel(openkit::LogLevel::LOG_LEVEL_WARN)
+		.withBeaconSendingConcurrency(numThreads)
+		.withMultiplicitySharingWindow(sharingWindow)
+		.build();
+	openKit->waitForInitCompletion();
+	server.setStatusResponseDelay(responseDelay);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < numSessions; i++)
+	{
+		auto session = openKit->createSession("127.0.0.1");
+		session->enterAction("action")->reportValue("index", i)->leaveAction();
+		session->end();
+	}
+	auto sent = waitForRequests(server, true, static_cast<size_t>(numSessions), 600000);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	// the initial status request is sent without body as well
+	numNewSessionRequests = countRequests(server, false) - 1;
+
+	openKit->shutdown();
+	server.stop();
+
+	return sent ? elapsed : -1;
+}
+
+int main(int argc, char** argv)
+{
+	int32_t numSessions = 64;
+	int64_t responseDelay = 50;
+	if (argc > 1)
+	{
+		numSessions = static_cast<int32_t>(std::strtol(argv[1], nullptr, 10));
+	}
+	if (argc > 2)
+	{
+		responseDelay = std::strtoll(argv[2], nullptr, 10);
+	}
+
+	std::cout << "sending " << numSessions << " sessions, new session response delay " << responseDelay << " ms" << std::endl;
+	for (auto sharingWindow : { int64_t(0), int64_t(10000) })
+	{
+		for (auto numThreads : { 1, 2, 4, 8 })
+		{
+			size_t numNewSessionRequests = 0;
+			auto burstTime = measureBurstTime(numThreads, sharingWindow, numSessions, responseDelay, numNewSessionRequests);
+			if (burstTime < 0)
+			{
+				std::cout << "workers: " << numThreads << " sharing window: " << sharingWindow << " ms failed to send all sessions" << std::endl;
+				return EXIT_FAILURE;
+			}
+			std::cout << "workers: " << numThreads << " sharing window: " << sharingWindow << " ms"
+				<< " new session requests: " << numNewSessionRequests
+				<< " time to last beacon: " << burstTime << " ms" << std::endl;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
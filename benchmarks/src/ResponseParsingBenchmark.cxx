@@ -0,0 +1,85 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "core/UTF8String.h"
+#include "core/util/DefaultLogger.h"
+#include "protocol/HTTPResponseParser.h"
+#include "protocol/StatusResponse.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+///
+/// Measures how many status responses per second can be handled, starting from the raw
+/// header lines and body data as they are handed over by curl up to the parsed StatusResponse.
+///
+/// Usage: openkit-benchmark-response-parsing [iterations]
+///
+
+static const char* RESPONSE_HEADER_LINES[] =
+{
+	"HTTP/1.1 200 OK\r\n",
+	"Date: Mon, 21 Jan 2019 10:15:42 GMT\r\n",
+	"Content-Type: text/plain;charset=UTF-8\r\n",
+	"Content-Length: 56\r\n",
+	"Connection: keep-alive\r\n",
+	"Cache-Control: no-cache, no-store, must-revalidate\r\n",
+	"Set-Cookie: dtCookie=v_4_srv_1_sn_0123456789ABCDEF; Path=/; Domain=.example.com\r\n",
+	"Retry-After: 600\r\n",
+	"\r\n"
+};
+
+static const char RESPONSE_BODY[] = "type=m&si=120&bn=dynaTraceMonitor&id=1&bl=150&er=1&cr=1&mp=1&cp=1";
+
+int main(int argc, char** argv)
+{
+	int64_t iterations = 1000000;
+	if (argc > 1)
+	{
+		iterations = std::strtoll(argv[1], nullptr, 10);
+	}
+
+	std::ostringstream devNull;
+	auto logger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_WARN);
+
+	int64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int64_t i = 0; i < iterations; i++)
+	{
+		protocol::HTTPResponseParser parser;
+		for (auto line : RESPONSE_HEADER_LINES)
+		{
+			parser.responseHeaderData(line, 1, std::strlen(line));
+		}
+		parser.responseBodyData(RESPONSE_BODY, 1, sizeof(RESPONSE_BODY) - 1);
+
+		protocol::StatusResponse statusResponse(logger, core::UTF8String(parser.getResponseBody()), 200, parser.getResponseHeaders());
+		checksum += statusResponse.getSendInterval();
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	auto seconds = static_cast<double>(elapsed) / 1000000.0;
+	std::cout << "parsed " << iterations << " responses in " << seconds << " s" << std::endl;
+	std::cout << "responses/sec: " << (seconds > 0 ? static_cast<double>(iterations) / seconds : 0.0) << std::endl;
+	std::cout << "checksum: " << checksum << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "caching/BeaconCache.h"
+#include "configuration/BeaconCacheConfiguration.h"
+#include "configuration/BeaconConfiguration.h"
+#include "configuration/Configuration.h"
+#include "configuration/Device.h"
+#include "core/BeaconSender.h"
+#include "core/Session.h"
+#include "core/WebRequestTracer.h"
+#include "core/util/DefaultLogger.h"
+#include "protocol/Beacon.h"
+#include "protocol/ssl/SSLStrictTrustManager.h"
+#include "providers/DefaultHTTPClientProvider.h"
+#include "providers/DefaultSessionIDProvider.h"
+#include "providers/DefaultThreadIDProvider.h"
+#include "providers/DefaultTimingProvider.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+///
+/// Measures the cost of tracing a web request: validating the URL scheme, creating the tag which is attached
+/// to the request, and the whole trace of a request on a root action.
+///
+/// Usage: openkit-benchmark-web-request-tagging [number of calls]
+///
+
+static std::shared_ptr<configuration::Configuration> createConfiguration()
+{
+	auto device = std::make_shared<configuration::Device>("", "", "");
+	auto beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1);
+	auto beaconConfiguration = std::make_shared<configuration::BeaconConfiguration>();
+
+	auto configuration = std::make_shared<configuration::Configuration>(device, configuration::OpenKitType::Type::DYNATRACE,
+		"benchmark", "", "benchmark", 1, "1", "http://localhost", std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(), beaconCacheConfiguration, beaconConfiguration);
+	configuration->enableCapture();
+	return configuration;
+}
+
+template <typename Function>
+static void measure(const char* name, int32_t numCalls, Function function)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < numCalls; i++)
+	{
+		function(i);
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << name << " time per call: " << elapsed / numCalls << " ns" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	int32_t numCalls = 100000;
+	if (argc > 1)
+	{
+		numCalls = std::atoi(argv[1]);
+	}
+	if (numCalls <= 0)
+	{
+		std::cout << "number of calls must be positive" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> logger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_ERROR);
+	auto timingProvider = std::make_shared<providers::DefaultTimingProvider>();
+	auto configuration = createConfiguration();
+	auto beaconSender = std::make_shared<core::BeaconSender>(logger, configuration, std::make_shared<providers::DefaultHTTPClientProvider>(), timingProvider);
+	auto beacon = std::make_shared<protocol::Beacon>(logger, std::make_shared<caching::BeaconCache>(logger), configuration, "127.0.0.1",
+		std::make_shared<providers::DefaultThreadIDProvider>(), timingProvider);
+	auto session = std::make_shared<core::Session>(logger, beaconSender, beacon);
+	auto rootAction = session->enterAction("root action");
+
+	const core::UTF8String url("https://www.example.com/api/v1/orders?customer=42");
+	size_t numValid = 0;
+	size_t tagLength = 0;
+
+	std::cout << numCalls << " calls" << std::endl;
+	measure("URL scheme check:  ", numCalls, [&](int32_t) { numValid += core::WebRequestTracer::isValidURLScheme(url) ? 1 : 0; });
+	measure("tag creation:      ", numCalls, [&](int32_t i) { tagLength += beacon->createTag(1, i).getStringLength(); });
+	measure("web request trace: ", numCalls, [&](int32_t) { rootAction->traceWebRequest(url.getStringData().c_str())->stop(200); });
+
+	rootAction->leaveAction();
+
+	// use the results, so that the measured calls are not optimized away
+	return numValid == static_cast<size_t>(numCalls) && tagLength > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -21,6 +21,12 @@ include (CMakeDependentOption)
 # Option enabling or disableing building and running of unit tests
 option(OPENKIT_BUILD_TESTS "Build tests (default: ON)" ON)
 
+# Option enabling or disabling building of the micro benchmarks
+option(OPENKIT_BUILD_BENCHMARKS "Build benchmarks (default: OFF)" OFF)
+
+# Option enabling or disabling building of tools (e.g. the local forwarder daemon)
+option(OPENKIT_BUILD_TOOLS "Build tools (default: OFF)" OFF)
+
 # option to build API documentation via Doxygen
 option(BUILD_DOC "Create and install the HTML based API documentation (requires Doxygen)" OFF)
 
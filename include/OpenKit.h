@@ -27,5 +27,8 @@
 #include "OpenKit/AppMonOpenKitBuilder.h"
 #include "OpenKit/DynatraceOpenKitBuilder.h"
 #include "OpenKit/ISSLTrustManager.h"
+#include "OpenKit/ICompressor.h"
+#include "OpenKit/CompressionMode.h"
+#include "OpenKit/SendPriorityPolicy.h"
 
 #endif
@@ -21,12 +21,17 @@
 #include "OpenKit/IOpenKit.h"
 #include "OpenKit/ILogger.h"
 #include "OpenKit/ISSLTrustManager.h"
+#include "OpenKit/ICompressor.h"
+#include "OpenKit/CompressionMode.h"
+#include "OpenKit/SendPriorityPolicy.h"
+#include "OpenKit/SamplingRule.h"
 #include "OpenKit/DataCollectionLevel.h"
 #include "OpenKit/CrashReportingLevel.h"
 
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #ifndef DOXYGEN_HIDE_FROM_DOC
 namespace configuration
@@ -143,6 +148,32 @@ namespace openkit
 			///
 			AbstractOpenKitBuilder& withBeaconCacheUpperMemoryBoundary(int64_t upperMemoryBoundaryInBytes);
 
+			///
+			/// Sets the number of bytes cached for a single session, which trigger sending the session.
+			///
+			/// When a session caches at least this amount of data, it is sent right away instead of
+			/// waiting for the send interval to expire.
+			/// @param[in] sessionFlushThresholdInBytes The threshold in bytes, or non-positive to only send when the send interval expires.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withBeaconCacheSessionFlushThreshold(int64_t sessionFlushThresholdInBytes);
+
+			///
+			/// Moves the insertion of reported data into the beacon cache off the reporting threads.
+			///
+			/// Each thread reporting data appends it to its own lock-free buffer instead of locking the session's cache
+			/// entry, so threads reporting into the same session do not wait for each other. A background thread moves
+			/// the buffered data into the beacon cache in batches, keeping the order in which it was reported.
+			///
+			/// No data is dropped: a thread reporting more than @c maxBufferSizePerThreadInBytes before the background
+			/// thread drained its buffer moves its own buffered data into the beacon cache, waiting for a batch in progress.
+			/// @param[in] drainIntervalInMilliseconds The time between two batches, or non-positive to insert data on the reporting thread.
+			/// @param[in] maxBufferSizePerThreadInBytes The number of bytes a thread buffers before it drains its buffer itself,
+			///                                          or non-positive for the default of 64 KiB.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withBufferedIngestion(int64_t drainIntervalInMilliseconds, int64_t maxBufferSizePerThreadInBytes = 0);
+
 			///
 			/// Sets the data collection level used
 			///
@@ -175,6 +206,219 @@ namespace openkit
 			///
 			AbstractOpenKitBuilder& withCrashReportingLevel(openkit::CrashReportingLevel crashReportingLevel);
 
+			///
+			/// Sets the timeout for establishing a connection to the server.
+			///
+			/// @param[in] connectTimeoutInMilliseconds The connect timeout in milliseconds.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withConnectTimeout(int64_t connectTimeoutInMilliseconds);
+
+			///
+			/// Sets the timeout for a whole request to the server, including connecting and reading the response.
+			///
+			/// @param[in] readTimeoutInMilliseconds The read timeout in milliseconds.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withReadTimeout(int64_t readTimeoutInMilliseconds);
+
+			///
+			/// Sets the maximum number of retries for a failed request.
+			///
+			/// Failed requests are not retried immediately, but deferred with an exponentially growing and
+			/// randomized delay, while data of other sessions is still sent. When a session runs out of retries,
+			/// the data which could not be sent is discarded.
+			/// @param[in] maxRetryAttempts The maximum number of retries or negative if unlimited.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withMaxRetryAttempts(int32_t maxRetryAttempts);
+
+			///
+			/// Sets the delay before the first retry of a failed request.
+			///
+			/// The delay is doubled with every further failed attempt, until @ref withMaxRetryDelay is reached.
+			/// @param[in] initialRetryDelayInMilliseconds The delay before the first retry in milliseconds.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withInitialRetryDelay(int64_t initialRetryDelayInMilliseconds);
+
+			///
+			/// Sets the upper bound for the delay between retries of a failed request.
+			///
+			/// @param[in] maxRetryDelayInMilliseconds The maximum delay between two retries in milliseconds.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withMaxRetryDelay(int64_t maxRetryDelayInMilliseconds);
+
+			///
+			/// Sets the built-in compression used for beacon data
+			///
+			/// <ul>
+			///   <li> @ref openkit::CompressionMode::DEFAULT - gzip with zlib's default compression level
+			///   <li> @ref openkit::CompressionMode::FAST - gzip with the fastest compression level, for CPU bound hosts
+			///   <li> @ref openkit::CompressionMode::ADAPTIVE - gzip with a compression level chosen from recent compression
+			///        times and savings, small payloads are sent uncompressed
+			/// </ul>
+			///
+			/// Default behavior is the mode @ref openkit::CompressionMode::DEFAULT
+			/// @remarks The compression mode is ignored if a compressor is set via @ref withCompressor.
+			/// @param[in] compressionMode compression mode to use
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withCompressionMode(openkit::CompressionMode compressionMode);
+
+			///
+			/// Sets the compressor, if it's not @c nullptr.
+			/// @remarks Overrides the built-in compression selected by @ref withCompressionMode.
+			///
+			/// @param[in] compressor compressor implementation
+			/// @returns @c this for fluent usage
+			///
+			AbstractOpenKitBuilder& withCompressor(std::shared_ptr<openkit::ICompressor> compressor);
+
+			///
+			/// Limits the bandwidth used for uploading beacon data.
+			///
+			/// Uploads are shaped by a token bucket holding up to @c burstSizeInBytes bytes, which is refilled with
+			/// @c bytesPerSecond. While the bucket is exhausted, further uploads are deferred.
+			/// The current state can be queried via @ref openkit::IOpenKit::getUploadThrottleState.
+			/// @param[in] bytesPerSecond The upload rate in bytes per second or non-positive if unlimited.
+			/// @param[in] burstSizeInBytes The maximum number of bytes uploaded without delay or non-positive to allow
+			///            one second of upload rate.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withUploadRateLimit(int64_t bytesPerSecond, int64_t burstSizeInBytes);
+
+			///
+			/// Sets the number of threads sending beacons of different sessions in parallel.
+			///
+			/// With the default of one thread all beacons are sent by the beacon sending thread, so that one slow
+			/// request delays all other sessions. With more threads the beacons of different sessions are uploaded
+			/// concurrently, while the beacons of a single session are still sent one after the other.
+			/// @param[in] numThreads The number of upload threads, values less than @c 1 are treated as @c 1.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withBeaconSendingConcurrency(int32_t numThreads);
+
+			///
+			/// Spreads the beacons of open sessions evenly across the send interval.
+			///
+			/// By default all open sessions are sent back to back once the send interval expires, which causes
+			/// a burst of CPU, memory and network usage. When staggering is enabled, each open session gets its own
+			/// slot within the interval, and all open sessions are still sent once per interval.
+			/// @param[in] jitterEnabled @c true to randomize the send time of each session within its slot
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withStaggeredOpenSessionSending(bool jitterEnabled);
+
+			///
+			/// Shares the multiplicity of a new session response with sessions created shortly after.
+			///
+			/// By default every session sends its own new session request before its data can be sent. Within the given
+			/// window after a successful new session response, further new sessions are configured with the multiplicity
+			/// of that response without sending a request.
+			/// @param[in] windowInMilliseconds The sharing window in milliseconds, @c 0 disables sharing.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withMultiplicitySharingWindow(int64_t windowInMilliseconds);
+
+			///
+			/// Adapts the send interval of open sessions and the beacon size to the beacon cache and collector load.
+			///
+			/// By default the send interval and maximum beacon size given by the server are applied as they are. With
+			/// adaptive sending, open sessions are sent more often while the beacon cache is close to its upper memory
+			/// boundary, and less often with smaller beacons while the collector responds slowly. The beacon size never
+			/// exceeds the server's limit. The current state can be queried via @ref openkit::IOpenKit::getAdaptiveSendingState.
+			/// @param[in] slowResponseThresholdInMilliseconds average response time at which the collector is considered slow,
+			///            values less than or equal to @c 0 disable adaptive sending.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withAdaptiveSending(int64_t slowResponseThresholdInMilliseconds);
+
+			///
+			/// Sets the order in which the beacons of sessions are sent
+			///
+			/// <ul>
+			///   <li> @ref openkit::SendPriorityPolicy::INSERTION_ORDER - sessions are sent in the order they were created
+			///   <li> @ref openkit::SendPriorityPolicy::EVICTION_RISK - sessions holding the oldest and most data are sent first,
+			///        so that as little data as possible is evicted from the beacon cache if not all sessions can be sent
+			/// </ul>
+			///
+			/// Default behavior is the policy @ref openkit::SendPriorityPolicy::INSERTION_ORDER
+			/// @param[in] sendPriorityPolicy send priority policy to use
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withSendPriorityPolicy(openkit::SendPriorityPolicy sendPriorityPolicy);
+
+			///
+			/// Sends all requests to a local forwarder instead of the server.
+			///
+			/// Requests are written uncompressed to the Unix domain socket of the forwarder, which compresses them
+			/// and uploads them over a connection shared by all processes on the host.
+			/// @param[in] socketPath The file system path of the forwarder's socket or @c nullptr to send requests to the server directly.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withLocalForwarder(const char* socketPath);
+
+			///
+			/// Stores beacon data on disk instead of dropping it while the server does not accept data
+			///
+			/// When the server responds with "too many requests" or cannot be reached and capturing is turned off,
+			/// the cached data is written as ready-to-send compressed chunks to the given directory. Once capturing is
+			/// turned on again, the stored chunks are sent oldest first, paced to the given rate. Chunks left over by
+			/// a previous run of the application are sent as well.
+			///
+			/// By default store-and-forward is disabled and the data is dropped.
+			/// @param[in] directory The directory to store the chunks in or @c nullptr to disable store-and-forward.
+			/// @param[in] maxStoreSizeInBytes The maximum number of bytes stored, the oldest chunks are dropped first.
+			/// @param[in] maxChunkAgeInMilliseconds The maximum age of a stored chunk, values less than or equal to @c 0 disable the limit.
+			/// @param[in] replayBytesPerSecond The rate stored chunks are sent with, values less than or equal to @c 0 disable the limit.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withStoreAndForward(const char* directory, int64_t maxStoreSizeInBytes, int64_t maxChunkAgeInMilliseconds, int64_t replayBytesPerSecond);
+
+			///
+			/// Adds a client side sampling rule for events, values, errors or web requests
+			///
+			/// Records the rule applies to are kept with the given probability and, if a rate is given, at most that many
+			/// records are kept per second and name. Kept records carry the rate they were sampled with, so that counts
+			/// can be scaled up again. A rule for a specific name takes precedence over a rule without name.
+			///
+			/// By default all records are kept.
+			/// @param[in] eventType The kind of data the rule applies to.
+			/// @param[in] name The name the rule applies to, or @c nullptr to apply it to every name without a rule of its own.
+			/// @param[in] sampleRate The probability with which a record is kept, between @c 0 and @c 1.
+			/// @param[in] maxEventsPerSecond The maximum number of records kept per second and name, values less than or equal to @c 0 disable the limit.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withSamplingRule(openkit::SampledEventType eventType, const char* name, double sampleRate, double maxEventsPerSecond);
+
+			///
+			/// Aggregates integer and double values locally instead of sending one record per reported value
+			///
+			/// Values reported on the same action with the same name are folded into count, minimum, maximum and sum.
+			/// One record per name is sent when the action is left or, if a flush interval is given, once the first
+			/// value folded into it is older than the interval. Values kept by a sampling rule with a rate below @c 1
+			/// are not aggregated.
+			///
+			/// By default every value is sent as a record of its own.
+			/// @param[in] flushIntervalInMilliseconds The maximum time values are held back, @c 0 to hold them back until the action is left,
+			///            negative values disable aggregation.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withValueAggregation(int64_t flushIntervalInMilliseconds);
+
+			///
+			/// Reads timestamps from a coarse clock, which is cheaper to read than the precise system clock
+			///
+			/// The coarse clock is updated on each timer tick of the operating system, so that timestamps and durations
+			/// of actions and web requests have a resolution of a few milliseconds instead of one millisecond.
+			///
+			/// By default the precise system clock is used.
+			/// @returns @c this
+			///
+			AbstractOpenKitBuilder& withCoarseTimestamps();
+
 			///
 			/// Builds an @ref openkit::IOpenKit instance
 			/// @return an @ref openkit::IOpenKit instance
@@ -271,6 +515,24 @@ namespace openkit
 			///
 			int64_t getBeaconCacheUpperMemoryBoundary() const;
 
+			///
+			/// Returns the number of bytes cached for a single session, which trigger sending the session
+			/// @returns the session flush threshold, non-positive values declare that the threshold is disabled
+			///
+			int64_t getBeaconCacheSessionFlushThreshold() const;
+
+			///
+			/// Returns the time between two batches of buffered data moved into the beacon cache
+			/// @returns the drain interval in milliseconds, non-positive values declare that data is inserted on the reporting thread
+			///
+			int64_t getIngestionDrainInterval() const;
+
+			///
+			/// Returns the number of bytes a reporting thread buffers before it drains its buffer itself
+			/// @returns the buffer size in bytes, non-positive values declare that the default is used
+			///
+			int64_t getMaxIngestionBufferSizePerThread() const;
+
 			///
 			/// Returns the data collection level
 			/// @returns the data collection level
@@ -283,6 +545,145 @@ namespace openkit
 			///
 			CrashReportingLevel getCrashReportingLevel() const;
 
+			///
+			/// Returns the connect timeout
+			/// @returns the connect timeout in milliseconds
+			///
+			int64_t getConnectTimeout() const;
+
+			///
+			/// Returns the read timeout
+			/// @returns the read timeout in milliseconds
+			///
+			int64_t getReadTimeout() const;
+
+			///
+			/// Returns the maximum number of retries
+			/// @returns the maximum number of retries, negative values declare that there are no bounds
+			///
+			int32_t getMaxRetryAttempts() const;
+
+			///
+			/// Returns the delay before the first retry
+			/// @returns the delay before the first retry in milliseconds
+			///
+			int64_t getInitialRetryDelay() const;
+
+			///
+			/// Returns the upper bound of the retry delay
+			/// @returns the maximum delay between two retries in milliseconds
+			///
+			int64_t getMaxRetryDelay() const;
+
+			///
+			/// Returns the compression mode
+			/// @returns the compression mode
+			///
+			CompressionMode getCompressionMode() const;
+
+			///
+			/// Returns the compressor for beacon data
+			/// @returns the compressor set via @ref withCompressor or a new compressor for the compression mode
+			///
+			std::shared_ptr<openkit::ICompressor> getCompressor() const;
+
+			///
+			/// Returns the upload rate limit
+			/// @returns the upload rate in bytes per second, non-positive values declare that there are no bounds
+			///
+			int64_t getUploadRateLimit() const;
+
+			///
+			/// Returns the burst size of the upload rate limit
+			/// @returns the maximum number of bytes uploaded without delay
+			///
+			int64_t getUploadBurstSize() const;
+
+			///
+			/// Returns the number of threads sending beacons of different sessions in parallel
+			/// @returns the beacon sending concurrency
+			///
+			int32_t getBeaconSendingConcurrency() const;
+
+			///
+			/// Returns whether the beacons of open sessions are spread across the send interval
+			/// @returns @c true if open sessions are sent staggered
+			///
+			bool isOpenSessionSendStaggered() const;
+
+			///
+			/// Returns whether the send time of staggered open sessions is randomized
+			/// @returns @c true if jitter is enabled
+			///
+			bool isOpenSessionSendJitterEnabled() const;
+
+			///
+			/// Returns the time a new session response is shared with further new sessions
+			/// @returns the multiplicity sharing window in milliseconds
+			///
+			int64_t getMultiplicitySharingWindow() const;
+
+			///
+			/// Returns the average response time at which the collector is considered slow
+			/// @returns the slow response threshold in milliseconds, or a non-positive value if adaptive sending is disabled
+			///
+			int64_t getSlowResponseThreshold() const;
+
+			///
+			/// Returns the order in which the beacons of sessions are sent
+			/// @returns the send priority policy
+			///
+			openkit::SendPriorityPolicy getSendPriorityPolicy() const;
+
+			///
+			/// Returns the socket path of the local forwarder
+			/// @returns the socket path or an empty string if requests are sent to the server directly
+			///
+			const std::string& getLocalForwarderSocketPath() const;
+
+			///
+			/// Returns the directory beacon data is stored in while the server does not accept data
+			/// @returns the directory or an empty string if store-and-forward is disabled
+			///
+			const std::string& getStoreAndForwardDirectory() const;
+
+			///
+			/// Returns the maximum number of bytes stored on disk
+			/// @returns the maximum store size in bytes
+			///
+			int64_t getMaxStoreSize() const;
+
+			///
+			/// Returns the maximum age of a stored chunk
+			/// @returns the maximum chunk age in milliseconds, or a non-positive value if the age is not limited
+			///
+			int64_t getMaxStoredChunkAge() const;
+
+			///
+			/// Returns the rate stored chunks are sent with
+			/// @returns the rate in bytes per second, or a non-positive value if the rate is not limited
+			///
+			int64_t getReplayBytesPerSecond() const;
+
+			///
+			/// Returns the client side sampling rules
+			/// @returns the sampling rules, which are empty if all records are kept
+			///
+			const std::vector<openkit::SamplingRule>& getSamplingRules() const;
+
+			///
+			/// Returns the flush interval of aggregated values
+			/// @returns the interval in milliseconds, @c 0 if values are held back until the action is left,
+			///          or a negative value if values are not aggregated
+			///
+			int64_t getValueAggregationInterval() const;
+
+			///
+			/// Returns whether timestamps are read from a coarse clock
+			/// @returns @c true if the coarse clock is used, @c false if the precise system clock is used
+			///
+			bool isCoarseTimestampsEnabled() const;
+
 		public:
 			///
 			/// Returns a @ref openkit::ILogger. If no logger is set, when building the OpenKit with @ref build(),
@@ -339,11 +740,89 @@ namespace openkit
 			/// upper memory boundary of beacon cache
 			int64_t mBeaconCacheUpperMemoryBoundary;
 
+			/// number of bytes cached for a single session which trigger sending it
+			int64_t mBeaconCacheSessionFlushThreshold;
+
+			/// time between two batches of buffered data moved into the beacon cache
+			int64_t mIngestionDrainInterval;
+
+			/// number of bytes a reporting thread buffers before it drains its buffer itself
+			int64_t mMaxIngestionBufferSizePerThread;
+
 			/// data collection level
 			openkit::DataCollectionLevel mDataCollectionLevel;
 
 			/// crash reporting level
 			openkit::CrashReportingLevel mCrashReportingLevel;
+
+			/// connect timeout
+			int64_t mConnectTimeout;
+
+			/// read timeout
+			int64_t mReadTimeout;
+
+			/// maximum number of retries
+			int32_t mMaxRetryAttempts;
+
+			/// delay before the first retry
+			int64_t mInitialRetryDelay;
+
+			/// maximum delay between two retries
+			int64_t mMaxRetryDelay;
+
+			/// compression mode
+			openkit::CompressionMode mCompressionMode;
+
+			/// custom compressor
+			std::shared_ptr<openkit::ICompressor> mCompressor;
+
+			/// upload rate in bytes per second
+			int64_t mUploadRateLimit;
+
+			/// burst size of the upload rate limit
+			int64_t mUploadBurstSize;
+
+			/// number of threads sending beacons
+			int32_t mBeaconSendingConcurrency;
+
+			/// spread the beacons of open sessions across the send interval
+			bool mStaggerOpenSessionSending;
+
+			/// randomize the send time of staggered open sessions
+			bool mOpenSessionSendJitter;
+
+			/// time a new session response is shared with further new sessions
+			int64_t mMultiplicitySharingWindow;
+
+			/// response time at which adaptive sending backs off
+			int64_t mSlowResponseThreshold;
+
+			/// order in which the beacons of sessions are sent
+			openkit::SendPriorityPolicy mSendPriorityPolicy;
+
+			/// socket path of the local forwarder
+			std::string mLocalForwarderSocketPath;
+
+			/// directory beacon data is stored in during backoff
+			std::string mStoreAndForwardDirectory;
+
+			/// maximum number of bytes stored on disk
+			int64_t mMaxStoreSize;
+
+			/// maximum age of a stored chunk
+			int64_t mMaxStoredChunkAge;
+
+			/// rate stored chunks are sent with
+			int64_t mReplayBytesPerSecond;
+
+			/// client side sampling rules
+			std::vector<openkit::SamplingRule> mSamplingRules;
+
+			/// flush interval of aggregated values
+			int64_t mValueAggregationInterval;
+
+			/// flag if timestamps are read from a coarse clock
+			bool mCoarseTimestamps;
 	};
 }
 
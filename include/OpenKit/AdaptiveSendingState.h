@@ -0,0 +1,55 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _OPENKIT_ADAPTIVESENDINGSTATE_H
+#define _OPENKIT_ADAPTIVESENDINGSTATE_H
+
+#include <cstdint>
+
+namespace openkit
+{
+	///
+	/// Snapshot of the adaptive sending configured via @ref openkit::AbstractOpenKitBuilder::withAdaptiveSending
+	///
+	struct AdaptiveSendingState
+	{
+		/// @c true if send interval and payload size are adapted at all
+		bool isEnabled;
+
+		/// @c true if the beacon cache is close to its upper memory boundary
+		bool isCachePressure;
+
+		/// @c true if the collector responds slowly
+		bool isLatencyPressure;
+
+		/// send interval of open sessions currently applied in milliseconds
+		int64_t sendIntervalInMilliseconds;
+
+		/// maximum size of a beacon chunk currently applied in bytes
+		int32_t maxBeaconSize;
+
+		/// smoothed response time of beacon requests in milliseconds
+		int64_t averageResponseLatencyInMilliseconds;
+
+		/// number of times the send interval was shortened
+		int64_t numSendIntervalDecreases;
+
+		/// number of times the send interval was lengthened
+		int64_t numSendIntervalIncreases;
+	};
+}
+
+#endif
@@ -0,0 +1,36 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef _OPENKIT_COMPRESSIONMODE_H
+#define _OPENKIT_COMPRESSIONMODE_H
+
+#include "OpenKit_export.h"
+
+#include <cstdint>
+
+namespace openkit
+{
+	///
+	/// This enum declares the built-in compression of beacon data to use
+	///
+	enum class OPENKIT_EXPORT CompressionMode : int32_t
+	{
+		DEFAULT, // gzip with default compression level
+		FAST, // gzip with fastest compression level, for CPU bound hosts
+		ADAPTIVE // gzip with a compression level chosen per request, small payloads are sent uncompressed
+	};
+}
+
+#endif
@@ -0,0 +1,51 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef _OPENKIT_ICOMPRESSOR_H
+#define _OPENKIT_ICOMPRESSOR_H
+
+#include "OpenKit_export.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace openkit
+{
+	///
+	/// Interface to provide a user-defined compression of the beacon data sent to the server.
+	/// Implementations must be thread safe, since a compressor might be used concurrently for multiple requests.
+	///
+	class OPENKIT_EXPORT ICompressor
+	{
+	public:
+
+		///
+		/// Destructor
+		///
+		virtual ~ICompressor() {}
+
+		///
+		/// Compress the given data in gzip format.
+		/// @remarks If an implementation decides not to compress the data (e.g. because the data is too small
+		///          to benefit from compression), @c false must be returned and the data is sent uncompressed.
+		/// @param[in] inData pointer to the data to compress
+		/// @param[in] inDataSize size of the data to compress in bytes
+		/// @param[out] outData gzip compressed data
+		/// @returns @c true if @c outData contains the gzip compressed data, @c false if the data shall be sent uncompressed
+		///
+		virtual bool compress(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData) = 0;
+	};
+}
+#endif
@@ -18,6 +18,9 @@
 #define _OPENKIT_IOPENKIT_H
 
 #include "OpenKit_export.h"
+#include "OpenKit/UploadThrottleState.h"
+#include "OpenKit/AdaptiveSendingState.h"
+#include "OpenKit/ShutdownReport.h"
 
 #include <cstdint>
 #include <memory>
@@ -77,10 +80,49 @@ namespace openkit
 		///
 		virtual std::shared_ptr<openkit::ISession> createSession(const char* clientIPAddress) = 0;
 
+		///
+		/// Returns the current state of the upload rate limit.
+		/// @see openkit::AbstractOpenKitBuilder::withUploadRateLimit
+		/// The default implementation reports uploads as not being rate limited.
+		/// @returns a snapshot of the upload throttle state
+		///
+		virtual openkit::UploadThrottleState getUploadThrottleState() const
+		{
+			return { false, false, 0, 0, 0 };
+		}
+
+		///
+		/// Returns the current state of adaptive sending.
+		/// @see openkit::AbstractOpenKitBuilder::withAdaptiveSending
+		/// The default implementation reports adaptive sending as disabled.
+		/// @returns a snapshot of the adaptive sending state
+		///
+		virtual openkit::AdaptiveSendingState getAdaptiveSendingState() const
+		{
+			return { false, false, false, 0, 0, 0, 0, 0 };
+		}
+
 		///
 		/// Shuts down OpenKit, ending all open Sessions and waiting for them to be sent.
 		///
 		virtual void shutdown() = 0;
+
+		///
+		/// Shuts down OpenKit, ending all open Sessions and sending them within the given timeout.
+		///
+		/// Sessions are sent in parallel if a beacon sending concurrency greater than one is configured, the ones
+		/// holding most data first. Once the timeout expires, requests still in flight are aborted and the data of
+		/// sessions not sent yet is discarded.
+		/// The default implementation calls @ref shutdown() ignoring the timeout and returns an empty report.
+		/// @param[in] timeoutMillis maximum number of milliseconds to wait for the data being sent
+		/// @returns how much data was sent and discarded
+		///
+		virtual openkit::ShutdownReport shutdown(int64_t timeoutMillis)
+		{
+			(void)timeoutMillis;
+			shutdown();
+			return { false, 0, 0, 0, 0 };
+		}
 	};
 }
 
@@ -18,7 +18,9 @@
 #define _OPENKIT_IROOTACTION_H
 
 #include "OpenKit_export.h"
+#include "OpenKit/ReportedValue.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -80,6 +82,49 @@ namespace openkit
 		///
 		virtual std::shared_ptr<IRootAction> reportValue(const char* valueName, const char* value) = 0;
 
+		///
+		/// Reports several events and values at once.
+		///
+		/// The beacon data is the same as if each entry was reported on its own, in the given order,
+		/// except that all entries share one timestamp. Entries whose name is @c nullptr or empty are skipped.
+		///
+		/// The default implementation reports each entry on its own and returns the result of the last call,
+		/// or @c nullptr if no entry was reported.
+		///
+		/// @param values    events and values to report
+		/// @param numValues number of entries in @c values
+		/// @return this Action (for usage as fluent API), the default implementation returns @c nullptr if no entry was reported
+		///
+		virtual std::shared_ptr<IRootAction> reportValues(const ReportedValue* values, size_t numValues)
+		{
+			std::shared_ptr<IRootAction> result = nullptr;
+			for (size_t i = 0; values != nullptr && i < numValues; i++)
+			{
+				const auto& value = values[i];
+				if (value.name == nullptr || value.name[0] == '\0')
+				{
+					continue;
+				}
+
+				switch (value.type)
+				{
+				case ReportedValueType::EVENT:
+					result = reportEvent(value.name);
+					break;
+				case ReportedValueType::INT_VALUE:
+					result = reportValue(value.name, value.intValue);
+					break;
+				case ReportedValueType::DOUBLE_VALUE:
+					result = reportValue(value.name, value.doubleValue);
+					break;
+				case ReportedValueType::STRING_VALUE:
+					result = reportValue(value.name, value.stringValue);
+					break;
+				}
+			}
+			return result;
+		}
+
 		///
 		/// Reports an error with a specified name, error code and reason.
 		///
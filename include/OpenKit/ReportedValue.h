@@ -0,0 +1,97 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _OPENKIT_REPORTEDVALUE_H
+#define _OPENKIT_REPORTEDVALUE_H
+
+#include <cstdint>
+
+namespace openkit
+{
+	///
+	/// This enum declares what kind of data a @ref ReportedValue carries
+	///
+	enum class ReportedValueType : int32_t
+	{
+		EVENT, // named event without a value
+		INT_VALUE, // int value, taken from ReportedValue::intValue
+		DOUBLE_VALUE, // double value, taken from ReportedValue::doubleValue
+		STRING_VALUE // string value, taken from ReportedValue::stringValue
+	};
+
+	///
+	/// A named event or value reported together with others via @ref openkit::IAction::reportValues
+	/// or @ref openkit::IRootAction::reportValues
+	///
+	struct ReportedValue
+	{
+		/// name of the event or value
+		const char* name;
+
+		/// kind of data, which determines the field holding the value
+		ReportedValueType type;
+
+		/// value if @c type is @ref ReportedValueType::INT_VALUE
+		int32_t intValue;
+
+		/// value if @c type is @ref ReportedValueType::DOUBLE_VALUE
+		double doubleValue;
+
+		/// value if @c type is @ref ReportedValueType::STRING_VALUE
+		const char* stringValue;
+
+		///
+		/// Creates a named event
+		/// @param[in] eventName name of the event
+		///
+		static ReportedValue event(const char* eventName)
+		{
+			return { eventName, ReportedValueType::EVENT, 0, 0.0, nullptr };
+		}
+
+		///
+		/// Creates an int value
+		/// @param[in] valueName name of this value
+		/// @param[in] value value itself
+		///
+		static ReportedValue value(const char* valueName, int32_t value)
+		{
+			return { valueName, ReportedValueType::INT_VALUE, value, 0.0, nullptr };
+		}
+
+		///
+		/// Creates a double value
+		/// @param[in] valueName name of this value
+		/// @param[in] value value itself
+		///
+		static ReportedValue value(const char* valueName, double value)
+		{
+			return { valueName, ReportedValueType::DOUBLE_VALUE, 0, value, nullptr };
+		}
+
+		///
+		/// Creates a string value
+		/// @param[in] valueName name of this value
+		/// @param[in] value value itself
+		///
+		static ReportedValue value(const char* valueName, const char* value)
+		{
+			return { valueName, ReportedValueType::STRING_VALUE, 0, 0.0, value };
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,81 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _OPENKIT_SAMPLINGRULE_H
+#define _OPENKIT_SAMPLINGRULE_H
+
+#include "OpenKit_export.h"
+
+#include <cstdint>
+#include <string>
+
+namespace openkit
+{
+	///
+	/// This enum declares the kinds of data a @ref SamplingRule applies to
+	///
+	enum class OPENKIT_EXPORT SampledEventType : int32_t
+	{
+		NAMED_EVENT, // events reported via reportEvent
+		VALUE, // int, double and string values reported via reportValue
+		REPORTED_ERROR, // errors reported via reportError
+		WEB_REQUEST // web requests, the name is the traced URL
+	};
+
+	///
+	/// Client side sampling of events, values, errors or web requests,
+	/// configured via @ref openkit::AbstractOpenKitBuilder::withSamplingRule
+	///
+	struct SamplingRule
+	{
+		///
+		/// Default constructor, keeping every named event
+		///
+		SamplingRule()
+			: SamplingRule(SampledEventType::NAMED_EVENT, std::string(), 1.0, 0.0)
+		{
+		}
+
+		///
+		/// Constructor
+		/// @param[in] eventType kind of data the rule applies to
+		/// @param[in] name name the rule applies to, empty to apply it to every name without a rule of its own
+		/// @param[in] sampleRate probability with which a record is kept
+		/// @param[in] maxEventsPerSecond maximum number of records kept per second and name, not limited if not positive
+		///
+		SamplingRule(SampledEventType eventType, const std::string& name, double sampleRate, double maxEventsPerSecond)
+			: eventType(eventType)
+			, name(name)
+			, sampleRate(sampleRate)
+			, maxEventsPerSecond(maxEventsPerSecond)
+		{
+		}
+
+		/// kind of data the rule applies to
+		SampledEventType eventType;
+
+		/// name the rule applies to, an empty name applies the rule to every name without a rule of its own
+		std::string name;
+
+		/// probability with which a record is kept
+		double sampleRate;
+
+		/// maximum number of records kept per second and name, not limited if not positive
+		double maxEventsPerSecond;
+	};
+}
+
+#endif
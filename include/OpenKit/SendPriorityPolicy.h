@@ -0,0 +1,36 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _OPENKIT_SENDPRIORITYPOLICY_H
+#define _OPENKIT_SENDPRIORITYPOLICY_H
+
+#include "OpenKit_export.h"
+
+#include <cstdint>
+
+namespace openkit
+{
+	///
+	/// This enum declares in which order the beacons of sessions are sent
+	///
+	enum class OPENKIT_EXPORT SendPriorityPolicy : int32_t
+	{
+		INSERTION_ORDER, // sessions are sent in the order they were created
+		EVICTION_RISK // sessions whose data is closest to being evicted from the beacon cache are sent first
+	};
+}
+
+#endif
@@ -0,0 +1,46 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _OPENKIT_SHUTDOWNREPORT_H
+#define _OPENKIT_SHUTDOWNREPORT_H
+
+#include <cstdint>
+
+namespace openkit
+{
+	///
+	/// Outcome of shutting down OpenKit via @ref openkit::IOpenKit::shutdown(int64_t)
+	///
+	struct ShutdownReport
+	{
+		/// @c true if the timeout expired before all data was sent
+		bool isDeadlineExceeded;
+
+		/// number of sessions whose data was sent completely
+		int32_t numSessionsFlushed;
+
+		/// number of sessions whose data was not or only partially sent
+		int32_t numSessionsDropped;
+
+		/// number of bytes of beacon data sent
+		int64_t numBytesFlushed;
+
+		/// number of bytes of beacon data discarded without being sent
+		int64_t numBytesDropped;
+	};
+}
+
+#endif
@@ -0,0 +1,45 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef _OPENKIT_UPLOADTHROTTLESTATE_H
+#define _OPENKIT_UPLOADTHROTTLESTATE_H
+
+#include <cstdint>
+
+namespace openkit
+{
+	///
+	/// Snapshot of the upload rate limiting configured via @ref openkit::AbstractOpenKitBuilder::withUploadRateLimit
+	///
+	struct UploadThrottleState
+	{
+		/// @c true if uploads are rate limited at all
+		bool isEnabled;
+
+		/// @c true if the upload budget is currently exhausted and uploads are delayed
+		bool isThrottled;
+
+		/// number of bytes which can currently be uploaded without delay
+		int64_t availableBytes;
+
+		/// total time in milliseconds uploads have been delayed by the rate limit
+		int64_t totalThrottledTimeInMilliseconds;
+
+		/// total number of bytes uploaded
+		int64_t totalUploadedBytes;
+	};
+}
+
+#endif
@@ -17,6 +17,7 @@
 #ifndef _API_C_OPENKIT_H
 #define _API_C_OPENKIT_H
 
+#include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "curl/curl.h"
@@ -117,6 +118,14 @@ extern "C" {
 		CRASH_REPORTING_LEVEL_COUNT
 	} CrashReportingLevel;
 
+	typedef enum CompressionMode
+	{
+		COMPRESSION_MODE_DEFAULT = 0,
+		COMPRESSION_MODE_FAST = 1,
+		COMPRESSION_MODE_ADAPTIVE = 2,
+		COMPRESSION_MODE_COUNT
+	} CompressionMode;
+
 	/// an opaque type that we'll use as a handle
 	struct OpenKitConfigurationHandle;
 
@@ -227,6 +236,13 @@ extern "C" {
 	///
 	OPENKIT_EXPORT void useCrashReportingLevelForConfiguration(struct OpenKitConfigurationHandle* configurationHandle, CrashReportingLevel crashReportingLevel);
 
+	///
+	/// Set the compression of beacon data in the OpenKit configuration
+	/// @param[in] configurationHandle configuration storing the given parameter
+	/// @param[in] compressionMode optional parameter, default mode is COMPRESSION_MODE_DEFAULT
+	///
+	OPENKIT_EXPORT void useCompressionModeForConfiguration(struct OpenKitConfigurationHandle* configurationHandle, CompressionMode compressionMode);
+
 	//--------------
 	//  OpenKit
 	//--------------
@@ -255,6 +271,16 @@ extern "C" {
 	///
 	OPENKIT_EXPORT void shutdownOpenKit(struct OpenKitHandle* openKitHandle);
 
+	///
+	/// Shuts down the OpenKit, ending all open Sessions and sending them within the given timeout.
+	/// Once the timeout expires, requests still in flight are aborted and the data not sent yet is discarded.
+	/// After calling @c shutdown the openKitHandle is released and must not be used any more.
+	/// @param[in] openKitHandle the handle returned by @ref createDynatraceOpenKit or @ref createAppMonOpenKit
+	/// @param[in] timeoutMillis maximum number of milliseconds to wait for the data being sent
+	/// @return @c true if all data was sent, @c false if data was discarded
+	///
+	OPENKIT_EXPORT bool shutdownOpenKitWithTimeout(struct OpenKitHandle* openKitHandle, int64_t timeoutMillis);
+
 	///
 	/// Waits until OpenKit is fully initialized.
 	///
@@ -333,6 +359,36 @@ extern "C" {
 	///
 	OPENKIT_EXPORT void reportCrash(struct SessionHandle* sessionHandle, const char* errorName, const char* reason, const char* stacktrace);
 
+	//--------------
+	//  Reported Values
+	//--------------
+
+	typedef enum REPORTED_VALUE_TYPE
+	{
+		REPORTED_VALUE_TYPE_EVENT = 0,
+		REPORTED_VALUE_TYPE_INT = 1,
+		REPORTED_VALUE_TYPE_DOUBLE = 2,
+		REPORTED_VALUE_TYPE_STRING = 3,
+		REPORTED_VALUE_TYPE_COUNT
+	} REPORTED_VALUE_TYPE;
+
+	///
+	/// A named event or value reported together with others via @ref reportValuesOnRootAction or @ref reportValuesOnAction
+	///
+	typedef struct ReportedValue
+	{
+		/// name of the event or value
+		const char* name;
+		/// kind of data, which determines the field holding the value
+		REPORTED_VALUE_TYPE type;
+		/// value if @c type is @c REPORTED_VALUE_TYPE_INT
+		int32_t intValue;
+		/// value if @c type is @c REPORTED_VALUE_TYPE_DOUBLE
+		double doubleValue;
+		/// value if @c type is @c REPORTED_VALUE_TYPE_STRING
+		const char* stringValue;
+	} ReportedValue;
+
 	//--------------
 	//  Root Action
 	//--------------
@@ -391,6 +447,18 @@ extern "C" {
 	///
 	OPENKIT_EXPORT void reportStringValueOnRootAction(struct RootActionHandle* rootActionHandle, const char* valueName, const char* value);
 
+	///
+	/// Reports several events and values at once.
+	///
+	/// The beacon data is the same as if each entry was reported on its own, in the given order,
+	/// except that all entries share one timestamp. Entries whose name is @c NULL or empty or whose type is unknown are skipped.
+	///
+	/// @param[in] rootActionHandle	the handle returned by @ref enterRootAction
+	/// @param[in] values			events and values to report
+	/// @param[in] numValues		number of entries in @c values
+	///
+	OPENKIT_EXPORT void reportValuesOnRootAction(struct RootActionHandle* rootActionHandle, const struct ReportedValue* values, size_t numValues);
+
 	///
 	/// Reports an error with a specified name, error code and reason.
 	///
@@ -459,6 +527,18 @@ extern "C" {
 	///
 	OPENKIT_EXPORT void reportStringValueOnAction(struct ActionHandle* actionHandle, const char* valueName, const char* value);
 
+	///
+	/// Reports several events and values at once.
+	///
+	/// The beacon data is the same as if each entry was reported on its own, in the given order,
+	/// except that all entries share one timestamp. Entries whose name is @c NULL or empty or whose type is unknown are skipped.
+	///
+	/// @param[in] actionHandle	the handle returned by @ref enterAction
+	/// @param[in] values		events and values to report
+	/// @param[in] numValues	number of entries in @c values
+	///
+	OPENKIT_EXPORT void reportValuesOnAction(struct ActionHandle* actionHandle, const struct ReportedValue* values, size_t numValues);
+
 	///
 	/// Reports an error with a specified name, error code and reason.
 	///
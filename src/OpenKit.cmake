@@ -15,10 +15,12 @@
 set(OPENKIT_PUBLIC_HEADERS_CXX_API
     ${CMAKE_SOURCE_DIR}/include/OpenKit/AbstractOpenKitBuilder.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/AppMonOpenKitBuilder.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/CompressionMode.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/CrashReportingLevel.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/DataCollectionLevel.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/DynatraceOpenKitBuilder.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/IAction.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/ICompressor.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/ILogger.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/IOpenKit.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/IRootAction.h
@@ -27,6 +29,12 @@ set(OPENKIT_PUBLIC_HEADERS_CXX_API
     ${CMAKE_SOURCE_DIR}/include/OpenKit/IWebRequestTracer.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/LogLevel.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit/OpenKitConstants.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/UploadThrottleState.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/AdaptiveSendingState.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/SendPriorityPolicy.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/ShutdownReport.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/ReportedValue.h
+    ${CMAKE_SOURCE_DIR}/include/OpenKit/SamplingRule.h
     ${CMAKE_SOURCE_DIR}/include/OpenKit.h
 )
 
@@ -58,6 +66,10 @@ set(OPENKIT_SOURCES_CACHING
     ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconCacheEvictor.h
     ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconCacheRecord.cxx
     ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconCacheRecord.h
+    ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconChunkStore.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconChunkStore.h
+    ${CMAKE_CURRENT_LIST_DIR}/caching/BufferedBeaconCache.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/caching/BufferedBeaconCache.h
     ${CMAKE_CURRENT_LIST_DIR}/caching/IBeaconCache.h
     ${CMAKE_CURRENT_LIST_DIR}/caching/IObserver.h
     ${CMAKE_CURRENT_LIST_DIR}/caching/SpaceEvictionStrategy.cxx
@@ -79,10 +91,16 @@ set(OPENKIT_SOURCES_COMMUNICATION
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingFlushSessionsState.h
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingInitialState.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingInitialState.h
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingOpenSessionScheduler.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingOpenSessionScheduler.h
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingRequestUtil.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingRequestUtil.h
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingResponseUtil.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingResponseUtil.h
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingRetryScheduler.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingRetryScheduler.h
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingSessionPrioritizer.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingSessionPrioritizer.h
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingTerminalState.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingTerminalState.h
 )
@@ -100,9 +118,15 @@ set(OPENKIT_SOURCES_CONFIGURATION
     ${CMAKE_CURRENT_LIST_DIR}/configuration/HTTPClientConfiguration.h
     ${CMAKE_CURRENT_LIST_DIR}/configuration/OpenKitType.cxx
     ${CMAKE_CURRENT_LIST_DIR}/configuration/OpenKitType.h
+    ${CMAKE_CURRENT_LIST_DIR}/configuration/RetryPolicy.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/configuration/RetryPolicy.h
+    ${CMAKE_CURRENT_LIST_DIR}/configuration/StoreAndForwardConfiguration.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/configuration/StoreAndForwardConfiguration.h
 )
 
 set(OPENKIT_SOURCES_CORE_UTIL
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/AdaptiveCompressor.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/AdaptiveCompressor.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/Compressor.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/Compressor.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/CountDownLatch.cxx
@@ -111,16 +135,26 @@ set(OPENKIT_SOURCES_CORE_UTIL
     ${CMAKE_CURRENT_LIST_DIR}/core/util/CyclicBarrier.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/DefaultLogger.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/DefaultLogger.h
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/GzipCompressor.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/GzipCompressor.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/InetAddressValidator.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/InetAddressValidator.h
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/ObjectArena.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/ObjectArena.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/ReadWriteLock.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/ScopedReadLock.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/ScopedWriteLock.h
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/OpenActionSet.h
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/SingleProducerQueue.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/SynchronizedQueue.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/URLEncoding.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/URLEncoding.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/StringUtil.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/StringUtil.h
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/WakeupEvent.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/WakeupEvent.h
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/WorkStealingThreadPool.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/WorkStealingThreadPool.h
 )
 
 set(OPENKIT_SOURCES_CORE
@@ -140,6 +174,8 @@ set(OPENKIT_SOURCES_CORE
     ${CMAKE_CURRENT_LIST_DIR}/core/RootAction.h
     ${CMAKE_CURRENT_LIST_DIR}/core/Session.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/Session.h
+    ${CMAKE_CURRENT_LIST_DIR}/core/SessionRegistry.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/SessionRegistry.h
     ${CMAKE_CURRENT_LIST_DIR}/core/SessionWrapper.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/SessionWrapper.h
     ${CMAKE_CURRENT_LIST_DIR}/core/UTF8String.cxx
@@ -156,22 +192,44 @@ set(OPENKIT_SOURCES_PROTOCOL_SSL
 )
 
 set(OPENKIT_SOURCES_PROTOCOL
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/AdaptiveSendingController.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/AdaptiveSendingController.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/Beacon.cxx
     ${CMAKE_CURRENT_LIST_DIR}/protocol/Beacon.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/BeaconPayload.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/BeaconPayload.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/BeaconProtocolConstants.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/EventType.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/EventSampler.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/EventSampler.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/HTTPClient.cxx
     ${CMAKE_CURRENT_LIST_DIR}/protocol/HTTPClient.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/HTTPResponseParser.cxx
     ${CMAKE_CURRENT_LIST_DIR}/protocol/HTTPResponseParser.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/IHTTPClient.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalForwarder.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalForwarder.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalForwarderProtocol.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalForwarderProtocol.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalSocket.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalSocket.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalSocketHTTPClient.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalSocketHTTPClient.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/Response.cxx
     ${CMAKE_CURRENT_LIST_DIR}/protocol/Response.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/StatusResponse.cxx
     ${CMAKE_CURRENT_LIST_DIR}/protocol/StatusResponse.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/TransferDeadline.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/TransferDeadline.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/UploadRateLimiter.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/UploadRateLimiter.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/ValueAggregator.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/ValueAggregator.h
 )
 
 set(OPENKIT_SOURCES_PROVIDERS
+    ${CMAKE_CURRENT_LIST_DIR}/providers/CoarseTimingProvider.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/providers/CoarseTimingProvider.h
     ${CMAKE_CURRENT_LIST_DIR}/providers/DefaultHTTPClientProvider.cxx
     ${CMAKE_CURRENT_LIST_DIR}/providers/DefaultHTTPClientProvider.h
     ${CMAKE_CURRENT_LIST_DIR}/providers/DefaultPRNGenerator.cxx
@@ -187,6 +245,8 @@ set(OPENKIT_SOURCES_PROVIDERS
     ${CMAKE_CURRENT_LIST_DIR}/providers/ISessionIDProvider.h
     ${CMAKE_CURRENT_LIST_DIR}/providers/IThreadIDProvider.h
     ${CMAKE_CURRENT_LIST_DIR}/providers/ITimingProvider.h
+    ${CMAKE_CURRENT_LIST_DIR}/providers/LocalSocketHTTPClientProvider.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/providers/LocalSocketHTTPClientProvider.h
 )
 
 set(OPENKIT_SOURCES_UTIL_JSON_CONSTANTS
@@ -332,6 +392,10 @@ function(build_open_kit)
         ${ZLIB_LIBRARY}
         ${CURL_LIBRARY}
     )
+    if (WIN32)
+        # local sockets of the local forwarder
+        set(OPENKIT_LIBS ${OPENKIT_LIBS} ws2_32)
+    endif()
 
     include(CompilerConfiguration)
     include(BuildFunctions)
@@ -32,6 +32,7 @@
 #include "protocol/ssl/SSLBlindTrustManager.h"
 
 #include <list>
+#include <vector>
 #include <exception>
 #include <assert.h>
 #include <string.h>
@@ -261,6 +262,7 @@ extern "C" {
 		int64_t beaconCacheUpperMemoryBoundary = -1;
 		DataCollectionLevel dataCollectionLevel = DATA_COLLECTION_LEVEL_USER_BEHAVIOR;
 		CrashReportingLevel crashReportingLevel = CRASH_REPORTING_LEVEL_OPT_IN_CRASHES;
+		CompressionMode compressionMode = COMPRESSION_MODE_DEFAULT;
 	} OpenKitConfigurationHandle;
 
 	struct OpenKitConfigurationHandle* createOpenKitConfigurationWithOrigAndHashedDeviceId(const char* endpointURL, const char* applicationID, int64_t deviceID, const char* origDeviceID)
@@ -414,6 +416,11 @@ extern "C" {
 		configurationHandle->crashReportingLevel = crashReportingLevel;
 	}
 
+	void useCompressionModeForConfiguration(struct OpenKitConfigurationHandle* configurationHandle, CompressionMode compressionMode)
+	{
+		configurationHandle->compressionMode = compressionMode;
+	}
+
 	//--------------
 	//  OpenKit
 	//--------------
@@ -528,6 +535,11 @@ extern "C" {
 		{
 			builder.withCrashReportingLevel((openkit::CrashReportingLevel)configurationHandle->crashReportingLevel);
 		}
+
+		if (configurationHandle->compressionMode < COMPRESSION_MODE_COUNT)
+		{
+			builder.withCompressionMode((openkit::CompressionMode)configurationHandle->compressionMode);
+		}
 	}
 
 	static OpenKitHandle* createOpenKitHandle(struct OpenKitConfigurationHandle* configurationHandle, std::shared_ptr<openkit::IOpenKit> openKit)
@@ -587,6 +599,25 @@ extern "C" {
 		return handle;
 	}
 
+	static void releaseOpenKitHandle(OpenKitHandle* openKitHandle)
+	{
+		// release shared pointer
+		openKitHandle->sharedPointer = nullptr;
+		openKitHandle->logger = nullptr;
+		if (openKitHandle->ownsTrustManagerHandle &&  openKitHandle->trustManagerHandle != nullptr)
+		{
+			destroyTrustManager(openKitHandle->trustManagerHandle);
+			openKitHandle->trustManagerHandle = nullptr;
+		}
+		if (openKitHandle->ownsLoggerHandle && openKitHandle->loggerHandle != nullptr)
+		{
+			destroyLogger(openKitHandle->loggerHandle);
+			openKitHandle->loggerHandle = nullptr;
+		}
+
+		delete openKitHandle;
+	}
+
 	void shutdownOpenKit(OpenKitHandle* openKitHandle)
 	{
 		// Sanity
@@ -601,23 +632,32 @@ extern "C" {
 			assert(openKitHandle->sharedPointer != nullptr);
 			openKitHandle->sharedPointer->shutdown();
 
-			// release shared pointer
-			openKitHandle->sharedPointer = nullptr;
-			openKitHandle->logger = nullptr;
-			if (openKitHandle->ownsTrustManagerHandle &&  openKitHandle->trustManagerHandle != nullptr)
-			{
-				destroyTrustManager(openKitHandle->trustManagerHandle);
-				openKitHandle->trustManagerHandle = nullptr;
-			}
-			if (openKitHandle->ownsLoggerHandle && openKitHandle->loggerHandle != nullptr)
-			{
-				destroyLogger(openKitHandle->loggerHandle);
-				openKitHandle->loggerHandle = nullptr;
-			}
+			releaseOpenKitHandle(openKitHandle);
+		}
+		CATCH_AND_LOG(openKitHandle)
+	}
+
+	bool shutdownOpenKitWithTimeout(OpenKitHandle* openKitHandle, int64_t timeoutMillis)
+	{
+		// Sanity
+		if (openKitHandle == nullptr)
+		{
+			return false;
+		}
 
-			delete openKitHandle;
+		TRY
+		{
+			// retrieve the OpenKit instance from the handle and call the respective method
+			assert(openKitHandle->sharedPointer != nullptr);
+			auto shutdownReport = openKitHandle->sharedPointer->shutdown(timeoutMillis);
+
+			releaseOpenKitHandle(openKitHandle);
+
+			return shutdownReport.numSessionsDropped == 0;
 		}
 		CATCH_AND_LOG(openKitHandle)
+
+		return false;
 	}
 
 	bool waitForInitCompletion(struct OpenKitHandle* openKitHandle)
@@ -753,6 +793,24 @@ extern "C" {
 		CATCH_AND_LOG(sessionHandle)
 	}
 
+	//--------------
+	//  Reported Values
+	//--------------
+
+	static void convertReportedValues(std::shared_ptr<openkit::ILogger> logger, const ReportedValue* values, size_t numValues, std::vector<openkit::ReportedValue>& converted)
+	{
+		converted.reserve(numValues);
+		for (size_t i = 0; i < numValues; i++)
+		{
+			if (values[i].type >= REPORTED_VALUE_TYPE_COUNT)
+			{
+				logger->warning("reportValues: type %d of entry %u is unknown, skipping the entry", static_cast<int32_t>(values[i].type), static_cast<uint32_t>(i));
+				continue;
+			}
+			converted.push_back({ values[i].name, (openkit::ReportedValueType)values[i].type, values[i].intValue, values[i].doubleValue, values[i].stringValue });
+		}
+	}
+
 	//--------------
 	//  Root Action
 	//--------------
@@ -866,6 +924,23 @@ extern "C" {
 		CATCH_AND_LOG(rootActionHandle)
 	}
 
+	void reportValuesOnRootAction(RootActionHandle* rootActionHandle, const ReportedValue* values, size_t numValues)
+	{
+		TRY
+		{
+			if (rootActionHandle && values)
+			{
+				std::vector<openkit::ReportedValue> convertedValues;
+				convertReportedValues(rootActionHandle->logger, values, numValues, convertedValues);
+
+				// retrieve the RootAction instance from the handle and call the respective method
+				assert(rootActionHandle->sharedPointer != nullptr);
+				rootActionHandle->sharedPointer->reportValues(convertedValues.data(), convertedValues.size());
+			}
+		}
+		CATCH_AND_LOG(rootActionHandle)
+	}
+
 	void reportErrorOnRootAction(RootActionHandle* rootActionHandle, const char* errorName, int32_t errorCode, const char* reason)
 	{
 		TRY
@@ -994,6 +1069,23 @@ extern "C" {
 		CATCH_AND_LOG(actionHandle)
 	}
 
+	void reportValuesOnAction(ActionHandle* actionHandle, const ReportedValue* values, size_t numValues)
+	{
+		TRY
+		{
+			if (actionHandle && values)
+			{
+				std::vector<openkit::ReportedValue> convertedValues;
+				convertReportedValues(actionHandle->logger, values, numValues, convertedValues);
+
+				// retrieve the Action instance from the handle and call the respective method
+				assert(actionHandle->sharedPointer != nullptr);
+				actionHandle->sharedPointer->reportValues(convertedValues.data(), convertedValues.size());
+			}
+		}
+		CATCH_AND_LOG(actionHandle)
+	}
+
 	void reportErrorOnAction(ActionHandle* actionHandle, const char* errorName, int32_t errorCode, const char* reason)
 	{
 		TRY
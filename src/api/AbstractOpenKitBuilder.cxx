@@ -20,6 +20,19 @@
 #include "core/OpenKit.h"
 #include "OpenKit/OpenKitConstants.h"
 #include "protocol/ssl/SSLStrictTrustManager.h"
+#include "configuration/RetryPolicy.h"
+#include "protocol/AdaptiveSendingController.h"
+#include "core/util/AdaptiveCompressor.h"
+#include "core/util/Compressor.h"
+#include "core/util/GzipCompressor.h"
+#include "protocol/UploadRateLimiter.h"
+#include "providers/CoarseTimingProvider.h"
+#include "providers/DefaultHTTPClientProvider.h"
+#include "providers/DefaultThreadIDProvider.h"
+#include "providers/DefaultTimingProvider.h"
+#include "providers/LocalSocketHTTPClientProvider.h"
+
+#include <algorithm>
 
 using namespace openkit;
 
@@ -47,8 +60,34 @@ AbstractOpenKitBuilder::AbstractOpenKitBuilder(const char* endpointURL, int64_t
 	, mBeaconCacheMaxRecordAge(configuration::BeaconCacheConfiguration::DEFAULT_MAX_RECORD_AGE_IN_MILLIS.count())
 	, mBeaconCacheLowerMemoryBoundary(configuration::BeaconCacheConfiguration::DEFAULT_LOWER_MEMORY_BOUNDARY_IN_BYTES)
 	, mBeaconCacheUpperMemoryBoundary(configuration::BeaconCacheConfiguration::DEFAULT_UPPER_MEMORY_BOUNDARY_IN_BYTES)
+	, mBeaconCacheSessionFlushThreshold(configuration::BeaconCacheConfiguration::DEFAULT_SESSION_FLUSH_THRESHOLD_IN_BYTES)
+	, mIngestionDrainInterval(0)
+	, mMaxIngestionBufferSizePerThread(0)
 	, mDataCollectionLevel(configuration::BeaconConfiguration::DEFAULT_DATA_COLLECTION_LEVEL)
 	, mCrashReportingLevel(configuration::BeaconConfiguration::DEFAULT_CRASH_REPORTING_LEVEL)
+	, mConnectTimeout(configuration::RetryPolicy::DEFAULT_CONNECT_TIMEOUT.count())
+	, mReadTimeout(configuration::RetryPolicy::DEFAULT_READ_TIMEOUT.count())
+	, mMaxRetryAttempts(configuration::RetryPolicy::DEFAULT_MAX_RETRY_ATTEMPTS)
+	, mInitialRetryDelay(configuration::RetryPolicy::DEFAULT_INITIAL_RETRY_DELAY.count())
+	, mMaxRetryDelay(configuration::RetryPolicy::DEFAULT_MAX_RETRY_DELAY.count())
+	, mCompressionMode(CompressionMode::DEFAULT)
+	, mCompressor(nullptr)
+	, mUploadRateLimit(protocol::UploadRateLimiter::DEFAULT_BYTES_PER_SECOND)
+	, mUploadBurstSize(protocol::UploadRateLimiter::DEFAULT_BURST_SIZE)
+	, mBeaconSendingConcurrency(configuration::Configuration::DEFAULT_BEACON_SENDING_CONCURRENCY)
+	, mStaggerOpenSessionSending(false)
+	, mOpenSessionSendJitter(false)
+	, mMultiplicitySharingWindow(0)
+	, mSlowResponseThreshold(protocol::AdaptiveSendingController::DEFAULT_SLOW_RESPONSE_THRESHOLD)
+	, mSendPriorityPolicy(SendPriorityPolicy::INSERTION_ORDER)
+	, mLocalForwarderSocketPath()
+	, mStoreAndForwardDirectory()
+	, mMaxStoreSize(0)
+	, mMaxStoredChunkAge(0)
+	, mReplayBytesPerSecond(0)
+	, mSamplingRules()
+	, mValueAggregationInterval(-1)
+	, mCoarseTimestamps(false)
 {
 }
 
@@ -132,6 +171,19 @@ AbstractOpenKitBuilder& AbstractOpenKitBuilder::withBeaconCacheUpperMemoryBounda
 	return *this;
 }
 
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withBeaconCacheSessionFlushThreshold(int64_t sessionFlushThresholdInBytes)
+{
+	mBeaconCacheSessionFlushThreshold = sessionFlushThresholdInBytes;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withBufferedIngestion(int64_t drainIntervalInMilliseconds, int64_t maxBufferSizePerThreadInBytes)
+{
+	mIngestionDrainInterval = drainIntervalInMilliseconds;
+	mMaxIngestionBufferSizePerThread = maxBufferSizePerThreadInBytes;
+	return *this;
+}
+
 AbstractOpenKitBuilder& AbstractOpenKitBuilder::withDataCollectionLevel(DataCollectionLevel dataCollectionLevel)
 {
 	mDataCollectionLevel = dataCollectionLevel;
@@ -144,9 +196,146 @@ AbstractOpenKitBuilder& AbstractOpenKitBuilder::withCrashReportingLevel(CrashRep
 	return *this;
 }
 
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withConnectTimeout(int64_t connectTimeoutInMilliseconds)
+{
+	mConnectTimeout = connectTimeoutInMilliseconds;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withReadTimeout(int64_t readTimeoutInMilliseconds)
+{
+	mReadTimeout = readTimeoutInMilliseconds;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withMaxRetryAttempts(int32_t maxRetryAttempts)
+{
+	mMaxRetryAttempts = maxRetryAttempts;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withInitialRetryDelay(int64_t initialRetryDelayInMilliseconds)
+{
+	mInitialRetryDelay = initialRetryDelayInMilliseconds;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withMaxRetryDelay(int64_t maxRetryDelayInMilliseconds)
+{
+	mMaxRetryDelay = maxRetryDelayInMilliseconds;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withCompressionMode(openkit::CompressionMode compressionMode)
+{
+	mCompressionMode = compressionMode;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withCompressor(std::shared_ptr<openkit::ICompressor> compressor)
+{
+	if (compressor != nullptr)
+	{
+		mCompressor = compressor;
+	}
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withUploadRateLimit(int64_t bytesPerSecond, int64_t burstSizeInBytes)
+{
+	mUploadRateLimit = bytesPerSecond;
+	mUploadBurstSize = burstSizeInBytes;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withBeaconSendingConcurrency(int32_t numThreads)
+{
+	mBeaconSendingConcurrency = numThreads;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withStaggeredOpenSessionSending(bool jitterEnabled)
+{
+	mStaggerOpenSessionSending = true;
+	mOpenSessionSendJitter = jitterEnabled;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withMultiplicitySharingWindow(int64_t windowInMilliseconds)
+{
+	mMultiplicitySharingWindow = windowInMilliseconds;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withAdaptiveSending(int64_t slowResponseThresholdInMilliseconds)
+{
+	mSlowResponseThreshold = slowResponseThresholdInMilliseconds;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withSendPriorityPolicy(SendPriorityPolicy sendPriorityPolicy)
+{
+	mSendPriorityPolicy = sendPriorityPolicy;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withLocalForwarder(const char* socketPath)
+{
+	mLocalForwarderSocketPath = socketPath != nullptr ? socketPath : "";
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withStoreAndForward(const char* directory, int64_t maxStoreSizeInBytes, int64_t maxChunkAgeInMilliseconds, int64_t replayBytesPerSecond)
+{
+	mStoreAndForwardDirectory = directory != nullptr ? directory : "";
+	mMaxStoreSize = maxStoreSizeInBytes;
+	mMaxStoredChunkAge = maxChunkAgeInMilliseconds;
+	mReplayBytesPerSecond = replayBytesPerSecond;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withSamplingRule(openkit::SampledEventType eventType, const char* name, double sampleRate, double maxEventsPerSecond)
+{
+	mSamplingRules.push_back(openkit::SamplingRule(eventType, name != nullptr ? name : "", std::min(std::max(sampleRate, 0.0), 1.0), maxEventsPerSecond));
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withValueAggregation(int64_t flushIntervalInMilliseconds)
+{
+	mValueAggregationInterval = flushIntervalInMilliseconds;
+	return *this;
+}
+
+AbstractOpenKitBuilder& AbstractOpenKitBuilder::withCoarseTimestamps()
+{
+	mCoarseTimestamps = true;
+	return *this;
+}
+
 std::shared_ptr<openkit::IOpenKit> AbstractOpenKitBuilder::build()
 {
-	auto openKit = std::make_shared<core::OpenKit>(getLogger(), buildConfiguration());
+	std::shared_ptr<providers::IHTTPClientProvider> httpClientProvider;
+	if (mLocalForwarderSocketPath.empty())
+	{
+		httpClientProvider = std::make_shared<providers::DefaultHTTPClientProvider>();
+	}
+	else
+	{
+		httpClientProvider = std::make_shared<providers::LocalSocketHTTPClientProvider>(mLocalForwarderSocketPath);
+	}
+
+	std::shared_ptr<providers::ITimingProvider> timingProvider;
+	if (mCoarseTimestamps)
+	{
+		timingProvider = std::make_shared<providers::CoarseTimingProvider>();
+	}
+	else
+	{
+		timingProvider = std::make_shared<providers::DefaultTimingProvider>();
+	}
+
+	auto openKit = std::make_shared<core::OpenKit>(getLogger(), buildConfiguration(), httpClientProvider,
+		timingProvider, std::make_shared<providers::DefaultThreadIDProvider>());
 	openKit->initialize();
 	return openKit;
 }
@@ -215,6 +404,21 @@ int64_t AbstractOpenKitBuilder::getBeaconCacheUpperMemoryBoundary() const
 	return mBeaconCacheUpperMemoryBoundary;
 }
 
+int64_t AbstractOpenKitBuilder::getBeaconCacheSessionFlushThreshold() const
+{
+	return mBeaconCacheSessionFlushThreshold;
+}
+
+int64_t AbstractOpenKitBuilder::getIngestionDrainInterval() const
+{
+	return mIngestionDrainInterval;
+}
+
+int64_t AbstractOpenKitBuilder::getMaxIngestionBufferSizePerThread() const
+{
+	return mMaxIngestionBufferSizePerThread;
+}
+
 openkit::DataCollectionLevel AbstractOpenKitBuilder::getDataCollectionLevel() const
 {
 	return mDataCollectionLevel;
@@ -223,4 +427,132 @@ openkit::DataCollectionLevel AbstractOpenKitBuilder::getDataCollectionLevel() co
 openkit::CrashReportingLevel AbstractOpenKitBuilder::getCrashReportingLevel() const
 {
 	return mCrashReportingLevel;
-}
\ No newline at end of file
+}
+
+int64_t AbstractOpenKitBuilder::getConnectTimeout() const
+{
+	return mConnectTimeout;
+}
+
+int64_t AbstractOpenKitBuilder::getReadTimeout() const
+{
+	return mReadTimeout;
+}
+
+int32_t AbstractOpenKitBuilder::getMaxRetryAttempts() const
+{
+	return mMaxRetryAttempts;
+}
+
+int64_t AbstractOpenKitBuilder::getInitialRetryDelay() const
+{
+	return mInitialRetryDelay;
+}
+
+int64_t AbstractOpenKitBuilder::getMaxRetryDelay() const
+{
+	return mMaxRetryDelay;
+}
+
+openkit::CompressionMode AbstractOpenKitBuilder::getCompressionMode() const
+{
+	return mCompressionMode;
+}
+
+std::shared_ptr<openkit::ICompressor> AbstractOpenKitBuilder::getCompressor() const
+{
+	if (mCompressor != nullptr)
+	{
+		return mCompressor;
+	}
+
+	switch (mCompressionMode)
+	{
+	case CompressionMode::FAST:
+		return std::make_shared<core::util::GzipCompressor>(base::util::Compressor::FASTEST_COMPRESSION_LEVEL);
+	case CompressionMode::ADAPTIVE:
+		return std::make_shared<core::util::AdaptiveCompressor>();
+	default:
+		return std::make_shared<core::util::GzipCompressor>(base::util::Compressor::DEFAULT_COMPRESSION_LEVEL);
+	}
+}
+
+int64_t AbstractOpenKitBuilder::getUploadRateLimit() const
+{
+	return mUploadRateLimit;
+}
+
+int64_t AbstractOpenKitBuilder::getUploadBurstSize() const
+{
+	return mUploadBurstSize;
+}
+
+int32_t AbstractOpenKitBuilder::getBeaconSendingConcurrency() const
+{
+	return mBeaconSendingConcurrency;
+}
+
+bool AbstractOpenKitBuilder::isOpenSessionSendStaggered() const
+{
+	return mStaggerOpenSessionSending;
+}
+
+bool AbstractOpenKitBuilder::isOpenSessionSendJitterEnabled() const
+{
+	return mOpenSessionSendJitter;
+}
+
+int64_t AbstractOpenKitBuilder::getMultiplicitySharingWindow() const
+{
+	return mMultiplicitySharingWindow;
+}
+
+int64_t AbstractOpenKitBuilder::getSlowResponseThreshold() const
+{
+	return mSlowResponseThreshold;
+}
+
+SendPriorityPolicy AbstractOpenKitBuilder::getSendPriorityPolicy() const
+{
+	return mSendPriorityPolicy;
+}
+
+const std::string& AbstractOpenKitBuilder::getLocalForwarderSocketPath() const
+{
+	return mLocalForwarderSocketPath;
+}
+
+const std::string& AbstractOpenKitBuilder::getStoreAndForwardDirectory() const
+{
+	return mStoreAndForwardDirectory;
+}
+
+int64_t AbstractOpenKitBuilder::getMaxStoreSize() const
+{
+	return mMaxStoreSize;
+}
+
+int64_t AbstractOpenKitBuilder::getMaxStoredChunkAge() const
+{
+	return mMaxStoredChunkAge;
+}
+
+int64_t AbstractOpenKitBuilder::getReplayBytesPerSecond() const
+{
+	return mReplayBytesPerSecond;
+}
+
+const std::vector<openkit::SamplingRule>& AbstractOpenKitBuilder::getSamplingRules() const
+{
+	return mSamplingRules;
+}
+
+int64_t AbstractOpenKitBuilder::getValueAggregationInterval() const
+{
+	return mValueAggregationInterval;
+}
+
+bool AbstractOpenKitBuilder::isCoarseTimestampsEnabled() const
+{
+	return mCoarseTimestamps;
+}
@@ -16,6 +16,10 @@
 
 #include "OpenKit/DynatraceOpenKitBuilder.h"
 #include "providers/DefaultSessionIDProvider.h"
+#include "providers/DefaultTimingProvider.h"
+#include "protocol/UploadRateLimiter.h"
+#include "protocol/AdaptiveSendingController.h"
+#include "protocol/EventSampler.h"
 #include "configuration/Configuration.h"
 
 using namespace openkit;
@@ -41,7 +45,10 @@ std::shared_ptr<configuration::Configuration> DynatraceOpenKitBuilder::buildConf
 	std::shared_ptr<configuration::BeaconCacheConfiguration> beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(
 			getBeaconCacheMaxRecordAge(),
 			getBeaconCacheLowerMemoryBoundary(),
-			getBeaconCacheUpperMemoryBoundary()
+			getBeaconCacheUpperMemoryBoundary(),
+			getBeaconCacheSessionFlushThreshold(),
+			getIngestionDrainInterval(),
+			getMaxIngestionBufferSizePerThread()
 		);
 
 	std::shared_ptr<configuration::BeaconConfiguration> beaconConfiguration = std::make_shared<configuration::BeaconConfiguration>(
@@ -50,6 +57,45 @@ std::shared_ptr<configuration::Configuration> DynatraceOpenKitBuilder::buildConf
 		getCrashReportingLevel()
 		);
 
+	std::shared_ptr<configuration::RetryPolicy> retryPolicy = std::make_shared<configuration::RetryPolicy>(
+		getConnectTimeout(),
+		getReadTimeout(),
+		getMaxRetryAttempts(),
+		getInitialRetryDelay(),
+		getMaxRetryDelay()
+		);
+
+	std::shared_ptr<protocol::UploadRateLimiter> uploadRateLimiter = std::make_shared<protocol::UploadRateLimiter>(
+		std::make_shared<providers::DefaultTimingProvider>(),
+		getUploadRateLimit(),
+		getUploadBurstSize()
+		);
+
+	std::shared_ptr<protocol::AdaptiveSendingController> adaptiveSendingController = std::make_shared<protocol::AdaptiveSendingController>(
+		getBeaconCacheUpperMemoryBoundary(),
+		getSlowResponseThreshold()
+		);
+
+	std::shared_ptr<configuration::StoreAndForwardConfiguration> storeAndForwardConfiguration = nullptr;
+	if (!getStoreAndForwardDirectory().empty())
+	{
+		storeAndForwardConfiguration = std::make_shared<configuration::StoreAndForwardConfiguration>(
+			getStoreAndForwardDirectory(),
+			getMaxStoreSize(),
+			getMaxStoredChunkAge(),
+			getReplayBytesPerSecond()
+			);
+	}
+
+	std::shared_ptr<protocol::EventSampler> eventSampler = nullptr;
+	if (!getSamplingRules().empty())
+	{
+		eventSampler = std::make_shared<protocol::EventSampler>(
+			getSamplingRules(),
+			std::make_shared<providers::DefaultTimingProvider>()
+			);
+	}
+
 	return std::make_shared<configuration::Configuration>(
 			device,
 			configuration::OpenKitType::Type::DYNATRACE,
@@ -62,7 +108,19 @@ std::shared_ptr<configuration::Configuration> DynatraceOpenKitBuilder::buildConf
 			std::make_shared<providers::DefaultSessionIDProvider>(),
 			getTrustManager(),
 			beaconCacheConfiguration,
-			beaconConfiguration
+			beaconConfiguration,
+			retryPolicy,
+			getCompressor(),
+			uploadRateLimiter,
+			getBeaconSendingConcurrency(),
+			isOpenSessionSendStaggered(),
+			isOpenSessionSendJitterEnabled(),
+			getMultiplicitySharingWindow(),
+			adaptiveSendingController,
+			getSendPriorityPolicy(),
+			storeAndForwardConfiguration,
+			eventSampler,
+			getValueAggregationInterval()
 		);
 }
 
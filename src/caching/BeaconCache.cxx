@@ -62,6 +62,18 @@ void BeaconCache::addEventData(int32_t beaconID, int64_t timestamp, const core::
 	onDataAdded();
 }
 
+void BeaconCache::addEventDataBatch(int32_t beaconID, int64_t timestamp, const std::vector<core::UTF8String>& data)
+{
+	std::vector<BeaconCacheRecord> eventRecords;
+	eventRecords.reserve(data.size());
+	for (const auto& eventData : data)
+	{
+		eventRecords.emplace_back(timestamp, eventData);
+	}
+
+	addRecords(beaconID, eventRecords, std::vector<BeaconCacheRecord>());
+}
+
 void BeaconCache::addActionData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data)
 {
 	if (mLogger->isDebugEnabled())
@@ -84,6 +96,42 @@ void BeaconCache::addActionData(int32_t beaconID, int64_t timestamp, const core:
 	onDataAdded();
 }
 
+void BeaconCache::addRecords(int32_t beaconID, const std::vector<BeaconCacheRecord>& eventRecords, const std::vector<BeaconCacheRecord>& actionRecords)
+{
+	if (eventRecords.empty() && actionRecords.empty())
+	{
+		return;
+	}
+
+	if (mLogger->isDebugEnabled())
+	{
+		mLogger->debug("BeaconCache addRecords(sn=%d, events=%u, actions=%u)", beaconID, static_cast<uint32_t>(eventRecords.size()), static_cast<uint32_t>(actionRecords.size()));
+	}
+
+	// get a reference to the cache entry
+	auto entry = getCachedEntryOrInsert(beaconID);
+
+	int64_t numBytes = 0;
+	std::unique_lock<std::mutex> lock(entry->getLock());
+	for (const auto& record : eventRecords)
+	{
+		entry->addEventData(record);
+		numBytes += record.getDataSizeInBytes();
+	}
+	for (const auto& record : actionRecords)
+	{
+		entry->addActionData(record);
+		numBytes += record.getDataSizeInBytes();
+	}
+	lock.unlock();
+
+	// update cache stats
+	mCacheSizeInBytes += numBytes;
+
+	// notify observers
+	onDataAdded();
+}
+
 void BeaconCache::deleteCacheEntry(int32_t beaconID)
 {
 	core::util::ScopedWriteLock lock(mGlobalCacheLock);
@@ -128,6 +176,19 @@ const core::UTF8String BeaconCache::getNextBeaconChunk(int32_t beaconID, const c
 	return entry->getChunk(chunkPrefix, maxSize, delimiter);
 }
 
+const core::UTF8String BeaconCache::getFollowingBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter)
+{
+	auto entry = getCachedEntry(beaconID);
+	if (entry == nullptr)
+	{
+		// a cache entry for the given beaconID does not exist
+		return core::UTF8String();
+	}
+
+	// data being sent was already copied when the current chunk was retrieved
+	return entry->getFollowingChunk(chunkPrefix, maxSize, delimiter);
+}
+
 void BeaconCache::removeChunkedData(int32_t beaconID)
 {
 	auto entry = getCachedEntry(beaconID);
@@ -295,7 +356,9 @@ uint32_t BeaconCache::evictRecordsByAge(int32_t beaconID, int64_t minTimestamp)
 	}
 
 	std::unique_lock<std::mutex> lock(entry->getLock());
+	auto numBytesBefore = entry->getTotalNumberOfBytes();
 	uint32_t numRecordsRemoved = entry->removeRecordsOlderThan(minTimestamp);
+	mCacheSizeInBytes -= numBytesBefore - entry->getTotalNumberOfBytes();
 	lock.unlock();
 
 	if (mLogger->isDebugEnabled())
@@ -316,7 +379,9 @@ uint32_t BeaconCache::evictRecordsByNumber(int32_t beaconID, uint32_t numRecords
 	}
 
 	std::unique_lock<std::mutex> lock(entry->getLock());
+	auto numBytesBefore = entry->getTotalNumberOfBytes();
 	uint32_t numRecordsRemoved = entry->removeOldestRecords(numRecords);
+	mCacheSizeInBytes -= numBytesBefore - entry->getTotalNumberOfBytes();
 	lock.unlock();
 
 	if (mLogger->isDebugEnabled())
@@ -354,4 +419,30 @@ bool BeaconCache::isEmpty(int32_t beaconID)
 	lock.unlock();
 	
 	return isEmpty;
+}
+
+int64_t BeaconCache::getNumBytes(int32_t beaconID)
+{
+	auto entry = getCachedEntry(beaconID);
+	if (entry == nullptr)
+	{
+		// already removed
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(entry->getLock());
+	return entry->getTotalNumberOfBytes();
+}
+
+int64_t BeaconCache::getOldestRecordTimestamp(int32_t beaconID)
+{
+	auto entry = getCachedEntry(beaconID);
+	if (entry == nullptr)
+	{
+		// already removed
+		return -1;
+	}
+
+	std::lock_guard<std::mutex> lock(entry->getLock());
+	return entry->getOldestRecordTimestamp();
 }
\ No newline at end of file
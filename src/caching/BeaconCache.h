@@ -65,12 +65,24 @@ namespace caching
 
 		virtual void addEventData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data) override;
 
+		virtual void addEventDataBatch(int32_t beaconID, int64_t timestamp, const std::vector<core::UTF8String>& data) override;
+
 		virtual void addActionData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data) override;
 
+		///
+		/// Adds records of one beacon at once, locking its cache entry and notifying the observers only once.
+		/// @param[in] beaconID The beacon's ID (aka Session ID) for which to add the records.
+		/// @param[in] eventRecords Event records in the order they were reported.
+		/// @param[in] actionRecords Action records in the order they were reported.
+		///
+		void addRecords(int32_t beaconID, const std::vector<BeaconCacheRecord>& eventRecords, const std::vector<BeaconCacheRecord>& actionRecords);
+
 		virtual void deleteCacheEntry(int32_t beaconID) override;
 
 		virtual const core::UTF8String getNextBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter) override;
 
+		virtual const core::UTF8String getFollowingBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter) override;
+
 		virtual void removeChunkedData(int32_t beaconID) override;
 
 		virtual void resetChunkedData(int32_t beaconID) override;
@@ -125,6 +137,10 @@ namespace caching
 
 		virtual bool isEmpty(int32_t beaconID) override;
 
+		virtual int64_t getNumBytes(int32_t beaconID) override;
+
+		virtual int64_t getOldestRecordTimestamp(int32_t beaconID) override;
+
 	private:
 		///
 		/// Get cached @ref BeaconCacheEntry or insert new one if nothing exists for given @c beaconID.
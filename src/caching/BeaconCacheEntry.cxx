@@ -16,6 +16,8 @@
 
 #include "BeaconCacheEntry.h"
 
+#include <algorithm>
+
 using namespace caching;
 
 BeaconCacheEntry::BeaconCacheEntry()
@@ -108,6 +110,45 @@ void BeaconCacheEntry::chunkifyDataList(core::UTF8String& chunk, std::list<Beaco
 	}
 }
 
+const core::UTF8String BeaconCacheEntry::getFollowingChunk(const core::UTF8String& chunkPrefix, size_t maxSize, const core::UTF8String& delimiter)
+{
+	core::UTF8String chunk;
+	chunk.concatenate(chunkPrefix);
+
+	// same order as in getNextChunk -> event data goes first, then action data
+	auto prefixLength = chunk.getStringLength();
+	chunkifyPendingDataList(chunk, mEventDataBeingSent, maxSize, delimiter);
+	chunkifyPendingDataList(chunk, mActionDataBeingSent, maxSize, delimiter);
+
+	if (chunk.getStringLength() == prefixLength)
+	{
+		// all data is part of the current chunk
+		return core::UTF8String();
+	}
+
+	return chunk;
+}
+
+void BeaconCacheEntry::chunkifyPendingDataList(core::UTF8String& chunk, std::list<BeaconCacheRecord>& dataBeingSent, size_t maxSize, const core::UTF8String& delimiter)
+{
+	// records marked for sending are always at the beginning of the list
+	auto it = dataBeingSent.begin();
+	while (it != dataBeingSent.end() && it->isMarkedForSending())
+	{
+		it++;
+	}
+
+	while (it != dataBeingSent.end() && chunk.getStringLength() <= maxSize)
+	{
+		it->markPending();
+
+		chunk.concatenate(delimiter);
+		chunk.concatenate(it->getData());
+
+		it++;
+	}
+}
+
 void BeaconCacheEntry::removeDataMarkedForSending()
 {
 	if (!hasDataToSend())
@@ -125,6 +166,10 @@ void BeaconCacheEntry::removeDataMarkedForSending()
 		}
 		else
 		{
+			if (it->isPending())
+			{
+				it->markForSending();
+			}
 			++it;
 		}
 	}
@@ -141,6 +186,10 @@ void BeaconCacheEntry::removeDataMarkedForSending()
 			}
 			else
 			{
+				if (it->isPending())
+				{
+					it->markForSending();
+				}
 				++it;
 			}
 		}
@@ -181,15 +230,30 @@ int64_t BeaconCacheEntry::getTotalNumberOfBytes() const
 	return mTotalNumBytes;
 }
 
+int64_t BeaconCacheEntry::getOldestRecordTimestamp() const
+{
+	// records are appended in chronological order, so only the first event and the first action are compared
+	if (mEventData.empty())
+	{
+		return mActionData.empty() ? -1 : mActionData.front().getTimestamp();
+	}
+	if (mActionData.empty())
+	{
+		return mEventData.front().getTimestamp();
+	}
+
+	return std::min(mEventData.front().getTimestamp(), mActionData.front().getTimestamp());
+}
+
 int32_t BeaconCacheEntry::removeRecordsOlderThan(int64_t minTimestamp)
 {
-	int32_t numRecordsRemoved = removeRecordsOlderThan(mEventData, minTimestamp);
-	numRecordsRemoved += removeRecordsOlderThan(mActionData, minTimestamp);
+	int32_t numRecordsRemoved = removeRecordsOlderThan(mEventData, minTimestamp, mTotalNumBytes);
+	numRecordsRemoved += removeRecordsOlderThan(mActionData, minTimestamp, mTotalNumBytes);
 
 	return numRecordsRemoved;
 }
 
-int32_t BeaconCacheEntry::removeRecordsOlderThan(std::list<BeaconCacheRecord>& records, int64_t minTimestamp)
+int32_t BeaconCacheEntry::removeRecordsOlderThan(std::list<BeaconCacheRecord>& records, int64_t minTimestamp, int64_t& totalNumBytes)
 {
 	int32_t numRecordsRemoved = 0;
 	auto it = records.begin();
@@ -198,6 +262,7 @@ int32_t BeaconCacheEntry::removeRecordsOlderThan(std::list<BeaconCacheRecord>& r
 		auto record = *it;
 		if (record.getTimestamp() < minTimestamp)
 		{
+			totalNumBytes -= record.getDataSizeInBytes();
 			it = records.erase(it);
 			numRecordsRemoved++;
 		}
@@ -222,11 +287,13 @@ int32_t BeaconCacheEntry::removeOldestRecords(int32_t numRecords)
 		if (eventsIterator == mEventData.end())
 		{
 			// actions is not empty -> remove action
+			mTotalNumBytes -= actionsIterator->getDataSizeInBytes();
 			actionsIterator = mActionData.erase(actionsIterator);
 		}
 		else if (actionsIterator == mActionData.end())
 		{
 			// events is not empty -> remove event
+			mTotalNumBytes -= eventsIterator->getDataSizeInBytes();
 			eventsIterator = mEventData.erase(eventsIterator);
 		}
 		else
@@ -235,11 +302,13 @@ int32_t BeaconCacheEntry::removeOldestRecords(int32_t numRecords)
 			if ((*actionsIterator).getTimestamp() < (*eventsIterator).getTimestamp())
 			{
 				// first action is older than first event
+				mTotalNumBytes -= actionsIterator->getDataSizeInBytes();
 				actionsIterator = mActionData.erase(actionsIterator);
 			}
 			else
 			{
 				// first event is older than first action
+				mTotalNumBytes -= eventsIterator->getDataSizeInBytes();
 				eventsIterator = mEventData.erase(eventsIterator);
 			}
 		}
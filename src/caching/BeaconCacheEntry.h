@@ -86,13 +86,29 @@ namespace caching
 		///
 		const core::UTF8String getChunk(const core::UTF8String& chunkPrefix, size_t maxSize, const core::UTF8String& delimiter);
 
+		///
+		/// Get the data chunk following the chunk returned by the last call to @ref getChunk.
+		///
+		/// The records are marked as pending and become marked for sending once the current chunk
+		/// is removed by @ref removeDataMarkedForSending, so that the following chunk can be prepared
+		/// while the current one is sent. This method is called from beacon sending thread.
+		///
+		/// @param[in] chunkPrefix The prefix to add to each chunk.
+		/// @param[in] maxSize     The maximum size in characters for one chunk.
+		/// @param[in] delimiter   The delimiter between data chunks.
+		/// @return The string to send or an empty string if there is no more data to send.
+		///
+		const core::UTF8String getFollowingChunk(const core::UTF8String& chunkPrefix, size_t maxSize, const core::UTF8String& delimiter);
+
 		///
 		/// Remove data that was previously marked for sending when @ref getNextChunk was called.
 		///
+		/// Data marked as pending by @ref getFollowingChunk becomes marked for sending.
+		///
 		void removeDataMarkedForSending();
 
 		///
-		/// This method removes the marked for sending and prepends the copied data back to the data.
+		/// This method removes the marked for sending and pending flags and prepends the copied data back to the data.
 		///
 		void resetDataMarkedForSending();
 
@@ -107,6 +123,15 @@ namespace caching
 		///
 		int64_t getTotalNumberOfBytes() const;
 
+		///
+		/// Get the timestamp of the oldest record, which is the first one to be evicted.
+		///
+		/// Note: Like @ref getTotalNumberOfBytes only records which are not being sent are taken into account.
+		///
+		/// @return The oldest record's timestamp or @c -1 if there are no records.
+		///
+		int64_t getOldestRecordTimestamp() const;
+
 		///
 		/// Remove all @ref BeaconCacheRecord from event and action data which are older than given minTimestamp
 		///
@@ -183,13 +208,23 @@ namespace caching
 		///
 		static void chunkifyDataList(core::UTF8String& chunk, std::list<BeaconCacheRecord>& dataBeingSent, size_t maxSize, const core::UTF8String& delimiter);
 
+		///
+		/// Like @ref chunkifyDataList, but skips the records already marked for sending and marks the appended records as pending.
+		/// param[in,out] chunk the chunk to which the data is appended
+		/// param[in] dataBeingSent the list of record containing the data to append
+		/// param[in] maxSize in characters for one chunk. Up to this size data (if available) is appended
+		/// param[in] delimiter the delimiter between data chunks
+		///
+		static void chunkifyPendingDataList(core::UTF8String& chunk, std::list<BeaconCacheRecord>& dataBeingSent, size_t maxSize, const core::UTF8String& delimiter);
+
 		///
 		/// Remove all @ref BeaconCacheRecord from @c records.
 		/// @param[in,out] records list of cache records
 		/// @param[in] minTimestamp The minimum timestamp allowed.
+		/// @param[in,out] totalNumBytes The number of bytes, from which the size of the removed records is subtracted.
 		/// @return The number of records removed from @c records.
 		///
-		static int32_t removeRecordsOlderThan(std::list<BeaconCacheRecord>& records, int64_t minTimestamp);
+		static int32_t removeRecordsOlderThan(std::list<BeaconCacheRecord>& records, int64_t minTimestamp, int64_t& totalNumBytes);
 
 	private:
 
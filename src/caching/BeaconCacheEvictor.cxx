@@ -102,13 +102,10 @@ bool BeaconCacheEvictor::stop(std::chrono::milliseconds timeout)
 	
 	// Instead of join() (=waiting for the thread to terminate) we detach the thread and wait up to the timeout time
 	mEvictionThread->detach();
-	std::chrono::steady_clock clock;
-	auto t0 = clock.now();
-	auto t1 = t0 + timeout;
-
-	while (mRunning && clock.now() < t1)
 	{
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		// the eviction thread notifies when it terminates, so there is no need to poll
+		std::unique_lock<std::mutex> lock(mMutex);
+		mConditionVariable.wait_for(lock, timeout, [this] { return !mRunning; });
 	}
 	mEvictionThread = nullptr;
 
@@ -199,6 +196,9 @@ void BeaconCacheEvictor::cacheEvictionLoopFunc()
 	std::unique_lock<std::mutex> lock(mMutex);
 	mRunning = false;
 
+	// let a pending stop() return
+	mConditionVariable.notify_all();
+
 	if (mLogger->isDebugEnabled())
 	{
 		mLogger->debug("BeaconCacheEvictor cacheEvictionLoopFunc() - BeaconCacheEviction thread is stopped.");
@@ -22,6 +22,7 @@ BeaconCacheRecord::BeaconCacheRecord(int64_t timestamp, const core::UTF8String&
 	: mTimestamp(timestamp)
 	, mData(data)
 	, mMarkedForSending(false)
+	, mPending(false)
 {
 
 }
@@ -53,9 +54,21 @@ bool BeaconCacheRecord::isMarkedForSending() const
 void BeaconCacheRecord::markForSending()
 {
 	mMarkedForSending = true;
+	mPending = false;
+}
+
+bool BeaconCacheRecord::isPending() const
+{
+	return mPending;
+}
+
+void BeaconCacheRecord::markPending()
+{
+	mPending = true;
 }
 
 void BeaconCacheRecord::unsetSending()
 {
 	mMarkedForSending = false;
+	mPending = false;
 }
\ No newline at end of file
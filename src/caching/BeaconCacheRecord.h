@@ -68,7 +68,18 @@ namespace caching
 		void markForSending();
 
 		///
-		/// Reset marked for sending flag (@ref isMarkedForSending()).
+		/// Test if this record is part of a following chunk, which is prepared while the current chunk is sent.
+		/// @return @c true if this record was previously marked as pending, @c false otherwise.
+		///
+		bool isPending() const;
+
+		///
+		/// Mark this record as part of the following chunk (@ref isPending()).
+		///
+		void markPending();
+
+		///
+		/// Reset marked for sending and pending flags (@ref isMarkedForSending(), @ref isPending()).
 		///
 		void unsetSending();
 
@@ -81,6 +92,9 @@ namespace caching
 
 		/// Indicates if this record is marked for sending
 		bool mMarkedForSending;
+
+		/// Indicates if this record is part of the following chunk
+		bool mPending;
 	};
 
 }
@@ -0,0 +1,335 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "caching/BeaconChunkStore.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32) || defined(WIN32)
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+using namespace caching;
+
+/// identifies a chunk file and the version of its layout
+static const char CHUNK_FILE_MAGIC[] = "OKC4";
+
+/// extension of complete chunk files
+static const char CHUNK_FILE_EXTENSION[] = ".chunk";
+
+/// extension of chunk files being written
+static const char TEMPORARY_FILE_EXTENSION[] = ".tmp";
+
+///
+/// Reads the header of a chunk file
+/// @param[in] file the chunk file positioned at its start
+/// @param[out] timestamp time when the chunk was stored
+/// @param[out] clientIPAddressLength length of the client IP address following the header
+/// @param[out] chunkPrefixLength length of the chunk prefix following the client IP address
+/// @param[out] isCompressed whether the content following the chunk prefix is gzip compressed
+/// @param[out] contentLength length of the content following the chunk prefix
+/// @returns @c true if a valid header was read, @c false otherwise
+///
+static bool readHeader(std::istream& file, int64_t& timestamp, int64_t& clientIPAddressLength, int64_t& chunkPrefixLength,
+	bool& isCompressed, int64_t& contentLength)
+{
+	std::string magic;
+	int32_t compression = -1;
+	file >> magic >> timestamp >> clientIPAddressLength >> chunkPrefixLength >> compression >> contentLength;
+	isCompressed = compression == 1;
+	if (!file || magic != CHUNK_FILE_MAGIC || clientIPAddressLength < 0 || chunkPrefixLength < 0
+		|| (compression != 0 && compression != 1) || contentLength < 0)
+	{
+		return false;
+	}
+
+	// skip the line break terminating the header
+	return file.get() == '\n';
+}
+
+static bool createDirectory(const std::string& directory)
+{
+#if defined(_WIN32) || defined(WIN32)
+	return _mkdir(directory.c_str()) == 0 || errno == EEXIST;
+#else
+	return mkdir(directory.c_str(), 0700) == 0 || errno == EEXIST;
+#endif
+}
+
+static std::vector<std::string> listDirectory(const std::string& directory)
+{
+	std::vector<std::string> fileNames;
+#if defined(_WIN32) || defined(WIN32)
+	WIN32_FIND_DATAA findData;
+	HANDLE findHandle = FindFirstFileA((directory + "\\*").c_str(), &findData);
+	if (findHandle != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			fileNames.push_back(findData.cFileName);
+		} while (FindNextFileA(findHandle, &findData));
+		FindClose(findHandle);
+	}
+#else
+	DIR* dir = opendir(directory.c_str());
+	if (dir != nullptr)
+	{
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != nullptr)
+		{
+			fileNames.push_back(entry->d_name);
+		}
+		closedir(dir);
+	}
+#endif
+	return fileNames;
+}
+
+static bool endsWith(const std::string& value, const std::string& suffix)
+{
+	return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+BeaconChunkStore::BeaconChunkStore(std::shared_ptr<openkit::ILogger> logger, const std::string& directory, int64_t maxSize, int64_t maxAge)
+	: mLogger(logger)
+	, mDirectory(directory)
+	, mMaxSize(maxSize)
+	, mMaxAge(maxAge)
+	, mChunks()
+	, mNumBytes(0)
+	, mNextSequenceNumber(0)
+	, mMutex()
+{
+	if (!createDirectory(mDirectory))
+	{
+		mLogger->warning("BeaconChunkStore - Cannot create directory '%s', chunks cannot be stored", mDirectory.c_str());
+		return;
+	}
+
+	scanDirectory();
+}
+
+bool BeaconChunkStore::store(const core::UTF8String& clientIPAddress, const core::UTF8String& chunkPrefix, const protocol::BeaconPayload& payload,
+	int64_t timestamp)
+{
+	std::ostringstream header;
+	header << CHUNK_FILE_MAGIC << ' ' << timestamp << ' ' << clientIPAddress.getStringData().size() << ' ' << chunkPrefix.getStringData().size() << ' '
+		<< (payload.isCompressed() ? 1 : 0) << ' ' << payload.getContentSize() << '\n';
+	auto headerData = header.str();
+
+	auto size = static_cast<int64_t>(headerData.size() + clientIPAddress.getStringData().size() + chunkPrefix.getStringData().size()
+		+ payload.getContentSize());
+	if (size > mMaxSize)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// make room by dropping the oldest chunks
+	while (!mChunks.empty() && mNumBytes + size > mMaxSize)
+	{
+		removeChunk(mChunks.begin());
+	}
+
+	// write to a temporary file first, so that a partially written chunk is never picked up
+	auto sequenceNumber = mNextSequenceNumber++;
+	auto chunkPath = getChunkPath(sequenceNumber);
+	auto temporaryPath = chunkPath + TEMPORARY_FILE_EXTENSION;
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		file.write(headerData.data(), headerData.size());
+		file.write(clientIPAddress.getStringData().data(), clientIPAddress.getStringData().size());
+		file.write(chunkPrefix.getStringData().data(), chunkPrefix.getStringData().size());
+		file.write(reinterpret_cast<const char*>(payload.getContent()), payload.getContentSize());
+		if (!file)
+		{
+			file.close();
+			std::remove(temporaryPath.c_str());
+			mLogger->warning("BeaconChunkStore store() - Cannot write chunk file '%s'", temporaryPath.c_str());
+			return false;
+		}
+	}
+	if (std::rename(temporaryPath.c_str(), chunkPath.c_str()) != 0)
+	{
+		std::remove(temporaryPath.c_str());
+		mLogger->warning("BeaconChunkStore store() - Cannot write chunk file '%s'", chunkPath.c_str());
+		return false;
+	}
+
+	mChunks[sequenceNumber] = ChunkInfo{ timestamp, size };
+	mNumBytes += size;
+	return true;
+}
+
+bool BeaconChunkStore::loadOldest(StoredChunk& chunk)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	while (!mChunks.empty())
+	{
+		auto it = mChunks.begin();
+
+		std::ifstream file(getChunkPath(it->first), std::ios::binary);
+		int64_t timestamp = 0;
+		int64_t clientIPAddressLength = 0;
+		int64_t chunkPrefixLength = 0;
+		auto isCompressed = false;
+		int64_t contentLength = 0;
+		if (file && readHeader(file, timestamp, clientIPAddressLength, chunkPrefixLength, isCompressed, contentLength)
+			&& clientIPAddressLength + chunkPrefixLength + contentLength <= it->second.size)
+		{
+			std::string clientIPAddress(static_cast<size_t>(clientIPAddressLength), '\0');
+			std::string chunkPrefix(static_cast<size_t>(chunkPrefixLength), '\0');
+			std::vector<unsigned char> content(static_cast<size_t>(contentLength));
+			file.read(&clientIPAddress[0], clientIPAddress.size());
+			file.read(&chunkPrefix[0], chunkPrefix.size());
+			file.read(reinterpret_cast<char*>(content.data()), content.size());
+			if (file)
+			{
+				chunk.sequenceNumber = it->first;
+				chunk.timestamp = timestamp;
+				chunk.clientIPAddress = core::UTF8String(clientIPAddress);
+				chunk.chunkPrefix = core::UTF8String(chunkPrefix);
+				chunk.payload = isCompressed
+					? protocol::BeaconPayload(std::move(content))
+					: protocol::BeaconPayload(core::UTF8String(std::string(content.begin(), content.end())));
+				return true;
+			}
+		}
+
+		mLogger->warning("BeaconChunkStore loadOldest() - Cannot read chunk file '%s', dropping it", getChunkPath(it->first).c_str());
+		removeChunk(it);
+	}
+
+	return false;
+}
+
+void BeaconChunkStore::remove(uint64_t sequenceNumber)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mChunks.find(sequenceNumber);
+	if (it != mChunks.end())
+	{
+		removeChunk(it);
+	}
+}
+
+void BeaconChunkStore::evictExpired(int64_t timestamp)
+{
+	if (mMaxAge <= 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mChunks.begin();
+	while (it != mChunks.end())
+	{
+		auto current = it++;
+		if (timestamp - current->second.timestamp > mMaxAge)
+		{
+			removeChunk(current);
+		}
+	}
+}
+
+bool BeaconChunkStore::isEmpty() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mChunks.empty();
+}
+
+size_t BeaconChunkStore::getNumChunks() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mChunks.size();
+}
+
+int64_t BeaconChunkStore::getNumBytes() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mNumBytes;
+}
+
+void BeaconChunkStore::scanDirectory()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (const auto& fileName : listDirectory(mDirectory))
+	{
+		auto path = mDirectory + "/" + fileName;
+		if (endsWith(fileName, TEMPORARY_FILE_EXTENSION))
+		{
+			// left over by an interrupted write
+			std::remove(path.c_str());
+			continue;
+		}
+		if (!endsWith(fileName, CHUNK_FILE_EXTENSION))
+		{
+			continue;
+		}
+
+		uint64_t sequenceNumber = 0;
+		std::istringstream name(fileName.substr(0, fileName.size() - (sizeof(CHUNK_FILE_EXTENSION) - 1)));
+		name >> sequenceNumber;
+
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		auto size = static_cast<int64_t>(file.tellg());
+		file.seekg(0);
+		int64_t timestamp = 0;
+		int64_t clientIPAddressLength = 0;
+		int64_t chunkPrefixLength = 0;
+		auto isCompressed = false;
+		int64_t contentLength = 0;
+		if (name.fail() || !file || !readHeader(file, timestamp, clientIPAddressLength, chunkPrefixLength, isCompressed, contentLength))
+		{
+			// damaged or written in an outdated layout
+			file.close();
+			std::remove(path.c_str());
+			continue;
+		}
+
+		mChunks[sequenceNumber] = ChunkInfo{ timestamp, size };
+		mNumBytes += size;
+		if (sequenceNumber >= mNextSequenceNumber)
+		{
+			mNextSequenceNumber = sequenceNumber + 1;
+		}
+	}
+}
+
+std::string BeaconChunkStore::getChunkPath(uint64_t sequenceNumber) const
+{
+	// zero padded, so that the files are listed in the order they were stored
+	char fileName[32];
+	std::snprintf(fileName, sizeof(fileName), "%020llu", static_cast<unsigned long long>(sequenceNumber));
+	return mDirectory + "/" + fileName + CHUNK_FILE_EXTENSION;
+}
+
+void BeaconChunkStore::removeChunk(std::map<uint64_t, ChunkInfo>::iterator it)
+{
+	std::remove(getChunkPath(it->first).c_str());
+	mNumBytes -= it->second.size;
+	mChunks.erase(it);
+}
@@ -0,0 +1,188 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _CACHING_BEACONCHUNKSTORE_H
+#define _CACHING_BEACONCHUNKSTORE_H
+
+#include "OpenKit/ILogger.h"
+#include "core/UTF8String.h"
+#include "protocol/BeaconPayload.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace caching
+{
+	///
+	/// Store for beacon chunks which could not be sent, kept on local disk until the server accepts data again.
+	///
+	/// Chunks are stored assembled and encoded as for sending, one file per chunk, so that replaying them neither
+	/// assembles nor compresses them again. The chunk prefix is kept apart from the encoded records, since the
+	/// transmission time it lacks is only known when the chunk is replayed. The oldest chunks
+	/// are removed if storing a chunk would exceed the size budget, and chunks older than the maximum age are removed
+	/// by @ref evictExpired. Chunks found in the directory on construction, e.g. stored before the application
+	/// was restarted, are picked up again.
+	///
+	class BeaconChunkStore
+	{
+	public:
+		///
+		/// A chunk loaded from the store
+		///
+		struct StoredChunk
+		{
+			StoredChunk()
+				: sequenceNumber(0)
+				, timestamp(0)
+				, clientIPAddress()
+				, chunkPrefix()
+				, payload()
+			{
+			}
+
+			/// identifies the chunk within the store
+			uint64_t sequenceNumber;
+
+			/// time when the chunk was stored in milliseconds
+			int64_t timestamp;
+
+			/// the client IP address the chunk has to be sent with
+			core::UTF8String clientIPAddress;
+
+			/// the beacon data preceding the records, except for the transmission time
+			core::UTF8String chunkPrefix;
+
+			/// the encoded records of the chunk
+			protocol::BeaconPayload payload;
+		};
+
+		///
+		/// Constructor
+		/// @param[in] logger to write traces to
+		/// @param[in] directory the directory holding the chunk files, created if it does not exist
+		/// @param[in] maxSize maximum number of bytes stored
+		/// @param[in] maxAge maximum age of a chunk in milliseconds, or unbounded if not positive
+		///
+		BeaconChunkStore(std::shared_ptr<openkit::ILogger> logger, const std::string& directory, int64_t maxSize, int64_t maxAge);
+
+		///
+		/// Stores a chunk, removing the oldest chunks if the size budget would be exceeded otherwise.
+		/// @param[in] clientIPAddress the client IP address the chunk has to be sent with
+		/// @param[in] chunkPrefix the beacon data preceding the records, except for the transmission time
+		/// @param[in] payload the encoded records of the chunk
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns @c true if the chunk was stored, @c false if it exceeds the size budget or could not be written
+		///
+		bool store(const core::UTF8String& clientIPAddress, const core::UTF8String& chunkPrefix, const protocol::BeaconPayload& payload,
+			int64_t timestamp);
+
+		///
+		/// Loads the oldest chunk without removing it from the store.
+		/// @remarks Chunks which cannot be read are removed.
+		/// @param[out] chunk receives the loaded chunk
+		/// @returns @c true if a chunk was loaded, @c false if the store is empty
+		///
+		bool loadOldest(StoredChunk& chunk);
+
+		///
+		/// Removes a chunk, typically after it has been sent.
+		/// @param[in] sequenceNumber identifies the chunk to remove
+		///
+		void remove(uint64_t sequenceNumber);
+
+		///
+		/// Removes all chunks exceeding the maximum age.
+		/// @param[in] timestamp the current timestamp in milliseconds
+		///
+		void evictExpired(int64_t timestamp);
+
+		///
+		/// Returns whether the store holds any chunk
+		/// @returns @c true if no chunk is stored, @c false otherwise
+		///
+		bool isEmpty() const;
+
+		///
+		/// Returns the number of stored chunks
+		/// @returns the number of chunks
+		///
+		size_t getNumChunks() const;
+
+		///
+		/// Returns the size of all stored chunks
+		/// @returns the number of bytes stored
+		///
+		int64_t getNumBytes() const;
+
+	private:
+		///
+		/// Size and age of a stored chunk
+		///
+		struct ChunkInfo
+		{
+			/// time when the chunk was stored in milliseconds
+			int64_t timestamp;
+
+			/// size of the chunk file in bytes
+			int64_t size;
+		};
+
+		///
+		/// Adds the chunk files found in the directory to the index.
+		///
+		void scanDirectory();
+
+		///
+		/// Returns the path of the file holding the given chunk
+		///
+		std::string getChunkPath(uint64_t sequenceNumber) const;
+
+		///
+		/// Removes a chunk file and its index entry.
+		/// Must be called with @c mMutex held.
+		///
+		void removeChunk(std::map<uint64_t, ChunkInfo>::iterator it);
+
+		/// Logger to write traces to
+		std::shared_ptr<openkit::ILogger> mLogger;
+
+		/// the directory holding the chunk files
+		const std::string mDirectory;
+
+		/// maximum number of bytes stored
+		const int64_t mMaxSize;
+
+		/// maximum age of a chunk
+		const int64_t mMaxAge;
+
+		/// stored chunks, ordered from oldest to newest
+		std::map<uint64_t, ChunkInfo> mChunks;
+
+		/// size of all stored chunks
+		int64_t mNumBytes;
+
+		/// sequence number of the next chunk to store
+		uint64_t mNextSequenceNumber;
+
+		/// mutex protecting the index and the files
+		mutable std::mutex mMutex;
+	};
+}
+
+#endif
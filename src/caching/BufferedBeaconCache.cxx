@@ -0,0 +1,440 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "caching/BufferedBeaconCache.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+using namespace caching;
+
+const int64_t BufferedBeaconCache::DEFAULT_MAX_BUFFERED_BYTES_PER_THREAD = 64 * 1024;
+constexpr size_t BufferedBeaconCache::NUMBER_OF_SEQUENCE_STRIPES;
+
+/// source of the IDs identifying cache instances in the thread local buffer maps
+static std::atomic<uint64_t> gNextInstanceID(0);
+
+/// buffers of the calling thread, keyed by the ID of the cache they belong to
+static thread_local std::unordered_map<uint64_t, std::shared_ptr<BufferedBeaconCache::IngestionBuffer>> tThreadBuffers;
+
+BufferedBeaconCache::BufferedBeaconCache(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<BeaconCache> beaconCache, int64_t drainInterval,
+	int64_t maxBufferedBytesPerThread)
+	: mLogger(logger)
+	, mBeaconCache(beaconCache)
+	, mDrainInterval(drainInterval > 0 ? drainInterval : 1)
+	, mMaxBufferedBytesPerThread(maxBufferedBytesPerThread > 0 ? maxBufferedBytesPerThread : DEFAULT_MAX_BUFFERED_BYTES_PER_THREAD)
+	, mInstanceID(gNextInstanceID++)
+	, mBuffers()
+	, mBuffersMutex()
+	, mSequenceStripes()
+	, mNextSequenceNumbersToAdd()
+	, mHeldBackRecords()
+	, mNumHeldBackBytes(0)
+	, mDrainMutex()
+	, mDrainThread(nullptr)
+	, mStop(false)
+	, mIsStopped(false)
+	, mIsDrainerRunning(false)
+	, mIsDrainRequested(false)
+	, mMutex()
+	, mConditionVariable()
+{
+	mNextSequenceNumbersToAdd.fill(0);
+}
+
+BufferedBeaconCache::~BufferedBeaconCache()
+{
+	stop();
+
+	// threads still holding a buffer release it once they report to another cache or terminate
+	std::lock_guard<std::mutex> lock(mBuffersMutex);
+	for (auto& buffer : mBuffers)
+	{
+		buffer->isClosed = true;
+	}
+}
+
+bool BufferedBeaconCache::start()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mDrainThread != nullptr)
+	{
+		return false;
+	}
+
+	mStop = false;
+	mIsDrainerRunning = true;
+	mDrainThread = std::unique_ptr<std::thread>(new std::thread(&BufferedBeaconCache::drainLoopFunc, this));
+	return true;
+}
+
+bool BufferedBeaconCache::stop()
+{
+	std::unique_ptr<std::thread> drainThread;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mDrainThread == nullptr)
+		{
+			return false;
+		}
+		mStop = true;
+		mIsStopped = true;
+		mIsDrainerRunning = false;
+		mConditionVariable.notify_all();
+		drainThread = std::move(mDrainThread);
+	}
+
+	drainThread->join();
+
+	// records reported after the last drain of the thread, later records are drained by the reporting threads
+	drain();
+	return true;
+}
+
+void BufferedBeaconCache::drainLoopFunc()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mStop)
+	{
+		// a request set right before waiting is picked up with the next drain interval at the latest
+		mConditionVariable.wait_for(lock, mDrainInterval, [this]() { return mStop || mIsDrainRequested; });
+		mIsDrainRequested = false;
+		lock.unlock();
+		drainBuffers(nullptr);
+		lock.lock();
+	}
+}
+
+void BufferedBeaconCache::drain()
+{
+	drainBuffers(nullptr);
+}
+
+size_t BufferedBeaconCache::getSequenceStripe(int32_t beaconID)
+{
+	return static_cast<size_t>(static_cast<uint32_t>(beaconID)) % NUMBER_OF_SEQUENCE_STRIPES;
+}
+
+uint64_t BufferedBeaconCache::takeSequenceNumber(int32_t beaconID)
+{
+	return mSequenceStripes[getSequenceStripe(beaconID)].nextSequenceNumber.fetch_add(1);
+}
+
+void BufferedBeaconCache::requestDrain()
+{
+	if (!mIsDrainRequested.exchange(true))
+	{
+		mConditionVariable.notify_one();
+	}
+}
+
+void BufferedBeaconCache::drainBuffers(std::shared_ptr<IngestionBuffer> threadBuffer)
+{
+	std::lock_guard<std::mutex> drainLock(mDrainMutex);
+
+	// the records held back last time and the records of all threads, or of the calling thread only
+	std::vector<BufferedRecord> records;
+	records.swap(mHeldBackRecords);
+	std::vector<std::pair<std::shared_ptr<IngestionBuffer>, int64_t>> drainedBytes;
+	if (threadBuffer != nullptr)
+	{
+		int64_t numBytes = 0;
+		BufferedRecord record;
+		while (threadBuffer->records.pop(record))
+		{
+			numBytes += record.data.getStringData().size();
+			records.push_back(std::move(record));
+		}
+		drainedBytes.push_back(std::make_pair(threadBuffer, numBytes));
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(mBuffersMutex);
+		auto it = mBuffers.begin();
+		while (it != mBuffers.end())
+		{
+			// only this cache holds the buffer once its thread terminated, nothing can be added anymore
+			auto isAbandoned = it->use_count() == 1;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			int64_t numBytes = 0;
+			BufferedRecord record;
+			while ((*it)->records.pop(record))
+			{
+				numBytes += record.data.getStringData().size();
+				records.push_back(std::move(record));
+			}
+			if (numBytes > 0)
+			{
+				drainedBytes.push_back(std::make_pair(*it, numBytes));
+			}
+
+			if (isAbandoned)
+			{
+				it = mBuffers.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	// restore the reporting order of each stripe, a gap means a record is still being appended by its thread
+	std::sort(records.begin(), records.end(), [](const BufferedRecord& lhs, const BufferedRecord& rhs)
+	{
+		auto lhsStripe = getSequenceStripe(lhs.beaconID);
+		auto rhsStripe = getSequenceStripe(rhs.beaconID);
+		return lhsStripe != rhsStripe ? lhsStripe < rhsStripe : lhs.sequenceNumber < rhs.sequenceNumber;
+	});
+	std::vector<BufferedRecord> recordsToAdd;
+	recordsToAdd.reserve(records.size());
+	int64_t numHeldBackBytes = 0;
+	for (auto& record : records)
+	{
+		auto& nextSequenceNumber = mNextSequenceNumbersToAdd[getSequenceStripe(record.beaconID)];
+		if (record.sequenceNumber == nextSequenceNumber)
+		{
+			nextSequenceNumber++;
+			if (!record.isDiscarded)
+			{
+				recordsToAdd.push_back(std::move(record));
+			}
+		}
+		else
+		{
+			numHeldBackBytes += record.data.getStringData().size();
+			mHeldBackRecords.push_back(std::move(record));
+		}
+	}
+	records.swap(recordsToAdd);
+
+	// add one batch per beacon
+	std::vector<int32_t> beaconIDs;
+	std::unordered_map<int32_t, std::pair<std::vector<BeaconCacheRecord>, std::vector<BeaconCacheRecord>>> batches;
+	for (auto& record : records)
+	{
+		auto it = batches.find(record.beaconID);
+		if (it == batches.end())
+		{
+			beaconIDs.push_back(record.beaconID);
+			it = batches.insert(std::make_pair(record.beaconID, std::make_pair(std::vector<BeaconCacheRecord>(), std::vector<BeaconCacheRecord>()))).first;
+		}
+
+		auto& batch = record.isAction ? it->second.second : it->second.first;
+		batch.push_back(BeaconCacheRecord(record.timestamp, record.data));
+	}
+	for (auto beaconID : beaconIDs)
+	{
+		auto& batch = batches[beaconID];
+		mBeaconCache->addRecords(beaconID, batch.first, batch.second);
+	}
+
+	// the drained records are accounted for by the cache or as held back records now
+	mNumHeldBackBytes = numHeldBackBytes;
+	for (auto& drained : drainedBytes)
+	{
+		drained.first->numBytes -= drained.second;
+	}
+}
+
+BufferedBeaconCache::IngestionBuffer& BufferedBeaconCache::getThreadBuffer()
+{
+	auto it = tThreadBuffers.find(mInstanceID);
+	if (it != tThreadBuffers.end())
+	{
+		return *it->second;
+	}
+
+	// first record of this thread for this cache - release buffers of destroyed caches on the way
+	for (auto bufferIt = tThreadBuffers.begin(); bufferIt != tThreadBuffers.end();)
+	{
+		if (bufferIt->second->isClosed)
+		{
+			bufferIt = tThreadBuffers.erase(bufferIt);
+		}
+		else
+		{
+			++bufferIt;
+		}
+	}
+
+	auto buffer = std::make_shared<IngestionBuffer>();
+	{
+		std::lock_guard<std::mutex> lock(mBuffersMutex);
+		mBuffers.push_back(buffer);
+	}
+	tThreadBuffers[mInstanceID] = buffer;
+	return *buffer;
+}
+
+void BufferedBeaconCache::addRecord(int32_t beaconID, bool isAction, int64_t timestamp, const core::UTF8String& data)
+{
+	auto& buffer = getThreadBuffer();
+	auto recordBytes = static_cast<int64_t>(data.getStringData().size());
+	auto bufferedBytes = buffer.numBytes.load(std::memory_order_relaxed);
+	if (!mIsStopped && bufferedBytes > 0 && bufferedBytes + recordBytes > mMaxBufferedBytesPerThread)
+	{
+		if (mIsDrainerRunning)
+		{
+			// a burst faster than the drainer thread, make room by draining only this thread's buffer instead of dropping
+			drainBuffers(tThreadBuffers[mInstanceID]);
+			requestDrain();
+		}
+		else
+		{
+			// without drainer thread nobody else makes room in the buffer
+			drain();
+		}
+		bufferedBytes = buffer.numBytes.load(std::memory_order_relaxed);
+	}
+
+	BufferedRecord record;
+	record.beaconID = beaconID;
+	record.sequenceNumber = takeSequenceNumber(beaconID);
+	record.isAction = isAction;
+	record.timestamp = timestamp;
+	record.data = data;
+
+	buffer.numBytes.fetch_add(recordBytes);
+	buffer.records.push(std::move(record));
+
+	if (mIsStopped)
+	{
+		// nobody drains the buffers after stop
+		drain();
+	}
+	else if ((bufferedBytes + recordBytes) * 2 > mMaxBufferedBytesPerThread)
+	{
+		requestDrain();
+	}
+}
+
+void BufferedBeaconCache::addObserver(IObserver* observer)
+{
+	mBeaconCache->addObserver(observer);
+}
+
+void BufferedBeaconCache::addEventData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data)
+{
+	addRecord(beaconID, false, timestamp, data);
+}
+
+void BufferedBeaconCache::addEventDataBatch(int32_t beaconID, int64_t timestamp, const std::vector<core::UTF8String>& data)
+{
+	for (const auto& eventData : data)
+	{
+		addRecord(beaconID, false, timestamp, eventData);
+	}
+}
+
+void BufferedBeaconCache::addActionData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data)
+{
+	addRecord(beaconID, true, timestamp, data);
+}
+
+void BufferedBeaconCache::deleteCacheEntry(int32_t beaconID)
+{
+	drain();
+
+	std::lock_guard<std::mutex> drainLock(mDrainMutex);
+
+	// held back records must not create the entry again once the gap closes, but still occupy their sequence number
+	int64_t numDiscardedBytes = 0;
+	for (auto& record : mHeldBackRecords)
+	{
+		if (record.beaconID == beaconID && !record.isDiscarded)
+		{
+			numDiscardedBytes += record.data.getStringData().size();
+			record.isDiscarded = true;
+			record.data = core::UTF8String();
+		}
+	}
+	mNumHeldBackBytes -= numDiscardedBytes;
+
+	mBeaconCache->deleteCacheEntry(beaconID);
+}
+
+const core::UTF8String BufferedBeaconCache::getNextBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter)
+{
+	drain();
+	return mBeaconCache->getNextBeaconChunk(beaconID, chunkPrefix, maxSize, delimiter);
+}
+
+const core::UTF8String BufferedBeaconCache::getFollowingBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter)
+{
+	return mBeaconCache->getFollowingBeaconChunk(beaconID, chunkPrefix, maxSize, delimiter);
+}
+
+void BufferedBeaconCache::removeChunkedData(int32_t beaconID)
+{
+	mBeaconCache->removeChunkedData(beaconID);
+}
+
+void BufferedBeaconCache::resetChunkedData(int32_t beaconID)
+{
+	mBeaconCache->resetChunkedData(beaconID);
+}
+
+const std::unordered_set<int32_t> BufferedBeaconCache::getBeaconIDs()
+{
+	drain();
+	return mBeaconCache->getBeaconIDs();
+}
+
+uint32_t BufferedBeaconCache::evictRecordsByAge(int32_t beaconID, int64_t minTimestamp)
+{
+	return mBeaconCache->evictRecordsByAge(beaconID, minTimestamp);
+}
+
+uint32_t BufferedBeaconCache::evictRecordsByNumber(int32_t beaconID, uint32_t numRecords)
+{
+	return mBeaconCache->evictRecordsByNumber(beaconID, numRecords);
+}
+
+int64_t BufferedBeaconCache::getNumBytesInCache() const
+{
+	int64_t numBufferedBytes = mNumHeldBackBytes;
+	{
+		std::lock_guard<std::mutex> lock(mBuffersMutex);
+		for (const auto& buffer : mBuffers)
+		{
+			numBufferedBytes += buffer->numBytes;
+		}
+	}
+
+	return mBeaconCache->getNumBytesInCache() + numBufferedBytes;
+}
+
+bool BufferedBeaconCache::isEmpty(int32_t beaconID)
+{
+	drain();
+	return mBeaconCache->isEmpty(beaconID);
+}
+
+int64_t BufferedBeaconCache::getNumBytes(int32_t beaconID)
+{
+	drain();
+	return mBeaconCache->getNumBytes(beaconID);
+}
+
+int64_t BufferedBeaconCache::getOldestRecordTimestamp(int32_t beaconID)
+{
+	drain();
+	return mBeaconCache->getOldestRecordTimestamp(beaconID);
+}
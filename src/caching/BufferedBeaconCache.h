@@ -0,0 +1,308 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _CACHING_BUFFEREDBEACONCACHE_H
+#define _CACHING_BUFFEREDBEACONCACHE_H
+
+#include "OpenKit/ILogger.h"
+#include "caching/BeaconCache.h"
+#include "caching/IBeaconCache.h"
+#include "core/util/SingleProducerQueue.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace caching
+{
+	///
+	/// Beacon cache decorator moving reported data off the reporting threads.
+	///
+	/// Each thread reporting data appends its records to its own lock-free buffer, so reporting threads never wait
+	/// for each other or for the cache. A drainer thread moves the buffered records into the wrapped @ref BeaconCache
+	/// in batches, one cache entry lock per beacon and batch.
+	///
+	/// Each record is stamped with a sequence number of its beacon, taken from a counter shared by the beacons of one
+	/// stripe, and the buffers are merged on it. Since a thread may append a record after a drain took records with
+	/// higher sequence numbers, records following a gap in the sequence of their stripe are held back until the
+	/// missing record arrived.
+	///
+	/// A thread whose buffer would exceed the configured number of bytes per thread drains its own buffer, waiting only
+	/// for a drain in progress, and wakes the drainer thread, so no record is dropped. Without a drainer thread the
+	/// reporting thread drains all buffers itself, as does every thread reporting data after @ref stop. Buffered records count towards
+	/// @ref getNumBytesInCache, so that eviction sees them. All methods reading beacon data drain the buffers first,
+	/// so that they see all data reported before the call.
+	///
+	class BufferedBeaconCache : public IBeaconCache
+	{
+	public:
+		///
+		/// Constructor
+		/// @param[in] logger to write traces to
+		/// @param[in] beaconCache the cache receiving the buffered records
+		/// @param[in] drainInterval time in milliseconds between two drains of the drainer thread
+		/// @param[in] maxBufferedBytesPerThread number of bytes a thread may buffer before it drains its buffer itself
+		///
+		BufferedBeaconCache(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<BeaconCache> beaconCache, int64_t drainInterval,
+			int64_t maxBufferedBytesPerThread = DEFAULT_MAX_BUFFERED_BYTES_PER_THREAD);
+
+		///
+		/// Destructor, stops the drainer thread
+		///
+		virtual ~BufferedBeaconCache();
+
+		BufferedBeaconCache(const BufferedBeaconCache&) = delete;
+		BufferedBeaconCache& operator=(const BufferedBeaconCache&) = delete;
+
+		///
+		/// Starts the drainer thread.
+		/// @returns @c true if the thread was started, @c false if it was already running
+		///
+		bool start();
+
+		///
+		/// Stops the drainer thread and drains the remaining records.
+		/// @returns @c true if the thread was stopped, @c false if it was not running
+		///
+		bool stop();
+
+		///
+		/// Moves all buffered records into the wrapped cache, except the ones following a record which is still
+		/// being appended by another thread.
+		///
+		void drain();
+
+		virtual void addObserver(IObserver* observer) override;
+
+		virtual void addEventData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data) override;
+
+		virtual void addEventDataBatch(int32_t beaconID, int64_t timestamp, const std::vector<core::UTF8String>& data) override;
+
+		virtual void addActionData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data) override;
+
+		virtual void deleteCacheEntry(int32_t beaconID) override;
+
+		virtual const core::UTF8String getNextBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter) override;
+
+		virtual const core::UTF8String getFollowingBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter) override;
+
+		virtual void removeChunkedData(int32_t beaconID) override;
+
+		virtual void resetChunkedData(int32_t beaconID) override;
+
+		virtual const std::unordered_set<int32_t> getBeaconIDs() override;
+
+		virtual uint32_t evictRecordsByAge(int32_t beaconID, int64_t minTimestamp) override;
+
+		virtual uint32_t evictRecordsByNumber(int32_t beaconID, uint32_t numRecords) override;
+
+		///
+		/// Returns the number of bytes in the wrapped cache and in the buffers.
+		///
+		virtual int64_t getNumBytesInCache() const override;
+
+		virtual bool isEmpty(int32_t beaconID) override;
+
+		virtual int64_t getNumBytes(int32_t beaconID) override;
+
+		virtual int64_t getOldestRecordTimestamp(int32_t beaconID) override;
+
+		///
+		/// A record waiting in a thread's buffer
+		///
+		struct BufferedRecord
+		{
+			BufferedRecord()
+				: beaconID(0)
+				, sequenceNumber(0)
+				, isAction(false)
+				, timestamp(0)
+				, data()
+				, isDiscarded(false)
+			{
+			}
+
+			/// the beacon the record belongs to
+			int32_t beaconID;
+
+			/// position of the record in the sequence of its beacon's stripe
+			uint64_t sequenceNumber;
+
+			/// @c true for action data, @c false for event data
+			bool isAction;
+
+			/// time when the record was reported
+			int64_t timestamp;
+
+			/// the serialized data
+			core::UTF8String data;
+
+			/// set for a held back record whose cache entry was deleted, it is skipped once the gap before it closed
+			bool isDiscarded;
+		};
+
+		///
+		/// Buffer of one reporting thread
+		///
+		struct IngestionBuffer
+		{
+			IngestionBuffer()
+				: records()
+				, numBytes(0)
+				, isClosed(false)
+			{
+			}
+
+			/// records reported by the thread, consumed by @ref drain
+			core::util::SingleProducerQueue<BufferedRecord> records;
+
+			/// size of the data of the buffered records
+			std::atomic<int64_t> numBytes;
+
+			/// set once the cache owning the buffer is destroyed
+			std::atomic<bool> isClosed;
+		};
+
+		/// default number of bytes a thread may buffer before it drains its buffer itself
+		static const int64_t DEFAULT_MAX_BUFFERED_BYTES_PER_THREAD;
+
+		/// number of counters the sequence numbers of the beacons are taken from
+		static constexpr size_t NUMBER_OF_SEQUENCE_STRIPES = 256;
+
+	protected:
+		///
+		/// Takes the sequence number of the next record reported for the given beacon
+		/// @param[in] beaconID the beacon the record belongs to
+		/// @returns the sequence number within the stripe of the beacon
+		///
+		virtual uint64_t takeSequenceNumber(int32_t beaconID);
+
+	private:
+		///
+		/// Sequence number counter on its own cache line, so that beacons of different stripes do not contend
+		///
+		struct SequenceStripe
+		{
+			SequenceStripe()
+				: nextSequenceNumber(0)
+				, padding()
+			{
+			}
+
+			/// sequence number of the next record reported for a beacon of this stripe
+			std::atomic<uint64_t> nextSequenceNumber;
+
+			/// fills the rest of the cache line
+			char padding[64 - sizeof(std::atomic<uint64_t>)];
+		};
+
+		///
+		/// Returns the stripe whose counter provides the sequence numbers of a beacon
+		///
+		static size_t getSequenceStripe(int32_t beaconID);
+
+		///
+		/// Wakes up the drainer thread unless a drain was already requested
+		///
+		void requestDrain();
+
+		///
+		/// Returns the buffer of the calling thread, registering a new one on the first call.
+		///
+		IngestionBuffer& getThreadBuffer();
+
+		///
+		/// Appends a record to the buffer of the calling thread
+		///
+		void addRecord(int32_t beaconID, bool isAction, int64_t timestamp, const core::UTF8String& data);
+
+		///
+		/// Moves the buffered records into the wrapped cache.
+		/// @param[in] threadBuffer the buffer of the calling thread to drain it only, @c nullptr to drain all buffers
+		///
+		void drainBuffers(std::shared_ptr<IngestionBuffer> threadBuffer);
+
+		///
+		/// The thread function
+		///
+		void drainLoopFunc();
+
+		/// Logger to write traces to
+		std::shared_ptr<openkit::ILogger> mLogger;
+
+		/// the cache receiving the buffered records
+		std::shared_ptr<BeaconCache> mBeaconCache;
+
+		/// time between two drains
+		const std::chrono::milliseconds mDrainInterval;
+
+		/// number of bytes a thread may buffer before it drains its buffer itself
+		const int64_t mMaxBufferedBytesPerThread;
+
+		/// identifies this cache in the thread local buffer maps
+		const uint64_t mInstanceID;
+
+		/// buffers of all threads which reported data
+		std::vector<std::shared_ptr<IngestionBuffer>> mBuffers;
+
+		/// mutex protecting the list of buffers
+		mutable std::mutex mBuffersMutex;
+
+		/// sequence number counters of the beacons
+		std::array<SequenceStripe, NUMBER_OF_SEQUENCE_STRIPES> mSequenceStripes;
+
+		/// sequence number of the next record to add per stripe, only accessed by the thread holding @c mDrainMutex
+		std::array<uint64_t, NUMBER_OF_SEQUENCE_STRIPES> mNextSequenceNumbersToAdd;
+
+		/// records held back by the last drain since they follow a gap in the sequence of their stripe
+		std::vector<BufferedRecord> mHeldBackRecords;
+
+		/// size of the data of the held back records
+		std::atomic<int64_t> mNumHeldBackBytes;
+
+		/// mutex making sure there is only one consumer of the buffers
+		std::mutex mDrainMutex;
+
+		/// thread draining the buffers periodically
+		std::unique_ptr<std::thread> mDrainThread;
+
+		/// flag to stop the drainer thread
+		bool mStop;
+
+		/// set once @ref stop was called, records reported afterwards are drained right away
+		std::atomic<bool> mIsStopped;
+
+		/// @c true while the drainer thread is running
+		std::atomic<bool> mIsDrainerRunning;
+
+		/// set when a reporting thread asked the drainer thread to drain before the drain interval elapsed
+		std::atomic<bool> mIsDrainRequested;
+
+		/// mutex for the condition variable
+		std::mutex mMutex;
+
+		/// to wake up the drainer thread when stopping or when a buffer fills up
+		std::condition_variable mConditionVariable;
+	};
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 namespace caching
 {
@@ -54,6 +55,17 @@ namespace caching
 		///
 		virtual void addEventData(int32_t beaconID, int64_t timestamp, const core::UTF8String& data) = 0;
 
+		///
+		/// Add several event data records sharing one timestamp for a given @c beaconID to this cache.
+		///
+		/// The records are inserted in the given order and all registered observers are notified once.
+		///
+		/// @param[in] beaconID The beacon's ID (aka Session ID) for which to add event data.
+		/// @param[in] timestamp The data's timestamp.
+		/// @param[in] data serialized event data records to add.
+		///
+		virtual void addEventDataBatch(int32_t beaconID, int64_t timestamp, const std::vector<core::UTF8String>& data) = 0;
+
 		///
 		/// Add action data for a given @c beaconID to this cache.
 		///
@@ -82,6 +94,22 @@ namespace caching
 		///
 		virtual const core::UTF8String getNextBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter) = 0;
 
+		///
+		/// Get the chunk following the one returned by the last call to @ref getNextBeaconChunk, while that one is still being sent.
+		///
+		/// The following chunk becomes the current chunk with @ref removeChunkedData, so that the next call to @ref getNextBeaconChunk
+		/// returns the same data. @ref resetChunkedData restores the data of both chunks.
+		///
+		/// Note: This method must only be invoked from the beacon sending thread or on its behalf, while it is waiting for the current chunk to be sent.
+		///
+		/// @param[in] beaconID The beacon id for which to get the following chunk.
+		/// @param[in] chunkPrefix Prefix to append to the beginning of the chunk.
+		/// @param[in] maxSize Maximum chunk size. As soon as chunk's size is greater than or equal to maxSize result is returned.
+		/// @param[in] delimiter Delimiter between consecutive chunks.
+		/// @return the following chunk to send or an empty string, if either the given @c beaconID does not exist or if there is no more data to send.
+		///
+		virtual const core::UTF8String getFollowingBeaconChunk(int32_t beaconID, const core::UTF8String& chunkPrefix, int32_t maxSize, const core::UTF8String& delimiter) = 0;
+
 		///
 		/// Remove all data that was previously included in chunks.
 		///
@@ -145,6 +173,24 @@ namespace caching
 		/// @return @c true if the cached entry is empty, @c false otherwise.
 		///
 		virtual bool isEmpty(int32_t beaconID) = 0;
+
+		///
+		/// Get the number of bytes stored for the given @c beaconID.
+		///
+		/// @param[in] beaconID The beacon's identifier.
+		/// @return Number of bytes stored for the beacon, or @c 0 if there is no entry.
+		///
+		virtual int64_t getNumBytes(int32_t beaconID) = 0;
+
+		///
+		/// Get the timestamp of the oldest record stored for the given @c beaconID.
+		///
+		/// Eviction strategies remove the oldest records first, so this is the record at the highest risk of being evicted.
+		///
+		/// @param[in] beaconID The beacon's identifier.
+		/// @return The oldest record's timestamp or @c -1 if there are no records.
+		///
+		virtual int64_t getOldestRecordTimestamp(int32_t beaconID) = 0;
 	};
 }
 
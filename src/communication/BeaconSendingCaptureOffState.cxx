@@ -52,7 +52,15 @@ BeaconSendingCaptureOffState::BeaconSendingCaptureOffState(int64_t sleepTimeInMi
 void BeaconSendingCaptureOffState::doExecute(BeaconSendingContext& context)
 {
 	// disable capturing - avoid collecting further data
-	context.disableCapture();
+	if (mSleepTimeInMilliseconds > int64_t(0))
+	{
+		// the server asked to back off - keep the data captured so far to send it later on
+		context.disableCaptureAndStoreData();
+	}
+	else
+	{
+		context.disableCapture();
+	}
 
 	auto currentTime = context.getCurrentTimestamp();
 
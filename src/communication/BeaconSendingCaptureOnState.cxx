@@ -19,6 +19,7 @@
 #include <chrono>
 #include <algorithm>
 #include <memory>
+#include <unordered_set>
 
 #include "communication/BeaconSendingCaptureOffState.h"
 #include "communication/BeaconSendingFlushSessionsState.h"
@@ -38,10 +39,10 @@ BeaconSendingCaptureOnState::BeaconSendingCaptureOnState()
 
 void BeaconSendingCaptureOnState::doExecute(BeaconSendingContext& context)
 {
-	context.sleep();
+	context.waitForWakeup();
 	if (context.isShutdownRequested())
 	{
-		// shutdown was requested during sleep
+		// shutdown was requested while waiting
 		// return and let the base class handle this
 		return;
 	}
@@ -54,7 +55,16 @@ void BeaconSendingCaptureOnState::doExecute(BeaconSendingContext& context)
 		context.setNextState(std::make_shared<BeaconSendingCaptureOffState>(newSessionsResponse->getRetryAfterInMilliseconds()));
 		return;
 	}
-	
+
+	// send data stored while capturing was off
+	auto replayResponse = context.replayStoredChunks();
+	if (BeaconSendingResponseUtil::isTooManyRequestsResponse(replayResponse))
+	{
+		// server is currently overloaded, temporarily switch to capture off
+		context.setNextState(std::make_shared<BeaconSendingCaptureOffState>(replayResponse->getRetryAfterInMilliseconds()));
+		return;
+	}
+
 	// send all finished sessions
 	auto finishedSessionsResponse = sendFinishedSessions(context);
 	if (BeaconSendingResponseUtil::isTooManyRequestsResponse(finishedSessionsResponse))
@@ -64,6 +74,9 @@ void BeaconSendingCaptureOnState::doExecute(BeaconSendingContext& context)
 		return;
 	}
 
+	// adapt the send interval to cache and collector load before checking it
+	context.updateAdaptiveSending();
+
 	// check if we need to send open sessions & do it if necessary
 	auto openSessionsResponse = sendOpenSessions(context);
 	if (BeaconSendingResponseUtil::isTooManyRequestsResponse(openSessionsResponse))
@@ -99,60 +112,206 @@ const char* BeaconSendingCaptureOnState::getStateName() const
 std::shared_ptr<protocol::StatusResponse> BeaconSendingCaptureOnState::sendFinishedSessions(BeaconSendingContext& context)
 {
 	std::shared_ptr<protocol::StatusResponse> statusResponse = nullptr;
+	auto retryScheduler = context.getRetryScheduler();
+	int64_t currentTimestamp = context.getCurrentTimestamp();
+
 	// check if there's finished Sessions to be sent -> immediately send beacon(s) of finished Sessions
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessionsToSend;
 	for (auto session : context.getAllFinishedAndConfiguredSessions())
 	{
-		if (session->isDataSendingAllowed()) {
-			statusResponse = session->sendBeacon(context.getHTTPClientProvider());
-			if (!BeaconSendingResponseUtil::isSuccessfulResponse(statusResponse))
+		if (!session->isDataSendingAllowed())
+		{
+			// session is not allowed to be sent - so remove it from beacon cache
+			context.removeSession(session);
+			session->clearCapturedData();
+		}
+		else if (retryScheduler->isSendDue(session, currentTimestamp))
+		{
+			sessionsToSend.push_back(session);
+		}
+		// else: previous attempt failed, the retry is not yet due
+	}
+
+	context.getSessionPrioritizer()->prioritize(sessionsToSend, currentTimestamp);
+	auto results = context.sendBeacons(sessionsToSend);
+	for (size_t i = 0; i < sessionsToSend.size(); i++)
+	{
+		if (!results[i].sent)
+		{
+			continue; // upload budget is exhausted or the server is overloaded, send this session later
+		}
+
+		auto session = sessionsToSend[i];
+		auto response = results[i].response;
+		statusResponse = selectStatusResponse(statusResponse, response);
+		if (!BeaconSendingResponseUtil::isSuccessfulResponse(response))
+		{
+			// something went wrong,
+			if (BeaconSendingResponseUtil::isTooManyRequestsResponse(response))
+			{
+				statusResponse = response;
+				continue; //  server is overloaded, retry it later
+			}
+			if (!session->isEmpty() && retryScheduler->scheduleRetry(session, currentTimestamp))
 			{
-				// something went wrong,
-				if (BeaconSendingResponseUtil::isTooManyRequestsResponse(statusResponse) || !session->isEmpty())
-				{
-					break; //  sending did not work, break out for now and retry it later
-				}
+				continue; // retry this session later, but keep on sending the other ones
 			}
 		}
 
-		// session was sent/is not allowed to be sent - so remove it from beacon cache
+		// session was sent/ran out of retries - so remove it from beacon cache
 		context.removeSession(session);
 		session->clearCapturedData();
 	}
 
-	return statusResponse;
+	return tooManyRequestsResponseOr(results, statusResponse);
 }
 
 std::shared_ptr<protocol::StatusResponse> BeaconSendingCaptureOnState::sendOpenSessions(BeaconSendingContext& context)
 {
-	std::shared_ptr<protocol::StatusResponse> statusResponse = nullptr;
 	int64_t currentTimestamp = context.getCurrentTimestamp();
-	if (currentTimestamp <= context.getLastOpenSessionBeaconSendTime() + context.getSendInterval())
+	auto sendIntervalExpired = currentTimestamp > context.getLastOpenSessionBeaconSendTime() + context.getSendInterval();
+
+	auto openSessions = context.getAllOpenAndConfiguredSessions();
+	auto openSessionScheduler = context.getOpenSessionScheduler();
+	std::unordered_set<const core::SessionWrapper*> scheduledSessions;
+	if (openSessionScheduler != nullptr)
 	{
-		return nullptr; // send interval to send open sessions has not expired yet
+		if (sendIntervalExpired)
+		{
+			// spread the open sessions of this send interval across the interval
+			openSessionScheduler->scheduleCohort(openSessions, currentTimestamp, context.getSendInterval());
+		}
+		for (auto& session : openSessionScheduler->pollDueSessions(currentTimestamp))
+		{
+			scheduledSessions.insert(session.get());
+		}
 	}
 
-	for (auto session : context.getAllOpenAndConfiguredSessions())
+	auto retryScheduler = context.getRetryScheduler();
+	auto dataLeft = false;
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessionsToSend;
+	for (auto session : openSessions)
 	{
-		if (session->isDataSendingAllowed())
+		auto sendDue = openSessionScheduler != nullptr ? scheduledSessions.count(session.get()) > 0 : sendIntervalExpired;
+		if (!sendDue && !session->isSendThresholdReached() && !retryScheduler->isRetryDue(session, currentTimestamp))
 		{
-			statusResponse = session->sendBeacon(context.getHTTPClientProvider());
-			if (BeaconSendingResponseUtil::isTooManyRequestsResponse(statusResponse))
+			continue; // send time has not been reached yet, the session did not cache enough data to be sent earlier and no retry is due
+		}
+
+		if (!session->isDataSendingAllowed())
+		{
+			session->clearCapturedData();
+		}
+		else if (retryScheduler->isSendDue(session, currentTimestamp))
+		{
+			sessionsToSend.push_back(session);
+		}
+		else
+		{
+			dataLeft = true; // previous attempt failed, the retry is not yet due
+		}
+	}
+
+	context.getSessionPrioritizer()->prioritize(sessionsToSend, currentTimestamp);
+
+	std::shared_ptr<protocol::StatusResponse> statusResponse = nullptr;
+	auto allSent = true;
+	auto results = context.sendBeacons(sessionsToSend);
+	for (size_t i = 0; i < sessionsToSend.size(); i++)
+	{
+		auto session = sessionsToSend[i];
+		if (!results[i].sent)
+		{
+			allSent = false;
+			if (openSessionScheduler != nullptr && scheduledSessions.count(session.get()) > 0)
 			{
-				// server is currently overloaded, return immediately
-				break;
+				openSessionScheduler->postpone(session, currentTimestamp); // send it as soon as possible
 			}
+			continue;
 		}
-		else
+
+		auto response = results[i].response;
+		statusResponse = selectStatusResponse(statusResponse, response);
+		if (BeaconSendingResponseUtil::isSuccessfulResponse(response))
 		{
+			retryScheduler->resetRetry(session);
+		}
+		else if (!BeaconSendingResponseUtil::isTooManyRequestsResponse(response) && !retryScheduler->scheduleRetry(session, currentTimestamp))
+		{
+			// ran out of retries, drop the data which could not be sent
+			retryScheduler->resetRetry(session);
 			session->clearCapturedData();
 		}
+		else
+		{
+			dataLeft = true; // data is kept for the retry
+		}
 	}
 
-	context.setLastOpenSessionBeaconSendTime(currentTimestamp);
+	if (!allSent || dataLeft)
+	{
+		context.setOpenSessionDataPending(true);
+	}
+	else if (sendIntervalExpired)
+	{
+		// every open session was sent, wait until new data arrives
+		context.setOpenSessionDataPending(false);
+	}
+
+	statusResponse = tooManyRequestsResponseOr(results, statusResponse);
+	if (!allSent && openSessionScheduler == nullptr && !BeaconSendingResponseUtil::isTooManyRequestsResponse(statusResponse))
+	{
+		// upload budget is exhausted, continue sending open sessions once it has been refilled
+		// without waiting for the next send interval
+		return statusResponse;
+	}
+
+	if (sendIntervalExpired)
+	{
+		context.setLastOpenSessionBeaconSendTime(currentTimestamp);
+	}
 
 	return statusResponse;
 }
 
+std::shared_ptr<protocol::StatusResponse> BeaconSendingCaptureOnState::tooManyRequestsResponseOr(const std::vector<std::shared_ptr<protocol::StatusResponse>>& responses, std::shared_ptr<protocol::StatusResponse> statusResponse)
+{
+	for (auto& response : responses)
+	{
+		if (BeaconSendingResponseUtil::isTooManyRequestsResponse(response))
+		{
+			return response;
+		}
+	}
+
+	return statusResponse;
+}
+
+std::shared_ptr<protocol::StatusResponse> BeaconSendingCaptureOnState::tooManyRequestsResponseOr(const std::vector<BeaconSendingContext::SendBeaconResult>& results, std::shared_ptr<protocol::StatusResponse> statusResponse)
+{
+	// a "too many requests" response takes precedence, since it turns capturing off temporarily
+	for (auto& result : results)
+	{
+		if (BeaconSendingResponseUtil::isTooManyRequestsResponse(result.response))
+		{
+			return result.response;
+		}
+	}
+
+	return statusResponse;
+}
+
+std::shared_ptr<protocol::StatusResponse> BeaconSendingCaptureOnState::selectStatusResponse(std::shared_ptr<protocol::StatusResponse> currentResponse, std::shared_ptr<protocol::StatusResponse> newResponse)
+{
+	// a single failing session shall not override a successful response, since this would turn capturing off
+	if (BeaconSendingResponseUtil::isSuccessfulResponse(currentResponse) && !BeaconSendingResponseUtil::isSuccessfulResponse(newResponse))
+	{
+		return currentResponse;
+	}
+
+	return newResponse;
+}
+
 void BeaconSendingCaptureOnState::handleStatusResponse(BeaconSendingContext& context, std::shared_ptr<protocol::StatusResponse> statusResponse)
 {
 	if (statusResponse == nullptr)
@@ -169,36 +328,90 @@ void BeaconSendingCaptureOnState::handleStatusResponse(BeaconSendingContext& con
 
 std::shared_ptr<protocol::StatusResponse> BeaconSendingCaptureOnState::sendNewSessionRequests(BeaconSendingContext& context)
 {
-	std::shared_ptr<protocol::StatusResponse> statusResponse = nullptr;
+	auto retryScheduler = context.getRetryScheduler();
+	int64_t currentTimestamp = context.getCurrentTimestamp();
+	auto sharedResponse = context.getSharedNewSessionResponse(currentTimestamp);
+
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessionsToRequest;
 	for (auto session : context.getAllNewSessions() )
 	{
 		if (!session->canSendNewSessionRequest())
 		{
 			// already exceeded the maximum number of session requests, disable any further data collecting
-			auto beaconConfiguration = session->getBeaconConfiguration();
-			auto newBeaconConfiguration = std::make_shared<configuration::BeaconConfiguration>(0, beaconConfiguration->getDataCollectionLevel(), beaconConfiguration->getCrashReportingLevel());
-			session->updateBeaconConfiguration(newBeaconConfiguration);
+			disableDataCollection(session);
 			continue;
 		}
 
-		statusResponse = context.getHTTPClient()->sendNewSessionRequest();
-		if (BeaconSendingResponseUtil::isSuccessfulResponse(statusResponse))
+		if (!retryScheduler->isSendDue(session, currentTimestamp))
+		{
+			continue; // previous attempt failed, the retry is not yet due
+		}
+
+		if (sharedResponse != nullptr)
 		{
-			auto beaconConfiguration = session->getBeaconConfiguration();
-			auto newBeaconConfiguration = std::make_shared<configuration::BeaconConfiguration>(statusResponse->getMultiplicity(), beaconConfiguration->getDataCollectionLevel(), beaconConfiguration->getCrashReportingLevel());
-			session->updateBeaconConfiguration(newBeaconConfiguration);
+			// a fresh response was received shortly before, take over its multiplicity without a request
+			updateMultiplicity(session, sharedResponse);
+			retryScheduler->resetRetry(session);
+			continue;
 		}
-		else if (BeaconSendingResponseUtil::isTooManyRequestsResponse(statusResponse))
+
+		sessionsToRequest.push_back(session);
+	}
+
+	if (context.isMultiplicityShared() && sessionsToRequest.size() > 1)
+	{
+		// request a fresh multiplicity for the first session only, the others take it over in the next pass
+		sessionsToRequest.resize(1);
+	}
+
+	std::shared_ptr<protocol::StatusResponse> statusResponse = nullptr;
+	auto responses = context.sendNewSessionRequests(sessionsToRequest.size());
+	for (size_t i = 0; i < sessionsToRequest.size(); i++)
+	{
+		auto session = sessionsToRequest[i];
+		auto response = responses[i];
+		if (response == nullptr)
 		{
-			// server is currently overloaded, return immediately
-			break;
+			continue; // server is overloaded, the request was not sent
+		}
+
+		statusResponse = selectStatusResponse(statusResponse, response);
+		if (BeaconSendingResponseUtil::isSuccessfulResponse(response))
+		{
+			updateMultiplicity(session, response);
+			retryScheduler->resetRetry(session);
+			context.setSharedNewSessionResponse(response, currentTimestamp);
+		}
+		else if (BeaconSendingResponseUtil::isTooManyRequestsResponse(response))
+		{
+			// server is currently overloaded
+			statusResponse = response;
 		}
 		else
 		{
 			// any other unsuccessful response
 			session->decreaseNumberOfNewSessionRequests();
+			if (!retryScheduler->scheduleRetry(session, currentTimestamp))
+			{
+				// ran out of retries, disable any further data collecting
+				disableDataCollection(session);
+			}
 		}
 	}
 
-	return statusResponse;
+	return tooManyRequestsResponseOr(responses, statusResponse);
+}
+
+void BeaconSendingCaptureOnState::updateMultiplicity(std::shared_ptr<core::SessionWrapper> session, std::shared_ptr<protocol::StatusResponse> response)
+{
+	auto beaconConfiguration = session->getBeaconConfiguration();
+	auto newBeaconConfiguration = std::make_shared<configuration::BeaconConfiguration>(response->getMultiplicity(), beaconConfiguration->getDataCollectionLevel(), beaconConfiguration->getCrashReportingLevel());
+	session->updateBeaconConfiguration(newBeaconConfiguration);
+}
+
+void BeaconSendingCaptureOnState::disableDataCollection(std::shared_ptr<core::SessionWrapper> session)
+{
+	auto beaconConfiguration = session->getBeaconConfiguration();
+	auto newBeaconConfiguration = std::make_shared<configuration::BeaconConfiguration>(0, beaconConfiguration->getDataCollectionLevel(), beaconConfiguration->getCrashReportingLevel());
+	session->updateBeaconConfiguration(newBeaconConfiguration);
 }
\ No newline at end of file
@@ -18,7 +18,9 @@
 #define _COMMUNICATION_BEACONSENDINGCAPTUREONSTATE_H
 
 #include "communication/AbstractBeaconSendingState.h"
+#include "communication/BeaconSendingContext.h"
 #include "protocol/StatusResponse.h"
+#include "core/SessionWrapper.h"
 
 #include <memory>
 #include <vector>
@@ -61,6 +63,7 @@ namespace communication
 
 		///
 		/// Check if the send interval (configured by server) has expired and start to send open sessions if it has expired.
+		/// Open sessions which reached their flush threshold are sent without waiting for the send interval.
 		/// @param[in] context the state context
 		///
 		std::shared_ptr<protocol::StatusResponse> sendOpenSessions(BeaconSendingContext& context);
@@ -77,6 +80,44 @@ namespace communication
 		/// @param[in] context beacon sending context
 		///
 		std::shared_ptr<protocol::StatusResponse> sendNewSessionRequests(BeaconSendingContext& context);
+
+		///
+		/// Set the multiplicity of a session to @c 0, so that no further data is collected
+		/// @param[in] session the session to disable
+		///
+		static void disableDataCollection(std::shared_ptr<core::SessionWrapper> session);
+
+		///
+		/// Configure a session with the multiplicity of a new session response
+		/// @param[in] session the session to configure
+		/// @param[in] response the successful new session response
+		///
+		static void updateMultiplicity(std::shared_ptr<core::SessionWrapper> session, std::shared_ptr<protocol::StatusResponse> response);
+
+		///
+		/// Select the response to hand over to @ref handleStatusResponse, preferring successful responses
+		/// over failed ones, so that a single failing session does not turn capturing off.
+		/// @param[in] currentResponse the response selected so far
+		/// @param[in] newResponse the response received last
+		/// @returns the response to keep
+		///
+		static std::shared_ptr<protocol::StatusResponse> selectStatusResponse(std::shared_ptr<protocol::StatusResponse> currentResponse, std::shared_ptr<protocol::StatusResponse> newResponse);
+
+		///
+		/// Return the first "too many requests" response among the given results, or the given response if there is none.
+		/// @param[in] results the results of sending the beacons of several sessions
+		/// @param[in] statusResponse the response selected so far
+		/// @returns the response to keep
+		///
+		static std::shared_ptr<protocol::StatusResponse> tooManyRequestsResponseOr(const std::vector<BeaconSendingContext::SendBeaconResult>& results, std::shared_ptr<protocol::StatusResponse> statusResponse);
+
+		///
+		/// Return the first "too many requests" response among the given responses, or the given response if there is none.
+		/// @param[in] responses the responses of several requests, @c nullptr for requests not sent
+		/// @param[in] statusResponse the response selected so far
+		/// @returns the response to keep
+		///
+		static std::shared_ptr<protocol::StatusResponse> tooManyRequestsResponseOr(const std::vector<std::shared_ptr<protocol::StatusResponse>>& responses, std::shared_ptr<protocol::StatusResponse> statusResponse);
 	};
 }
 #endif
\ No newline at end of file
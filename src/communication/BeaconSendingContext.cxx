@@ -18,10 +18,17 @@
 
 #include "communication/AbstractBeaconSendingState.h"
 #include "communication/BeaconSendingInitialState.h"
+#include "communication/BeaconSendingResponseUtil.h"
+#include "core/util/CountDownLatch.h"
 
+#include "protocol/Beacon.h"
 #include "protocol/HTTPClient.h"
 #include "configuration/Configuration.h"
 #include "configuration/HTTPClientConfiguration.h"
+#include "providers/DefaultPRNGenerator.h"
+
+#include <algorithm>
+#include <limits>
 
 using namespace communication;
 
@@ -38,15 +45,48 @@ BeaconSendingContext::BeaconSendingContext(std::shared_ptr<openkit::ILogger> log
 	, mShutdown(false)
 	, mShutdownMutex()
 	, mSleepConditionVariable()
+	, mWakeupEvent(std::make_shared<core::util::WakeupEvent>())
 	, mInitSucceeded(false)
 	, mConfiguration(configuration)
 	, mHTTPClientProvider(httpClientProvider)
 	, mTimingProvider(timingProvider)
 	, mLastStatusCheckTime(0)
 	, mLastOpenSessionBeaconSendTime(0)
+	, mOpenSessionDataPending(false)
+	, mHasUnsentBeacons(false)
 	, mInitCountdownLatch(1)
 	, mSessions()
-{
+	, mRetryScheduler(std::make_shared<BeaconSendingRetryScheduler>(configuration->getRetryPolicy(), std::make_shared<providers::DefaultPRNGenerator>()))
+	, mUploadRateLimiter(configuration->getHTTPClientConfiguration()->getUploadRateLimiter())
+	, mOpenSessionScheduler(nullptr)
+	, mSessionPrioritizer(std::make_shared<BeaconSendingSessionPrioritizer>(configuration->getSendPriorityPolicy(),
+		configuration->getBeaconCacheConfiguration()->getMaxRecordAge(), configuration->getBeaconCacheConfiguration()->getCacheSizeUpperBound()))
+	, mWorkerPool(nullptr)
+	, mChunkBuilderPool(std::make_shared<core::util::WorkStealingThreadPool>(static_cast<uint32_t>(std::max(configuration->getBeaconSendingConcurrency(), 1))))
+	, mSharedNewSessionResponse(nullptr)
+	, mSharedNewSessionResponseTime(0)
+	, mShutdownDeadline(-1)
+	, mShutdownReport()
+	, mShutdownReportMutex()
+	, mChunkStore(nullptr)
+	, mReplayBytesPerSecond(0)
+	, mNextReplayTime(0)
+{
+	if (configuration->isOpenSessionSendStaggered())
+	{
+		mOpenSessionScheduler = std::make_shared<BeaconSendingOpenSessionScheduler>(configuration->isOpenSessionSendJitterEnabled(), std::make_shared<providers::DefaultPRNGenerator>());
+	}
+	if (configuration->getBeaconSendingConcurrency() > 1)
+	{
+		mWorkerPool.reset(new core::util::WorkStealingThreadPool(static_cast<uint32_t>(configuration->getBeaconSendingConcurrency())));
+	}
+	auto storeAndForwardConfiguration = configuration->getStoreAndForwardConfiguration();
+	if (storeAndForwardConfiguration != nullptr)
+	{
+		mChunkStore = std::make_shared<caching::BeaconChunkStore>(logger, storeAndForwardConfiguration->getDirectory(),
+			storeAndForwardConfiguration->getMaxStoreSize(), storeAndForwardConfiguration->getMaxChunkAge());
+		mReplayBytesPerSecond = storeAndForwardConfiguration->getReplayBytesPerSecond();
+	}
 }
 
 BeaconSendingContext::BeaconSendingContext(std::shared_ptr<openkit::ILogger> logger,
@@ -87,6 +127,25 @@ void BeaconSendingContext::requestShutdown()
 	std::unique_lock<std::mutex> lock(mShutdownMutex);
 	mShutdown = true;
 	mSleepConditionVariable.notify_all(); // wake up all sleeping threads
+	mWakeupEvent->signal();
+}
+
+void BeaconSendingContext::requestShutdownWithTimeout(int64_t timeoutMillis)
+{
+	if (timeoutMillis < 0)
+	{
+		timeoutMillis = 0;
+	}
+	mShutdownDeadline = getCurrentTimestamp() + timeoutMillis;
+	mConfiguration->getHTTPClientConfiguration()->getTransferDeadline()->expireAfter(timeoutMillis);
+
+	requestShutdown();
+}
+
+bool BeaconSendingContext::isShutdownDeadlineExpired() const
+{
+	auto shutdownDeadline = mShutdownDeadline.load();
+	return shutdownDeadline >= 0 && getCurrentTimestamp() >= shutdownDeadline;
 }
 
 bool BeaconSendingContext::isShutdownRequested() const
@@ -111,18 +170,250 @@ std::shared_ptr<protocol::IHTTPClient> BeaconSendingContext::getHTTPClient()
 	return mHTTPClientProvider->createClient(mLogger, httpClientConfig);
 }
 
+std::shared_ptr<BeaconSendingRetryScheduler> BeaconSendingContext::getRetryScheduler() const
+{
+	return mRetryScheduler;
+}
+
+std::shared_ptr<protocol::UploadRateLimiter> BeaconSendingContext::getUploadRateLimiter() const
+{
+	return mUploadRateLimiter;
+}
+
+std::shared_ptr<BeaconSendingOpenSessionScheduler> BeaconSendingContext::getOpenSessionScheduler() const
+{
+	return mOpenSessionScheduler;
+}
+
+std::shared_ptr<BeaconSendingSessionPrioritizer> BeaconSendingContext::getSessionPrioritizer() const
+{
+	return mSessionPrioritizer;
+}
+
+std::vector<BeaconSendingContext::SendBeaconResult> BeaconSendingContext::sendBeacons(const std::vector<std::shared_ptr<core::SessionWrapper>>& sessions)
+{
+	std::vector<SendBeaconResult> results(sessions.size());
+	auto httpClientProvider = getHTTPClientProvider();
+	std::atomic<bool> aborted(false);
+
+	runTasks(sessions.size(), [&](size_t index)
+	{
+		if (aborted)
+		{
+			return;
+		}
+		if (mUploadRateLimiter->isThrottled())
+		{
+			aborted = true; // send the remaining sessions once the upload budget has been refilled
+			mHasUnsentBeacons = true;
+			return;
+		}
+
+		auto response = sessions[index]->sendBeacon(httpClientProvider);
+		results[index].sent = true;
+		results[index].response = response;
+		if (BeaconSendingResponseUtil::isTooManyRequestsResponse(response))
+		{
+			aborted = true; // server is overloaded, do not send any further requests
+		}
+	});
+
+	return results;
+}
+
+std::vector<BeaconSendingContext::SendBeaconResult> BeaconSendingContext::flushBeacons(const std::vector<std::shared_ptr<core::SessionWrapper>>& sessions)
+{
+	std::vector<SendBeaconResult> results(sessions.size());
+	auto httpClientProvider = getHTTPClientProvider();
+	std::atomic<bool> aborted(false);
+
+	// the bytes held by the sessions count as discarded until they are sent
+	std::vector<int64_t> numBytesToSend(sessions.size(), 0);
+	{
+		std::lock_guard<std::mutex> lock(mShutdownReportMutex);
+		for (size_t i = 0; i < sessions.size(); i++)
+		{
+			if (sessions[i]->isDataSendingAllowed())
+			{
+				numBytesToSend[i] = sessions[i]->getWrappedSession()->getNumBytesInCache();
+				mShutdownReport.numSessionsDropped += 1;
+				mShutdownReport.numBytesDropped += numBytesToSend[i];
+			}
+		}
+	}
+
+	runTasks(sessions.size(), [&](size_t index)
+	{
+		if (aborted || !sessions[index]->isDataSendingAllowed())
+		{
+			return;
+		}
+		if (isShutdownDeadlineExpired())
+		{
+			aborted = true; // out of time, discard the remaining sessions
+			return;
+		}
+
+		auto response = sessions[index]->sendBeacon(httpClientProvider);
+		results[index].sent = true;
+		results[index].response = response;
+		if (BeaconSendingResponseUtil::isTooManyRequestsResponse(response))
+		{
+			aborted = true; // server is overloaded, do not send any further requests
+		}
+
+		// a failed request restores the chunk, so whatever is left in the cache was not sent
+		auto numBytesLeft = sessions[index]->getWrappedSession()->getNumBytesInCache();
+		auto numBytesSent = std::max(numBytesToSend[index] - numBytesLeft, int64_t(0));
+
+		std::lock_guard<std::mutex> lock(mShutdownReportMutex);
+		mShutdownReport.numBytesFlushed += numBytesSent;
+		mShutdownReport.numBytesDropped -= numBytesSent;
+		if (numBytesLeft <= 0)
+		{
+			mShutdownReport.numSessionsFlushed += 1;
+			mShutdownReport.numSessionsDropped -= 1;
+		}
+	});
+
+	std::lock_guard<std::mutex> lock(mShutdownReportMutex);
+	if (mShutdownReport.numSessionsDropped > 0 && isShutdownDeadlineExpired())
+	{
+		mShutdownReport.isDeadlineExceeded = true;
+	}
+
+	return results;
+}
+
+openkit::ShutdownReport BeaconSendingContext::getShutdownReport() const
+{
+	std::lock_guard<std::mutex> lock(mShutdownReportMutex);
+	return mShutdownReport;
+}
+
+std::vector<std::shared_ptr<protocol::StatusResponse>> BeaconSendingContext::sendNewSessionRequests(size_t numRequests)
+{
+	std::vector<std::shared_ptr<protocol::StatusResponse>> responses(numRequests);
+	std::atomic<bool> aborted(false);
+
+	// clients not in use by a worker, each one keeps its connection open for the next request
+	std::mutex idleClientsMutex;
+	std::vector<std::shared_ptr<protocol::IHTTPClient>> idleClients;
+
+	runTasks(numRequests, [&](size_t index)
+	{
+		if (aborted)
+		{
+			return;
+		}
+
+		std::shared_ptr<protocol::IHTTPClient> httpClient = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(idleClientsMutex);
+			if (!idleClients.empty())
+			{
+				httpClient = idleClients.back();
+				idleClients.pop_back();
+			}
+		}
+		if (httpClient == nullptr)
+		{
+			httpClient = getHTTPClient();
+		}
+
+		auto response = httpClient->sendNewSessionRequest();
+		responses[index] = response;
+		if (BeaconSendingResponseUtil::isTooManyRequestsResponse(response))
+		{
+			aborted = true; // server is overloaded, do not send any further requests
+		}
+
+		std::lock_guard<std::mutex> lock(idleClientsMutex);
+		idleClients.push_back(httpClient);
+	});
+
+	return responses;
+}
+
+bool BeaconSendingContext::isMultiplicityShared() const
+{
+	return mConfiguration->getMultiplicitySharingWindow() > 0;
+}
+
+std::shared_ptr<protocol::StatusResponse> BeaconSendingContext::getSharedNewSessionResponse(int64_t timestamp) const
+{
+	if (!isMultiplicityShared() || mSharedNewSessionResponse == nullptr
+		|| timestamp > mSharedNewSessionResponseTime + mConfiguration->getMultiplicitySharingWindow())
+	{
+		return nullptr;
+	}
+
+	return mSharedNewSessionResponse;
+}
+
+void BeaconSendingContext::setSharedNewSessionResponse(std::shared_ptr<protocol::StatusResponse> response, int64_t timestamp)
+{
+	if (isMultiplicityShared())
+	{
+		mSharedNewSessionResponse = response;
+		mSharedNewSessionResponseTime = timestamp;
+	}
+}
+
+void BeaconSendingContext::runTasks(size_t numTasks, const std::function<void(size_t)>& task)
+{
+	if (mWorkerPool == nullptr || numTasks < 2)
+	{
+		for (size_t i = 0; i < numTasks; i++)
+		{
+			task(i);
+		}
+		return;
+	}
+
+	core::util::CountDownLatch completedLatch(static_cast<uint32_t>(numTasks));
+	for (size_t i = 0; i < numTasks; i++)
+	{
+		mWorkerPool->submit([&task, &completedLatch, i]
+		{
+			task(i);
+			completedLatch.countDown();
+		});
+	}
+	completedLatch.await();
+}
+
 int64_t BeaconSendingContext::getSendInterval() const
 {
+	auto adaptiveSendingController = mConfiguration->getAdaptiveSendingController();
+	if (adaptiveSendingController != nullptr)
+	{
+		return adaptiveSendingController->getSendInterval(mConfiguration->getSendInterval());
+	}
+
 	return mConfiguration->getSendInterval();
 }
 
+void BeaconSendingContext::updateAdaptiveSending()
+{
+	auto adaptiveSendingController = mConfiguration->getAdaptiveSendingController();
+	if (adaptiveSendingController != nullptr)
+	{
+		adaptiveSendingController->evaluate(getCurrentTimestamp(), mConfiguration->getSendInterval());
+	}
+}
+
 void BeaconSendingContext::handleStatusResponse(std::shared_ptr<protocol::StatusResponse> response)
 {
 	mConfiguration->updateSettings(response);
 
 	if (!isCaptureOn())
 	{
-		// capturing was turned off
+		// capturing was turned off - keep the data if the server could not take it
+		if (response == nullptr || response->getResponseCode() != 200)
+		{
+			storeAllSessionData();
+		}
 		clearAllSessionData();
 	}
 }
@@ -130,7 +421,7 @@ void BeaconSendingContext::handleStatusResponse(std::shared_ptr<protocol::Status
 void BeaconSendingContext::clearAllSessionData()
 {
 	// clear captured data from finished sessions
-	for (auto session : mSessions.toStdVector())
+	for (auto session : mSessions.getAllSessions())
 	{
 		session->clearCapturedData();
 		if (session->isSessionFinished())
@@ -138,6 +429,89 @@ void BeaconSendingContext::clearAllSessionData()
 			mSessions.remove(session);
 		}
 	}
+
+	if (mOpenSessionScheduler != nullptr)
+	{
+		mOpenSessionScheduler->clear();
+	}
+}
+
+void BeaconSendingContext::storeAllSessionData()
+{
+	if (mChunkStore == nullptr)
+	{
+		return;
+	}
+
+	auto httpClientProvider = getHTTPClientProvider();
+	for (auto session : mSessions.getAllSessions())
+	{
+		if (session->isDataSendingAllowed() && !session->storeBeacon(*mChunkStore, httpClientProvider))
+		{
+			mLogger->warning("BeaconSendingContext storeAllSessionData() - Store is full, dropping remaining data");
+			return;
+		}
+	}
+}
+
+std::shared_ptr<protocol::StatusResponse> BeaconSendingContext::replayStoredChunks()
+{
+	std::shared_ptr<protocol::StatusResponse> response = nullptr;
+	if (mChunkStore == nullptr)
+	{
+		return response;
+	}
+
+	mChunkStore->evictExpired(getCurrentTimestamp());
+
+	std::shared_ptr<protocol::IHTTPClient> httpClient = nullptr;
+	caching::BeaconChunkStore::StoredChunk chunk;
+	while (!isShutdownRequested()
+		&& getCurrentTimestamp() >= mNextReplayTime
+		&& (mUploadRateLimiter == nullptr || !mUploadRateLimiter->isThrottled())
+		&& mChunkStore->loadOldest(chunk))
+	{
+		if (httpClient == nullptr)
+		{
+			httpClient = getHTTPClient();
+		}
+
+		// the records are sent as they were encoded when storing the chunk, only the prefix is completed by the current
+		// transmission time; a client sending plain beacon data decompresses the payload
+		auto prefix = chunk.chunkPrefix;
+		prefix.concatenate(protocol::Beacon::createTransmissionTimeData(getCurrentTimestamp()));
+		response = httpClient->sendEncodedBeaconRequest(chunk.clientIPAddress, protocol::BeaconPayload::withPrefix(prefix, chunk.payload));
+		if (response == nullptr || (response->isErroneousResponse() && !isPermanentError(response)))
+		{
+			// keep the chunk and try again next time
+			break;
+		}
+		if (response->isErroneousResponse())
+		{
+			mLogger->warning("BeaconSendingContext replayStoredChunks() - Chunk was rejected with response code %d, dropping it",
+				response->getResponseCode());
+		}
+
+		mChunkStore->remove(chunk.sequenceNumber);
+		if (mReplayBytesPerSecond > 0)
+		{
+			mNextReplayTime = getCurrentTimestamp() + static_cast<int64_t>(chunk.payload.getContentSize()) * 1000 / mReplayBytesPerSecond;
+		}
+	}
+
+	return response;
+}
+
+bool BeaconSendingContext::isPermanentError(std::shared_ptr<protocol::StatusResponse> response)
+{
+	// the server rejects the chunk itself, sending it again would fail the same way
+	auto responseCode = response->getResponseCode();
+	return responseCode >= 400 && responseCode < 500 && !response->isTooManyRequestsResponse();
+}
+
+std::shared_ptr<caching::BeaconChunkStore> BeaconSendingContext::getChunkStore() const
+{
+	return mChunkStore;
 }
 
 bool BeaconSendingContext::isCaptureOn() const
@@ -184,6 +558,98 @@ void BeaconSendingContext::sleep(int64_t ms)
 	mSleepConditionVariable.wait_for(lock, std::chrono::milliseconds(ms), [&] { return mShutdown; });
 }
 
+void BeaconSendingContext::waitForWakeup()
+{
+	auto delay = getWakeupDelay();
+	if (isShutdownRequested())
+	{
+		return;
+	}
+
+	// an event raised since the last wait is remembered, so nothing gets lost while the states were sending
+	if (mWakeupEvent->wait(delay))
+	{
+		// sessions raise the event when data arrives after their last send
+		mOpenSessionDataPending = true;
+	}
+}
+
+int64_t BeaconSendingContext::getWakeupDelay()
+{
+	auto currentTimestamp = getCurrentTimestamp();
+
+	// retries of open sessions, the ones of new and finished sessions are covered below as well
+	auto nextWakeupTime = mRetryScheduler->getNextRetryTime(currentTimestamp);
+
+	// new session requests and finished sessions are sent right away, as soon as a previous retry is due
+	for (auto& wrapper : mSessions.getNewSessions())
+	{
+		nextWakeupTime = std::min(nextWakeupTime, wrapper->getNextSendAttemptTime());
+	}
+	for (auto& wrapper : mSessions.getFinishedSessions())
+	{
+		nextWakeupTime = std::min(nextWakeupTime, wrapper->getNextSendAttemptTime());
+	}
+
+	if (mOpenSessionDataPending)
+	{
+		// open sessions with data are sent when the send interval expired
+		nextWakeupTime = std::min(nextWakeupTime, getLastOpenSessionBeaconSendTime() + getSendInterval() + 1);
+	}
+
+	if (mChunkStore != nullptr && !mChunkStore->isEmpty())
+	{
+		// stored chunks are replayed at the configured rate
+		nextWakeupTime = std::min(nextWakeupTime, mNextReplayTime);
+	}
+
+	if (mHasUnsentBeacons.exchange(false))
+	{
+		// the last pass ran out of upload budget, continue as soon as it has been refilled
+		nextWakeupTime = currentTimestamp;
+	}
+
+	if (mOpenSessionScheduler != nullptr)
+	{
+		// next open session of the current cohort
+		nextWakeupTime = std::min(nextWakeupTime, mOpenSessionScheduler->getNextDeadline());
+	}
+
+	if (nextWakeupTime == std::numeric_limits<int64_t>::max())
+	{
+		return -1; // nothing to send, wait for the next event
+	}
+
+	auto delay = std::max(nextWakeupTime - currentTimestamp, int64_t(0));
+	if (delay < DEFAULT_SLEEP_TIME_MILLISECONDS.count() && mUploadRateLimiter->isThrottled())
+	{
+		// the upload budget has to be refilled before anything can be sent
+		delay = DEFAULT_SLEEP_TIME_MILLISECONDS.count();
+	}
+
+	return delay;
+}
+
+void BeaconSendingContext::setOpenSessionDataPending(bool dataPending)
+{
+	mOpenSessionDataPending = dataPending;
+}
+
+bool BeaconSendingContext::isOpenSessionDataPending() const
+{
+	return mOpenSessionDataPending;
+}
+
+std::shared_ptr<core::util::WakeupEvent> BeaconSendingContext::getWakeupEvent() const
+{
+	return mWakeupEvent;
+}
+
+std::shared_ptr<core::util::WorkStealingThreadPool> BeaconSendingContext::getChunkBuilderPool() const
+{
+	return mChunkBuilderPool;
+}
+
 int64_t BeaconSendingContext::getLastStatusCheckTime() const
 {
 	return mLastStatusCheckTime;
@@ -201,6 +667,14 @@ void BeaconSendingContext::disableCapture()
 	clearAllSessionData();
 }
 
+void BeaconSendingContext::disableCaptureAndStoreData()
+{
+	// first disable in configuration, so no further data will get collected
+	mConfiguration->disableCapture();
+	storeAllSessionData();
+	clearAllSessionData();
+}
+
 int64_t BeaconSendingContext::getCurrentTimestamp() const
 {
 	return mTimingProvider->provideTimestampInMilliseconds();
@@ -224,60 +698,32 @@ AbstractBeaconSendingState::StateType BeaconSendingContext::getCurrentStateType(
 void BeaconSendingContext::startSession(std::shared_ptr<core::Session> session)
 {
 	auto sessionWrapper = std::make_shared<core::SessionWrapper>(session);
-	mSessions.put(sessionWrapper);
+	mSessions.add(sessionWrapper);
+	mWakeupEvent->signal(); // send the new session request
 }
 
 void BeaconSendingContext::finishSession(std::shared_ptr<core::Session> session)
 {
-	std::shared_ptr<core::SessionWrapper> sessionWrapper = findSessionWrapper(session);
+	auto sessionWrapper = mSessions.finish(session);
 	if (sessionWrapper != nullptr)
 	{
-		sessionWrapper->finishSession();
+		mWakeupEvent->signal(); // send the finished session
 	}
 }
 
 std::vector<std::shared_ptr<core::SessionWrapper>> BeaconSendingContext::getAllNewSessions()
 {
-	std::vector<std::shared_ptr<core::SessionWrapper>> newSessions;
-
-	for (auto wrapper : mSessions.toStdVector())
-	{
-		if (!wrapper->isBeaconConfigurationSet())
-		{
-			newSessions.push_back(wrapper);
-		}
-	}
-
-	return newSessions;
+	return mSessions.getNewSessions();
 }
 
 std::vector<std::shared_ptr<core::SessionWrapper>> BeaconSendingContext::getAllOpenAndConfiguredSessions()
 {
-	std::vector<std::shared_ptr<core::SessionWrapper>> openSessions;
-
-	for (auto wrapper : mSessions.toStdVector())
-	{
-		if (wrapper->isBeaconConfigurationSet() && !wrapper->isSessionFinished())
-		{
-			openSessions.push_back(wrapper);
-		}
-	}
-
-	return openSessions;
+	return mSessions.getOpenSessions();
 }
 
 std::vector<std::shared_ptr<core::SessionWrapper>> BeaconSendingContext::getAllFinishedAndConfiguredSessions()
 {
-	std::vector<std::shared_ptr<core::SessionWrapper>> finishedSessions;
-	for (auto wrapper : mSessions.toStdVector())
-	{
-		if (wrapper->isBeaconConfigurationSet() && wrapper->isSessionFinished())
-		{
-			finishedSessions.push_back(wrapper);
-		}
-	}
-
-	return finishedSessions;
+	return mSessions.getFinishedSessions();
 }
 
 std::shared_ptr<AbstractBeaconSendingState> BeaconSendingContext::getNextState()
@@ -287,14 +733,7 @@ std::shared_ptr<AbstractBeaconSendingState> BeaconSendingContext::getNextState()
 
 std::shared_ptr<core::SessionWrapper> BeaconSendingContext::findSessionWrapper(std::shared_ptr<core::Session> session)
 {
-	for (auto sessionWrapper : mSessions.toStdVector())
-	{
-		if ( sessionWrapper->getWrappedSession() == session )
-		{
-			return sessionWrapper;
-		}
-	}
-	return nullptr;
+	return mSessions.find(session);
 }
 
 bool BeaconSendingContext::removeSession(std::shared_ptr<core::SessionWrapper> sessionWrapper)
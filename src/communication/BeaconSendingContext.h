@@ -18,14 +18,22 @@
 #define _COMMUNICATION_BEACONSENDINGCONTEXT_H
 
 #include "OpenKit/ILogger.h"
+#include "OpenKit/ShutdownReport.h"
 #include "core/util/CountDownLatch.h"
-#include "core/util/SynchronizedQueue.h"
+#include "core/util/WakeupEvent.h"
+#include "core/util/WorkStealingThreadPool.h"
 #include "providers/IHTTPClientProvider.h"
 #include "providers/ITimingProvider.h"
 #include "configuration/Configuration.h"
+#include "caching/BeaconChunkStore.h"
 #include "protocol/StatusResponse.h"
 #include "communication/AbstractBeaconSendingState.h"
+#include "communication/BeaconSendingOpenSessionScheduler.h"
+#include "communication/BeaconSendingRetryScheduler.h"
+#include "communication/BeaconSendingSessionPrioritizer.h"
+#include "protocol/UploadRateLimiter.h"
 #include "core/Session.h"
+#include "core/SessionRegistry.h"
 #include "core/SessionWrapper.h"
 
 #include <atomic>
@@ -33,6 +41,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <functional>
 
 namespace communication
 {
@@ -42,6 +51,18 @@ namespace communication
 	class BeaconSendingContext
 	{
 	public:
+		///
+		/// Outcome of sending the beacon of a single session via @ref sendBeacons
+		///
+		struct SendBeaconResult
+		{
+			/// flag indicating whether the beacon was sent, @c false if sending was skipped
+			bool sent = false;
+
+			/// the response of the last request, @c nullptr if the beacon was not sent or was empty
+			std::shared_ptr<protocol::StatusResponse> response = nullptr;
+		};
+
 		///
 		/// Constructor
 		/// @param[in] logger to write traces to
@@ -80,6 +101,19 @@ namespace communication
 		///
 		virtual void requestShutdown();
 
+		///
+		/// Request shutdown, the remaining data has to be sent within the given timeout.
+		/// Requests still in flight when the timeout expires are aborted.
+		/// @param[in] timeoutMillis maximum number of milliseconds for sending the remaining data
+		///
+		void requestShutdownWithTimeout(int64_t timeoutMillis);
+
+		///
+		/// Returns whether the timeout passed to @ref requestShutdownWithTimeout has expired
+		/// @returns @c true if a shutdown timeout was requested and has expired, @c false otherwise
+		///
+		bool isShutdownDeadlineExpired() const;
+
 		///
 		/// Return a flag if shutdown was requested
 		/// @returns @c true if shutdown was requested, @c false if not
@@ -155,6 +189,93 @@ namespace communication
 		///
 		virtual std::shared_ptr<protocol::IHTTPClient> getHTTPClient();
 
+		///
+		/// Returns the scheduler deferring sessions whose requests failed
+		/// @returns the retry scheduler
+		///
+		std::shared_ptr<BeaconSendingRetryScheduler> getRetryScheduler() const;
+
+		///
+		/// Returns the rate limiter shared by all uploads
+		/// @returns the upload rate limiter
+		///
+		std::shared_ptr<protocol::UploadRateLimiter> getUploadRateLimiter() const;
+
+		///
+		/// Returns the scheduler spreading the beacons of open sessions across the send interval
+		/// @returns the open session scheduler or @c nullptr if open sessions are sent all at once
+		///
+		std::shared_ptr<BeaconSendingOpenSessionScheduler> getOpenSessionScheduler() const;
+
+		///
+		/// Returns the prioritizer ordering the sessions of a send pass
+		/// @returns the session prioritizer
+		///
+		std::shared_ptr<BeaconSendingSessionPrioritizer> getSessionPrioritizer() const;
+
+		///
+		/// Send the beacons of the given sessions.
+		///
+		/// If a beacon sending concurrency greater than one is configured, the beacons are sent in parallel
+		/// by the upload workers, otherwise one after the other on the calling thread. Either way this method
+		/// returns after all requests completed, so at most one request per session is in flight and the
+		/// beacons of a single session are sent in order.
+		/// Beacons not yet sent are skipped as soon as the upload budget is exhausted or a
+		/// "too many requests" response was received.
+		/// @param[in] sessions the sessions whose beacons to send
+		/// @returns the results, in the same order as @c sessions
+		///
+		std::vector<SendBeaconResult> sendBeacons(const std::vector<std::shared_ptr<core::SessionWrapper>>& sessions);
+
+		///
+		/// Send the beacons of the given finished sessions when shutting down.
+		///
+		/// The beacons are sent like in @ref sendBeacons, but regardless of the upload budget. Sessions not allowed
+		/// to send data are skipped, as are the sessions not sent yet once the shutdown timeout expired or a
+		/// "too many requests" response was received. How much data was sent and discarded is recorded for the
+		/// report returned by @ref getShutdownReport.
+		/// @param[in] sessions the sessions whose beacons to send
+		/// @returns the results, in the same order as @c sessions
+		///
+		std::vector<SendBeaconResult> flushBeacons(const std::vector<std::shared_ptr<core::SessionWrapper>>& sessions);
+
+		///
+		/// Returns how much data was sent and discarded by @ref flushBeacons
+		/// @returns the shutdown report
+		///
+		openkit::ShutdownReport getShutdownReport() const;
+
+		///
+		/// Send the given number of new session requests.
+		///
+		/// The requests are sent with bounded concurrency by the upload workers (see @ref sendBeacons). Each worker
+		/// reuses one HTTP client, and thereby its connection, for all requests it sends within this call.
+		/// Requests not yet sent are skipped as soon as a "too many requests" response was received.
+		/// @param[in] numRequests the number of new session requests to send
+		/// @returns the responses, @c nullptr for requests which were skipped
+		///
+		std::vector<std::shared_ptr<protocol::StatusResponse>> sendNewSessionRequests(size_t numRequests);
+
+		///
+		/// Returns whether the multiplicity of a fresh new session response is shared by all sessions created shortly after
+		/// @returns @c true if a multiplicity sharing window is configured
+		///
+		bool isMultiplicityShared() const;
+
+		///
+		/// Returns the last successful new session response, if it is still within the multiplicity sharing window
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns the shared response or @c nullptr if there is none or sharing is disabled
+		///
+		std::shared_ptr<protocol::StatusResponse> getSharedNewSessionResponse(int64_t timestamp) const;
+
+		///
+		/// Remembers a successful new session response for sharing its multiplicity with subsequently created sessions
+		/// @param[in] response the successful new session response
+		/// @param[in] timestamp the timestamp in milliseconds when the response was received
+		///
+		void setSharedNewSessionResponse(std::shared_ptr<protocol::StatusResponse> response, int64_t timestamp);
+
 		///
 		/// Get current timestamp
 		/// @returns current timestamp
@@ -172,6 +293,52 @@ namespace communication
 		///
 		virtual void sleep(int64_t ms);
 
+		///
+		/// Wait until there is something to send.
+		///
+		/// The waiting thread is woken up when a session is started or finished, when a session reaches
+		/// its flush threshold, when shutdown is requested or when the delay returned by @ref getWakeupDelay() expired.
+		///
+		virtual void waitForWakeup();
+
+		///
+		/// Calculate the time until the earliest session becomes due for sending.
+		///
+		/// New and finished sessions are due once their retry is due, stored chunks once the replay rate allows
+		/// sending the next one. Open sessions are not inspected one by one:
+		/// they are due once a scheduled retry is due or, if data arrived since they were sent last, once the send
+		/// interval expired. Reaching the flush threshold raises the wakeup event, so it does not need a deadline.
+		/// @returns the delay in milliseconds, or a negative value if no session is waiting to be sent
+		///
+		int64_t getWakeupDelay();
+
+		///
+		/// Set whether open sessions hold data to be sent when the send interval expired.
+		///
+		/// The flag is raised whenever the wakeup event woke up the beacon sending thread and cleared by the
+		/// capture-on state after a send pass left no data behind.
+		/// @param[in] dataPending @c true if open sessions hold data, @c false otherwise
+		///
+		void setOpenSessionDataPending(bool dataPending);
+
+		///
+		/// Returns whether open sessions hold data to be sent when the send interval expired.
+		/// @returns @c true if open sessions hold data, @c false otherwise
+		///
+		bool isOpenSessionDataPending() const;
+
+		///
+		/// Returns the event which wakes up the thread blocked in @ref waitForWakeup() when raised.
+		/// @returns the wakeup event
+		///
+		std::shared_ptr<core::util::WakeupEvent> getWakeupEvent() const;
+
+		///
+		/// Returns the pool assembling and compressing the following chunk of a beacon while a chunk is in flight.
+		/// @returns the chunk builder pool, holding one thread per beacon sending thread
+		///
+		std::shared_ptr<core::util::WorkStealingThreadPool> getChunkBuilderPool() const;
+
 		///
 		/// Get timestamp when open sessions were sent last
 		/// @returns timestamp of last sending of open session
@@ -202,11 +369,24 @@ namespace communication
 		///
 		virtual int64_t getSendInterval() const;
 
+		///
+		/// Re-evaluates cache and collector load and adapts the send interval if adaptive sending is enabled.
+		///
+		virtual void updateAdaptiveSending();
+
 		///
 		/// Disable data capturing.
 		///
 		virtual void disableCapture();
 
+		///
+		/// Disable data capturing, storing the data captured so far if store-and-forward is configured.
+		///
+		/// This is used while the server asks to back off, so that the data is sent once capturing is re-enabled
+		/// instead of being dropped.
+		///
+		virtual void disableCaptureAndStoreData();
+
 		///
 		/// Handle the status response received from the server
 		/// Update the current configuration accordingly
@@ -218,6 +398,28 @@ namespace communication
 		///
 		void clearAllSessionData();
 
+		///
+		/// Stores the data of all sessions allowed to send data in the chunk store, if store-and-forward is configured
+		///
+		void storeAllSessionData();
+
+		///
+		/// Sends the chunks stored while capturing was off, oldest first.
+		///
+		/// Replaying stops at the first failed request, keeping the chunk for the next attempt, and if the upload
+		/// budget is exhausted. Chunks rejected with a client error other than "too many requests" are dropped,
+		/// since they would block the store forever otherwise. The replay rate is limited to the configured number of bytes per second, further
+		/// chunks are deferred to the following calls.
+		/// @returns the response of the last replayed chunk or @c nullptr if no chunk was sent
+		///
+		std::shared_ptr<protocol::StatusResponse> replayStoredChunks();
+
+		///
+		/// Returns the store holding chunks while capturing is off
+		/// @returns the chunk store or @c nullptr if store-and-forward is not configured
+		///
+		std::shared_ptr<caching::BeaconChunkStore> getChunkStore() const;
+
 		///
 		/// Get all sessions that are considered new.
 		///
@@ -285,6 +487,21 @@ namespace communication
 		virtual bool removeSession(std::shared_ptr<core::SessionWrapper> sessionWrapper);
 
 	private:
+		///
+		/// Run the given task for each index, either on the upload workers or on the calling thread.
+		/// Returns after all tasks completed.
+		/// @param[in] numTasks the number of tasks
+		/// @param[in] task the task, called with the index of each task
+		///
+		void runTasks(size_t numTasks, const std::function<void(size_t)>& task);
+
+		///
+		/// Returns whether a replayed chunk was rejected for good, i.e. with a client error other than "too many requests"
+		/// @param[in] response the erroneous response received for the chunk
+		/// @returns @c true if the chunk has to be dropped, @c false if it may be sent again later on
+		///
+		static bool isPermanentError(std::shared_ptr<protocol::StatusResponse> response);
+
 		/// Logger to write traces to
 		std::shared_ptr<openkit::ILogger> mLogger;
 
@@ -303,6 +520,9 @@ namespace communication
 		/// condition variable used to wait on when calling sleep.
 		std::condition_variable mSleepConditionVariable;
 
+		/// event used to wake up the thread waiting for sessions to send
+		std::shared_ptr<core::util::WakeupEvent> mWakeupEvent;
+
 		/// Atomic flag for successful initialization
 		std::atomic<bool> mInitSucceeded;
 
@@ -321,11 +541,59 @@ namespace communication
 		/// time when open sessions were last sent
 		int64_t mLastOpenSessionBeaconSendTime;
 
+		/// flag indicating that open sessions may hold data which was not sent yet
+		bool mOpenSessionDataPending;
+
+		/// flag indicating that the last send pass left beacons unsent, since the upload budget was exhausted
+		std::atomic<bool> mHasUnsentBeacons;
+
 		/// countdown latch used for wait-on-initialization
 		core::util::CountDownLatch mInitCountdownLatch;
 
-		/// container storing all session wrappers
-		core::util::SynchronizedQueue<std::shared_ptr<core::SessionWrapper>> mSessions;
+		/// registry of all session wrappers, bucketed by their lifecycle state
+		core::SessionRegistry mSessions;
+
+		/// scheduler for retries of failed requests
+		std::shared_ptr<BeaconSendingRetryScheduler> mRetryScheduler;
+
+		/// rate limiter shared by all uploads
+		std::shared_ptr<protocol::UploadRateLimiter> mUploadRateLimiter;
+
+		/// scheduler spreading open session sends across the send interval, @c nullptr if they are sent all at once
+		std::shared_ptr<BeaconSendingOpenSessionScheduler> mOpenSessionScheduler;
+
+		/// orders the sessions of a send pass
+		std::shared_ptr<BeaconSendingSessionPrioritizer> mSessionPrioritizer;
+
+		/// workers sending beacons in parallel, @c nullptr if beacons are sent on the beacon sending thread
+		std::unique_ptr<core::util::WorkStealingThreadPool> mWorkerPool;
+
+		/// threads building the following chunk of the beacons being sent, see @ref getChunkBuilderPool
+		std::shared_ptr<core::util::WorkStealingThreadPool> mChunkBuilderPool;
+
+		/// last successful new session response shared with subsequently created sessions
+		std::shared_ptr<protocol::StatusResponse> mSharedNewSessionResponse;
+
+		/// timestamp when the shared new session response was received
+		int64_t mSharedNewSessionResponseTime;
+
+		/// timestamp when the remaining data has to be sent at latest, @c -1 if no shutdown timeout was requested
+		std::atomic<int64_t> mShutdownDeadline;
+
+		/// how much data was sent and discarded when shutting down
+		openkit::ShutdownReport mShutdownReport;
+
+		/// mutex protecting the shutdown report
+		mutable std::mutex mShutdownReportMutex;
+
+		/// store holding chunks while capturing is off, @c nullptr if store-and-forward is not configured
+		std::shared_ptr<caching::BeaconChunkStore> mChunkStore;
+
+		/// rate stored chunks are sent with, unlimited if not positive
+		int64_t mReplayBytesPerSecond;
+
+		/// timestamp before which no further stored chunk is sent
+		int64_t mNextReplayTime;
 	};
 }
 #endif
@@ -24,7 +24,6 @@
 #include "communication/AbstractBeaconSendingState.h"
 #include "communication/BeaconSendingContext.h"
 #include "communication/BeaconSendingTerminalState.h"
-#include "communication/BeaconSendingResponseUtil.h"
 
 using namespace communication;
 
@@ -49,18 +48,14 @@ void BeaconSendingFlushSessionsState::doExecute(BeaconSendingContext& context)
 		openSession->end();
 	}
 
-	// flush already finished (and previously ended) sessions
-	auto tooManyRequestsReceived = false;
-	for (auto finishedSession : context.getAllFinishedAndConfiguredSessions())
+	// flush already finished (and previously ended) sessions, the ones holding most data first,
+	// so that as little data as possible is lost if the shutdown timeout expires
+	auto finishedSessions = context.getAllFinishedAndConfiguredSessions();
+	context.getSessionPrioritizer()->prioritizeByCachedData(finishedSessions);
+
+	context.flushBeacons(finishedSessions);
+	for (auto finishedSession : finishedSessions)
 	{
-		if (!tooManyRequestsReceived && finishedSession->isDataSendingAllowed())
-		{
-			auto response = finishedSession->sendBeacon(context.getHTTPClientProvider());
-			if (BeaconSendingResponseUtil::isTooManyRequestsResponse(response))
-			{
-				tooManyRequestsReceived = true;
-			}
-		}
 		finishedSession->clearCapturedData();
 		context.removeSession(finishedSession);
 	}
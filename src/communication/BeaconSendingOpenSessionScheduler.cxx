@@ -0,0 +1,110 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "BeaconSendingOpenSessionScheduler.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+
+using namespace communication;
+
+BeaconSendingOpenSessionScheduler::BeaconSendingOpenSessionScheduler(bool jitterEnabled, std::shared_ptr<providers::IPRNGenerator> randomGenerator)
+	: mJitterEnabled(jitterEnabled)
+	, mRandomGenerator(randomGenerator)
+	, mSchedule()
+	, mNextSequenceNumber(0)
+{
+}
+
+void BeaconSendingOpenSessionScheduler::scheduleCohort(const std::vector<std::shared_ptr<core::SessionWrapper>>& sessions, int64_t startTime, int64_t sendInterval)
+{
+	std::unordered_set<const core::SessionWrapper*> openSessions;
+	for (auto& session : sessions)
+	{
+		openSessions.insert(session.get());
+	}
+
+	// sessions still pending from the previous cohort come first, unless they are no longer open
+	std::vector<std::shared_ptr<core::SessionWrapper>> cohort;
+	std::unordered_set<const core::SessionWrapper*> scheduledSessions;
+	while (!mSchedule.empty())
+	{
+		auto session = mSchedule.top().session;
+		mSchedule.pop();
+		if (openSessions.count(session.get()) > 0 && scheduledSessions.insert(session.get()).second)
+		{
+			cohort.push_back(session);
+		}
+	}
+
+	for (auto& session : sessions)
+	{
+		if (scheduledSessions.count(session.get()) == 0 && !session->isEmpty())
+		{
+			cohort.push_back(session);
+		}
+	}
+
+	// session i gets the slot [start + i * interval / n, start + (i + 1) * interval / n)
+	auto numSessions = static_cast<int64_t>(cohort.size());
+	auto interval = std::max(sendInterval, int64_t(0));
+	for (int64_t i = 0; i < numSessions; i++)
+	{
+		auto slotStart = i * interval / numSessions;
+		auto slotLength = (i + 1) * interval / numSessions - slotStart;
+		auto jitter = mJitterEnabled && slotLength > 1 ? mRandomGenerator->nextInt64(slotLength) : 0;
+		push(cohort[static_cast<size_t>(i)], startTime + slotStart + jitter);
+	}
+}
+
+std::vector<std::shared_ptr<core::SessionWrapper>> BeaconSendingOpenSessionScheduler::pollDueSessions(int64_t timestamp)
+{
+	std::vector<std::shared_ptr<core::SessionWrapper>> dueSessions;
+	while (!mSchedule.empty() && mSchedule.top().deadline <= timestamp)
+	{
+		dueSessions.push_back(mSchedule.top().session);
+		mSchedule.pop();
+	}
+
+	return dueSessions;
+}
+
+void BeaconSendingOpenSessionScheduler::postpone(std::shared_ptr<core::SessionWrapper> session, int64_t deadline)
+{
+	push(session, deadline);
+}
+
+int64_t BeaconSendingOpenSessionScheduler::getNextDeadline() const
+{
+	return mSchedule.empty() ? std::numeric_limits<int64_t>::max() : mSchedule.top().deadline;
+}
+
+size_t BeaconSendingOpenSessionScheduler::size() const
+{
+	return mSchedule.size();
+}
+
+void BeaconSendingOpenSessionScheduler::clear()
+{
+	mSchedule = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>();
+}
+
+void BeaconSendingOpenSessionScheduler::push(std::shared_ptr<core::SessionWrapper> session, int64_t deadline)
+{
+	mSchedule.push(Entry{ deadline, mNextSequenceNumber++, session });
+}
@@ -0,0 +1,135 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _COMMUNICATION_BEACONSENDINGOPENSESSIONSCHEDULER_H
+#define _COMMUNICATION_BEACONSENDINGOPENSESSIONSCHEDULER_H
+
+#include "core/SessionWrapper.h"
+#include "providers/IPRNGenerator.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace communication
+{
+	///
+	/// Spreads the beacons of open sessions evenly across the send interval.
+	///
+	/// Instead of sending all open sessions back to back whenever the send interval expires, each session of
+	/// the cohort gets its own deadline within the interval. The deadlines are kept in a min-heap, so that the
+	/// beacon sending states only pick the sessions which are due. Optionally the deadlines are jittered within
+	/// the slot of each session. Sessions of the previous cohort which are still pending are scheduled first,
+	/// therefore every cohort is sent completely within one send interval.
+	///
+	class BeaconSendingOpenSessionScheduler
+	{
+	public:
+		///
+		/// Constructor
+		/// @param[in] jitterEnabled @c true to randomize the deadline of each session within its slot
+		/// @param[in] randomGenerator random number generator used for jitter
+		///
+		BeaconSendingOpenSessionScheduler(bool jitterEnabled, std::shared_ptr<providers::IPRNGenerator> randomGenerator);
+
+		///
+		/// Schedules the open sessions of a new send interval.
+		///
+		/// The sessions, which have data, are assigned deadlines evenly distributed between @c startTime (inclusive)
+		/// and @c startTime + @c sendInterval (exclusive). Pending sessions of the previous cohort get the first slots.
+		/// @param[in] sessions the open sessions
+		/// @param[in] startTime the start of the send interval in milliseconds
+		/// @param[in] sendInterval the send interval in milliseconds
+		///
+		void scheduleCohort(const std::vector<std::shared_ptr<core::SessionWrapper>>& sessions, int64_t startTime, int64_t sendInterval);
+
+		///
+		/// Removes and returns all sessions whose deadline is reached.
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns the due sessions ordered by their deadline
+		///
+		std::vector<std::shared_ptr<core::SessionWrapper>> pollDueSessions(int64_t timestamp);
+
+		///
+		/// Schedules a session again, e.g. after it could not be sent due to the upload rate limit.
+		/// @param[in] session the session to schedule
+		/// @param[in] deadline the new deadline in milliseconds
+		///
+		void postpone(std::shared_ptr<core::SessionWrapper> session, int64_t deadline);
+
+		///
+		/// Returns the earliest deadline of all scheduled sessions.
+		/// @returns the deadline in milliseconds or @c std::numeric_limits<int64_t>::max() if no session is scheduled
+		///
+		int64_t getNextDeadline() const;
+
+		///
+		/// Returns the number of scheduled sessions
+		/// @returns the number of scheduled sessions
+		///
+		size_t size() const;
+
+		///
+		/// Removes all scheduled sessions
+		///
+		void clear();
+
+	private:
+		///
+		/// A scheduled session
+		///
+		struct Entry
+		{
+			/// the deadline in milliseconds
+			int64_t deadline;
+
+			/// insertion sequence number, keeping sessions with the same deadline in order
+			uint64_t sequenceNumber;
+
+			/// the scheduled session
+			std::shared_ptr<core::SessionWrapper> session;
+
+			bool operator>(const Entry& other) const
+			{
+				return deadline != other.deadline ? deadline > other.deadline : sequenceNumber > other.sequenceNumber;
+			}
+		};
+
+		///
+		/// Adds a session to the heap
+		/// @param[in] session the session to schedule
+		/// @param[in] deadline the deadline in milliseconds
+		///
+		void push(std::shared_ptr<core::SessionWrapper> session, int64_t deadline);
+
+		/// @c true if the deadlines are jittered
+		bool mJitterEnabled;
+
+		/// random number generator used for jitter
+		std::shared_ptr<providers::IPRNGenerator> mRandomGenerator;
+
+		/// min-heap of scheduled sessions
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> mSchedule;
+
+		/// next insertion sequence number
+		uint64_t mNextSequenceNumber;
+	};
+}
+
+#endif
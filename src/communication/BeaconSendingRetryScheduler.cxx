@@ -0,0 +1,101 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "BeaconSendingRetryScheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace communication;
+
+BeaconSendingRetryScheduler::BeaconSendingRetryScheduler(std::shared_ptr<configuration::RetryPolicy> retryPolicy, std::shared_ptr<providers::IPRNGenerator> randomGenerator)
+	: mRetryPolicy(retryPolicy)
+	, mRandomGenerator(randomGenerator)
+	, mScheduledRetries()
+	, mMutex()
+{
+}
+
+bool BeaconSendingRetryScheduler::isSendDue(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp) const
+{
+	return session->getNextSendAttemptTime() <= timestamp;
+}
+
+bool BeaconSendingRetryScheduler::isRetryDue(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp) const
+{
+	return session->getNumFailedSendAttempts() > 0 && isSendDue(session, timestamp);
+}
+
+bool BeaconSendingRetryScheduler::scheduleRetry(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp)
+{
+	auto maxRetryAttempts = mRetryPolicy->getMaxRetryAttempts();
+	if (maxRetryAttempts >= 0 && session->getNumFailedSendAttempts() >= static_cast<uint32_t>(maxRetryAttempts))
+	{
+		return false;
+	}
+
+	auto nextSendAttemptTime = timestamp + getRetryDelay(session->getNumFailedSendAttempts() + 1);
+	session->recordFailedSendAttempt(nextSendAttemptTime);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mScheduledRetries.push(ScheduledRetry(nextSendAttemptTime, session));
+	return true;
+}
+
+void BeaconSendingRetryScheduler::resetRetry(std::shared_ptr<core::SessionWrapper> session)
+{
+	session->resetFailedSendAttempts();
+}
+
+int64_t BeaconSendingRetryScheduler::getNextRetryTime(int64_t timestamp)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	while (!mScheduledRetries.empty())
+	{
+		auto& retry = mScheduledRetries.top();
+		auto session = retry.second.lock();
+		if (session != nullptr && session->getNextSendAttemptTime() == retry.first && retry.first > timestamp)
+		{
+			return retry.first;
+		}
+
+		// stale or already due
+		mScheduledRetries.pop();
+	}
+
+	return std::numeric_limits<int64_t>::max();
+}
+
+int64_t BeaconSendingRetryScheduler::getRetryDelay(uint32_t numFailedAttempts)
+{
+	auto maxRetryDelay = std::max(mRetryPolicy->getMaxRetryDelay(), int64_t(0));
+	auto delay = std::min(std::max(mRetryPolicy->getInitialRetryDelay(), int64_t(0)), maxRetryDelay);
+
+	// double the delay for each further attempt, stop doubling once the upper bound is reached
+	for (uint32_t attempt = 1; attempt < numFailedAttempts && delay < maxRetryDelay; attempt++)
+	{
+		delay = std::min(delay * 2, maxRetryDelay);
+	}
+
+	// equal jitter - keep half of the delay and randomize the other half
+	auto halfDelay = delay / 2;
+	return (delay - halfDelay) + mRandomGenerator->nextInt64(halfDelay + 1);
+}
+
+std::shared_ptr<configuration::RetryPolicy> BeaconSendingRetryScheduler::getRetryPolicy() const
+{
+	return mRetryPolicy;
+}
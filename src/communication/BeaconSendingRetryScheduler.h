@@ -0,0 +1,136 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _COMMUNICATION_BEACONSENDINGRETRYSCHEDULER_H
+#define _COMMUNICATION_BEACONSENDINGRETRYSCHEDULER_H
+
+#include "configuration/RetryPolicy.h"
+#include "providers/IPRNGenerator.h"
+#include "core/SessionWrapper.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace communication
+{
+	///
+	/// Schedules retries of failed requests without blocking the beacon sending thread.
+	///
+	/// Instead of sleeping after a failed request, the session is deferred until its backoff expired
+	/// and the beacon sending states skip it in the meantime, so that other sessions keep being sent.
+	/// The backoff grows exponentially with the number of failed attempts and is jittered to avoid
+	/// that many clients hit a recovering server at the same time.
+	///
+	class BeaconSendingRetryScheduler
+	{
+	public:
+		///
+		/// Constructor
+		/// @param[in] retryPolicy the retry policy to apply
+		/// @param[in] randomGenerator random number generator used for jitter
+		///
+		BeaconSendingRetryScheduler(std::shared_ptr<configuration::RetryPolicy> retryPolicy, std::shared_ptr<providers::IPRNGenerator> randomGenerator);
+
+		///
+		/// Returns whether a request for the given session may be sent at the given time.
+		/// @param[in] session the session to check
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns @c true if the session is not deferred by a pending retry, @c false otherwise
+		///
+		bool isSendDue(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp) const;
+
+		///
+		/// Returns whether a retry is pending for the given session and due at the given time.
+		/// @param[in] session the session to check
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns @c true if a previous request failed and its retry is due, @c false otherwise
+		///
+		bool isRetryDue(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp) const;
+
+		///
+		/// Defers the given session after a failed request.
+		/// @param[in] session the session whose request failed
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns @c true if a retry was scheduled, @c false if the maximum number of retries is exhausted
+		///
+		bool scheduleRetry(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp);
+
+		///
+		/// Clears the retry state of the given session after a successful request.
+		/// @param[in] session the session whose request succeeded
+		///
+		void resetRetry(std::shared_ptr<core::SessionWrapper> session);
+
+		///
+		/// Returns the earliest pending retry after the given time.
+		///
+		/// Retries which have been reset, rescheduled or whose session is gone are discarded lazily, as are
+		/// retries which are already due, since the beacon sending states pick those up in their next pass.
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns the time of the next retry or @c INT64_MAX if no retry is pending
+		///
+		int64_t getNextRetryTime(int64_t timestamp);
+
+		///
+		/// Calculates the jittered backoff delay for a given number of failed attempts.
+		///
+		/// The delay is @c initialRetryDelay * 2^(numFailedAttempts - 1), capped at @c maxRetryDelay.
+		/// The returned value lies uniformly distributed between half of that delay and the full delay.
+		/// @param[in] numFailedAttempts the number of consecutive failed attempts (at least @c 1)
+		/// @returns the delay in milliseconds
+		///
+		int64_t getRetryDelay(uint32_t numFailedAttempts);
+
+		///
+		/// Returns the retry policy
+		/// @returns the retry policy
+		///
+		std::shared_ptr<configuration::RetryPolicy> getRetryPolicy() const;
+
+	private:
+		/// scheduled retry, consisting of the time the retry is due and the deferred session
+		typedef std::pair<int64_t, std::weak_ptr<core::SessionWrapper>> ScheduledRetry;
+
+		///
+		/// Orders scheduled retries so that the earliest one is on top of the heap
+		///
+		struct LaterRetry
+		{
+			bool operator()(const ScheduledRetry& lhs, const ScheduledRetry& rhs) const
+			{
+				return lhs.first > rhs.first;
+			}
+		};
+
+		/// the retry policy
+		std::shared_ptr<configuration::RetryPolicy> mRetryPolicy;
+
+		/// random number generator used for jitter
+		std::shared_ptr<providers::IPRNGenerator> mRandomGenerator;
+
+		/// scheduled retries, earliest first
+		std::priority_queue<ScheduledRetry, std::vector<ScheduledRetry>, LaterRetry> mScheduledRetries;
+
+		/// mutex protecting the scheduled retries
+		std::mutex mMutex;
+	};
+}
+
+#endif
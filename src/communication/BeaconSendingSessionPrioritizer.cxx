@@ -0,0 +1,99 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "communication/BeaconSendingSessionPrioritizer.h"
+
+#include <algorithm>
+
+using namespace communication;
+
+BeaconSendingSessionPrioritizer::BeaconSendingSessionPrioritizer(openkit::SendPriorityPolicy policy, int64_t maxRecordAge, int64_t cacheSizeUpperBound)
+	: mPolicy(policy)
+	, mMaxRecordAge(maxRecordAge)
+	, mCacheSizeUpperBound(cacheSizeUpperBound)
+{
+}
+
+void BeaconSendingSessionPrioritizer::prioritize(std::vector<std::shared_ptr<core::SessionWrapper>>& sessions, int64_t timestamp) const
+{
+	if (mPolicy == openkit::SendPriorityPolicy::INSERTION_ORDER)
+	{
+		return;
+	}
+
+	sortByRating(sessions, [this, timestamp](const std::shared_ptr<core::SessionWrapper>& session)
+	{
+		return getEvictionRisk(session, timestamp);
+	});
+}
+
+void BeaconSendingSessionPrioritizer::prioritizeByCachedData(std::vector<std::shared_ptr<core::SessionWrapper>>& sessions) const
+{
+	sortByRating(sessions, [](const std::shared_ptr<core::SessionWrapper>& session)
+	{
+		return static_cast<double>(session->getWrappedSession()->getNumBytesInCache());
+	});
+}
+
+void BeaconSendingSessionPrioritizer::sortByRating(std::vector<std::shared_ptr<core::SessionWrapper>>& sessions, const SessionRating& rating)
+{
+	if (sessions.size() < 2)
+	{
+		return;
+	}
+
+	// rate each session once, the cache entries are locked for every lookup
+	std::vector<std::pair<double, std::shared_ptr<core::SessionWrapper>>> ratedSessions;
+	ratedSessions.reserve(sessions.size());
+	for (auto& session : sessions)
+	{
+		ratedSessions.emplace_back(rating(session), session);
+	}
+
+	std::stable_sort(ratedSessions.begin(), ratedSessions.end(),
+		[](const std::pair<double, std::shared_ptr<core::SessionWrapper>>& lhs, const std::pair<double, std::shared_ptr<core::SessionWrapper>>& rhs)
+		{
+			return lhs.first > rhs.first;
+		});
+
+	for (size_t i = 0; i < sessions.size(); i++)
+	{
+		sessions[i] = ratedSessions[i].second;
+	}
+}
+
+double BeaconSendingSessionPrioritizer::getEvictionRisk(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp) const
+{
+	auto risk = 0.0;
+
+	auto oldestRecordTimestamp = session->getWrappedSession()->getOldestRecordTimestamp();
+	if (oldestRecordTimestamp >= 0 && mMaxRecordAge > 0)
+	{
+		risk += static_cast<double>(std::max(timestamp - oldestRecordTimestamp, int64_t(0))) / mMaxRecordAge;
+	}
+
+	if (mCacheSizeUpperBound > 0)
+	{
+		risk += static_cast<double>(session->getWrappedSession()->getNumBytesInCache()) / mCacheSizeUpperBound;
+	}
+
+	return risk;
+}
+
+openkit::SendPriorityPolicy BeaconSendingSessionPrioritizer::getPolicy() const
+{
+	return mPolicy;
+}
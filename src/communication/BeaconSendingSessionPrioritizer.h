@@ -0,0 +1,110 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _COMMUNICATION_BEACONSENDINGSESSIONPRIORITIZER_H
+#define _COMMUNICATION_BEACONSENDINGSESSIONPRIORITIZER_H
+
+#include "OpenKit/SendPriorityPolicy.h"
+#include "core/SessionWrapper.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace communication
+{
+	///
+	/// Orders the sessions of a send pass according to a @ref openkit::SendPriorityPolicy.
+	///
+	/// If a pass is cut short, e.g. because the server responds with "too many requests", the upload budget is
+	/// exhausted or OpenKit is shut down, the sessions at the front of the list are the ones which got sent.
+	/// With @ref openkit::SendPriorityPolicy::EVICTION_RISK these are the sessions whose data would be evicted first:
+	/// both eviction strategies remove the oldest records first, so sessions holding older data come first, and
+	/// among sessions of similar age the ones holding more bytes, since sending them frees more of the cache.
+	/// Finished sessions are always sent before open sessions, since the beacon sending states send them in a separate
+	/// step first.
+	///
+	class BeaconSendingSessionPrioritizer
+	{
+	public:
+		///
+		/// Constructor
+		/// @param[in] policy the order in which sessions are sent
+		/// @param[in] maxRecordAge maximum age of a record in the beacon cache before it is evicted, in milliseconds
+		/// @param[in] cacheSizeUpperBound upper memory boundary of the beacon cache in bytes
+		///
+		BeaconSendingSessionPrioritizer(openkit::SendPriorityPolicy policy, int64_t maxRecordAge, int64_t cacheSizeUpperBound);
+
+		///
+		/// Reorders the given sessions, the session to send first is moved to the front.
+		/// @remarks Sessions of equal priority keep their relative order.
+		/// @param[in,out] sessions the sessions to send
+		/// @param[in] timestamp the current timestamp in milliseconds
+		///
+		void prioritize(std::vector<std::shared_ptr<core::SessionWrapper>>& sessions, int64_t timestamp) const;
+
+		///
+		/// Reorders the given sessions for flushing at shutdown, the session holding most data is moved to the front.
+		///
+		/// Once OpenKit is shut down, no data is evicted anymore but the data of sessions not sent before the shutdown
+		/// timeout expires is lost, therefore the sessions are ordered by the number of bytes they hold regardless of
+		/// the policy.
+		/// @remarks Sessions holding the same number of bytes keep their relative order.
+		/// @param[in,out] sessions the sessions to send
+		///
+		void prioritizeByCachedData(std::vector<std::shared_ptr<core::SessionWrapper>>& sessions) const;
+
+		///
+		/// Returns the eviction risk of a session.
+		///
+		/// The risk is the age of the session's oldest record relative to the maximum record age, plus the number of bytes
+		/// the session holds relative to the upper memory boundary of the cache.
+		/// @param[in] session the session to rate
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns the eviction risk, @c 0 for a session without cached data
+		///
+		double getEvictionRisk(std::shared_ptr<core::SessionWrapper> session, int64_t timestamp) const;
+
+		///
+		/// Returns the send priority policy
+		/// @returns the policy
+		///
+		openkit::SendPriorityPolicy getPolicy() const;
+
+	private:
+		/// function rating a session, sessions with a higher rating are sent first
+		using SessionRating = std::function<double(const std::shared_ptr<core::SessionWrapper>&)>;
+
+		///
+		/// Sorts the given sessions by descending rating, sessions of equal rating keep their relative order.
+		/// @param[in,out] sessions the sessions to sort
+		/// @param[in] rating the function rating a session, called once per session
+		///
+		static void sortByRating(std::vector<std::shared_ptr<core::SessionWrapper>>& sessions, const SessionRating& rating);
+
+		/// the order in which sessions are sent
+		const openkit::SendPriorityPolicy mPolicy;
+
+		/// maximum age of a record in the beacon cache
+		const int64_t mMaxRecordAge;
+
+		/// upper memory boundary of the beacon cache
+		const int64_t mCacheSizeUpperBound;
+	};
+}
+
+#endif
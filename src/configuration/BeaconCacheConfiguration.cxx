@@ -25,11 +25,16 @@ using namespace configuration;
 const std::chrono::milliseconds BeaconCacheConfiguration::DEFAULT_MAX_RECORD_AGE_IN_MILLIS = std::chrono::minutes(105);	// 1hour and 45 minutes
 const int64_t BeaconCacheConfiguration::DEFAULT_UPPER_MEMORY_BOUNDARY_IN_BYTES = 100 * 1024 * 1024;			// 100 MiB
 const int64_t BeaconCacheConfiguration::DEFAULT_LOWER_MEMORY_BOUNDARY_IN_BYTES = 80 * 1024 * 1024;			// 80 MiB
+const int64_t BeaconCacheConfiguration::DEFAULT_SESSION_FLUSH_THRESHOLD_IN_BYTES = 64 * 1024;					// 64 KiB
 
-BeaconCacheConfiguration::BeaconCacheConfiguration(int64_t maxRecordAge, int64_t cacheSizeLowerBound, int64_t cacheSizeUpperBound)
+BeaconCacheConfiguration::BeaconCacheConfiguration(int64_t maxRecordAge, int64_t cacheSizeLowerBound, int64_t cacheSizeUpperBound, int64_t sessionFlushThreshold, int64_t ingestionDrainInterval,
+	int64_t maxIngestionBufferSizePerThread)
 	: mMaxRecordAge(maxRecordAge)
 	, mCacheSizeLowerBound(cacheSizeLowerBound)
 	, mCacheSizeUpperBound(cacheSizeUpperBound)
+	, mSessionFlushThreshold(sessionFlushThreshold)
+	, mIngestionDrainInterval(ingestionDrainInterval)
+	, mMaxIngestionBufferSizePerThread(maxIngestionBufferSizePerThread)
 {
 
 }
@@ -47,4 +52,19 @@ int64_t BeaconCacheConfiguration::getCacheSizeLowerBound() const
 int64_t BeaconCacheConfiguration::getCacheSizeUpperBound() const
 {
 	return mCacheSizeUpperBound;
-}
\ No newline at end of file
+}
+
+int64_t BeaconCacheConfiguration::getSessionFlushThreshold() const
+{
+	return mSessionFlushThreshold;
+}
+
+int64_t BeaconCacheConfiguration::getIngestionDrainInterval() const
+{
+	return mIngestionDrainInterval;
+}
+
+int64_t BeaconCacheConfiguration::getMaxIngestionBufferSizePerThread() const
+{
+	return mMaxIngestionBufferSizePerThread;
+}
@@ -33,8 +33,13 @@ namespace configuration
 		/// @param[in] maxRecordAge Maximum record age
 		/// @param[in] cacheSizeLowerBound lower memory limit for cache
 		/// @param[in] cacheSizeUpperBound upper memory limit for cache
+		/// @param[in] sessionFlushThreshold number of bytes cached for a single session which trigger sending it
+		/// @param[in] ingestionDrainInterval time between two batches of buffered data moved into the cache, non-positive to insert data directly
+		/// @param[in] maxIngestionBufferSizePerThread number of bytes a reporting thread buffers before it drains its buffer itself, non-positive for the default
 		///
-		BeaconCacheConfiguration(int64_t maxRecordAge, int64_t cacheSizeLowerBound, int64_t cacheSizeUpperBound);
+		BeaconCacheConfiguration(int64_t maxRecordAge, int64_t cacheSizeLowerBound, int64_t cacheSizeUpperBound,
+			int64_t sessionFlushThreshold = DEFAULT_SESSION_FLUSH_THRESHOLD_IN_BYTES, int64_t ingestionDrainInterval = 0,
+			int64_t maxIngestionBufferSizePerThread = 0);
 
 		///
 		/// Get maximum record age.
@@ -52,6 +57,24 @@ namespace configuration
 		///
 		int64_t getCacheSizeUpperBound() const;
 
+		///
+		/// Get the number of bytes cached for a single session which trigger sending it
+		/// before the send interval expired. A non-positive value disables this trigger.
+		///
+		int64_t getSessionFlushThreshold() const;
+
+		///
+		/// Get the time between two batches of buffered data moved into the cache in milliseconds.
+		/// A non-positive value declares that data is inserted into the cache on the reporting thread.
+		///
+		int64_t getIngestionDrainInterval() const;
+
+		///
+		/// Get the number of bytes a reporting thread buffers before it drains its buffer itself.
+		/// A non-positive value declares that the default is used.
+		///
+		int64_t getMaxIngestionBufferSizePerThread() const;
+
 	private:
 		/// maximum record age
 		int64_t mMaxRecordAge;
@@ -62,6 +85,15 @@ namespace configuration
 		/// upper memory limit for the cache
 		int64_t mCacheSizeUpperBound;
 
+		/// number of bytes cached for a single session which trigger sending it
+		int64_t mSessionFlushThreshold;
+
+		/// time between two batches of buffered data moved into the cache
+		int64_t mIngestionDrainInterval;
+
+		/// number of bytes a reporting thread buffers before it drains its buffer itself
+		int64_t mMaxIngestionBufferSizePerThread;
+
 	public:
 	
 		//default value for maximum record age
@@ -72,6 +104,9 @@ namespace configuration
 
 		//default value for lower memory boundary
 		static const int64_t DEFAULT_LOWER_MEMORY_BOUNDARY_IN_BYTES;
+
+		//default value for the number of cached bytes which trigger sending a session
+		static const int64_t DEFAULT_SESSION_FLUSH_THRESHOLD_IN_BYTES;
 	};
 }
 
@@ -27,16 +27,33 @@ constexpr int32_t DEFAULT_MAX_BEACON_SIZE = 30 * 1024;            // default: ma
 constexpr bool DEFAULT_CAPTURE_ERRORS = true;                     // default: capture errors on
 constexpr bool DEFAULT_CAPTURE_CRASHES = true;                    // default: capture crashes on
 
+constexpr uint32_t CAPTURE_FLAG = 1 << 0;
+constexpr uint32_t CAPTURE_ERRORS_FLAG = 1 << 1;
+constexpr uint32_t CAPTURE_CRASHES_FLAG = 1 << 2;
+constexpr uint32_t CAPTURE_KNOWN_FLAG = 1 << 3;
+
+static uint32_t toCaptureFlags(bool capture, bool captureErrors, bool captureCrashes)
+{
+	return (capture ? CAPTURE_FLAG : 0) | (captureErrors ? CAPTURE_ERRORS_FLAG : 0) | (captureCrashes ? CAPTURE_CRASHES_FLAG : 0) | CAPTURE_KNOWN_FLAG;
+}
+
+const int32_t Configuration::DEFAULT_BEACON_SENDING_CONCURRENCY = 1;   // default: send beacons on the beacon sending thread
+
 Configuration::Configuration(std::shared_ptr<configuration::Device> device, OpenKitType openKitType, const core::UTF8String& applicationName, const core::UTF8String& applicationVersion, const core::UTF8String& applicationID, int64_t deviceID, const core::UTF8String& origDeviceID, const core::UTF8String& endpointURL,
 	std::shared_ptr<providers::ISessionIDProvider> sessionIDProvider, std::shared_ptr<openkit::ISSLTrustManager> sslTrustManager,
-	std::shared_ptr<configuration::BeaconCacheConfiguration> beaconCacheConfiguration, std::shared_ptr<configuration::BeaconConfiguration> beaconConfiguration)
-	: mHTTPClientConfiguration(std::make_shared<configuration::HTTPClientConfiguration>(endpointURL, openKitType.getDefaultServerID(), applicationID, sslTrustManager))
+	std::shared_ptr<configuration::BeaconCacheConfiguration> beaconCacheConfiguration, std::shared_ptr<configuration::BeaconConfiguration> beaconConfiguration,
+	std::shared_ptr<configuration::RetryPolicy> retryPolicy, std::shared_ptr<openkit::ICompressor> compressor,
+	std::shared_ptr<protocol::UploadRateLimiter> uploadRateLimiter, int32_t beaconSendingConcurrency,
+	bool staggerOpenSessionSending, bool openSessionSendJitter, int64_t multiplicitySharingWindow,
+	std::shared_ptr<protocol::AdaptiveSendingController> adaptiveSendingController, openkit::SendPriorityPolicy sendPriorityPolicy,
+	std::shared_ptr<configuration::StoreAndForwardConfiguration> storeAndForwardConfiguration,
+	std::shared_ptr<protocol::EventSampler> eventSampler,
+	int64_t valueAggregationInterval)
+	: mHTTPClientConfiguration(std::make_shared<configuration::HTTPClientConfiguration>(endpointURL, openKitType.getDefaultServerID(), applicationID, sslTrustManager, retryPolicy, compressor, uploadRateLimiter))
 	, mSessionIDProvider(sessionIDProvider)
-	, mIsCapture(false)
+	, mCaptureFlags(toCaptureFlags(false, DEFAULT_CAPTURE_ERRORS, DEFAULT_CAPTURE_CRASHES) & ~CAPTURE_KNOWN_FLAG)
 	, mSendInterval(DEFAULT_SEND_INTERVAL)
 	, mMaxBeaconSize(DEFAULT_MAX_BEACON_SIZE)
-	, mCaptureErrors(DEFAULT_CAPTURE_ERRORS)
-	, mCaptureCrashes(DEFAULT_CAPTURE_CRASHES)
 	, mOpenKitType(openKitType)
 	, mApplicationName(applicationName)
 	, mApplicationID(applicationID)
@@ -48,12 +65,21 @@ Configuration::Configuration(std::shared_ptr<configuration::Device> device, Open
 	, mDevice(device)
 	, mBeaconCacheConfiguration(beaconCacheConfiguration)
 	, mBeaconConfiguration(beaconConfiguration)
+	, mBeaconSendingConcurrency(beaconSendingConcurrency)
+	, mStaggerOpenSessionSending(staggerOpenSessionSending)
+	, mOpenSessionSendJitter(openSessionSendJitter)
+	, mMultiplicitySharingWindow(multiplicitySharingWindow)
+	, mAdaptiveSendingController(adaptiveSendingController)
+	, mSendPriorityPolicy(sendPriorityPolicy)
+	, mStoreAndForwardConfiguration(storeAndForwardConfiguration)
+	, mEventSampler(eventSampler)
+	, mValueAggregationInterval(valueAggregationInterval)
 {
 }
 
 std::shared_ptr<HTTPClientConfiguration> Configuration::getHTTPClientConfiguration() const
 {
-	return mHTTPClientConfiguration;
+	return std::atomic_load(&mHTTPClientConfiguration);
 }
 
 void Configuration::updateSettings(std::shared_ptr<protocol::StatusResponse> statusResponse)
@@ -64,11 +90,10 @@ void Configuration::updateSettings(std::shared_ptr<protocol::StatusResponse> sta
 		return;
 	}
 
-	mIsCapture = statusResponse->isCapture();
-
 	//if capture is off -> leave other settings on their current values
 	if (!statusResponse->isCapture())
 	{
+		disableCapture();
 		return;
 	}
 
@@ -79,13 +104,18 @@ void Configuration::updateSettings(std::shared_ptr<protocol::StatusResponse> sta
 		newServerID = mOpenKitType.getDefaultServerID();
 	}
 
-	//check if HTTP configuration changed
-	if (mHTTPClientConfiguration->getServerID() != newServerID)
+	//check if HTTP configuration changed, the configuration is immutable and replaced as a whole
+	auto httpClientConfiguration = getHTTPClientConfiguration();
+	if (httpClientConfiguration->getServerID() != newServerID)
 	{
-		mHTTPClientConfiguration = std::make_shared<configuration::HTTPClientConfiguration>(mEndpointURL,
+		std::atomic_store(&mHTTPClientConfiguration, std::make_shared<configuration::HTTPClientConfiguration>(mEndpointURL,
 																							newServerID,
 																							mApplicationID,
-																							mHTTPClientConfiguration->getSSLTrustManager());
+																							httpClientConfiguration->getSSLTrustManager(),
+																							httpClientConfiguration->getRetryPolicy(),
+																							httpClientConfiguration->getCompressor(),
+																							httpClientConfiguration->getUploadRateLimiter(),
+																							httpClientConfiguration->getTransferDeadline()));
 	}
 
 	// use send interval from beacon response or default
@@ -94,10 +124,7 @@ void Configuration::updateSettings(std::shared_ptr<protocol::StatusResponse> sta
 	{
 		newSendInterval = DEFAULT_SEND_INTERVAL;
 	}
-	if (newSendInterval != mSendInterval)
-	{
-		mSendInterval = newSendInterval;
-	}
+	mSendInterval.store(newSendInterval, std::memory_order_relaxed);
 
 	// use max beacon size from beacon response or default
 	auto newMaxBeaconSize = statusResponse->getMaxBeaconSize();
@@ -105,29 +132,32 @@ void Configuration::updateSettings(std::shared_ptr<protocol::StatusResponse> sta
 	{
 		newMaxBeaconSize = DEFAULT_MAX_BEACON_SIZE;
 	}
-	if (newMaxBeaconSize != mMaxBeaconSize)
-	{
-		mMaxBeaconSize = newMaxBeaconSize;
-	}
+	mMaxBeaconSize.store(newMaxBeaconSize, std::memory_order_relaxed);
 
-	// use capture settings for errors and crashes
-	mCaptureErrors = statusResponse->isCaptureErrors();
-	mCaptureCrashes = statusResponse->isCaptureCrashes();
+	// turn capturing on together with the capture settings for errors and crashes
+	mCaptureFlags.store(toCaptureFlags(true, statusResponse->isCaptureErrors(), statusResponse->isCaptureCrashes()), std::memory_order_relaxed);
 }
 
 void Configuration::enableCapture()
 {
-	mIsCapture = true;
+	mCaptureFlags.fetch_or(CAPTURE_FLAG | CAPTURE_KNOWN_FLAG, std::memory_order_relaxed);
 }
 
 void Configuration::disableCapture()
 {
-	mIsCapture = false;
+	// clear the capture flag before marking it as known, so capturing never appears to be turned off while it is on
+	mCaptureFlags.fetch_and(~CAPTURE_FLAG, std::memory_order_relaxed);
+	mCaptureFlags.fetch_or(CAPTURE_KNOWN_FLAG, std::memory_order_relaxed);
 }
 
 bool Configuration::isCapture() const
 {
-	return mIsCapture;
+	return (mCaptureFlags.load(std::memory_order_relaxed) & CAPTURE_FLAG) != 0;
+}
+
+bool Configuration::isCaptureTurnedOff() const
+{
+	return (mCaptureFlags.load(std::memory_order_relaxed) & (CAPTURE_FLAG | CAPTURE_KNOWN_FLAG)) == CAPTURE_KNOWN_FLAG;
 }
 
 int32_t Configuration::createSessionNumber()
@@ -184,27 +214,27 @@ const core::UTF8String& Configuration::getOrigDeviceID() const
 
 int64_t Configuration::getSendInterval() const
 {
-	return mSendInterval;
+	return mSendInterval.load(std::memory_order_relaxed);
 }
 
 void Configuration::setSendInterval(int64_t sendInterval)
 {
-	mSendInterval = sendInterval;
+	mSendInterval.store(sendInterval, std::memory_order_relaxed);
 }
 
 int32_t Configuration::getMaxBeaconSize() const
 {
-	return mMaxBeaconSize;
+	return mMaxBeaconSize.load(std::memory_order_relaxed);
 }
 
 bool Configuration::isCaptureErrors() const
 {
-	return mCaptureErrors;
+	return (mCaptureFlags.load(std::memory_order_relaxed) & CAPTURE_ERRORS_FLAG) != 0;
 }
 
 bool Configuration::isCaptureCrashes() const
 {
-	return mCaptureCrashes;
+	return (mCaptureFlags.load(std::memory_order_relaxed) & CAPTURE_CRASHES_FLAG) != 0;
 }
 
 std::shared_ptr<configuration::Device> Configuration::getDevice() const
@@ -220,4 +250,53 @@ std::shared_ptr<configuration::BeaconCacheConfiguration> Configuration::getBeaco
 std::shared_ptr<configuration::BeaconConfiguration> Configuration::getBeaconConfiguration() const
 {
 	return mBeaconConfiguration;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<configuration::RetryPolicy> Configuration::getRetryPolicy() const
+{
+	return getHTTPClientConfiguration()->getRetryPolicy();
+}
+int32_t Configuration::getBeaconSendingConcurrency() const
+{
+	return mBeaconSendingConcurrency;
+}
+
+bool Configuration::isOpenSessionSendStaggered() const
+{
+	return mStaggerOpenSessionSending;
+}
+
+bool Configuration::isOpenSessionSendJitterEnabled() const
+{
+	return mOpenSessionSendJitter;
+}
+
+int64_t Configuration::getMultiplicitySharingWindow() const
+{
+	return mMultiplicitySharingWindow;
+}
+
+std::shared_ptr<protocol::AdaptiveSendingController> Configuration::getAdaptiveSendingController() const
+{
+	return mAdaptiveSendingController;
+}
+
+openkit::SendPriorityPolicy Configuration::getSendPriorityPolicy() const
+{
+	return mSendPriorityPolicy;
+}
+
+std::shared_ptr<configuration::StoreAndForwardConfiguration> Configuration::getStoreAndForwardConfiguration() const
+{
+	return mStoreAndForwardConfiguration;
+}
+
+std::shared_ptr<protocol::EventSampler> Configuration::getEventSampler() const
+{
+	return mEventSampler;
+}
+
+int64_t Configuration::getValueAggregationInterval() const
+{
+	return mValueAggregationInterval;
+}
@@ -24,9 +24,15 @@
 #include "protocol/StatusResponse.h"
 #include "configuration/BeaconCacheConfiguration.h"
 #include "configuration/BeaconConfiguration.h"
+#include "configuration/RetryPolicy.h"
+#include "configuration/StoreAndForwardConfiguration.h"
+#include "protocol/AdaptiveSendingController.h"
+#include "protocol/EventSampler.h"
+#include "OpenKit/SendPriorityPolicy.h"
 
 #include <memory>
 #include <atomic>
+#include <cstdint>
 
 namespace configuration
 {
@@ -49,10 +55,30 @@ namespace configuration
 		/// @param[in] sslTrustManager the openkit::ISSLTrustManager instance to use
 		/// @param[in] beaconCacheConfiguration beacon cache configuration
 		/// @param[in] beaconConfiguration beacon configuration
+		/// @param[in] retryPolicy timeouts and retry settings for requests, defaults are used if @c nullptr
+		/// @param[in] compressor compressor for beacon data, gzip with default level is used if @c nullptr
+		/// @param[in] uploadRateLimiter rate limiter for uploads, uploads are not limited if @c nullptr
+		/// @param[in] beaconSendingConcurrency number of threads sending beacons of different sessions in parallel
+		/// @param[in] staggerOpenSessionSending @c true to spread the beacons of open sessions across the send interval
+		/// @param[in] openSessionSendJitter @c true to randomize the send time of each open session within its slot
+		/// @param[in] multiplicitySharingWindow time in milliseconds a new session response is applied to further new sessions, @c 0 to disable
+		/// @param[in] adaptiveSendingController controller adapting send interval and beacon size, the server's values are used if @c nullptr
+		/// @param[in] sendPriorityPolicy order in which the sessions of a send pass are sent
+		/// @param[in] storeAndForwardConfiguration configuration for storing data on disk during backoff, data is dropped if @c nullptr
+		/// @param[in] eventSampler client side sampling of reported data, all data is kept if @c nullptr
+		/// @param[in] valueAggregationInterval flush interval in milliseconds of aggregated values, @c 0 to flush only when the action is left, negative to disable aggregation
 		///
 		Configuration(std::shared_ptr<configuration::Device> device, OpenKitType openKitType, const core::UTF8String& applicationName, const core::UTF8String& applicationVersion, const core::UTF8String& applicationID, int64_t deviceID, const core::UTF8String& origDeviceID, const core::UTF8String& endpointURL,
 			std::shared_ptr<providers::ISessionIDProvider> sessionIDProvider, std::shared_ptr<openkit::ISSLTrustManager> sslTrustManager,
-			std::shared_ptr<configuration::BeaconCacheConfiguration> beaconCacheConfiguration, std::shared_ptr<configuration::BeaconConfiguration> beaconConfiguration);
+			std::shared_ptr<configuration::BeaconCacheConfiguration> beaconCacheConfiguration, std::shared_ptr<configuration::BeaconConfiguration> beaconConfiguration,
+			std::shared_ptr<configuration::RetryPolicy> retryPolicy = nullptr, std::shared_ptr<openkit::ICompressor> compressor = nullptr,
+			std::shared_ptr<protocol::UploadRateLimiter> uploadRateLimiter = nullptr, int32_t beaconSendingConcurrency = DEFAULT_BEACON_SENDING_CONCURRENCY,
+			bool staggerOpenSessionSending = false, bool openSessionSendJitter = false, int64_t multiplicitySharingWindow = 0,
+			std::shared_ptr<protocol::AdaptiveSendingController> adaptiveSendingController = nullptr,
+			openkit::SendPriorityPolicy sendPriorityPolicy = openkit::SendPriorityPolicy::INSERTION_ORDER,
+			std::shared_ptr<configuration::StoreAndForwardConfiguration> storeAndForwardConfiguration = nullptr,
+			std::shared_ptr<protocol::EventSampler> eventSampler = nullptr,
+			int64_t valueAggregationInterval = -1);
 
 		virtual ~Configuration() {}
 
@@ -84,6 +110,16 @@ namespace configuration
 		///
 		bool isCapture() const;
 
+		///
+		/// Returns a flag if capturing is known to be turned off
+		///
+		/// Capturing is off until the first status response was handled, but data reported until then is still recorded
+		/// and only discarded if the server turns capturing off.
+		/// @returns @c true if capturing was disabled or turned off by the server, @c false if capturing is enabled
+		///          or not yet known
+		///
+		bool isCaptureTurnedOff() const;
+
 		///
 		/// Return next session number
 		/// @returns session number
@@ -186,6 +222,70 @@ namespace configuration
 		///
 		std::shared_ptr<configuration::BeaconConfiguration> getBeaconConfiguration() const;
 
+		///
+		/// Return the retry policy
+		/// @returns the timeouts and retry settings for requests
+		///
+		std::shared_ptr<configuration::RetryPolicy> getRetryPolicy() const;
+
+		///
+		/// Return the number of threads sending beacons of different sessions in parallel
+		/// @returns the beacon sending concurrency, @c 1 if beacons are sent by the beacon sending thread itself
+		///
+		int32_t getBeaconSendingConcurrency() const;
+
+		///
+		/// Return whether the beacons of open sessions are spread across the send interval
+		/// @returns @c true if open sessions are sent staggered, @c false if they are sent all at once
+		///
+		bool isOpenSessionSendStaggered() const;
+
+		///
+		/// Return whether the send time of each open session is randomized within its slot
+		/// @returns @c true if jitter is applied to staggered open session sends
+		///
+		bool isOpenSessionSendJitterEnabled() const;
+
+		///
+		/// Return the time a successful new session response is applied to further new sessions instead of sending requests for them
+		/// @returns the multiplicity sharing window in milliseconds, @c 0 if each session sends its own new session request
+		///
+		int64_t getMultiplicitySharingWindow() const;
+
+		///
+		/// Return the controller adapting the send interval and the beacon size to cache and collector load
+		/// @returns the adaptive sending controller or @c nullptr if the server's values are applied as they are
+		///
+		std::shared_ptr<protocol::AdaptiveSendingController> getAdaptiveSendingController() const;
+
+		///
+		/// Return the order in which the sessions of a send pass are sent
+		/// @returns the send priority policy
+		///
+		openkit::SendPriorityPolicy getSendPriorityPolicy() const;
+
+		///
+		/// Return the configuration for storing data on disk while the server does not accept it
+		/// @returns the store-and-forward configuration or @c nullptr if data is dropped instead
+		///
+		std::shared_ptr<configuration::StoreAndForwardConfiguration> getStoreAndForwardConfiguration() const;
+
+		///
+		/// Return the client side sampling of reported data
+		/// @returns the event sampler or @c nullptr if all data is kept
+		///
+		std::shared_ptr<protocol::EventSampler> getEventSampler() const;
+
+		///
+		/// Return the flush interval of aggregated numeric values
+		/// @returns the interval in milliseconds, @c 0 if aggregates are only flushed when the action is left,
+		///          or a negative value if values are not aggregated
+		///
+		int64_t getValueAggregationInterval() const;
+
+		/// default number of threads sending beacons
+		static const int32_t DEFAULT_BEACON_SENDING_CONCURRENCY;
+
 	private:
 		/// HTTP client configuration
 		std::shared_ptr<HTTPClientConfiguration> mHTTPClientConfiguration;
@@ -193,20 +293,14 @@ namespace configuration
 		/// session ID provider
 		std::shared_ptr<providers::ISessionIDProvider> mSessionIDProvider;
 
-		/// flag if capturing is enabled
-		std::atomic<bool> mIsCapture;
+		/// flags if capturing, capturing errors and capturing crashes is enabled and if capturing is known, packed to be read with a single load
+		std::atomic<uint32_t> mCaptureFlags;
 
 		/// the send interval
-		int64_t mSendInterval;
+		std::atomic<int64_t> mSendInterval;
 
 		/// maximum beacon size
-		int32_t mMaxBeaconSize;
-
-		/// flag if to capture errors
-		bool mCaptureErrors;
-
-		/// flag if to capture crashes
-		bool mCaptureCrashes;
+		std::atomic<int32_t> mMaxBeaconSize;
 
 		/// OpenKit type
 		OpenKitType mOpenKitType;
@@ -240,6 +334,33 @@ namespace configuration
 
 		/// configuration options for @ref protocol::Beacon
 		std::shared_ptr<configuration::BeaconConfiguration> mBeaconConfiguration;
+
+		/// number of threads sending beacons
+		int32_t mBeaconSendingConcurrency;
+
+		/// spread the beacons of open sessions across the send interval
+		bool mStaggerOpenSessionSending;
+
+		/// randomize the send time of open sessions within their slot
+		bool mOpenSessionSendJitter;
+
+		/// time a new session response is shared with further new sessions
+		int64_t mMultiplicitySharingWindow;
+
+		/// controller adapting send interval and beacon size
+		std::shared_ptr<protocol::AdaptiveSendingController> mAdaptiveSendingController;
+
+		/// order in which the sessions of a send pass are sent
+		openkit::SendPriorityPolicy mSendPriorityPolicy;
+
+		/// configuration for storing data on disk during backoff
+		std::shared_ptr<configuration::StoreAndForwardConfiguration> mStoreAndForwardConfiguration;
+
+		/// client side sampling of reported data
+		std::shared_ptr<protocol::EventSampler> mEventSampler;
+
+		/// flush interval of aggregated numeric values
+		int64_t mValueAggregationInterval;
 	};
 }
 
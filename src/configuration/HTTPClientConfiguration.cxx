@@ -15,15 +15,44 @@
 */
 
 #include "HTTPClientConfiguration.h"
+#include "core/util/Compressor.h"
+#include "core/util/GzipCompressor.h"
 
 using namespace configuration;
 
-HTTPClientConfiguration::HTTPClientConfiguration(const core::UTF8String& url, uint32_t serverID, const core::UTF8String& applicationID, std::shared_ptr<openkit::ISSLTrustManager> sslTrustManager)
+HTTPClientConfiguration::HTTPClientConfiguration(const core::UTF8String& url, uint32_t serverID, const core::UTF8String& applicationID, std::shared_ptr<openkit::ISSLTrustManager> sslTrustManager,
+	std::shared_ptr<RetryPolicy> retryPolicy, std::shared_ptr<openkit::ICompressor> compressor,
+	std::shared_ptr<protocol::UploadRateLimiter> uploadRateLimiter, std::shared_ptr<protocol::TransferDeadline> transferDeadline)
 	: mBaseURL(url)
 	, mServerID(serverID)
 	, mApplicationID(applicationID)
 	, mSSLTrustManager(sslTrustManager)
+	, mRetryPolicy(retryPolicy)
+	, mCompressor(compressor)
+	, mUploadRateLimiter(uploadRateLimiter)
+	, mTransferDeadline(transferDeadline)
 {
+	if (mRetryPolicy == nullptr)
+	{
+		mRetryPolicy = std::make_shared<RetryPolicy>(RetryPolicy::DEFAULT_CONNECT_TIMEOUT.count(),
+			RetryPolicy::DEFAULT_READ_TIMEOUT.count(),
+			RetryPolicy::DEFAULT_MAX_RETRY_ATTEMPTS,
+			RetryPolicy::DEFAULT_INITIAL_RETRY_DELAY.count(),
+			RetryPolicy::DEFAULT_MAX_RETRY_DELAY.count());
+	}
+	if (mCompressor == nullptr)
+	{
+		mCompressor = std::make_shared<core::util::GzipCompressor>(base::util::Compressor::DEFAULT_COMPRESSION_LEVEL);
+	}
+	if (mUploadRateLimiter == nullptr)
+	{
+		mUploadRateLimiter = std::make_shared<protocol::UploadRateLimiter>(nullptr, protocol::UploadRateLimiter::DEFAULT_BYTES_PER_SECOND,
+			protocol::UploadRateLimiter::DEFAULT_BURST_SIZE);
+	}
+	if (mTransferDeadline == nullptr)
+	{
+		mTransferDeadline = std::make_shared<protocol::TransferDeadline>();
+	}
 }
 
 const core::UTF8String& HTTPClientConfiguration::getBaseURL() const
@@ -46,3 +75,22 @@ std::shared_ptr<openkit::ISSLTrustManager> HTTPClientConfiguration::getSSLTrustM
 	return mSSLTrustManager;
 }
 
+std::shared_ptr<RetryPolicy> HTTPClientConfiguration::getRetryPolicy() const
+{
+	return mRetryPolicy;
+}
+
+std::shared_ptr<openkit::ICompressor> HTTPClientConfiguration::getCompressor() const
+{
+	return mCompressor;
+}
+
+std::shared_ptr<protocol::UploadRateLimiter> HTTPClientConfiguration::getUploadRateLimiter() const
+{
+	return mUploadRateLimiter;
+}
+
+std::shared_ptr<protocol::TransferDeadline> HTTPClientConfiguration::getTransferDeadline() const
+{
+	return mTransferDeadline;
+}
\ No newline at end of file
@@ -18,11 +18,15 @@
 #define _CONFIGURATION_HTTPCLIENTCONFIGURATION_H
 
 #include "OpenKit/ISSLTrustManager.h"
+#include "OpenKit/ICompressor.h"
 
 #include <memory>
 
 #include "core/UTF8String.h"
+#include "configuration/RetryPolicy.h"
 #include "protocol/ssl/SSLBlindTrustManager.h"
+#include "protocol/TransferDeadline.h"
+#include "protocol/UploadRateLimiter.h"
 
 namespace configuration
 {
@@ -38,8 +42,14 @@ namespace configuration
 		/// @param[in] serverID server id
 		/// @param[in] applicationID the application id
 		/// @param[in] sslTrustManager optional
+		/// @param[in] retryPolicy optional timeouts and retry settings, defaults are used if @c nullptr
+		/// @param[in] compressor optional compressor for beacon data, gzip with default level is used if @c nullptr
+		/// @param[in] uploadRateLimiter optional rate limiter for uploads, uploads are not limited if @c nullptr
+		/// @param[in] transferDeadline optional deadline shared by all requests, a deadline which is never set is used if @c nullptr
 		///
-		HTTPClientConfiguration(const core::UTF8String& url, uint32_t serverID, const core::UTF8String& applicationID, std::shared_ptr<openkit::ISSLTrustManager> sslTrustManager = nullptr);
+		HTTPClientConfiguration(const core::UTF8String& url, uint32_t serverID, const core::UTF8String& applicationID, std::shared_ptr<openkit::ISSLTrustManager> sslTrustManager = nullptr,
+			std::shared_ptr<RetryPolicy> retryPolicy = nullptr, std::shared_ptr<openkit::ICompressor> compressor = nullptr,
+			std::shared_ptr<protocol::UploadRateLimiter> uploadRateLimiter = nullptr, std::shared_ptr<protocol::TransferDeadline> transferDeadline = nullptr);
 
 		///
 		/// Returns the base url for the http client
@@ -65,6 +75,30 @@ namespace configuration
 		///
 		std::shared_ptr<openkit::ISSLTrustManager> getSSLTrustManager() const;
 
+		///
+		/// Returns the retry policy defining timeouts and retries of requests
+		/// @returns the retry policy
+		///
+		std::shared_ptr<RetryPolicy> getRetryPolicy() const;
+
+		///
+		/// Returns the compressor used for beacon data
+		/// @returns the compressor
+		///
+		std::shared_ptr<openkit::ICompressor> getCompressor() const;
+
+		///
+		/// Returns the rate limiter shared by all uploads
+		/// @returns the upload rate limiter
+		///
+		std::shared_ptr<protocol::UploadRateLimiter> getUploadRateLimiter() const;
+
+		///
+		/// Returns the deadline after which requests are aborted
+		/// @returns the transfer deadline
+		///
+		std::shared_ptr<protocol::TransferDeadline> getTransferDeadline() const;
+
 	private:
 		/// the beacon URL
 		const core::UTF8String mBaseURL;
@@ -77,6 +111,18 @@ namespace configuration
 
 		/// how the peer's TSL/SSL certificate and the hostname shall be trusted
 		std::shared_ptr<openkit::ISSLTrustManager> mSSLTrustManager;
+
+		/// timeouts and retry settings
+		std::shared_ptr<RetryPolicy> mRetryPolicy;
+
+		/// compression of beacon data
+		std::shared_ptr<openkit::ICompressor> mCompressor;
+
+		/// rate limiting of uploads
+		std::shared_ptr<protocol::UploadRateLimiter> mUploadRateLimiter;
+
+		/// deadline for requests at shutdown
+		std::shared_ptr<protocol::TransferDeadline> mTransferDeadline;
 	};
 
 }
@@ -0,0 +1,63 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "configuration/RetryPolicy.h"
+
+using namespace configuration;
+
+///
+/// The default @ref RetryPolicy when user does not override it.
+/// Failed requests are retried without limit, starting with one second and backing off up to two minutes.
+///
+const std::chrono::milliseconds RetryPolicy::DEFAULT_CONNECT_TIMEOUT = std::chrono::seconds(5);
+const std::chrono::milliseconds RetryPolicy::DEFAULT_READ_TIMEOUT = std::chrono::seconds(30);
+const int32_t RetryPolicy::DEFAULT_MAX_RETRY_ATTEMPTS = -1;
+const std::chrono::milliseconds RetryPolicy::DEFAULT_INITIAL_RETRY_DELAY = std::chrono::seconds(1);
+const std::chrono::milliseconds RetryPolicy::DEFAULT_MAX_RETRY_DELAY = std::chrono::minutes(2);
+
+RetryPolicy::RetryPolicy(int64_t connectTimeout, int64_t readTimeout, int32_t maxRetryAttempts, int64_t initialRetryDelay, int64_t maxRetryDelay)
+	: mConnectTimeout(connectTimeout)
+	, mReadTimeout(readTimeout)
+	, mMaxRetryAttempts(maxRetryAttempts)
+	, mInitialRetryDelay(initialRetryDelay)
+	, mMaxRetryDelay(maxRetryDelay)
+{
+}
+
+int64_t RetryPolicy::getConnectTimeout() const
+{
+	return mConnectTimeout;
+}
+
+int64_t RetryPolicy::getReadTimeout() const
+{
+	return mReadTimeout;
+}
+
+int32_t RetryPolicy::getMaxRetryAttempts() const
+{
+	return mMaxRetryAttempts;
+}
+
+int64_t RetryPolicy::getInitialRetryDelay() const
+{
+	return mInitialRetryDelay;
+}
+
+int64_t RetryPolicy::getMaxRetryDelay() const
+{
+	return mMaxRetryDelay;
+}
@@ -0,0 +1,101 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _CONFIGURATION_RETRYPOLICY_H
+#define _CONFIGURATION_RETRYPOLICY_H
+
+#include <cstdint>
+#include <chrono>
+
+namespace configuration
+{
+	///
+	/// Configuration for timeouts and retries of requests sent to the server.
+	///
+	class RetryPolicy
+	{
+	public:
+		///
+		/// Constructor
+		/// @param[in] connectTimeout timeout for establishing a connection in milliseconds
+		/// @param[in] readTimeout timeout for the whole request in milliseconds
+		/// @param[in] maxRetryAttempts maximum number of retries for a failed request, or unbounded if negative
+		/// @param[in] initialRetryDelay delay in milliseconds before the first retry
+		/// @param[in] maxRetryDelay upper bound in milliseconds for the exponentially growing retry delay
+		///
+		RetryPolicy(int64_t connectTimeout, int64_t readTimeout, int32_t maxRetryAttempts, int64_t initialRetryDelay, int64_t maxRetryDelay);
+
+		///
+		/// Get the connect timeout in milliseconds.
+		///
+		int64_t getConnectTimeout() const;
+
+		///
+		/// Get the read timeout in milliseconds.
+		///
+		int64_t getReadTimeout() const;
+
+		///
+		/// Get the maximum number of retries, negative values declare that there are no bounds.
+		///
+		int32_t getMaxRetryAttempts() const;
+
+		///
+		/// Get the delay before the first retry in milliseconds.
+		///
+		int64_t getInitialRetryDelay() const;
+
+		///
+		/// Get the upper bound of the retry delay in milliseconds.
+		///
+		int64_t getMaxRetryDelay() const;
+
+	private:
+		/// connect timeout
+		int64_t mConnectTimeout;
+
+		/// read timeout
+		int64_t mReadTimeout;
+
+		/// maximum number of retries
+		int32_t mMaxRetryAttempts;
+
+		/// delay before the first retry
+		int64_t mInitialRetryDelay;
+
+		/// upper bound of the retry delay
+		int64_t mMaxRetryDelay;
+
+	public:
+
+		//default value for the connect timeout
+		static const std::chrono::milliseconds DEFAULT_CONNECT_TIMEOUT;
+
+		//default value for the read timeout
+		static const std::chrono::milliseconds DEFAULT_READ_TIMEOUT;
+
+		//default value for the maximum number of retries
+		static const int32_t DEFAULT_MAX_RETRY_ATTEMPTS;
+
+		//default value for the delay before the first retry
+		static const std::chrono::milliseconds DEFAULT_INITIAL_RETRY_DELAY;
+
+		//default value for the upper bound of the retry delay
+		static const std::chrono::milliseconds DEFAULT_MAX_RETRY_DELAY;
+	};
+}
+
+#endif
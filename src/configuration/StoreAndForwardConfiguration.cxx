@@ -0,0 +1,47 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "configuration/StoreAndForwardConfiguration.h"
+
+using namespace configuration;
+
+StoreAndForwardConfiguration::StoreAndForwardConfiguration(const std::string& directory, int64_t maxStoreSize, int64_t maxChunkAge, int64_t replayBytesPerSecond)
+	: mDirectory(directory)
+	, mMaxStoreSize(maxStoreSize)
+	, mMaxChunkAge(maxChunkAge)
+	, mReplayBytesPerSecond(replayBytesPerSecond)
+{
+}
+
+const std::string& StoreAndForwardConfiguration::getDirectory() const
+{
+	return mDirectory;
+}
+
+int64_t StoreAndForwardConfiguration::getMaxStoreSize() const
+{
+	return mMaxStoreSize;
+}
+
+int64_t StoreAndForwardConfiguration::getMaxChunkAge() const
+{
+	return mMaxChunkAge;
+}
+
+int64_t StoreAndForwardConfiguration::getReplayBytesPerSecond() const
+{
+	return mReplayBytesPerSecond;
+}
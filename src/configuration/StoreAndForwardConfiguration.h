@@ -0,0 +1,75 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _CONFIGURATION_STOREANDFORWARDCONFIGURATION_H
+#define _CONFIGURATION_STOREANDFORWARDCONFIGURATION_H
+
+#include <cstdint>
+#include <string>
+
+namespace configuration
+{
+	///
+	/// Configuration for storing beacon data on disk while the server does not accept it.
+	///
+	class StoreAndForwardConfiguration
+	{
+	public:
+		///
+		/// Constructor
+		/// @param[in] directory directory the chunks are stored in
+		/// @param[in] maxStoreSize maximum number of bytes stored on disk
+		/// @param[in] maxChunkAge maximum age of a stored chunk in milliseconds, unbounded if not positive
+		/// @param[in] replayBytesPerSecond rate stored chunks are sent with, unlimited if not positive
+		///
+		StoreAndForwardConfiguration(const std::string& directory, int64_t maxStoreSize, int64_t maxChunkAge, int64_t replayBytesPerSecond);
+
+		///
+		/// Get the directory the chunks are stored in.
+		///
+		const std::string& getDirectory() const;
+
+		///
+		/// Get the maximum number of bytes stored on disk.
+		///
+		int64_t getMaxStoreSize() const;
+
+		///
+		/// Get the maximum age of a stored chunk in milliseconds.
+		///
+		int64_t getMaxChunkAge() const;
+
+		///
+		/// Get the number of bytes per second stored chunks are sent with, non-positive values declare no limit.
+		///
+		int64_t getReplayBytesPerSecond() const;
+
+	private:
+		/// directory the chunks are stored in
+		std::string mDirectory;
+
+		/// maximum number of bytes stored on disk
+		int64_t mMaxStoreSize;
+
+		/// maximum age of a stored chunk
+		int64_t mMaxChunkAge;
+
+		/// rate stored chunks are sent with
+		int64_t mReplayBytesPerSecond;
+	};
+}
+
+#endif
@@ -36,6 +36,7 @@ Action::Action(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protoco
 Action::Action(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, const UTF8String& name, std::shared_ptr<RootAction> parentAction)
 	: mLogger(logger)
 	, mParentAction(parentAction)
+	, mParentActionID(parentAction != nullptr ? parentAction->getID() : -1)
 	, mEndTime(-1)
 	, mBeacon(beacon)
 	, mID(mBeacon->createID())
@@ -43,7 +44,8 @@ Action::Action(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protoco
 	, mStartTime(mBeacon->getCurrentTimestamp())
 	, mStartSequenceNumber(mBeacon->createSequenceNumber())
 	, mEndSequenceNumber(-1)
-	, mActionImpl(logger, beacon, mID, toString())
+	, mActionImpl(logger, beacon, mID, [this]() { return toString(); }, parentAction != nullptr ? parentAction->getObjectArena() : nullptr)
+	, mOpenActionHook()
 {
 
 }
@@ -84,6 +86,15 @@ std::shared_ptr<openkit::IAction> Action::reportValue(const char* valueName, con
 	return shared_from_this();
 }
 
+std::shared_ptr<openkit::IAction> Action::reportValues(const openkit::ReportedValue* values, size_t numValues)
+{
+	if (!isActionLeft())
+	{
+		mActionImpl.reportValues(values, numValues);
+	}
+	return shared_from_this();
+}
+
 std::shared_ptr<openkit::IAction> Action::reportError(const char* errorName, int32_t errorCode, const char* reason)
 {
 	if (!isActionLeft())
@@ -119,7 +130,7 @@ std::shared_ptr<openkit::IRootAction> Action::leaveAction()
 
 std::shared_ptr<openkit::IRootAction> Action::doLeaveAction()
 {
-	mEndTime = mBeacon->getCurrentTimestamp();
+	// the end time was taken when the action was marked as left
 	mEndSequenceNumber = mBeacon->createSequenceNumber();
 
 	// add Action to Beacon
@@ -178,9 +189,14 @@ bool Action::isActionLeft() const
 	return mEndTime != -1;
 }
 
+util::OpenActionSet<Action>::Hook& Action::getOpenActionHook()
+{
+	return mOpenActionHook;
+}
+
 const std::string Action::toString() const
 {
 	std::stringstream ss;
-	ss << "Action [sn=" << mBeacon->getSessionNumber() << ", id=" << mID << ", name=" << mName.getStringData() << ", pa=" << (mParentAction != nullptr ? std::to_string(mParentAction->getID()) : "no parent") << "]";
+	ss << "Action [sn=" << mBeacon->getSessionNumber() << ", id=" << mID << ", name=" << mName.getStringData() << ", pa=" << (mParentActionID != -1 ? std::to_string(mParentActionID) : "no parent") << "]";
 	return ss.str();
 }
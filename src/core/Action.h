@@ -24,7 +24,7 @@
 
 #include "OpenKit/IAction.h"
 #include "OpenKit/ILogger.h"
-#include "core/util/SynchronizedQueue.h"
+#include "core/util/OpenActionSet.h"
 #include "core/UTF8String.h"
 #include "core/NullWebRequestTracer.h"
 #include "core/ActionCommonImpl.h"
@@ -80,6 +80,8 @@ namespace core
 
 		std::shared_ptr<IAction> reportValue(const char* valueName, const char* value) override;
 
+		std::shared_ptr<IAction> reportValues(const openkit::ReportedValue* values, size_t numValues) override;
+
 		std::shared_ptr<IAction> reportError(const char* errorName, int32_t errorCode, const char* reason) override;
 
 		std::shared_ptr<openkit::IWebRequestTracer> traceWebRequest(const char* url) override;
@@ -134,6 +136,12 @@ namespace core
 		///
 		bool isActionLeft() const;
 
+		///
+		/// Returns the position of this action within the open child actions of its parent
+		/// @returns the hook linking this action into its parent's open child actions
+		///
+		util::OpenActionSet<Action>::Hook& getOpenActionHook();
+
 	private:
 		///
 		/// Leaves this Action.
@@ -155,6 +163,9 @@ namespace core
 		/// parent action
 		std::shared_ptr<RootAction> mParentAction;
 
+		/// ID of the parent action, kept after leaving for logging
+		const int32_t mParentActionID;
+
 		/// action end time
 		std::atomic<int64_t> mEndTime;
 
@@ -178,6 +189,9 @@ namespace core
 
 		/// Impl object with the actual implementations for Action/RootAction
 		ActionCommonImpl mActionImpl;
+
+		/// position of this action within the open child actions of its parent
+		util::OpenActionSet<Action>::Hook mOpenActionHook;
 	};
 }
 
@@ -21,26 +21,33 @@
 
 using namespace core;
 
-std::shared_ptr<NullWebRequestTracer> ActionCommonImpl::NULL_WEB_REQUEST_TRACER(std::make_shared<NullWebRequestTracer>());
+std::shared_ptr<NullWebRequestTracer> ActionCommonImpl::NULL_WEB_REQUEST_TRACER(NullWebRequestTracer::getInstance());
 
-ActionCommonImpl::ActionCommonImpl(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t actionID, const std::string& objectID)
+ActionCommonImpl::ActionCommonImpl(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t actionID,
+	std::function<const std::string()> objectID, std::shared_ptr<util::ObjectArena> objectArena)
 	: mLogger(logger)
 	, mBeacon(beacon)
 	, mActionID(actionID)
 	, mObjectID(objectID)
+	, mObjectArena(objectArena)
 {}
 
 void ActionCommonImpl::reportEvent(const char* eventName)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return;
+	}
+
 	UTF8String eventNameString(eventName);
 	if (eventNameString.empty())
 	{
-		mLogger->warning("%s reportEvent: eventName must not be null or empty", mObjectID.c_str());
+		mLogger->warning("%s reportEvent: eventName must not be null or empty", mObjectID().c_str());
 		return;
 	}
 	if (mLogger->isDebugEnabled())
 	{
-		mLogger->debug("%s reportEvent(%s)", mObjectID.c_str(), eventNameString.getStringData().c_str());
+		mLogger->debug("%s reportEvent(%s)", mObjectID().c_str(), eventNameString.getStringData().c_str());
 	}
 
 	mBeacon->reportEvent(mActionID, eventNameString);
@@ -48,15 +55,20 @@ void ActionCommonImpl::reportEvent(const char* eventName)
 
 void ActionCommonImpl::reportValue(const char* valueName, int32_t value)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return;
+	}
+
 	UTF8String valueNameString(valueName);
 	if (valueNameString.empty())
 	{
-		mLogger->warning("%s reportValue (int): valueName must not be null or empty", mObjectID.c_str());
+		mLogger->warning("%s reportValue (int): valueName must not be null or empty", mObjectID().c_str());
 		return;
 	}
 	if (mLogger->isDebugEnabled())
 	{
-		mLogger->debug("%s reportValue (int) (%s, %d))", mObjectID.c_str(), valueNameString.getStringData().c_str(), value);
+		mLogger->debug("%s reportValue (int) (%s, %d))", mObjectID().c_str(), valueNameString.getStringData().c_str(), value);
 	}
 
 	mBeacon->reportValue(mActionID, valueNameString, value);
@@ -65,15 +77,20 @@ void ActionCommonImpl::reportValue(const char* valueName, int32_t value)
 
 void ActionCommonImpl::reportValue(const char* valueName, double value)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return;
+	}
+
 	UTF8String valueNameString(valueName);
 	if (valueNameString.empty())
 	{
-		mLogger->warning("%s reportValue (double): valueName must not be null or empty", mObjectID.c_str());
+		mLogger->warning("%s reportValue (double): valueName must not be null or empty", mObjectID().c_str());
 		return;
 	}
 	if (mLogger->isDebugEnabled())
 	{
-		mLogger->debug("%s reportValue (double) (%s, %f))", mObjectID.c_str(), valueNameString.getStringData().c_str(), value);
+		mLogger->debug("%s reportValue (double) (%s, %f))", mObjectID().c_str(), valueNameString.getStringData().c_str(), value);
 	}
 
 	mBeacon->reportValue(mActionID, valueNameString, value);
@@ -81,16 +98,21 @@ void ActionCommonImpl::reportValue(const char* valueName, double value)
 
 void ActionCommonImpl::reportValue(const char* valueName, const char* value)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return;
+	}
+
 	UTF8String valueNameString(valueName);
 	if (valueNameString.empty())
 	{
-		mLogger->warning("%s reportValue (string): valueName must not be null or empty", mObjectID.c_str());
+		mLogger->warning("%s reportValue (string): valueName must not be null or empty", mObjectID().c_str());
 		return;
 	}
 	if (mLogger->isDebugEnabled())
 	{
 		UTF8String valueString(value);
-		mLogger->debug("%s reportValue (string) (%s, %s))", mObjectID.c_str(),
+		mLogger->debug("%s reportValue (string) (%s, %s))", mObjectID().c_str(),
 				valueNameString.getStringData().c_str(),
 				(value != nullptr ? valueString.getStringData().c_str() : "null"));
 	}
@@ -99,18 +121,45 @@ void ActionCommonImpl::reportValue(const char* valueName, const char* value)
 }
 
 
+void ActionCommonImpl::reportValues(const openkit::ReportedValue* values, size_t numValues)
+{
+	if (!mBeacon->isCapturing() || values == nullptr || numValues == 0)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < numValues; i++)
+	{
+		if (values[i].name == nullptr || values[i].name[0] == '\0')
+		{
+			mLogger->warning("%s reportValues: name of entry %u must not be null or empty", mObjectID().c_str(), static_cast<uint32_t>(i));
+		}
+	}
+	if (mLogger->isDebugEnabled())
+	{
+		mLogger->debug("%s reportValues(%u entries)", mObjectID().c_str(), static_cast<uint32_t>(numValues));
+	}
+
+	mBeacon->reportValues(mActionID, values, numValues);
+}
+
 void ActionCommonImpl::reportError(const char* errorName, int32_t errorCode, const char* reason)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return;
+	}
+
 	UTF8String errorNameString(errorName);
 	UTF8String reasonString(reason);
 	if (errorNameString.empty())
 	{
-		mLogger->warning("%s reportError: errorName must not be null or empty", mObjectID.c_str());
+		mLogger->warning("%s reportError: errorName must not be null or empty", mObjectID().c_str());
 		return;
 	}
 	if (mLogger->isDebugEnabled())
 	{
-		mLogger->debug("%s reportError (%s, %d, %s))", mObjectID.c_str(),
+		mLogger->debug("%s reportError (%s, %d, %s))", mObjectID().c_str(),
 				errorNameString.getStringData().c_str(), errorCode,
 				(reason != nullptr ? reasonString.getStringData().c_str() : "null"));
 	}
@@ -121,21 +170,32 @@ void ActionCommonImpl::reportError(const char* errorName, int32_t errorCode, con
 
 std::shared_ptr<openkit::IWebRequestTracer> ActionCommonImpl::traceWebRequest(const char* url)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return NULL_WEB_REQUEST_TRACER;
+	}
+
 	core::UTF8String urlString(url);
 	if (urlString.empty())
 	{
-		mLogger->warning("%s traceWebRequest (string): url must not be null or empty", mObjectID.c_str());
+		mLogger->warning("%s traceWebRequest (string): url must not be null or empty", mObjectID().c_str());
 		return NULL_WEB_REQUEST_TRACER;
 	}
 	if (!WebRequestTracer::isValidURLScheme(urlString))
 	{
-		mLogger->warning("%s traceWebRequest (string): url \"%s\" does not have a valid scheme", mObjectID.c_str(), urlString.getStringData().c_str());
+		mLogger->warning("%s traceWebRequest (string): url \"%s\" does not have a valid scheme", mObjectID().c_str(), urlString.getStringData().c_str());
 		return NULL_WEB_REQUEST_TRACER;
 	}
 	if (mLogger->isDebugEnabled())
 	{
-		mLogger->debug("%s traceWebRequest (string) (%s))", mObjectID.c_str(), urlString.getStringData().c_str());
+		mLogger->debug("%s traceWebRequest (string) (%s))", mObjectID().c_str(), urlString.getStringData().c_str());
 	}
 
-	return std::make_shared<core::WebRequestTracer>(mLogger, mBeacon, mActionID, urlString);
+	// a dropped web request gets no tag, so the server never waits for its record
+	auto sampleRate = mBeacon->sampleWebRequest(urlString);
+	if (sampleRate <= 0.0)
+	{
+		return NULL_WEB_REQUEST_TRACER;
+	}
+	return util::allocateShared<core::WebRequestTracer>(mObjectArena, mLogger, mBeacon, mActionID, urlString, sampleRate);
 }
\ No newline at end of file
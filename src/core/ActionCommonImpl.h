@@ -19,8 +19,12 @@
 
 #include "OpenKit/ILogger.h"
 #include "OpenKit/IWebRequestTracer.h"
+#include "OpenKit/ReportedValue.h"
 #include "core/NullWebRequestTracer.h"
+#include "core/util/ObjectArena.h"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -43,9 +47,11 @@ namespace core
 		/// @param[in] logger logger instance to use
 		/// @param[in] beacon for this session that will serialize the data
 		/// @param[in] actionID integer ID of the action this @ref ActionCommonImpl will create data for
-		/// @param[in] objectID instance details serialization used for logging
+		/// @param[in] objectID provides the instance details serialization used for logging, only called when logging
+		/// @param[in] objectArena arena to allocate web request tracers from, or @c nullptr to allocate them on the heap
 		///
-		ActionCommonImpl(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t actionID, const std::string& objectID);
+		ActionCommonImpl(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t actionID,
+			std::function<const std::string()> objectID, std::shared_ptr<util::ObjectArena> objectArena = nullptr);
 
 		///
 		/// Add event (aka. named event) to Beacon.
@@ -74,6 +80,13 @@ namespace core
 		///
 		void reportValue(const char* valueName, const char* value);
 
+		///
+		/// Add several events and key-value-pairs to Beacon at once.
+		/// @param values Events and values to report, entries without a name are skipped.
+		/// @param numValues Number of entries in @c values.
+		///
+		void reportValues(const openkit::ReportedValue* values, size_t numValues);
+
 		///
 		/// Add error to Beacon.
 		/// @param errorName Error's name.
@@ -98,8 +111,11 @@ namespace core
 		/// the action ID
 		int32_t mActionID;
 
-		/// object information
-		const std::string mObjectID;
+		/// provides the object information, built lazily as it is only needed for logging
+		std::function<const std::string()> mObjectID;
+
+		/// arena to allocate web request tracers from
+		std::shared_ptr<util::ObjectArena> mObjectArena;
 
 	public:
 
@@ -27,7 +27,6 @@ using namespace communication;
 using namespace providers;
 
 constexpr int32_t SHUTDOWN_TIMEOUT_MILLISECONDS = 10 * 1000;
-constexpr int32_t SHUTDOWN_SLICED_WAIT_TIME_MILLISECONDS = 100;
 
 BeaconSender::BeaconSender(std::shared_ptr<openkit::ILogger> logger,
 						   std::shared_ptr<configuration::Configuration> configuration,
@@ -88,22 +87,35 @@ void BeaconSender::shutdown()
 		mLogger->debug("BeaconSender thread request shutdown");
 	}
 
+	// without a deadline requests in flight are not aborted, the thread is only waited for a limited time
 	mBeaconSendingContext->requestShutdown();
 
-	auto start = mTimingProvider->provideTimestampInMilliseconds();
-	int64_t timePassed = 0;
-	while (timePassed < SHUTDOWN_TIMEOUT_MILLISECONDS)
+	if (mSendingThread.valid())
 	{
-		//sleep in slices of 100ms
-		auto threadStatus = mSendingThread.wait_for(std::chrono::milliseconds(SHUTDOWN_SLICED_WAIT_TIME_MILLISECONDS));
-		if (threadStatus == std::future_status::ready)
-		{
-			return;//thread finished before timeout occurs
-		}
-		timePassed = mTimingProvider->provideTimestampInMilliseconds() - start;
+		// if the thread is still running after the wait it will either finish later or killed when the main process is ended
+		mSendingThread.wait_for(std::chrono::milliseconds(SHUTDOWN_TIMEOUT_MILLISECONDS));
+	}
+}
+
+openkit::ShutdownReport BeaconSender::shutdown(int64_t timeoutMillis)
+{
+	if (mLogger->isDebugEnabled())
+	{
+		mLogger->debug("BeaconSender thread request shutdown");
 	}
 
+	auto start = mTimingProvider->provideTimestampInMilliseconds();
+	mBeaconSendingContext->requestShutdownWithTimeout(timeoutMillis);
+
+	// the sending thread aborts its requests at the deadline, so a single wait is sufficient
+	auto remainingTime = timeoutMillis - (mTimingProvider->provideTimestampInMilliseconds() - start);
+	auto threadFinished = !mSendingThread.valid()
+		|| mSendingThread.wait_for(std::chrono::milliseconds(remainingTime > 0 ? remainingTime : 0)) == std::future_status::ready;
+
 	// if the thread is still running here it will either finish later or killed when the main process is ended
+	auto report = mBeaconSendingContext->getShutdownReport();
+	report.isDeadlineExceeded = report.isDeadlineExceeded || !threadFinished;
+	return report;
 }
 
 void BeaconSender::startSession(std::shared_ptr<Session> session)
@@ -123,3 +135,13 @@ void BeaconSender::finishSession(std::shared_ptr<Session> session)
 	}
 	mBeaconSendingContext->finishSession(session);
 }
+
+std::shared_ptr<util::WakeupEvent> BeaconSender::getWakeupEvent() const
+{
+	return mBeaconSendingContext->getWakeupEvent();
+}
+
+std::shared_ptr<util::WorkStealingThreadPool> BeaconSender::getChunkBuilderPool() const
+{
+	return mBeaconSendingContext->getChunkBuilderPool();
+}
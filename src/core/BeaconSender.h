@@ -20,12 +20,15 @@
 #include <memory>
 #include <future>
 
+#include "OpenKit/ShutdownReport.h"
 #include "communication/BeaconSendingContext.h"
 #include "configuration/Configuration.h"
 #include "providers/IHTTPClientProvider.h"
 #include "providers/ITimingProvider.h"
 
 #include "Session.h"
+#include "util/WakeupEvent.h"
+#include "util/WorkStealingThreadPool.h"
 
 namespace core
 {
@@ -77,10 +80,19 @@ namespace core
 		bool isInitialized() const;
 
 		///
-		/// Shutdown this instance of the BeaconSender
+		/// Shutdown this instance of the BeaconSender, waiting up to ten seconds for the remaining data being sent.
+		/// Requests in flight are not aborted.
 		///
 		void shutdown();
 
+		///
+		/// Shutdown this instance of the BeaconSender, waiting up to the given timeout for the remaining data being sent.
+		/// Requests still in flight when the timeout expires are aborted.
+		/// @param[in] timeoutMillis maximum number of milliseconds to wait
+		/// @returns how much data was sent and discarded
+		///
+		openkit::ShutdownReport shutdown(int64_t timeoutMillis);
+
 		///
 		/// When starting a new Session, put it into open Sessions.
 		/// A session is only put into the open Sessions if capturing is enabled.
@@ -96,6 +108,18 @@ namespace core
 		///
 		virtual void finishSession(std::shared_ptr<Session> session);
 
+		///
+		/// Returns the event which wakes up the beacon sending thread when raised.
+		/// @returns the wakeup event
+		///
+		std::shared_ptr<util::WakeupEvent> getWakeupEvent() const;
+
+		///
+		/// Returns the pool building the following chunk of a beacon while a chunk is in flight.
+		/// @returns the chunk builder pool
+		///
+		std::shared_ptr<util::WorkStealingThreadPool> getChunkBuilderPool() const;
+
 	private:
 		/// Logger to write traces to
 		std::shared_ptr<openkit::ILogger> mLogger;
@@ -36,10 +36,33 @@ namespace core
 			: NullAction(nullptr)
 		{}
 
+		///
+		/// Returns the process-wide instance without parent action, null objects carry no state and can be shared
+		/// @returns the shared NullAction
+		///
+		static const std::shared_ptr<NullAction>& getInstance()
+		{
+			static const std::shared_ptr<NullAction> instance = std::make_shared<NullAction>();
+			return instance;
+		}
+
 		NullAction(std::shared_ptr<openkit::IRootAction> parent)
 			: mParentAction(parent)
+			, mWeakParentAction()
 		{}
 
+		///
+		/// Creates a null action cached by its parent, which would never be released if it was referenced strongly
+		/// @param[in] parent the parent action returned by @ref leaveAction while it exists
+		/// @returns the new NullAction
+		///
+		static std::shared_ptr<NullAction> createCachedChildOf(std::weak_ptr<openkit::IRootAction> parent)
+		{
+			auto nullAction = std::make_shared<NullAction>();
+			nullAction->mWeakParentAction = parent;
+			return nullAction;
+		}
+
 		std::shared_ptr<IAction> reportEvent(const char* /*eventName*/) override
 		{
 			return shared_from_this();
@@ -60,6 +83,11 @@ namespace core
 			return shared_from_this();
 		}
 
+		std::shared_ptr<IAction> reportValues(const openkit::ReportedValue* /*values*/, size_t /*numValues*/) override
+		{
+			return shared_from_this();
+		}
+
 		std::shared_ptr<IAction> reportError(const char* /*errorName*/, int32_t /*errorCode*/, const char* /*reason*/) override
 		{
 			return shared_from_this();
@@ -67,15 +95,17 @@ namespace core
 
 		virtual std::shared_ptr<openkit::IWebRequestTracer> traceWebRequest(const char* /*url*/) override
 		{
-			return std::make_shared<NullWebRequestTracer>();
+			return NullWebRequestTracer::getInstance();
 		}
 
 		virtual std::shared_ptr<openkit::IRootAction> leaveAction() override
 		{
-			return mParentAction;
+			return mParentAction != nullptr ? mParentAction : mWeakParentAction.lock();
 		}
 
 		std::shared_ptr<openkit::IRootAction> mParentAction;
+
+		std::weak_ptr<openkit::IRootAction> mWeakParentAction;
 	};
 }
 
@@ -34,6 +34,16 @@ namespace core
 	{
 	public:
 
+		///
+		/// Returns the process-wide instance, null objects carry no state and can be shared
+		/// @returns the shared NullRootAction
+		///
+		static const std::shared_ptr<NullRootAction>& getInstance()
+		{
+			static const std::shared_ptr<NullRootAction> instance = std::make_shared<NullRootAction>();
+			return instance;
+		}
+
 		virtual std::shared_ptr<openkit::IAction> enterAction(const char* /*actionName*/) override
 		{
 			return std::shared_ptr<NullAction>(new NullAction(shared_from_this()));
@@ -59,6 +69,11 @@ namespace core
 			return shared_from_this();
 		}
 
+		virtual std::shared_ptr<IRootAction> reportValues(const openkit::ReportedValue* /*values*/, size_t /*numValues*/) override
+		{
+			return shared_from_this();
+		}
+
 		virtual std::shared_ptr<IRootAction> reportError(const char* /*errorName*/, int32_t /*errorCode*/, const char* /*reason*/) override
 		{
 			return shared_from_this();
@@ -66,7 +81,7 @@ namespace core
 
 		virtual std::shared_ptr<openkit::IWebRequestTracer> traceWebRequest(const char* /*url*/) override
 		{
-			return std::make_shared<NullWebRequestTracer>();
+			return NullWebRequestTracer::getInstance();
 		}
 
 		virtual void leaveAction() override
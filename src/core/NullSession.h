@@ -44,7 +44,7 @@ namespace core
 
 		virtual std::shared_ptr<openkit::IRootAction> enterAction(const char* /*actionName*/) override
 		{
-			return std::make_shared<NullRootAction>();
+			return NullRootAction::getInstance();
 		}
 
 		virtual void identifyUser(const char* /*userTag*/) override
@@ -59,7 +59,7 @@ namespace core
 
 		virtual std::shared_ptr<openkit::IWebRequestTracer> traceWebRequest(const char* /*url*/) override
 		{
-			return std::make_shared<NullWebRequestTracer>();
+			return NullWebRequestTracer::getInstance();
 		}
 
 		virtual void end() override
@@ -36,6 +36,16 @@ namespace core
 	{
 	public:
 
+		///
+		/// Returns the process-wide instance, null objects carry no state and can be shared
+		/// @returns the shared NullWebRequestTracer
+		///
+		static const std::shared_ptr<NullWebRequestTracer>& getInstance()
+		{
+			static const std::shared_ptr<NullWebRequestTracer> instance = std::make_shared<NullWebRequestTracer>();
+			return instance;
+		}
+
 		const char* getTag() const override
 		{
 			return emptyString;
@@ -20,6 +20,7 @@
 #include "providers/DefaultTimingProvider.h"
 #include "providers/DefaultThreadIDProvider.h"
 #include "caching/BeaconCache.h"
+#include "caching/BufferedBeaconCache.h"
 
 #include <inttypes.h> // for PRId64 macro
 
@@ -29,6 +30,22 @@ using namespace core;
 int32_t OpenKit::gInstanceCount = 0;
 std::mutex OpenKit::gInitLock;
 
+///
+/// Creates the cache buffering reported data if buffered ingestion is configured
+/// @returns the buffered beacon cache or @c nullptr if data is inserted on the reporting thread
+///
+static std::shared_ptr<caching::BufferedBeaconCache> createBufferedBeaconCache(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::Configuration> configuration)
+{
+	auto drainInterval = configuration->getBeaconCacheConfiguration()->getIngestionDrainInterval();
+	if (drainInterval <= 0)
+	{
+		return nullptr;
+	}
+
+	return std::make_shared<caching::BufferedBeaconCache>(logger, std::make_shared<caching::BeaconCache>(logger), drainInterval,
+		configuration->getBeaconCacheConfiguration()->getMaxIngestionBufferSizePerThread());
+}
+
 OpenKit::OpenKit(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::Configuration> configuration)
 	: OpenKit(logger, configuration,
 		std::make_shared<providers::DefaultHTTPClientProvider>(),
@@ -48,9 +65,13 @@ OpenKit::OpenKit(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<confi
 	, mConfiguration(configuration)
 	, mTimingProvider(timingProvider)
 	, mThreadIDProvider(threadIDProvider)
-	, mBeaconCache(std::make_shared<caching::BeaconCache>(logger))
+	, mBufferedBeaconCache(createBufferedBeaconCache(logger, configuration))
+	, mBeaconCache(mBufferedBeaconCache != nullptr
+		? std::static_pointer_cast<caching::IBeaconCache>(mBufferedBeaconCache)
+		: std::make_shared<caching::BeaconCache>(logger))
 	, mBeaconSender(std::make_shared<core::BeaconSender>(logger, configuration, httpClientProvider, timingProvider))
 	, mBeaconCacheEvictor(std::make_shared<caching::BeaconCacheEvictor>(logger, mBeaconCache, configuration->getBeaconCacheConfiguration(), timingProvider))
+	, mUploadRateLimiter(configuration->getHTTPClientConfiguration()->getUploadRateLimiter())
 	, mIsShutdown(0)
 	, NULL_SESSION(std::make_shared<core::NullSession>())
 {
@@ -69,6 +90,12 @@ OpenKit::OpenKit(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<confi
 			configuration->getEndpointURL().getStringData().c_str());
 	}
 
+	auto adaptiveSendingController = configuration->getAdaptiveSendingController();
+	if (adaptiveSendingController != nullptr)
+	{
+		adaptiveSendingController->setBeaconCache(mBeaconCache);
+	}
+
 	globalInit();
 }
 
@@ -79,6 +106,10 @@ OpenKit::~OpenKit()
 
 void OpenKit::initialize()
 {
+	if (mBufferedBeaconCache != nullptr)
+	{
+		mBufferedBeaconCache->start();
+	}
 	mBeaconCacheEvictor->start();
 	mBeaconSender->initialize();
 }
@@ -110,11 +141,30 @@ std::shared_ptr<openkit::ISession> OpenKit::createSession(const char* clientIPAd
 	}
 
 	auto beacon = std::make_shared<protocol::Beacon>(mLogger, mBeaconCache, mConfiguration, clientIPAddress, mThreadIDProvider, mTimingProvider);
+	beacon->setWakeupEvent(mBeaconSender->getWakeupEvent());
+	beacon->setChunkBuilderPool(mBeaconSender->getChunkBuilderPool());
 	auto newSession = std::make_shared<core::Session>(mLogger, mBeaconSender, beacon);
 	newSession->startSession();
 	return newSession;
 }
 
+openkit::UploadThrottleState OpenKit::getUploadThrottleState() const
+{
+	return mUploadRateLimiter->getThrottleState();
+}
+
+openkit::AdaptiveSendingState OpenKit::getAdaptiveSendingState() const
+{
+	auto adaptiveSendingController = mConfiguration->getAdaptiveSendingController();
+	if (adaptiveSendingController == nullptr)
+	{
+		// report the server's values as they are applied without adaptation
+		adaptiveSendingController = std::make_shared<protocol::AdaptiveSendingController>(0, protocol::AdaptiveSendingController::DEFAULT_SLOW_RESPONSE_THRESHOLD);
+	}
+
+	return adaptiveSendingController->getState(mConfiguration->getSendInterval(), mConfiguration->getMaxBeaconSize());
+}
+
 void OpenKit::shutdown()
 {
 	if (mLogger->isDebugEnabled())
@@ -123,9 +173,33 @@ void OpenKit::shutdown()
 	}
 	mIsShutdown = 1;
 	mBeaconCacheEvictor->stop();
+	if (mBufferedBeaconCache != nullptr)
+	{
+		mBufferedBeaconCache->stop();
+	}
 	mBeaconSender->shutdown();
 }
 
+openkit::ShutdownReport OpenKit::shutdown(int64_t timeoutMillis)
+{
+	if (mLogger->isDebugEnabled())
+	{
+		mLogger->debug("OpenKit shutdown requested with timeout of %" PRId64 " ms", timeoutMillis);
+	}
+	mIsShutdown = 1;
+
+	// the evictor and the beacon sender share the timeout
+	auto start = mTimingProvider->provideTimestampInMilliseconds();
+	mBeaconCacheEvictor->stop(std::chrono::milliseconds(timeoutMillis > 0 ? timeoutMillis : 0));
+	if (mBufferedBeaconCache != nullptr)
+	{
+		mBufferedBeaconCache->stop();
+	}
+	auto remainingTime = timeoutMillis - (mTimingProvider->provideTimestampInMilliseconds() - start);
+
+	return mBeaconSender->shutdown(remainingTime);
+}
+
 void OpenKit::globalInit()
 {
 	std::lock_guard<std::mutex> guard(gInitLock);
@@ -27,6 +27,7 @@
 #include "providers/IThreadIDProvider.h"
 #include "caching/IBeaconCache.h"
 #include "caching/BeaconCacheEvictor.h"
+#include "caching/BufferedBeaconCache.h"
 #include "core/BeaconSender.h"
 #include "core/NullSession.h"
 
@@ -78,8 +79,14 @@ namespace core
 
 		virtual std::shared_ptr<openkit::ISession> createSession(const char* clientIPAddress) override;
 
+		virtual openkit::UploadThrottleState getUploadThrottleState() const override;
+
+		virtual openkit::AdaptiveSendingState getAdaptiveSendingState() const override;
+
 		virtual void shutdown() override;
 
+		virtual openkit::ShutdownReport shutdown(int64_t timeoutMillis) override;
+
 	private:
 
 		///
@@ -111,6 +118,9 @@ namespace core
 		/// thread id provider
 		std::shared_ptr<providers::IThreadIDProvider> mThreadIDProvider;
 
+		/// the beacon cache buffering reported data, @c nullptr if data is inserted on the reporting thread
+		std::shared_ptr<caching::BufferedBeaconCache> mBufferedBeaconCache;
+
 		/// the beacon cache
 		std::shared_ptr<caching::IBeaconCache> mBeaconCache;
 
@@ -120,6 +130,9 @@ namespace core
 		/// beacon cache evictor
 		std::shared_ptr<caching::BeaconCacheEvictor> mBeaconCacheEvictor;
 
+		/// rate limiter shared by all uploads
+		std::shared_ptr<protocol::UploadRateLimiter> mUploadRateLimiter;
+
 		/// atomic flag for shutdown state
 		std::atomic<int32_t> mIsShutdown;
 
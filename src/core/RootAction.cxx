@@ -23,10 +23,14 @@
 
 using namespace core;
 
+std::shared_ptr<NullAction> RootAction::NULL_ACTION(NullAction::getInstance());
+
 RootAction::RootAction(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, const UTF8String& name, std::shared_ptr<Session> session)
 	: mLogger(logger)
 	, mBeacon(beacon)
-	, mOpenChildActions()
+	, mObjectArena(session != nullptr ? session->getObjectArena() : nullptr)
+	, mOpenChildActions(mObjectArena)
+	, mOpenActionHook()
 	, mSession(session)
 	, mID(mBeacon->createID())
 	, mName(name)
@@ -34,14 +38,27 @@ RootAction::RootAction(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr
 	, mStartSequenceNumber(mBeacon->createSequenceNumber())
 	, mEndSequenceNumber(-1)
 	, mEndTime(-1)
-	, NULL_ACTION(std::make_shared<NullAction>())
-	, mActionImpl(logger, beacon, mID, toString())
+	, mNullChildAction()
+	, mActionImpl(logger, beacon, mID, [this]() { return toString(); }, mObjectArena)
 {
 
 }
 
 std::shared_ptr<openkit::IAction> RootAction::enterAction(const char* actionName)
 {
+	if (!mBeacon->isCapturing())
+	{
+		// nothing would be recorded, skip validation and allocation, leaving the null action still returns to this action
+		auto nullChildAction = std::atomic_load(&mNullChildAction);
+		if (nullChildAction == nullptr)
+		{
+			// threads racing here each create one, which is harmless
+			nullChildAction = NullAction::createCachedChildOf(shared_from_this());
+			std::atomic_store(&mNullChildAction, nullChildAction);
+		}
+		return nullChildAction;
+	}
+
 	UTF8String actionNameString(actionName);
 	if (actionNameString.empty())
 	{
@@ -51,8 +68,8 @@ std::shared_ptr<openkit::IAction> RootAction::enterAction(const char* actionName
 
 	if (!isActionLeft())
 	{
-		auto childAction = std::make_shared<Action>(mLogger, mBeacon, UTF8String(actionName), shared_from_this());
-		mOpenChildActions.put(std::static_pointer_cast<openkit::IAction>(childAction));
+		auto childAction = util::allocateShared<Action>(mObjectArena, mLogger, mBeacon, UTF8String(actionName), shared_from_this());
+		mOpenChildActions.insert(childAction);
 		return childAction;
 	}
 	return NULL_ACTION;
@@ -94,6 +111,15 @@ std::shared_ptr<openkit::IRootAction> RootAction::reportValue(const char* valueN
 	return shared_from_this();
 }
 
+std::shared_ptr<openkit::IRootAction> RootAction::reportValues(const openkit::ReportedValue* values, size_t numValues)
+{
+	if (!isActionLeft())
+	{
+		mActionImpl.reportValues(values, numValues);
+	}
+	return shared_from_this();
+}
+
 std::shared_ptr<openkit::IRootAction> RootAction::reportError(const char* errorName, int32_t errorCode, const char* reason)
 {
 	if (!isActionLeft())
@@ -117,14 +143,21 @@ void RootAction::doLeaveAction()
 	// add Action to Beacon
 	mBeacon->addAction(shared_from_this());
 
+	auto hasLeftChildActions = false;
 	while (!mOpenChildActions.isEmpty())
 	{
-		auto action = mOpenChildActions.get();
-		action->leaveAction();
+		for (auto& action : mOpenChildActions.removeAll())
+		{
+			action->leaveAction();
+		}
+		hasLeftChildActions = true;
 	}
 
 	// leave event of the root action must be later than the leaveAction calls of the childs
-	mEndTime = mBeacon->getCurrentTimestamp();
+	if (hasLeftChildActions)
+	{
+		mEndTime = mBeacon->getCurrentTimestamp();
+	}
 	mEndSequenceNumber = mBeacon->createSequenceNumber();
 
 	mSession->rootActionEnded(std::static_pointer_cast<RootAction>(shared_from_this()));
@@ -148,7 +181,7 @@ void RootAction::leaveAction()
 
 void RootAction::childActionEnded(std::shared_ptr<Action> childAction)
 {
-	mOpenChildActions.remove(childAction);
+	mOpenChildActions.remove(*childAction);
 }
 
 int32_t RootAction::getID() const
@@ -191,6 +224,16 @@ bool RootAction::hasOpenChildActions() const
 	return !mOpenChildActions.isEmpty();
 }
 
+util::OpenActionSet<RootAction>::Hook& RootAction::getOpenActionHook()
+{
+	return mOpenActionHook;
+}
+
+std::shared_ptr<util::ObjectArena> RootAction::getObjectArena() const
+{
+	return mObjectArena;
+}
+
 const std::string RootAction::toString() const
 {
 	std::stringstream ss;
@@ -30,6 +30,7 @@
 #include "NullAction.h"
 #include "NullWebRequestTracer.h"
 #include "core/ActionCommonImpl.h"
+#include "core/util/OpenActionSet.h"
 
 #include <memory>
 
@@ -71,6 +72,8 @@ namespace core
 
 		std::shared_ptr<IRootAction> reportValue(const char* valueName, const char* value) override;
 
+		std::shared_ptr<IRootAction> reportValues(const openkit::ReportedValue* values, size_t numValues) override;
+
 		std::shared_ptr<IRootAction> reportError(const char* errorName, int32_t errorCode, const char* reason) override;
 
 		std::shared_ptr<openkit::IWebRequestTracer> traceWebRequest(const char* url) override;
@@ -126,6 +129,18 @@ namespace core
 		///
 		bool hasOpenChildActions() const;
 
+		///
+		/// Returns the position of this action within the open actions of its session
+		/// @returns the hook linking this action into its session's open actions
+		///
+		util::OpenActionSet<RootAction>::Hook& getOpenActionHook();
+
+		///
+		/// Returns the arena the child actions and web request tracers of this action are allocated from
+		/// @returns the arena of this action's session, or @c nullptr if there is none
+		///
+		std::shared_ptr<util::ObjectArena> getObjectArena() const;
+
 		///
 		/// Return a flag if this action has been closed already
 		/// @returns @c true if action was already left, @c false if action is open
@@ -154,8 +169,14 @@ namespace core
 		/// beacon used for serialization
 		std::shared_ptr<protocol::Beacon> mBeacon;
 
+		/// arena for the child actions and web request tracers, shared with the session
+		std::shared_ptr<util::ObjectArena> mObjectArena;
+
 		/// open Actions of children
-		util::SynchronizedQueue<std::shared_ptr<openkit::IAction>> mOpenChildActions;
+		util::OpenActionSet<Action> mOpenChildActions;
+
+		/// position of this action within the open actions of its session
+		util::OpenActionSet<RootAction>::Hook mOpenActionHook;
 
 		/// session keeping track of all root actions
 		std::shared_ptr<Session> mSession;
@@ -179,7 +200,10 @@ namespace core
 		std::atomic<int64_t> mEndTime;
 
 		/// NullAction
-		std::shared_ptr<NullAction> NULL_ACTION;
+		static std::shared_ptr<NullAction> NULL_ACTION;
+
+		/// null action leading back to this action, created when the first child action is entered while nothing is captured
+		std::shared_ptr<NullAction> mNullChildAction;
 
 		/// Impl object with the actual implementations for Action/RootAction
 		ActionCommonImpl mActionImpl;
@@ -25,15 +25,16 @@
 
 using namespace core;
 
-std::shared_ptr<NullWebRequestTracer> Session::NULL_WEB_REQUEST_TRACER(std::make_shared<NullWebRequestTracer>());
+std::shared_ptr<NullWebRequestTracer> Session::NULL_WEB_REQUEST_TRACER(NullWebRequestTracer::getInstance());
+std::shared_ptr<NullRootAction> Session::NULL_ROOT_ACTION(NullRootAction::getInstance());
 
 Session::Session(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<BeaconSender> beaconSender, std::shared_ptr<protocol::Beacon> beacon)
 	: mLogger(logger)
 	, mBeaconSender(beaconSender)
 	, mBeacon(beacon)
 	, mEndTime(-1)
-	, mOpenRootActions()
-	, NULL_ROOT_ACTION(std::make_shared<NullRootAction>())
+	, mObjectArena(std::make_shared<util::ObjectArena>())
+	, mOpenRootActions(mObjectArena)
 {
 
 }
@@ -46,6 +47,12 @@ void Session::startSession()
 
 std::shared_ptr<openkit::IRootAction> Session::enterAction(const char* actionName)
 {
+	if (!mBeacon->isCapturing())
+	{
+		// nothing would be recorded, skip validation and allocation
+		return NULL_ROOT_ACTION;
+	}
+
 	UTF8String actionNameString(actionName);
 	if (actionNameString.empty())
 	{
@@ -61,13 +68,18 @@ std::shared_ptr<openkit::IRootAction> Session::enterAction(const char* actionNam
 	{
 		return NULL_ROOT_ACTION;
 	}
-	std::shared_ptr<openkit::IRootAction> pointer = std::make_shared<RootAction>(mLogger, mBeacon, actionNameString, shared_from_this());
-	mOpenRootActions.put(pointer);
-	return pointer;
+	auto rootAction = util::allocateShared<RootAction>(mObjectArena, mLogger, mBeacon, actionNameString, shared_from_this());
+	mOpenRootActions.insert(rootAction);
+	return rootAction;
 }
 
 void Session::identifyUser(const char* userTag)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return;
+	}
+
 	UTF8String userTagString(userTag);
 
 	if (userTag == nullptr || userTagString.empty())
@@ -113,6 +125,11 @@ void Session::reportCrash(const char* errorName, const char* reason, const char*
 
 std::shared_ptr<openkit::IWebRequestTracer> Session::traceWebRequest(const char* url)
 {
+	if (!mBeacon->isCapturing())
+	{
+		return NULL_WEB_REQUEST_TRACER;
+	}
+
 	core::UTF8String urlString(url);
 	if (urlString.empty())
 	{
@@ -131,7 +148,13 @@ std::shared_ptr<openkit::IWebRequestTracer> Session::traceWebRequest(const char*
 
 	if (!isSessionEnded())
 	{
-		return std::make_shared<core::WebRequestTracer>(mLogger, mBeacon, 0, urlString);
+		// a dropped web request gets no tag, so the server never waits for its record
+		auto sampleRate = mBeacon->sampleWebRequest(urlString);
+		if (sampleRate <= 0.0)
+		{
+			return NULL_WEB_REQUEST_TRACER;
+		}
+		return util::allocateShared<core::WebRequestTracer>(mObjectArena, mLogger, mBeacon, 0, urlString, sampleRate);
 	}
 	return NULL_WEB_REQUEST_TRACER;
 }
@@ -150,8 +173,10 @@ void Session::end()
 
 	// leave all Root-Actions for sanity reasons
 	while (!mOpenRootActions.isEmpty()) {
-		auto action = mOpenRootActions.get();
-		action->leaveAction();
+		for (auto& action : mOpenRootActions.removeAll())
+		{
+			action->leaveAction();
+		}
 	}
 
 	mBeacon->endSession(shared_from_this());
@@ -171,7 +196,12 @@ int64_t Session::getEndTime() const
 
 void Session::rootActionEnded(std::shared_ptr<RootAction> rootAction)
 {
-	mOpenRootActions.remove(rootAction);
+	mOpenRootActions.remove(*rootAction);
+}
+
+std::shared_ptr<util::ObjectArena> Session::getObjectArena() const
+{
+	return mObjectArena;
 }
 
 std::shared_ptr<protocol::StatusResponse> Session::sendBeacon(std::shared_ptr<providers::IHTTPClientProvider> clientProvider)
@@ -179,11 +209,31 @@ std::shared_ptr<protocol::StatusResponse> Session::sendBeacon(std::shared_ptr<pr
 	return mBeacon->send(clientProvider);
 }
 
+bool Session::storeBeacon(caching::BeaconChunkStore& chunkStore, std::shared_ptr<providers::IHTTPClientProvider> clientProvider)
+{
+	return mBeacon->store(chunkStore, clientProvider);
+}
+
 bool Session::isEmpty() const
 {
 	return mBeacon->isEmpty();
 }
 
+bool Session::isSendThresholdReached() const
+{
+	return mBeacon->isSendThresholdReached();
+}
+
+int64_t Session::getNumBytesInCache() const
+{
+	return mBeacon->getNumBytesInCache();
+}
+
+int64_t Session::getOldestRecordTimestamp() const
+{
+	return mBeacon->getOldestRecordTimestamp();
+}
+
 void Session::clearCapturedData()
 {
 	mBeacon->clearData();
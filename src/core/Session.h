@@ -28,7 +28,8 @@
 #include "NullRootAction.h"
 
 #include "UTF8String.h"
-#include "util/SynchronizedQueue.h"
+#include "util/ObjectArena.h"
+#include "util/OpenActionSet.h"
 #include "providers/IHTTPClientProvider.h"
 #include "providers/IHTTPClientProvider.h"
 #include "configuration/BeaconConfiguration.h"
@@ -41,6 +42,11 @@ namespace protocol
 	class Beacon;
 }
 
+namespace caching
+{
+	class BeaconChunkStore;
+}
+
 namespace core
 {
 	class BeaconSender;
@@ -90,6 +96,12 @@ namespace core
 		///
 		void rootActionEnded(std::shared_ptr<RootAction> rootAction);
 
+		///
+		/// Returns the arena the actions and web request tracers of this session are allocated from
+		/// @returns the arena of this session
+		///
+		std::shared_ptr<util::ObjectArena> getObjectArena() const;
+
 		///
 		/// Start a session
 		///
@@ -102,6 +114,14 @@ namespace core
 		///
 		virtual std::shared_ptr<protocol::StatusResponse> sendBeacon(std::shared_ptr<providers::IHTTPClientProvider> clientProvider);
 
+		///
+		/// Stores the current Beacon state in the given chunk store to send it later on
+		/// @param[in] chunkStore the store receiving the data
+		/// @param[in] clientProvider the IHTTPClientProvider providing the client encoding the data
+		/// @returns @c true if all data was stored, @c false otherwise
+		///
+		virtual bool storeBeacon(caching::BeaconChunkStore& chunkStore, std::shared_ptr<providers::IHTTPClientProvider> clientProvider);
+
 		///
 		/// Test if this session is empty or not
 		///
@@ -110,6 +130,24 @@ namespace core
 		///
 		virtual bool isEmpty() const;
 
+		///
+		/// Test if the data captured since the last send reached the session flush threshold
+		/// @returns @c true if this session shall be sent before the send interval expired, @c false otherwise
+		///
+		virtual bool isSendThresholdReached() const;
+
+		///
+		/// Returns the number of bytes this session holds in the beacon cache
+		/// @returns the number of cached bytes
+		///
+		virtual int64_t getNumBytesInCache() const;
+
+		///
+		/// Returns the timestamp of the oldest data this session holds in the beacon cache
+		/// @returns the oldest record's timestamp or @c -1 if nothing is cached
+		///
+		virtual int64_t getOldestRecordTimestamp() const;
+
 
 		///
 		/// Clears data that has been captured so far.
@@ -156,11 +194,14 @@ namespace core
 		/// end time
 		std::atomic<int64_t> mEndTime;
 
-		/// synchronized queue of root actions of this session
-		util::SynchronizedQueue<std::shared_ptr<openkit::IRootAction>> mOpenRootActions;
+		/// arena for the actions and web request tracers of this session
+		std::shared_ptr<util::ObjectArena> mObjectArena;
+
+		/// root actions of this session which were not left yet
+		util::OpenActionSet<RootAction> mOpenRootActions;
 
 		/// instance of NullRootAction
-		std::shared_ptr<NullRootAction> NULL_ROOT_ACTION;
+		static std::shared_ptr<NullRootAction> NULL_ROOT_ACTION;
 
 		/// Null WebRequestTracer
 		static std::shared_ptr<NullWebRequestTracer> NULL_WEB_REQUEST_TRACER;
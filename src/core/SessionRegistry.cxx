@@ -0,0 +1,158 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "core/SessionRegistry.h"
+
+using namespace core;
+
+SessionRegistry::SessionRegistry()
+	: mNewSessions()
+	, mOpenSessions()
+	, mFinishedSessions()
+	, mIndex()
+	, mMutex()
+{
+}
+
+void SessionRegistry::add(std::shared_ptr<SessionWrapper> sessionWrapper)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto key = sessionWrapper->getWrappedSession().get();
+	if (mIndex.find(key) != mIndex.end())
+	{
+		return; // session is registered already
+	}
+
+	auto position = mNewSessions.insert(mNewSessions.end(), sessionWrapper);
+	mIndex[key] = Entry{ &mNewSessions, position };
+}
+
+std::shared_ptr<SessionWrapper> SessionRegistry::find(std::shared_ptr<Session> session) const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mIndex.find(session.get());
+	return it != mIndex.end() ? *it->second.position : nullptr;
+}
+
+std::shared_ptr<SessionWrapper> SessionRegistry::finish(std::shared_ptr<Session> session)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mIndex.find(session.get());
+	if (it == mIndex.end())
+	{
+		return nullptr;
+	}
+
+	auto sessionWrapper = *it->second.position;
+	sessionWrapper->finishSession();
+	if (it->second.bucket == &mOpenSessions)
+	{
+		moveTo(it->second, mFinishedSessions);
+	}
+	// new sessions are moved to the finished sessions once they are configured
+
+	return sessionWrapper;
+}
+
+bool SessionRegistry::remove(std::shared_ptr<SessionWrapper> sessionWrapper)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mIndex.find(sessionWrapper->getWrappedSession().get());
+	if (it == mIndex.end() || *it->second.position != sessionWrapper)
+	{
+		return false;
+	}
+
+	it->second.bucket->erase(it->second.position);
+	mIndex.erase(it);
+	return true;
+}
+
+std::vector<std::shared_ptr<SessionWrapper>> SessionRegistry::getNewSessions()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	promoteConfiguredSessions();
+	return std::vector<std::shared_ptr<SessionWrapper>>(mNewSessions.begin(), mNewSessions.end());
+}
+
+std::vector<std::shared_ptr<SessionWrapper>> SessionRegistry::getOpenSessions()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	promoteConfiguredSessions();
+
+	std::vector<std::shared_ptr<SessionWrapper>> openSessions;
+	openSessions.reserve(mOpenSessions.size());
+	for (auto it = mOpenSessions.begin(); it != mOpenSessions.end();)
+	{
+		auto sessionWrapper = *it++;
+		if (sessionWrapper->isSessionFinished())
+		{
+			// finished on the wrapper directly instead of via finish()
+			moveTo(mIndex[sessionWrapper->getWrappedSession().get()], mFinishedSessions);
+		}
+		else
+		{
+			openSessions.push_back(sessionWrapper);
+		}
+	}
+
+	return openSessions;
+}
+
+std::vector<std::shared_ptr<SessionWrapper>> SessionRegistry::getFinishedSessions()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	promoteConfiguredSessions();
+	return std::vector<std::shared_ptr<SessionWrapper>>(mFinishedSessions.begin(), mFinishedSessions.end());
+}
+
+std::vector<std::shared_ptr<SessionWrapper>> SessionRegistry::getAllSessions() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	std::vector<std::shared_ptr<SessionWrapper>> allSessions;
+	allSessions.reserve(mIndex.size());
+	allSessions.insert(allSessions.end(), mNewSessions.begin(), mNewSessions.end());
+	allSessions.insert(allSessions.end(), mOpenSessions.begin(), mOpenSessions.end());
+	allSessions.insert(allSessions.end(), mFinishedSessions.begin(), mFinishedSessions.end());
+	return allSessions;
+}
+
+size_t SessionRegistry::size() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mIndex.size();
+}
+
+void SessionRegistry::moveTo(Entry& entry, SessionList& bucket)
+{
+	// splicing keeps the iterator valid, so the index entry stays intact apart from the bucket
+	bucket.splice(bucket.end(), *entry.bucket, entry.position);
+	entry.bucket = &bucket;
+}
+
+void SessionRegistry::promoteConfiguredSessions()
+{
+	for (auto it = mNewSessions.begin(); it != mNewSessions.end();)
+	{
+		auto sessionWrapper = *it++;
+		if (sessionWrapper->isBeaconConfigurationSet())
+		{
+			auto& entry = mIndex[sessionWrapper->getWrappedSession().get()];
+			moveTo(entry, sessionWrapper->isSessionFinished() ? mFinishedSessions : mOpenSessions);
+		}
+	}
+}
@@ -0,0 +1,164 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _CORE_SESSIONREGISTRY_H
+#define _CORE_SESSIONREGISTRY_H
+
+#include "core/Session.h"
+#include "core/SessionWrapper.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace core
+{
+	///
+	/// Thread-safe registry of the sessions known to the beacon sending context.
+	///
+	/// Sessions are kept in three buckets (new, open and finished) in the order they entered the bucket,
+	/// and indexed by the wrapped session, so that looking up, finishing and removing a session takes constant time.
+	/// A new session moves on to the open or finished bucket once its beacon configuration has been set. Since the
+	/// configuration is set on the wrapper directly, this is done lazily whenever the buckets are read.
+	///
+	class SessionRegistry
+	{
+	public:
+		///
+		/// Constructor creating an empty registry
+		///
+		SessionRegistry();
+
+		///
+		/// Add a session to the new sessions
+		/// @param[in] sessionWrapper the wrapper of the session to add
+		///
+		void add(std::shared_ptr<SessionWrapper> sessionWrapper);
+
+		///
+		/// Look up the wrapper of a session
+		/// @param[in] session the wrapped session
+		/// @returns the wrapper or @c nullptr if the session is not registered
+		///
+		std::shared_ptr<SessionWrapper> find(std::shared_ptr<Session> session) const;
+
+		///
+		/// Mark a session as finished and move it to the finished sessions if it is configured already
+		/// @param[in] session the wrapped session
+		/// @returns the wrapper of the finished session or @c nullptr if the session is not registered
+		///
+		std::shared_ptr<SessionWrapper> finish(std::shared_ptr<Session> session);
+
+		///
+		/// Remove a session from the registry
+		/// @param[in] sessionWrapper the wrapper of the session to remove
+		/// @returns @c true if the session was registered, @c false otherwise
+		///
+		bool remove(std::shared_ptr<SessionWrapper> sessionWrapper);
+
+		///
+		/// Returns the sessions which have not been configured yet
+		/// @returns a shallow copy of the new sessions
+		///
+		std::vector<std::shared_ptr<SessionWrapper>> getNewSessions();
+
+		///
+		/// Returns the configured sessions which are not finished
+		/// @returns a shallow copy of the open sessions
+		///
+		std::vector<std::shared_ptr<SessionWrapper>> getOpenSessions();
+
+		///
+		/// Returns the configured sessions which are finished
+		/// @returns a shallow copy of the finished sessions
+		///
+		std::vector<std::shared_ptr<SessionWrapper>> getFinishedSessions();
+
+		///
+		/// Returns all registered sessions
+		/// @returns a shallow copy of all sessions
+		///
+		std::vector<std::shared_ptr<SessionWrapper>> getAllSessions() const;
+
+		///
+		/// Returns the number of registered sessions
+		/// @returns the number of sessions
+		///
+		size_t size() const;
+
+	private:
+		/// list of sessions forming one bucket
+		typedef std::list<std::shared_ptr<SessionWrapper>> SessionList;
+
+		///
+		/// Bucket and position of a registered session
+		///
+		struct Entry
+		{
+			Entry()
+				: bucket(nullptr)
+				, position()
+			{
+			}
+
+			Entry(SessionList* bucket, SessionList::iterator position)
+				: bucket(bucket)
+				, position(position)
+			{
+			}
+
+			/// the bucket containing the session
+			SessionList* bucket;
+
+			/// position of the session within the bucket
+			SessionList::iterator position;
+		};
+
+		///
+		/// Move the session at the given entry to another bucket
+		/// @param[in] entry the entry of the session to move
+		/// @param[in] bucket the target bucket
+		///
+		void moveTo(Entry& entry, SessionList& bucket);
+
+		///
+		/// Move the new sessions whose beacon configuration has been set to the open or finished sessions.
+		/// Must be called with the mutex held.
+		///
+		void promoteConfiguredSessions();
+
+		/// sessions which have not been configured yet
+		SessionList mNewSessions;
+
+		/// configured sessions which are not finished
+		SessionList mOpenSessions;
+
+		/// configured sessions which are finished
+		SessionList mFinishedSessions;
+
+		/// index from the wrapped session to its bucket and position
+		std::unordered_map<const Session*, Entry> mIndex;
+
+		/// mutex protecting the buckets and the index
+		mutable std::mutex mMutex;
+	};
+}
+
+#endif
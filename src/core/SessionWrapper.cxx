@@ -27,6 +27,8 @@ SessionWrapper::SessionWrapper(std::shared_ptr<Session> session)
 	, mIsBeaconConfigurationSet(false)
 	, mSessionFinished(false)
 	, mNumNewSessionRequestsLeft(MAX_NEW_SESSION_REQUESTS)
+	, mNumFailedSendAttempts(0)
+	, mNextSendAttemptTime(0)
 {
 
 }
@@ -72,6 +74,11 @@ bool SessionWrapper::isEmpty() const
 	return mWrappedSession->isEmpty();
 }
 
+bool SessionWrapper::isSendThresholdReached() const
+{
+	return mWrappedSession->isSendThresholdReached();
+}
+
 void SessionWrapper::end()
 {
 	mWrappedSession->end();
@@ -96,3 +103,30 @@ std::shared_ptr<protocol::StatusResponse> SessionWrapper::sendBeacon(std::shared
 {
 	return mWrappedSession->sendBeacon(httpClientProvider);
 }
+
+bool SessionWrapper::storeBeacon(caching::BeaconChunkStore& chunkStore, std::shared_ptr<providers::IHTTPClientProvider> httpClientProvider)
+{
+	return mWrappedSession->storeBeacon(chunkStore, httpClientProvider);
+}
+
+uint32_t SessionWrapper::getNumFailedSendAttempts() const
+{
+	return mNumFailedSendAttempts;
+}
+
+int64_t SessionWrapper::getNextSendAttemptTime() const
+{
+	return mNextSendAttemptTime;
+}
+
+void SessionWrapper::recordFailedSendAttempt(int64_t nextSendAttemptTime)
+{
+	mNumFailedSendAttempts++;
+	mNextSendAttemptTime = nextSendAttemptTime;
+}
+
+void SessionWrapper::resetFailedSendAttempts()
+{
+	mNumFailedSendAttempts = 0;
+	mNextSendAttemptTime = 0;
+}
\ No newline at end of file
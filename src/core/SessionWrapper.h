@@ -90,6 +90,12 @@ namespace core
 		///
 		bool isEmpty() const;
 
+		///
+		/// Test if the Session reached the flush threshold and shall be sent before the send interval expired.
+		/// @returns flag if the wrapped session indicates that the threshold is reached
+		///
+		bool isSendThresholdReached() const;
+
 		///
 		/// Ends the session
 		///
@@ -120,6 +126,37 @@ namespace core
 		///
 		std::shared_ptr<protocol::StatusResponse> sendBeacon(std::shared_ptr<providers::IHTTPClientProvider> httpClientProvider);
 
+		///
+		/// Store beacon forward call
+		/// @param[in] chunkStore the store receiving the data
+		/// @param[in] httpClientProvider http client provider
+		/// @returns @c true if all data was stored, @c false otherwise
+		///
+		bool storeBeacon(caching::BeaconChunkStore& chunkStore, std::shared_ptr<providers::IHTTPClientProvider> httpClientProvider);
+
+		///
+		/// Get the number of consecutive failed send attempts for this session.
+		/// @returns number of failed attempts since the last successful request
+		///
+		uint32_t getNumFailedSendAttempts() const;
+
+		///
+		/// Get the earliest timestamp at which the next request for this session may be sent.
+		/// @returns timestamp in milliseconds, @c 0 if sending is not deferred
+		///
+		int64_t getNextSendAttemptTime() const;
+
+		///
+		/// Record a failed send attempt and defer further requests until the given time.
+		/// @param[in] nextSendAttemptTime timestamp in milliseconds before which no request shall be sent
+		///
+		void recordFailedSendAttempt(int64_t nextSendAttemptTime);
+
+		///
+		/// Reset the failed send attempts after a request was sent successfully.
+		///
+		void resetFailedSendAttempts();
+
 	private:
 
 		/// pointer to wrapped session
@@ -136,6 +173,12 @@ namespace core
 
 		/// number of remaining session requests before giving up
 		uint32_t mNumNewSessionRequestsLeft;
+
+		/// number of consecutive failed send attempts
+		uint32_t mNumFailedSendAttempts;
+
+		/// earliest timestamp for the next send attempt
+		int64_t mNextSendAttemptTime;
 	};
 }
 
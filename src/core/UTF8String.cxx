@@ -155,9 +155,11 @@ void UTF8String::validateString(const char* stringData)
 	}
 
 	auto byteLength = 0;
+	auto isASCII = true;
 
 	while (!isStringTerminationCharacter(stringData, byteLength))
 	{
+		isASCII = isASCII && (static_cast<unsigned char>(stringData[byteLength]) & 0x80) == 0;
 		byteLength++;
 	}
 
@@ -166,6 +168,14 @@ void UTF8String::validateString(const char* stringData)
 		return;
 	}
 
+	if (isASCII)
+	{
+		// nothing to validate, every byte is a character of its own
+		mData.assign(stringData, byteLength);
+		mStringLength = byteLength;
+		return;
+	}
+
 	mData.clear();
 
 	auto multibyteSeqenceLength = -1;
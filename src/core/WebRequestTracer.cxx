@@ -19,11 +19,24 @@
 #include "protocol/Beacon.h"
 
 #include <sstream>
-#include <regex>
 
 namespace core
 {
-	static const std::regex SCHEMA_VALIDATION_PATTERN("^[a-zA-Z][a-zA-Z0-9+\\-.]*://.+$", std::regex::optimize | std::regex::ECMAScript);
+	///
+	/// Returns whether a character is an ASCII letter.
+	///
+	static bool isSchemeLetter(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+	}
+
+	///
+	/// Returns whether a character may follow the first letter of a URL scheme.
+	///
+	static bool isSchemeCharacter(char c)
+	{
+		return isSchemeLetter(c) || (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.';
+	}
 
 	WebRequestTracer::WebRequestTracer(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t parentActionID)
 		: mLogger(logger)
@@ -37,14 +50,17 @@ namespace core
 		, mStartSequenceNo(beacon->createSequenceNumber())
 		, mEndSequenceNo(-1)
 		, mWebRequestTag(beacon->createTag(parentActionID, mStartSequenceNo))
+		, mSampleRate(1.0)
 		, mURL(core::UTF8String("<unknown>"))
 	{
 
 	}
 
-	WebRequestTracer::WebRequestTracer(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t parentActionID, const UTF8String& url)
+	WebRequestTracer::WebRequestTracer(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t parentActionID, const UTF8String& url, double sampleRate)
 		: WebRequestTracer(logger, beacon, parentActionID)
 	{
+		mSampleRate = sampleRate;
+
 		if (isValidURLScheme(url))
 		{
 			auto indexOfQuestionMark = url.getIndexOf("?");
@@ -62,7 +78,40 @@ namespace core
 
 	bool WebRequestTracer::isValidURLScheme(const UTF8String& url)
 	{
-		return std::regex_match(url.getStringData(), SCHEMA_VALIDATION_PATTERN);
+		// equivalent to matching ^[a-zA-Z][a-zA-Z0-9+\-.]*://.+$ - a scheme, "://" and at least one character
+		// which is not a line terminator - but without the cost of a regular expression on every traced URL
+		const auto& data = url.getStringData();
+		auto length = data.size();
+		if (length == 0 || !isSchemeLetter(data[0]))
+		{
+			return false;
+		}
+
+		std::string::size_type index = 1;
+		while (index < length && isSchemeCharacter(data[index]))
+		{
+			index++;
+		}
+
+		if (data.compare(index, 3, "://") != 0)
+		{
+			return false;
+		}
+
+		index += 3;
+		if (index >= length)
+		{
+			return false;
+		}
+
+		for (; index < length; index++)
+		{
+			if (data[index] == '\n' || data[index] == '\r')
+			{
+				return false;
+			}
+		}
+		return true;
 	}
 
 	const char* WebRequestTracer::getTag() const
@@ -152,6 +201,11 @@ namespace core
 		return mURL;
 	}
 
+	double WebRequestTracer::getSampleRate() const
+	{
+		return mSampleRate;
+	}
+
 	int32_t WebRequestTracer::getResponseCode() const
 	{
 		return mResponseCode;
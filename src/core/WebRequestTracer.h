@@ -61,9 +61,10 @@ namespace core
 		/// @param[in] beacon @ref protocol::Beacon used to serialize the WebRequestTracer
 		/// @param[in] parentActionID parent of the WebRequestTracer
 		/// @param[in] url target url of the web request
+		/// @param[in] sampleRate the rate the web request was sampled with when it was traced
 		///
 		WebRequestTracer
-		(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t parentActionID, const UTF8String& url);
+		(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::Beacon> beacon, int32_t parentActionID, const UTF8String& url, double sampleRate = 1.0);
 
 		///
 		/// Test if given @c url contains a valid URL scheme according to RFC3986.
@@ -101,6 +102,12 @@ namespace core
 		///
 		const core::UTF8String getURL() const;
 
+		///
+		/// Returns the rate the web request was sampled with
+		/// @returns the sample rate, @c 1 if the web request is not sampled
+		///
+		double getSampleRate() const;
+
 		///
 		/// Returns the response code of the web request
 		/// @returns response code of the web request
@@ -190,6 +197,9 @@ namespace core
 		/// Dynatrace tag that has to be used for tracing the web request
 		UTF8String mWebRequestTag;
 
+		/// rate the web request was sampled with
+		double mSampleRate;
+
 	protected:
 		/// The target URL of the web request
 		UTF8String mURL;
@@ -0,0 +1,151 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "AdaptiveCompressor.h"
+#include "Compressor.h"
+
+#include <chrono>
+
+using namespace core::util;
+
+constexpr size_t AdaptiveCompressor::DEFAULT_MIN_COMPRESSION_SIZE;
+constexpr int64_t AdaptiveCompressor::DEFAULT_TRANSFER_COST_PER_BYTE_IN_NANOSECONDS;
+constexpr uint32_t AdaptiveCompressor::PROBE_INTERVAL;
+
+const std::array<int32_t, 4> AdaptiveCompressor::COMPRESSION_LEVELS =
+{
+	{
+		base::util::Compressor::FASTEST_COMPRESSION_LEVEL,
+		3,
+		base::util::Compressor::DEFAULT_COMPRESSION_LEVEL,
+		base::util::Compressor::BEST_COMPRESSION_LEVEL
+	}
+};
+
+/// weight of the most recent sample in the moving averages
+static const double SMOOTHING_FACTOR = 0.2;
+
+AdaptiveCompressor::AdaptiveCompressor()
+	: AdaptiveCompressor(DEFAULT_MIN_COMPRESSION_SIZE, DEFAULT_TRANSFER_COST_PER_BYTE_IN_NANOSECONDS)
+{
+}
+
+AdaptiveCompressor::AdaptiveCompressor(size_t minCompressionSize, int64_t transferCostPerByteInNanoseconds)
+	: mMinCompressionSize(minCompressionSize)
+	, mTransferCostPerByteInNanoseconds(transferCostPerByteInNanoseconds)
+	, mStatistics()
+	, mBestIndex(2) // start with the default compression level
+	, mNumCompressions(0)
+	, mMutex()
+{
+}
+
+bool AdaptiveCompressor::compress(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData)
+{
+	if (inDataSize < mMinCompressionSize)
+	{
+		return false;
+	}
+
+	auto compressionLevel = nextCompressionLevel();
+
+	auto start = std::chrono::steady_clock::now();
+	base::util::Compressor::compressMemory(inData, inDataSize, outData, compressionLevel);
+	auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+	recordCompression(compressionLevel, inDataSize, outData.size(), duration.count());
+
+	// incompressible data is sent as is
+	return outData.size() < inDataSize;
+}
+
+void AdaptiveCompressor::recordCompression(int32_t compressionLevel, size_t inDataSize, size_t outDataSize, int64_t durationInNanoseconds)
+{
+	if (inDataSize == 0)
+	{
+		return;
+	}
+
+	auto nanosecondsPerByte = static_cast<double>(durationInNanoseconds) / static_cast<double>(inDataSize);
+	auto compressionRatio = static_cast<double>(outDataSize) / static_cast<double>(inDataSize);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (size_t i = 0; i < COMPRESSION_LEVELS.size(); i++)
+	{
+		if (COMPRESSION_LEVELS[i] != compressionLevel)
+		{
+			continue;
+		}
+
+		auto& statistics = mStatistics[i];
+		if (statistics.numSamples == 0)
+		{
+			statistics.nanosecondsPerByte = nanosecondsPerByte;
+			statistics.compressionRatio = compressionRatio;
+		}
+		else
+		{
+			statistics.nanosecondsPerByte += SMOOTHING_FACTOR * (nanosecondsPerByte - statistics.nanosecondsPerByte);
+			statistics.compressionRatio += SMOOTHING_FACTOR * (compressionRatio - statistics.compressionRatio);
+		}
+		statistics.numSamples++;
+		break;
+	}
+
+	// pick the cheapest level among those having statistics
+	for (size_t i = 0; i < mStatistics.size(); i++)
+	{
+		if (mStatistics[i].numSamples > 0
+			&& (mStatistics[mBestIndex].numSamples == 0 || estimateCost(mStatistics[i]) < estimateCost(mStatistics[mBestIndex])))
+		{
+			mBestIndex = i;
+		}
+	}
+}
+
+int32_t AdaptiveCompressor::getCompressionLevel() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return COMPRESSION_LEVELS[mBestIndex];
+}
+
+size_t AdaptiveCompressor::getMinCompressionSize() const
+{
+	return mMinCompressionSize;
+}
+
+int32_t AdaptiveCompressor::nextCompressionLevel()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mNumCompressions++;
+
+	if (mNumCompressions % PROBE_INTERVAL != 0)
+	{
+		return COMPRESSION_LEVELS[mBestIndex];
+	}
+
+	// probe the lower and the higher neighbour in turns
+	auto probeLower = (mNumCompressions / PROBE_INTERVAL) % 2 == 1;
+	if ((probeLower && mBestIndex > 0) || mBestIndex + 1 >= COMPRESSION_LEVELS.size())
+	{
+		return COMPRESSION_LEVELS[mBestIndex - 1];
+	}
+	return COMPRESSION_LEVELS[mBestIndex + 1];
+}
+
+double AdaptiveCompressor::estimateCost(const LevelStatistics& statistics) const
+{
+	return statistics.nanosecondsPerByte + statistics.compressionRatio * static_cast<double>(mTransferCostPerByteInNanoseconds);
+}
@@ -0,0 +1,139 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef _CORE_UTIL_ADAPTIVECOMPRESSOR_H
+#define _CORE_UTIL_ADAPTIVECOMPRESSOR_H
+
+#include "OpenKit/ICompressor.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+namespace core
+{
+	namespace util
+	{
+		///
+		/// Compressor choosing the gzip compression level per request.
+		///
+		/// For each candidate level the time spent compressing and the achieved compression ratio are tracked
+		/// as moving averages. The level with the lowest estimated cost, which is the compression time plus the
+		/// time needed to transfer the compressed bytes, is used for the next requests. Neighbouring levels are
+		/// probed from time to time, so that the choice follows changes of the payload.
+		/// Payloads smaller than the minimum compression size are not compressed at all, since the gzip
+		/// header and trailer outweigh the savings.
+		///
+		class AdaptiveCompressor : public openkit::ICompressor
+		{
+		public:
+
+			///
+			/// Constructor using the default settings
+			///
+			AdaptiveCompressor();
+
+			///
+			/// Constructor
+			/// @param[in] minCompressionSize payloads smaller than this number of bytes are sent uncompressed
+			/// @param[in] transferCostPerByteInNanoseconds estimated time to transfer a single byte, used to weigh
+			///            bytes saved against compression time
+			///
+			AdaptiveCompressor(size_t minCompressionSize, int64_t transferCostPerByteInNanoseconds);
+
+			bool compress(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData) override;
+
+			///
+			/// Updates the statistics of a compression level with the result of a compression.
+			/// @param[in] compressionLevel the compression level used
+			/// @param[in] inDataSize the uncompressed size in bytes
+			/// @param[in] outDataSize the compressed size in bytes
+			/// @param[in] durationInNanoseconds the time spent compressing
+			///
+			void recordCompression(int32_t compressionLevel, size_t inDataSize, size_t outDataSize, int64_t durationInNanoseconds);
+
+			///
+			/// Returns the compression level currently considered to be the cheapest one
+			/// @returns the zlib compression level
+			///
+			int32_t getCompressionLevel() const;
+
+			///
+			/// Returns the minimum size of payloads to compress
+			/// @returns the minimum compression size in bytes
+			///
+			size_t getMinCompressionSize() const;
+
+			/// default minimum size of payloads to compress
+			static constexpr size_t DEFAULT_MIN_COMPRESSION_SIZE = 256;
+
+			/// default estimated time to transfer a single byte (corresponds to roughly 2 MB/s)
+			static constexpr int64_t DEFAULT_TRANSFER_COST_PER_BYTE_IN_NANOSECONDS = 500;
+
+			/// number of requests after which a neighbouring compression level is probed
+			static constexpr uint32_t PROBE_INTERVAL = 32;
+
+		private:
+
+			/// statistics of a single compression level
+			struct LevelStatistics
+			{
+				/// number of compressions using this level
+				uint32_t numSamples;
+
+				/// moving average of compression time per uncompressed byte
+				double nanosecondsPerByte;
+
+				/// moving average of compressed size divided by uncompressed size
+				double compressionRatio;
+			};
+
+			///
+			/// Picks the compression level for the next request
+			/// @returns the zlib compression level
+			///
+			int32_t nextCompressionLevel();
+
+			///
+			/// Returns the estimated cost of compressing and transferring a single byte of payload.
+			/// Must be called with @c mMutex held.
+			///
+			double estimateCost(const LevelStatistics& statistics) const;
+
+			/// candidate compression levels, in ascending order
+			static const std::array<int32_t, 4> COMPRESSION_LEVELS;
+
+			/// payloads smaller than this size are sent uncompressed
+			const size_t mMinCompressionSize;
+
+			/// estimated time to transfer a single byte
+			const int64_t mTransferCostPerByteInNanoseconds;
+
+			/// statistics for each candidate in @c COMPRESSION_LEVELS
+			std::array<LevelStatistics, 4> mStatistics;
+
+			/// index of the cheapest compression level
+			size_t mBestIndex;
+
+			/// number of compressions so far
+			uint32_t mNumCompressions;
+
+			/// mutex protecting the statistics
+			mutable std::mutex mMutex;
+		};
+	}
+}
+
+#endif
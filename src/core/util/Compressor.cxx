@@ -24,54 +24,81 @@ using namespace base::util;
 
 #define WINDOW_BITS   15
 #define GZIP_ENCODING 16
+#define MEMORY_LEVEL  8
 
-void Compressor::compressMemory(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData)
-{
-	std::vector<uint8_t> buffer;
+constexpr int32_t Compressor::FASTEST_COMPRESSION_LEVEL;
+constexpr int32_t Compressor::DEFAULT_COMPRESSION_LEVEL;
+constexpr int32_t Compressor::BEST_COMPRESSION_LEVEL;
 
-	const size_t BUFSIZE = 128 * 1024;
-	uint8_t tmpBuffer[BUFSIZE];
+void Compressor::compressMemory(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData, int32_t compressionLevel)
+{
+	if (compressionLevel < FASTEST_COMPRESSION_LEVEL || compressionLevel > BEST_COMPRESSION_LEVEL)
+	{
+		compressionLevel = DEFAULT_COMPRESSION_LEVEL;
+	}
 
 	z_stream strm;
 	strm.zalloc = 0;
 	strm.zfree = 0;
+	strm.opaque = 0;
+
+	// Use GZIP with the given compresssion level
+	int32_t res = deflateInit2(&strm, compressionLevel, Z_DEFLATED, WINDOW_BITS | GZIP_ENCODING, MEMORY_LEVEL, Z_DEFAULT_STRATEGY);
+	assert(res == Z_OK);
+	(void)res;
+
+	// deflateBound includes the gzip header and trailer
+	outData.resize(deflateBound(&strm, static_cast<uLong>(inDataSize)));
+
 	strm.next_in = (Bytef*)inData;
-	strm.avail_in = inDataSize;
-	strm.next_out = tmpBuffer;
-	strm.avail_out = BUFSIZE;
+	strm.avail_in = static_cast<uInt>(inDataSize);
+	strm.next_out = outData.data();
+	strm.avail_out = static_cast<uInt>(outData.size());
 
-	// Use GZIP with default compresssion
-	deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, WINDOW_BITS | GZIP_ENCODING, 8, Z_DEFAULT_STRATEGY);
+	// the output buffer is large enough to hold all the data, thus a single call suffices
+	int32_t deflateResult = deflate(&strm, Z_FINISH);
+	assert(deflateResult == Z_STREAM_END);
+	(void)deflateResult;
+
+	outData.resize(outData.size() - strm.avail_out);
+	deflateEnd(&strm);
+}
 
-	int32_t res = Z_OK;
-	while (strm.avail_in != 0 && res == Z_OK)
+bool Compressor::decompressMemory(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData)
+{
+	z_stream strm;
+	strm.zalloc = 0;
+	strm.zfree = 0;
+	strm.opaque = 0;
+	strm.next_in = (Bytef*)inData;
+	strm.avail_in = static_cast<uInt>(inDataSize);
+	if (inflateInit2(&strm, WINDOW_BITS | GZIP_ENCODING) != Z_OK)
 	{
-		res = deflate(&strm, Z_NO_FLUSH);
-		assert(res == Z_OK);
-		if (strm.avail_out == 0)
-		{
-			buffer.insert(buffer.end(), tmpBuffer, tmpBuffer + BUFSIZE);
-			strm.next_out = tmpBuffer;
-			strm.avail_out = BUFSIZE;
-		}
+		return false;
 	}
 
-	uint32_t deflateResult = Z_OK;
-	do
+	// beacon data compresses well, start with a buffer a few times the size of the input and grow it as needed
+	outData.resize(inDataSize * 4 + 64);
+	size_t outDataSize = 0;
+	int32_t inflateResult = Z_OK;
+	while (inflateResult == Z_OK)
 	{
-		if (strm.avail_out == 0)
+		if (outDataSize == outData.size())
 		{
-			buffer.insert(buffer.end(), tmpBuffer, tmpBuffer + BUFSIZE);
-			strm.next_out = tmpBuffer;
-			strm.avail_out = BUFSIZE;
+			outData.resize(outData.size() * 2);
 		}
-		deflateResult = deflate(&strm, Z_FINISH);
-	} while (deflateResult == Z_OK);
-
-	assert(deflateResult == Z_STREAM_END);
-	buffer.insert(buffer.end(), tmpBuffer, tmpBuffer + BUFSIZE - strm.avail_out);
-	deflateEnd(&strm);
+		strm.next_out = outData.data() + outDataSize;
+		strm.avail_out = static_cast<uInt>(outData.size() - outDataSize);
+		inflateResult = inflate(&strm, Z_NO_FLUSH);
+		outDataSize = outData.size() - strm.avail_out;
+		if (inflateResult == Z_STREAM_END && strm.avail_in > 0)
+		{
+			// concatenated gzip members, e.g. a replayed chunk preceded by its fresh prefix
+			inflateResult = inflateReset(&strm);
+		}
+	}
+	inflateEnd(&strm);
 
-	outData.swap(buffer);
+	outData.resize(outDataSize);
+	return inflateResult == Z_STREAM_END;
 }
-
@@ -19,6 +19,7 @@
 
 #include <vector>
 #include <cstddef>
+#include <cstdint>
 
 namespace base
 {
@@ -32,12 +33,34 @@ namespace base
 		public:
 
 			///
-			/// Compress block of memory at in_data with a length of @c inDataSize bytes 
+			/// Compress block of memory at in_data with a length of @c inDataSize bytes in gzip format
+			/// @remarks The data is compressed in one shot into an output buffer sized by zlib's upper bound
+			///          for the compressed size, thus no intermediate buffers are needed.
 			/// @param[in] inData pointer to the incoming data
 			/// @param[in] inDataSize size of data behind the pointer (measured in bytes)
 			/// @param[out] out_data binary_data struct passed as reference that will contain the compressed data.
+			/// @param[in] compressionLevel zlib compression level between @ref FASTEST_COMPRESSION_LEVEL and @ref BEST_COMPRESSION_LEVEL
 			///
-			static void compressMemory(const void *inData, size_t inDataSize, std::vector<unsigned char>& out_data);
+			static void compressMemory(const void *inData, size_t inDataSize, std::vector<unsigned char>& out_data, int32_t compressionLevel = DEFAULT_COMPRESSION_LEVEL);
+
+			///
+			/// Decompress gzip compressed data, e.g. stored beacon data which has to be sent uncompressed
+			/// @remarks Concatenated gzip members are decompressed one after the other.
+			/// @param[in] inData pointer to the gzip compressed data
+			/// @param[in] inDataSize size of data behind the pointer (measured in bytes)
+			/// @param[out] outData the decompressed data
+			/// @returns @c true if the data was decompressed, @c false if it is not valid gzip data
+			///
+			static bool decompressMemory(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData);
+
+			/// fastest compression level
+			static constexpr int32_t FASTEST_COMPRESSION_LEVEL = 1;
+
+			/// zlib's default compression level, a trade-off between speed and compression
+			static constexpr int32_t DEFAULT_COMPRESSION_LEVEL = 6;
+
+			/// best compression level
+			static constexpr int32_t BEST_COMPRESSION_LEVEL = 9;
 		};
 	}
 	
@@ -0,0 +1,35 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "GzipCompressor.h"
+#include "Compressor.h"
+
+using namespace core::util;
+
+GzipCompressor::GzipCompressor(int32_t compressionLevel)
+	: mCompressionLevel(compressionLevel)
+{
+}
+
+bool GzipCompressor::compress(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData)
+{
+	base::util::Compressor::compressMemory(inData, inDataSize, outData, mCompressionLevel);
+	return true;
+}
+
+int32_t GzipCompressor::getCompressionLevel() const
+{
+	return mCompressionLevel;
+}
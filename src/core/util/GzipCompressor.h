@@ -0,0 +1,55 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef _CORE_UTIL_GZIPCOMPRESSOR_H
+#define _CORE_UTIL_GZIPCOMPRESSOR_H
+
+#include "OpenKit/ICompressor.h"
+
+#include <cstdint>
+
+namespace core
+{
+	namespace util
+	{
+		///
+		/// Compressor using zlib's gzip compression with a fixed compression level
+		///
+		class GzipCompressor : public openkit::ICompressor
+		{
+		public:
+
+			///
+			/// Constructor taking the compression level
+			/// @param[in] compressionLevel zlib compression level between 1 (fastest) and 9 (best compression)
+			///
+			GzipCompressor(int32_t compressionLevel);
+
+			bool compress(const void* inData, size_t inDataSize, std::vector<unsigned char>& outData) override;
+
+			///
+			/// Returns the compression level
+			/// @returns the zlib compression level
+			///
+			int32_t getCompressionLevel() const;
+
+		private:
+			/// the compression level
+			const int32_t mCompressionLevel;
+		};
+	}
+}
+
+#endif
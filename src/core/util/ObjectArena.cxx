@@ -0,0 +1,202 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "ObjectArena.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace core::util;
+
+const std::size_t ObjectArena::MIN_CHUNK_SIZE;
+const std::size_t ObjectArena::MAX_CHUNK_SIZE;
+
+/// maximum number of bytes kept in the chunk pool
+static const std::size_t MAX_POOLED_BYTES = 4 * 1024 * 1024;
+
+///
+/// Chunks released by destroyed arenas, kept for reuse by other arenas
+///
+struct ObjectArenaChunkPool
+{
+	ObjectArenaChunkPool()
+		: chunks()
+		, numBytes(0)
+		, mutex()
+	{
+	}
+
+	/// pooled chunks by their size
+	std::vector<std::pair<std::size_t, std::unique_ptr<unsigned char[]>>> chunks;
+
+	/// size of all pooled chunks
+	std::size_t numBytes;
+
+	/// mutex guarding the pooled chunks
+	std::mutex mutex;
+};
+
+///
+/// Returns the pool shared by all arenas
+/// @remarks The pool is never destroyed, since arenas may be destroyed during static destruction.
+///
+static ObjectArenaChunkPool& getChunkPool()
+{
+	static ObjectArenaChunkPool* pool = new ObjectArenaChunkPool();
+	return *pool;
+}
+
+/// source of the shard indices assigned to threads
+static std::atomic<std::size_t> gNextShardIndex(0);
+
+ObjectArena::ObjectArena()
+	: mShards()
+{
+}
+
+ObjectArena::~ObjectArena()
+{
+	auto& pool = getChunkPool();
+	std::lock_guard<std::mutex> lock(pool.mutex);
+	for (auto& shard : mShards)
+	{
+		for (auto& chunk : shard.chunks)
+		{
+			if (pool.numBytes + chunk.size > MAX_POOLED_BYTES)
+			{
+				return; // the remaining chunks are released to the system
+			}
+			pool.numBytes += chunk.size;
+			pool.chunks.push_back(std::make_pair(chunk.size, std::move(chunk.memory)));
+		}
+	}
+}
+
+ObjectArena::Shard& ObjectArena::getThreadShard()
+{
+	static thread_local std::size_t shardIndex = gNextShardIndex++ % NUMBER_OF_SHARDS;
+	return mShards[shardIndex];
+}
+
+void* ObjectArena::allocate(std::size_t size)
+{
+	if (size > MAX_BLOCK_SIZE)
+	{
+		return ::operator new(size);
+	}
+
+	auto sizeClass = size == 0 ? 0 : (size - 1) / BLOCK_ALIGNMENT;
+	auto blockSize = (sizeClass + 1) * BLOCK_ALIGNMENT;
+
+	auto& shard = getThreadShard();
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto freeBlock = shard.freeBlocks[sizeClass];
+	if (freeBlock != nullptr)
+	{
+		shard.freeBlocks[sizeClass] = freeBlock->next;
+		return freeBlock;
+	}
+
+	if (shard.numRemainingBytes < blockSize)
+	{
+		// the rest of the current chunk is too small, it is left unused
+		auto chunkSize = shard.chunks.empty() ? MIN_CHUNK_SIZE : std::min(shard.chunks.back().size * 2, MAX_CHUNK_SIZE);
+		chunkSize = std::max(chunkSize, blockSize);
+
+		std::unique_ptr<unsigned char[]> memory;
+		{
+			auto& pool = getChunkPool();
+			std::lock_guard<std::mutex> poolLock(pool.mutex);
+			auto it = std::find_if(pool.chunks.begin(), pool.chunks.end(),
+				[chunkSize](const std::pair<std::size_t, std::unique_ptr<unsigned char[]>>& chunk) { return chunk.first == chunkSize; });
+			if (it != pool.chunks.end())
+			{
+				memory = std::move(it->second);
+				pool.numBytes -= chunkSize;
+				pool.chunks.erase(it);
+			}
+		}
+		if (memory == nullptr)
+		{
+			memory.reset(new unsigned char[chunkSize + BLOCK_ALIGNMENT]);
+		}
+
+		auto address = reinterpret_cast<std::uintptr_t>(memory.get());
+		auto padding = (BLOCK_ALIGNMENT - address % BLOCK_ALIGNMENT) % BLOCK_ALIGNMENT;
+		shard.nextBlock = memory.get() + padding;
+		shard.numRemainingBytes = chunkSize;
+		shard.chunks.push_back(Chunk(std::move(memory), chunkSize));
+	}
+
+	auto block = shard.nextBlock;
+	shard.nextBlock += blockSize;
+	shard.numRemainingBytes -= blockSize;
+	return block;
+}
+
+void ObjectArena::deallocate(void* block, std::size_t size)
+{
+	if (block == nullptr)
+	{
+		return;
+	}
+	if (size > MAX_BLOCK_SIZE)
+	{
+		::operator delete(block);
+		return;
+	}
+
+	// blocks of one size class are interchangeable, so the block is reused by the releasing thread's shard
+	auto sizeClass = size == 0 ? 0 : (size - 1) / BLOCK_ALIGNMENT;
+	auto freeBlock = static_cast<FreeBlock*>(block);
+
+	auto& shard = getThreadShard();
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	freeBlock->next = shard.freeBlocks[sizeClass];
+	shard.freeBlocks[sizeClass] = freeBlock;
+}
+
+std::size_t ObjectArena::getNumChunks() const
+{
+	std::size_t numChunks = 0;
+	for (const auto& shard : mShards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		numChunks += shard.chunks.size();
+	}
+	return numChunks;
+}
+
+std::size_t ObjectArena::getNumChunkBytes() const
+{
+	std::size_t numBytes = 0;
+	for (const auto& shard : mShards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		for (const auto& chunk : shard.chunks)
+		{
+			numBytes += chunk.size;
+		}
+	}
+	return numBytes;
+}
+
+std::size_t ObjectArena::getNumPooledChunks()
+{
+	auto& pool = getChunkPool();
+	std::lock_guard<std::mutex> lock(pool.mutex);
+	return pool.chunks.size();
+}
@@ -0,0 +1,269 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _CORE_UTIL_OBJECTARENA_H
+#define _CORE_UTIL_OBJECTARENA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+	namespace util
+	{
+		///
+		/// Arena for the short-lived objects of a session, like actions and web request tracers.
+		///
+		/// Memory is taken in chunks and carved into blocks of a few size classes. Released blocks are kept in a free list
+		/// per size class and reused by the next allocation of that size, so that entering and leaving actions does not
+		/// allocate from the system once the arena is warmed up.
+		///
+		/// The arena is split into shards with their own lock, free lists and chunk, and each thread uses one shard, so
+		/// that threads reporting into the same session do not contend for one lock. A shard starts with a small chunk
+		/// and doubles the chunk size up to @c MAX_CHUNK_SIZE, so that sessions with few objects stay small. Chunks are
+		/// taken from and, once the arena is destroyed, returned to a pool shared by all arenas, so that short sessions
+		/// do not allocate from the system either.
+		///
+		class ObjectArena
+		{
+		public:
+			///
+			/// Constructor creating an empty arena
+			///
+			ObjectArena();
+
+			///
+			/// Destructor releasing all chunks
+			///
+			~ObjectArena();
+
+			ObjectArena(const ObjectArena&) = delete;
+			ObjectArena& operator=(const ObjectArena&) = delete;
+
+			///
+			/// Allocates a block
+			/// @param[in] size the size of the block in bytes
+			/// @returns the block, aligned for any fundamental type
+			///
+			void* allocate(std::size_t size);
+
+			///
+			/// Releases a block for reuse
+			/// @param[in] block a block returned by @ref allocate
+			/// @param[in] size the size the block was allocated with
+			///
+			void deallocate(void* block, std::size_t size);
+
+			///
+			/// Returns the number of chunks held by the arena
+			/// @returns the number of chunks
+			///
+			std::size_t getNumChunks() const;
+
+			///
+			/// Returns the size of all chunks held by the arena
+			/// @returns the number of bytes
+			///
+			std::size_t getNumChunkBytes() const;
+
+			///
+			/// Returns the number of chunks kept in the shared pool for reuse by other arenas
+			/// @returns the number of pooled chunks
+			///
+			static std::size_t getNumPooledChunks();
+
+			/// size of the first chunk of a shard
+			static const std::size_t MIN_CHUNK_SIZE = 1024;
+
+			/// size the chunks of a shard grow to
+			static const std::size_t MAX_CHUNK_SIZE = 16 * 1024;
+
+		private:
+			/// alignment and granularity of blocks
+			static const std::size_t BLOCK_ALIGNMENT = 16;
+
+			/// blocks larger than this are allocated directly from the system
+			static const std::size_t MAX_BLOCK_SIZE = 1024;
+
+			/// number of size classes
+			static const std::size_t NUMBER_OF_SIZE_CLASSES = MAX_BLOCK_SIZE / BLOCK_ALIGNMENT;
+
+			/// number of shards
+			static const std::size_t NUMBER_OF_SHARDS = 8;
+
+			///
+			/// Released block linking to the next released block of the same size class
+			///
+			struct FreeBlock
+			{
+				FreeBlock* next;
+			};
+
+			///
+			/// Memory taken from the pool
+			///
+			struct Chunk
+			{
+				Chunk()
+					: memory()
+					, size(0)
+				{
+				}
+
+				Chunk(std::unique_ptr<unsigned char[]> memory, std::size_t size)
+					: memory(std::move(memory))
+					, size(size)
+				{
+				}
+
+				/// the memory, with room for aligning the first block
+				std::unique_ptr<unsigned char[]> memory;
+
+				/// the usable size in bytes
+				std::size_t size;
+			};
+
+			///
+			/// Part of the arena used by some of the threads
+			///
+			struct Shard
+			{
+				Shard()
+					: freeBlocks()
+					, chunks()
+					, nextBlock(nullptr)
+					, numRemainingBytes(0)
+					, mutex()
+				{
+					freeBlocks.fill(nullptr);
+				}
+
+				Shard(const Shard&) = delete;
+				Shard& operator=(const Shard&) = delete;
+
+				/// released blocks per size class
+				std::array<FreeBlock*, NUMBER_OF_SIZE_CLASSES> freeBlocks;
+
+				/// chunks taken from the pool
+				std::vector<Chunk> chunks;
+
+				/// start of the not yet used part of the current chunk
+				unsigned char* nextBlock;
+
+				/// number of not yet used bytes in the current chunk
+				std::size_t numRemainingBytes;
+
+				/// mutex guarding the free lists and chunks of the shard
+				mutable std::mutex mutex;
+			};
+
+			///
+			/// Returns the shard used by the calling thread
+			///
+			Shard& getThreadShard();
+
+			/// the shards
+			std::array<Shard, NUMBER_OF_SHARDS> mShards;
+		};
+
+		///
+		/// Standard allocator taking its memory from an @ref ObjectArena, to be used with @c std::allocate_shared.
+		///
+		/// Each allocator keeps the arena alive, so an object allocated with @c std::allocate_shared, which stores a copy
+		/// of the allocator along with the object, can outlive the owner of the arena. Without arena the memory is
+		/// allocated on the heap.
+		///
+		template <class T> class ArenaAllocator
+		{
+		public:
+			typedef T value_type;
+			typedef std::true_type propagate_on_container_copy_assignment;
+			typedef std::true_type propagate_on_container_move_assignment;
+			typedef std::true_type propagate_on_container_swap;
+
+			ArenaAllocator()
+				: mArena()
+			{
+			}
+
+			ArenaAllocator(std::shared_ptr<ObjectArena> arena)
+				: mArena(arena)
+			{
+			}
+
+			template <class U> ArenaAllocator(const ArenaAllocator<U>& other)
+				: mArena(other.mArena)
+			{
+			}
+
+			T* allocate(std::size_t n)
+			{
+				if (mArena == nullptr)
+				{
+					return static_cast<T*>(::operator new(n * sizeof(T)));
+				}
+				return static_cast<T*>(mArena->allocate(n * sizeof(T)));
+			}
+
+			void deallocate(T* pointer, std::size_t n)
+			{
+				if (mArena == nullptr)
+				{
+					::operator delete(pointer);
+					return;
+				}
+				mArena->deallocate(pointer, n * sizeof(T));
+			}
+
+			template <class U> bool operator==(const ArenaAllocator<U>& other) const
+			{
+				return mArena == other.mArena;
+			}
+
+			template <class U> bool operator!=(const ArenaAllocator<U>& other) const
+			{
+				return mArena != other.mArena;
+			}
+
+		private:
+			template <class U> friend class ArenaAllocator;
+
+			/// the arena to allocate from
+			std::shared_ptr<ObjectArena> mArena;
+		};
+
+		///
+		/// Creates a shared object in the given arena, or on the heap if there is no arena
+		/// @param[in] arena the arena to allocate from, might be @c nullptr
+		/// @param[in] args the arguments passed to the constructor of @c T
+		/// @returns the created object
+		///
+		template <class T, class... Args> std::shared_ptr<T> allocateShared(const std::shared_ptr<ObjectArena>& arena, Args&&... args)
+		{
+			if (arena == nullptr)
+			{
+				return std::make_shared<T>(std::forward<Args>(args)...);
+			}
+			return std::allocate_shared<T>(ArenaAllocator<T>(arena), std::forward<Args>(args)...);
+		}
+	}
+}
+#endif
@@ -0,0 +1,235 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _CORE_UTIL_OPENACTIONSET_H
+#define _CORE_UTIL_OPENACTIONSET_H
+
+#include "core/util/ObjectArena.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace core
+{
+	namespace util
+	{
+		///
+		/// Set of actions which were entered but not yet left.
+		///
+		/// The set is intrusive: each element carries a @ref Hook, returned by its @c getOpenActionHook method, which
+		/// remembers where the element is stored. Inserting and removing an element is therefore O(1), independent of
+		/// the number of open actions. Elements are spread round-robin over a fixed number of shards with a lock each,
+		/// which is only held to link or unlink a single preallocated node, so that concurrently entered and left
+		/// actions rarely contend for the same lock. The nodes are taken from the session's @ref ObjectArena.
+		///
+		/// @param T type of the elements, providing a @c Hook& getOpenActionHook() method
+		///
+		template <class T> class OpenActionSet
+		{
+		public:
+			class Hook;
+
+		private:
+			///
+			/// An element with the number it was inserted as
+			///
+			struct Entry
+			{
+				uint64_t sequenceNumber;
+				std::shared_ptr<T> item;
+				Hook* hook;
+			};
+
+			typedef std::list<Entry, ArenaAllocator<Entry>> entry_list;
+
+		public:
+			///
+			/// Position of an element within the set, to be embedded into the element
+			///
+			class Hook
+			{
+			public:
+				Hook()
+					: mShard(NOT_LINKED)
+					, mPosition()
+				{
+				}
+
+				Hook(const Hook&) = delete;
+				Hook& operator=(const Hook&) = delete;
+
+			private:
+				friend class OpenActionSet<T>;
+
+				/// index of the shard storing the element, or @c NOT_LINKED
+				std::atomic<int32_t> mShard;
+
+				/// position of the element within its shard, guarded by the shard's lock
+				typename entry_list::iterator mPosition;
+			};
+
+			///
+			/// Constructor creating an empty set
+			/// @param[in] arena arena to allocate the nodes from, or @c nullptr to allocate them on the heap
+			///
+			OpenActionSet(std::shared_ptr<ObjectArena> arena = nullptr)
+				: mAllocator(arena)
+				, mShards()
+				, mNextSequenceNumber(0)
+				, mSize(0)
+			{
+				for (auto& shard : mShards)
+				{
+					shard.entries = entry_list(mAllocator);
+				}
+			}
+
+			OpenActionSet(const OpenActionSet&) = delete;
+			OpenActionSet& operator=(const OpenActionSet&) = delete;
+
+			///
+			/// Adds an element to the set
+			/// @param[in] item the element to add, which must not be part of a set
+			///
+			void insert(const std::shared_ptr<T>& item)
+			{
+				auto& hook = item->getOpenActionHook();
+				auto sequenceNumber = mNextSequenceNumber.fetch_add(1, std::memory_order_relaxed);
+				auto shardIndex = static_cast<int32_t>(sequenceNumber % NUMBER_OF_SHARDS);
+
+				// allocate the node outside of the lock, linking it is a pointer update only
+				entry_list node(mAllocator);
+				node.push_back(Entry{ sequenceNumber, item, &hook });
+
+				auto& shard = mShards[shardIndex];
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				hook.mPosition = node.begin();
+				shard.entries.splice(shard.entries.end(), node);
+				hook.mShard.store(shardIndex, std::memory_order_release);
+				mSize.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			///
+			/// Removes an element from the set
+			/// @param[in] item the element to remove
+			/// @returns @c true if the element was removed, @c false if it was not part of the set
+			///
+			bool remove(T& item)
+			{
+				auto& hook = item.getOpenActionHook();
+				auto shardIndex = hook.mShard.load(std::memory_order_acquire);
+				if (shardIndex == NOT_LINKED)
+				{
+					return false;
+				}
+
+				// the node is released outside of the lock, as it might hold the last reference to the element
+				entry_list node(mAllocator);
+				auto& shard = mShards[shardIndex];
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				if (hook.mShard.load(std::memory_order_relaxed) != shardIndex)
+				{
+					// removed by a concurrent call to removeAll
+					return false;
+				}
+				node.splice(node.end(), shard.entries, hook.mPosition);
+				hook.mShard.store(NOT_LINKED, std::memory_order_relaxed);
+				mSize.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+
+			///
+			/// Removes all elements from the set, locking each shard only once
+			/// @returns the removed elements in the order they were inserted
+			///
+			std::vector<std::shared_ptr<T>> removeAll()
+			{
+				entry_list removed(mAllocator);
+				for (auto& shard : mShards)
+				{
+					std::lock_guard<std::mutex> lock(shard.mutex);
+					for (auto& entry : shard.entries)
+					{
+						entry.hook->mShard.store(NOT_LINKED, std::memory_order_relaxed);
+					}
+					mSize.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+					removed.splice(removed.end(), shard.entries);
+				}
+
+				removed.sort([](const Entry& lhs, const Entry& rhs) { return lhs.sequenceNumber < rhs.sequenceNumber; });
+
+				std::vector<std::shared_ptr<T>> items;
+				items.reserve(removed.size());
+				for (auto& entry : removed)
+				{
+					items.push_back(std::move(entry.item));
+				}
+				return items;
+			}
+
+			///
+			/// Check if the set is empty, without taking any lock
+			/// @returns @c true if the set is empty @c false otherwise
+			///
+			bool isEmpty() const
+			{
+				return mSize.load(std::memory_order_relaxed) == 0;
+			}
+
+		private:
+			/// number of shards the elements are distributed to
+			static const std::size_t NUMBER_OF_SHARDS = 8;
+
+			/// shard index of an element not being part of a set
+			static const int32_t NOT_LINKED = -1;
+
+			///
+			/// Part of the set guarded by its own lock
+			///
+			struct Shard
+			{
+				Shard()
+					: mutex()
+					, entries()
+				{
+				}
+
+				std::mutex mutex;
+				entry_list entries;
+			};
+
+			/// allocator of the nodes
+			ArenaAllocator<Entry> mAllocator;
+
+			/// the shards of this set
+			std::array<Shard, NUMBER_OF_SHARDS> mShards;
+
+			/// number assigned to the next inserted element
+			std::atomic<uint64_t> mNextSequenceNumber;
+
+			/// number of elements in the set
+			std::atomic<std::size_t> mSize;
+		};
+	}
+}
+#endif
@@ -0,0 +1,132 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _CORE_UTIL_SINGLEPRODUCERQUEUE_H
+#define _CORE_UTIL_SINGLEPRODUCERQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+namespace core
+{
+	namespace util
+	{
+		///
+		/// Unbounded lock-free FIFO queue for exactly one producer thread and one consumer thread at a time.
+		///
+		/// The producer only touches the tail and the consumer only touches the head, so neither of them ever waits for
+		/// the other. The queue always holds one stub node; a pushed item becomes visible to the consumer when the
+		/// producer publishes the link to its node.
+		/// @param T type of items in the queue, must be default constructible and movable
+		///
+		template <class T> class SingleProducerQueue
+		{
+		public:
+			///
+			/// Constructor creating an empty queue
+			///
+			SingleProducerQueue()
+				: mHead(new Node())
+				, mTail(mHead)
+			{
+			}
+
+			///
+			/// Destructor releasing the remaining items
+			///
+			~SingleProducerQueue()
+			{
+				while (mHead != nullptr)
+				{
+					auto next = mHead->next.load(std::memory_order_relaxed);
+					delete mHead;
+					mHead = next;
+				}
+			}
+
+			SingleProducerQueue(const SingleProducerQueue&) = delete;
+			SingleProducerQueue& operator=(const SingleProducerQueue&) = delete;
+
+			///
+			/// Appends an item, may only be called by the producer thread
+			/// @param[in] item the item to append
+			///
+			void push(T&& item)
+			{
+				auto node = new Node();
+				node->item = std::move(item);
+				mTail->next.store(node, std::memory_order_release);
+				mTail = node;
+			}
+
+			///
+			/// Removes the first item, may only be called by the consumer thread
+			/// @param[out] item receives the removed item
+			/// @returns @c true if an item was removed, @c false if the queue is empty
+			///
+			bool pop(T& item)
+			{
+				auto next = mHead->next.load(std::memory_order_acquire);
+				if (next == nullptr)
+				{
+					return false;
+				}
+
+				// the first node becomes the new stub
+				item = std::move(next->item);
+				delete mHead;
+				mHead = next;
+				return true;
+			}
+
+			///
+			/// Returns whether the queue is empty, as seen by the consumer thread
+			/// @returns @c true if there is no item to pop, @c false otherwise
+			///
+			bool isEmpty() const
+			{
+				return mHead->next.load(std::memory_order_acquire) == nullptr;
+			}
+
+		private:
+			///
+			/// Node holding one item
+			///
+			struct Node
+			{
+				Node()
+					: item()
+					, next(nullptr)
+				{
+				}
+
+				/// the item
+				T item;
+
+				/// the following node
+				std::atomic<Node*> next;
+			};
+
+			/// stub node preceding the first item, only accessed by the consumer
+			Node* mHead;
+
+			/// last node, only accessed by the producer
+			Node* mTail;
+		};
+	}
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include <iterator>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <codecvt>
 #include <locale>
 
@@ -146,4 +147,44 @@ bool StringUtil::isHighSurrogateCharacter(int32_t character)
 bool StringUtil::isLowSurrogateCharacter(int32_t character)
 {
 	return character >= 0xDC00 && character <= 0xDFFF;
+}
+
+bool StringUtil::tryParseInt32(const char* begin, const char* end, int32_t& result)
+{
+	auto current = begin;
+
+	// skip leading whitespace
+	while (current < end && std::isspace(static_cast<unsigned char>(*current)))
+	{
+		current++;
+	}
+
+	bool isNegative = false;
+	if (current < end && (*current == '+' || *current == '-'))
+	{
+		isNegative = *current == '-';
+		current++;
+	}
+
+	// the negative range is larger by one
+	const int64_t limit = isNegative ? -int64_t(INT32_MIN) : int64_t(INT32_MAX);
+	int64_t value = 0;
+	auto digitsBegin = current;
+	while (current < end && *current >= '0' && *current <= '9')
+	{
+		value = value * 10 + (*current - '0');
+		if (value > limit)
+		{
+			return false; // out of range
+		}
+		current++;
+	}
+
+	if (current == digitsBegin)
+	{
+		return false; // no digits
+	}
+
+	result = static_cast<int32_t>(isNegative ? -value : value);
+	return true;
 }
\ No newline at end of file
@@ -17,6 +17,7 @@
 #ifndef _CORE_UTIL_STRINGUTIL_H
 #define _CORE_UTIL_STRINGUTIL_H
 
+#include <cstdint>
 #include <string>
 
 namespace core
@@ -115,6 +116,20 @@ namespace core
 			///
 			static bool isLowSurrogateCharacter(int32_t character);
 
+			///
+			/// Parses a signed decimal integer from the character range [@c begin, @c end) without allocating memory.
+			///
+			/// @par
+			/// Like @c std::stoi leading whitespace and an optional sign are accepted and parsing stops at the
+			/// first character which is not a digit. Unlike @c std::stoi no exception is thrown.
+			///
+			/// @param[in] begin pointer to the first character
+			/// @param[in] end pointer past the last character
+			/// @param[out] result the parsed value, only modified if parsing succeeded
+			/// @return @c true if at least one digit was parsed and the value fits into 32 bits, @c false otherwise
+			///
+			static bool tryParseInt32(const char* begin, const char* end, int32_t& result);
+
 		private:
 			/// utility class, not instantiable
 			StringUtil();
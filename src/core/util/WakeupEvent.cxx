@@ -0,0 +1,55 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "WakeupEvent.h"
+
+#include <chrono>
+
+using namespace core::util;
+
+WakeupEvent::WakeupEvent()
+	: mSignalled(false)
+	, mMutex()
+	, mConditionVariable()
+{
+}
+
+void WakeupEvent::signal()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	mSignalled = true;
+	mConditionVariable.notify_all();
+}
+
+bool WakeupEvent::wait(int64_t milliseconds)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	if (milliseconds < 0)
+	{
+		mConditionVariable.wait(lock, [this] { return mSignalled; });
+	}
+	else
+	{
+		mConditionVariable.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return mSignalled; });
+	}
+
+	auto signalled = mSignalled;
+	mSignalled = false;
+	return signalled;
+}
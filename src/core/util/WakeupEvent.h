@@ -0,0 +1,69 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _CORE_UTIL_WAKEUPEVENT_H
+#define _CORE_UTIL_WAKEUPEVENT_H
+
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+
+namespace core
+{
+	namespace util
+	{
+		///
+		/// WakeupEvent is an auto-reset event used to wake up a single waiting thread.
+		/// A signal raised while nobody is waiting is remembered, so that the next call to @c wait()
+		/// returns immediately and no signal gets lost between two waits.
+		///
+		class WakeupEvent
+		{
+		public:
+
+			///
+			/// Constructor
+			///
+			WakeupEvent();
+
+			///
+			/// Raise the event and wake up the waiting thread.
+			///
+			void signal();
+
+			///
+			/// Wait until the event is raised or the timeout expired and reset the event.
+			/// NOTE: This is a blocking operation
+			/// @param[in] milliseconds The maximum number of milliseconds to wait, a negative value waits until the event is raised.
+			/// @returns @c true if the event was raised, @c false if the timeout expired
+			///
+			bool wait(int64_t milliseconds);
+
+		private:
+			/// flag indicating that the event was raised
+			bool mSignalled;
+
+			/// mutex used for sychronisation
+			std::mutex mMutex;
+
+			/// condition variable used to wait for the event
+			std::condition_variable mConditionVariable;
+		};
+	}
+}
+
+#endif
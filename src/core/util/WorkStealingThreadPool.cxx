@@ -0,0 +1,129 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "WorkStealingThreadPool.h"
+
+#include <algorithm>
+
+using namespace core::util;
+
+WorkStealingThreadPool::WorkStealingThreadPool(uint32_t numThreads)
+	: mQueues()
+	, mThreads()
+	, mNextQueue(0)
+	, mMutex()
+	, mConditionVariable()
+	, mNumPendingTasks(0)
+	, mStopped(false)
+{
+	numThreads = std::max(numThreads, uint32_t(1));
+	for (uint32_t i = 0; i < numThreads; i++)
+	{
+		mQueues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+	}
+	for (uint32_t i = 0; i < numThreads; i++)
+	{
+		mThreads.push_back(std::thread(&WorkStealingThreadPool::run, this, i));
+	}
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopped = true;
+	}
+	mConditionVariable.notify_all();
+
+	for (auto& thread : mThreads)
+	{
+		thread.join();
+	}
+}
+
+void WorkStealingThreadPool::submit(std::function<void()> task)
+{
+	// queue the task before counting it, so that a counted task can always be taken by a worker
+	auto& queue = *mQueues[mNextQueue++ % mQueues.size()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mMutex);
+		queue.mTasks.push_back(std::move(task));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mNumPendingTasks++;
+	}
+	mConditionVariable.notify_one();
+}
+
+uint32_t WorkStealingThreadPool::getNumThreads() const
+{
+	return static_cast<uint32_t>(mThreads.size());
+}
+
+void WorkStealingThreadPool::run(uint32_t index)
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mConditionVariable.wait(lock, [this] { return mStopped || mNumPendingTasks > 0; });
+			if (mNumPendingTasks == 0)
+			{
+				return; // stopped and all tasks are done
+			}
+
+			// claim one of the counted tasks, each of them is queued already and no other worker can claim it
+			mNumPendingTasks--;
+		}
+
+		std::function<void()> task;
+		if (takeTask(index, task))
+		{
+			task();
+		}
+	}
+}
+
+bool WorkStealingThreadPool::takeTask(uint32_t index, std::function<void()>& task)
+{
+	{
+		auto& ownQueue = *mQueues[index];
+		std::lock_guard<std::mutex> lock(ownQueue.mMutex);
+		if (!ownQueue.mTasks.empty())
+		{
+			task = std::move(ownQueue.mTasks.front());
+			ownQueue.mTasks.pop_front();
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i < mQueues.size(); i++)
+	{
+		auto& victimQueue = *mQueues[(index + i) % mQueues.size()];
+		std::lock_guard<std::mutex> lock(victimQueue.mMutex);
+		if (!victimQueue.mTasks.empty())
+		{
+			task = std::move(victimQueue.mTasks.back());
+			victimQueue.mTasks.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
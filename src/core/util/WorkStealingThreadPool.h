@@ -0,0 +1,128 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _CORE_UTIL_WORKSTEALINGTHREADPOOL_H
+#define _CORE_UTIL_WORKSTEALINGTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+	namespace util
+	{
+		///
+		/// Fixed size pool of worker threads executing submitted tasks.
+		///
+		/// Each worker owns a task queue. Submitted tasks are distributed round robin over the queues,
+		/// a worker takes tasks from the front of its own queue and steals from the back of the other
+		/// queues once its own queue is drained, so that a worker blocked by a slow task does not hold
+		/// up the tasks queued behind it.
+		/// Tasks are not ordered relative to each other, callers requiring an order have to wait for the
+		/// completion of a task before submitting the next one.
+		///
+		class WorkStealingThreadPool
+		{
+		public:
+			///
+			/// Constructor starting the worker threads
+			/// @param[in] numThreads number of worker threads, at least one thread is started
+			///
+			WorkStealingThreadPool(uint32_t numThreads);
+
+			///
+			/// Destructor executing all pending tasks and joining the worker threads
+			///
+			~WorkStealingThreadPool();
+
+			///
+			/// Submit a task for execution by one of the workers.
+			/// @param[in] task the task to execute, which must not throw
+			///
+			void submit(std::function<void()> task);
+
+			///
+			/// Returns the number of worker threads
+			/// @returns the number of worker threads
+			///
+			uint32_t getNumThreads() const;
+
+		private:
+			///
+			/// Task queue owned by a single worker
+			///
+			struct WorkerQueue
+			{
+				WorkerQueue()
+					: mMutex()
+					, mTasks()
+				{
+				}
+
+				/// mutex guarding the tasks
+				std::mutex mMutex;
+
+				/// the queued tasks
+				std::deque<std::function<void()>> mTasks;
+			};
+
+			///
+			/// Main loop of the worker with the given index
+			/// @param[in] index index of the worker
+			///
+			void run(uint32_t index);
+
+			///
+			/// Take the next task for the given worker, stealing from the other workers if its own queue is empty.
+			/// @param[in] index index of the worker
+			/// @param[out] task the task to execute
+			/// @returns @c true if a task was taken, @c false if all queues are empty
+			///
+			bool takeTask(uint32_t index, std::function<void()>& task);
+
+			/// one task queue per worker
+			std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+
+			/// the worker threads
+			std::vector<std::thread> mThreads;
+
+			/// index of the queue receiving the next submitted task
+			std::atomic<uint32_t> mNextQueue;
+
+			/// mutex guarding mNumPendingTasks and mStopped
+			std::mutex mMutex;
+
+			/// condition variable idle workers wait on
+			std::condition_variable mConditionVariable;
+
+			/// number of queued tasks not yet claimed by a worker
+			size_t mNumPendingTasks;
+
+			/// flag indicating that the pool is shutting down
+			bool mStopped;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,198 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "protocol/AdaptiveSendingController.h"
+
+#include <algorithm>
+
+using namespace protocol;
+
+const int64_t AdaptiveSendingController::DEFAULT_SLOW_RESPONSE_THRESHOLD = -1;
+const int32_t AdaptiveSendingController::MAX_ADAPTATION_LEVEL = 2;
+const int64_t AdaptiveSendingController::CACHE_PRESSURE_ENTER_PERCENTAGE = 75;
+const int64_t AdaptiveSendingController::CACHE_PRESSURE_LEAVE_PERCENTAGE = 50;
+const int64_t AdaptiveSendingController::MIN_SEND_INTERVAL = 1000;
+const int32_t AdaptiveSendingController::MIN_MAX_BEACON_SIZE = 8 * 1024;
+
+/// weight of a new response time sample in the smoothed response time
+static const int64_t LATENCY_SMOOTHING_DIVISOR = 4;
+
+AdaptiveSendingController::AdaptiveSendingController(int64_t cacheSizeUpperBound, int64_t slowResponseThreshold)
+	: mCacheSizeUpperBound(cacheSizeUpperBound)
+	, mSlowResponseThreshold(slowResponseThreshold)
+	, mBeaconCache(nullptr)
+	, mAverageResponseLatency(-1)
+	, mIsCachePressure(false)
+	, mIsLatencyPressure(false)
+	, mLevel(0)
+	, mLastAdaptationTime(-1)
+	, mNumSendIntervalDecreases(0)
+	, mNumSendIntervalIncreases(0)
+	, mMutex()
+{
+}
+
+bool AdaptiveSendingController::isEnabled() const
+{
+	return mSlowResponseThreshold > 0;
+}
+
+void AdaptiveSendingController::setBeaconCache(std::shared_ptr<caching::IBeaconCache> beaconCache)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBeaconCache = beaconCache;
+}
+
+void AdaptiveSendingController::recordResponseLatency(int64_t latencyInMilliseconds)
+{
+	if (!isEnabled())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mAverageResponseLatency < 0)
+	{
+		mAverageResponseLatency = latencyInMilliseconds;
+	}
+	else
+	{
+		mAverageResponseLatency += (latencyInMilliseconds - mAverageResponseLatency) / LATENCY_SMOOTHING_DIVISOR;
+	}
+}
+
+void AdaptiveSendingController::evaluate(int64_t timestamp, int64_t serverSendInterval)
+{
+	if (!isEnabled())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// enter and leave each condition at different thresholds (hysteresis)
+	if (mBeaconCache != nullptr && mCacheSizeUpperBound > 0)
+	{
+		auto cacheUsagePercentage = mBeaconCache->getNumBytesInCache() * 100 / mCacheSizeUpperBound;
+		if (!mIsCachePressure && cacheUsagePercentage >= CACHE_PRESSURE_ENTER_PERCENTAGE)
+		{
+			mIsCachePressure = true;
+		}
+		else if (mIsCachePressure && cacheUsagePercentage <= CACHE_PRESSURE_LEAVE_PERCENTAGE)
+		{
+			mIsCachePressure = false;
+		}
+	}
+	if (!mIsLatencyPressure && mAverageResponseLatency >= mSlowResponseThreshold)
+	{
+		mIsLatencyPressure = true;
+	}
+	else if (mIsLatencyPressure && mAverageResponseLatency <= mSlowResponseThreshold / 2)
+	{
+		mIsLatencyPressure = false;
+	}
+
+	// a slow collector wins over cache pressure, without pressure return to the server's values
+	auto targetLevel = 0;
+	if (mIsLatencyPressure)
+	{
+		targetLevel = MAX_ADAPTATION_LEVEL;
+	}
+	else if (mIsCachePressure)
+	{
+		targetLevel = -MAX_ADAPTATION_LEVEL;
+	}
+	if (targetLevel == mLevel)
+	{
+		return;
+	}
+
+	// keep each level for at least one send interval before taking the next step
+	if (mLastAdaptationTime >= 0 && timestamp - mLastAdaptationTime < getSendInterval(serverSendInterval, mLevel))
+	{
+		return;
+	}
+
+	if (targetLevel > mLevel)
+	{
+		mLevel++;
+		mNumSendIntervalIncreases++;
+	}
+	else
+	{
+		mLevel--;
+		mNumSendIntervalDecreases++;
+	}
+	mLastAdaptationTime = timestamp;
+}
+
+int64_t AdaptiveSendingController::getSendInterval(int64_t serverSendInterval) const
+{
+	if (!isEnabled())
+	{
+		return serverSendInterval;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	return getSendInterval(serverSendInterval, mLevel);
+}
+
+int32_t AdaptiveSendingController::getMaxBeaconSize(int32_t serverMaxBeaconSize) const
+{
+	if (!isEnabled())
+	{
+		return serverMaxBeaconSize;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mLevel <= 0)
+	{
+		// fill chunks up to the server's limit
+		return serverMaxBeaconSize;
+	}
+
+	return std::max(serverMaxBeaconSize >> mLevel, std::min(serverMaxBeaconSize, MIN_MAX_BEACON_SIZE));
+}
+
+openkit::AdaptiveSendingState AdaptiveSendingController::getState(int64_t serverSendInterval, int32_t serverMaxBeaconSize) const
+{
+	openkit::AdaptiveSendingState state;
+	state.sendIntervalInMilliseconds = getSendInterval(serverSendInterval);
+	state.maxBeaconSize = getMaxBeaconSize(serverMaxBeaconSize);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	state.isEnabled = isEnabled();
+	state.isCachePressure = mIsCachePressure;
+	state.isLatencyPressure = mIsLatencyPressure;
+	state.averageResponseLatencyInMilliseconds = std::max(mAverageResponseLatency, int64_t(0));
+	state.numSendIntervalDecreases = mNumSendIntervalDecreases;
+	state.numSendIntervalIncreases = mNumSendIntervalIncreases;
+
+	return state;
+}
+
+int64_t AdaptiveSendingController::getSendInterval(int64_t serverSendInterval, int32_t level)
+{
+	if (level > 0)
+	{
+		return serverSendInterval << level;
+	}
+	if (level < 0)
+	{
+		return std::max(serverSendInterval >> -level, std::min(serverSendInterval, MIN_SEND_INTERVAL));
+	}
+	return serverSendInterval;
+}
@@ -0,0 +1,159 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _PROTOCOL_ADAPTIVESENDINGCONTROLLER_H
+#define _PROTOCOL_ADAPTIVESENDINGCONTROLLER_H
+
+#include "OpenKit/AdaptiveSendingState.h"
+#include "caching/IBeaconCache.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace protocol
+{
+	///
+	/// Adapts the send interval of open sessions and the size of beacon chunks within the limits given by the server.
+	///
+	/// The server's send interval and maximum beacon size are the nominal values. When the beacon cache gets close to
+	/// its upper memory boundary, the send interval is shortened so that data is sent before it is evicted. When the
+	/// collector responds slowly, the send interval is lengthened and chunks are made smaller to back off before the
+	/// collector starts rejecting requests. A slow collector takes precedence over cache pressure.
+	///
+	/// Both conditions are entered and left at different thresholds, and the send interval is changed by at most one
+	/// step per adapted send interval, so that the controller does not oscillate.
+	///
+	class AdaptiveSendingController
+	{
+	public:
+
+		///
+		/// Constructor
+		/// @param[in] cacheSizeUpperBound upper memory boundary of the beacon cache in bytes
+		/// @param[in] slowResponseThreshold average response time in milliseconds at which the collector is considered slow,
+		///            adaptive sending is disabled if not positive
+		///
+		AdaptiveSendingController(int64_t cacheSizeUpperBound, int64_t slowResponseThreshold);
+
+		///
+		/// Returns whether send interval and payload size are adapted at all.
+		/// @returns @c true if a slow response threshold is configured, @c false otherwise
+		///
+		bool isEnabled() const;
+
+		///
+		/// Sets the beacon cache whose memory usage is monitored.
+		/// @param[in] beaconCache the beacon cache
+		///
+		void setBeaconCache(std::shared_ptr<caching::IBeaconCache> beaconCache);
+
+		///
+		/// Records the response time of a beacon request.
+		/// @param[in] latencyInMilliseconds the time from sending the request until the response was received
+		///
+		void recordResponseLatency(int64_t latencyInMilliseconds);
+
+		///
+		/// Re-evaluates cache and latency pressure and adapts the send interval by at most one step.
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @param[in] serverSendInterval the send interval given by the server in milliseconds
+		///
+		void evaluate(int64_t timestamp, int64_t serverSendInterval);
+
+		///
+		/// Returns the send interval of open sessions to apply.
+		/// @param[in] serverSendInterval the send interval given by the server in milliseconds
+		/// @returns the adapted send interval in milliseconds
+		///
+		int64_t getSendInterval(int64_t serverSendInterval) const;
+
+		///
+		/// Returns the maximum size of a beacon chunk to apply, which never exceeds the server's limit.
+		/// @param[in] serverMaxBeaconSize the maximum beacon size given by the server in bytes
+		/// @returns the adapted maximum beacon size in bytes
+		///
+		int32_t getMaxBeaconSize(int32_t serverMaxBeaconSize) const;
+
+		///
+		/// Returns a snapshot of the current adaptation state
+		/// @param[in] serverSendInterval the send interval given by the server in milliseconds
+		/// @param[in] serverMaxBeaconSize the maximum beacon size given by the server in bytes
+		/// @returns the adaptation state
+		///
+		openkit::AdaptiveSendingState getState(int64_t serverSendInterval, int32_t serverMaxBeaconSize) const;
+
+		/// default slow response threshold (adaptive sending disabled)
+		static const int64_t DEFAULT_SLOW_RESPONSE_THRESHOLD;
+
+		/// maximum number of halving or doubling steps applied to the server's send interval
+		static const int32_t MAX_ADAPTATION_LEVEL;
+
+		/// cache usage in percent of the upper memory boundary at which cache pressure is entered
+		static const int64_t CACHE_PRESSURE_ENTER_PERCENTAGE;
+
+		/// cache usage in percent of the upper memory boundary at which cache pressure is left
+		static const int64_t CACHE_PRESSURE_LEAVE_PERCENTAGE;
+
+		/// lower bound for a shortened send interval in milliseconds
+		static const int64_t MIN_SEND_INTERVAL;
+
+		/// lower bound for a reduced maximum beacon size in bytes
+		static const int32_t MIN_MAX_BEACON_SIZE;
+
+	private:
+
+		///
+		/// Returns the send interval for the given adaptation level.
+		///
+		static int64_t getSendInterval(int64_t serverSendInterval, int32_t level);
+
+		/// upper memory boundary of the beacon cache
+		const int64_t mCacheSizeUpperBound;
+
+		/// average response time at which latency pressure is entered
+		const int64_t mSlowResponseThreshold;
+
+		/// monitored beacon cache
+		std::shared_ptr<caching::IBeaconCache> mBeaconCache;
+
+		/// exponentially smoothed response time, negative until the first response was recorded
+		int64_t mAverageResponseLatency;
+
+		/// @c true if the beacon cache is close to its upper memory boundary
+		bool mIsCachePressure;
+
+		/// @c true if the collector responds slowly
+		bool mIsLatencyPressure;
+
+		/// negative levels halve the send interval, positive levels double it and halve the beacon size
+		int32_t mLevel;
+
+		/// timestamp of the last change of the level, negative if it was never changed
+		int64_t mLastAdaptationTime;
+
+		/// number of times the send interval was shortened
+		int64_t mNumSendIntervalDecreases;
+
+		/// number of times the send interval was lengthened
+		int64_t mNumSendIntervalIncreases;
+
+		/// mutex protecting the adaptation state
+		mutable std::mutex mMutex;
+	};
+}
+
+#endif
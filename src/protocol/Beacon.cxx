@@ -21,13 +21,147 @@
 #include "BeaconProtocolConstants.h"
 #include "core/util/URLEncoding.h"
 #include "core/util/InetAddressValidator.h"
+#include "providers/CoarseTimingProvider.h"
 #include "providers/DefaultPRNGenerator.h"
+#include "providers/DefaultThreadIDProvider.h"
+#include "providers/DefaultTimingProvider.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
 #include <random>
 #include <sstream>
+#include <typeinfo>
 
 using namespace protocol;
 
+///
+/// Writes the decimal representation of a value without going through the locale aware printf machinery.
+/// @param[in] buffer buffer with room for at least 11 characters
+/// @param[in] value the value to write
+/// @returns pointer behind the last written character
+///
+static char* appendInt32(char* buffer, int32_t value)
+{
+	auto magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+	if (value < 0)
+	{
+		*buffer++ = '-';
+	}
+
+	char digits[10];
+	auto numDigits = 0;
+	do
+	{
+		digits[numDigits++] = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+
+	while (numDigits > 0)
+	{
+		*buffer++ = digits[--numDigits];
+	}
+	return buffer;
+}
+
+///
+/// Chunk following the one in flight, built either by a chunk builder thread or by the sending thread.
+///
+/// Whichever thread calls @ref build first builds the chunk, so the sending thread never waits for a chunk
+/// builder which did not start yet.
+///
+class FollowingChunkBuild
+{
+public:
+	FollowingChunkBuild(std::shared_ptr<caching::IBeaconCache> beaconCache, int32_t beaconID, const core::UTF8String& chunkPrefix,
+		int32_t maxChunkSize, std::shared_ptr<protocol::IHTTPClient> httpClient)
+		: mBeaconCache(beaconCache)
+		, mBeaconID(beaconID)
+		, mChunkPrefix(chunkPrefix)
+		, mMaxChunkSize(maxChunkSize)
+		, mHTTPClient(httpClient)
+		, mIsClaimed(false)
+		, mMutex()
+		, mConditionVariable()
+		, mIsBuilt(false)
+		, mChunk()
+		, mPayload()
+	{
+	}
+
+	///
+	/// Assembles and encodes the chunk unless another thread already started doing so
+	///
+	void build()
+	{
+		if (mIsClaimed.exchange(true))
+		{
+			return;
+		}
+
+		auto chunk = mBeaconCache->getFollowingBeaconChunk(mBeaconID, mChunkPrefix, mMaxChunkSize, BEACON_DATA_DELIMITER);
+		auto payload = chunk.empty() ? protocol::BeaconPayload() : mHTTPClient->encodeBeaconData(chunk);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mChunk = chunk;
+			mPayload = payload;
+			mIsBuilt = true;
+		}
+		mConditionVariable.notify_all();
+	}
+
+	///
+	/// Returns the chunk, building it on the calling thread if no chunk builder started building it
+	/// @param[out] chunk the assembled chunk, empty if all data is sent
+	/// @param[out] payload the encoded chunk
+	///
+	void take(core::UTF8String& chunk, protocol::BeaconPayload& payload)
+	{
+		build();
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		mConditionVariable.wait(lock, [this]() { return mIsBuilt; });
+		chunk = mChunk;
+		payload = mPayload;
+	}
+
+private:
+	/// the cache holding the chunk data
+	const std::shared_ptr<caching::IBeaconCache> mBeaconCache;
+
+	/// the beacon the chunk belongs to
+	const int32_t mBeaconID;
+
+	/// prefix of the chunk
+	const core::UTF8String mChunkPrefix;
+
+	/// maximum size of the chunk
+	const int32_t mMaxChunkSize;
+
+	/// client encoding the chunk
+	const std::shared_ptr<protocol::IHTTPClient> mHTTPClient;
+
+	/// set by the first thread calling build
+	std::atomic<bool> mIsClaimed;
+
+	/// mutex guarding the built chunk
+	std::mutex mMutex;
+
+	/// condition variable signalled once the chunk is built
+	std::condition_variable mConditionVariable;
+
+	/// @c true once the chunk is built
+	bool mIsBuilt;
+
+	/// the assembled chunk
+	core::UTF8String mChunk;
+
+	/// the encoded chunk
+	protocol::BeaconPayload mPayload;
+};
+
 Beacon::Beacon(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<caching::IBeaconCache> beaconCache, std::shared_ptr<configuration::Configuration> configuration, const char* clientIPAddress, std::shared_ptr<providers::IThreadIDProvider> threadIDProvider, std::shared_ptr<providers::ITimingProvider> timingProvider)
 	: Beacon(logger, beaconCache, configuration, clientIPAddress, threadIDProvider, timingProvider, std::make_shared<providers::DefaultPRNGenerator>())
 {
@@ -45,11 +179,21 @@ Beacon::Beacon(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<caching
 	, mBeaconId()
 	, mSessionStartTime(timingProvider->provideTimestampInMilliseconds())
 	, mImmutableBasicBeaconData()
+	, mTagPrefix()
 	, mBeaconCache(beaconCache)
 	, mHTTPClientConfiguration(configuration->getHTTPClientConfiguration())
 	, mBeaconConfiguration(configuration->getBeaconConfiguration())
+	, mLevels(packLevels(*mBeaconConfiguration))
 	, mDeviceID()
 	, mRandomGenerator(randomGenerator)
+	, mSessionFlushThreshold(0)
+	, mNumBytesSinceLastSend(0)
+	, mWakeupEvent(nullptr)
+	, mChunkBuilderPool()
+	, mEventSampler(configuration->getEventSampler())
+	, mClock(getClock(*timingProvider))
+	, mIsDefaultThreadIDProvider(isDefaultThreadIDProvider(*threadIDProvider))
+	, mValueAggregator(configuration->getValueAggregationInterval() >= 0 ? new ValueAggregator(configuration->getValueAggregationInterval()) : nullptr)
 {
 	core::UTF8String internalClientIPAddress(clientIPAddress);
 	if (clientIPAddress == nullptr)
@@ -81,7 +225,14 @@ Beacon::Beacon(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<caching
 		mSessionNumber = 1;
 	}
 
+	auto beaconCacheConfiguration = configuration->getBeaconCacheConfiguration();
+	if (beaconCacheConfiguration != nullptr)
+	{
+		mSessionFlushThreshold = beaconCacheConfiguration->getSessionFlushThreshold();
+	}
+
 	mImmutableBasicBeaconData = createImmutableBeaconData();
+	mTagPrefix = createTagPrefix();
 }
 
 core::UTF8String Beacon::createImmutableBeaconData()
@@ -139,14 +290,14 @@ core::UTF8String Beacon::createBasicEventData(protocol::EventType eventType, con
 	{
 		addKeyValuePair(eventData, BEACON_KEY_NAME, truncate(eventName));
 	}
-	addKeyValuePair(eventData, BEACON_KEY_THREAD_ID, mThreadIDProvider->getThreadID());
+	addKeyValuePair(eventData, BEACON_KEY_THREAD_ID, readThreadID());
 	return eventData;
 }
 
 core::UTF8String Beacon::createTimestampData()
 {
 	core::UTF8String timestampData;
-	addKeyValuePair(timestampData, BEACON_KEY_TRANSMISSION_TIME, mTimingProvider->provideTimestampInMilliseconds());
+	addKeyValuePair(timestampData, BEACON_KEY_TRANSMISSION_TIME, readTimestamp());
 	addKeyValuePair(timestampData, BEACON_KEY_SESSION_START_TIME, mSessionStartTime);
 
 	return timestampData;
@@ -156,7 +307,7 @@ core::UTF8String Beacon::buildEvent(EventType eventType, const core::UTF8String&
 {
 	core::UTF8String eventData = createBasicEventData(eventType, name);
 
-	eventTimestamp = mTimingProvider->provideTimestampInMilliseconds();
+	eventTimestamp = readTimestamp();
 	addKeyValuePair(eventData, BEACON_KEY_PARENT_ACTION_ID, parentActionID);
 	addKeyValuePair(eventData, BEACON_KEY_START_SEQUENCE_NUMBER, createSequenceNumber());
 	addKeyValuePair(eventData, BEACON_KEY_TIME_0, getTimeSinceSessionStartTime(eventTimestamp));
@@ -203,7 +354,44 @@ int32_t Beacon::createSequenceNumber()
 
 int64_t Beacon::getCurrentTimestamp() const
 {
-	return mTimingProvider->provideTimestampInMilliseconds();
+	return readTimestamp();
+}
+
+int64_t Beacon::readTimestamp() const
+{
+	switch (mClock)
+	{
+	case Clock::SYSTEM:
+		return providers::DefaultTimingProvider::currentTimestampInMilliseconds();
+	case Clock::COARSE:
+		return providers::CoarseTimingProvider::currentTimestampInMilliseconds();
+	default:
+		return mTimingProvider->provideTimestampInMilliseconds();
+	}
+}
+
+Beacon::Clock Beacon::getClock(const providers::ITimingProvider& timingProvider)
+{
+	// derived classes, like mocks, may override the clock and are called through the interface
+	if (typeid(timingProvider) == typeid(providers::DefaultTimingProvider))
+	{
+		return Clock::SYSTEM;
+	}
+	if (typeid(timingProvider) == typeid(providers::CoarseTimingProvider))
+	{
+		return Clock::COARSE;
+	}
+	return Clock::PROVIDER;
+}
+
+bool Beacon::isDefaultThreadIDProvider(const providers::IThreadIDProvider& threadIDProvider)
+{
+	return typeid(threadIDProvider) == typeid(providers::DefaultThreadIDProvider);
+}
+
+int32_t Beacon::readThreadID() const
+{
+	return mIsDefaultThreadIDProvider ? providers::DefaultThreadIDProvider::currentThreadID() : mThreadIDProvider->getThreadID();
 }
 
 int32_t Beacon::createID()
@@ -211,38 +399,55 @@ int32_t Beacon::createID()
 	return ++mID;
 }
 
+core::UTF8String Beacon::createTagPrefix()
+{
+	core::UTF8String tagPrefix(TAG_PREFIX);
+
+	tagPrefix.concatenate("_");
+	tagPrefix.concatenate(std::to_string(PROTOCOL_VERSION));
+	tagPrefix.concatenate("_");
+	tagPrefix.concatenate(std::to_string(mHTTPClientConfiguration->getServerID()));
+	tagPrefix.concatenate("_");
+	tagPrefix.concatenate(std::to_string(getDeviceID()));
+	tagPrefix.concatenate("_");
+	tagPrefix.concatenate(std::to_string(mSessionNumber));
+	tagPrefix.concatenate("_");
+	tagPrefix.concatenate(mConfiguration->getApplicationIDPercentEncoded());
+	tagPrefix.concatenate("_");
+
+	return tagPrefix;
+}
+
 core::UTF8String Beacon::createTag(int32_t parentActionID, int32_t sequenceNumber)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() == openkit::DataCollectionLevel::OFF)
+	if (getDataCollectionLevel() == openkit::DataCollectionLevel::OFF)
 	{
 		return core::UTF8String("");
 	}
 
-	core::UTF8String webRequestTag(TAG_PREFIX);
-
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(std::to_string(PROTOCOL_VERSION));
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(std::to_string(mHTTPClientConfiguration->getServerID()));
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(std::to_string(getDeviceID()));
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(std::to_string(mSessionNumber));
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(mConfiguration->getApplicationIDPercentEncoded());
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(std::to_string(parentActionID));
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(std::to_string(mThreadIDProvider->getThreadID()));
-	webRequestTag.concatenate("_");
-	webRequestTag.concatenate(std::to_string(sequenceNumber));
+	// only the fields varying per web request are formatted, the rest is fixed per session
+	char buffer[3 * 12];
+	auto end = appendInt32(buffer, parentActionID);
+	*end++ = '_';
+	end = appendInt32(end, readThreadID());
+	*end++ = '_';
+	end = appendInt32(end, sequenceNumber);
+	*end = '\0';
+
+	core::UTF8String webRequestTag(mTagPrefix);
+	webRequestTag.concatenate(buffer);
 
 	return webRequestTag;
 }
 
 void Beacon::addAction(std::shared_ptr<core::Action> action)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() == openkit::DataCollectionLevel::OFF)
+	if (mValueAggregator != nullptr)
+	{
+		addAggregatedValues(mValueAggregator->removeAction(action->getID()));
+	}
+
+	if (!isCapturing())
 	{
 		return;
 	}
@@ -261,7 +466,12 @@ void Beacon::addAction(std::shared_ptr<core::Action> action)
 
 void Beacon::addAction(std::shared_ptr<core::RootAction> action)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() == openkit::DataCollectionLevel::OFF)
+	if (mValueAggregator != nullptr)
+	{
+		addAggregatedValues(mValueAggregator->removeAction(action->getID()));
+	}
+
+	if (!isCapturing())
 	{
 		return;
 	}
@@ -283,6 +493,7 @@ void Beacon::addActionData(int64_t timestamp, const core::UTF8String& actionData
 	if (mConfiguration->isCapture())
 	{
 		mBeaconCache->addActionData(mBeaconId, timestamp, actionData);
+		recordCachedData(actionData.getStringData().size());
 	}
 }
 
@@ -299,7 +510,7 @@ void Beacon::startSession()
 
 void Beacon::endSession(std::shared_ptr<core::Session> session)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() == openkit::DataCollectionLevel::OFF)
+	if (!isCapturing())
 	{
 		return;
 	}
@@ -315,7 +526,18 @@ void Beacon::endSession(std::shared_ptr<core::Session> session)
 
 void Beacon::reportValue(int32_t actionID, const core::UTF8String& valueName, int32_t value)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	if (!isCapturing() || getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	{
+		return;
+	}
+
+	auto sampleRate = sample(openkit::SampledEventType::VALUE, valueName);
+	if (sampleRate <= 0.0)
+	{
+		return;
+	}
+
+	if (aggregateValue(actionID, EventType::VALUE_INT, valueName, value, sampleRate))
 	{
 		return;
 	}
@@ -324,12 +546,24 @@ void Beacon::reportValue(int32_t actionID, const core::UTF8String& valueName, in
 	core::UTF8String eventData = buildEvent(EventType::VALUE_INT, valueName, actionID, eventTimestamp);
 	addKeyValuePair(eventData, BEACON_KEY_VALUE, value);
 
+	addSampleRate(eventData, sampleRate);
 	addEventData(eventTimestamp, eventData);
 }
 
 void Beacon::reportValue(int32_t actionID, const core::UTF8String& valueName, double value)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	if (!isCapturing() || getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	{
+		return;
+	}
+
+	auto sampleRate = sample(openkit::SampledEventType::VALUE, valueName);
+	if (sampleRate <= 0.0)
+	{
+		return;
+	}
+
+	if (aggregateValue(actionID, EventType::VALUE_DOUBLE, valueName, value, sampleRate))
 	{
 		return;
 	}
@@ -339,12 +573,19 @@ void Beacon::reportValue(int32_t actionID, const core::UTF8String& valueName, do
 
 	addKeyValuePair(eventData, BEACON_KEY_VALUE, value);
 
+	addSampleRate(eventData, sampleRate);
 	addEventData(eventTimestamp, eventData);
 }
 
 void Beacon::reportValue(int32_t actionID, const core::UTF8String& valueName, const core::UTF8String& value)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	if (!isCapturing() || getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	{
+		return;
+	}
+
+	auto sampleRate = sample(openkit::SampledEventType::VALUE, valueName);
+	if (sampleRate <= 0.0)
 	{
 		return;
 	}
@@ -354,12 +595,19 @@ void Beacon::reportValue(int32_t actionID, const core::UTF8String& valueName, co
 
 	addKeyValuePair(eventData, BEACON_KEY_VALUE, value);
 
+	addSampleRate(eventData, sampleRate);
 	addEventData(eventTimestamp, eventData);
 }
 
 void Beacon::reportEvent(int32_t actionID, const core::UTF8String& eventName)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	if (!isCapturing() || getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	{
+		return;
+	}
+
+	auto sampleRate = sample(openkit::SampledEventType::NAMED_EVENT, eventName);
+	if (sampleRate <= 0.0)
 	{
 		return;
 	}
@@ -367,6 +615,107 @@ void Beacon::reportEvent(int32_t actionID, const core::UTF8String& eventName)
 	uint64_t eventTimestamp;
 	core::UTF8String eventData = buildEvent(EventType::NAMED_EVENT, eventName, actionID, eventTimestamp);
 
+	addSampleRate(eventData, sampleRate);
+	addEventData(eventTimestamp, eventData);
+}
+
+void Beacon::reportValues(int32_t actionID, const openkit::ReportedValue* values, size_t numValues)
+{
+	if (!isCapturing() || getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	{
+		return;
+	}
+
+	std::vector<core::UTF8String> names;
+	std::vector<double> sampleRates;
+	names.reserve(numValues);
+	sampleRates.reserve(numValues);
+	int32_t numEvents = 0;
+	for (size_t i = 0; i < numValues; i++)
+	{
+		names.emplace_back(values[i].name);
+		auto sampleRate = 0.0;
+		if (!names.back().empty())
+		{
+			auto eventType = values[i].type == openkit::ReportedValueType::EVENT ? openkit::SampledEventType::NAMED_EVENT : openkit::SampledEventType::VALUE;
+			sampleRate = sample(eventType, names.back());
+		}
+		if (sampleRate > 0.0 && values[i].type == openkit::ReportedValueType::INT_VALUE
+			&& aggregateValue(actionID, EventType::VALUE_INT, names.back(), values[i].intValue, sampleRate))
+		{
+			sampleRate = 0.0;
+		}
+		else if (sampleRate > 0.0 && values[i].type == openkit::ReportedValueType::DOUBLE_VALUE
+			&& aggregateValue(actionID, EventType::VALUE_DOUBLE, names.back(), values[i].doubleValue, sampleRate))
+		{
+			sampleRate = 0.0;
+		}
+		if (sampleRate > 0.0)
+		{
+			numEvents++;
+		}
+		sampleRates.push_back(sampleRate);
+	}
+	if (numEvents == 0)
+	{
+		return;
+	}
+
+	// the whole batch shares one timestamp and takes one consecutive range of sequence numbers
+	auto eventTimestamp = readTimestamp();
+	auto timeSinceSessionStart = getTimeSinceSessionStartTime(eventTimestamp);
+	auto sequenceNumber = mSequenceNumber.fetch_add(numEvents) + 1;
+
+	std::vector<core::UTF8String> eventData;
+	eventData.reserve(numEvents);
+	for (size_t i = 0; i < numValues; i++)
+	{
+		if (sampleRates[i] <= 0.0)
+		{
+			continue;
+		}
+
+		const auto& value = values[i];
+		EventType eventType = EventType::NAMED_EVENT;
+		switch (value.type)
+		{
+		case openkit::ReportedValueType::INT_VALUE:
+			eventType = EventType::VALUE_INT;
+			break;
+		case openkit::ReportedValueType::DOUBLE_VALUE:
+			eventType = EventType::VALUE_DOUBLE;
+			break;
+		case openkit::ReportedValueType::STRING_VALUE:
+			eventType = EventType::VALUE_STRING;
+			break;
+		default:
+			break;
+		}
+
+		core::UTF8String data = createBasicEventData(eventType, names[i]);
+		addKeyValuePair(data, BEACON_KEY_PARENT_ACTION_ID, actionID);
+		addKeyValuePair(data, BEACON_KEY_START_SEQUENCE_NUMBER, sequenceNumber++);
+		addKeyValuePair(data, BEACON_KEY_TIME_0, timeSinceSessionStart);
+
+		switch (value.type)
+		{
+		case openkit::ReportedValueType::INT_VALUE:
+			addKeyValuePair(data, BEACON_KEY_VALUE, value.intValue);
+			break;
+		case openkit::ReportedValueType::DOUBLE_VALUE:
+			addKeyValuePair(data, BEACON_KEY_VALUE, value.doubleValue);
+			break;
+		case openkit::ReportedValueType::STRING_VALUE:
+			addKeyValuePair(data, BEACON_KEY_VALUE, core::UTF8String(value.stringValue));
+			break;
+		default:
+			break;
+		}
+
+		addSampleRate(data, sampleRates[i]);
+		eventData.push_back(std::move(data));
+	}
+
 	addEventData(eventTimestamp, eventData);
 }
 
@@ -377,13 +726,19 @@ void Beacon::reportError(int32_t actionID, const core::UTF8String& errorName, in
 		return;
 	}
 
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() == openkit::DataCollectionLevel::OFF)
+	if (!isCapturing())
+	{
+		return;
+	}
+
+	auto sampleRate = sample(openkit::SampledEventType::REPORTED_ERROR, errorName);
+	if (sampleRate <= 0.0)
 	{
 		return;
 	}
 
 	core::UTF8String eventData = createBasicEventData(EventType::FAILURE_ERROR, errorName);
-	uint64_t timestamp = mTimingProvider->provideTimestampInMilliseconds();
+	uint64_t timestamp = readTimestamp();
 	addKeyValuePair(eventData, BEACON_KEY_PARENT_ACTION_ID, actionID);
 	addKeyValuePair(eventData, BEACON_KEY_START_SEQUENCE_NUMBER, createSequenceNumber());
 	addKeyValuePair(eventData, BEACON_KEY_TIME_0, getTimeSinceSessionStartTime(timestamp));
@@ -393,24 +748,25 @@ void Beacon::reportError(int32_t actionID, const core::UTF8String& errorName, in
 		addKeyValuePair(eventData, BEACON_KEY_ERROR_REASON, reason);
 	}
 
+	addSampleRate(eventData, sampleRate);
 	addEventData(timestamp, eventData);
 }
 
 void Beacon::reportCrash(const core::UTF8String& errorName, const core::UTF8String& reason, const core::UTF8String& stacktrace)
 {
-	if (!mConfiguration->isCaptureCrashes())
+	if (mConfiguration->isCaptureTurnedOff() || !mConfiguration->isCaptureCrashes())
 	{
 		return;
 	}
 
-	if (std::atomic_load(&mBeaconConfiguration)->getCrashReportingLevel() != openkit::CrashReportingLevel::OPT_IN_CRASHES)
+	if (getCrashReportingLevel() != openkit::CrashReportingLevel::OPT_IN_CRASHES)
 	{
 		return;
 	}
 
 	core::UTF8String eventData = createBasicEventData(EventType::FAILURE_CRASH, errorName);
 
-	auto timestamp = mTimingProvider->provideTimestampInMilliseconds();
+	auto timestamp = readTimestamp();
 
 	addKeyValuePair(eventData, BEACON_KEY_PARENT_ACTION_ID, 0);                                  // no parent action
 	addKeyValuePair(eventData, BEACON_KEY_START_SEQUENCE_NUMBER, createSequenceNumber());
@@ -423,7 +779,7 @@ void Beacon::reportCrash(const core::UTF8String& errorName, const core::UTF8Stri
 
 void Beacon::addWebRequest(int32_t parentActionID, std::shared_ptr<core::WebRequestTracer> webRequestTracer)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() == openkit::DataCollectionLevel::OFF)
+	if (!isCapturing())
 	{
 		return;
 	}
@@ -454,19 +810,36 @@ void Beacon::addWebRequest(int32_t parentActionID, std::shared_ptr<core::WebRequ
 		addKeyValuePair(eventData, BEACON_KEY_WEBREQUEST_RESPONSE_CODE, responseCode);
 	}
 
+	addSampleRate(eventData, webRequestTracer->getSampleRate());
 	addEventData(webRequestTracer->getStartTime(), eventData);
 }
 
+double Beacon::sampleWebRequest(const core::UTF8String& url)
+{
+	if (mEventSampler == nullptr)
+	{
+		return 1.0;
+	}
+
+	// rules apply to the URL without query, as it is reported
+	auto indexOfQuestionMark = url.getIndexOf("?");
+	if (indexOfQuestionMark != std::string::npos)
+	{
+		return sample(openkit::SampledEventType::WEB_REQUEST, url.substring(0, indexOfQuestionMark));
+	}
+	return sample(openkit::SampledEventType::WEB_REQUEST, url);
+}
+
 void Beacon::identifyUser(const core::UTF8String& userTag)
 {
-	if (std::atomic_load(&mBeaconConfiguration)->getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	if (!isCapturing() || getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
 	{
 		return;
 	}
 
 	core::UTF8String eventData = createBasicEventData(EventType::IDENTIFY_USER, userTag);
 
-	auto timestamp = mTimingProvider->provideTimestampInMilliseconds();
+	auto timestamp = readTimestamp();
 
 	addKeyValuePair(eventData, BEACON_KEY_PARENT_ACTION_ID, 0);
 	addKeyValuePair(eventData, BEACON_KEY_START_SEQUENCE_NUMBER, createSequenceNumber());
@@ -478,7 +851,7 @@ void Beacon::identifyUser(const core::UTF8String& userTag)
 core::UTF8String Beacon::createMultiplicityData()
 {
 	core::UTF8String multiplicityData;
-	addKeyValuePair(multiplicityData, BEACON_KEY_MULTIPLICITY, mBeaconConfiguration->getMultiplicity());
+	addKeyValuePair(multiplicityData, BEACON_KEY_MULTIPLICITY, getBeaconConfiguration()->getMultiplicity());
 	return multiplicityData;
 }
 
@@ -501,43 +874,279 @@ std::shared_ptr<protocol::StatusResponse> Beacon::send(std::shared_ptr<providers
 	std::shared_ptr<protocol::IHTTPClient> httpClient = clientProvider->createClient(mLogger, mHTTPClientConfiguration);
 
 	std::shared_ptr<protocol::StatusResponse> response = nullptr;
+	auto adaptiveSendingController = mConfiguration->getAdaptiveSendingController();
+
+	// aggregates of long running actions are part of this send once their flush interval expired
+	if (mValueAggregator != nullptr)
+	{
+		addAggregatedValues(mValueAggregator->removeExpired(readTimestamp()));
+	}
+
+	// all data cached so far is part of this send
+	mNumBytesSinceLastSend = 0;
 
+	auto maxChunkSize = getMaxChunkSize();
+	core::UTF8String chunk = mBeaconCache->getNextBeaconChunk(mBeaconId, createChunkPrefix(), maxChunkSize, BEACON_DATA_DELIMITER);
+	if (chunk == nullptr || chunk.empty())
+	{
+		return response;
+	}
+
+	auto chunkBuilderPool = mChunkBuilderPool.lock();
+	auto payload = httpClient->encodeBeaconData(chunk);
 	while (true)
 	{
-		// prefix for this chunk - must be built up newly, due to changing timestamps
-		core::UTF8String prefix = mImmutableBasicBeaconData;
-		prefix.concatenate( getMutableBeaconData());
+		// a chunk only stops short of the maximum size if it contains all remaining data
+		auto hasFollowingChunk = chunk.getStringLength() > static_cast<core::UTF8String::size_type>(maxChunkSize);
 
-		core::UTF8String chunk = mBeaconCache->getNextBeaconChunk(mBeaconId, prefix, mConfiguration->getMaxBeaconSize() - 1024, BEACON_DATA_DELIMITER);
-		if (chunk == nullptr || chunk.empty())
+		// assemble and compress the following chunk while the current one is in flight
+		std::shared_ptr<FollowingChunkBuild> followingChunk = nullptr;
+		if (hasFollowingChunk)
 		{
-			return response;
+			followingChunk = std::make_shared<FollowingChunkBuild>(mBeaconCache, mBeaconId, createChunkPrefix(), maxChunkSize, httpClient);
+			if (chunkBuilderPool != nullptr)
+			{
+				chunkBuilderPool->submit([followingChunk]() { followingChunk->build(); });
+			}
 		}
 
 		// send the request
-		response = httpClient->sendBeaconRequest(mClientIPAddress, chunk);
+		auto requestStartTime = readTimestamp();
+		response = httpClient->sendEncodedBeaconRequest(mClientIPAddress, payload);
+		if (adaptiveSendingController != nullptr && response != nullptr)
+		{
+			// waiting for the upload rate limit is no sign of a slow collector
+			auto latency = readTimestamp() - requestStartTime - httpClient->getLastRequestThrottledTime();
+			adaptiveSendingController->recordResponseLatency(std::max(latency, int64_t(0)));
+		}
+
+		// the cache must not be modified before the following chunk is complete
+		payload = protocol::BeaconPayload();
+		if (hasFollowingChunk)
+		{
+			followingChunk->take(chunk, payload);
+		}
+
 		if (response == nullptr || response->isErroneousResponse())
 		{
 			// error happened - but don't know what exactly
-			// reset the previously retrieved chunk (restore it in internal cache) & retry another time
+			// reset the previously retrieved chunks (restore them in internal cache) & retry another time
 			mBeaconCache->resetChunkedData(mBeaconId);
 			break;
 		}
-		else
+
+		// worked -> remove previously retrieved chunk from cache, the following chunk becomes the current one
+		mBeaconCache->removeChunkedData(mBeaconId);
+		if (payload.isEmpty())
 		{
-			// worked -> remove previously retrieved chunk from cache
-			mBeaconCache->removeChunkedData(mBeaconId);
+			// all data being sent is removed - send data which was cached in the meantime
+			chunk = mBeaconCache->getNextBeaconChunk(mBeaconId, createChunkPrefix(), maxChunkSize, BEACON_DATA_DELIMITER);
+			if (chunk == nullptr || chunk.empty())
+			{
+				break;
+			}
+			payload = httpClient->encodeBeaconData(chunk);
 		}
 	}
 
 	return response;
 }
 
+bool Beacon::store(caching::BeaconChunkStore& chunkStore, std::shared_ptr<providers::IHTTPClientProvider> clientProvider)
+{
+	std::shared_ptr<protocol::IHTTPClient> httpClient = clientProvider->createClient(mLogger, mHTTPClientConfiguration);
+
+	// stored data must not be sent once again
+	mNumBytesSinceLastSend = 0;
+
+	auto maxChunkSize = getMaxChunkSize();
+	while (true)
+	{
+		auto prefix = createChunkPrefix();
+		core::UTF8String chunk = mBeaconCache->getNextBeaconChunk(mBeaconId, prefix, maxChunkSize, BEACON_DATA_DELIMITER);
+		if (chunk == nullptr || chunk.empty())
+		{
+			return true;
+		}
+
+		// the transmission time is only known when the chunk is replayed, thus the prefix is stored apart from the records
+		core::UTF8String records(chunk.getStringData().substr(prefix.getStringData().size()));
+		if (!chunkStore.store(mClientIPAddress, createStoredChunkPrefix(), httpClient->encodeBeaconData(records), readTimestamp()))
+		{
+			mBeaconCache->resetChunkedData(mBeaconId);
+			return false;
+		}
+
+		mBeaconCache->removeChunkedData(mBeaconId);
+	}
+}
+
+core::UTF8String Beacon::createChunkPrefix()
+{
+	// prefix for a chunk - must be built up newly, due to changing timestamps
+	core::UTF8String prefix = mImmutableBasicBeaconData;
+	prefix.concatenate(getMutableBeaconData());
+
+	return prefix;
+}
+
+core::UTF8String Beacon::createStoredChunkPrefix()
+{
+	core::UTF8String sessionStartTimeData;
+	addKeyValuePair(sessionStartTimeData, BEACON_KEY_SESSION_START_TIME, mSessionStartTime);
+
+	core::UTF8String prefix = mImmutableBasicBeaconData;
+	prefix.concatenate(BEACON_DATA_DELIMITER);
+	prefix.concatenate(sessionStartTimeData);
+	prefix.concatenate(BEACON_DATA_DELIMITER);
+	prefix.concatenate(createMultiplicityData());
+
+	return prefix;
+}
+
+core::UTF8String Beacon::createTransmissionTimeData(int64_t timestamp)
+{
+	core::UTF8String transmissionTimeData(BEACON_DATA_DELIMITER);
+	transmissionTimeData.concatenate(BEACON_KEY_TRANSMISSION_TIME);
+	transmissionTimeData.concatenate("=");
+	transmissionTimeData.concatenate(std::to_string(timestamp));
+
+	return transmissionTimeData;
+}
+
+int32_t Beacon::getMaxChunkSize() const
+{
+	auto maxBeaconSize = mConfiguration->getMaxBeaconSize();
+	auto adaptiveSendingController = mConfiguration->getAdaptiveSendingController();
+	if (adaptiveSendingController != nullptr)
+	{
+		maxBeaconSize = adaptiveSendingController->getMaxBeaconSize(maxBeaconSize);
+	}
+
+	return maxBeaconSize - 1024;
+}
+
 void Beacon::addEventData(int64_t timestamp, const core::UTF8String& eventData)
 {
 	if (mConfiguration->isCapture())
 	{
 		mBeaconCache->addEventData(mBeaconId, timestamp, eventData);
+		recordCachedData(eventData.getStringData().size());
+	}
+}
+
+void Beacon::addEventData(int64_t timestamp, const std::vector<core::UTF8String>& eventData)
+{
+	if (mConfiguration->isCapture())
+	{
+		mBeaconCache->addEventDataBatch(mBeaconId, timestamp, eventData);
+
+		int64_t numBytes = 0;
+		for (const auto& data : eventData)
+		{
+			numBytes += data.getStringData().size();
+		}
+		recordCachedData(numBytes);
+	}
+}
+
+double Beacon::sample(openkit::SampledEventType eventType, const core::UTF8String& name)
+{
+	if (mEventSampler == nullptr)
+	{
+		return 1.0;
+	}
+
+	return mEventSampler->sample(eventType, name.getStringData());
+}
+
+void Beacon::addSampleRate(core::UTF8String& s, double sampleRate)
+{
+	if (sampleRate < 1.0)
+	{
+		// keep significant digits of small rates, which a fixed number of decimals would round to zero
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.6g", sampleRate);
+		addKeyValuePair(s, BEACON_KEY_SAMPLE_RATE, core::UTF8String(buffer));
+	}
+}
+
+bool Beacon::aggregateValue(int32_t actionID, EventType eventType, const core::UTF8String& valueName, double value, double sampleRate)
+{
+	if (mValueAggregator == nullptr || sampleRate < 1.0)
+	{
+		return false;
+	}
+
+	auto timestamp = readTimestamp();
+	auto threadID = readThreadID();
+	addAggregatedValues(mValueAggregator->add(actionID, eventType, valueName, value, timestamp, threadID, [this]() { return createSequenceNumber(); }));
+	return true;
+}
+
+void Beacon::addAggregatedValues(const std::vector<ValueAggregator::Aggregate>& aggregates)
+{
+	if (aggregates.empty() || !isCapturing() || getDataCollectionLevel() != openkit::DataCollectionLevel::USER_BEHAVIOR)
+	{
+		return;
+	}
+
+	for (const auto& aggregate : aggregates)
+	{
+		core::UTF8String eventData;
+		addKeyValuePair(eventData, BEACON_KEY_EVENT_TYPE, static_cast<int32_t>(aggregate.eventType));
+		if (!aggregate.name.empty())
+		{
+			addKeyValuePair(eventData, BEACON_KEY_NAME, truncate(aggregate.name));
+		}
+		addKeyValuePair(eventData, BEACON_KEY_THREAD_ID, aggregate.threadID);
+		addKeyValuePair(eventData, BEACON_KEY_PARENT_ACTION_ID, aggregate.actionID);
+		addKeyValuePair(eventData, BEACON_KEY_START_SEQUENCE_NUMBER, aggregate.sequenceNumber);
+		addKeyValuePair(eventData, BEACON_KEY_TIME_0, getTimeSinceSessionStartTime(aggregate.timestamp));
+
+		// the last value is written like a record which is not aggregated, a single value carries nothing else
+		if (aggregate.eventType == EventType::VALUE_INT)
+		{
+			addKeyValuePair(eventData, BEACON_KEY_VALUE, static_cast<int32_t>(aggregate.last));
+			if (aggregate.count > 1)
+			{
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_COUNT, aggregate.count);
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_MIN, static_cast<int64_t>(aggregate.min));
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_MAX, static_cast<int64_t>(aggregate.max));
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_SUM, static_cast<int64_t>(aggregate.sum));
+			}
+		}
+		else
+		{
+			addKeyValuePair(eventData, BEACON_KEY_VALUE, aggregate.last);
+			if (aggregate.count > 1)
+			{
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_COUNT, aggregate.count);
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_MIN, aggregate.min);
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_MAX, aggregate.max);
+				addKeyValuePair(eventData, BEACON_KEY_VALUE_SUM, aggregate.sum);
+			}
+		}
+
+		addEventData(aggregate.timestamp, eventData);
+	}
+}
+
+void Beacon::recordCachedData(int64_t numBytes)
+{
+	auto previous = mNumBytesSinceLastSend.fetch_add(numBytes);
+	auto current = previous + numBytes;
+
+	// notify once when the first data arrives, so that the next send interval is scheduled,
+	// and once when the threshold is crossed, so that the beacon is sent right away
+	auto thresholdCrossed = mSessionFlushThreshold > 0 && previous < mSessionFlushThreshold && current >= mSessionFlushThreshold;
+	if (previous == 0 || thresholdCrossed)
+	{
+		auto wakeupEvent = std::atomic_load(&mWakeupEvent);
+		if (wakeupEvent != nullptr)
+		{
+			wakeupEvent->signal();
+		}
 	}
 }
 
@@ -560,10 +1169,40 @@ bool Beacon::isEmpty() const
 	return mBeaconCache->isEmpty(mBeaconId);
 }
 
+int64_t Beacon::getNumBytesInCache() const
+{
+	return mBeaconCache->getNumBytes(mBeaconId);
+}
+
+int64_t Beacon::getOldestRecordTimestamp() const
+{
+	return mBeaconCache->getOldestRecordTimestamp(mBeaconId);
+}
+
 void Beacon::clearData()
 {
 	// remove all cached data for this Beacon from the cache
+	if (mValueAggregator != nullptr)
+	{
+		mValueAggregator->removeAll();
+	}
 	mBeaconCache->deleteCacheEntry(mBeaconId);
+	mNumBytesSinceLastSend = 0;
+}
+
+void Beacon::setWakeupEvent(std::shared_ptr<core::util::WakeupEvent> wakeupEvent)
+{
+	std::atomic_store(&mWakeupEvent, wakeupEvent);
+}
+
+void Beacon::setChunkBuilderPool(std::shared_ptr<core::util::WorkStealingThreadPool> chunkBuilderPool)
+{
+	mChunkBuilderPool = chunkBuilderPool;
+}
+
+bool Beacon::isSendThresholdReached() const
+{
+	return mSessionFlushThreshold > 0 && mNumBytesSinceLastSend >= mSessionFlushThreshold;
 }
 
 int32_t Beacon::getSessionNumber() const
@@ -579,6 +1218,28 @@ int64_t Beacon::getDeviceID() const
 void Beacon::setBeaconConfiguration(std::shared_ptr<configuration::BeaconConfiguration> beaconConfiguration)
 {
 	std::atomic_store(&mBeaconConfiguration, beaconConfiguration);
+	mLevels.store(packLevels(*beaconConfiguration), std::memory_order_relaxed);
+}
+
+bool Beacon::isCapturing() const
+{
+	return !mConfiguration->isCaptureTurnedOff() && getDataCollectionLevel() != openkit::DataCollectionLevel::OFF;
+}
+
+uint32_t Beacon::packLevels(const configuration::BeaconConfiguration& beaconConfiguration)
+{
+	return static_cast<uint32_t>(beaconConfiguration.getDataCollectionLevel())
+		| (static_cast<uint32_t>(beaconConfiguration.getCrashReportingLevel()) << 8);
+}
+
+openkit::DataCollectionLevel Beacon::getDataCollectionLevel() const
+{
+	return static_cast<openkit::DataCollectionLevel>(mLevels.load(std::memory_order_relaxed) & 0xFF);
+}
+
+openkit::CrashReportingLevel Beacon::getCrashReportingLevel() const
+{
+	return static_cast<openkit::CrashReportingLevel>((mLevels.load(std::memory_order_relaxed) >> 8) & 0xFF);
 }
 
 std::shared_ptr<configuration::BeaconConfiguration> Beacon::getBeaconConfiguration() const
@@ -18,6 +18,7 @@
 #define _PROTOCOL_BEACON_H
 
 #include "OpenKit/ILogger.h"
+#include "OpenKit/ReportedValue.h"
 #include "core/UTF8String.h"
 #include "providers/ITimingProvider.h"
 #include "providers/IThreadIDProvider.h"
@@ -29,10 +30,16 @@
 #include "core/Session.h"
 #include "core/WebRequestTracer.h"
 #include "caching/BeaconCache.h"
+#include "caching/BeaconChunkStore.h"
+#include "core/util/WakeupEvent.h"
+#include "core/util/WorkStealingThreadPool.h"
+#include "EventSampler.h"
 #include "EventType.h"
+#include "ValueAggregator.h"
 
 #include <memory>
 #include <map>
+#include <vector>
 
 namespace protocol
 {
@@ -177,6 +184,19 @@ namespace protocol
 		///
 		virtual void reportEvent(int32_t actionID, const core::UTF8String& eventName);
 
+		///
+		/// Add several events and key-value-pairs to Beacon at once.
+		///
+		/// The entries get one common timestamp and consecutive sequence numbers,
+		/// their serialized data is added to @ref caching::BeaconCache in one go.
+		/// Entries without a name or dropped by client side sampling are skipped.
+		///
+		/// @param actionID The id of the @ref core::Action on which the entries were reported.
+		/// @param values Events and values to report.
+		/// @param numValues Number of entries in @c values.
+		///
+		virtual void reportValues(int32_t actionID, const openkit::ReportedValue* values, size_t numValues);
+
 		///
 		/// Add error to Beacon.
 		///
@@ -206,6 +226,13 @@ namespace protocol
 		///
 		virtual void addWebRequest(int32_t parentActionID, std::shared_ptr<core::WebRequestTracer> webRequestTracer);
 
+		///
+		/// Decides whether a web request is traced, before its tag is created and sent along with the request.
+		/// @param[in] url the URL of the web request, which must have a valid scheme
+		/// @returns the rate the web request is sampled with, or @c 0 if it is not traced
+		///
+		double sampleWebRequest(const core::UTF8String& url);
+
 		///
 		/// Add user identification to Beacon.
 		/// The serialized data is added to @ref caching::BeaconCache
@@ -215,11 +242,33 @@ namespace protocol
 
 		///
 		/// Sends the current Beacon state
+		///
+		/// If the data does not fit into a single request, the next chunk is assembled and compressed
+		/// while the current chunk is sent.
 		/// @param[in] clientProvider the @ref providers::IHTTPClientProvider to use for sending
 		/// @returns the status response returned for the Beacon data
 		///
 		virtual std::shared_ptr<protocol::StatusResponse> send(std::shared_ptr<providers::IHTTPClientProvider> clientProvider);
 
+		///
+		/// Stores the current Beacon state in the given chunk store instead of sending it
+		///
+		/// The records are assembled into chunks and encoded exactly as they would be sent, so that replaying the chunks later on
+		/// neither assembles nor compresses them again. The chunk prefix is stored without the transmission time, which
+		/// is added by @ref createTransmissionTimeData when the chunk is replayed. Stored data is removed from the beacon cache.
+		/// @param[in] chunkStore the store receiving the chunks
+		/// @param[in] clientProvider the @ref providers::IHTTPClientProvider providing the client encoding the chunks
+		/// @returns @c true if all data was stored, @c false if a chunk could not be stored and remains in the cache
+		///
+		virtual bool store(caching::BeaconChunkStore& chunkStore, std::shared_ptr<providers::IHTTPClientProvider> clientProvider);
+
+		///
+		/// Generate the transmission time completing the prefix of a stored chunk
+		/// @param[in] timestamp the time the chunk is sent in milliseconds
+		/// @returns the transmission time data, including the leading delimiter
+		///
+		static core::UTF8String createTransmissionTimeData(int64_t timestamp);
+
 		///
 		/// Tests if the Beacon is empty
 		///
@@ -228,6 +277,18 @@ namespace protocol
 		///
 		bool isEmpty() const;
 
+		///
+		/// Returns the number of bytes cached for this Beacon
+		/// @returns the number of cached bytes
+		///
+		int64_t getNumBytesInCache() const;
+
+		///
+		/// Returns the timestamp of the oldest record cached for this Beacon
+		/// @returns the oldest record's timestamp or @c -1 if nothing is cached
+		///
+		int64_t getOldestRecordTimestamp() const;
+
 		///
 		/// Clears all previously collected data for this Beacon.
 		///
@@ -235,6 +296,28 @@ namespace protocol
 		///
 		void clearData();
 
+		///
+		/// Sets the event to raise when data was added to this Beacon for the first time since the last send
+		/// or when the data added since the last send reaches the session flush threshold.
+		/// @param[in] wakeupEvent the event to raise or @c nullptr to not notify anybody
+		///
+		void setWakeupEvent(std::shared_ptr<core::util::WakeupEvent> wakeupEvent);
+
+		///
+		/// Sets the pool whose threads assemble and compress the following chunk while a chunk is in flight.
+		/// Without pool, or while its threads are busy, the sending thread builds the following chunk itself.
+		/// @remarks Must be called before the Beacon is sent for the first time.
+		/// @param[in] chunkBuilderPool the pool building chunks, which is not kept alive by the Beacon
+		///
+		void setChunkBuilderPool(std::shared_ptr<core::util::WorkStealingThreadPool> chunkBuilderPool);
+
+		///
+		/// Returns whether the data added since the last send reached the session flush threshold
+		/// configured in the @ref configuration::BeaconCacheConfiguration.
+		/// @returns @c true if this Beacon shall be sent before the send interval expired, @c false otherwise
+		///
+		bool isSendThresholdReached() const;
+
 		///
 		/// Returns the session number.
 		/// @returns session number
@@ -259,6 +342,17 @@ namespace protocol
 		///
 		std::shared_ptr<configuration::BeaconConfiguration> getBeaconConfiguration() const;
 
+		///
+		/// Returns whether reported data is captured at all.
+		///
+		/// This is the fast path check for the public API: if capturing is turned off by the server or data collection
+		/// is OFF, all data except crashes is discarded, so there is no point in validating, allocating or serializing it.
+		/// Until the first status response was handled capturing is not known yet, data is recorded then and the
+		/// capture check when it is added to the beacon cache decides whether it is kept.
+		/// @returns @c true if capturing is on or not yet known and the data collection level is not OFF, @c false otherwise
+		///
+		bool isCapturing() const;
+
 		///
 		/// Get the client IP address.
 		/// @returns The client's IP address.
@@ -272,6 +366,59 @@ namespace protocol
 		///
 		core::UTF8String createImmutableBeaconData();
 
+		///
+		/// Serialization helper for the part of web request tags which is fixed per session.
+		/// @returns the tag prefix up to and including the separator after the application ID
+		///
+		core::UTF8String createTagPrefix();
+
+		///
+		/// Clocks which are read without virtual dispatch
+		///
+		enum class Clock
+		{
+			PROVIDER,	///< any other timing provider, which is called through its interface
+			SYSTEM,		///< @ref providers::DefaultTimingProvider
+			COARSE		///< @ref providers::CoarseTimingProvider
+		};
+
+		///
+		/// Determines the clock to read for the given timing provider.
+		///
+		static Clock getClock(const providers::ITimingProvider& timingProvider);
+
+		///
+		/// Returns whether the given thread ID provider can be called directly.
+		///
+		static bool isDefaultThreadIDProvider(const providers::IThreadIDProvider& threadIDProvider);
+
+		///
+		/// Reads the current timestamp, calling the built-in timing providers directly.
+		/// @returns the current timestamp in milliseconds
+		///
+		int64_t readTimestamp() const;
+
+		///
+		/// Reads the current thread ID, calling the built-in thread ID provider directly.
+		/// @returns the current thread ID
+		///
+		int32_t readThreadID() const;
+
+		///
+		/// Packs the data collection and crash reporting level of the given beacon configuration into one word.
+		///
+		static uint32_t packLevels(const configuration::BeaconConfiguration& beaconConfiguration);
+
+		///
+		/// Returns the data collection level of the current beacon configuration.
+		///
+		openkit::DataCollectionLevel getDataCollectionLevel() const;
+
+		///
+		/// Returns the crash reporting level of the current beacon configuration.
+		///
+		openkit::CrashReportingLevel getCrashReportingLevel() const;
+
 		///
 		/// Serialization helper method for creating basic event data
 		/// @returns Serialized data
@@ -366,6 +513,52 @@ namespace protocol
 		///
 		void addEventData(int64_t timestamp, const core::UTF8String& eventData);
 
+		///
+		/// Add several previously serialized event data records to the beacon list at once
+		/// @param[in] timestamp The timestamp when the event data occurred.
+		/// @param[in] eventData Contains the serialized event data records.
+		///
+		void addEventData(int64_t timestamp, const std::vector<core::UTF8String>& eventData);
+
+		///
+		/// Decides whether a record is kept by client side sampling, before it is serialized.
+		/// @param[in] eventType The kind of record.
+		/// @param[in] name The record's name.
+		/// @returns the rate the record is sampled with, or @c 0 if the record is dropped
+		///
+		double sample(openkit::SampledEventType eventType, const core::UTF8String& name);
+
+		///
+		/// Serialization helper for the rate a record was sampled with, which is only written for sampled records.
+		/// @param[in] s reference to string containing serialized data
+		/// @param[in] sampleRate the rate returned by @ref sample
+		///
+		void addSampleRate(core::UTF8String& s, double sampleRate);
+
+		///
+		/// Folds a numeric value into its aggregate instead of serializing it, if value aggregation is enabled.
+		/// Values sampled with a rate below @c 1 are not aggregated, since their records carry the sample rate.
+		/// @param[in] actionID The ID of the action the value is reported on.
+		/// @param[in] eventType @ref EventType::VALUE_INT or @ref EventType::VALUE_DOUBLE
+		/// @param[in] valueName The name of the value.
+		/// @param[in] value The value.
+		/// @param[in] sampleRate the rate returned by @ref sample
+		/// @returns @c true if the value was aggregated, @c false if it has to be serialized
+		///
+		bool aggregateValue(int32_t actionID, EventType eventType, const core::UTF8String& valueName, double value, double sampleRate);
+
+		///
+		/// Serializes aggregated values, one record per aggregate.
+		/// @param[in] aggregates The aggregates removed from the @ref ValueAggregator.
+		///
+		void addAggregatedValues(const std::vector<ValueAggregator::Aggregate>& aggregates);
+
+		///
+		/// Account for data added to the cache and raise the wakeup event if the sender needs to be notified
+		/// @param[in] numBytes number of bytes added to the cache
+		///
+		void recordCachedData(int64_t numBytes);
+
 		///
 		/// Generate serialization for the mutable part of the beaon
 		/// e.g. multiplicity and timestamp
@@ -373,6 +566,24 @@ namespace protocol
 		///
 		core::UTF8String getMutableBeaconData();
 
+		///
+		/// Generate the prefix of a chunk sent to the server
+		/// @returns the immutable and mutable beacon data
+		///
+		core::UTF8String createChunkPrefix();
+
+		///
+		/// Generate the prefix of a stored chunk, which lacks the transmission time
+		/// @returns the immutable and mutable beacon data except for the transmission time
+		///
+		core::UTF8String createStoredChunkPrefix();
+
+		///
+		/// Get the maximum size of the beacon data in a chunk, which leaves room for the chunk prefix
+		/// @returns the maximum chunk size in characters
+		///
+		int32_t getMaxChunkSize() const;
+
 		///
 		/// Generate multiplicity data
 		/// @returns the multiplicity data
@@ -413,6 +624,9 @@ namespace protocol
 		/// basic beacon data
 		core::UTF8String mImmutableBasicBeaconData;
 
+		/// part of web request tags which is fixed per session
+		core::UTF8String mTagPrefix;
+
 		///cache for beacons
 		std::shared_ptr<caching::IBeaconCache> mBeaconCache;
 
@@ -422,11 +636,38 @@ namespace protocol
 		/// beacon configuration
 		std::shared_ptr<configuration::BeaconConfiguration> mBeaconConfiguration;
 
+		/// data collection and crash reporting level of the beacon configuration, readable without loading the configuration
+		std::atomic<uint32_t> mLevels;
+
 		/// device id
 		int64_t mDeviceID;
 
 		///random generator
 		std::shared_ptr<providers::IPRNGenerator> mRandomGenerator;
+
+		/// number of cached bytes which trigger sending this beacon before the send interval expired
+		int64_t mSessionFlushThreshold;
+
+		/// number of bytes added to the cache since the last send
+		std::atomic<int64_t> mNumBytesSinceLastSend;
+
+		/// event raised to wake up the beacon sender
+		std::shared_ptr<core::util::WakeupEvent> mWakeupEvent;
+
+		/// pool building following chunks, see @ref setChunkBuilderPool
+		std::weak_ptr<core::util::WorkStealingThreadPool> mChunkBuilderPool;
+
+		/// client side sampling of reported data, or @c nullptr if all data is kept
+		std::shared_ptr<EventSampler> mEventSampler;
+
+		/// clock read by @ref readTimestamp
+		const Clock mClock;
+
+		/// @c true if the thread ID provider is a @ref providers::DefaultThreadIDProvider
+		const bool mIsDefaultThreadIDProvider;
+
+		/// aggregates of numeric values, or @c nullptr if every value is serialized
+		std::unique_ptr<ValueAggregator> mValueAggregator;
 	};
 }
 #endif
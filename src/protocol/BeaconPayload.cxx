@@ -0,0 +1,106 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "BeaconPayload.h"
+#include "core/util/Compressor.h"
+
+#include <string>
+
+using namespace protocol;
+
+BeaconPayload::BeaconPayload()
+	: mBeaconData()
+	, mCompressedData()
+	, mIsCompressed(false)
+	, mHasBeaconData(true)
+{
+}
+
+BeaconPayload::BeaconPayload(const core::UTF8String& beaconData)
+	: mBeaconData(beaconData)
+	, mCompressedData()
+	, mIsCompressed(false)
+	, mHasBeaconData(true)
+{
+}
+
+BeaconPayload::BeaconPayload(const core::UTF8String& beaconData, std::vector<unsigned char>&& compressedData)
+	: mBeaconData(beaconData)
+	, mCompressedData(std::move(compressedData))
+	, mIsCompressed(true)
+	, mHasBeaconData(true)
+{
+}
+
+BeaconPayload::BeaconPayload(std::vector<unsigned char>&& compressedData)
+	: mBeaconData()
+	, mCompressedData(std::move(compressedData))
+	, mIsCompressed(true)
+	, mHasBeaconData(false)
+{
+}
+
+BeaconPayload BeaconPayload::withPrefix(const core::UTF8String& prefix, const BeaconPayload& payload)
+{
+	if (!payload.isCompressed())
+	{
+		auto beaconData = prefix;
+		beaconData.concatenate(payload.getBeaconData());
+		return BeaconPayload(beaconData);
+	}
+
+	std::vector<unsigned char> compressedData;
+	base::util::Compressor::compressMemory(prefix.getStringData().data(), prefix.getStringData().size(), compressedData);
+	compressedData.insert(compressedData.end(), payload.mCompressedData.begin(), payload.mCompressedData.end());
+	return BeaconPayload(std::move(compressedData));
+}
+
+core::UTF8String BeaconPayload::getBeaconData() const
+{
+	if (mHasBeaconData)
+	{
+		return mBeaconData;
+	}
+
+	std::vector<unsigned char> beaconData;
+	if (!base::util::Compressor::decompressMemory(mCompressedData.data(), mCompressedData.size(), beaconData))
+	{
+		return core::UTF8String();
+	}
+	return core::UTF8String(std::string(beaconData.begin(), beaconData.end()));
+}
+
+bool BeaconPayload::isCompressed() const
+{
+	return mIsCompressed;
+}
+
+const unsigned char* BeaconPayload::getContent() const
+{
+	return mIsCompressed
+		? mCompressedData.data()
+		: reinterpret_cast<const unsigned char*>(mBeaconData.getStringData().data());
+}
+
+size_t BeaconPayload::getContentSize() const
+{
+	return mIsCompressed ? mCompressedData.size() : mBeaconData.getStringData().size();
+}
+
+bool BeaconPayload::isEmpty() const
+{
+	return getContentSize() == 0;
+}
@@ -0,0 +1,116 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _PROTOCOL_BEACONPAYLOAD_H
+#define _PROTOCOL_BEACONPAYLOAD_H
+
+#include "core/UTF8String.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace protocol
+{
+	///
+	/// Beacon data prepared for a beacon send request.
+	///
+	/// The payload is encoded before the request is sent, so that a beacon can assemble and compress
+	/// its next chunk while the current one is still in flight.
+	///
+	class BeaconPayload
+	{
+	public:
+		///
+		/// Constructor for an empty payload
+		///
+		BeaconPayload();
+
+		///
+		/// Constructor for a payload sent uncompressed
+		/// @param[in] beaconData the beacon data
+		///
+		explicit BeaconPayload(const core::UTF8String& beaconData);
+
+		///
+		/// Constructor for a payload sent gzip compressed
+		/// @param[in] beaconData the beacon data
+		/// @param[in] compressedData the gzip compressed beacon data
+		///
+		BeaconPayload(const core::UTF8String& beaconData, std::vector<unsigned char>&& compressedData);
+
+		///
+		/// Constructor for a payload sent gzip compressed whose uncompressed data is not kept, e.g. a stored chunk
+		/// @param[in] compressedData the gzip compressed beacon data
+		///
+		explicit BeaconPayload(std::vector<unsigned char>&& compressedData);
+
+		///
+		/// Returns a payload whose beacon data is the given prefix followed by the beacon data of @c payload
+		/// @remarks A compressed payload is not decompressed, instead the prefix is compressed as a gzip member
+		///          of its own and put ahead of the compressed data.
+		/// @param[in] prefix the beacon data to put in front
+		/// @param[in] payload the payload to prefix
+		/// @returns the prefixed payload, compressed if @c payload is compressed
+		///
+		static BeaconPayload withPrefix(const core::UTF8String& prefix, const BeaconPayload& payload);
+
+		///
+		/// Returns the uncompressed beacon data
+		/// @remarks A payload constructed from compressed data only is decompressed on each call.
+		/// @returns the beacon data, empty if the compressed data is damaged
+		///
+		core::UTF8String getBeaconData() const;
+
+		///
+		/// Returns whether the payload is gzip compressed
+		/// @returns @c true if the content is compressed, @c false if the beacon data is sent as is
+		///
+		bool isCompressed() const;
+
+		///
+		/// Returns the content to send in the request body
+		/// @returns pointer to the first byte of the content
+		///
+		const unsigned char* getContent() const;
+
+		///
+		/// Returns the size of the content to send in the request body
+		/// @returns the size in bytes
+		///
+		size_t getContentSize() const;
+
+		///
+		/// Returns whether there is no beacon data to send
+		/// @returns @c true if the payload is empty, @c false otherwise
+		///
+		bool isEmpty() const;
+
+	private:
+		/// the uncompressed beacon data
+		core::UTF8String mBeaconData;
+
+		/// the gzip compressed beacon data, empty if the data is sent uncompressed
+		std::vector<unsigned char> mCompressedData;
+
+		/// flag indicating whether the content is compressed
+		bool mIsCompressed;
+
+		/// flag indicating whether the uncompressed beacon data is kept
+		bool mHasBeaconData;
+	};
+}
+
+#endif
@@ -68,6 +68,11 @@ namespace protocol
 	constexpr char BEACON_KEY_WEBREQUEST_RESPONSE_CODE[] = "rc";
 	constexpr char BEACON_KEY_WEBREQUEST_BYTES_SENT[] = "bs";
 	constexpr char BEACON_KEY_WEBREQUEST_BYTES_RECEIVED[] = "br";
+	constexpr char BEACON_KEY_SAMPLE_RATE[] = "sr";
+	constexpr char BEACON_KEY_VALUE_COUNT[] = "vc";
+	constexpr char BEACON_KEY_VALUE_MIN[] = "vmn";
+	constexpr char BEACON_KEY_VALUE_MAX[] = "vmx";
+	constexpr char BEACON_KEY_VALUE_SUM[] = "vs";
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,220 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "protocol/EventSampler.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+using namespace protocol;
+
+constexpr size_t EventSampler::MAX_NAMES_PER_RULE;
+constexpr size_t EventSampler::NUM_EVENT_TYPES;
+
+/// resolution of the random numbers deciding about sampled records
+static const int64_t SAMPLE_RATE_RESOLUTION = 1000000;
+
+/// thousandths of a token taken out of a rate limit per record
+static const int64_t MILLI_TOKENS_PER_TOKEN = 1000;
+
+EventSampler::RateLimit::RateLimit(double eventsPerSecond, int64_t timestamp)
+	: mMilliTokensPerMillisecond(eventsPerSecond)
+	, mCapacity(static_cast<int64_t>(std::max(eventsPerSecond, 1.0) * MILLI_TOKENS_PER_TOKEN))
+	, mMilliTokens(mCapacity)
+	, mLastRefillTime(timestamp)
+	, mNumDroppedSinceAdmitted(0)
+{
+}
+
+double EventSampler::RateLimit::tryAcquire(int64_t timestamp)
+{
+	// the thread moving the refill time forward adds the tokens for the elapsed time
+	auto lastRefillTime = mLastRefillTime.load(std::memory_order_relaxed);
+	auto refill = static_cast<int64_t>((timestamp - lastRefillTime) * mMilliTokensPerMillisecond);
+	if (refill > 0 && mLastRefillTime.compare_exchange_strong(lastRefillTime, timestamp, std::memory_order_relaxed))
+	{
+		auto milliTokens = mMilliTokens.load(std::memory_order_relaxed);
+		while (!mMilliTokens.compare_exchange_weak(milliTokens, std::min(milliTokens + refill, mCapacity), std::memory_order_relaxed))
+		{
+		}
+	}
+
+	auto milliTokens = mMilliTokens.load(std::memory_order_relaxed);
+	do
+	{
+		if (milliTokens < MILLI_TOKENS_PER_TOKEN)
+		{
+			mNumDroppedSinceAdmitted.fetch_add(1, std::memory_order_relaxed);
+			return 0.0;
+		}
+	} while (!mMilliTokens.compare_exchange_weak(milliTokens, milliTokens - MILLI_TOKENS_PER_TOKEN, std::memory_order_relaxed));
+
+	// records dropped concurrently are carried by this or the next admitted record, none is lost
+	auto numDropped = mNumDroppedSinceAdmitted.exchange(0, std::memory_order_relaxed);
+	return 1.0 / static_cast<double>(numDropped + 1);
+}
+
+EventSampler::NamedRateLimit::NamedRateLimit(const std::string& internedName, size_t nameHash, double eventsPerSecond, int64_t timestamp)
+	: name(internedName)
+	, hash(nameHash)
+	, rateLimit(eventsPerSecond, timestamp)
+{
+}
+
+EventSampler::CompiledRule::CompiledRule(const openkit::SamplingRule& rule, int64_t timestamp)
+	: isDefaultRule(rule.name.empty())
+	, sampleRate(rule.sampleRate)
+	, maxEventsPerSecond(rule.maxEventsPerSecond)
+	, rateLimit(rule.maxEventsPerSecond > 0 ? rule.maxEventsPerSecond : 1.0, timestamp)
+	, namedRateLimits()
+{
+	for (auto& namedRateLimit : namedRateLimits)
+	{
+		namedRateLimit.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+EventSampler::CompiledRule::~CompiledRule()
+{
+	for (auto& namedRateLimit : namedRateLimits)
+	{
+		delete namedRateLimit.load(std::memory_order_acquire);
+	}
+}
+
+EventSampler::EventSampler(const std::vector<openkit::SamplingRule>& rules, std::shared_ptr<providers::ITimingProvider> timingProvider,
+	std::shared_ptr<providers::IPRNGenerator> randomGenerator)
+	: mTimingProvider(timingProvider)
+	, mRandomGenerator(randomGenerator)
+	, mNamedRules()
+	, mDefaultRules()
+{
+	auto timestamp = mTimingProvider->provideTimestampInMilliseconds();
+	for (const auto& rule : rules)
+	{
+		auto index = static_cast<size_t>(rule.eventType);
+		if (index >= NUM_EVENT_TYPES)
+		{
+			continue;
+		}
+
+		// a later rule for the same type and name replaces an earlier one
+		std::unique_ptr<CompiledRule> compiledRule(new CompiledRule(rule, timestamp));
+		if (rule.name.empty())
+		{
+			mDefaultRules[index] = std::move(compiledRule);
+		}
+		else
+		{
+			mNamedRules[index][rule.name] = std::move(compiledRule);
+		}
+	}
+}
+
+double EventSampler::sample(openkit::SampledEventType eventType, const std::string& name)
+{
+	auto index = static_cast<size_t>(eventType);
+	if (index >= NUM_EVENT_TYPES)
+	{
+		return 1.0;
+	}
+
+	CompiledRule* rule = nullptr;
+	const auto& namedRules = mNamedRules[index];
+	if (!namedRules.empty())
+	{
+		auto it = namedRules.find(name);
+		if (it != namedRules.end())
+		{
+			rule = it->second.get();
+		}
+	}
+	if (rule == nullptr)
+	{
+		rule = mDefaultRules[index].get();
+		if (rule == nullptr)
+		{
+			return 1.0;
+		}
+	}
+
+	if (!isSampledIn(rule->sampleRate))
+	{
+		return 0.0;
+	}
+	if (rule->maxEventsPerSecond <= 0)
+	{
+		return rule->sampleRate;
+	}
+
+	auto timestamp = mTimingProvider->provideTimestampInMilliseconds();
+	auto& rateLimit = rule->isDefaultRule ? getNamedRateLimit(*rule, name, timestamp) : rule->rateLimit;
+	return rule->sampleRate * rateLimit.tryAcquire(timestamp);
+}
+
+EventSampler::RateLimit& EventSampler::getNamedRateLimit(CompiledRule& rule, const std::string& name, int64_t timestamp)
+{
+	auto hash = std::hash<std::string>()(name);
+	for (size_t probe = 0; probe < MAX_NAMES_PER_RULE; probe++)
+	{
+		auto& slot = rule.namedRateLimits[(hash + probe) % MAX_NAMES_PER_RULE];
+		auto namedRateLimit = slot.load(std::memory_order_acquire);
+		if (namedRateLimit == nullptr)
+		{
+			// intern the name when it is seen first, another thread may take the slot concurrently
+			auto created = new NamedRateLimit(name, hash, rule.maxEventsPerSecond, timestamp);
+			if (slot.compare_exchange_strong(namedRateLimit, created, std::memory_order_acq_rel))
+			{
+				return created->rateLimit;
+			}
+			delete created;
+		}
+
+		if (namedRateLimit->hash == hash && namedRateLimit->name == name)
+		{
+			return namedRateLimit->rateLimit;
+		}
+	}
+
+	// the table is full, the remaining names share the rule's rate limit
+	return rule.rateLimit;
+}
+
+bool EventSampler::isSampledIn(double sampleRate)
+{
+	if (sampleRate >= 1.0)
+	{
+		return true;
+	}
+	if (sampleRate <= 0.0)
+	{
+		return false;
+	}
+
+	int64_t random;
+	if (mRandomGenerator != nullptr)
+	{
+		random = mRandomGenerator->nextInt64(SAMPLE_RATE_RESOLUTION);
+	}
+	else
+	{
+		static thread_local std::minstd_rand randomEngine(std::random_device{}());
+		random = std::uniform_int_distribution<int64_t>(0, SAMPLE_RATE_RESOLUTION - 1)(randomEngine);
+	}
+
+	return random < static_cast<int64_t>(sampleRate * SAMPLE_RATE_RESOLUTION);
+}
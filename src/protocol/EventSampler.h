@@ -0,0 +1,205 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _PROTOCOL_EVENTSAMPLER_H
+#define _PROTOCOL_EVENTSAMPLER_H
+
+#include "OpenKit/SamplingRule.h"
+#include "providers/IPRNGenerator.h"
+#include "providers/ITimingProvider.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace protocol
+{
+	///
+	/// Client side sampling of events, values, errors and web requests.
+	///
+	/// Each record is looked up by its type and name before it is serialized. A rule for the exact name takes
+	/// precedence over the rule without name for that type, records without a matching rule are always kept.
+	/// A rule keeps a record with its sample rate and then takes a token out of the bucket of the record's name.
+	///
+	/// The rules are fixed after construction, so looking them up needs no locking. Rate limits of rules without
+	/// name are kept per name in a fixed size open addressing table whose entries are inserted with
+	/// compare-and-swap and never removed; names beyond its capacity share one bucket.
+	///
+	class EventSampler
+	{
+	public:
+
+		///
+		/// Constructor
+		/// @param[in] rules the sampling rules
+		/// @param[in] timingProvider timing provider used to refill the rate limits
+		/// @param[in] randomGenerator random number generator deciding about sampled records,
+		///            a thread local generator is used if @c nullptr
+		///
+		EventSampler(const std::vector<openkit::SamplingRule>& rules, std::shared_ptr<providers::ITimingProvider> timingProvider,
+			std::shared_ptr<providers::IPRNGenerator> randomGenerator = nullptr);
+
+		///
+		/// Decides whether a record is kept.
+		/// @param[in] eventType the kind of record
+		/// @param[in] name the record's name, for web requests the URL
+		/// @returns the rate the record is sampled with, which is @c 1 if it is not sampled at all,
+		///          or @c 0 if the record is dropped
+		///
+		double sample(openkit::SampledEventType eventType, const std::string& name);
+
+		/// maximum number of names with their own rate limit per rule without name
+		static constexpr size_t MAX_NAMES_PER_RULE = 256;
+
+	private:
+
+		///
+		/// Lock-free token bucket, counting the records it dropped since it admitted the last one.
+		///
+		/// The next admitted record stands for itself and all records dropped before it, so scaling each kept record
+		/// up by its rate gives the number of records asked for, even if a burst was cut off and nothing was reported
+		/// for the rest of the second.
+		///
+		class RateLimit
+		{
+		public:
+			///
+			/// Constructor
+			/// @param[in] eventsPerSecond refill rate, the bucket holds one second of it, but at least one token
+			/// @param[in] timestamp the current timestamp in milliseconds
+			///
+			RateLimit(double eventsPerSecond, int64_t timestamp);
+
+			///
+			/// Takes a token out of the bucket.
+			/// @param[in] timestamp the current timestamp in milliseconds
+			/// @returns one divided by the number of records the admitted record stands for, or @c 0 if the bucket is empty
+			///
+			double tryAcquire(int64_t timestamp);
+
+		private:
+			/// tokens added per millisecond, in thousandths of a token
+			const double mMilliTokensPerMillisecond;
+
+			/// capacity of the bucket in thousandths of a token
+			const int64_t mCapacity;
+
+			/// thousandths of tokens currently in the bucket
+			std::atomic<int64_t> mMilliTokens;
+
+			/// timestamp of the last refill
+			std::atomic<int64_t> mLastRefillTime;
+
+			/// number of records dropped since the last admitted record
+			std::atomic<int64_t> mNumDroppedSinceAdmitted;
+		};
+
+		///
+		/// Rate limit of a single name of a rule without name
+		///
+		struct NamedRateLimit
+		{
+			///
+			/// Constructor
+			/// @param[in] internedName the name, copied once when it is seen first
+			/// @param[in] nameHash hash of the name
+			/// @param[in] eventsPerSecond refill rate of the rate limit
+			/// @param[in] timestamp the current timestamp in milliseconds
+			///
+			NamedRateLimit(const std::string& internedName, size_t nameHash, double eventsPerSecond, int64_t timestamp);
+
+			/// the name
+			const std::string name;
+
+			/// hash of the name
+			const size_t hash;
+
+			/// the rate limit
+			RateLimit rateLimit;
+		};
+
+		///
+		/// A sampling rule prepared for lookup
+		///
+		struct CompiledRule
+		{
+			///
+			/// Constructor
+			/// @param[in] rule the sampling rule
+			/// @param[in] timestamp the current timestamp in milliseconds
+			///
+			CompiledRule(const openkit::SamplingRule& rule, int64_t timestamp);
+
+			///
+			/// Destructor
+			///
+			~CompiledRule();
+
+			CompiledRule(const CompiledRule&) = delete;
+			CompiledRule& operator = (const CompiledRule&) = delete;
+
+			/// @c true if the rule applies to all names without a rule of their own
+			const bool isDefaultRule;
+
+			/// probability with which a record is kept
+			const double sampleRate;
+
+			/// maximum number of records kept per second and name
+			const double maxEventsPerSecond;
+
+			/// rate limit of a rule with name, or of the names not fitting into @c namedRateLimits
+			RateLimit rateLimit;
+
+			/// rate limits of the names seen by a rule without name
+			std::array<std::atomic<NamedRateLimit*>, MAX_NAMES_PER_RULE> namedRateLimits;
+		};
+
+		///
+		/// Returns the rate limit to use for the given name.
+		/// @param[in] rule rule without name
+		/// @param[in] name the record's name
+		/// @param[in] timestamp the current timestamp in milliseconds
+		///
+		RateLimit& getNamedRateLimit(CompiledRule& rule, const std::string& name, int64_t timestamp);
+
+		///
+		/// Returns whether a record is kept with the given probability.
+		///
+		bool isSampledIn(double sampleRate);
+
+		/// number of event types
+		static constexpr size_t NUM_EVENT_TYPES = 4;
+
+		/// timing provider
+		std::shared_ptr<providers::ITimingProvider> mTimingProvider;
+
+		/// random number generator, or @c nullptr to use a thread local generator
+		std::shared_ptr<providers::IPRNGenerator> mRandomGenerator;
+
+		/// rules with name per event type, keyed by name
+		std::array<std::unordered_map<std::string, std::unique_ptr<CompiledRule>>, NUM_EVENT_TYPES> mNamedRules;
+
+		/// rules without name per event type
+		std::array<std::unique_ptr<CompiledRule>, NUM_EVENT_TYPES> mDefaultRules;
+	};
+}
+
+#endif
@@ -17,13 +17,11 @@
 #include "HTTPClient.h"
 #include "HTTPResponseParser.h"
 #include "ProtocolConstants.h"
-#include "core/util/Compressor.h"
 #include "core/util/URLEncoding.h"
 #include "protocol/ssl/SSLStrictTrustManager.h"
 
 #include <cstdint>
 #include <chrono>
-#include <thread>
 #include <algorithm>
 #include <string>
 #include <cctype>
@@ -31,14 +29,7 @@
 #include <string.h>
 #include <iostream>
 
-// connection constants
-constexpr uint32_t MAX_SEND_RETRIES = 3;	// max number of retries of the HTTP GET or POST operation
-constexpr uint32_t RETRY_SLEEP_TIME = 200;	// retry sleep time in ms
-constexpr uint64_t CONNECT_TIMEOUT = 5;		// Time-out connect operations after this amount of seconds
-constexpr uint64_t READ_TIMEOUT = 30;		// Time-out the read operation after this amount of seconds
-
 using namespace protocol;
-using namespace base::util;
 
 std::vector<X509*> HTTPClient::m_trustedCertificateList;
 
@@ -47,10 +38,16 @@ HTTPClient::HTTPClient(std::shared_ptr<openkit::ILogger> logger, const std::shar
 	, mCurl(nullptr)
 	, mServerID(configuration->getServerID())
 	, mMonitorURL()
-	, mReadBuffer()
-	, mReadBufferPos(0)
+	, mReadPayload(nullptr)
+	, mReadPayloadPos(0)
+	, mLastRequestThrottledTime(0)
 	, mSSLTrustManager(nullptr)
 	, mNewSessionURL()
+	, mConnectTimeout(configuration->getRetryPolicy()->getConnectTimeout())
+	, mReadTimeout(configuration->getRetryPolicy()->getReadTimeout())
+	, mCompressor(configuration->getCompressor())
+	, mUploadRateLimiter(configuration->getUploadRateLimiter())
+	, mTransferDeadline(configuration->getTransferDeadline())
 {
 	// build the beacon URLs
 	buildMonitorURL(mMonitorURL, configuration->getBaseURL(), configuration->getApplicationID(), mServerID);
@@ -70,11 +67,16 @@ HTTPClient::HTTPClient(std::shared_ptr<openkit::ILogger> logger, const std::shar
 
 HTTPClient::~HTTPClient()
 {
+	if (mCurl != nullptr)
+	{
+		curl_easy_cleanup(mCurl);
+		mCurl = nullptr;
+	}
 }
 
 std::shared_ptr<StatusResponse> HTTPClient::sendStatusRequest()
 {
-	auto response = sendRequestInternal(RequestType::STATUS, mMonitorURL, core::UTF8String(""), core::UTF8String(""), HttpMethod::GET);
+	auto response = sendRequestInternal(RequestType::STATUS, mMonitorURL, core::UTF8String(""), BeaconPayload(), HttpMethod::GET);
 
 	return response != nullptr
 		? std::static_pointer_cast<StatusResponse>(response)
@@ -83,7 +85,25 @@ std::shared_ptr<StatusResponse> HTTPClient::sendStatusRequest()
 
 std::shared_ptr<StatusResponse> HTTPClient::sendBeaconRequest(const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData)
 {
-	auto response = sendRequestInternal(RequestType::BEACON, mMonitorURL, clientIPAddress, beaconData, HttpMethod::POST);
+	return sendEncodedBeaconRequest(clientIPAddress, encodeBeaconData(beaconData));
+}
+
+BeaconPayload HTTPClient::encodeBeaconData(const core::UTF8String& beaconData)
+{
+	// data to send is compressed, unless the compressor decides it is not worth it
+	const auto& data = beaconData.getStringData();
+	std::vector<unsigned char> compressedData;
+	if (!data.empty() && mCompressor->compress(data.c_str(), data.size(), compressedData))
+	{
+		return BeaconPayload(beaconData, std::move(compressedData));
+	}
+
+	return BeaconPayload(beaconData);
+}
+
+std::shared_ptr<StatusResponse> HTTPClient::sendEncodedBeaconRequest(const core::UTF8String& clientIPAddress, const BeaconPayload& payload)
+{
+	auto response = sendRequestInternal(RequestType::BEACON, mMonitorURL, clientIPAddress, payload, HttpMethod::POST);
 
 	return response != nullptr
 		? std::static_pointer_cast<StatusResponse>(response)
@@ -92,13 +112,18 @@ std::shared_ptr<StatusResponse> HTTPClient::sendBeaconRequest(const core::UTF8St
 
 std::shared_ptr<StatusResponse> HTTPClient::sendNewSessionRequest()
 {
-	auto response = sendRequestInternal(RequestType::NEW_SESSION, mNewSessionURL, core::UTF8String(""), core::UTF8String(""), HttpMethod::GET);
+	auto response = sendRequestInternal(RequestType::NEW_SESSION, mNewSessionURL, core::UTF8String(""), BeaconPayload(), HttpMethod::GET);
 
 	return response != nullptr
 		? std::static_pointer_cast<StatusResponse>(response)
 		: std::make_shared<StatusResponse>(mLogger, core::UTF8String(), std::numeric_limits<int32_t>::max(), Response::ResponseHeaders());
 }
 
+int64_t HTTPClient::getLastRequestThrottledTime() const
+{
+	return mLastRequestThrottledTime;
+}
+
 void HTTPClient::globalInit()
 {
 	// set up the program environment that libcurl needs. In windows, this will init the winsock stuff
@@ -123,13 +148,21 @@ size_t HTTPClient::readFunction(void *ptr, size_t elementSize, size_t numberOfEl
 	if (userPtr)
 	{
 		HTTPClient *_this = (HTTPClient*)userPtr;
-		size_t available = (_this->mReadBuffer.size() - _this->mReadBufferPos);
+		if (_this->mReadPayload == nullptr)
+		{
+			return 0;
+		}
+
+		size_t available = (_this->mReadPayload->getContentSize() - _this->mReadPayloadPos);
 
 		if (available > 0)
 		{
-			size_t written = std::min(elementSize * numberOfElements, available);
-			memcpy(ptr, ((char*)(_this->mReadBuffer.data())) + _this->mReadBufferPos, written);
-			_this->mReadBufferPos += written;
+			// wait for the upload rate limit, which may grant less than requested
+			int64_t throttledTime = 0;
+			size_t written = _this->mUploadRateLimiter->acquire(std::min(elementSize * numberOfElements, available), throttledTime);
+			_this->mLastRequestThrottledTime += throttledTime;
+			memcpy(ptr, _this->mReadPayload->getContent() + _this->mReadPayloadPos, written);
+			_this->mReadPayloadPos += written;
 			return written;
 		}
 	}
@@ -137,6 +170,22 @@ size_t HTTPClient::readFunction(void *ptr, size_t elementSize, size_t numberOfEl
 	return 0;
 }
 
+///
+/// Local callback function called by curl while a request is performed.
+/// @param[in] userPtr the HTTPClient performing the request
+/// @return non-zero to abort the request once the transfer deadline expired, @c 0 to continue
+///
+int HTTPClient::progressFunction(void* userPtr, curl_off_t /* downloadTotal */, curl_off_t /* downloadNow */, curl_off_t /* uploadTotal */, curl_off_t /* uploadNow */)
+{
+	if (userPtr)
+	{
+		HTTPClient *_this = (HTTPClient*)userPtr;
+		return _this->mTransferDeadline->isExpired() ? 1 : 0;
+	}
+
+	return 0;
+}
+
 ///
 /// Local callback function for writing received data (=the response).
 /// @param[in] ptr to the delivered data
@@ -173,7 +222,7 @@ static size_t headerFunction(char *buffer, size_t elementSize, size_t numberOfEl
 }
 
 //TODO: stefan.eberl - use the request type or rethink design
-std::shared_ptr<Response> HTTPClient::sendRequestInternal(HTTPClient::RequestType requestType, const core::UTF8String& url, const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData, const HTTPClient::HttpMethod method)
+std::shared_ptr<Response> HTTPClient::sendRequestInternal(HTTPClient::RequestType requestType, const core::UTF8String& url, const core::UTF8String& clientIPAddress, const BeaconPayload& payload, const HTTPClient::HttpMethod method)
 {
 	if (mLogger->isDebugEnabled())
 	{
@@ -191,126 +240,174 @@ std::shared_ptr<Response> HTTPClient::sendRequestInternal(HTTPClient::RequestTyp
 		};
 	}
 
-	// init the curl session - get the curl handle
-	mCurl = curl_easy_init();
+	long httpCode = 0L;
+	HTTPResponseParser responseParser;
+	if (performRequest(url, clientIPAddress, payload, method, responseParser, httpCode))
+	{
+		// Check for success or error
+		return handleResponse(requestType, httpCode, responseParser.getResponseBody(), responseParser.getResponseHeaders());
+	}
+
+	return HTTPClient::unknownErrorResponse(requestType);
+}
 
-	if (!mCurl)
+bool HTTPClient::forwardRequest(RequestType requestType, const core::UTF8String& url, const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData,
+	int32_t& responseCode, std::string& responseBody, Response::ResponseHeaders& responseHeaders)
+{
+	if (mLogger->isDebugEnabled())
 	{
-		// Abort and cleanup if CURL cannot be initialized
-		mLogger->error("HTTPClient sendRequestInternal() - curl_easy_init() failed");
-		return HTTPClient::unknownErrorResponse(requestType);
+		mLogger->debug("HTTPClient forwardRequest() - HTTP request: %s", url.getStringData().c_str());
 	}
 
 	long httpCode = 0L;
-	uint32_t retryCount = 0;
-	do
+	HTTPResponseParser responseParser;
+	auto method = requestType == RequestType::BEACON ? HttpMethod::POST : HttpMethod::GET;
+	auto payload = method == HttpMethod::POST ? encodeBeaconData(beaconData) : BeaconPayload();
+	if (!performRequest(url, clientIPAddress, payload, method, responseParser, httpCode))
 	{
-		// This will use a function to load the certificates from the Windows CA Store (Transmax Specific)
-		curl_easy_setopt(mCurl, CURLOPT_SSL_CTX_FUNCTION, &HTTPClient::SslContextFunction);
-		
-		// Wan't to see everything that happens (Transmax Specific)
-		curl_easy_setopt(mCurl, CURLOPT_VERBOSE, 1L); //Verbose mode - Display what's happening
-
-		// Set the connection parameters (URL, timeouts, etc.)
-		curl_easy_setopt(mCurl, CURLOPT_URL, url.getStringData().c_str());
-		curl_easy_setopt(mCurl, CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT);
-		curl_easy_setopt(mCurl, CURLOPT_TIMEOUT, READ_TIMEOUT);
-		// allow servers to send compressed data
-		curl_easy_setopt(mCurl, CURLOPT_ACCEPT_ENCODING, "");
-		// SSL/TSL certificate handling
-		mSSLTrustManager->applyTrustManager(mCurl);
-
-		HTTPResponseParser responseParser;
-		// To retrieve the response headers
-		curl_easy_setopt(mCurl, CURLOPT_HEADERFUNCTION, headerFunction);
-		curl_easy_setopt(mCurl, CURLOPT_HEADERDATA, &responseParser);
-		// To retrieve the response
-		curl_easy_setopt(mCurl, CURLOPT_WRITEFUNCTION, writeFunction);
-		curl_easy_setopt(mCurl, CURLOPT_WRITEDATA, &responseParser);
-
-
-		// Set the custom HTTP header with the client IP address, if provided
-		struct curl_slist *list = NULL;
-		if (!clientIPAddress.empty())
-		{
-			core::UTF8String xClientId("X-Client-IP: ");
-			xClientId.concatenate(clientIPAddress);
-			list = curl_slist_append(list, xClientId.getStringData().c_str());
-		}
-
-		if (method == POST)
-		{
-			// Do a regular HTTP post
-			curl_easy_setopt(mCurl, CURLOPT_POST, 1L);
+		return false;
+	}
 
-			if (!beaconData.empty())
-			{
-				if (mLogger->isDebugEnabled())
-				{
-					mLogger->debug("HTTPClient sendRequestInternal() - Beacon Payload: %s", beaconData.getStringData().c_str());
-				}
-
-				// Data to send is compressed => Compress the data
-				Compressor::compressMemory(beaconData.getStringData().c_str(), beaconData.getStringLength(), mReadBuffer);
-				mReadBufferPos = 0;
-				curl_easy_setopt(mCurl, CURLOPT_READFUNCTION, readFunction);
-				curl_easy_setopt(mCurl, CURLOPT_READDATA, this);
-				curl_easy_setopt(mCurl, CURLOPT_POSTFIELDSIZE, mReadBuffer.size());
-				list = curl_slist_append(list, "Content-Encoding: gzip");
-			}
-		}
+	responseCode = static_cast<int32_t>(httpCode);
+	responseBody = responseParser.getResponseBody();
+	responseHeaders = responseParser.getResponseHeaders();
+	return true;
+}
 
-		if (list != NULL)
+bool HTTPClient::performRequest(const core::UTF8String& url, const core::UTF8String& clientIPAddress, const BeaconPayload& payload, const HttpMethod method,
+	HTTPResponseParser& responseParser, long& httpCode)
+{
+	if (mTransferDeadline->isExpired())
+	{
+		if (mLogger->isDebugEnabled())
 		{
-			curl_easy_setopt(mCurl, CURLOPT_HTTPHEADER, list);
+			mLogger->debug("HTTPClient performRequest() - Transfer deadline expired, not sending request to '%s'", url.getStringData().c_str());
 		}
+		return false;
+	}
 
-		// Perform the request, res will get the return code
-		CURLcode response = curl_easy_perform(mCurl);
-		if (response == CURLE_OK)
-		{
-			// To retrieve the HTTP response code
-			curl_easy_getinfo(mCurl, CURLINFO_RESPONSE_CODE, &httpCode);
-		}
-		else
+	// init the curl session once and reset it for further requests,
+	// which keeps the connection open for subsequent requests to the same host
+	if (mCurl == nullptr)
+	{
+		mCurl = curl_easy_init();
+		if (!mCurl)
 		{
-			// See https://curl.haxx.se/libcurl/c/libcurl-errors.html for a list of CURL error codes.
-			mLogger->error("HTTPClient sendRequestInternal() - curl_easy_perform() failed on '%s': ErrorCode '%u', [%s]", url.getStringData().c_str(), response, curl_easy_strerror(response));
+			// Abort and cleanup if CURL cannot be initialized
+			mLogger->error("HTTPClient performRequest() - curl_easy_init() failed");
+			return false;
 		}
+	}
+	else
+	{
+		curl_easy_reset(mCurl);
+	}
 
-		// Cleanup
-		if (list != nullptr)
-		{
-			curl_slist_free_all(list);
-			list = nullptr;
-		}
+	// This will use a function to load the certificates from the Windows CA Store (Transmax Specific)
+	curl_easy_setopt(mCurl, CURLOPT_SSL_CTX_FUNCTION, &HTTPClient::SslContextFunction);
+	
+	// Wan't to see everything that happens (Transmax Specific)
+	curl_easy_setopt(mCurl, CURLOPT_VERBOSE, 1L); //Verbose mode - Display what's happening
+
+	// Set the connection parameters (URL, timeouts, etc.)
+	curl_easy_setopt(mCurl, CURLOPT_URL, url.getStringData().c_str());
+	curl_easy_setopt(mCurl, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(mConnectTimeout));
+	auto timeout = mReadTimeout;
+	// allow servers to send compressed data
+	curl_easy_setopt(mCurl, CURLOPT_ACCEPT_ENCODING, "");
+	// SSL/TSL certificate handling
+	mSSLTrustManager->applyTrustManager(mCurl);
+
+	// To retrieve the response headers
+	curl_easy_setopt(mCurl, CURLOPT_HEADERFUNCTION, headerFunction);
+	curl_easy_setopt(mCurl, CURLOPT_HEADERDATA, &responseParser);
+	// To retrieve the response
+	curl_easy_setopt(mCurl, CURLOPT_WRITEFUNCTION, writeFunction);
+	curl_easy_setopt(mCurl, CURLOPT_WRITEDATA, &responseParser);
+
+
+	// Set the custom HTTP header with the client IP address, if provided
+	struct curl_slist *list = NULL;
+	if (!clientIPAddress.empty())
+	{
+		core::UTF8String xClientId("X-Client-IP: ");
+		xClientId.concatenate(clientIPAddress);
+		list = curl_slist_append(list, xClientId.getStringData().c_str());
+	}
 
-		if (response == CURLE_OK)
-		{
-			curl_easy_cleanup(mCurl);
-			mCurl = nullptr;
+	mLastRequestThrottledTime = 0;
+	if (method == POST)
+	{
+		// Do a regular HTTP post
+		curl_easy_setopt(mCurl, CURLOPT_POST, 1L);
 
-			// Check for success or error
-			return handleResponse(requestType, httpCode, responseParser.getResponseBody(), responseParser.getResponseHeaders());
-		}
-		else
+		if (!payload.isEmpty())
 		{
-			// For CURL related errors, we retry. Note that HTTP status codes >= 400 are returned with CURLE_OK.
-			retryCount++;
-			std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_SLEEP_TIME));
-			curl_easy_reset(mCurl);
+			if (mLogger->isDebugEnabled())
+			{
+				mLogger->debug("HTTPClient performRequest() - Beacon Payload: %s", payload.getBeaconData().getStringData().c_str());
+			}
+
+			if (payload.isCompressed())
+			{
+				list = curl_slist_append(list, "Content-Encoding: gzip");
+			}
+			mReadPayload = &payload;
+			mReadPayloadPos = 0;
+			curl_easy_setopt(mCurl, CURLOPT_READFUNCTION, readFunction);
+			curl_easy_setopt(mCurl, CURLOPT_READDATA, this);
+			curl_easy_setopt(mCurl, CURLOPT_POSTFIELDSIZE, static_cast<long>(payload.getContentSize()));
+
+			if (mUploadRateLimiter->isEnabled())
+			{
+				// time spent waiting for the upload rate limit must not let the request time out
+				auto uploadWaitTime = mUploadRateLimiter->getWaitTime(payload.getContentSize());
+				timeout = mReadTimeout + uploadWaitTime;
+			}
 		}
+	}
 
-	} while (retryCount < MAX_SEND_RETRIES);
+	// once shutting down, requests must not outlast the shutdown timeout
+	// requests already in flight when the deadline is set are aborted by the progress function
+	auto remainingTime = mTransferDeadline->getRemainingMilliseconds();
+	if (remainingTime >= 0)
+	{
+		timeout = std::max(std::min(timeout, remainingTime), int64_t(1));
+	}
+	curl_easy_setopt(mCurl, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout));
+	curl_easy_setopt(mCurl, CURLOPT_XFERINFOFUNCTION, progressFunction);
+	curl_easy_setopt(mCurl, CURLOPT_XFERINFODATA, this);
+	curl_easy_setopt(mCurl, CURLOPT_NOPROGRESS, 0L);
+
+	if (list != NULL)
+	{
+		curl_easy_setopt(mCurl, CURLOPT_HTTPHEADER, list);
+	}
+
+	// Perform the request, res will get the return code
+	// Failed requests are not retried here, retries are scheduled by the beacon sending states
+	// so that a failing request does not block the sender thread.
+	CURLcode response = curl_easy_perform(mCurl);
+	if (response == CURLE_OK)
+	{
+		// To retrieve the HTTP response code
+		curl_easy_getinfo(mCurl, CURLINFO_RESPONSE_CODE, &httpCode);
+	}
+	else
+	{
+		// See https://curl.haxx.se/libcurl/c/libcurl-errors.html for a list of CURL error codes.
+		mLogger->error("HTTPClient performRequest() - curl_easy_perform() failed on '%s': ErrorCode '%u', [%s]", url.getStringData().c_str(), response, curl_easy_strerror(response));
+	}
 
 	// Cleanup
-	if (mCurl != nullptr)
+	mReadPayload = nullptr;
+	if (list != nullptr)
 	{
-		curl_easy_cleanup(mCurl);
-		mCurl = nullptr;
+		curl_slist_free_all(list);
+		list = nullptr;
 	}
 
-	return HTTPClient::unknownErrorResponse(requestType);
+	return response == CURLE_OK;
 }
 
 std::shared_ptr<Response> HTTPClient::handleResponse(RequestType requestType, int32_t httpCode, const std::string& response, const Response::ResponseHeaders& responseHeaders)
@@ -354,19 +451,31 @@ void HTTPClient::buildMonitorURL(core::UTF8String& monitorURL, const core::UTF8S
 {
 	monitorURL.concatenate(baseURL);
 	monitorURL.concatenate("?");
-	monitorURL.concatenate(REQUEST_TYPE_MOBILE);
-
-	appendQueryParam(monitorURL, QUERY_KEY_SERVER_ID, std::to_string(serverID));
-	appendQueryParam(monitorURL, QUERY_KEY_APPLICATION, applicationID);
-	appendQueryParam(monitorURL, QUERY_KEY_VERSION, OPENKIT_VERSION);
-	appendQueryParam(monitorURL, QUERY_KEY_PLATFORM_TYPE, PLATFORM_TYPE_OPENKIT);
-	appendQueryParam(monitorURL, QUERY_KEY_AGENT_TECHNOLOGY_TYPE, AGENT_TECHNOLOGY_TYPE);
+	buildMonitorQuery(monitorURL, applicationID, serverID);
 }
 
 void HTTPClient::buildNewSessionURL(core::UTF8String& newSessionURL, const core::UTF8String& baseURL, const core::UTF8String& applicationID, uint32_t serverID)
 {
-	buildMonitorURL(newSessionURL, baseURL, applicationID, serverID);
-	appendQueryParam(newSessionURL, QUERY_KEY_NEW_SESSION, "1");
+	newSessionURL.concatenate(baseURL);
+	newSessionURL.concatenate("?");
+	buildNewSessionQuery(newSessionURL, applicationID, serverID);
+}
+
+void HTTPClient::buildMonitorQuery(core::UTF8String& query, const core::UTF8String& applicationID, uint32_t serverID)
+{
+	query.concatenate(REQUEST_TYPE_MOBILE);
+
+	appendQueryParam(query, QUERY_KEY_SERVER_ID, std::to_string(serverID));
+	appendQueryParam(query, QUERY_KEY_APPLICATION, applicationID);
+	appendQueryParam(query, QUERY_KEY_VERSION, OPENKIT_VERSION);
+	appendQueryParam(query, QUERY_KEY_PLATFORM_TYPE, PLATFORM_TYPE_OPENKIT);
+	appendQueryParam(query, QUERY_KEY_AGENT_TECHNOLOGY_TYPE, AGENT_TECHNOLOGY_TYPE);
+}
+
+void HTTPClient::buildNewSessionQuery(core::UTF8String& query, const core::UTF8String& applicationID, uint32_t serverID)
+{
+	buildMonitorQuery(query, applicationID, serverID);
+	appendQueryParam(query, QUERY_KEY_NEW_SESSION, "1");
 }
 
 
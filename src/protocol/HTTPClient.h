@@ -22,7 +22,11 @@
 
 #include "OpenKit/ILogger.h"
 #include "protocol/IHTTPClient.h"
+#include "protocol/TransferDeadline.h"
+#include "protocol/UploadRateLimiter.h"
+#include "protocol/HTTPResponseParser.h"
 #include "OpenKit/ISSLTrustManager.h"
+#include "OpenKit/ICompressor.h"
 #include "curl/curl.h"
 
 #include <openssl/ssl.h>
@@ -84,8 +88,45 @@ namespace protocol
 
 		virtual std::shared_ptr<StatusResponse> sendBeaconRequest(const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData) override;
 
+		virtual BeaconPayload encodeBeaconData(const core::UTF8String& beaconData) override;
+
+		virtual std::shared_ptr<StatusResponse> sendEncodedBeaconRequest(const core::UTF8String& clientIPAddress, const BeaconPayload& payload) override;
+
 		virtual std::shared_ptr<StatusResponse> sendNewSessionRequest() override;
 
+		virtual int64_t getLastRequestThrottledTime() const override;
+
+		///
+		/// Sends a request on behalf of another process and returns the unparsed response.
+		/// @remarks Used by the @ref LocalForwarder to relay requests received over a local socket.
+		/// @param[in] requestType the type of request sent to the server
+		/// @param[in] url the complete URL where to send the request to
+		/// @param[in] clientIPAddress optional IP address of the client, sent in the custom HTTP header "X-Client-IP"
+		/// @param[in] beaconData optional beacon data, only sent with beacon requests
+		/// @param[out] responseCode the HTTP response code
+		/// @param[out] responseBody the HTTP response body
+		/// @param[out] responseHeaders the HTTP response headers
+		/// @returns @c true if a response was received, @c false if the request failed
+		///
+		bool forwardRequest(RequestType requestType, const core::UTF8String& url, const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData,
+			int32_t& responseCode, std::string& responseBody, Response::ResponseHeaders& responseHeaders);
+
+		///
+		/// Build the query string used for status check and beacon send requests
+		/// @param[in,out] query the query string to build
+		/// @param[in] applicationID
+		/// @param[in] serverID
+		///
+		static void buildMonitorQuery(core::UTF8String& query, const core::UTF8String& applicationID, uint32_t serverID);
+
+		///
+		/// Build the query string used for new session requests
+		/// @param[in,out] query the query string to build
+		/// @param[in] applicationID
+		/// @param[in] serverID
+		///
+		static void buildNewSessionQuery(core::UTF8String& query, const core::UTF8String& applicationID, uint32_t serverID);
+
 		///
 		/// Perform global initialization.
 		/// @remarks This method expects to be called before any other operation.
@@ -114,11 +155,24 @@ namespace protocol
 		/// @param[in] requestType the type of request sent to the server
 		/// @param[in] url the url where to send the request to
 		/// @param[in] clientIPAddress optional the IP address of the client. If provided, this is sent in the custom HTTP header "X-Client-IP"
-		/// @param[in] beaconData optional data to send in the HTTP POST. Data will be gzip compressed.
+		/// @param[in] payload optional encoded data to send in the HTTP POST
 		/// @param[in] method the HTTP method to use. Currently either POST or GET
 		/// @returns a status response with the response data for the request or @c nullptr on error
 		///
-		std::shared_ptr<Response> sendRequestInternal(RequestType requestType, const core::UTF8String& url, const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData, const HttpMethod method);
+		std::shared_ptr<Response> sendRequestInternal(RequestType requestType, const core::UTF8String& url, const core::UTF8String& clientIPAddress, const BeaconPayload& payload, const HttpMethod method);
+
+		///
+		/// performs a request on the (reused) curl handle
+		/// @param[in] url the url where to send the request to
+		/// @param[in] clientIPAddress optional the IP address of the client
+		/// @param[in] payload optional encoded data to send in the HTTP POST
+		/// @param[in] method the HTTP method to use
+		/// @param[in,out] responseParser receives the response headers and body
+		/// @param[out] httpCode the HTTP response code
+		/// @returns @c true if a response was received, @c false otherwise
+		///
+		bool performRequest(const core::UTF8String& url, const core::UTF8String& clientIPAddress, const BeaconPayload& payload, const HttpMethod method,
+			HTTPResponseParser& responseParser, long& httpCode);
 
 		///
 		/// Build URL used for status check and beacon send requests
@@ -137,6 +191,8 @@ namespace protocol
 
 		static size_t readFunction(void *ptr, size_t elementSize, size_t numberOfElements, void* userPtr);
 
+		static int progressFunction(void* userPtr, curl_off_t downloadTotal, curl_off_t downloadNow, curl_off_t uploadTotal, curl_off_t uploadNow);
+
 		std::shared_ptr<Response> unknownErrorResponse(RequestType requestType);
 
 	private:
@@ -144,7 +200,7 @@ namespace protocol
 		/// Logger to write traces to
 		std::shared_ptr<openkit::ILogger> mLogger;
 
-		/// easy handle to the CURL session
+		/// easy handle to the CURL session, kept for the lifetime of the client to reuse the connection
 		CURL * mCurl;
 
 		/// the server ID
@@ -153,17 +209,35 @@ namespace protocol
 		/// URL used for status check and beacon send requests
 		core::UTF8String mMonitorURL;
 
-		/// buffer used for curl's read function
-		std::vector<unsigned char> mReadBuffer;
+		/// payload read by curl's read function while a request is performed
+		const BeaconPayload* mReadPayload;
+
+		/// read position in the payload's content
+		size_t mReadPayloadPos;
 
-		/// read position in the read buffer
-		size_t mReadBufferPos;
+		/// time in milliseconds the last request waited for the upload rate limit
+		int64_t mLastRequestThrottledTime;
 
 		/// how the peer's TSL/SSL certificate and the hostname shall be trusted
 		std::shared_ptr<openkit::ISSLTrustManager> mSSLTrustManager;
 
 		/// URL for new session requests
 		core::UTF8String mNewSessionURL;
+
+		/// timeout in milliseconds for establishing a connection
+		int64_t mConnectTimeout;
+
+		/// timeout in milliseconds for the whole request
+		int64_t mReadTimeout;
+
+		/// compression of beacon data
+		std::shared_ptr<openkit::ICompressor> mCompressor;
+
+		/// rate limiting of uploads
+		std::shared_ptr<UploadRateLimiter> mUploadRateLimiter;
+
+		/// deadline after which requests are aborted
+		std::shared_ptr<TransferDeadline> mTransferDeadline;
 	};
 
 }
@@ -17,6 +17,7 @@
 #include "HTTPResponseParser.h"
 
 #include <cctype>
+#include <cstring>
 #include <algorithm>
 
 using namespace protocol;
@@ -24,6 +25,9 @@ using namespace protocol;
 static constexpr char HTTP_HEADER_LINE_KEY_VALUE_SEPARATOR = ':';
 static constexpr char HTTP_HEADER_LINE_VALUE_SEPARATOR = ',';
 
+/// lower case keys of the response headers evaluated by OpenKit, all other headers are skipped
+static constexpr const char* RELEVANT_RESPONSE_HEADER_KEYS[] = { "retry-after" };
+
 HTTPResponseParser::HTTPResponseParser()
 	: mResponseHeaders()
 	, mResponseBody()
@@ -33,31 +37,33 @@ HTTPResponseParser::HTTPResponseParser()
 
 size_t HTTPResponseParser::responseHeaderData(const char *buffer, size_t elementSize, size_t numberOfElements)
 {
-	// convert response line into STL string
-	auto responseLine = std::string(buffer, elementSize * numberOfElements);
+	// work on the raw header line, only headers evaluated by OpenKit are copied
+	auto lineBegin = buffer;
+	auto lineEnd = buffer + elementSize * numberOfElements;
 
 	// split up response header line
-	auto separatorPosition = responseLine.find(HTTP_HEADER_LINE_KEY_VALUE_SEPARATOR);
-	if (separatorPosition != std::string::npos)
+	auto separator = std::find(lineBegin, lineEnd, HTTP_HEADER_LINE_KEY_VALUE_SEPARATOR);
+	if (separator != lineEnd)
 	{
-		// found the separator - split into key and value
-		auto key = responseLine.substr(0, separatorPosition);
-		auto valueString = responseLine.substr(separatorPosition + 1);
-
-		// strip optional whitespace character
-		HTTPResponseParser::stripWhitespaces(valueString);
-
-		// key is case insensitive
-		std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-		auto responseKeyIterator = mResponseHeaders.find(key);
-		if (responseKeyIterator == mResponseHeaders.end())
+		// found the separator - check if the key is of interest
+		auto relevantKey = findRelevantHeaderKey(lineBegin, separator);
+		if (relevantKey != nullptr)
 		{
-			// key not yet present
-			responseKeyIterator = mResponseHeaders.insert({ key, std::vector<std::string>() }).first;
+			// strip optional whitespace character
+			auto valueBegin = separator + 1;
+			auto valueEnd = lineEnd;
+			while (valueBegin < valueEnd && isWhitespace(*valueBegin))
+			{
+				valueBegin++;
+			}
+			while (valueEnd > valueBegin && isWhitespace(*(valueEnd - 1)))
+			{
+				valueEnd--;
+			}
+
+			// key is case insensitive and stored in lower case
+			mResponseHeaders[relevantKey].emplace_back(valueBegin, valueEnd);
 		}
-
-		// move over previously parsed values
-		responseKeyIterator->second.push_back(valueString);
 	}
 
 	// in any case return the number of bytes processed
@@ -85,25 +91,17 @@ bool HTTPResponseParser::isWhitespace(char c)
 	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
 }
 
-void HTTPResponseParser::stripWhitespaces(std::string& str)
+const char* HTTPResponseParser::findRelevantHeaderKey(const char* keyBegin, const char* keyEnd)
 {
-	auto begin = str.cbegin();
-	auto end = str.cend();
-
-	// strip leading whitespace
-	while (begin < end && isWhitespace(*begin))
+	auto keyLength = static_cast<size_t>(keyEnd - keyBegin);
+	for (auto relevantKey : RELEVANT_RESPONSE_HEADER_KEYS)
 	{
-		begin++;
-	}
-	// strip trailing whitespaces
-	end -= 1;
-	while (end > begin && isWhitespace(*end))
-	{
-		end--;
+		if (strlen(relevantKey) == keyLength
+			&& std::equal(keyBegin, keyEnd, relevantKey, [](char c, char lowerCase) { return std::tolower(static_cast<unsigned char>(c)) == lowerCase; }))
+		{
+			return relevantKey;
+		}
 	}
 
-	end += 1;
-	
-	// assign final result
-	str = end > begin ? std::string(begin, end) : std::string();
-}
+	return nullptr;
+}
\ No newline at end of file
@@ -39,7 +39,9 @@ namespace protocol
 
 		///
 		/// Method called when new header line is ready to be parsed.
-		/// @remarks The deprecated header folding (having one long header split up into multiple lines)
+		/// @remarks Only headers which are evaluated by OpenKit (e.g. Retry-After) are kept, all other header lines
+		///          are skipped without copying any data.
+		///          The deprecated header folding (having one long header split up into multiple lines)
 		///          is not supported.
 		///          Furthermore do not assume that @c buffer is 0-terminated.
 		/// @param[in] buffer The header line to parse.
@@ -83,10 +85,13 @@ namespace protocol
 		static bool isWhitespace(char c);
 
 		///
-		/// Strip leading and trailing whitespace characters from the string.
-		/// @param[in,out] The string to strip.
+		/// Look up the given header key in the list of headers evaluated by OpenKit.
+		/// @remarks The comparison is case insensitive.
+		/// @param[in] keyBegin pointer to the first character of the key
+		/// @param[in] keyEnd pointer past the last character of the key
+		/// @return The lower case key if the header is of interest, @c nullptr otherwise.
 		///
-		static void stripWhitespaces(std::string& str);
+		static const char* findRelevantHeaderKey(const char* keyBegin, const char* keyEnd);
 
 		/// Response headers
 		Response::ResponseHeaders mResponseHeaders;
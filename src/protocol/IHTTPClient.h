@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "protocol/BeaconPayload.h"
 #include "protocol/StatusResponse.h"
 #include "configuration/HTTPClientConfiguration.h"
 #include "core/UTF8String.h"
@@ -53,6 +54,39 @@ namespace protocol
 		///
 		virtual std::shared_ptr<StatusResponse> sendBeaconRequest(const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData) = 0;
 
+		///
+		/// prepares beacon data for @ref sendEncodedBeaconRequest
+		/// @remarks This method may be called from another thread while a request is sent. The default
+		///          implementation does not compress the data.
+		/// @param[in] beaconData the beacon payload
+		/// @returns the encoded payload
+		///
+		virtual BeaconPayload encodeBeaconData(const core::UTF8String& beaconData)
+		{
+			return BeaconPayload(beaconData);
+		}
+
+		///
+		/// sends a beacon send request with a payload prepared by @ref encodeBeaconData and returns a status response
+		/// @param[in] clientIPAddress the client IP address
+		/// @param[in] payload the encoded beacon payload
+		/// @returns a status response with the response data for the request or @c nullptr on error
+		///
+		virtual std::shared_ptr<StatusResponse> sendEncodedBeaconRequest(const core::UTF8String& clientIPAddress, const BeaconPayload& payload)
+		{
+			return sendBeaconRequest(clientIPAddress, payload.getBeaconData());
+		}
+
+		///
+		/// returns the time the last request waited for the upload rate limit, which is not spent waiting for the server
+		/// @remarks The default implementation does not limit the upload rate.
+		/// @returns the time in milliseconds
+		///
+		virtual int64_t getLastRequestThrottledTime() const
+		{
+			return 0;
+		}
+
 		///
 		/// sends a new session request and returns a status response
 		/// @returns a status response with the response data for the request or @c nullptr on error
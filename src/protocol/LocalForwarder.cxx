@@ -0,0 +1,355 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "protocol/LocalForwarder.h"
+#include "protocol/ProtocolConstants.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <limits>
+
+using namespace protocol;
+
+const size_t LocalForwarder::DEFAULT_MAX_QUEUED_BEACONS = 1024;
+const size_t LocalForwarder::DEFAULT_MAX_BATCH_SIZE = 64;
+const int64_t LocalForwarder::DEFAULT_SHUTDOWN_TIMEOUT = 10000;
+const uint32_t LocalForwarder::NUM_CONNECTION_THREADS = 4;
+
+/// interval in milliseconds in which the accepting thread checks whether the forwarder was stopped
+static const int64_t ACCEPT_POLL_INTERVAL_MILLIS = 100;
+
+/// timeout in milliseconds for exchanging a frame with a local process
+static const int64_t CONNECTION_TIMEOUT_MILLIS = 5000;
+
+/// response code telling local processes to keep their beacon and retry later
+static const int32_t SERVICE_UNAVAILABLE = 503;
+
+/// response code acknowledging a beacon
+static const int32_t OK_RESPONSE_CODE = 200;
+
+static HTTPClient::RequestType toHTTPRequestType(LocalForwarderProtocol::RequestType requestType)
+{
+	switch (requestType)
+	{
+	case LocalForwarderProtocol::RequestType::BEACON:
+		return HTTPClient::RequestType::BEACON;
+	case LocalForwarderProtocol::RequestType::NEW_SESSION:
+		return HTTPClient::RequestType::NEW_SESSION;
+	default:
+		return HTTPClient::RequestType::STATUS;
+	}
+}
+
+///
+/// Returns whether a failed upload shall be retried, which is the case for connection errors,
+/// "too many requests" and server errors. Other erroneous responses reject the beacon for good.
+///
+static bool isRetryable(const LocalForwarderProtocol::ForwardedResponse& response)
+{
+	return response.responseCode == 429 || response.responseCode >= 500;
+}
+
+LocalForwarder::LocalForwarder(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::HTTPClientConfiguration> configuration, const std::string& socketPath,
+	size_t maxQueuedBeacons, size_t maxBatchSize, int64_t shutdownTimeout)
+	: mLogger(logger)
+	, mBaseURL(configuration->getBaseURL())
+	, mSocketPath(socketPath)
+	, mMaxQueuedBeacons(maxQueuedBeacons)
+	, mMaxBatchSize(std::max(maxBatchSize, size_t(1)))
+	, mInitialRetryDelay(std::max(configuration->getRetryPolicy()->getInitialRetryDelay(), int64_t(1)))
+	, mMaxRetryDelay(std::max(configuration->getRetryPolicy()->getMaxRetryDelay(), int64_t(1)))
+	, mShutdownTimeout(std::max(shutdownTimeout, int64_t(0)))
+	, mRequestClient(logger, configuration)
+	, mRequestMutex()
+	, mUploadClient(logger, configuration)
+	, mListeningSocket()
+	, mQueue()
+	, mQueueMutex()
+	, mIsUploading(false)
+	, mShutdownDeadline()
+	, mQueueCondition()
+	, mLastResponses()
+	, mLastResponsesMutex()
+	, mIsRunning(false)
+	, mAcceptThread()
+	, mConnectionPool()
+	, mUploadThread()
+	, mNumForwardedBeacons(0)
+	, mNumRejectedBeacons(0)
+	, mNumDroppedBeacons(0)
+{
+}
+
+LocalForwarder::~LocalForwarder()
+{
+	stop();
+}
+
+bool LocalForwarder::start()
+{
+	if (mIsRunning)
+	{
+		return true;
+	}
+
+	if (!mListeningSocket.listen(mSocketPath))
+	{
+		mLogger->error("LocalForwarder start() - cannot listen on '%s'", mSocketPath.c_str());
+		return false;
+	}
+
+	if (mLogger->isInfoEnabled())
+	{
+		mLogger->info("LocalForwarder start() - forwarding requests from '%s' to '%s'", mSocketPath.c_str(), mBaseURL.getStringData().c_str());
+	}
+
+	mIsRunning = true;
+	mIsUploading = true;
+	mConnectionPool = std::unique_ptr<core::util::WorkStealingThreadPool>(new core::util::WorkStealingThreadPool(NUM_CONNECTION_THREADS));
+	mAcceptThread = std::thread(&LocalForwarder::acceptLoop, this);
+	mUploadThread = std::thread(&LocalForwarder::uploadLoop, this);
+	return true;
+}
+
+void LocalForwarder::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mQueueMutex);
+		if (!mIsRunning)
+		{
+			return;
+		}
+		mIsRunning = false;
+	}
+
+	if (mAcceptThread.joinable())
+	{
+		mAcceptThread.join();
+	}
+
+	// the connections accepted so far are still handled and may queue further beacons
+	mConnectionPool.reset();
+	{
+		std::lock_guard<std::mutex> lock(mQueueMutex);
+		mIsUploading = false;
+		mShutdownDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(mShutdownTimeout);
+	}
+	mQueueCondition.notify_all();
+
+	if (mUploadThread.joinable())
+	{
+		mUploadThread.join();
+	}
+	mListeningSocket.close();
+}
+
+uint64_t LocalForwarder::getNumForwardedBeacons() const
+{
+	return mNumForwardedBeacons;
+}
+
+uint64_t LocalForwarder::getNumRejectedBeacons() const
+{
+	return mNumRejectedBeacons;
+}
+
+uint64_t LocalForwarder::getNumDroppedBeacons() const
+{
+	return mNumDroppedBeacons;
+}
+
+void LocalForwarder::acceptLoop()
+{
+	while (mIsRunning)
+	{
+		auto connection = std::make_shared<LocalSocket>();
+		if (mListeningSocket.accept(*connection, ACCEPT_POLL_INTERVAL_MILLIS))
+		{
+			mConnectionPool->submit([this, connection]() { handleConnection(*connection); });
+		}
+	}
+}
+
+void LocalForwarder::handleConnection(LocalSocket& connection)
+{
+	connection.setTimeout(CONNECTION_TIMEOUT_MILLIS);
+
+	std::string payload;
+	LocalForwarderProtocol::ForwardedRequest request;
+	if (!connection.readFrame(payload, LocalForwarderProtocol::MAX_FRAME_SIZE)
+		|| !LocalForwarderProtocol::decodeRequest(payload, request))
+	{
+		mLogger->warning("LocalForwarder handleConnection() - ignoring invalid request");
+		return;
+	}
+
+	LocalForwarderProtocol::ForwardedResponse response;
+	if (request.requestType == LocalForwarderProtocol::RequestType::BEACON)
+	{
+		enqueueBeacon(request, response);
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(mRequestMutex);
+		forwardRequest(mRequestClient, request, response);
+	}
+
+	LocalForwarderProtocol::encodeResponse(response, payload);
+	if (!connection.writeFrame(payload))
+	{
+		mLogger->warning("LocalForwarder handleConnection() - cannot send response");
+	}
+}
+
+void LocalForwarder::enqueueBeacon(const LocalForwarderProtocol::ForwardedRequest& request, LocalForwarderProtocol::ForwardedResponse& response)
+{
+	{
+		// without a known response of the server, the beacon is acknowledged without changing any settings
+		std::lock_guard<std::mutex> lock(mLastResponsesMutex);
+		auto lastResponse = mLastResponses.find(request.query);
+		if (lastResponse != mLastResponses.end())
+		{
+			response = lastResponse->second;
+		}
+		else
+		{
+			response.responseCode = OK_RESPONSE_CODE;
+			response.responseBody = REQUEST_TYPE_MOBILE;
+			response.responseHeaders.clear();
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mQueueMutex);
+		if (mQueue.size() >= mMaxQueuedBeacons)
+		{
+			mNumRejectedBeacons++;
+			response.responseCode = SERVICE_UNAVAILABLE;
+			response.responseBody.clear();
+			response.responseHeaders.clear();
+			return;
+		}
+		mQueue.push_back(request);
+	}
+	mQueueCondition.notify_one();
+}
+
+bool LocalForwarder::forwardRequest(HTTPClient& client, const LocalForwarderProtocol::ForwardedRequest& request, LocalForwarderProtocol::ForwardedResponse& response)
+{
+	core::UTF8String url(mBaseURL);
+	url.concatenate("?");
+	url.concatenate(request.query);
+
+	auto isResponseReceived = client.forwardRequest(toHTTPRequestType(request.requestType), url,
+		core::UTF8String(request.clientIPAddress.c_str()), core::UTF8String(request.beaconData.c_str()),
+		response.responseCode, response.responseBody, response.responseHeaders);
+
+	if (!isResponseReceived)
+	{
+		response.responseCode = std::numeric_limits<int32_t>::max();
+		response.responseBody.clear();
+		response.responseHeaders.clear();
+		return false;
+	}
+
+	// remember the response to acknowledge queued beacons with
+	if (response.responseCode < 400 && response.responseBody.find(REQUEST_TYPE_MOBILE) == 0)
+	{
+		std::lock_guard<std::mutex> lock(mLastResponsesMutex);
+		mLastResponses[request.query] = response;
+	}
+
+	return true;
+}
+
+void LocalForwarder::uploadLoop()
+{
+	int64_t retryDelay = 0;
+
+	while (true)
+	{
+		std::deque<LocalForwarderProtocol::ForwardedRequest> batch;
+		{
+			std::unique_lock<std::mutex> lock(mQueueMutex);
+			mQueueCondition.wait(lock, [this]() { return !mQueue.empty() || !mIsUploading; });
+			if (mQueue.empty())
+			{
+				return;
+			}
+
+			auto batchEnd = mQueue.begin() + std::min(mQueue.size(), mMaxBatchSize);
+			batch.assign(std::make_move_iterator(mQueue.begin()), std::make_move_iterator(batchEnd));
+			mQueue.erase(mQueue.begin(), batchEnd);
+		}
+
+		// upload the batch back to back over the same connection
+		while (!batch.empty())
+		{
+			LocalForwarderProtocol::ForwardedResponse response;
+			if (!forwardRequest(mUploadClient, batch.front(), response) || isRetryable(response))
+			{
+				break;
+			}
+
+			if (response.responseCode >= 400)
+			{
+				mLogger->warning("LocalForwarder uploadLoop() - beacon rejected by server with response code %d", response.responseCode);
+				mNumDroppedBeacons++;
+			}
+			else
+			{
+				mNumForwardedBeacons++;
+			}
+			batch.pop_front();
+		}
+
+		if (batch.empty())
+		{
+			retryDelay = 0;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mQueueMutex);
+		auto isStopping = !mIsUploading;
+		auto now = std::chrono::steady_clock::now();
+		if (isStopping && now >= mShutdownDeadline)
+		{
+			// the beacons were acknowledged, but cannot be uploaded within the shutdown timeout
+			mLogger->warning("LocalForwarder uploadLoop() - dropping %" PRIu64 " beacons not uploaded within the shutdown timeout",
+				static_cast<uint64_t>(batch.size() + mQueue.size()));
+			mNumDroppedBeacons += batch.size() + mQueue.size();
+			mQueue.clear();
+			return;
+		}
+
+		// keep the order of beacons and retry after a backoff
+		mQueue.insert(mQueue.begin(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+		retryDelay = retryDelay == 0 ? mInitialRetryDelay : std::min(retryDelay * 2, mMaxRetryDelay);
+		auto retryTime = now + std::chrono::milliseconds(retryDelay);
+		if (isStopping)
+		{
+			// the last retry happens at the shutdown deadline
+			mQueueCondition.wait_until(lock, std::min(retryTime, mShutdownDeadline));
+		}
+		else
+		{
+			// stopping retries right away, the backoff might exceed the shutdown timeout otherwise
+			mQueueCondition.wait_until(lock, retryTime, [this]() { return !mIsUploading; });
+		}
+	}
+}
@@ -0,0 +1,233 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _PROTOCOL_LOCALFORWARDER_H
+#define _PROTOCOL_LOCALFORWARDER_H
+
+#include "OpenKit/ILogger.h"
+#include "configuration/HTTPClientConfiguration.h"
+#include "core/util/WorkStealingThreadPool.h"
+#include "protocol/HTTPClient.h"
+#include "protocol/LocalForwarderProtocol.h"
+#include "protocol/LocalSocket.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace protocol
+{
+	///
+	/// Receives requests of @ref LocalSocketHTTPClient instances over a local socket and
+	/// forwards them to the server over reused connections.
+	///
+	/// Connections of local processes are handled by a small pool of threads, so that a slow request
+	/// does not hold up the others. Status and new session requests are forwarded synchronously.
+	/// Beacon requests never wait for the server: they are acknowledged right away with the last response
+	/// the server sent for the same query, or a plain OK response if there is none yet, and queued.
+	/// A background thread drains the queue in batches over its own connection, compresses the beacon data
+	/// and uploads it. Failed uploads are kept and retried with exponential backoff, while the queue is full
+	/// further beacons are rejected, so the sending processes keep them and retry later.
+	/// Since queued beacons were already acknowledged, stopping the forwarder keeps uploading and retrying them
+	/// until the queue is drained or the shutdown timeout expires.
+	///
+	class LocalForwarder
+	{
+	public:
+
+		///
+		/// Constructor
+		/// @param[in] logger to write traces to
+		/// @param[in] configuration configuration for the connection to the server, its base URL is the forwarding target
+		/// @param[in] socketPath file system path of the socket to listen on
+		/// @param[in] maxQueuedBeacons maximum number of beacons waiting for upload
+		/// @param[in] maxBatchSize maximum number of beacons uploaded in one batch
+		/// @param[in] shutdownTimeout time in milliseconds stopping keeps retrying failed uploads of queued beacons
+		///
+		LocalForwarder(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::HTTPClientConfiguration> configuration, const std::string& socketPath,
+			size_t maxQueuedBeacons = DEFAULT_MAX_QUEUED_BEACONS, size_t maxBatchSize = DEFAULT_MAX_BATCH_SIZE, int64_t shutdownTimeout = DEFAULT_SHUTDOWN_TIMEOUT);
+
+		///
+		/// Destructor, stops the forwarder
+		///
+		~LocalForwarder();
+
+		///
+		/// Delete the copy constructor
+		///
+		LocalForwarder(const LocalForwarder&) = delete;
+
+		///
+		/// Delete the assignment operator
+		///
+		LocalForwarder& operator = (const LocalForwarder&) = delete;
+
+		///
+		/// Starts listening on the socket and forwarding requests
+		/// @returns @c true if the forwarder was started, @c false if the socket could not be created
+		///
+		bool start();
+
+		///
+		/// Stops listening and uploads the queued beacons.
+		/// @remarks Failed uploads are retried until the shutdown timeout expires, beacons still queued then are dropped.
+		///
+		void stop();
+
+		///
+		/// Returns the number of beacons uploaded to the server
+		///
+		uint64_t getNumForwardedBeacons() const;
+
+		///
+		/// Returns the number of beacons rejected because the queue was full
+		///
+		uint64_t getNumRejectedBeacons() const;
+
+		///
+		/// Returns the number of acknowledged beacons which could not be uploaded
+		///
+		uint64_t getNumDroppedBeacons() const;
+
+		/// default maximum number of beacons waiting for upload
+		static const size_t DEFAULT_MAX_QUEUED_BEACONS;
+
+		/// default maximum number of beacons uploaded in one batch
+		static const size_t DEFAULT_MAX_BATCH_SIZE;
+
+		/// default time in milliseconds stopping keeps retrying failed uploads
+		static const int64_t DEFAULT_SHUTDOWN_TIMEOUT;
+
+		/// number of threads handling connections of local processes
+		static const uint32_t NUM_CONNECTION_THREADS;
+
+	private:
+
+		///
+		/// accepts connections until the forwarder is stopped
+		///
+		void acceptLoop();
+
+		///
+		/// reads a request from a connection and writes back the response
+		///
+		void handleConnection(LocalSocket& connection);
+
+		///
+		/// queues a beacon for upload and fills in the response acknowledging it
+		///
+		void enqueueBeacon(const LocalForwarderProtocol::ForwardedRequest& request, LocalForwarderProtocol::ForwardedResponse& response);
+
+		///
+		/// forwards a request to the server using the given client
+		/// @returns @c true if a response was received, @c false if the request failed
+		///
+		bool forwardRequest(HTTPClient& client, const LocalForwarderProtocol::ForwardedRequest& request, LocalForwarderProtocol::ForwardedResponse& response);
+
+		///
+		/// uploads queued beacons until the forwarder is stopped and the queue is drained
+		///
+		void uploadLoop();
+
+		/// Logger to write traces to
+		std::shared_ptr<openkit::ILogger> mLogger;
+
+		/// base URL of the server
+		const core::UTF8String mBaseURL;
+
+		/// file system path of the socket
+		const std::string mSocketPath;
+
+		/// maximum number of beacons waiting for upload
+		const size_t mMaxQueuedBeacons;
+
+		/// maximum number of beacons uploaded in one batch
+		const size_t mMaxBatchSize;
+
+		/// delay in milliseconds before the first retry of a failed upload
+		const int64_t mInitialRetryDelay;
+
+		/// upper bound in milliseconds of the retry delay
+		const int64_t mMaxRetryDelay;
+
+		/// time in milliseconds stopping keeps retrying failed uploads
+		const int64_t mShutdownTimeout;
+
+		/// client sending status and new session requests to the server, reusing its connection
+		HTTPClient mRequestClient;
+
+		/// serializes requests on the request client
+		std::mutex mRequestMutex;
+
+		/// client uploading queued beacons, only used by the upload thread
+		HTTPClient mUploadClient;
+
+		/// socket accepting connections of local processes
+		LocalSocket mListeningSocket;
+
+		/// beacons waiting for upload
+		std::deque<LocalForwarderProtocol::ForwardedRequest> mQueue;
+
+		/// guards the queue and the upload flag
+		std::mutex mQueueMutex;
+
+		/// whether the upload thread keeps waiting for beacons, cleared once no more beacons can be queued
+		bool mIsUploading;
+
+		/// time until which failed uploads are retried after the upload flag was cleared
+		std::chrono::steady_clock::time_point mShutdownDeadline;
+
+		/// signals queued beacons and stopping
+		std::condition_variable mQueueCondition;
+
+		/// last successful response of the server per query string
+		std::unordered_map<std::string, LocalForwarderProtocol::ForwardedResponse> mLastResponses;
+
+		/// guards the last responses
+		std::mutex mLastResponsesMutex;
+
+		/// whether the forwarder is running
+		std::atomic<bool> mIsRunning;
+
+		/// thread accepting connections
+		std::thread mAcceptThread;
+
+		/// threads handling accepted connections
+		std::unique_ptr<core::util::WorkStealingThreadPool> mConnectionPool;
+
+		/// thread uploading queued beacons
+		std::thread mUploadThread;
+
+		/// number of beacons uploaded to the server
+		std::atomic<uint64_t> mNumForwardedBeacons;
+
+		/// number of beacons rejected because the queue was full
+		std::atomic<uint64_t> mNumRejectedBeacons;
+
+		/// number of acknowledged beacons which could not be uploaded
+		std::atomic<uint64_t> mNumDroppedBeacons;
+	};
+}
+
+#endif
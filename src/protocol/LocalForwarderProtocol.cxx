@@ -0,0 +1,165 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "protocol/LocalForwarderProtocol.h"
+
+using namespace protocol;
+
+const uint8_t LocalForwarderProtocol::PROTOCOL_VERSION = 1;
+const uint32_t LocalForwarderProtocol::MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+static void appendUInt32(std::string& payload, uint32_t value)
+{
+	payload.push_back(static_cast<char>((value >> 24) & 0xFF));
+	payload.push_back(static_cast<char>((value >> 16) & 0xFF));
+	payload.push_back(static_cast<char>((value >> 8) & 0xFF));
+	payload.push_back(static_cast<char>(value & 0xFF));
+}
+
+static void appendString(std::string& payload, const std::string& value)
+{
+	appendUInt32(payload, static_cast<uint32_t>(value.size()));
+	payload.append(value);
+}
+
+static bool readUInt8(const std::string& payload, size_t& position, uint8_t& value)
+{
+	if (payload.size() - position < 1)
+	{
+		return false;
+	}
+	value = static_cast<uint8_t>(payload[position++]);
+	return true;
+}
+
+static bool readUInt32(const std::string& payload, size_t& position, uint32_t& value)
+{
+	if (payload.size() - position < 4)
+	{
+		return false;
+	}
+	value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		value = (value << 8) | static_cast<uint8_t>(payload[position++]);
+	}
+	return true;
+}
+
+static bool readString(const std::string& payload, size_t& position, std::string& value)
+{
+	uint32_t length = 0;
+	if (!readUInt32(payload, position, length) || payload.size() - position < length)
+	{
+		return false;
+	}
+	value.assign(payload, position, length);
+	position += length;
+	return true;
+}
+
+void LocalForwarderProtocol::encodeRequest(const ForwardedRequest& request, std::string& payload)
+{
+	payload.clear();
+	payload.reserve(1 + 1 + 12 + request.query.size() + request.clientIPAddress.size() + request.beaconData.size());
+	payload.push_back(static_cast<char>(PROTOCOL_VERSION));
+	payload.push_back(static_cast<char>(request.requestType));
+	appendString(payload, request.query);
+	appendString(payload, request.clientIPAddress);
+	appendString(payload, request.beaconData);
+}
+
+bool LocalForwarderProtocol::decodeRequest(const std::string& payload, ForwardedRequest& request)
+{
+	size_t position = 0;
+	uint8_t version = 0;
+	uint8_t requestType = 0;
+	if (!readUInt8(payload, position, version) || version != PROTOCOL_VERSION
+		|| !readUInt8(payload, position, requestType))
+	{
+		return false;
+	}
+
+	switch (static_cast<RequestType>(requestType))
+	{
+	case RequestType::STATUS:
+	case RequestType::BEACON:      // FALLTHROUGH
+	case RequestType::NEW_SESSION: // FALLTHROUGH
+		request.requestType = static_cast<RequestType>(requestType);
+		break;
+	default:
+		return false;
+	}
+
+	return readString(payload, position, request.query)
+		&& readString(payload, position, request.clientIPAddress)
+		&& readString(payload, position, request.beaconData)
+		&& position == payload.size();
+}
+
+void LocalForwarderProtocol::encodeResponse(const ForwardedResponse& response, std::string& payload)
+{
+	payload.clear();
+	payload.push_back(static_cast<char>(PROTOCOL_VERSION));
+	appendUInt32(payload, static_cast<uint32_t>(response.responseCode));
+	appendString(payload, response.responseBody);
+
+	uint32_t numHeaderValues = 0;
+	for (const auto& header : response.responseHeaders)
+	{
+		numHeaderValues += static_cast<uint32_t>(header.second.size());
+	}
+	appendUInt32(payload, numHeaderValues);
+	for (const auto& header : response.responseHeaders)
+	{
+		for (const auto& value : header.second)
+		{
+			appendString(payload, header.first);
+			appendString(payload, value);
+		}
+	}
+}
+
+bool LocalForwarderProtocol::decodeResponse(const std::string& payload, ForwardedResponse& response)
+{
+	size_t position = 0;
+	uint8_t version = 0;
+	uint32_t responseCode = 0;
+	uint32_t numHeaderValues = 0;
+	if (!readUInt8(payload, position, version) || version != PROTOCOL_VERSION
+		|| !readUInt32(payload, position, responseCode)
+		|| !readString(payload, position, response.responseBody)
+		|| !readUInt32(payload, position, numHeaderValues))
+	{
+		return false;
+	}
+	response.responseCode = static_cast<int32_t>(responseCode);
+
+	response.responseHeaders.clear();
+	for (uint32_t i = 0; i < numHeaderValues; i++)
+	{
+		std::string name;
+		std::string value;
+		if (!readString(payload, position, name) || !readString(payload, position, value))
+		{
+			return false;
+		}
+		response.responseHeaders[name].push_back(value);
+	}
+
+	return position == payload.size();
+}
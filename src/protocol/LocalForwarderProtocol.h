@@ -0,0 +1,145 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _PROTOCOL_LOCALFORWARDERPROTOCOL_H
+#define _PROTOCOL_LOCALFORWARDERPROTOCOL_H
+
+#include "protocol/Response.h"
+
+#include <cstdint>
+#include <string>
+
+namespace protocol
+{
+	///
+	/// Encoding of the frames exchanged between a @ref LocalSocketHTTPClient and a @ref LocalForwarder.
+	///
+	/// All integers are encoded big endian, strings are prefixed by their length as 32 bit integer.
+	/// A request frame consists of the protocol version, the request type, the query string,
+	/// the client IP address and the uncompressed beacon data.
+	/// A response frame consists of the protocol version, the HTTP response code, the response body
+	/// and the number of response headers followed by name/value pairs.
+	///
+	class LocalForwarderProtocol
+	{
+	public:
+
+		///
+		/// type of a forwarded request, the values are part of the wire format
+		///
+		enum class RequestType : uint8_t
+		{
+			STATUS = 1, ///< status check request
+			BEACON = 2, ///< beacon send request
+			NEW_SESSION = 3 ///< new session request
+		};
+
+		///
+		/// a request received from a local process
+		///
+		struct ForwardedRequest
+		{
+			ForwardedRequest()
+				: requestType(RequestType::STATUS)
+				, query()
+				, clientIPAddress()
+				, beaconData()
+			{
+			}
+
+			ForwardedRequest(RequestType requestType, const std::string& query, const std::string& clientIPAddress, const std::string& beaconData)
+				: requestType(requestType)
+				, query(query)
+				, clientIPAddress(clientIPAddress)
+				, beaconData(beaconData)
+			{
+			}
+
+			/// the type of request
+			RequestType requestType;
+
+			/// the query string of the request URL, without the leading '?'
+			std::string query;
+
+			/// optional IP address of the client
+			std::string clientIPAddress;
+
+			/// uncompressed beacon data of a beacon request
+			std::string beaconData;
+		};
+
+		///
+		/// a response returned to a local process
+		///
+		struct ForwardedResponse
+		{
+			ForwardedResponse()
+				: responseCode(0)
+				, responseBody()
+				, responseHeaders()
+			{
+			}
+
+			/// the HTTP response code
+			int32_t responseCode;
+
+			/// the HTTP response body
+			std::string responseBody;
+
+			/// the HTTP response headers
+			Response::ResponseHeaders responseHeaders;
+		};
+
+		///
+		/// Encodes a request into a frame payload
+		/// @param[in] request the request to encode
+		/// @param[out] payload receives the encoded request
+		///
+		static void encodeRequest(const ForwardedRequest& request, std::string& payload);
+
+		///
+		/// Decodes a request from a frame payload
+		/// @param[in] payload the encoded request
+		/// @param[out] request receives the decoded request
+		/// @returns @c true if the payload is a valid request, @c false otherwise
+		///
+		static bool decodeRequest(const std::string& payload, ForwardedRequest& request);
+
+		///
+		/// Encodes a response into a frame payload
+		/// @param[in] response the response to encode
+		/// @param[out] payload receives the encoded response
+		///
+		static void encodeResponse(const ForwardedResponse& response, std::string& payload);
+
+		///
+		/// Decodes a response from a frame payload
+		/// @param[in] payload the encoded response
+		/// @param[out] response receives the decoded response
+		/// @returns @c true if the payload is a valid response, @c false otherwise
+		///
+		static bool decodeResponse(const std::string& payload, ForwardedResponse& response);
+
+		/// version of the frame format
+		static const uint8_t PROTOCOL_VERSION;
+
+		/// upper bound of a frame's size, which is large enough for any beacon chunk
+		static const uint32_t MAX_FRAME_SIZE;
+	};
+}
+
+#endif
@@ -0,0 +1,316 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "protocol/LocalSocket.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32) || defined(WIN32)
+#include <winsock2.h>
+#include <afunix.h>
+#include <windows.h>
+using SocketHandle = SOCKET;
+#define closeSocket closesocket
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+using SocketHandle = int;
+#define closeSocket ::close
+#endif
+
+// do not raise SIGPIPE when the peer closed the connection
+#if defined(MSG_NOSIGNAL)
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+using namespace protocol;
+
+static void disableSigPipe(SocketHandle handle)
+{
+#if defined(SO_NOSIGPIPE)
+	int value = 1;
+	setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#else
+	(void)handle;
+#endif
+}
+
+///
+/// Initializes the socket library once per process, which is only required on Windows
+/// @returns @c true if sockets can be used
+///
+static bool initializeSockets()
+{
+#if defined(_WIN32) || defined(WIN32)
+	static const bool isInitialized = []()
+	{
+		WSADATA data;
+		return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	}();
+	return isInitialized;
+#else
+	return true;
+#endif
+}
+
+///
+/// Removes a socket file left behind by a previous instance, which prevents binding.
+/// Any other kind of file at the given path is left untouched.
+/// @returns @c true if nothing exists at the given path (anymore), @c false otherwise
+///
+static bool removeStaleSocketFile(const std::string& path)
+{
+#if defined(_WIN32) || defined(WIN32)
+	// Unix domain sockets are reparse points on Windows
+	auto attributes = GetFileAttributesA(path.c_str());
+	if (attributes == INVALID_FILE_ATTRIBUTES)
+	{
+		return true;
+	}
+	return (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0 && (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0
+		&& DeleteFileA(path.c_str()) != 0;
+#else
+	struct stat status;
+	if (lstat(path.c_str(), &status) != 0)
+	{
+		return errno == ENOENT;
+	}
+	return S_ISSOCK(status.st_mode) && unlink(path.c_str()) == 0;
+#endif
+}
+
+const intptr_t LocalSocket::INVALID_HANDLE = -1;
+
+static bool fillAddress(const std::string& path, sockaddr_un& address)
+{
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.empty() || path.size() >= sizeof(address.sun_path))
+	{
+		return false;
+	}
+	memcpy(address.sun_path, path.c_str(), path.size());
+	return true;
+}
+
+LocalSocket::LocalSocket()
+	: mHandle(INVALID_HANDLE)
+	, mListeningPath()
+{
+}
+
+LocalSocket::~LocalSocket()
+{
+	close();
+}
+
+bool LocalSocket::connect(const std::string& path, int64_t timeoutMillis)
+{
+	close();
+
+	sockaddr_un address;
+	if (!initializeSockets() || !fillAddress(path, address))
+	{
+		return false;
+	}
+
+	auto handle = socket(AF_UNIX, SOCK_STREAM, 0);
+	mHandle = static_cast<intptr_t>(handle);
+	if (mHandle == INVALID_HANDLE)
+	{
+		return false;
+	}
+
+	if (::connect(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		close();
+		return false;
+	}
+
+	disableSigPipe(handle);
+	setTimeout(timeoutMillis);
+	return true;
+}
+
+bool LocalSocket::listen(const std::string& path)
+{
+	close();
+
+	sockaddr_un address;
+	if (!initializeSockets() || !fillAddress(path, address) || !removeStaleSocketFile(path))
+	{
+		return false;
+	}
+
+	auto handle = socket(AF_UNIX, SOCK_STREAM, 0);
+	mHandle = static_cast<intptr_t>(handle);
+	if (mHandle == INVALID_HANDLE)
+	{
+		return false;
+	}
+
+	if (bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+		|| ::listen(handle, SOMAXCONN) != 0)
+	{
+		close();
+		return false;
+	}
+
+	mListeningPath = path;
+	return true;
+}
+
+bool LocalSocket::accept(LocalSocket& connection, int64_t timeoutMillis)
+{
+	if (!isOpen())
+	{
+		return false;
+	}
+
+	auto handle = static_cast<SocketHandle>(mHandle);
+	fd_set readSet;
+	FD_ZERO(&readSet);
+	FD_SET(handle, &readSet);
+	timeval timeout;
+	timeout.tv_sec = static_cast<long>(timeoutMillis / 1000);
+	timeout.tv_usec = static_cast<long>((timeoutMillis % 1000) * 1000);
+	if (select(static_cast<int>(handle + 1), &readSet, nullptr, nullptr, &timeout) <= 0)
+	{
+		return false;
+	}
+
+	auto accepted = ::accept(handle, nullptr, nullptr);
+	if (static_cast<intptr_t>(accepted) == INVALID_HANDLE)
+	{
+		return false;
+	}
+
+	disableSigPipe(accepted);
+	connection.close();
+	connection.mHandle = static_cast<intptr_t>(accepted);
+	return true;
+}
+
+void LocalSocket::setTimeout(int64_t timeoutMillis)
+{
+	if (!isOpen())
+	{
+		return;
+	}
+
+	auto handle = static_cast<SocketHandle>(mHandle);
+#if defined(_WIN32) || defined(WIN32)
+	DWORD timeout = static_cast<DWORD>(timeoutMillis);
+#else
+	timeval timeout;
+	timeout.tv_sec = static_cast<time_t>(timeoutMillis / 1000);
+	timeout.tv_usec = static_cast<suseconds_t>((timeoutMillis % 1000) * 1000);
+#endif
+	setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+	setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+bool LocalSocket::writeFrame(const std::string& payload)
+{
+	auto length = static_cast<uint32_t>(payload.size());
+	char header[4] =
+	{
+		static_cast<char>((length >> 24) & 0xFF),
+		static_cast<char>((length >> 16) & 0xFF),
+		static_cast<char>((length >> 8) & 0xFF),
+		static_cast<char>(length & 0xFF)
+	};
+
+	return sendAll(header, sizeof(header)) && sendAll(payload.data(), payload.size());
+}
+
+bool LocalSocket::readFrame(std::string& payload, uint32_t maxFrameSize)
+{
+	unsigned char header[4];
+	if (!receiveAll(reinterpret_cast<char*>(header), sizeof(header)))
+	{
+		return false;
+	}
+
+	auto length = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) | (uint32_t(header[2]) << 8) | uint32_t(header[3]);
+	if (length > maxFrameSize)
+	{
+		return false;
+	}
+
+	payload.resize(length);
+	return length == 0 || receiveAll(&payload[0], length);
+}
+
+void LocalSocket::close()
+{
+	if (mHandle != INVALID_HANDLE)
+	{
+		closeSocket(static_cast<SocketHandle>(mHandle));
+		mHandle = INVALID_HANDLE;
+	}
+	if (!mListeningPath.empty())
+	{
+		std::remove(mListeningPath.c_str());
+		mListeningPath.clear();
+	}
+}
+
+bool LocalSocket::isOpen() const
+{
+	return mHandle != INVALID_HANDLE;
+}
+
+bool LocalSocket::sendAll(const char* data, size_t length)
+{
+	auto handle = static_cast<SocketHandle>(mHandle);
+	while (length > 0)
+	{
+		auto sent = send(handle, data, static_cast<int>(length), SEND_FLAGS);
+		if (sent <= 0)
+		{
+			return false;
+		}
+		data += sent;
+		length -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+bool LocalSocket::receiveAll(char* data, size_t length)
+{
+	auto handle = static_cast<SocketHandle>(mHandle);
+	while (length > 0)
+	{
+		auto received = recv(handle, data, static_cast<int>(length), 0);
+		if (received <= 0)
+		{
+			return false;
+		}
+		data += received;
+		length -= static_cast<size_t>(received);
+	}
+	return true;
+}
@@ -0,0 +1,136 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _PROTOCOL_LOCALSOCKET_H
+#define _PROTOCOL_LOCALSOCKET_H
+
+#include <cstdint>
+#include <string>
+
+namespace protocol
+{
+	///
+	/// Stream socket in the local (Unix) domain exchanging length prefixed frames.
+	///
+	/// Each frame is sent as a 4 byte big endian length followed by the payload.
+	/// On Windows local sockets are available starting with Windows 10 (version 1803);
+	/// the socket library is initialized by @ref HTTPClient::globalInit.
+	///
+	class LocalSocket
+	{
+	public:
+
+		///
+		/// Constructs a socket which is not yet connected
+		///
+		LocalSocket();
+
+		///
+		/// Destructor, closes the socket
+		///
+		~LocalSocket();
+
+		///
+		/// Delete the copy constructor
+		///
+		LocalSocket(const LocalSocket&) = delete;
+
+		///
+		/// Delete the assignment operator
+		///
+		LocalSocket& operator = (const LocalSocket&) = delete;
+
+		///
+		/// Connects to a listening socket
+		/// @param[in] path the file system path of the listening socket
+		/// @param[in] timeoutMillis timeout in milliseconds for sending and receiving a frame
+		/// @returns @c true if the connection was established, @c false otherwise
+		///
+		bool connect(const std::string& path, int64_t timeoutMillis);
+
+		///
+		/// Creates a listening socket, replacing a stale socket file left at the same path.
+		/// If any other kind of file exists at the path, it is left untouched and listening fails.
+		/// @param[in] path the file system path of the socket
+		/// @returns @c true if the socket is listening, @c false otherwise
+		///
+		bool listen(const std::string& path);
+
+		///
+		/// Waits for an incoming connection on a listening socket
+		/// @param[out] connection receives the accepted connection
+		/// @param[in] timeoutMillis maximum time in milliseconds to wait for a connection
+		/// @returns @c true if a connection was accepted, @c false if the timeout elapsed or an error occurred
+		///
+		bool accept(LocalSocket& connection, int64_t timeoutMillis);
+
+		///
+		/// Sets the timeout for sending and receiving a frame
+		/// @param[in] timeoutMillis timeout in milliseconds
+		///
+		void setTimeout(int64_t timeoutMillis);
+
+		///
+		/// Sends a frame
+		/// @param[in] payload the frame payload
+		/// @returns @c true if the whole frame was sent, @c false otherwise
+		///
+		bool writeFrame(const std::string& payload);
+
+		///
+		/// Receives a frame
+		/// @param[out] payload receives the frame payload
+		/// @param[in] maxFrameSize frames larger than this size are rejected
+		/// @returns @c true if a whole frame was received, @c false otherwise
+		///
+		bool readFrame(std::string& payload, uint32_t maxFrameSize);
+
+		///
+		/// Closes the socket. The socket file of a listening socket is removed.
+		///
+		void close();
+
+		///
+		/// Returns whether the socket is open
+		/// @returns @c true if the socket is connected or listening, @c false otherwise
+		///
+		bool isOpen() const;
+
+	private:
+
+		///
+		/// Sends all given bytes
+		///
+		bool sendAll(const char* data, size_t length);
+
+		///
+		/// Receives exactly the given number of bytes
+		///
+		bool receiveAll(char* data, size_t length);
+
+		/// native socket handle, or @c INVALID_HANDLE if not open
+		intptr_t mHandle;
+
+		/// file system path of a listening socket
+		std::string mListeningPath;
+
+		/// value of an unused socket handle
+		static const intptr_t INVALID_HANDLE;
+	};
+}
+
+#endif
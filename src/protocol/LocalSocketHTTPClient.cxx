@@ -0,0 +1,105 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "protocol/LocalSocketHTTPClient.h"
+#include "protocol/HTTPClient.h"
+#include "protocol/LocalSocket.h"
+#include "protocol/ProtocolConstants.h"
+
+#include <limits>
+
+using namespace protocol;
+
+LocalSocketHTTPClient::LocalSocketHTTPClient(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::HTTPClientConfiguration> configuration, const std::string& socketPath)
+	: mLogger(logger)
+	, mSocketPath(socketPath)
+	, mMonitorQuery()
+	, mNewSessionQuery()
+	, mReadTimeout(configuration->getRetryPolicy()->getReadTimeout())
+{
+	core::UTF8String monitorQuery;
+	HTTPClient::buildMonitorQuery(monitorQuery, configuration->getApplicationID(), configuration->getServerID());
+	mMonitorQuery = monitorQuery.getStringData();
+
+	core::UTF8String newSessionQuery;
+	HTTPClient::buildNewSessionQuery(newSessionQuery, configuration->getApplicationID(), configuration->getServerID());
+	mNewSessionQuery = newSessionQuery.getStringData();
+}
+
+std::shared_ptr<StatusResponse> LocalSocketHTTPClient::sendStatusRequest()
+{
+	LocalForwarderProtocol::ForwardedRequest request = { LocalForwarderProtocol::RequestType::STATUS, mMonitorQuery, std::string(), std::string() };
+	return sendRequestInternal(request);
+}
+
+std::shared_ptr<StatusResponse> LocalSocketHTTPClient::sendBeaconRequest(const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData)
+{
+	LocalForwarderProtocol::ForwardedRequest request = { LocalForwarderProtocol::RequestType::BEACON, mMonitorQuery, clientIPAddress.getStringData(), beaconData.getStringData() };
+	return sendRequestInternal(request);
+}
+
+std::shared_ptr<StatusResponse> LocalSocketHTTPClient::sendNewSessionRequest()
+{
+	LocalForwarderProtocol::ForwardedRequest request = { LocalForwarderProtocol::RequestType::NEW_SESSION, mNewSessionQuery, std::string(), std::string() };
+	return sendRequestInternal(request);
+}
+
+std::shared_ptr<StatusResponse> LocalSocketHTTPClient::sendRequestInternal(const LocalForwarderProtocol::ForwardedRequest& request)
+{
+	std::string payload;
+	LocalForwarderProtocol::encodeRequest(request, payload);
+
+	LocalSocket socket;
+	if (!socket.connect(mSocketPath, mReadTimeout))
+	{
+		mLogger->error("LocalSocketHTTPClient sendRequestInternal() - cannot connect to forwarder at '%s'", mSocketPath.c_str());
+		return unknownErrorResponse();
+	}
+
+	LocalForwarderProtocol::ForwardedResponse response;
+	if (!socket.writeFrame(payload)
+		|| !socket.readFrame(payload, LocalForwarderProtocol::MAX_FRAME_SIZE)
+		|| !LocalForwarderProtocol::decodeResponse(payload, response))
+	{
+		mLogger->error("LocalSocketHTTPClient sendRequestInternal() - request to forwarder at '%s' failed", mSocketPath.c_str());
+		return unknownErrorResponse();
+	}
+
+	if (mLogger->isDebugEnabled())
+	{
+		mLogger->debug("LocalSocketHTTPClient sendRequestInternal() - Response: %s", response.responseBody.c_str());
+		mLogger->debug("LocalSocketHTTPClient sendRequestInternal() - Response Code: %d", response.responseCode);
+	}
+
+	// same evaluation as for responses received directly from the server
+	if (response.responseCode >= 400)
+	{
+		return std::make_shared<StatusResponse>(mLogger, core::UTF8String(), response.responseCode, response.responseHeaders);
+	}
+	if (response.responseBody.find(REQUEST_TYPE_MOBILE) == 0)
+	{
+		return std::make_shared<StatusResponse>(mLogger, core::UTF8String(response.responseBody.c_str()), response.responseCode, response.responseHeaders);
+	}
+
+	mLogger->warning("LocalSocketHTTPClient sendRequestInternal() - Ignoring response - unknown request type in response [%s]", response.responseBody.c_str());
+	return unknownErrorResponse();
+}
+
+std::shared_ptr<StatusResponse> LocalSocketHTTPClient::unknownErrorResponse()
+{
+	return std::make_shared<StatusResponse>(mLogger, core::UTF8String(), std::numeric_limits<int32_t>::max(), Response::ResponseHeaders());
+}
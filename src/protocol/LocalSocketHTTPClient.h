@@ -0,0 +1,86 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _PROTOCOL_LOCALSOCKETHTTPCLIENT_H
+#define _PROTOCOL_LOCALSOCKETHTTPCLIENT_H
+
+#include "OpenKit/ILogger.h"
+#include "protocol/IHTTPClient.h"
+#include "protocol/LocalForwarderProtocol.h"
+
+#include <memory>
+#include <string>
+
+namespace protocol
+{
+	///
+	/// HTTP client which hands requests to a @ref LocalForwarder over a local socket
+	/// instead of sending them to the server itself.
+	///
+	/// Beacon data is written uncompressed, compression, TLS and connection handling
+	/// are left to the forwarder, which is shared by all processes on the host.
+	///
+	class LocalSocketHTTPClient : public IHTTPClient
+	{
+	public:
+
+		///
+		/// Constructor
+		/// @param[in] logger to write traces to
+		/// @param[in] configuration configuration parameters for the requests
+		/// @param[in] socketPath file system path of the forwarder's socket
+		///
+		LocalSocketHTTPClient(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::HTTPClientConfiguration> configuration, const std::string& socketPath);
+
+		virtual std::shared_ptr<StatusResponse> sendStatusRequest() override;
+
+		virtual std::shared_ptr<StatusResponse> sendBeaconRequest(const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData) override;
+
+		virtual std::shared_ptr<StatusResponse> sendNewSessionRequest() override;
+
+	private:
+
+		///
+		/// sends a request to the forwarder and waits for its response
+		/// @param[in] request the request to send
+		/// @returns the status response, or an error response if the forwarder could not be reached
+		///
+		std::shared_ptr<StatusResponse> sendRequestInternal(const LocalForwarderProtocol::ForwardedRequest& request);
+
+		///
+		/// Returns the response for requests which did not receive a response
+		///
+		std::shared_ptr<StatusResponse> unknownErrorResponse();
+
+		/// Logger to write traces to
+		std::shared_ptr<openkit::ILogger> mLogger;
+
+		/// file system path of the forwarder's socket
+		const std::string mSocketPath;
+
+		/// query string for status check and beacon send requests
+		std::string mMonitorQuery;
+
+		/// query string for new session requests
+		std::string mNewSessionQuery;
+
+		/// timeout in milliseconds for the whole request
+		int64_t mReadTimeout;
+	};
+}
+
+#endif
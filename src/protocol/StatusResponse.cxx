@@ -24,9 +24,9 @@ constexpr char RESPONSE_KEY_CAPTURE_CRASHES[] = "cr";
 constexpr char RESPONSE_KEY_MULTIPLICITY[] = "mp";
 
 #include "StatusResponse.h"
+#include "core/util/StringUtil.h"
 
-#include <stdexcept>
-#include <sstream>
+#include <algorithm>
 
 using namespace protocol;
 
@@ -44,55 +44,87 @@ StatusResponse::StatusResponse(std::shared_ptr<openkit::ILogger> logger, const c
 	parseResponse(response);
 }
 
+///
+/// Compare the key given by the character range [@c begin, @c end) with a 0-terminated key.
+///
+template <size_t N>
+static bool isKey(const char* begin, const char* end, const char (&key)[N])
+{
+	return static_cast<size_t>(end - begin) == N - 1 && std::equal(begin, end, key);
+}
+
 void StatusResponse::parseResponse(const core::UTF8String& response)
 {
-	auto parts = response.split('&');
-	for (auto const& part : parts)
+	// single pass over the raw response data, key-value pairs are separated by '&'
+	const auto& responseData = response.getStringData();
+	auto current = responseData.data();
+	auto end = current + responseData.size();
+
+	while (current < end)
 	{
-		auto found = part.getIndexOf("="); 
-		if (found != std::string::npos)
+		auto partEnd = std::find(current, end, '&');
+		auto separator = std::find(current, partEnd, '=');
+		if (separator != partEnd)
 		{
-			auto key = part.substring(0, found);
-			auto value = part.substring(found + 1);
+			auto keyBegin = current;
+			auto keyEnd = separator;
+			auto valueBegin = separator + 1;
+			auto valueEnd = partEnd;
 
-			if (!key.empty() && !value.empty())
+			if (keyBegin != keyEnd && valueBegin != valueEnd)
 			{
-				if (key.equals(RESPONSE_KEY_CAPTURE))
-				{
-					mCapture = std::stoi(value.getStringData()) == 1;
-				}
-				else if (key.equals(RESPONSE_KEY_SEND_INTERVAL))
-				{
-					mSendInterval = std::stoi(value.getStringData()) * 1000;
-				}
-				else if (key.equals(RESPONSE_KEY_MONITOR_NAME))
-				{
-					mMonitorName = core::UTF8String(value);
-				}
-				else if (key.equals(RESPONSE_KEY_SERVER_ID))
-				{
-					mServerID = std::stoi(value.getStringData());
-				}
-				else if (key.equals(RESPONSE_KEY_MAX_BEACON_SIZE))
-				{
-					mMaxBeaconSize = std::stoi(value.getStringData());
-				}
-				else if (key.equals(RESPONSE_KEY_CAPTURE_ERRORS))
-				{
-					/* 1 (always on) and 2 (only on WiFi) are treated the same */
-					mCaptureErrors = std::stoi(value.getStringData()) != 0;
-				}
-				else if (key.equals(RESPONSE_KEY_CAPTURE_CRASHES))
-				{
-					/* 1 (always on) and 2 (only on WiFi) are treated the same */
-					mCaptureCrashes = std::stoi(value.getStringData()) != 0;
-				}
-				else if (key.equals(RESPONSE_KEY_MULTIPLICITY))
-				{
-					mMultiplicity = std::stoi(value.getStringData());
-				}
+				parseKeyValue(keyBegin, keyEnd, valueBegin, valueEnd);
 			}
 		}
+
+		current = partEnd == end ? end : partEnd + 1;
+	}
+}
+
+void StatusResponse::parseKeyValue(const char* keyBegin, const char* keyEnd, const char* valueBegin, const char* valueEnd)
+{
+	if (isKey(keyBegin, keyEnd, RESPONSE_KEY_MONITOR_NAME))
+	{
+		mMonitorName = core::UTF8String(std::string(valueBegin, valueEnd));
+		return;
+	}
+
+	int32_t value;
+	if (!core::util::StringUtil::tryParseInt32(valueBegin, valueEnd, value))
+	{
+		return; // invalid or out of range, keep the current value
+	}
+
+	if (isKey(keyBegin, keyEnd, RESPONSE_KEY_CAPTURE))
+	{
+		mCapture = value == 1;
+	}
+	else if (isKey(keyBegin, keyEnd, RESPONSE_KEY_SEND_INTERVAL))
+	{
+		// value is given in seconds, multiplication wraps around like 32 bit arithmetic
+		mSendInterval = static_cast<int32_t>(static_cast<uint32_t>(value) * 1000u);
+	}
+	else if (isKey(keyBegin, keyEnd, RESPONSE_KEY_SERVER_ID))
+	{
+		mServerID = value;
+	}
+	else if (isKey(keyBegin, keyEnd, RESPONSE_KEY_MAX_BEACON_SIZE))
+	{
+		mMaxBeaconSize = value;
+	}
+	else if (isKey(keyBegin, keyEnd, RESPONSE_KEY_CAPTURE_ERRORS))
+	{
+		/* 1 (always on) and 2 (only on WiFi) are treated the same */
+		mCaptureErrors = value != 0;
+	}
+	else if (isKey(keyBegin, keyEnd, RESPONSE_KEY_CAPTURE_CRASHES))
+	{
+		/* 1 (always on) and 2 (only on WiFi) are treated the same */
+		mCaptureCrashes = value != 0;
+	}
+	else if (isKey(keyBegin, keyEnd, RESPONSE_KEY_MULTIPLICITY))
+	{
+		mMultiplicity = value;
 	}
 }
 
@@ -98,6 +98,15 @@ namespace protocol
 		/// @param[in] response the response string obtained from the server
 		///
 		void parseResponse(const core::UTF8String& response);
+
+		///
+		/// Apply a single key-value pair given as raw character ranges of the response
+		/// @param[in] keyBegin pointer to the first character of the key
+		/// @param[in] keyEnd pointer past the last character of the key
+		/// @param[in] valueBegin pointer to the first character of the value
+		/// @param[in] valueEnd pointer past the last character of the value
+		///
+		void parseKeyValue(const char* keyBegin, const char* keyEnd, const char* valueBegin, const char* valueEnd);
 	private:
 
 		/// capture on/off
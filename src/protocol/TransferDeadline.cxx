@@ -0,0 +1,59 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "TransferDeadline.h"
+
+#include <chrono>
+
+using namespace protocol;
+
+TransferDeadline::TransferDeadline()
+	: mDeadline(-1)
+{
+}
+
+void TransferDeadline::expireAfter(int64_t timeoutMillis)
+{
+	mDeadline = now() + (timeoutMillis > 0 ? timeoutMillis : 0);
+}
+
+bool TransferDeadline::isSet() const
+{
+	return mDeadline >= 0;
+}
+
+bool TransferDeadline::isExpired() const
+{
+	auto deadline = mDeadline.load();
+	return deadline >= 0 && now() >= deadline;
+}
+
+int64_t TransferDeadline::getRemainingMilliseconds() const
+{
+	auto deadline = mDeadline.load();
+	if (deadline < 0)
+	{
+		return -1;
+	}
+
+	auto remaining = deadline - now();
+	return remaining > 0 ? remaining : 0;
+}
+
+int64_t TransferDeadline::now()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
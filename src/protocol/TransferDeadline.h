@@ -0,0 +1,76 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _PROTOCOL_TRANSFERDEADLINE_H
+#define _PROTOCOL_TRANSFERDEADLINE_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace protocol
+{
+	///
+	/// Point in time after which no request may be in flight anymore.
+	///
+	/// The deadline is set when OpenKit is shut down with a timeout and shared by all HTTP clients. Requests
+	/// started afterwards are bounded by the remaining time, requests already in flight are aborted from curl's
+	/// progress callback once the deadline expired. Until a deadline is set, requests are only bounded by the
+	/// timeouts of the @ref configuration::RetryPolicy.
+	///
+	class TransferDeadline
+	{
+	public:
+		///
+		/// Constructor, no deadline is set
+		///
+		TransferDeadline();
+
+		///
+		/// Sets the deadline relative to now.
+		/// @param[in] timeoutMillis time in milliseconds until the deadline expires, negative values are treated as @c 0
+		///
+		void expireAfter(int64_t timeoutMillis);
+
+		///
+		/// Returns whether a deadline is set at all.
+		/// @returns @c true if @ref expireAfter was called, @c false otherwise
+		///
+		bool isSet() const;
+
+		///
+		/// Returns whether the deadline has expired.
+		/// @returns @c true if a deadline is set and has passed, @c false otherwise
+		///
+		bool isExpired() const;
+
+		///
+		/// Returns the time left until the deadline expires.
+		/// @returns the remaining time in milliseconds, @c 0 if expired or @c -1 if no deadline is set
+		///
+		int64_t getRemainingMilliseconds() const;
+
+	private:
+		///
+		/// Returns the current time of the monotonic clock in milliseconds
+		///
+		static int64_t now();
+
+		/// the deadline in milliseconds of the monotonic clock, @c -1 if no deadline is set
+		std::atomic<int64_t> mDeadline;
+	};
+}
+
+#endif
@@ -0,0 +1,157 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#include "UploadRateLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace protocol;
+
+const int64_t UploadRateLimiter::DEFAULT_BYTES_PER_SECOND = -1;
+const int64_t UploadRateLimiter::DEFAULT_BURST_SIZE = -1;
+
+/// fraction of a second an upload waits at least, to avoid waking up for every single byte
+static const int64_t MINIMUM_GRANT_DIVISOR = 20;
+
+UploadRateLimiter::UploadRateLimiter(std::shared_ptr<providers::ITimingProvider> timingProvider, int64_t bytesPerSecond, int64_t burstSize)
+	: mTimingProvider(timingProvider)
+	, mBytesPerSecond(bytesPerSecond)
+	, mBurstSize(burstSize > 0 ? burstSize : std::max(bytesPerSecond, int64_t(1)))
+	, mAvailableBytes(static_cast<double>(mBurstSize))
+	, mLastRefillTime(isEnabled() ? timingProvider->provideTimestampInMilliseconds() : 0)
+	, mNumWaiting(0)
+	, mTotalThrottledTime(0)
+	, mTotalUploadedBytes(0)
+	, mMutex()
+{
+}
+
+bool UploadRateLimiter::isEnabled() const
+{
+	return mBytesPerSecond > 0;
+}
+
+size_t UploadRateLimiter::acquire(size_t numBytes)
+{
+	int64_t throttledTime = 0;
+	return acquire(numBytes, throttledTime);
+}
+
+size_t UploadRateLimiter::acquire(size_t numBytes, int64_t& throttledTime)
+{
+	throttledTime = 0;
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!isEnabled() || numBytes == 0)
+	{
+		mTotalUploadedBytes += numBytes;
+		return numBytes;
+	}
+
+	auto minimumGrant = getMinimumGrant(numBytes);
+	refill();
+	while (mAvailableBytes < minimumGrant)
+	{
+		auto waitTime = static_cast<int64_t>(std::ceil((minimumGrant - mAvailableBytes) * 1000.0 / mBytesPerSecond));
+
+		mNumWaiting++;
+		lock.unlock();
+		mTimingProvider->sleep(waitTime);
+		lock.lock();
+		mNumWaiting--;
+
+		mTotalThrottledTime += waitTime;
+		throttledTime += waitTime;
+		refill();
+	}
+
+	auto granted = std::min(numBytes, static_cast<size_t>(mAvailableBytes));
+	mAvailableBytes -= static_cast<double>(granted);
+	mTotalUploadedBytes += granted;
+
+	return granted;
+}
+
+int64_t UploadRateLimiter::getWaitTime(size_t numBytes)
+{
+	if (!isEnabled())
+	{
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	refill();
+	auto missingBytes = static_cast<double>(numBytes) - mAvailableBytes;
+	if (missingBytes <= 0)
+	{
+		return 0;
+	}
+
+	return static_cast<int64_t>(std::ceil(missingBytes * 1000.0 / mBytesPerSecond));
+}
+
+bool UploadRateLimiter::isThrottled()
+{
+	if (!isEnabled())
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	refill();
+	return mNumWaiting > 0 || mAvailableBytes < getMinimumGrant(static_cast<size_t>(mBurstSize));
+}
+
+openkit::UploadThrottleState UploadRateLimiter::getThrottleState()
+{
+	auto throttled = isThrottled();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	openkit::UploadThrottleState state;
+	state.isEnabled = isEnabled();
+	state.isThrottled = throttled;
+	state.availableBytes = isEnabled() ? static_cast<int64_t>(mAvailableBytes) : -1;
+	state.totalThrottledTimeInMilliseconds = mTotalThrottledTime;
+	state.totalUploadedBytes = mTotalUploadedBytes;
+
+	return state;
+}
+
+int64_t UploadRateLimiter::getBytesPerSecond() const
+{
+	return mBytesPerSecond;
+}
+
+int64_t UploadRateLimiter::getBurstSize() const
+{
+	return mBurstSize;
+}
+
+void UploadRateLimiter::refill()
+{
+	auto now = mTimingProvider->provideTimestampInMilliseconds();
+	auto elapsed = now - mLastRefillTime;
+	if (elapsed > 0)
+	{
+		mAvailableBytes = std::min(static_cast<double>(mBurstSize), mAvailableBytes + elapsed * mBytesPerSecond / 1000.0);
+		mLastRefillTime = now;
+	}
+}
+
+double UploadRateLimiter::getMinimumGrant(size_t numBytes) const
+{
+	auto minimumGrant = std::max(std::min(mBurstSize, mBytesPerSecond / MINIMUM_GRANT_DIVISOR), int64_t(1));
+	return static_cast<double>(std::min(static_cast<int64_t>(numBytes), minimumGrant));
+}
@@ -0,0 +1,151 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+#ifndef _PROTOCOL_UPLOADRATELIMITER_H
+#define _PROTOCOL_UPLOADRATELIMITER_H
+
+#include "OpenKit/UploadThrottleState.h"
+#include "providers/ITimingProvider.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace protocol
+{
+	///
+	/// Token bucket limiting the number of bytes uploaded per second.
+	///
+	/// The bucket holds up to @c burstSize bytes and is refilled with @c bytesPerSecond. Uploads take bytes
+	/// out of the bucket while curl reads the request body and wait for the bucket to be refilled if it is empty.
+	/// The beacon sending states check @ref isThrottled to defer further uploads instead of waiting.
+	///
+	class UploadRateLimiter
+	{
+	public:
+
+		///
+		/// Constructor
+		/// @param[in] timingProvider timing provider used to refill the bucket and to wait for it
+		/// @param[in] bytesPerSecond upload rate in bytes per second, or unlimited if not positive
+		/// @param[in] burstSize maximum number of bytes which can be uploaded without delay,
+		///            one second of upload rate is used if not positive
+		///
+		UploadRateLimiter(std::shared_ptr<providers::ITimingProvider> timingProvider, int64_t bytesPerSecond, int64_t burstSize);
+
+		///
+		/// Returns whether uploads are rate limited at all.
+		/// @returns @c true if an upload rate is configured, @c false otherwise
+		///
+		bool isEnabled() const;
+
+		///
+		/// Takes bytes to upload out of the bucket, waiting for the bucket to be refilled if necessary.
+		/// @remarks If the bucket does not hold enough bytes, less than @c numBytes may be granted.
+		/// @param[in] numBytes number of bytes which are about to be uploaded
+		/// @returns number of bytes which may be uploaded, which is at least @c 1 if @c numBytes is not @c 0
+		///
+		size_t acquire(size_t numBytes);
+
+		///
+		/// Takes bytes to upload out of the bucket, waiting for the bucket to be refilled if necessary.
+		/// @remarks If the bucket does not hold enough bytes, less than @c numBytes may be granted.
+		/// @param[in] numBytes number of bytes which are about to be uploaded
+		/// @param[out] throttledTime time in milliseconds spent waiting for the bucket to be refilled
+		/// @returns number of bytes which may be uploaded, which is at least @c 1 if @c numBytes is not @c 0
+		///
+		size_t acquire(size_t numBytes, int64_t& throttledTime);
+
+		///
+		/// Returns the estimated time until the given number of bytes can be uploaded without delay.
+		/// @param[in] numBytes number of bytes to upload
+		/// @returns the time to wait in milliseconds
+		///
+		int64_t getWaitTime(size_t numBytes);
+
+		///
+		/// Returns whether the bucket is currently exhausted, thus uploads would have to wait.
+		/// @returns @c true if uploads are throttled, @c false otherwise
+		///
+		bool isThrottled();
+
+		///
+		/// Returns a snapshot of the current throttle state
+		/// @returns the throttle state
+		///
+		openkit::UploadThrottleState getThrottleState();
+
+		///
+		/// Returns the upload rate
+		/// @returns the upload rate in bytes per second, or a non-positive value if unlimited
+		///
+		int64_t getBytesPerSecond() const;
+
+		///
+		/// Returns the burst size
+		/// @returns the maximum number of bytes which can be uploaded without delay
+		///
+		int64_t getBurstSize() const;
+
+		/// default upload rate (unlimited)
+		static const int64_t DEFAULT_BYTES_PER_SECOND;
+
+		/// default burst size (one second of upload rate)
+		static const int64_t DEFAULT_BURST_SIZE;
+
+	private:
+
+		///
+		/// Adds the bytes accumulated since the last refill to the bucket.
+		/// Must be called with @c mMutex held.
+		///
+		void refill();
+
+		///
+		/// Returns the number of bytes which must be available before an upload of the given size may continue.
+		///
+		double getMinimumGrant(size_t numBytes) const;
+
+		/// timing provider
+		std::shared_ptr<providers::ITimingProvider> mTimingProvider;
+
+		/// upload rate in bytes per second
+		const int64_t mBytesPerSecond;
+
+		/// capacity of the bucket in bytes
+		const int64_t mBurstSize;
+
+		/// bytes currently in the bucket
+		double mAvailableBytes;
+
+		/// timestamp of the last refill
+		int64_t mLastRefillTime;
+
+		/// number of uploads currently waiting for the bucket
+		uint32_t mNumWaiting;
+
+		/// total time uploads have been delayed
+		int64_t mTotalThrottledTime;
+
+		/// total number of bytes uploaded
+		int64_t mTotalUploadedBytes;
+
+		/// mutex protecting the bucket
+		std::mutex mMutex;
+	};
+}
+
+#endif
@@ -0,0 +1,285 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "ValueAggregator.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+using namespace protocol;
+
+constexpr size_t ValueAggregator::INITIAL_CAPACITY;
+
+ValueAggregator::Aggregate::Aggregate()
+	: Aggregate(0, EventType::VALUE_DOUBLE, core::UTF8String(), 0, 0, 0, 0.0)
+{
+}
+
+ValueAggregator::Aggregate::Aggregate(int32_t actionID, EventType eventType, const core::UTF8String& name, int32_t threadID, int32_t sequenceNumber,
+	int64_t timestamp, double value)
+	: actionID(actionID)
+	, eventType(eventType)
+	, name(name)
+	, threadID(threadID)
+	, sequenceNumber(sequenceNumber)
+	, timestamp(timestamp)
+	, count(1)
+	, min(value)
+	, max(value)
+	, sum(value)
+	, last(value)
+{
+}
+
+ValueAggregator::Slot::Slot()
+	: used(false)
+	, hash(0)
+	, aggregate()
+{
+}
+
+ValueAggregator::ValueAggregator(int64_t flushInterval)
+	: mFlushInterval(flushInterval)
+	, mSlots()
+	, mSize(0)
+	, mActionIndex()
+	, mNextFlushTime(std::numeric_limits<int64_t>::max())
+	, mMutex()
+{
+}
+
+std::vector<ValueAggregator::Aggregate> ValueAggregator::add(int32_t actionID, EventType eventType, const core::UTF8String& name, double value,
+	int64_t timestamp, int32_t threadID, const std::function<int32_t()>& createSequenceNumber)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	// keep the load factor at or below one half, so that probe sequences stay short
+	if ((mSize + 1) * 2 > mSlots.size())
+	{
+		std::vector<Slot> slots(std::max(mSlots.size() * 2, INITIAL_CAPACITY));
+		for (const auto& slot : mSlots)
+		{
+			if (slot.used)
+			{
+				insert(slots, slot.hash, slot.aggregate);
+			}
+		}
+		mSlots.swap(slots);
+	}
+
+	auto nameHash = hash(actionID, eventType, name);
+	auto mask = mSlots.size() - 1;
+	for (auto index = nameHash & mask; ; index = (index + 1) & mask)
+	{
+		auto& slot = mSlots[index];
+		if (!slot.used)
+		{
+			slot.used = true;
+			slot.hash = nameHash;
+			slot.aggregate = Aggregate(actionID, eventType, name, threadID, createSequenceNumber(), timestamp, value);
+			mSize++;
+			mActionIndex[actionID].push_back(nameHash);
+
+			if (mFlushInterval > 0)
+			{
+				mNextFlushTime = std::min(mNextFlushTime, timestamp + mFlushInterval);
+			}
+			break;
+		}
+
+		auto& aggregate = slot.aggregate;
+		if (slot.hash == nameHash && aggregate.actionID == actionID && aggregate.eventType == eventType
+			&& aggregate.name.getStringData() == name.getStringData())
+		{
+			aggregate.count++;
+			aggregate.min = std::min(aggregate.min, value);
+			aggregate.max = std::max(aggregate.max, value);
+			aggregate.sum += value;
+			aggregate.last = value;
+			break;
+		}
+	}
+
+	if (timestamp < mNextFlushTime)
+	{
+		return std::vector<Aggregate>();
+	}
+
+	auto flushInterval = mFlushInterval;
+	return removeIf([timestamp, flushInterval](const Aggregate& aggregate) { return aggregate.timestamp + flushInterval <= timestamp; });
+}
+
+std::vector<ValueAggregator::Aggregate> ValueAggregator::removeAction(int32_t actionID)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto it = mActionIndex.find(actionID);
+	if (it == mActionIndex.end())
+	{
+		return std::vector<Aggregate>();
+	}
+
+	// aggregates of the same action with equal hashes are all listed, so each lookup finds one of them
+	std::vector<Aggregate> removed;
+	auto mask = mSlots.size() - 1;
+	for (auto aggregateHash : it->second)
+	{
+		for (auto index = aggregateHash & mask; mSlots[index].used; index = (index + 1) & mask)
+		{
+			if (mSlots[index].hash == aggregateHash && mSlots[index].aggregate.actionID == actionID)
+			{
+				removed.push_back(erase(index));
+				break;
+			}
+		}
+	}
+	mActionIndex.erase(it);
+
+	// the flush time of the remaining aggregates is not recomputed, an early flush time only costs a rebuild
+	std::sort(removed.begin(), removed.end(), [](const Aggregate& lhs, const Aggregate& rhs) { return lhs.sequenceNumber < rhs.sequenceNumber; });
+	return removed;
+}
+
+std::vector<ValueAggregator::Aggregate> ValueAggregator::removeExpired(int64_t timestamp)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (timestamp < mNextFlushTime)
+	{
+		return std::vector<Aggregate>();
+	}
+
+	auto flushInterval = mFlushInterval;
+	return removeIf([timestamp, flushInterval](const Aggregate& aggregate) { return aggregate.timestamp + flushInterval <= timestamp; });
+}
+
+std::vector<ValueAggregator::Aggregate> ValueAggregator::removeAll()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mSize == 0)
+	{
+		return std::vector<Aggregate>();
+	}
+
+	return removeIf([](const Aggregate&) { return true; });
+}
+
+size_t ValueAggregator::size() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mSize;
+}
+
+size_t ValueAggregator::hash(int32_t actionID, EventType eventType, const core::UTF8String& name)
+{
+	auto result = std::hash<std::string>()(name.getStringData());
+	result ^= (static_cast<size_t>(static_cast<uint32_t>(actionID)) << 3) + static_cast<size_t>(eventType) + 0x9e3779b9 + (result << 6) + (result >> 2);
+	return result;
+}
+
+void ValueAggregator::insert(std::vector<Slot>& slots, size_t hash, const Aggregate& aggregate)
+{
+	auto mask = slots.size() - 1;
+	auto index = hash & mask;
+	while (slots[index].used)
+	{
+		index = (index + 1) & mask;
+	}
+
+	slots[index].used = true;
+	slots[index].hash = hash;
+	slots[index].aggregate = aggregate;
+}
+
+ValueAggregator::Aggregate ValueAggregator::erase(size_t index)
+{
+	auto removed = std::move(mSlots[index].aggregate);
+	mSize--;
+
+	// move each following entry into the hole unless its home slot lies cyclically between the hole and itself
+	auto mask = mSlots.size() - 1;
+	auto hole = index;
+	for (auto next = (hole + 1) & mask; mSlots[next].used; next = (next + 1) & mask)
+	{
+		auto home = mSlots[next].hash & mask;
+		auto homeBetweenHoleAndNext = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+		if (!homeBetweenHoleAndNext)
+		{
+			mSlots[hole].hash = mSlots[next].hash;
+			mSlots[hole].aggregate = std::move(mSlots[next].aggregate);
+			hole = next;
+		}
+	}
+
+	mSlots[hole].used = false;
+	mSlots[hole].aggregate = Aggregate();
+	return removed;
+}
+
+void ValueAggregator::unindex(int32_t actionID, size_t hash)
+{
+	auto it = mActionIndex.find(actionID);
+	if (it == mActionIndex.end())
+	{
+		return;
+	}
+
+	auto& hashes = it->second;
+	auto hashIt = std::find(hashes.begin(), hashes.end(), hash);
+	if (hashIt != hashes.end())
+	{
+		*hashIt = hashes.back();
+		hashes.pop_back();
+	}
+	if (hashes.empty())
+	{
+		mActionIndex.erase(it);
+	}
+}
+
+std::vector<ValueAggregator::Aggregate> ValueAggregator::removeIf(const std::function<bool(const Aggregate&)>& predicate)
+{
+	std::vector<Aggregate> removed;
+	std::vector<Slot> slots(mSlots.size());
+	mSize = 0;
+	mNextFlushTime = std::numeric_limits<int64_t>::max();
+	for (auto& slot : mSlots)
+	{
+		if (!slot.used)
+		{
+			continue;
+		}
+
+		if (predicate(slot.aggregate))
+		{
+			unindex(slot.aggregate.actionID, slot.hash);
+			removed.push_back(std::move(slot.aggregate));
+			continue;
+		}
+
+		insert(slots, slot.hash, slot.aggregate);
+		mSize++;
+		if (mFlushInterval > 0)
+		{
+			mNextFlushTime = std::min(mNextFlushTime, slot.aggregate.timestamp + mFlushInterval);
+		}
+	}
+	mSlots.swap(slots);
+
+	// keep the order of the records as if they had been written when their first value was reported
+	std::sort(removed.begin(), removed.end(), [](const Aggregate& lhs, const Aggregate& rhs) { return lhs.sequenceNumber < rhs.sequenceNumber; });
+	return removed;
+}
@@ -0,0 +1,227 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _PROTOCOL_VALUEAGGREGATOR_H
+#define _PROTOCOL_VALUEAGGREGATOR_H
+
+#include "core/UTF8String.h"
+#include "EventType.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace protocol
+{
+	///
+	/// Local pre-aggregation of numeric values.
+	///
+	/// Values reported on the same action with the same name and type are folded into count, minimum, maximum,
+	/// sum and last value instead of being serialized one by one. One record per name is written when the action
+	/// is left, or when the flush interval of the aggregate expired.
+	///
+	/// The aggregates are kept in an open addressing table with linear probing. The hashes of each action's
+	/// aggregates are indexed by action ID, so leaving an action finds its aggregates without scanning the table
+	/// and deletes them by shifting the following entries back, which keeps probe sequences short without
+	/// tombstones. Removing expired aggregates rebuilds the table from the remaining ones.
+	///
+	class ValueAggregator
+	{
+	public:
+
+		///
+		/// Values with the same action, name and type folded together
+		///
+		struct Aggregate
+		{
+			///
+			/// Default constructor, creating an empty aggregate
+			///
+			Aggregate();
+
+			///
+			/// Constructor, creating an aggregate from its first value
+			/// @param[in] actionID ID of the action the value was reported on
+			/// @param[in] eventType @ref EventType::VALUE_INT or @ref EventType::VALUE_DOUBLE
+			/// @param[in] name name of the value
+			/// @param[in] threadID thread which reported the value
+			/// @param[in] sequenceNumber sequence number of the value
+			/// @param[in] timestamp timestamp of the value
+			/// @param[in] value the value
+			///
+			Aggregate(int32_t actionID, EventType eventType, const core::UTF8String& name, int32_t threadID, int32_t sequenceNumber,
+				int64_t timestamp, double value);
+
+			/// ID of the action the values were reported on
+			int32_t actionID;
+
+			/// @ref EventType::VALUE_INT or @ref EventType::VALUE_DOUBLE
+			EventType eventType;
+
+			/// name of the values
+			core::UTF8String name;
+
+			/// thread which reported the first value
+			int32_t threadID;
+
+			/// sequence number taken when the first value was reported
+			int32_t sequenceNumber;
+
+			/// timestamp of the first value
+			int64_t timestamp;
+
+			/// number of values
+			int64_t count;
+
+			/// smallest value
+			double min;
+
+			/// largest value
+			double max;
+
+			/// sum of the values
+			double sum;
+
+			/// value reported last
+			double last;
+		};
+
+		///
+		/// Constructor
+		/// @param[in] flushInterval time in milliseconds after which an aggregate is written although its action
+		///            is still open, values less than or equal to @c 0 write aggregates only when the action is left
+		///
+		ValueAggregator(int64_t flushInterval);
+
+		///
+		/// Folds a value into the aggregate of its action, name and type.
+		/// @param[in] actionID ID of the action the value is reported on
+		/// @param[in] eventType @ref EventType::VALUE_INT or @ref EventType::VALUE_DOUBLE
+		/// @param[in] name name of the value
+		/// @param[in] value the value
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @param[in] threadID ID of the reporting thread
+		/// @param[in] createSequenceNumber called once if a new aggregate is started
+		/// @returns the aggregates whose flush interval expired, which are removed
+		///
+		std::vector<Aggregate> add(int32_t actionID, EventType eventType, const core::UTF8String& name, double value,
+			int64_t timestamp, int32_t threadID, const std::function<int32_t()>& createSequenceNumber);
+
+		///
+		/// Removes the aggregates of an action.
+		/// @param[in] actionID ID of the action which is left
+		/// @returns the removed aggregates in the order they were started
+		///
+		std::vector<Aggregate> removeAction(int32_t actionID);
+
+		///
+		/// Removes the aggregates whose flush interval expired.
+		/// @param[in] timestamp the current timestamp in milliseconds
+		/// @returns the removed aggregates in the order they were started
+		///
+		std::vector<Aggregate> removeExpired(int64_t timestamp);
+
+		///
+		/// Removes all aggregates.
+		/// @returns the removed aggregates in the order they were started
+		///
+		std::vector<Aggregate> removeAll();
+
+		///
+		/// Returns the number of aggregates
+		///
+		size_t size() const;
+
+	private:
+
+		///
+		/// Entry of the open addressing table
+		///
+		struct Slot
+		{
+			///
+			/// Default constructor, creating an unused slot
+			///
+			Slot();
+
+			/// @c true if the slot holds an aggregate
+			bool used;
+
+			/// hash of action ID, type and name
+			size_t hash;
+
+			/// the aggregate
+			Aggregate aggregate;
+		};
+
+		///
+		/// Hashes action ID, type and name of an aggregate.
+		///
+		static size_t hash(int32_t actionID, EventType eventType, const core::UTF8String& name);
+
+		///
+		/// Inserts an aggregate into a free slot, the table must not be full.
+		///
+		static void insert(std::vector<Slot>& slots, size_t hash, const Aggregate& aggregate);
+
+		///
+		/// Deletes the entry of a slot and shifts the entries of the following probe sequence back.
+		/// The caller must hold @c mMutex.
+		/// @param[in] index index of the slot to delete
+		/// @returns the aggregate of the deleted slot
+		///
+		Aggregate erase(size_t index);
+
+		///
+		/// Removes the hash of an aggregate from the index of its action.
+		/// The caller must hold @c mMutex.
+		///
+		void unindex(int32_t actionID, size_t hash);
+
+		///
+		/// Removes the aggregates matching a predicate and rebuilds the table from the remaining ones.
+		/// The caller must hold @c mMutex.
+		///
+		std::vector<Aggregate> removeIf(const std::function<bool(const Aggregate&)>& predicate);
+
+		/// initial number of slots, always a power of two
+		static constexpr size_t INITIAL_CAPACITY = 16;
+
+		/// time after which an aggregate is written although its action is still open
+		const int64_t mFlushInterval;
+
+		/// slots of the table
+		std::vector<Slot> mSlots;
+
+		/// number of used slots
+		size_t mSize;
+
+		/// hashes of the aggregates per action ID, one entry per aggregate
+		std::unordered_map<int32_t, std::vector<size_t>> mActionIndex;
+
+		/// earliest time at which an aggregate expires
+		int64_t mNextFlushTime;
+
+		/// mutex protecting the table
+		mutable std::mutex mMutex;
+	};
+}
+
+#endif
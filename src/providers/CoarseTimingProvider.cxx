@@ -0,0 +1,62 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "CoarseTimingProvider.h"
+
+#include <chrono>
+#include <thread>
+
+#if defined(_WIN32) || defined(WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace providers;
+
+CoarseTimingProvider::CoarseTimingProvider()
+{
+}
+
+int64_t CoarseTimingProvider::provideTimestampInMilliseconds()
+{
+	return currentTimestampInMilliseconds();
+}
+
+void CoarseTimingProvider::sleep(int64_t milliseconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+int64_t CoarseTimingProvider::currentTimestampInMilliseconds()
+{
+#if defined(_WIN32) || defined(WIN32)
+	// 100 nanosecond intervals since 1601-01-01
+	static const int64_t FILETIME_UNIX_EPOCH = 116444736000000000LL;
+
+	FILETIME fileTime;
+	GetSystemTimeAsFileTime(&fileTime);
+	auto intervals = (static_cast<int64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+	return (intervals - FILETIME_UNIX_EPOCH) / 10000;
+#elif defined(CLOCK_REALTIME_COARSE)
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME_COARSE, &now);
+	return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+#else
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+#endif
+}
@@ -0,0 +1,62 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _PROVIDERS_COARSETIMINGPROVIDER_H
+#define _PROVIDERS_COARSETIMINGPROVIDER_H
+
+#include "ITimingProvider.h"
+
+namespace providers
+{
+	///
+	/// Timing provider trading resolution for speed
+	///
+	/// Timestamps are read from the coarse real time clock, which the kernel updates on each timer tick and
+	/// which is read through the vDSO without a system call, so that the resolution is a few milliseconds.
+	/// On Windows the system time is read, which is updated on each timer tick as well. Other platforms fall
+	/// back to the precise system clock.
+	///
+	class CoarseTimingProvider : public ITimingProvider
+	{
+	public:
+
+		///
+		/// Default constructor
+		///
+		CoarseTimingProvider();
+
+		///
+		/// Provide the current timestamp in milliseconds.
+		/// @returns the current timestamp
+		///
+		virtual int64_t provideTimestampInMilliseconds() override;
+
+		///
+		/// Sleep given amount of milliseconds.
+		/// @param[in] milliseconds amount of milliseconds to sleep
+		///
+		virtual void sleep(int64_t milliseconds) override;
+
+		///
+		/// Reads the coarse clock without virtual dispatch.
+		/// @returns the current timestamp in milliseconds
+		///
+		static int64_t currentTimestampInMilliseconds();
+	};
+}
+
+#endif
@@ -30,8 +30,14 @@ using namespace providers;
  */
 int32_t DefaultThreadIDProvider::getThreadID()
 {
-	int64_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
-	return convertNativeThreadIDToPositiveInteger(hash);
+	return currentThreadID();
+}
+
+int32_t DefaultThreadIDProvider::currentThreadID()
+{
+	static thread_local const int32_t threadID =
+		convertNativeThreadIDToPositiveInteger(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	return threadID;
 }
 
 int32_t DefaultThreadIDProvider::convertNativeThreadIDToPositiveInteger(int64_t nativeThreadID)
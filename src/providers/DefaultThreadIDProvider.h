@@ -34,6 +34,14 @@ namespace providers
 		///
 		virtual int32_t getThreadID() override;
 
+		///
+		/// Provide the current thread ID without virtual dispatch
+		///
+		/// The ID is derived once per thread and cached in thread local storage.
+		/// @returns the current thread ID
+		///
+		static int32_t currentThreadID();
+
 		///
 		/// Convert a native thread id to a positive integer required for the Beacon protocol
 		/// @param[in] nativeThreadID the native thread ID returned by std::this_thread::get_id
@@ -26,6 +26,11 @@ DefaultTimingProvider::DefaultTimingProvider()
 }
 
 int64_t DefaultTimingProvider::provideTimestampInMilliseconds()
+{
+	return currentTimestampInMilliseconds();
+}
+
+int64_t DefaultTimingProvider::currentTimestampInMilliseconds()
 {
 	std::chrono::milliseconds ms = std::chrono::duration_cast<std::chrono::milliseconds>(
 		std::chrono::system_clock::now().time_since_epoch()
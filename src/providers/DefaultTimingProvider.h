@@ -45,6 +45,12 @@ namespace providers
 		/// @param[in] milliseconds amount of milliseconds to sleep
 		///
 		virtual void sleep(int64_t milliseconds) override;
+
+		///
+		/// Reads the system clock without virtual dispatch.
+		/// @returns the current timestamp in milliseconds
+		///
+		static int64_t currentTimestampInMilliseconds();
 	};
 }
 
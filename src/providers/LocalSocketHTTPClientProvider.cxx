@@ -0,0 +1,42 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "LocalSocketHTTPClientProvider.h"
+#include "protocol/LocalSocketHTTPClient.h"
+
+using namespace providers;
+
+LocalSocketHTTPClientProvider::LocalSocketHTTPClientProvider(const std::string& socketPath)
+	: mSocketPath(socketPath)
+{
+}
+
+std::shared_ptr<protocol::IHTTPClient> LocalSocketHTTPClientProvider::createClient(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::HTTPClientConfiguration> configuration)
+{
+	return std::make_shared<protocol::LocalSocketHTTPClient>(logger, configuration, mSocketPath);
+}
+
+void LocalSocketHTTPClientProvider::globalInit()
+{
+	// also initializes the socket library on Windows
+	protocol::HTTPClient::globalInit();
+}
+
+void LocalSocketHTTPClientProvider::globalDestroy()
+{
+	protocol::HTTPClient::globalDestroy();
+}
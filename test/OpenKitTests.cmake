@@ -35,15 +35,23 @@ set(OPENKIT_SOURCES_TEST_API
 set(OPENKIT_SOURCES_TEST_CORE
     ${CMAKE_CURRENT_LIST_DIR}/core/UTF8StringTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/SessionTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/SessionRegistryTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/ActionTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/RootActionTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/WebRequestTracerTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/WebRequestTracerURLValidityTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/AdaptiveCompressorTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/CompressorTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/GzipCompressorTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/URLEncodingTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/ObjectArenaTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/OpenActionSetTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/SingleProducerQueueTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/SynchronizedQueueTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/InetAddressValidatorTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/util/StringUtilTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/WakeupEventTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/core/util/WorkStealingThreadPoolTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/core/MockBeaconSender.h
     ${CMAKE_CURRENT_LIST_DIR}/core/MockSession.h
     ${CMAKE_CURRENT_LIST_DIR}/core/util/DefaultLoggerTest.cxx
@@ -62,6 +70,15 @@ set(OPENKIT_SOURCES_TEST_PROTOCOL
     ${CMAKE_CURRENT_LIST_DIR}/protocol/ResponseTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/protocol/MockStatusResponse.h
     ${CMAKE_CURRENT_LIST_DIR}/protocol/NullLogger.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/UploadRateLimiterTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/EventSamplerTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/ValueAggregatorTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/AdaptiveSendingControllerTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalForwarderProtocolTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalForwarderTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/LocalHTTPServer.h
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/HTTPClientTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/protocol/TransferDeadlineTest.cxx
 )
 
 set(OPENKIT_SOURCES_TEST_PROVIDERS
@@ -72,6 +89,7 @@ set(OPENKIT_SOURCES_TEST_PROVIDERS
     ${CMAKE_CURRENT_LIST_DIR}/providers/MockPRNGenerator.h
     ${CMAKE_CURRENT_LIST_DIR}/providers/DefaultPRNGeneratorTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/providers/MockTimingProvider.h
+    ${CMAKE_CURRENT_LIST_DIR}/providers/CoarseTimingProviderTest.cxx
 )
 
 set(OPENKIT_SOURCES_TEST_COMMUNICATION
@@ -81,8 +99,11 @@ set(OPENKIT_SOURCES_TEST_COMMUNICATION
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingContextTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingFlushSessionStateTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingInitialStateTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingOpenSessionSchedulerTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingRequestUtilTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingResponseUtilTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingRetrySchedulerTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingSessionPrioritizerTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/BeaconSendingTerminalStateTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/communication/CustomMatchers.h
     ${CMAKE_CURRENT_LIST_DIR}/communication/MockAbstractBeaconSendingState.h
@@ -103,6 +124,8 @@ set(OPENKIT_SOURCES_TEST_CACHING
     ${CMAKE_CURRENT_LIST_DIR}/caching/TimeEvictionStrategyTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconCacheEvictorTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconCacheTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/caching/BeaconChunkStoreTest.cxx
+    ${CMAKE_CURRENT_LIST_DIR}/caching/BufferedBeaconCacheTest.cxx
     ${CMAKE_CURRENT_LIST_DIR}/caching/MockBeaconCache.h
     ${CMAKE_CURRENT_LIST_DIR}/caching/MockBeaconCacheEvictionStrategy.h
     ${CMAKE_CURRENT_LIST_DIR}/caching/MockObserver.h
@@ -28,6 +28,8 @@
 #include "protocol/ssl/SSLStrictTrustManager.h"
 #include "core/util/DefaultLogger.h"
 #include "core/util/StringUtil.h"
+#include "core/util/AdaptiveCompressor.h"
+#include "core/util/GzipCompressor.h"
 
 #include "../protocol/TestSSLTrustManager.h"
 
@@ -425,3 +427,85 @@ TEST_F(OpenKitBuilderTest, canSetCrashReportingLevelForAppMon)
 
 	ASSERT_EQ(configuration->getBeaconConfiguration()->getCrashReportingLevel(), CrashReportingLevel::OPT_IN_CRASHES);
 }
+
+TEST_F(OpenKitBuilderTest, defaultCompressorUsesDefaultCompressionLevel)
+{
+	auto configuration = DynatraceOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID).buildConfiguration();
+
+	auto compressor = std::dynamic_pointer_cast<core::util::GzipCompressor>(configuration->getHTTPClientConfiguration()->getCompressor());
+	ASSERT_TRUE(compressor != nullptr);
+	ASSERT_EQ(compressor->getCompressionLevel(), 6);
+}
+
+TEST_F(OpenKitBuilderTest, canSetCompressionModeForDynatrace)
+{
+	auto configuration = DynatraceOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID)
+		.withCompressionMode(CompressionMode::FAST)
+		.buildConfiguration();
+
+	auto compressor = std::dynamic_pointer_cast<core::util::GzipCompressor>(configuration->getHTTPClientConfiguration()->getCompressor());
+	ASSERT_TRUE(compressor != nullptr);
+	ASSERT_EQ(compressor->getCompressionLevel(), 1);
+}
+
+TEST_F(OpenKitBuilderTest, canSetCompressionModeForAppMon)
+{
+	auto configuration = AppMonOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID)
+		.withCompressionMode(CompressionMode::ADAPTIVE)
+		.buildConfiguration();
+
+	auto compressor = std::dynamic_pointer_cast<core::util::AdaptiveCompressor>(configuration->getHTTPClientConfiguration()->getCompressor());
+	ASSERT_TRUE(compressor != nullptr);
+}
+
+TEST_F(OpenKitBuilderTest, customCompressorOverridesCompressionMode)
+{
+	auto customCompressor = std::make_shared<core::util::GzipCompressor>(9);
+	auto configuration = DynatraceOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID)
+		.withCompressor(customCompressor)
+		.withCompressionMode(CompressionMode::ADAPTIVE)
+		.buildConfiguration();
+
+	ASSERT_EQ(configuration->getHTTPClientConfiguration()->getCompressor(), customCompressor);
+}
+
+TEST_F(OpenKitBuilderTest, noEventSamplerIsCreatedByDefault)
+{
+	auto configuration = DynatraceOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID)
+		.buildConfiguration();
+
+	ASSERT_EQ(configuration->getEventSampler(), nullptr);
+}
+
+TEST_F(OpenKitBuilderTest, canSetSamplingRulesForAppMon)
+{
+	auto builder = AppMonOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID);
+	builder.withSamplingRule(SampledEventType::WEB_REQUEST, nullptr, 1.5, 10.0)
+		.withSamplingRule(SampledEventType::NAMED_EVENT, "event", 0.0, 0.0);
+	auto configuration = builder.buildConfiguration();
+
+	ASSERT_NE(configuration->getEventSampler(), nullptr);
+	ASSERT_EQ(configuration->getEventSampler()->sample(SampledEventType::NAMED_EVENT, "event"), 0.0);
+	ASSERT_EQ(configuration->getEventSampler()->sample(SampledEventType::WEB_REQUEST, "http://example.com/"), 1.0);
+}
+
+TEST_F(OpenKitBuilderTest, valuesAreNotAggregatedByDefault)
+{
+	auto configuration = DynatraceOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID)
+		.buildConfiguration();
+
+	ASSERT_LT(configuration->getValueAggregationInterval(), 0);
+}
+
+TEST_F(OpenKitBuilderTest, canSetValueAggregationForDynatraceAndAppMon)
+{
+	auto dynatraceConfiguration = DynatraceOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID)
+		.withValueAggregation(5000)
+		.buildConfiguration();
+	auto appMonConfiguration = AppMonOpenKitBuilder(DEFAULT_ENDPOINT_URL, DEFAULT_APPLICATION_ID, DEFAULT_DEVICE_ID)
+		.withValueAggregation(0)
+		.buildConfiguration();
+
+	ASSERT_EQ(dynatraceConfiguration->getValueAggregationInterval(), 5000);
+	ASSERT_EQ(appMonConfiguration->getValueAggregationInterval(), 0);
+}
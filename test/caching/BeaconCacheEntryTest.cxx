@@ -418,6 +418,146 @@ TEST_F(BeaconCacheEntryTest, getChunksTakesSizeIntoAccount)
 	ASSERT_TRUE(obtained3.equals("prefix&One&Four"));
 }
 
+TEST_F(BeaconCacheEntryTest, getFollowingChunkMarksDataAfterCurrentChunkAsPending)
+{
+	// given
+	BeaconCacheRecord dataOne(0L, "One");
+	BeaconCacheRecord dataTwo(0L, "Two");
+	BeaconCacheRecord dataThree(1L, "Three");
+	BeaconCacheRecord dataFour(1L, "Four");
+
+	BeaconCacheEntry target;
+	target.addEventData(dataOne);
+	target.addEventData(dataFour);
+	target.addActionData(dataTwo);
+	target.addActionData(dataThree);
+
+	target.copyDataForChunking();
+	auto obtained = target.getChunk("a", 5, "&");
+
+	// when
+	auto obtained2 = target.getFollowingChunk("a", 5, "&");
+
+	// then
+	ASSERT_TRUE(obtained.equals("a&One&Four"));
+	ASSERT_TRUE(obtained2.equals("a&Two&Three"));
+	auto eventDataBeingSent = target.getEventDataBeingSent();
+	for (auto it = eventDataBeingSent.begin(); it != eventDataBeingSent.end(); it++)
+	{
+		ASSERT_TRUE(it->isMarkedForSending());
+		ASSERT_FALSE(it->isPending());
+	}
+	auto actionDataBeingSent = target.getActionDataBeingSent();
+	for (auto it = actionDataBeingSent.begin(); it != actionDataBeingSent.end(); it++)
+	{
+		ASSERT_FALSE(it->isMarkedForSending());
+		ASSERT_TRUE(it->isPending());
+	}
+}
+
+TEST_F(BeaconCacheEntryTest, getFollowingChunkReturnsEmptyStringIfCurrentChunkContainsAllData)
+{
+	// given
+	BeaconCacheRecord dataOne(0L, "One");
+	BeaconCacheRecord dataTwo(0L, "Two");
+
+	BeaconCacheEntry target;
+	target.addEventData(dataOne);
+	target.addActionData(dataTwo);
+
+	target.copyDataForChunking();
+	target.getChunk("a", 100, "&");
+
+	// when
+	auto obtained = target.getFollowingChunk("a", 100, "&");
+
+	// then
+	ASSERT_TRUE(obtained.empty());
+}
+
+TEST_F(BeaconCacheEntryTest, removeDataMarkedForSendingMarksPendingDataForSending)
+{
+	// given
+	BeaconCacheRecord dataOne(0L, "One");
+	BeaconCacheRecord dataTwo(0L, "Two");
+	BeaconCacheRecord dataThree(1L, "Three");
+	BeaconCacheRecord dataFour(1L, "Four");
+
+	BeaconCacheEntry target;
+	target.addEventData(dataOne);
+	target.addEventData(dataFour);
+	target.addActionData(dataTwo);
+	target.addActionData(dataThree);
+
+	target.copyDataForChunking();
+	target.getChunk("a", 5, "&");
+	target.getFollowingChunk("a", 5, "&");
+
+	// when
+	target.removeDataMarkedForSending();
+
+	// then the following chunk became the current chunk
+	ASSERT_TRUE(target.getEventDataBeingSent().empty());
+	auto actionDataBeingSent = target.getActionDataBeingSent();
+	ASSERT_EQ(actionDataBeingSent.size(), 2);
+	for (auto it = actionDataBeingSent.begin(); it != actionDataBeingSent.end(); it++)
+	{
+		ASSERT_TRUE(it->isMarkedForSending());
+		ASSERT_FALSE(it->isPending());
+	}
+	ASSERT_TRUE(target.getFollowingChunk("a", 5, "&").empty());
+	ASSERT_TRUE(target.getChunk("a", 5, "&").equals("a&Two&Three"));
+
+	// and when removing that one too
+	target.removeDataMarkedForSending();
+
+	// then
+	ASSERT_TRUE(target.getEventDataBeingSent().empty());
+	ASSERT_TRUE(target.getActionDataBeingSent().empty());
+}
+
+TEST_F(BeaconCacheEntryTest, resetDataMarkedForSendingRestoresPendingData)
+{
+	// given
+	BeaconCacheRecord dataOne(0L, "One");
+	BeaconCacheRecord dataTwo(0L, "Two");
+	BeaconCacheRecord dataThree(1L, "Three");
+	BeaconCacheRecord dataFour(1L, "Four");
+
+	BeaconCacheEntry target;
+	target.addEventData(dataOne);
+	target.addEventData(dataFour);
+	target.addActionData(dataTwo);
+	target.addActionData(dataThree);
+
+	auto numBytes = target.getTotalNumberOfBytes();
+	target.copyDataForChunking();
+	target.getChunk("a", 5, "&");
+	target.getFollowingChunk("a", 5, "&");
+
+	// when
+	target.resetDataMarkedForSending();
+
+	// then
+	ASSERT_TRUE(target.getEventDataBeingSent().empty());
+	ASSERT_TRUE(target.getActionDataBeingSent().empty());
+	ASSERT_EQ(target.getTotalNumberOfBytes(), numBytes);
+	auto eventData = target.getEventData();
+	auto actionData = target.getActionData();
+	ASSERT_EQ(eventData.size(), 2);
+	ASSERT_EQ(actionData.size(), 2);
+	for (auto it = eventData.begin(); it != eventData.end(); it++)
+	{
+		ASSERT_FALSE(it->isMarkedForSending());
+		ASSERT_FALSE(it->isPending());
+	}
+	for (auto it = actionData.begin(); it != actionData.end(); it++)
+	{
+		ASSERT_FALSE(it->isMarkedForSending());
+		ASSERT_FALSE(it->isPending());
+	}
+}
+
 TEST_F(BeaconCacheEntryTest, removeDataMarkedForSendingReturnsIfDataHasNotBeenCopied)
 {
 	// given
@@ -23,6 +23,8 @@
 #include "core/util/DefaultLogger.h"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 using namespace caching;
 
@@ -75,6 +77,24 @@ TEST_F(BeaconCacheTest, addEventDataAddsBeaconIdToCache)
 	ASSERT_TRUE(target.getEvents(2).begin()->equals("b"));
 }
 
+TEST_F(BeaconCacheTest, addEventDataBatchAddsAllRecordsInOrder)
+{
+	// given
+	BeaconCache target(mLogger);
+	target.addEventData(1, 1000L, "a");
+
+	// when
+	target.addEventDataBatch(1, 1100L, std::vector<core::UTF8String>{ "b", "c" });
+
+	// then
+	auto events = target.getEvents(1);
+	ASSERT_EQ(events.size(), size_t(3));
+	ASSERT_TRUE(events[0].equals("a"));
+	ASSERT_TRUE(events[1].equals("b"));
+	ASSERT_TRUE(events[2].equals("c"));
+	ASSERT_EQ(target.getNumBytesInCache(), int64_t(3));
+}
+
 TEST_F(BeaconCacheTest, addEventDataAddsDataToAlreadyExistingBeaconId)
 {
 	// given
@@ -436,6 +456,91 @@ TEST_F(BeaconCacheTest, removeChunkedDataClearsAlreadyRetrievedChunks)
 	ASSERT_TRUE(target.getEventsBeingSent(1).empty());
 }
 
+TEST_F(BeaconCacheTest, getFollowingBeaconChunkReturnsNullIfGivenBeaconIDDoesNotExist)
+{
+	// given
+	BeaconCache target(mLogger);
+	target.addActionData(1, 1000L, "a");
+
+	// when
+	core::UTF8String obtained = target.getFollowingBeaconChunk(42, "prefix", 0, "&");
+
+	// then
+	ASSERT_TRUE(obtained.empty());
+}
+
+TEST_F(BeaconCacheTest, followingBeaconChunksAreEqualToNextBeaconChunks)
+{
+	// given
+	BeaconCache sequential(mLogger);
+	BeaconCache pipelined(mLogger);
+	for (auto i = 0; i < 10; i++)
+	{
+		core::UTF8String data("data");
+		data.concatenate(std::to_string(i).c_str());
+		sequential.addActionData(1, 1000L + i, data);
+		sequential.addEventData(1, 2000L + i, data);
+		pipelined.addActionData(1, 1000L + i, data);
+		pipelined.addEventData(1, 2000L + i, data);
+	}
+
+	// when sending all chunks one after the other
+	std::vector<core::UTF8String> sequentialChunks;
+	auto chunk = sequential.getNextBeaconChunk(1, "prefix", 20, "&");
+	while (!chunk.empty())
+	{
+		sequentialChunks.push_back(chunk);
+		sequential.removeChunkedData(1);
+		chunk = sequential.getNextBeaconChunk(1, "prefix", 20, "&");
+	}
+
+	// and when retrieving each following chunk before the current one is removed
+	std::vector<core::UTF8String> pipelinedChunks;
+	chunk = pipelined.getNextBeaconChunk(1, "prefix", 20, "&");
+	while (!chunk.empty())
+	{
+		pipelinedChunks.push_back(chunk);
+		auto followingChunk = pipelined.getFollowingBeaconChunk(1, "prefix", 20, "&");
+		pipelined.removeChunkedData(1);
+		chunk = followingChunk;
+	}
+
+	// then
+	ASSERT_EQ(pipelinedChunks.size(), sequentialChunks.size());
+	ASSERT_GT(pipelinedChunks.size(), size_t(1));
+	for (size_t i = 0; i < pipelinedChunks.size(); i++)
+	{
+		ASSERT_TRUE(pipelinedChunks[i].equals(sequentialChunks[i]));
+	}
+	ASSERT_TRUE(pipelined.isEmpty(1));
+	ASSERT_TRUE(pipelined.getActionsBeingSent(1).empty());
+	ASSERT_TRUE(pipelined.getEventsBeingSent(1).empty());
+}
+
+TEST_F(BeaconCacheTest, resetChunkedDataRestoresCurrentAndFollowingChunk)
+{
+	// given
+	BeaconCache target(mLogger);
+	target.addActionData(1, 1000L, "a");
+	target.addActionData(1, 1001L, "iii");
+	target.addEventData(1, 1000L, "b");
+	target.addEventData(1, 1001L, "jjj");
+	auto numBytes = target.getNumBytesInCache();
+
+	target.getNextBeaconChunk(1, "prefix", 10, "&");
+	core::UTF8String obtained = target.getFollowingBeaconChunk(1, "prefix", 10, "&");
+
+	// when
+	target.resetChunkedData(1);
+
+	// then
+	ASSERT_TRUE(obtained.equals("prefix&a&iii"));
+	ASSERT_EQ(target.getNumBytesInCache(), numBytes);
+	ASSERT_TRUE(target.getActionsBeingSent(1).empty());
+	ASSERT_TRUE(target.getEventsBeingSent(1).empty());
+	ASSERT_TRUE(target.getNextBeaconChunk(1, "prefix", 10, "&").equals("prefix&b&jjj"));
+}
+
 TEST_F(BeaconCacheTest, removeChunkedDataDoesNothingIfCalledWithNonExistingBeaconID)
 {
 	// given
@@ -684,3 +789,63 @@ TEST_F(BeaconCacheTest, isEmptyGivesTrueIfBeaconDoesNotContainActiveData)
 	ASSERT_TRUE(target.isEmpty(1));
 }
 
+
+TEST_F(BeaconCacheTest, evictRecordsByAgeReducesNumberOfBytes)
+{
+	// given
+	BeaconCache target(mLogger);
+	target.addActionData(1, 1000L, "a");
+	target.addActionData(1, 1001L, "iii");
+	target.addEventData(1, 1000L, "b");
+	target.addEventData(1, 1001L, "jjj");
+
+	// when
+	target.evictRecordsByAge(1, 1001);
+
+	// then
+	ASSERT_EQ(target.getNumBytes(1), 6L);
+	ASSERT_EQ(target.getNumBytesInCache(), 6L);
+}
+
+TEST_F(BeaconCacheTest, evictRecordsByNumberReducesNumberOfBytes)
+{
+	// given
+	BeaconCache target(mLogger);
+	target.addActionData(1, 1000L, "a");
+	target.addActionData(1, 1001L, "iii");
+	target.addEventData(1, 1000L, "b");
+	target.addEventData(1, 1001L, "jjj");
+
+	// when
+	target.evictRecordsByNumber(1, 2);
+
+	// then
+	ASSERT_EQ(target.getNumBytes(1), 6L);
+	ASSERT_EQ(target.getNumBytesInCache(), 6L);
+}
+
+TEST_F(BeaconCacheTest, getNumBytesGivesZeroIfBeaconDoesNotExistInCache)
+{
+	// given
+	BeaconCache target(mLogger);
+	target.addActionData(1, 1000L, "a");
+
+	// then
+	ASSERT_EQ(target.getNumBytes(1), 1L);
+	ASSERT_EQ(target.getNumBytes(42), 0L);
+}
+
+TEST_F(BeaconCacheTest, getOldestRecordTimestampGivesTimestampOfOldestActionOrEvent)
+{
+	// given
+	BeaconCache target(mLogger);
+	target.addActionData(1, 1001L, "a");
+	target.addEventData(1, 1000L, "b");
+	target.addEventData(2, 2000L, "c");
+	target.addActionData(2, 1999L, "d");
+
+	// then
+	ASSERT_EQ(target.getOldestRecordTimestamp(1), 1000L);
+	ASSERT_EQ(target.getOldestRecordTimestamp(2), 1999L);
+	ASSERT_EQ(target.getOldestRecordTimestamp(42), -1L);
+}
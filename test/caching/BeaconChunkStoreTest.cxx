@@ -0,0 +1,286 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+
+#include "caching/BeaconChunkStore.h"
+#include "core/util/Compressor.h"
+#include "core/util/DefaultLogger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace caching;
+
+class BeaconChunkStoreTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_DEBUG);
+
+		char directoryTemplate[] = "/tmp/BeaconChunkStoreTest.XXXXXX";
+		ASSERT_NE(mkdtemp(directoryTemplate), nullptr);
+		mDirectory = directoryTemplate;
+	}
+
+	void TearDown()
+	{
+		DIR* dir = opendir(mDirectory.c_str());
+		if (dir != nullptr)
+		{
+			struct dirent* entry;
+			while ((entry = readdir(dir)) != nullptr)
+			{
+				std::remove((mDirectory + "/" + entry->d_name).c_str());
+			}
+			closedir(dir);
+		}
+		rmdir(mDirectory.c_str());
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> mLogger;
+	std::string mDirectory;
+};
+
+TEST_F(BeaconChunkStoreTest, aNewStoreIsEmpty)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+	BeaconChunkStore::StoredChunk chunk;
+
+	// then
+	ASSERT_TRUE(target.isEmpty());
+	ASSERT_EQ(target.getNumChunks(), size_t(0));
+	ASSERT_EQ(target.getNumBytes(), int64_t(0));
+	ASSERT_FALSE(target.loadOldest(chunk));
+}
+
+TEST_F(BeaconChunkStoreTest, storedChunksAreLoadedOldestFirst)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+
+	// when
+	ASSERT_TRUE(target.store(core::UTF8String("127.0.0.1"), core::UTF8String("vv=3"), protocol::BeaconPayload(core::UTF8String("first")), 1000));
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("second")), 2000));
+
+	// then
+	ASSERT_EQ(target.getNumChunks(), size_t(2));
+
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_EQ(chunk.timestamp, int64_t(1000));
+	ASSERT_TRUE(chunk.clientIPAddress.equals("127.0.0.1"));
+	ASSERT_TRUE(chunk.chunkPrefix.equals("vv=3"));
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "first");
+
+	// and when the chunk is removed
+	target.remove(chunk.sequenceNumber);
+
+	// then the next chunk is loaded
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_EQ(chunk.timestamp, int64_t(2000));
+	ASSERT_TRUE(chunk.clientIPAddress.empty());
+	ASSERT_TRUE(chunk.chunkPrefix.empty());
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "second");
+
+	target.remove(chunk.sequenceNumber);
+	ASSERT_TRUE(target.isEmpty());
+	ASSERT_EQ(target.getNumBytes(), int64_t(0));
+}
+
+TEST_F(BeaconChunkStoreTest, compressedChunksAreLoadedWithoutBeingDecompressed)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+	std::string beaconData = "et=1&na=action&et=1&na=action&et=1&na=action";
+	std::vector<unsigned char> compressedData;
+	base::util::Compressor::compressMemory(beaconData.c_str(), beaconData.size(), compressedData);
+	auto expectedContent = compressedData;
+
+	// when
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String(beaconData), std::move(compressedData)), 1000));
+
+	// then
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_TRUE(chunk.payload.isCompressed());
+	ASSERT_EQ(std::vector<unsigned char>(chunk.payload.getContent(), chunk.payload.getContent() + chunk.payload.getContentSize()), expectedContent);
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), beaconData);
+}
+
+TEST_F(BeaconChunkStoreTest, oldestChunksAreDroppedIfSizeBudgetIsExceeded)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String(std::string(400, 'a'))), 1000));
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String(std::string(400, 'b'))), 2000));
+
+	// when
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String(std::string(400, 'c'))), 3000));
+
+	// then
+	ASSERT_EQ(target.getNumChunks(), size_t(2));
+	ASSERT_LE(target.getNumBytes(), int64_t(1024));
+
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_EQ(chunk.timestamp, int64_t(2000));
+}
+
+TEST_F(BeaconChunkStoreTest, chunkExceedingSizeBudgetIsRejected)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("small")), 1000));
+
+	// when
+	auto obtained = target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String(std::string(2048, 'x'))), 2000);
+
+	// then
+	ASSERT_FALSE(obtained);
+	ASSERT_EQ(target.getNumChunks(), size_t(1));
+}
+
+TEST_F(BeaconChunkStoreTest, evictExpiredRemovesChunksExceedingMaxAge)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 5000);
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("old")), 1000));
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("new")), 4000));
+
+	// when
+	target.evictExpired(7000);
+
+	// then
+	ASSERT_EQ(target.getNumChunks(), size_t(1));
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "new");
+}
+
+TEST_F(BeaconChunkStoreTest, evictExpiredKeepsChunksIfMaxAgeIsNotPositive)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("old")), 1000));
+
+	// when
+	target.evictExpired(std::numeric_limits<int64_t>::max());
+
+	// then
+	ASSERT_EQ(target.getNumChunks(), size_t(1));
+}
+
+TEST_F(BeaconChunkStoreTest, chunksStoredByPreviousInstanceArePickedUp)
+{
+	// given
+	{
+		BeaconChunkStore previous(mLogger, mDirectory, 1024, 0);
+		ASSERT_TRUE(previous.store(core::UTF8String("10.0.0.1"), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("first")), 1000));
+		ASSERT_TRUE(previous.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("second")), 2000));
+	}
+
+	// when
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+
+	// then
+	ASSERT_EQ(target.getNumChunks(), size_t(2));
+	ASSERT_GT(target.getNumBytes(), int64_t(0));
+
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_TRUE(chunk.clientIPAddress.equals("10.0.0.1"));
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "first");
+
+	// and new chunks are stored after the picked up ones
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("third")), 3000));
+	target.remove(chunk.sequenceNumber);
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "second");
+}
+
+TEST_F(BeaconChunkStoreTest, unreadableChunksAreSkipped)
+{
+	// given
+	{
+		BeaconChunkStore previous(mLogger, mDirectory, 1024, 0);
+		ASSERT_TRUE(previous.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("first")), 1000));
+		ASSERT_TRUE(previous.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("second")), 2000));
+	}
+	std::ofstream(mDirectory + "/00000000000000000000.chunk", std::ios::trunc) << "garbage";
+	std::ofstream(mDirectory + "/00000000000000000005.chunk.tmp") << "partial";
+
+	// when
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+
+	// then
+	ASSERT_EQ(target.getNumChunks(), size_t(1));
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "second");
+	ASSERT_FALSE(std::ifstream(mDirectory + "/00000000000000000005.chunk.tmp").good());
+}
+
+TEST_F(BeaconChunkStoreTest, chunkDamagedAfterStoringIsDroppedWhenLoading)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("first")), 1000));
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("second")), 2000));
+	std::ofstream(mDirectory + "/00000000000000000000.chunk", std::ios::trunc) << "garbage";
+
+	// when
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+
+	// then
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "second");
+	ASSERT_EQ(target.getNumChunks(), size_t(1));
+}
+
+TEST_F(BeaconChunkStoreTest, truncatedChunkIsDroppedWhenLoading)
+{
+	// given
+	BeaconChunkStore target(mLogger, mDirectory, 1024, 0);
+	ASSERT_TRUE(target.store(core::UTF8String("10.0.0.1"), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("first")), 1000));
+	ASSERT_TRUE(target.store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("second")), 2000));
+
+	std::string content;
+	{
+		std::ifstream file(mDirectory + "/00000000000000000000.chunk", std::ios::binary);
+		content.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	}
+	std::ofstream(mDirectory + "/00000000000000000000.chunk", std::ios::binary | std::ios::trunc) << content.substr(0, content.size() - 2);
+
+	// when
+	BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(target.loadOldest(chunk));
+
+	// then
+	ASSERT_EQ(chunk.payload.getBeaconData().getStringData(), "second");
+	ASSERT_EQ(target.getNumChunks(), size_t(1));
+}
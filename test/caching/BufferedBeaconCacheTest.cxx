@@ -0,0 +1,424 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "caching/BeaconCache.h"
+#include "caching/BufferedBeaconCache.h"
+#include "../caching/MockObserver.h"
+#include "core/UTF8String.h"
+#include "core/util/DefaultLogger.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace caching;
+
+///
+/// Buffered cache leaving a gap in the sequence of a stripe, as a thread still appending a record does
+///
+class GapBufferedBeaconCache : public BufferedBeaconCache
+{
+public:
+	GapBufferedBeaconCache(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<BeaconCache> beaconCache)
+		: BufferedBeaconCache(logger, beaconCache, 1000)
+		, mGapSequenceNumber(0)
+		, mIsClosingGap(false)
+	{
+	}
+
+	void openGap(int32_t beaconID)
+	{
+		mGapSequenceNumber = BufferedBeaconCache::takeSequenceNumber(beaconID);
+	}
+
+	void closeGap(int32_t beaconID, int64_t timestamp, const core::UTF8String& data)
+	{
+		mIsClosingGap = true;
+		addEventData(beaconID, timestamp, data);
+	}
+
+protected:
+	virtual uint64_t takeSequenceNumber(int32_t beaconID) override
+	{
+		if (mIsClosingGap)
+		{
+			mIsClosingGap = false;
+			return mGapSequenceNumber;
+		}
+		return BufferedBeaconCache::takeSequenceNumber(beaconID);
+	}
+
+private:
+	uint64_t mGapSequenceNumber;
+	bool mIsClosingGap;
+};
+
+class BufferedBeaconCacheTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_DEBUG);
+		mBeaconCache = std::make_shared<BeaconCache>(mLogger);
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> mLogger;
+	std::shared_ptr<BeaconCache> mBeaconCache;
+};
+
+TEST_F(BufferedBeaconCacheTest, reportedDataIsNotAddedToCacheBeforeDrain)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+
+	// when
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+	target.addActionData(1, 1001L, core::UTF8String("b"));
+
+	// then (buffered data is accounted for nevertheless)
+	ASSERT_TRUE(mBeaconCache->getBeaconIDs().empty());
+	ASSERT_EQ(target.getNumBytesInCache(), 2L);
+}
+
+TEST_F(BufferedBeaconCacheTest, drainAddsBufferedDataToCache)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+	target.addEventData(2, 1001L, core::UTF8String("b"));
+	target.addActionData(1, 1002L, core::UTF8String("c"));
+
+	// when
+	target.drain();
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({ core::UTF8String("a") }));
+	ASSERT_EQ(mBeaconCache->getActions(1), std::vector<core::UTF8String>({ core::UTF8String("c") }));
+	ASSERT_EQ(mBeaconCache->getEvents(2), std::vector<core::UTF8String>({ core::UTF8String("b") }));
+	ASSERT_EQ(target.getNumBytesInCache(), 3L);
+}
+
+TEST_F(BufferedBeaconCacheTest, readingMethodsDrainBufferedDataFirst)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+
+	// then
+	ASSERT_FALSE(target.isEmpty(1));
+	ASSERT_EQ(target.getNumBytes(1), 1L);
+	ASSERT_EQ(target.getOldestRecordTimestamp(1), 1000L);
+	ASSERT_EQ(target.getBeaconIDs(), std::unordered_set<int32_t>({ 1 }));
+
+	// and when
+	target.addActionData(1, 1001L, core::UTF8String("b"));
+	auto obtained = target.getNextBeaconChunk(1, core::UTF8String("prefix"), 1024, core::UTF8String("&"));
+
+	// then
+	ASSERT_TRUE(obtained.equals("prefix&a&b"));
+}
+
+TEST_F(BufferedBeaconCacheTest, deleteCacheEntryAlsoDeletesBufferedData)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+
+	// when
+	target.deleteCacheEntry(1);
+
+	// then
+	ASSERT_TRUE(target.getBeaconIDs().empty());
+}
+
+TEST_F(BufferedBeaconCacheTest, deleteCacheEntryDiscardsHeldBackData)
+{
+	// given a record of beacon 1 held back behind a record of beacon 257, which shares its stripe
+	GapBufferedBeaconCache target(mLogger, mBeaconCache);
+	target.openGap(257);
+	target.addEventData(1, 1001L, core::UTF8String("a"));
+	target.drain();
+
+	// when
+	target.deleteCacheEntry(1);
+	target.closeGap(257, 1000L, core::UTF8String("b"));
+	target.drain();
+
+	// then the entry of beacon 1 is not created again
+	ASSERT_EQ(target.getBeaconIDs(), std::unordered_set<int32_t>({ 257 }));
+	ASSERT_EQ(target.getNumBytesInCache(), 1L);
+}
+
+TEST_F(BufferedBeaconCacheTest, heldBackDataIsAddedOnceTheGapClosed)
+{
+	// given
+	GapBufferedBeaconCache target(mLogger, mBeaconCache);
+	target.openGap(257);
+	target.addEventData(1, 1001L, core::UTF8String("a"));
+	target.drain();
+
+	// then
+	ASSERT_TRUE(mBeaconCache->getBeaconIDs().empty());
+	ASSERT_EQ(target.getNumBytesInCache(), 1L);
+
+	// and when
+	target.closeGap(257, 1000L, core::UTF8String("b"));
+	target.drain();
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({ core::UTF8String("a") }));
+	ASSERT_EQ(mBeaconCache->getEvents(257), std::vector<core::UTF8String>({ core::UTF8String("b") }));
+}
+
+TEST_F(BufferedBeaconCacheTest, dataOfOneBeaconIsAddedInReportingOrderAcrossThreads)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+
+	// when
+	for (auto i = 0; i < 4; i++)
+	{
+		std::thread reporter([&target, i]()
+		{
+			target.addEventData(1, 1000L + i, core::UTF8String(std::to_string(i)));
+		});
+		reporter.join();
+	}
+	target.drain();
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({
+		core::UTF8String("0"), core::UTF8String("1"), core::UTF8String("2"), core::UTF8String("3") }));
+}
+
+TEST_F(BufferedBeaconCacheTest, noDataIsLostWhenManyThreadsReportConcurrently)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1);
+	target.start();
+	const int32_t numThreads = 4;
+	const int32_t numRecords = 1000;
+
+	// when
+	std::vector<std::thread> reporters;
+	for (auto t = 0; t < numThreads; t++)
+	{
+		reporters.push_back(std::thread([&target, numRecords]()
+		{
+			for (auto i = 0; i < numRecords; i++)
+			{
+				target.addEventData(1, i, core::UTF8String("x"));
+			}
+		}));
+	}
+	for (auto& reporter : reporters)
+	{
+		reporter.join();
+	}
+	target.stop();
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1).size(), size_t(numThreads * numRecords));
+	ASSERT_EQ(target.getNumBytesInCache(), int64_t(numThreads * numRecords));
+}
+
+TEST_F(BufferedBeaconCacheTest, stopDrainsRemainingData)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 60000);
+	target.start();
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+
+	// when
+	auto obtained = target.stop();
+
+	// then
+	ASSERT_TRUE(obtained);
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({ core::UTF8String("a") }));
+}
+
+TEST_F(BufferedBeaconCacheTest, startAndStopCanOnlyBeCalledOnce)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+
+	// then
+	ASSERT_FALSE(target.stop());
+	ASSERT_TRUE(target.start());
+	ASSERT_FALSE(target.start());
+	ASSERT_TRUE(target.stop());
+	ASSERT_FALSE(target.stop());
+}
+
+TEST_F(BufferedBeaconCacheTest, observersAreNotifiedOncePerDrainedBeacon)
+{
+	// given
+	testing::StrictMock<test::MockObserver> observer;
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+	target.addObserver(&observer);
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+	target.addActionData(1, 1001L, core::UTF8String("b"));
+	target.addEventData(2, 1002L, core::UTF8String("c"));
+
+	// expect
+	EXPECT_CALL(observer, update())
+		.Times(testing::Exactly(2));
+
+	// when
+	target.drain();
+}
+
+TEST_F(BufferedBeaconCacheTest, recordsOfDifferentThreadsAreAddedInReportingOrder)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+	std::thread first([&target]()
+	{
+		target.addEventData(1, 1000L, core::UTF8String("a"));
+		target.addEventData(1, 1003L, core::UTF8String("b"));
+	});
+	first.join();
+	std::thread second([&target]()
+	{
+		target.addEventData(1, 1001L, core::UTF8String("c"));
+		target.addEventData(1, 1002L, core::UTF8String("d"));
+	});
+	second.join();
+
+	// when
+	target.drain();
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({
+		core::UTF8String("a"), core::UTF8String("b"), core::UTF8String("c"), core::UTF8String("d") }));
+}
+
+TEST_F(BufferedBeaconCacheTest, recordsOfTwoThreadsWithIdenticalTimestampsKeepTheirReportingOrder)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+
+	// when this thread and another one report alternately into one beacon
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+	std::thread other([&target]()
+	{
+		target.addEventData(1, 1000L, core::UTF8String("b"));
+	});
+	other.join();
+	target.addEventData(1, 1000L, core::UTF8String("c"));
+	std::thread another([&target]()
+	{
+		target.addEventData(1, 1000L, core::UTF8String("d"));
+	});
+	another.join();
+	target.drain();
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({
+		core::UTF8String("a"), core::UTF8String("b"), core::UTF8String("c"), core::UTF8String("d") }));
+}
+
+TEST_F(BufferedBeaconCacheTest, recordsOfOneThreadKeepTheirOrder)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 1000);
+	target.addEventData(1, 1005L, core::UTF8String("a"));
+	target.addEventData(1, 1001L, core::UTF8String("b"));
+
+	// when
+	target.drain();
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({ core::UTF8String("a"), core::UTF8String("b") }));
+}
+
+TEST_F(BufferedBeaconCacheTest, drainerThreadAddsBufferedRecords)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 10);
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+	target.addEventData(1, 2000L, core::UTF8String("b"));
+
+	// when
+	target.start();
+	for (auto i = 0; i < 500 && mBeaconCache->getEvents(1).size() < 2; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({ core::UTF8String("a"), core::UTF8String("b") }));
+	ASSERT_EQ(target.getNumBytesInCache(), 2L);
+	target.stop();
+}
+
+TEST_F(BufferedBeaconCacheTest, fullBufferIsDrainedByReportingThreadInsteadOfDroppingRecords)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 60000, 1024);
+	target.start();
+	auto data = core::UTF8String(std::string(256, 'x'));
+	const size_t numRecords = 1000;
+
+	// when reporting far more than fits into the buffer before the drainer thread's interval elapsed
+	for (size_t i = 0; i < numRecords; i++)
+	{
+		target.addEventData(1, 1000L, data);
+	}
+
+	// then the reporting thread made room itself, at most one buffer full of records is still buffered
+	ASSERT_GE(mBeaconCache->getEvents(1).size(), numRecords - 4);
+
+	// and no record is lost
+	target.stop();
+	ASSERT_EQ(mBeaconCache->getEvents(1).size(), numRecords);
+}
+
+TEST_F(BufferedBeaconCacheTest, fullBufferIsDrainedByReportingThreadWithoutDrainerThread)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 60000);
+	auto data = core::UTF8String(std::string(static_cast<size_t>(BufferedBeaconCache::DEFAULT_MAX_BUFFERED_BYTES_PER_THREAD), 'x'));
+
+	// when
+	target.addEventData(1, 1000L, data);
+	ASSERT_TRUE(mBeaconCache->getBeaconIDs().empty());
+	target.addEventData(1, 1001L, core::UTF8String("y"));
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1).size(), size_t(1));
+	target.drain();
+	ASSERT_EQ(mBeaconCache->getEvents(1).size(), size_t(2));
+}
+
+TEST_F(BufferedBeaconCacheTest, recordsReportedAfterStopAreAddedRightAway)
+{
+	// given
+	BufferedBeaconCache target(mLogger, mBeaconCache, 60000);
+	target.start();
+	target.stop();
+
+	// when
+	target.addEventData(1, 1000L, core::UTF8String("a"));
+
+	// then
+	ASSERT_EQ(mBeaconCache->getEvents(1), std::vector<core::UTF8String>({ core::UTF8String("a") }));
+}
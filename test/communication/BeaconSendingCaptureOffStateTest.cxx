@@ -159,6 +159,27 @@ TEST_F(BeaconSendingCaptureOffStateTest, aBeaconSendingCaptureOffStateWaitsForGi
 	target.execute(mockContext);
 }
 
+TEST_F(BeaconSendingCaptureOffStateTest, aBeaconSendingCaptureOffStateStoresDataWhenBackingOff)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOffState(int64_t(12345));
+
+	testing::NiceMock<test::MockBeaconSendingContext> mockContext(mLogger);
+	ON_CALL(mockContext, getHTTPClient())
+		.WillByDefault(testing::Return(mMockHTTPClient));
+	ON_CALL(mockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+
+	// verify that the data is stored instead of being dropped
+	EXPECT_CALL(mockContext, disableCaptureAndStoreData())
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(mockContext, disableCapture())
+		.Times(testing::Exactly(0));
+
+	// when calling execute
+	target.execute(mockContext);
+}
+
 TEST_F(BeaconSendingCaptureOffStateTest, aBeaconSendingCaptureOffStateStaysInOffStateWhenServerRespondsWithTooManyRequests)
 {
 	// given
@@ -17,6 +17,8 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <limits>
+
 #include "communication/BeaconSendingCaptureOnState.h"
 #include "communication/BeaconSendingCaptureOffState.h"
 #include "communication/AbstractBeaconSendingState.h"
@@ -335,6 +337,81 @@ TEST_F(BeaconSendingCaptureOnStateTest, newSessionRequestsAreMadeForAllNewSessio
 	ASSERT_EQ(capturedBeaconConfigurationForSession2->getCrashReportingLevel(), configuration::BeaconConfiguration::DEFAULT_CRASH_REPORTING_LEVEL);
 }
 
+TEST_F(BeaconSendingCaptureOnStateTest, newSessionRequestsOfOnePassShareOneHTTPClient)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession1Open);
+	auto sessionWrapper2 = std::make_shared<core::SessionWrapper>(mMockSession2Open);
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>{ sessionWrapper1, sessionWrapper2 }));
+
+	// expect the connection of a single client to be reused for all requests
+	EXPECT_CALL(*mMockContext, getHTTPClient())
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockHttpClient, sendNewSessionRequestRawPtrProxy())
+		.Times(testing::Exactly(2));
+
+	// when calling execute
+	target.execute(*mMockContext);
+
+	// then
+	ASSERT_TRUE(sessionWrapper1->isBeaconConfigurationSet());
+	ASSERT_TRUE(sessionWrapper2->isBeaconConfigurationSet());
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, freshMultiplicityIsSharedWithSessionsCreatedWithinTheSharingWindow)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto configuration = test::MockBeaconSendingContext::createConfiguration(nullptr, false, 1000);
+	auto mockContext = std::make_shared<testing::NiceMock<test::MockBeaconSendingContext>>(mLogger, configuration);
+	ON_CALL(*mockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(42L));
+	ON_CALL(*mockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+	ON_CALL(*mockContext, getHTTPClient())
+		.WillByDefault(testing::Return(mMockHttpClient));
+	ON_CALL(*mockContext, getAllNewSessions())
+		.WillByDefault(testing::Invoke(&*mockContext, &test::MockBeaconSendingContext::RealGetAllNewSessions));
+	ON_CALL(*mMockHttpClient, sendNewSessionRequestRawPtrProxy())
+		.WillByDefault(testing::Invoke([this]() -> protocol::StatusResponse*
+		{
+			return new protocol::StatusResponse(mLogger, "mp=3", 200, protocol::Response::ResponseHeaders());
+		}));
+
+	std::shared_ptr<configuration::BeaconConfiguration> capturedBeaconConfiguration;
+	ON_CALL(*mMockSession2Open, setBeaconConfiguration(testing::_))
+		.WillByDefault(testing::WithArgs<0>(testing::Invoke([&capturedBeaconConfiguration](std::shared_ptr<configuration::BeaconConfiguration> beaconConfig) {
+		capturedBeaconConfiguration = beaconConfig;
+	})));
+
+	mockContext->startSession(mMockSession1Open);
+	mockContext->startSession(mMockSession2Open);
+
+	// expect that only the first session requests a multiplicity
+	EXPECT_CALL(*mMockHttpClient, sendNewSessionRequestRawPtrProxy())
+		.Times(testing::Exactly(1));
+
+	// when executing the first pass
+	target.execute(*mockContext);
+
+	// then
+	ASSERT_EQ(mockContext->RealGetAllNewSessions().size(), size_t(1));
+
+	// when executing the second pass within the sharing window
+	ON_CALL(*mockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(1042L));
+	target.execute(*mockContext);
+
+	// then the second session took over the multiplicity
+	ASSERT_TRUE(mockContext->RealGetAllNewSessions().empty());
+	ASSERT_NE(capturedBeaconConfiguration, nullptr);
+	ASSERT_EQ(capturedBeaconConfiguration->getMultiplicity(), 3);
+}
+
 // Expectation: Given enough failed new session requests the beacon configuration created by the method
 // performing new session requests has a mulitplicity of '0'
 TEST_F(BeaconSendingCaptureOnStateTest, multiplicityIsSetToZeroIfNoFurtherNewSessionRequestsAreAllowed)
@@ -673,6 +750,73 @@ TEST_F(BeaconSendingCaptureOnStateTest, openSessionsAreSentIfSendIntervalIsExcee
 	target.execute(*mMockContext);
 }
 
+TEST_F(BeaconSendingCaptureOnStateTest, openSessionDataIsNoLongerPendingAfterAllOpenSessionsWereSent)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession1Open);
+	sessionWrapper1->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(2, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	std::vector<std::shared_ptr<core::SessionWrapper>> openSessions = { sessionWrapper1 };
+
+	ON_CALL(*mMockContext, getAllFinishedAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(openSessions));
+	ON_CALL(*mMockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+
+	ON_CALL(*mMockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(100));
+	ON_CALL(*mMockContext, getSendInterval())
+		.WillByDefault(testing::Return(50));
+	ON_CALL(*mMockContext, getLastOpenSessionBeaconSendTime())
+		.WillByDefault(testing::Return(45));
+	mMockContext->setOpenSessionDataPending(true);
+
+	// when calling execute
+	target.execute(*mMockContext);
+
+	// then
+	ASSERT_FALSE(mMockContext->isOpenSessionDataPending());
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, openSessionDataStaysPendingIfAnOpenSessionIsRetried)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession1Open);
+	sessionWrapper1->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(2, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	auto sessionWrapper2 = std::make_shared<core::SessionWrapper>(mMockSession2Open);
+	sessionWrapper2->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(2, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	std::vector<std::shared_ptr<core::SessionWrapper>> openSessions = { sessionWrapper1, sessionWrapper2 };
+
+	ON_CALL(*mMockContext, getAllFinishedAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(openSessions));
+	ON_CALL(*mMockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+
+	ON_CALL(*mMockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(100));
+	ON_CALL(*mMockContext, getSendInterval())
+		.WillByDefault(testing::Return(50));
+	ON_CALL(*mMockContext, getLastOpenSessionBeaconSendTime())
+		.WillByDefault(testing::Return(45));
+
+	// when calling execute (second session fails and is retried later)
+	target.execute(*mMockContext);
+
+	// then
+	ASSERT_TRUE(mMockContext->isOpenSessionDataPending());
+}
+
 TEST_F(BeaconSendingCaptureOnStateTest, openSessionsAreNotSentIfSendIntervalIsNotExceeded)
 {
 	// given
@@ -713,6 +857,106 @@ TEST_F(BeaconSendingCaptureOnStateTest, openSessionsAreNotSentIfSendIntervalIsNo
 	target.execute(*mMockContext);
 }
 
+TEST_F(BeaconSendingCaptureOnStateTest, openSessionsReachingFlushThresholdAreSentBeforeSendIntervalIsExceeded)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession1Open);
+	sessionWrapper1->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(2, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	auto sessionWrapper2 = std::make_shared<core::SessionWrapper>(mMockSession2Open);
+	sessionWrapper2->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(2, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	std::vector<std::shared_ptr<core::SessionWrapper>> openSessions = { sessionWrapper1, sessionWrapper2 };
+
+	ON_CALL(*mMockContext, getAllFinishedAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(openSessions));
+	ON_CALL(*mMockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+	ON_CALL(*mMockSession1Open, isSendThresholdReached())
+		.WillByDefault(testing::Return(true));
+
+	ON_CALL(*mMockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(100));
+	ON_CALL(*mMockContext, getSendInterval())
+		.WillByDefault(testing::Return(50));
+	ON_CALL(*mMockContext, getLastOpenSessionBeaconSendTime())
+		.WillByDefault(testing::Return(60));
+
+	EXPECT_CALL(*mMockSession1Open, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockSession2Open, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mMockContext, setLastOpenSessionBeaconSendTime(testing::_))
+		.Times(testing::Exactly(0));
+
+	// when calling execute
+	target.execute(*mMockContext);
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, openSessionIsResentAtItsRetryTimeBeforeSendIntervalIsExceeded)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession1Open);
+	sessionWrapper1->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(2, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	sessionWrapper1->recordFailedSendAttempt(100L);
+	auto sessionWrapper2 = std::make_shared<core::SessionWrapper>(mMockSession2Open);
+	sessionWrapper2->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(2, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	sessionWrapper2->recordFailedSendAttempt(101L);
+	std::vector<std::shared_ptr<core::SessionWrapper>> openSessions = { sessionWrapper1, sessionWrapper2 };
+
+	ON_CALL(*mMockContext, getAllFinishedAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(openSessions));
+	ON_CALL(*mMockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+
+	ON_CALL(*mMockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(100));
+	ON_CALL(*mMockContext, getSendInterval())
+		.WillByDefault(testing::Return(50));
+	ON_CALL(*mMockContext, getLastOpenSessionBeaconSendTime())
+		.WillByDefault(testing::Return(60));
+
+	// then only the session whose retry is due is sent, the send interval is not exceeded
+	EXPECT_CALL(*mMockSession1Open, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockSession2Open, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mMockContext, setLastOpenSessionBeaconSendTime(testing::_))
+		.Times(testing::Exactly(0));
+
+	// when calling execute
+	target.execute(*mMockContext);
+
+	// then the successful retry clears the retry state
+	ASSERT_EQ(sessionWrapper1->getNumFailedSendAttempts(), uint32_t(0));
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, executeWaitsForWakeupBeforeSending)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	// expect
+	testing::InSequence sequence;
+	EXPECT_CALL(*mMockContext, waitForWakeup())
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockContext, getAllNewSessions())
+		.Times(testing::Exactly(1));
+
+	// when calling execute
+	target.execute(*mMockContext);
+}
+
 TEST_F(BeaconSendingCaptureOnStateTest, sendingOpenSessionsIsAbortedImmediatelyWhenTooManyRequestsResponseIsReceived)
 {
 	// given
@@ -838,6 +1082,233 @@ TEST_F(BeaconSendingCaptureOnStateTest, nothingIsSentIfStateIsInterruptedDuringS
 	target.execute(*mMockContext);
 }
 
+TEST_F(BeaconSendingCaptureOnStateTest, failedFinishedSessionIsDeferredAndDoesNotBlockOtherFinishedSessions)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession3Finished);
+	sessionWrapper1->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	auto sessionWrapper2 = std::make_shared<core::SessionWrapper>(mMockSession4Finished);
+	sessionWrapper2->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	std::vector<std::shared_ptr<core::SessionWrapper>> finishedSessions = { sessionWrapper1, sessionWrapper2 };
+
+	ON_CALL(*mMockContext, getAllFinishedAndConfiguredSessions())
+		.WillByDefault(testing::Return(finishedSessions));
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+
+	ON_CALL(*mMockSession3Finished, sendBeaconRawPtrProxy(testing::_))
+		.WillByDefault(testing::Invoke([&](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse*
+		{
+			return new protocol::StatusResponse(mLogger, core::UTF8String(), std::numeric_limits<int32_t>::max(), protocol::Response::ResponseHeaders());
+		}));
+	ON_CALL(*mMockSession4Finished, sendBeaconRawPtrProxy(testing::_))
+		.WillByDefault(testing::Invoke([&](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse*
+		{
+			return new protocol::StatusResponse(mLogger, core::UTF8String(), 200, protocol::Response::ResponseHeaders());
+		}));
+
+	// then
+	EXPECT_CALL(*mMockSession3Finished, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockSession4Finished, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockContext, removeSession(testing::Eq(sessionWrapper1)))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mMockContext, removeSession(testing::Eq(sessionWrapper2)))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockContext, setNextState(testing::_))
+		.Times(testing::Exactly(0));
+
+	// when calling execute
+	target.execute(*mMockContext);
+
+	// the failed session is deferred by the retry scheduler
+	ASSERT_EQ(sessionWrapper1->getNumFailedSendAttempts(), uint32_t(1));
+	ASSERT_GT(sessionWrapper1->getNextSendAttemptTime(), 42L);
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, deferredFinishedSessionIsNotSentBeforeRetryIsDue)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession3Finished);
+	sessionWrapper1->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	sessionWrapper1->recordFailedSendAttempt(43L);
+	std::vector<std::shared_ptr<core::SessionWrapper>> finishedSessions = { sessionWrapper1 };
+
+	ON_CALL(*mMockContext, getAllFinishedAndConfiguredSessions())
+		.WillByDefault(testing::Return(finishedSessions));
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>()));
+	ON_CALL(*mMockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+
+	// then
+	EXPECT_CALL(*mMockSession3Finished, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mMockContext, removeSession(testing::_))
+		.Times(testing::Exactly(0));
+
+	// when calling execute
+	target.execute(*mMockContext);
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, failedNewSessionRequestIsDeferred)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto sessionWrapper1 = std::make_shared<core::SessionWrapper>(mMockSession1Open);
+	std::vector<std::shared_ptr<core::SessionWrapper>> newSessions = { sessionWrapper1 };
+
+	ON_CALL(*mMockContext, getAllNewSessions())
+		.WillByDefault(testing::Return(newSessions));
+	ON_CALL(*mMockHttpClient, sendNewSessionRequestRawPtrProxy())
+		.WillByDefault(testing::Invoke([this]() -> protocol::StatusResponse*
+		{
+			return new protocol::StatusResponse(mLogger, "", 500, protocol::Response::ResponseHeaders());
+		}));
+
+	// then
+	EXPECT_CALL(*mMockHttpClient, sendNewSessionRequestRawPtrProxy())
+		.Times(testing::Exactly(1));
+
+	// when calling execute twice at the same time
+	target.execute(*mMockContext);
+	target.execute(*mMockContext);
+
+	// the session is deferred and only one request was made
+	ASSERT_EQ(sessionWrapper1->getNumFailedSendAttempts(), uint32_t(1));
+	ASSERT_FALSE(sessionWrapper1->isBeaconConfigurationSet());
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, sessionsAreNotSentWhileUploadsAreThrottled)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	// a rate limiter with an exhausted budget and a frozen clock
+	auto mockTimingProvider = std::make_shared<testing::NiceMock<test::MockTimingProvider>>();
+	ON_CALL(*mockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(0L));
+	auto uploadRateLimiter = std::make_shared<protocol::UploadRateLimiter>(mockTimingProvider, 1000, 1000);
+	uploadRateLimiter->acquire(1000);
+
+	auto mockContext = std::make_shared<testing::NiceMock<test::MockBeaconSendingContext>>(mLogger, uploadRateLimiter);
+	ON_CALL(*mockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(42L));
+	ON_CALL(*mockContext, getSendInterval())
+		.WillByDefault(testing::Return(0L));
+	ON_CALL(*mockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+	ON_CALL(*mockContext, getHTTPClientProvider())
+		.WillByDefault(testing::Return(mMockHttpClientProvider));
+
+	auto openSession = std::make_shared<core::SessionWrapper>(mMockSession1Open);
+	openSession->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	auto finishedSession = std::make_shared<core::SessionWrapper>(mMockSession3Finished);
+	finishedSession->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+
+	ON_CALL(*mockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>{ openSession }));
+	ON_CALL(*mockContext, getAllFinishedAndConfiguredSessions())
+		.WillByDefault(testing::Return(std::vector<std::shared_ptr<core::SessionWrapper>>{ finishedSession }));
+
+	// then
+	EXPECT_CALL(*mMockSession1Open, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mMockSession3Finished, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mockContext, removeSession(testing::_))
+		.Times(testing::Exactly(0));
+	// open sessions are sent as soon as the budget is refilled, not only after the next send interval
+	EXPECT_CALL(*mockContext, setLastOpenSessionBeaconSendTime(testing::_))
+		.Times(testing::Exactly(0));
+
+	// when calling execute
+	target.execute(*mockContext);
+}
+
+TEST_F(BeaconSendingCaptureOnStateTest, staggeredOpenSessionsAreSpreadAcrossTheSendInterval)
+{
+	// given
+	auto target = communication::BeaconSendingCaptureOnState();
+
+	auto configuration = test::MockBeaconSendingContext::createConfiguration(nullptr, true);
+	auto mockContext = std::make_shared<testing::NiceMock<test::MockBeaconSendingContext>>(mLogger, configuration);
+	ON_CALL(*mockContext, getSendInterval())
+		.WillByDefault(testing::Return(1000L));
+	ON_CALL(*mockContext, isCaptureOn())
+		.WillByDefault(testing::Return(true));
+	ON_CALL(*mockContext, getHTTPClientProvider())
+		.WillByDefault(testing::Return(mMockHttpClientProvider));
+
+	std::vector<std::shared_ptr<testing::NiceMock<test::MockSession>>> mockSessions;
+	std::vector<std::shared_ptr<core::SessionWrapper>> openSessions;
+	for (int32_t i = 0; i < 4; i++)
+	{
+		auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+		ON_CALL(*mockSession, sendBeaconRawPtrProxy(testing::_))
+			.WillByDefault(testing::Invoke([&](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse*
+			{
+				return new protocol::StatusResponse(mLogger, "", 200, protocol::Response::ResponseHeaders());
+			}));
+		ON_CALL(*mockSession, getBeaconConfiguration())
+			.WillByDefault(testing::Return(std::make_shared<configuration::BeaconConfiguration>()));
+		auto openSession = std::make_shared<core::SessionWrapper>(mockSession);
+		openSession->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+		mockSessions.push_back(mockSession);
+		openSessions.push_back(openSession);
+	}
+	ON_CALL(*mockContext, getAllOpenAndConfiguredSessions())
+		.WillByDefault(testing::Return(openSessions));
+
+	// then the first session of the cohort is sent when the send interval expires
+	ON_CALL(*mockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(2000L));
+	EXPECT_CALL(*mockSessions[0], sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mockSessions[1], sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mockSessions[2], sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mockSessions[3], sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mockContext, setLastOpenSessionBeaconSendTime(2000L))
+		.Times(testing::Exactly(1));
+
+	// when
+	target.execute(*mockContext);
+	ASSERT_EQ(mockContext->getOpenSessionScheduler()->getNextDeadline(), 2250);
+
+	// then the sessions whose slots started are sent halfway through the interval
+	testing::Mock::VerifyAndClearExpectations(&*mockSessions[1]);
+	testing::Mock::VerifyAndClearExpectations(&*mockSessions[2]);
+	ON_CALL(*mockContext, getLastOpenSessionBeaconSendTime())
+		.WillByDefault(testing::Return(2000L));
+	ON_CALL(*mockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Return(2500L));
+	EXPECT_CALL(*mockSessions[1], sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mockSessions[2], sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+
+	// when
+	target.execute(*mockContext);
+
+	// then
+	ASSERT_EQ(mockContext->getOpenSessionScheduler()->getNextDeadline(), 2750);
+}
+
 TEST_F(BeaconSendingCaptureOnStateTest, getStateNameReturnsCorrectStateName)
 {
 	// given
@@ -23,6 +23,7 @@
 #include "providers/DefaultHTTPClientProvider.h"
 #include "providers/DefaultSessionIDProvider.h"
 #include "protocol/ssl/SSLStrictTrustManager.h"
+#include "core/util/Compressor.h"
 #include "core/util/DefaultLogger.h"
 
 #include "../protocol/MockHTTPClient.h"
@@ -32,6 +33,13 @@
 #include "../providers/MockHTTPClientProvider.h"
 #include "../communication/CustomMatchers.h"
 #include "../core/MockSession.h"
+#include "../caching/MockBeaconCache.h"
+
+#include <cstdio>
+#include <thread>
+
+#include <dirent.h>
+#include <unistd.h>
 
 class BeaconSendingContextTest : public testing::Test
 {
@@ -68,6 +76,38 @@ protected:
 		mMockHttpClientProvider = nullptr;
 		mMockTimingProvider = nullptr;
 		mMockState = nullptr;
+
+		if (!mStoreDirectory.empty())
+		{
+			DIR* dir = opendir(mStoreDirectory.c_str());
+			if (dir != nullptr)
+			{
+				struct dirent* entry;
+				while ((entry = readdir(dir)) != nullptr)
+				{
+					std::remove((mStoreDirectory + "/" + entry->d_name).c_str());
+				}
+				closedir(dir);
+			}
+			rmdir(mStoreDirectory.c_str());
+		}
+	}
+
+	std::shared_ptr<configuration::Configuration> createStoreAndForwardConfiguration(int64_t replayBytesPerSecond)
+	{
+		char directoryTemplate[] = "/tmp/BeaconSendingContextTest.XXXXXX";
+		if (mkdtemp(directoryTemplate) != nullptr)
+		{
+			mStoreDirectory = directoryTemplate;
+		}
+
+		return std::shared_ptr<configuration::Configuration>(new configuration::Configuration(std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")),
+			configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1", core::UTF8String(""),
+			std::make_shared<providers::DefaultSessionIDProvider>(),
+			std::make_shared<protocol::SSLStrictTrustManager>(),
+			mBeaconCacheConfiguration, mBeaconConfiguration, nullptr, nullptr, nullptr, 1, false, false, 0, nullptr,
+			openkit::SendPriorityPolicy::INSERTION_ORDER,
+			std::make_shared<configuration::StoreAndForwardConfiguration>(mStoreDirectory, 1024 * 1024, 0, replayBytesPerSecond)));
 	}
 
 	std::ostringstream devNull;
@@ -78,6 +118,7 @@ protected:
 	std::shared_ptr<testing::NiceMock<test::MockHTTPClientProvider>> mMockHttpClientProvider;
 	std::shared_ptr<testing::NiceMock<test::MockTimingProvider>> mMockTimingProvider;
 	std::shared_ptr<testing::StrictMock<test::MockAbstractBeaconSendingState>> mMockState;
+	std::string mStoreDirectory;
 };
 
 TEST_F(BeaconSendingContextTest, currentStateIsInitializedAccordingly)
@@ -146,6 +187,30 @@ TEST_F(BeaconSendingContextTest, requestShutdown)
 	ASSERT_TRUE(obtained);
 }
 
+TEST_F(BeaconSendingContextTest, requestShutdownWithTimeoutSetsShutdownDeadline)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(1000));
+	ASSERT_FALSE(target->isShutdownDeadlineExpired());
+
+	// when
+	target->requestShutdownWithTimeout(500);
+
+	// then
+	ASSERT_TRUE(target->isShutdownRequested());
+	ASSERT_FALSE(target->isShutdownDeadlineExpired());
+	ASSERT_TRUE(mConfiguration->getHTTPClientConfiguration()->getTransferDeadline()->isSet());
+
+	// and when
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(1500));
+
+	// then
+	ASSERT_TRUE(target->isShutdownDeadlineExpired());
+}
+
 TEST_F(BeaconSendingContextTest, initCompleteFailureAndWait)
 {
 	// given
@@ -319,6 +384,30 @@ TEST_F(BeaconSendingContextTest, getSendIntervalRetrievesItFromConfiguration)
 	ASSERT_EQ(obtained, 1234L);
 }
 
+TEST_F(BeaconSendingContextTest, getSendIntervalIsAdaptedUnderCachePressure)
+{
+	// given
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, getNumBytesInCache())
+		.WillByDefault(testing::Return(1000));
+	auto adaptiveSendingController = std::make_shared<protocol::AdaptiveSendingController>(1000, 1000);
+	adaptiveSendingController->setBeaconCache(mockBeaconCache);
+	auto configuration = std::shared_ptr<configuration::Configuration>(new configuration::Configuration(std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")),
+		configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1", core::UTF8String(""),
+		std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(),
+		mBeaconCacheConfiguration, mBeaconConfiguration, nullptr, nullptr, nullptr, 1, false, false, 0, adaptiveSendingController));
+	configuration->setSendInterval(8000L);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+
+	// when
+	target->updateAdaptiveSending();
+
+	// then
+	ASSERT_EQ(target->getSendInterval(), 4000L);
+	ASSERT_EQ(configuration->getSendInterval(), 8000L);
+}
+
 TEST_F(BeaconSendingContextTest, testGetHTTPClient)
 {
 	// given
@@ -738,3 +827,601 @@ TEST_F(BeaconSendingContextTest, afterAFinishedSessionHasBeenConfiguredItsFinish
 	ASSERT_EQ(target->getAllOpenAndConfiguredSessions().size(), 0);
 	ASSERT_EQ(target->getAllFinishedAndConfiguredSessions().size(), 2);
 }
+
+TEST_F(BeaconSendingContextTest, wakeupDelayIsNegativeIfThereAreNoSessions)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+
+	// then
+	ASSERT_LT(target->getWakeupDelay(), 0);
+}
+
+TEST_F(BeaconSendingContextTest, wakeupDelayIsZeroForNewSession)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	auto mockSession = std::shared_ptr<testing::NiceMock<test::MockSession>>(new testing::NiceMock<test::MockSession>(mLogger));
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(500));
+
+	// when
+	target->startSession(mockSession);
+
+	// then
+	ASSERT_EQ(target->getWakeupDelay(), 0);
+}
+
+TEST_F(BeaconSendingContextTest, wakeupDelayIsNegativeForEmptyOpenSession)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	auto mockSession = std::shared_ptr<testing::NiceMock<test::MockSession>>(new testing::NiceMock<test::MockSession>(mLogger));
+	ON_CALL(*mockSession, isEmpty())
+		.WillByDefault(testing::Return(true));
+
+	// when
+	target->startSession(mockSession);
+	target->findSessionWrapper(mockSession)->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+
+	// then
+	ASSERT_LT(target->getWakeupDelay(), 0);
+}
+
+TEST_F(BeaconSendingContextTest, wakeupDelayForOpenSessionWithDataEndsWithSendInterval)
+{
+	// given
+	mConfiguration->setSendInterval(1000);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	auto mockSession = std::shared_ptr<testing::NiceMock<test::MockSession>>(new testing::NiceMock<test::MockSession>(mLogger));
+	ON_CALL(*mockSession, isEmpty())
+		.WillByDefault(testing::Return(false));
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(500));
+
+	// when (adding data raises the wakeup event)
+	target->startSession(mockSession);
+	target->findSessionWrapper(mockSession)->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	target->setLastOpenSessionBeaconSendTime(100);
+	target->getWakeupEvent()->signal();
+	target->waitForWakeup();
+
+	// then
+	ASSERT_EQ(target->getWakeupDelay(), 601);
+}
+
+TEST_F(BeaconSendingContextTest, wakeupDelayIsNegativeForOpenSessionWithoutNewData)
+{
+	// given
+	mConfiguration->setSendInterval(1000);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	auto mockSession = std::shared_ptr<testing::NiceMock<test::MockSession>>(new testing::NiceMock<test::MockSession>(mLogger));
+	ON_CALL(*mockSession, isEmpty())
+		.WillByDefault(testing::Return(false));
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(500));
+
+	// when (data was sent in the last pass)
+	target->startSession(mockSession);
+	target->findSessionWrapper(mockSession)->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	target->setLastOpenSessionBeaconSendTime(100);
+	target->setOpenSessionDataPending(false);
+
+	// then (open sessions are not inspected one by one)
+	ASSERT_LT(target->getWakeupDelay(), 0);
+}
+
+TEST_F(BeaconSendingContextTest, wakeupDelayEndsWithRetryOfOpenSession)
+{
+	// given
+	mConfiguration->setSendInterval(100000);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	auto mockSession = std::shared_ptr<testing::NiceMock<test::MockSession>>(new testing::NiceMock<test::MockSession>(mLogger));
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(500));
+
+	// when
+	target->startSession(mockSession);
+	auto wrapper = target->findSessionWrapper(mockSession);
+	wrapper->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	target->setLastOpenSessionBeaconSendTime(500);
+	target->getRetryScheduler()->scheduleRetry(wrapper, 500);
+
+	// then
+	auto delay = target->getWakeupDelay();
+	ASSERT_GT(delay, 0);
+	ASSERT_EQ(delay, wrapper->getNextSendAttemptTime() - 500);
+}
+
+TEST_F(BeaconSendingContextTest, wakeupDelayIsZeroForFinishedSession)
+{
+	// given
+	mConfiguration->setSendInterval(1000);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	auto mockSession = std::shared_ptr<testing::NiceMock<test::MockSession>>(new testing::NiceMock<test::MockSession>(mLogger));
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(500));
+
+	// when
+	target->startSession(mockSession);
+	target->findSessionWrapper(mockSession)->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	target->setLastOpenSessionBeaconSendTime(100);
+	target->finishSession(mockSession);
+
+	// then
+	ASSERT_EQ(target->getWakeupDelay(), 0);
+}
+
+TEST_F(BeaconSendingContextTest, waitForWakeupReturnsWhenSessionIsStarted)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	auto mockSession = std::shared_ptr<testing::NiceMock<test::MockSession>>(new testing::NiceMock<test::MockSession>(mLogger));
+	std::thread starter([target, mockSession]
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		target->startSession(mockSession);
+	});
+
+	// when, then (no sessions -> waits until the session is started)
+	target->waitForWakeup();
+	starter.join();
+
+	ASSERT_EQ(target->getAllNewSessions().size(), 1);
+}
+
+TEST_F(BeaconSendingContextTest, waitForWakeupReturnsWhenShutdownIsRequested)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+	std::thread stopper([target]
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		target->requestShutdown();
+	});
+
+	// when
+	target->waitForWakeup();
+	stopper.join();
+
+	// then
+	ASSERT_TRUE(target->isShutdownRequested());
+}
+
+TEST_F(BeaconSendingContextTest, sendBeaconsOnWorkerPoolReturnsResultsInOrderOfSessions)
+{
+	// given
+	auto configuration = std::shared_ptr<configuration::Configuration>(new configuration::Configuration(std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")),
+		configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1", core::UTF8String(""),
+		std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(),
+		mBeaconCacheConfiguration, mBeaconConfiguration, nullptr, nullptr, nullptr, 4));
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessions;
+	for (int32_t i = 0; i < 8; i++)
+	{
+		auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+		auto logger = mLogger;
+		auto responseCode = 200 + i;
+		EXPECT_CALL(*mockSession, sendBeaconRawPtrProxy(testing::_))
+			.Times(testing::Exactly(1))
+			.WillOnce(testing::Invoke([logger, responseCode](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse*
+			{
+				return new protocol::StatusResponse(logger, "", responseCode, protocol::Response::ResponseHeaders());
+			}));
+		target->startSession(mockSession);
+		sessions.push_back(target->findSessionWrapper(mockSession));
+	}
+
+	// when
+	auto obtained = target->sendBeacons(sessions);
+
+	// then
+	ASSERT_EQ(obtained.size(), sessions.size());
+	for (size_t i = 0; i < obtained.size(); i++)
+	{
+		ASSERT_TRUE(obtained[i].sent);
+		ASSERT_NE(obtained[i].response, nullptr);
+		ASSERT_EQ(obtained[i].response->getResponseCode(), int32_t(200 + i));
+	}
+}
+
+TEST_F(BeaconSendingContextTest, flushBeaconsOnWorkerPoolReportsSentData)
+{
+	// given
+	auto configuration = std::shared_ptr<configuration::Configuration>(new configuration::Configuration(std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")),
+		configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1", core::UTF8String(""),
+		std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(),
+		mBeaconCacheConfiguration, mBeaconConfiguration, nullptr, nullptr, nullptr, 4));
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessions;
+	for (int32_t i = 0; i < 8; i++)
+	{
+		auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+		auto logger = mLogger;
+		auto numBytes = std::make_shared<std::atomic<int64_t>>(100);
+		ON_CALL(*mockSession, getNumBytesInCache())
+			.WillByDefault(testing::Invoke([numBytes]() { return numBytes->load(); }));
+		EXPECT_CALL(*mockSession, sendBeaconRawPtrProxy(testing::_))
+			.Times(testing::Exactly(1))
+			.WillOnce(testing::Invoke([logger, numBytes](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse*
+			{
+				*numBytes = 0;
+				return new protocol::StatusResponse(logger, "", 200, protocol::Response::ResponseHeaders());
+			}));
+		ON_CALL(*mockSession, getBeaconConfiguration())
+			.WillByDefault(testing::Return(std::make_shared<configuration::BeaconConfiguration>()));
+		target->startSession(mockSession);
+		sessions.push_back(target->findSessionWrapper(mockSession));
+		sessions.back()->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	}
+
+	// when
+	auto obtained = target->flushBeacons(sessions);
+
+	// then
+	ASSERT_EQ(obtained.size(), sessions.size());
+	auto shutdownReport = target->getShutdownReport();
+	ASSERT_FALSE(shutdownReport.isDeadlineExceeded);
+	ASSERT_EQ(shutdownReport.numSessionsFlushed, 8);
+	ASSERT_EQ(shutdownReport.numSessionsDropped, 0);
+	ASSERT_EQ(shutdownReport.numBytesFlushed, int64_t(800));
+	ASSERT_EQ(shutdownReport.numBytesDropped, int64_t(0));
+}
+
+TEST_F(BeaconSendingContextTest, sendNewSessionRequestsOnWorkerPoolReusesOneClientPerWorker)
+{
+	// given
+	auto configuration = std::shared_ptr<configuration::Configuration>(new configuration::Configuration(std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")),
+		configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1", core::UTF8String(""),
+		std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(),
+		mBeaconCacheConfiguration, mBeaconConfiguration, nullptr, nullptr, nullptr, 4));
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+
+	auto logger = mLogger;
+	std::atomic<uint32_t> numClients(0);
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Invoke([logger, &numClients](std::shared_ptr<openkit::ILogger>, std::shared_ptr<configuration::HTTPClientConfiguration> httpClientConfiguration) -> std::shared_ptr<protocol::IHTTPClient>
+		{
+			numClients++;
+			auto mockClient = std::make_shared<testing::NiceMock<test::MockHTTPClient>>(httpClientConfiguration);
+			ON_CALL(*mockClient, sendNewSessionRequestRawPtrProxy())
+				.WillByDefault(testing::Invoke([logger]() -> protocol::StatusResponse*
+				{
+					return new protocol::StatusResponse(logger, "mp=1", 200, protocol::Response::ResponseHeaders());
+				}));
+			return mockClient;
+		}));
+
+	// when
+	auto obtained = target->sendNewSessionRequests(16);
+
+	// then
+	ASSERT_EQ(obtained.size(), size_t(16));
+	for (auto& response : obtained)
+	{
+		ASSERT_NE(response, nullptr);
+		ASSERT_EQ(response->getResponseCode(), 200);
+	}
+	ASSERT_GE(numClients.load(), uint32_t(1));
+	ASSERT_LE(numClients.load(), uint32_t(4));
+}
+
+TEST_F(BeaconSendingContextTest, sharedNewSessionResponseExpiresAfterSharingWindow)
+{
+	// given
+	auto configuration = std::shared_ptr<configuration::Configuration>(new configuration::Configuration(std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")),
+		configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1", core::UTF8String(""),
+		std::make_shared<providers::DefaultSessionIDProvider>(),
+		std::make_shared<protocol::SSLStrictTrustManager>(),
+		mBeaconCacheConfiguration, mBeaconConfiguration, nullptr, nullptr, nullptr, 1, false, false, 500));
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	auto response = std::make_shared<protocol::StatusResponse>(mLogger, "mp=2", 200, protocol::Response::ResponseHeaders());
+
+	// when
+	target->setSharedNewSessionResponse(response, 1000);
+
+	// then
+	ASSERT_TRUE(target->isMultiplicityShared());
+	ASSERT_EQ(target->getSharedNewSessionResponse(1500), response);
+	ASSERT_EQ(target->getSharedNewSessionResponse(1501), nullptr);
+}
+
+TEST_F(BeaconSendingContextTest, newSessionResponseIsNotSharedByDefault)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+
+	// when
+	target->setSharedNewSessionResponse(std::make_shared<protocol::StatusResponse>(mLogger, "mp=2", 200, protocol::Response::ResponseHeaders()), 1000);
+
+	// then
+	ASSERT_FALSE(target->isMultiplicityShared());
+	ASSERT_EQ(target->getSharedNewSessionResponse(1000), nullptr);
+}
+
+TEST_F(BeaconSendingContextTest, chunkStoreIsNotCreatedByDefault)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, mConfiguration));
+
+	// then
+	ASSERT_EQ(target->getChunkStore(), nullptr);
+	ASSERT_EQ(target->replayStoredChunks(), nullptr);
+}
+
+TEST_F(BeaconSendingContextTest, disableCaptureAndStoreDataStoresSessionDataBeforeClearingIt)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, createStoreAndForwardConfiguration(0)));
+	ASSERT_NE(target->getChunkStore(), nullptr);
+
+	auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+	ON_CALL(*mockSession, getBeaconConfiguration())
+		.WillByDefault(testing::Return(std::make_shared<configuration::BeaconConfiguration>()));
+	target->startSession(mockSession);
+	target->findSessionWrapper(mockSession)->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+
+	// expect
+	testing::InSequence s;
+	EXPECT_CALL(*mockSession, storeBeacon(testing::Ref(*target->getChunkStore()), testing::_))
+		.Times(testing::Exactly(1))
+		.WillOnce(testing::Return(true));
+	EXPECT_CALL(*mockSession, clearCapturedData())
+		.Times(testing::Exactly(1));
+
+	// when
+	target->disableCaptureAndStoreData();
+
+	// then
+	ASSERT_FALSE(target->isCaptureOn());
+}
+
+TEST_F(BeaconSendingContextTest, disableCaptureDoesNotStoreSessionData)
+{
+	// given
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, createStoreAndForwardConfiguration(0)));
+
+	auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+	ON_CALL(*mockSession, getBeaconConfiguration())
+		.WillByDefault(testing::Return(std::make_shared<configuration::BeaconConfiguration>()));
+	target->startSession(mockSession);
+	target->findSessionWrapper(mockSession)->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+
+	// expect
+	EXPECT_CALL(*mockSession, storeBeacon(testing::_, testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mockSession, clearCapturedData())
+		.Times(testing::Exactly(1));
+
+	// when
+	target->disableCapture();
+}
+
+TEST_F(BeaconSendingContextTest, replayStoredChunksSendsChunksOldestFirstAndRemovesThem)
+{
+	// given
+	auto configuration = createStoreAndForwardConfiguration(0);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	target->getChunkStore()->store(core::UTF8String("10.0.0.1"), core::UTF8String("vv=3"), protocol::BeaconPayload(core::UTF8String("&first")), 0);
+	target->getChunkStore()->store(core::UTF8String("10.0.0.2"), core::UTF8String("vv=3"), protocol::BeaconPayload(core::UTF8String("&second")), 0);
+
+	auto mockClient = std::make_shared<testing::StrictMock<test::MockHTTPClient>>(configuration->getHTTPClientConfiguration());
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockClient));
+
+	// expect
+	auto logger = mLogger;
+	std::vector<std::string> sentChunks;
+	EXPECT_CALL(*mockClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.Times(testing::Exactly(2))
+		.WillRepeatedly(testing::Invoke([logger, &sentChunks](const core::UTF8String& clientIPAddress, const core::UTF8String& beaconData)
+		{
+			sentChunks.push_back(clientIPAddress.getStringData() + " " + beaconData.getStringData());
+			return new protocol::StatusResponse(logger, "", 200, protocol::Response::ResponseHeaders());
+		}));
+
+	// when
+	auto obtained = target->replayStoredChunks();
+
+	// then
+	ASSERT_NE(obtained, nullptr);
+	ASSERT_EQ(obtained->getResponseCode(), 200);
+	ASSERT_EQ(sentChunks, std::vector<std::string>({ "10.0.0.1 vv=3&tx=0&first", "10.0.0.2 vv=3&tx=0&second" }));
+	ASSERT_TRUE(target->getChunkStore()->isEmpty());
+}
+
+TEST_F(BeaconSendingContextTest, replayStoredChunksDecompressesChunksForClientsSendingPlainData)
+{
+	// given
+	auto configuration = createStoreAndForwardConfiguration(0);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	std::string beaconData = "&et=1&na=action&et=1&na=action";
+	std::vector<unsigned char> compressedData;
+	base::util::Compressor::compressMemory(beaconData.c_str(), beaconData.size(), compressedData);
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String("vv=3"), protocol::BeaconPayload(core::UTF8String(beaconData), std::move(compressedData)), 0);
+
+	auto mockClient = std::make_shared<testing::StrictMock<test::MockHTTPClient>>(configuration->getHTTPClientConfiguration());
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockClient));
+
+	// expect
+	auto logger = mLogger;
+	std::string sentBeaconData;
+	EXPECT_CALL(*mockClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.Times(testing::Exactly(1))
+		.WillOnce(testing::Invoke([logger, &sentBeaconData](const core::UTF8String&, const core::UTF8String& beaconData)
+		{
+			sentBeaconData = beaconData.getStringData();
+			return new protocol::StatusResponse(logger, "", 200, protocol::Response::ResponseHeaders());
+		}));
+
+	// when
+	target->replayStoredChunks();
+
+	// then
+	ASSERT_EQ(sentBeaconData, "vv=3&tx=0" + beaconData);
+	ASSERT_TRUE(target->getChunkStore()->isEmpty());
+}
+
+TEST_F(BeaconSendingContextTest, replayStoredChunksSendsTransmissionTimeOfReplay)
+{
+	// given
+	int64_t now = 1000;
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Invoke([&now]() { return now; }));
+
+	auto configuration = createStoreAndForwardConfiguration(0);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	std::string beaconData = "&et=1&na=action";
+	std::vector<unsigned char> compressedData;
+	base::util::Compressor::compressMemory(beaconData.c_str(), beaconData.size(), compressedData);
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String("vv=3"), protocol::BeaconPayload(core::UTF8String(beaconData), std::move(compressedData)), now);
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String("vv=3"), protocol::BeaconPayload(core::UTF8String(beaconData)), now);
+
+	auto mockClient = std::make_shared<testing::StrictMock<test::MockHTTPClient>>(configuration->getHTTPClientConfiguration());
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockClient));
+
+	// expect
+	auto logger = mLogger;
+	std::vector<std::string> sentChunks;
+	EXPECT_CALL(*mockClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.Times(testing::Exactly(2))
+		.WillRepeatedly(testing::Invoke([logger, &sentChunks](const core::UTF8String&, const core::UTF8String& beaconData)
+		{
+			sentChunks.push_back(beaconData.getStringData());
+			return new protocol::StatusResponse(logger, "", 200, protocol::Response::ResponseHeaders());
+		}));
+
+	// when replaying the chunks later on
+	now = 61000;
+	target->replayStoredChunks();
+
+	// then
+	ASSERT_EQ(sentChunks, std::vector<std::string>({ "vv=3&tx=61000" + beaconData, "vv=3&tx=61000" + beaconData }));
+}
+
+TEST_F(BeaconSendingContextTest, replayStoredChunksKeepsChunkIfSendingFailed)
+{
+	// given
+	auto configuration = createStoreAndForwardConfiguration(0);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("first")), 0);
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("second")), 0);
+
+	auto mockClient = std::make_shared<testing::StrictMock<test::MockHTTPClient>>(configuration->getHTTPClientConfiguration());
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockClient));
+
+	// expect
+	auto logger = mLogger;
+	EXPECT_CALL(*mockClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.Times(testing::Exactly(1))
+		.WillOnce(testing::InvokeWithoutArgs([logger]() { return new protocol::StatusResponse(logger, "", 429, protocol::Response::ResponseHeaders()); }));
+
+	// when
+	auto obtained = target->replayStoredChunks();
+
+	// then
+	ASSERT_NE(obtained, nullptr);
+	ASSERT_EQ(obtained->getResponseCode(), 429);
+	ASSERT_EQ(target->getChunkStore()->getNumChunks(), size_t(2));
+}
+
+TEST_F(BeaconSendingContextTest, replayStoredChunksIsPacedByReplayRate)
+{
+	// given
+	auto configuration = createStoreAndForwardConfiguration(10);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("0123456789")), 0);
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("abcdefghij")), 0);
+
+	auto mockClient = std::make_shared<testing::NiceMock<test::MockHTTPClient>>(configuration->getHTTPClientConfiguration());
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockClient));
+	auto logger = mLogger;
+	ON_CALL(*mockClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.WillByDefault(testing::InvokeWithoutArgs([logger]() { return new protocol::StatusResponse(logger, "", 200, protocol::Response::ResponseHeaders()); }));
+
+	int64_t now = 1000;
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Invoke([&now]() { return now; }));
+
+	// when sending at 10 bytes per second
+	target->replayStoredChunks();
+
+	// then the second chunk is deferred by one second
+	ASSERT_EQ(target->getChunkStore()->getNumChunks(), size_t(1));
+
+	// and when replaying before the second elapsed
+	now = 1999;
+	target->replayStoredChunks();
+
+	// then
+	ASSERT_EQ(target->getChunkStore()->getNumChunks(), size_t(1));
+
+	// and when replaying after the second elapsed
+	now = 2000;
+	target->replayStoredChunks();
+
+	// then
+	ASSERT_TRUE(target->getChunkStore()->isEmpty());
+}
+
+TEST_F(BeaconSendingContextTest, replayStoredChunksDropsChunkRejectedByServer)
+{
+	// given
+	auto configuration = createStoreAndForwardConfiguration(0);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("first")), 0);
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("second")), 0);
+
+	auto mockClient = std::make_shared<testing::StrictMock<test::MockHTTPClient>>(configuration->getHTTPClientConfiguration());
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockClient));
+
+	// expect
+	auto logger = mLogger;
+	EXPECT_CALL(*mockClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.Times(testing::Exactly(2))
+		.WillOnce(testing::InvokeWithoutArgs([logger]() { return new protocol::StatusResponse(logger, "", 400, protocol::Response::ResponseHeaders()); }))
+		.WillOnce(testing::InvokeWithoutArgs([logger]() { return new protocol::StatusResponse(logger, "", 200, protocol::Response::ResponseHeaders()); }));
+
+	// when
+	auto obtained = target->replayStoredChunks();
+
+	// then
+	ASSERT_NE(obtained, nullptr);
+	ASSERT_EQ(obtained->getResponseCode(), 200);
+	ASSERT_TRUE(target->getChunkStore()->isEmpty());
+}
+
+TEST_F(BeaconSendingContextTest, wakeupDelayEndsWithNextReplayTime)
+{
+	// given
+	auto configuration = createStoreAndForwardConfiguration(10);
+	auto target = std::shared_ptr<BeaconSendingContext>(new BeaconSendingContext(mLogger, mMockHttpClientProvider, mMockTimingProvider, configuration));
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("0123456789")), 0);
+	target->getChunkStore()->store(core::UTF8String(), core::UTF8String(), protocol::BeaconPayload(core::UTF8String("abcdefghij")), 0);
+
+	auto mockClient = std::make_shared<testing::NiceMock<test::MockHTTPClient>>(configuration->getHTTPClientConfiguration());
+	ON_CALL(*mMockHttpClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockClient));
+	auto logger = mLogger;
+	ON_CALL(*mockClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.WillByDefault(testing::InvokeWithoutArgs([logger]() { return new protocol::StatusResponse(logger, "", 200, protocol::Response::ResponseHeaders()); }));
+	ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Return(1000));
+
+	// when sending at 10 bytes per second
+	target->replayStoredChunks();
+
+	// then the sending thread wakes up once the second chunk may be sent
+	ASSERT_EQ(target->getChunkStore()->getNumChunks(), size_t(1));
+	ASSERT_EQ(target->getWakeupDelay(), 1000);
+}
@@ -261,3 +261,132 @@ TEST_F(BeaconSendingFlushSessionsStateTest, aBeaconSendingFlushSessionStateStops
 	// when calling execute
 	target.execute(*mMockContext);
 }
+
+TEST_F(BeaconSendingFlushSessionsStateTest, aBeaconSendingFlushSessionStateSendsSessionsHoldingMostDataFirst)
+{
+	//given
+	auto target = communication::BeaconSendingFlushSessionsState();
+
+	ON_CALL(*mMockSession1Open, getNumBytesInCache())
+		.WillByDefault(testing::Return(10));
+	ON_CALL(*mMockSession2Open, getNumBytesInCache())
+		.WillByDefault(testing::Return(30));
+	ON_CALL(*mMockSession3Closed, getNumBytesInCache())
+		.WillByDefault(testing::Return(20));
+
+	// record raw pointers, a session capturing a shared pointer to itself would never be destroyed
+	std::vector<core::Session*> sentSessions;
+	for (auto session : { mMockSession1Open, mMockSession2Open, mMockSession3Closed })
+	{
+		core::Session* sentSession = session.get();
+		ON_CALL(*session, sendBeaconRawPtrProxy(testing::_))
+			.WillByDefault(testing::Invoke([&, sentSession](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse*
+			{
+				sentSessions.push_back(sentSession);
+				return new protocol::StatusResponse(mLogger, "", 200, protocol::Response::ResponseHeaders());
+			}));
+	}
+
+	// move open sessions to finished session by calling BeaconSendinContext::finishSessions
+	mMockContext->finishSession(mMockSession1Open);
+	mMockContext->finishSession(mMockSession2Open);
+
+	// when calling execute
+	target.execute(*mMockContext);
+
+	// then
+	ASSERT_EQ(sentSessions.size(), size_t(3));
+	ASSERT_EQ(sentSessions[0], mMockSession2Open.get());
+	ASSERT_EQ(sentSessions[1], mMockSession3Closed.get());
+	ASSERT_EQ(sentSessions[2], mMockSession1Open.get());
+}
+
+TEST_F(BeaconSendingFlushSessionsStateTest, aBeaconSendingFlushSessionStateReportsSentAndDiscardedData)
+{
+	//given
+	auto target = communication::BeaconSendingFlushSessionsState();
+
+	// the third session's request fails, thus it keeps its data
+	int64_t numBytes1 = 10;
+	int64_t numBytes2 = 30;
+	int64_t numBytes3 = 20;
+	ON_CALL(*mMockSession1Open, getNumBytesInCache())
+		.WillByDefault(testing::Invoke([&]() { return numBytes1; }));
+	ON_CALL(*mMockSession2Open, getNumBytesInCache())
+		.WillByDefault(testing::Invoke([&]() { return numBytes2; }));
+	ON_CALL(*mMockSession3Closed, getNumBytesInCache())
+		.WillByDefault(testing::Invoke([&]() { return numBytes3; }));
+	ON_CALL(*mMockSession1Open, sendBeaconRawPtrProxy(testing::_))
+		.WillByDefault(testing::Invoke([&](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse* { numBytes1 = 0; return new protocol::StatusResponse(mLogger, "", 200, protocol::Response::ResponseHeaders()); }));
+	ON_CALL(*mMockSession2Open, sendBeaconRawPtrProxy(testing::_))
+		.WillByDefault(testing::Invoke([&](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse* { numBytes2 = 0; return new protocol::StatusResponse(mLogger, "", 200, protocol::Response::ResponseHeaders()); }));
+	ON_CALL(*mMockSession3Closed, sendBeaconRawPtrProxy(testing::_))
+		.WillByDefault(testing::Invoke([&](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse* { return new protocol::StatusResponse(mLogger, "", 500, protocol::Response::ResponseHeaders()); }));
+
+	mMockContext->finishSession(mMockSession1Open);
+	mMockContext->finishSession(mMockSession2Open);
+
+	// when calling execute
+	target.execute(*mMockContext);
+
+	// then
+	auto obtained = mMockContext->getShutdownReport();
+	ASSERT_FALSE(obtained.isDeadlineExceeded);
+	ASSERT_EQ(obtained.numSessionsFlushed, 2);
+	ASSERT_EQ(obtained.numSessionsDropped, 1);
+	ASSERT_EQ(obtained.numBytesFlushed, int64_t(40));
+	ASSERT_EQ(obtained.numBytesDropped, int64_t(20));
+}
+
+TEST_F(BeaconSendingFlushSessionsStateTest, aBeaconSendingFlushSessionStateDiscardsRemainingSessionsOnceShutdownTimeoutExpired)
+{
+	//given
+	auto target = communication::BeaconSendingFlushSessionsState();
+
+	int64_t currentTimestamp = 1000;
+	ON_CALL(*mMockContext, getCurrentTimestamp())
+		.WillByDefault(testing::Invoke([&]() { return currentTimestamp; }));
+	mMockContext->requestShutdownWithTimeout(100);
+
+	// sending the session holding most data takes longer than the shutdown timeout
+	int64_t numBytes2 = 30;
+	ON_CALL(*mMockSession1Open, getNumBytesInCache())
+		.WillByDefault(testing::Return(10));
+	ON_CALL(*mMockSession2Open, getNumBytesInCache())
+		.WillByDefault(testing::Invoke([&]() { return numBytes2; }));
+	ON_CALL(*mMockSession3Closed, getNumBytesInCache())
+		.WillByDefault(testing::Return(20));
+	ON_CALL(*mMockSession2Open, sendBeaconRawPtrProxy(testing::_))
+		.WillByDefault(testing::Invoke([&](std::shared_ptr<providers::IHTTPClientProvider>) -> protocol::StatusResponse*
+		{
+			numBytes2 = 0;
+			currentTimestamp += 200;
+			return new protocol::StatusResponse(mLogger, "", 200, protocol::Response::ResponseHeaders());
+		}));
+
+	// verify that the remaining sessions are not sent, but their data is discarded
+	EXPECT_CALL(*mMockSession1Open, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mMockSession2Open, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockSession3Closed, sendBeaconRawPtrProxy(testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mMockSession1Open, clearCapturedData())
+		.Times(testing::Exactly(1));
+	EXPECT_CALL(*mMockSession3Closed, clearCapturedData())
+		.Times(testing::Exactly(1));
+
+	mMockContext->finishSession(mMockSession1Open);
+	mMockContext->finishSession(mMockSession2Open);
+
+	// when calling execute
+	target.execute(*mMockContext);
+
+	// then
+	auto obtained = mMockContext->getShutdownReport();
+	ASSERT_TRUE(obtained.isDeadlineExceeded);
+	ASSERT_EQ(obtained.numSessionsFlushed, 1);
+	ASSERT_EQ(obtained.numSessionsDropped, 2);
+	ASSERT_EQ(obtained.numBytesFlushed, int64_t(30));
+	ASSERT_EQ(obtained.numBytesDropped, int64_t(30));
+}
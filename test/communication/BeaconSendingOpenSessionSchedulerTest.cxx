@@ -0,0 +1,185 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "communication/BeaconSendingOpenSessionScheduler.h"
+#include "core/SessionWrapper.h"
+#include "core/util/DefaultLogger.h"
+
+#include "../core/MockSession.h"
+#include "../providers/MockPRNGenerator.h"
+
+#include <limits>
+
+using namespace communication;
+
+class BeaconSendingOpenSessionSchedulerTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_DEBUG);
+		mMockRandomGenerator = std::make_shared<testing::NiceMock<test::MockPRNGenerator>>();
+	}
+
+	std::vector<std::shared_ptr<core::SessionWrapper>> createSessions(size_t numSessions)
+	{
+		std::vector<std::shared_ptr<core::SessionWrapper>> sessions;
+		for (size_t i = 0; i < numSessions; i++)
+		{
+			auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+			ON_CALL(*mockSession, isEmpty())
+				.WillByDefault(testing::Return(false));
+			mMockSessions.push_back(mockSession);
+			sessions.push_back(std::make_shared<core::SessionWrapper>(mockSession));
+		}
+		return sessions;
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> mLogger;
+	std::shared_ptr<testing::NiceMock<test::MockPRNGenerator>> mMockRandomGenerator;
+	std::vector<std::shared_ptr<testing::NiceMock<test::MockSession>>> mMockSessions;
+};
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, emptySchedulerHasNoDeadline)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(false, mMockRandomGenerator);
+
+	// then
+	ASSERT_EQ(target.size(), size_t(0));
+	ASSERT_EQ(target.getNextDeadline(), std::numeric_limits<int64_t>::max());
+	ASSERT_TRUE(target.pollDueSessions(std::numeric_limits<int64_t>::max()).empty());
+}
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, cohortIsSpreadEvenlyAcrossTheSendInterval)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(false, mMockRandomGenerator);
+	auto sessions = createSessions(4);
+
+	// when
+	target.scheduleCohort(sessions, 1000, 1000);
+
+	// then
+	ASSERT_EQ(target.size(), size_t(4));
+	ASSERT_EQ(target.pollDueSessions(1000), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[0] }));
+	ASSERT_EQ(target.pollDueSessions(1249), std::vector<std::shared_ptr<core::SessionWrapper>>());
+	ASSERT_EQ(target.pollDueSessions(1500), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[1], sessions[2] }));
+	ASSERT_EQ(target.getNextDeadline(), 1750);
+	ASSERT_EQ(target.pollDueSessions(1999), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[3] }));
+	ASSERT_EQ(target.size(), size_t(0));
+}
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, emptySessionsAreNotScheduled)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(false, mMockRandomGenerator);
+	auto sessions = createSessions(3);
+	ON_CALL(*mMockSessions[1], isEmpty())
+		.WillByDefault(testing::Return(true));
+
+	// when
+	target.scheduleCohort(sessions, 0, 1000);
+
+	// then
+	ASSERT_EQ(target.size(), size_t(2));
+	ASSERT_EQ(target.pollDueSessions(999), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[0], sessions[2] }));
+}
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, jitterIsAppliedWithinTheSlotOfEachSession)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(true, mMockRandomGenerator);
+	auto sessions = createSessions(2);
+
+	// expect
+	EXPECT_CALL(*mMockRandomGenerator, nextInt64(int64_t(500)))
+		.Times(testing::Exactly(2))
+		.WillRepeatedly(testing::Return(499));
+
+	// when
+	target.scheduleCohort(sessions, 0, 1000);
+
+	// then
+	ASSERT_EQ(target.getNextDeadline(), 499);
+	ASSERT_EQ(target.pollDueSessions(499), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[0] }));
+	ASSERT_EQ(target.getNextDeadline(), 999);
+}
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, pendingSessionsOfPreviousCohortAreScheduledFirst)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(false, mMockRandomGenerator);
+	auto sessions = createSessions(4);
+	target.scheduleCohort(sessions, 0, 1000);
+	target.pollDueSessions(500); // sessions 0, 1 and 2 were sent
+
+	// when
+	target.scheduleCohort(sessions, 1001, 1000);
+
+	// then
+	ASSERT_EQ(target.size(), size_t(4));
+	ASSERT_EQ(target.pollDueSessions(1001), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[3] }));
+	ASSERT_EQ(target.pollDueSessions(2000), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[0], sessions[1], sessions[2] }));
+}
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, pendingSessionsWhichAreNoLongerOpenAreDropped)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(false, mMockRandomGenerator);
+	auto sessions = createSessions(2);
+	target.scheduleCohort(sessions, 0, 1000);
+
+	// when
+	target.scheduleCohort({ sessions[1] }, 1001, 1000);
+
+	// then
+	ASSERT_EQ(target.pollDueSessions(2000), std::vector<std::shared_ptr<core::SessionWrapper>>({ sessions[1] }));
+}
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, postponedSessionIsDueAtItsNewDeadline)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(false, mMockRandomGenerator);
+	auto sessions = createSessions(1);
+
+	// when
+	target.postpone(sessions[0], 42);
+
+	// then
+	ASSERT_EQ(target.getNextDeadline(), 42);
+	ASSERT_TRUE(target.pollDueSessions(41).empty());
+	ASSERT_EQ(target.pollDueSessions(42), sessions);
+}
+
+TEST_F(BeaconSendingOpenSessionSchedulerTest, clearRemovesAllScheduledSessions)
+{
+	// given
+	BeaconSendingOpenSessionScheduler target(false, mMockRandomGenerator);
+	target.scheduleCohort(createSessions(3), 0, 1000);
+
+	// when
+	target.clear();
+
+	// then
+	ASSERT_EQ(target.size(), size_t(0));
+	ASSERT_EQ(target.getNextDeadline(), std::numeric_limits<int64_t>::max());
+}
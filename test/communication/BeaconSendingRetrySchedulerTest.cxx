@@ -0,0 +1,206 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "communication/BeaconSendingRetryScheduler.h"
+#include "configuration/RetryPolicy.h"
+#include "core/SessionWrapper.h"
+#include "core/util/DefaultLogger.h"
+
+#include "../core/MockSession.h"
+#include "../providers/MockPRNGenerator.h"
+
+#include <limits>
+
+using namespace communication;
+
+class BeaconSendingRetrySchedulerTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_DEBUG);
+		mMockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+		mSessionWrapper = std::make_shared<core::SessionWrapper>(mMockSession);
+
+		mMockRandomGenerator = std::make_shared<testing::NiceMock<test::MockPRNGenerator>>();
+		// return the upper bound (exclusive) minus one -> maximum delay
+		ON_CALL(*mMockRandomGenerator, nextInt64(testing::_))
+			.WillByDefault(testing::Invoke([](int64_t upperBound) { return upperBound - 1; }));
+	}
+
+	std::shared_ptr<BeaconSendingRetryScheduler> createScheduler(int32_t maxRetryAttempts, int64_t initialRetryDelay, int64_t maxRetryDelay)
+	{
+		auto retryPolicy = std::make_shared<configuration::RetryPolicy>(1000, 1000, maxRetryAttempts, initialRetryDelay, maxRetryDelay);
+		return std::make_shared<BeaconSendingRetryScheduler>(retryPolicy, mMockRandomGenerator);
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> mLogger;
+	std::shared_ptr<testing::NiceMock<test::MockSession>> mMockSession;
+	std::shared_ptr<core::SessionWrapper> mSessionWrapper;
+	std::shared_ptr<testing::NiceMock<test::MockPRNGenerator>> mMockRandomGenerator;
+};
+
+TEST_F(BeaconSendingRetrySchedulerTest, sendIsDueForSessionWithoutFailedAttempts)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+
+	// then
+	ASSERT_TRUE(target->isSendDue(mSessionWrapper, 0));
+	ASSERT_EQ(mSessionWrapper->getNumFailedSendAttempts(), uint32_t(0));
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, scheduleRetryDefersSessionUntilDelayExpired)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+
+	// when
+	auto obtained = target->scheduleRetry(mSessionWrapper, 5000);
+
+	// then
+	ASSERT_TRUE(obtained);
+	ASSERT_EQ(mSessionWrapper->getNumFailedSendAttempts(), uint32_t(1));
+	ASSERT_EQ(mSessionWrapper->getNextSendAttemptTime(), 6000);
+	ASSERT_FALSE(target->isSendDue(mSessionWrapper, 5999));
+	ASSERT_TRUE(target->isSendDue(mSessionWrapper, 6000));
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, retryIsOnlyDueForSessionWithFailedAttempt)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+
+	// then
+	ASSERT_FALSE(target->isRetryDue(mSessionWrapper, 5000));
+
+	// and when
+	target->scheduleRetry(mSessionWrapper, 5000);
+
+	// then
+	ASSERT_FALSE(target->isRetryDue(mSessionWrapper, 5999));
+	ASSERT_TRUE(target->isRetryDue(mSessionWrapper, 6000));
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, retryDelayIsDoubledForEachFailedAttempt)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+
+	// then
+	ASSERT_EQ(target->getRetryDelay(1), 1000);
+	ASSERT_EQ(target->getRetryDelay(2), 2000);
+	ASSERT_EQ(target->getRetryDelay(3), 4000);
+	ASSERT_EQ(target->getRetryDelay(4), 8000);
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, retryDelayIsCappedAtMaxRetryDelay)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 5000);
+
+	// then
+	ASSERT_EQ(target->getRetryDelay(3), 4000);
+	ASSERT_EQ(target->getRetryDelay(4), 5000);
+	ASSERT_EQ(target->getRetryDelay(100), 5000);
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, retryDelayIsJitteredWithinUpperHalf)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+	ON_CALL(*mMockRandomGenerator, nextInt64(testing::_))
+		.WillByDefault(testing::Return(0));
+
+	// expect
+	EXPECT_CALL(*mMockRandomGenerator, nextInt64(int64_t(2001)))
+		.Times(testing::Exactly(1));
+
+	// when
+	auto obtained = target->getRetryDelay(3);
+
+	// then
+	ASSERT_EQ(obtained, 2000);
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, scheduleRetryFailsIfMaxRetryAttemptsAreExhausted)
+{
+	// given
+	auto target = createScheduler(2, 1000, 60000);
+
+	// then
+	ASSERT_TRUE(target->scheduleRetry(mSessionWrapper, 0));
+	ASSERT_TRUE(target->scheduleRetry(mSessionWrapper, 0));
+	ASSERT_FALSE(target->scheduleRetry(mSessionWrapper, 0));
+	ASSERT_EQ(mSessionWrapper->getNumFailedSendAttempts(), uint32_t(2));
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, resetRetryMakesSessionDueImmediately)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+	target->scheduleRetry(mSessionWrapper, 5000);
+
+	// when
+	target->resetRetry(mSessionWrapper);
+
+	// then
+	ASSERT_EQ(mSessionWrapper->getNumFailedSendAttempts(), uint32_t(0));
+	ASSERT_TRUE(target->isSendDue(mSessionWrapper, 5000));
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, nextRetryTimeIsMaximumIfNoRetryIsScheduled)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+
+	// then
+	ASSERT_EQ(target->getNextRetryTime(0), std::numeric_limits<int64_t>::max());
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, nextRetryTimeIsEarliestScheduledRetry)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+	auto otherSessionWrapper = std::make_shared<core::SessionWrapper>(std::make_shared<testing::NiceMock<test::MockSession>>(mLogger));
+
+	// when
+	target->scheduleRetry(mSessionWrapper, 5000);
+	target->scheduleRetry(otherSessionWrapper, 3000);
+
+	// then
+	ASSERT_EQ(target->getNextRetryTime(3000), 4000);
+}
+
+TEST_F(BeaconSendingRetrySchedulerTest, nextRetryTimeSkipsResetAndDueRetries)
+{
+	// given
+	auto target = createScheduler(-1, 1000, 60000);
+	auto otherSessionWrapper = std::make_shared<core::SessionWrapper>(std::make_shared<testing::NiceMock<test::MockSession>>(mLogger));
+	target->scheduleRetry(mSessionWrapper, 3000);
+	target->scheduleRetry(otherSessionWrapper, 5000);
+
+	// when
+	target->resetRetry(otherSessionWrapper);
+
+	// then
+	ASSERT_EQ(target->getNextRetryTime(3000), 4000);
+	ASSERT_EQ(target->getNextRetryTime(4000), std::numeric_limits<int64_t>::max());
+}
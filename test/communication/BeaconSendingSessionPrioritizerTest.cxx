@@ -0,0 +1,224 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "communication/BeaconSendingSessionPrioritizer.h"
+#include "caching/BeaconCache.h"
+#include "core/SessionWrapper.h"
+#include "core/util/DefaultLogger.h"
+
+#include "../core/MockSession.h"
+
+#include <unordered_map>
+
+using namespace communication;
+
+class BeaconSendingSessionPrioritizerTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_DEBUG);
+	}
+
+	std::shared_ptr<core::SessionWrapper> createSession(int64_t oldestRecordTimestamp, int64_t numBytes)
+	{
+		auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+		ON_CALL(*mockSession, getOldestRecordTimestamp())
+			.WillByDefault(testing::Return(oldestRecordTimestamp));
+		ON_CALL(*mockSession, getNumBytesInCache())
+			.WillByDefault(testing::Return(numBytes));
+		return std::make_shared<core::SessionWrapper>(mockSession);
+	}
+
+	std::shared_ptr<core::SessionWrapper> createCachedSession(std::shared_ptr<caching::BeaconCache> beaconCache, int32_t beaconID)
+	{
+		auto mockSession = std::make_shared<testing::NiceMock<test::MockSession>>(mLogger);
+		ON_CALL(*mockSession, getOldestRecordTimestamp())
+			.WillByDefault(testing::Invoke([beaconCache, beaconID]() { return beaconCache->getOldestRecordTimestamp(beaconID); }));
+		ON_CALL(*mockSession, getNumBytesInCache())
+			.WillByDefault(testing::Invoke([beaconCache, beaconID]() { return beaconCache->getNumBytes(beaconID); }));
+		return std::make_shared<core::SessionWrapper>(mockSession);
+	}
+
+	///
+	/// Simulates sessions which keep on adding data while only a limited number of them can be sent per send pass.
+	/// Records exceeding the maximum age are evicted after each pass.
+	/// @returns the number of evicted bytes
+	///
+	int64_t simulateDataLoss(openkit::SendPriorityPolicy policy)
+	{
+		const int32_t numSessions = 20;
+		const size_t sessionsPerPass = 3;
+		const int64_t passInterval = 1000;
+		const int64_t maxRecordAge = 10 * passInterval;
+
+		auto beaconCache = std::make_shared<caching::BeaconCache>(mLogger);
+		BeaconSendingSessionPrioritizer target(policy, maxRecordAge, 100 * 1024);
+
+		std::vector<std::shared_ptr<core::SessionWrapper>> sessions;
+		std::unordered_map<core::SessionWrapper*, int32_t> beaconIDs;
+		for (int32_t beaconID = 0; beaconID < numSessions; beaconID++)
+		{
+			auto session = createCachedSession(beaconCache, beaconID);
+			sessions.push_back(session);
+			beaconIDs[session.get()] = beaconID;
+		}
+
+		int64_t numEvictedBytes = 0;
+		for (int64_t timestamp = 0; timestamp < 100 * passInterval; timestamp += passInterval)
+		{
+			// every session adds a record, later sessions add more data
+			for (int32_t beaconID = 0; beaconID < numSessions; beaconID++)
+			{
+				beaconCache->addEventData(beaconID, timestamp, core::UTF8String(std::string(10 + beaconID, 'x')));
+			}
+
+			// send as many sessions as the budget allows, sending removes all of their data
+			auto sessionsToSend = sessions;
+			target.prioritize(sessionsToSend, timestamp);
+			for (size_t i = 0; i < sessionsPerPass; i++)
+			{
+				beaconCache->evictRecordsByAge(beaconIDs[sessionsToSend[i].get()], timestamp + 1);
+			}
+
+			// evict data which became too old
+			for (int32_t beaconID = 0; beaconID < numSessions; beaconID++)
+			{
+				auto numBytesBefore = beaconCache->getNumBytes(beaconID);
+				beaconCache->evictRecordsByAge(beaconID, timestamp - maxRecordAge);
+				numEvictedBytes += numBytesBefore - beaconCache->getNumBytes(beaconID);
+			}
+		}
+
+		return numEvictedBytes;
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> mLogger;
+};
+
+TEST_F(BeaconSendingSessionPrioritizerTest, insertionOrderKeepsSessionOrder)
+{
+	// given
+	BeaconSendingSessionPrioritizer target(openkit::SendPriorityPolicy::INSERTION_ORDER, 1000, 1000);
+	auto session1 = createSession(900, 10);
+	auto session2 = createSession(100, 500);
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessions = { session1, session2 };
+
+	// when
+	target.prioritize(sessions, 1000);
+
+	// then
+	ASSERT_EQ(sessions[0], session1);
+	ASSERT_EQ(sessions[1], session2);
+}
+
+TEST_F(BeaconSendingSessionPrioritizerTest, evictionRiskSendsSessionWithOldestDataFirst)
+{
+	// given
+	BeaconSendingSessionPrioritizer target(openkit::SendPriorityPolicy::EVICTION_RISK, 1000, 1000);
+	auto session1 = createSession(900, 10);
+	auto session2 = createSession(100, 10);
+	auto session3 = createSession(500, 10);
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessions = { session1, session2, session3 };
+
+	// when
+	target.prioritize(sessions, 1000);
+
+	// then
+	ASSERT_EQ(sessions[0], session2);
+	ASSERT_EQ(sessions[1], session3);
+	ASSERT_EQ(sessions[2], session1);
+}
+
+TEST_F(BeaconSendingSessionPrioritizerTest, evictionRiskSendsSessionWithMoreDataFirstIfEquallyOld)
+{
+	// given
+	BeaconSendingSessionPrioritizer target(openkit::SendPriorityPolicy::EVICTION_RISK, 1000, 1000);
+	auto session1 = createSession(500, 10);
+	auto session2 = createSession(500, 200);
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessions = { session1, session2 };
+
+	// when
+	target.prioritize(sessions, 1000);
+
+	// then
+	ASSERT_EQ(sessions[0], session2);
+	ASSERT_EQ(sessions[1], session1);
+}
+
+TEST_F(BeaconSendingSessionPrioritizerTest, equallyRatedSessionsKeepTheirOrder)
+{
+	// given
+	BeaconSendingSessionPrioritizer target(openkit::SendPriorityPolicy::EVICTION_RISK, 1000, 1000);
+	auto session1 = createSession(-1, 0);
+	auto session2 = createSession(-1, 0);
+	auto session3 = createSession(-1, 0);
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessions = { session1, session2, session3 };
+
+	// when
+	target.prioritize(sessions, 1000);
+
+	// then
+	ASSERT_EQ(sessions[0], session1);
+	ASSERT_EQ(sessions[1], session2);
+	ASSERT_EQ(sessions[2], session3);
+}
+
+TEST_F(BeaconSendingSessionPrioritizerTest, prioritizeByCachedDataSendsSessionWithMostDataFirstRegardlessOfPolicy)
+{
+	// given
+	BeaconSendingSessionPrioritizer target(openkit::SendPriorityPolicy::INSERTION_ORDER, 1000, 1000);
+	auto session1 = createSession(100, 10);
+	auto session2 = createSession(900, 500);
+	auto session3 = createSession(500, 10);
+	std::vector<std::shared_ptr<core::SessionWrapper>> sessions = { session1, session2, session3 };
+
+	// when
+	target.prioritizeByCachedData(sessions);
+
+	// then
+	ASSERT_EQ(sessions[0], session2);
+	ASSERT_EQ(sessions[1], session1);
+	ASSERT_EQ(sessions[2], session3);
+}
+
+TEST_F(BeaconSendingSessionPrioritizerTest, evictionRiskAddsRelativeAgeAndRelativeSize)
+{
+	// given
+	BeaconSendingSessionPrioritizer target(openkit::SendPriorityPolicy::EVICTION_RISK, 1000, 2000);
+
+	// then
+	ASSERT_DOUBLE_EQ(target.getEvictionRisk(createSession(500, 1000), 1000), 1.0);
+	ASSERT_DOUBLE_EQ(target.getEvictionRisk(createSession(-1, 0), 1000), 0.0);
+	ASSERT_DOUBLE_EQ(target.getEvictionRisk(createSession(2000, 0), 1000), 0.0);
+}
+
+TEST_F(BeaconSendingSessionPrioritizerTest, evictionRiskPolicyLosesLessDataWithLimitedSendBudget)
+{
+	// when
+	auto insertionOrderLoss = simulateDataLoss(openkit::SendPriorityPolicy::INSERTION_ORDER);
+	auto evictionRiskLoss = simulateDataLoss(openkit::SendPriorityPolicy::EVICTION_RISK);
+	RecordProperty("insertionOrderEvictedBytes", static_cast<int>(insertionOrderLoss));
+	RecordProperty("evictionRiskEvictedBytes", static_cast<int>(evictionRiskLoss));
+
+	// then
+	ASSERT_GT(insertionOrderLoss, int64_t(0));
+	ASSERT_LT(evictionRiskLoss, insertionOrderLoss);
+}
@@ -47,15 +47,37 @@ namespace test
 	{
 	public:
 		MockBeaconSendingContext(std::shared_ptr<openkit::ILogger> logger)
+			: MockBeaconSendingContext(logger, std::shared_ptr<protocol::UploadRateLimiter>())
+		{
+		}
+
+		MockBeaconSendingContext(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<protocol::UploadRateLimiter> uploadRateLimiter)
+			: MockBeaconSendingContext(logger, createConfiguration(uploadRateLimiter))
+		{
+		}
+
+		MockBeaconSendingContext(std::shared_ptr<openkit::ILogger> logger, std::shared_ptr<configuration::Configuration> configuration)
 			: BeaconSendingContext(logger, 
 				std::make_shared<test::MockHTTPClientProvider>(),
 				std::make_shared<test::MockTimingProvider>(),
-				std::make_shared<configuration::Configuration>( std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")), configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1",  core::UTF8String(""),
-																std::make_shared<providers::DefaultSessionIDProvider>(),
-																std::make_shared<protocol::SSLStrictTrustManager>(),
-																std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1),
-																std::make_shared<configuration::BeaconConfiguration>()))
+				configuration)
+		{
+		}
+
+		static std::shared_ptr<configuration::Configuration> createConfiguration(std::shared_ptr<protocol::UploadRateLimiter> uploadRateLimiter, bool staggerOpenSessionSending = false, int64_t multiplicitySharingWindow = 0)
 		{
+			return std::make_shared<configuration::Configuration>( std::shared_ptr<configuration::Device>(new configuration::Device("", "", "")), configuration::OpenKitType::Type::DYNATRACE, core::UTF8String(""), core::UTF8String(""), core::UTF8String(""), 1, "1",  core::UTF8String(""),
+				std::make_shared<providers::DefaultSessionIDProvider>(),
+				std::make_shared<protocol::SSLStrictTrustManager>(),
+				std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1),
+				std::make_shared<configuration::BeaconConfiguration>(),
+				nullptr,
+				nullptr,
+				uploadRateLimiter,
+				configuration::Configuration::DEFAULT_BEACON_SENDING_CONCURRENCY,
+				staggerOpenSessionSending,
+				false,
+				multiplicitySharingWindow);
 		}
 
 		MOCK_METHOD0(requestShutdown, void());
@@ -69,6 +91,7 @@ namespace test
 		MOCK_CONST_METHOD0(getCurrentTimestamp, int64_t());
 		MOCK_METHOD0(sleep, void());
 		MOCK_METHOD1(sleep, void(int64_t));
+		MOCK_METHOD0(waitForWakeup, void());
 		MOCK_METHOD1(setLastOpenSessionBeaconSendTime, void(int64_t));
 		MOCK_CONST_METHOD0(getLastOpenSessionBeaconSendTime, int64_t());
 		MOCK_METHOD1(setLastStatusCheckTime, void(int64_t));
@@ -77,6 +100,7 @@ namespace test
 		MOCK_METHOD0(getAllOpenAndConfiguredSessions, std::vector<std::shared_ptr<core::SessionWrapper>>());
 		MOCK_METHOD0(getAllFinishedAndConfiguredSessions, std::vector<std::shared_ptr<core::SessionWrapper>>());
 		MOCK_METHOD0(disableCapture, void());
+		MOCK_METHOD0(disableCaptureAndStoreData, void());
 		MOCK_METHOD1(finishSession, void(std::shared_ptr<core::Session>));
 		MOCK_METHOD1(removeSession, bool(std::shared_ptr<core::SessionWrapper>));
 		MOCK_METHOD1(pushBackFinishedSession, void(std::shared_ptr<core::Session>));
@@ -18,6 +18,7 @@
 #include "gmock/gmock.h"
 
 #include "configuration/Configuration.h"
+#include "core/util/DefaultLogger.h"
 #include "providers/DefaultSessionIDProvider.h"
 #include "protocol/ssl/SSLStrictTrustManager.h"
 
@@ -75,6 +76,40 @@ TEST_F(ConfigurationTest, enableAndDisableCapturing)
 	ASSERT_FALSE(target->isCapture());
 }
 
+TEST_F(ConfigurationTest, capturingIsNotKnownToBeTurnedOffBeforeFirstStatusResponse)
+{
+	//given
+	auto target = getDefaultConfiguration();
+	ASSERT_TRUE(target != nullptr);
+
+	//then
+	ASSERT_FALSE(target->isCapture());
+	ASSERT_FALSE(target->isCaptureTurnedOff());
+
+	//when
+	target->disableCapture();
+	//then
+	ASSERT_TRUE(target->isCaptureTurnedOff());
+
+	//when
+	target->enableCapture();
+	//then
+	ASSERT_FALSE(target->isCaptureTurnedOff());
+}
+
+TEST_F(ConfigurationTest, capturingIsTurnedOffIfStatusResponseIsNull)
+{
+	//given
+	auto target = getDefaultConfiguration();
+	ASSERT_TRUE(target != nullptr);
+
+	//when
+	target->updateSettings(nullptr);
+
+	//then
+	ASSERT_TRUE(target->isCaptureTurnedOff());
+}
+
 TEST_F(ConfigurationTest, capturingIsDisabledIfStatusResponseIsNull)
 {
 	//given
@@ -129,6 +164,41 @@ TEST_F(ConfigurationTest, capturingIsDisabledFromStatusResponse)
 	ASSERT_FALSE(target->isCapture());
 }
 
+TEST_F(ConfigurationTest, settingsAreTakenFromStatusResponse)
+{
+	//given
+	std::ostringstream devNull;
+	auto logger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_DEBUG);
+	auto statusResponse = std::make_shared<protocol::StatusResponse>(logger, "cp=1&si=30&id=5&bl=10&er=0&cr=0", 200, protocol::Response::ResponseHeaders());
+	auto target = getDefaultConfiguration();
+
+	//when
+	target->updateSettings(statusResponse);
+
+	//then
+	ASSERT_TRUE(target->isCapture());
+	ASSERT_FALSE(target->isCaptureErrors());
+	ASSERT_FALSE(target->isCaptureCrashes());
+	ASSERT_EQ(target->getSendInterval(), int64_t(30000));
+	ASSERT_EQ(target->getMaxBeaconSize(), statusResponse->getMaxBeaconSize());
+	ASSERT_EQ(target->getHTTPClientConfiguration()->getServerID(), 5);
+}
+
+TEST_F(ConfigurationTest, disablingCaptureKeepsCaptureSettingsForErrorsAndCrashes)
+{
+	//given
+	auto target = getDefaultConfiguration();
+	target->enableCapture();
+
+	//when
+	target->disableCapture();
+
+	//then
+	ASSERT_FALSE(target->isCapture());
+	ASSERT_TRUE(target->isCaptureErrors());
+	ASSERT_TRUE(target->isCaptureCrashes());
+}
+
 TEST_F(ConfigurationTest, tenantURLisSetCorrectly)
 {
 	core::UTF8String host("localhost:9999");
@@ -707,4 +707,66 @@ TEST_F(ActionTest, reportErrorDoesNothingIfActionIsLeft)
 	//then
 	ASSERT_TRUE(mockBeacon->isEmpty());
 	ASSERT_EQ(testAction, obtained);
-}
\ No newline at end of file
+}
+
+TEST_F(ActionTest, reportEventDoesNothingIfCaptureIsOff)
+{
+	// given
+	auto testAction = std::make_shared<core::Action>(logger, mockBeacon, core::UTF8String("test action"));
+	configuration->disableCapture();
+
+	// expect
+	EXPECT_CALL(*mockBeacon, reportEvent(testing::_, testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mockBeacon, reportValueInt32(testing::_, testing::_, testing::_))
+		.Times(testing::Exactly(0));
+	EXPECT_CALL(*mockBeacon, reportError(testing::_, testing::_, testing::_, testing::_))
+		.Times(testing::Exactly(0));
+
+	// when
+	auto obtained = testAction->reportEvent("event");
+	testAction->reportValue("value", 42);
+	testAction->reportError("error", 42, "reason");
+
+	// then
+	ASSERT_EQ(obtained, testAction);
+}
+
+TEST_F(ActionTest, reportValuesWithValidValues)
+{
+	openkit::ReportedValue values[] = {
+		openkit::ReportedValue::event("eventName"),
+		openkit::ReportedValue::value("IntegerValue", 42)
+	};
+
+	//verify the following calls
+	EXPECT_CALL(*mockBeacon, reportValues(testing::_, values, size_t(2)))
+		.Times(testing::Exactly(1));
+
+	// create test environment
+	// create action without parent action
+	auto testAction = std::make_shared<core::Action>(logger, mockBeacon, core::UTF8String("test action"));
+
+	//when
+	auto returnedAction = testAction->reportValues(values, 2);
+
+	ASSERT_EQ(testAction, returnedAction);
+}
+
+TEST_F(ActionTest, reportValuesDoesNothingIfActionIsLeft)
+{
+	//given
+	auto testAction = std::make_shared<core::Action>(logger, mockBeacon, core::UTF8String("test action"));
+	testAction->leaveAction();
+	openkit::ReportedValue values[] = { openkit::ReportedValue::value("IntegerValue", 42) };
+
+	//verify the following calls
+	EXPECT_CALL(*mockBeacon, reportValues(testing::_, testing::_, testing::_))
+		.Times(testing::Exactly(0));
+
+	//when
+	auto obtained = testAction->reportValues(values, 1);
+
+	//then
+	ASSERT_EQ(testAction, obtained);
+}
@@ -18,6 +18,7 @@
 #define _TEST_CORE_MOCKSESSION_H
 
 #include "core/Session.h"
+#include "caching/BeaconChunkStore.h"
 #include "core/util/DefaultLogger.h"
 
 #include "gtest/gtest.h"
@@ -46,7 +47,11 @@ namespace test
 		MOCK_METHOD1(enterAction, std::shared_ptr<openkit::IRootAction>(const char*));
 		MOCK_METHOD0(end, void());
 		MOCK_METHOD1(sendBeaconRawPtrProxy, protocol::StatusResponse*(std::shared_ptr<providers::IHTTPClientProvider>));
+		MOCK_METHOD2(storeBeacon, bool(caching::BeaconChunkStore&, std::shared_ptr<providers::IHTTPClientProvider>));
 		MOCK_CONST_METHOD0(isEmpty, bool());
+		MOCK_CONST_METHOD0(isSendThresholdReached, bool());
+		MOCK_CONST_METHOD0(getNumBytesInCache, int64_t());
+		MOCK_CONST_METHOD0(getOldestRecordTimestamp, int64_t());
 		MOCK_METHOD0(clearCapturedData, void());
 		MOCK_CONST_METHOD0(getEndTime, int64_t());
 		MOCK_METHOD1(setBeaconConfiguration, void(std::shared_ptr<configuration::BeaconConfiguration>));
@@ -527,6 +527,25 @@ TEST_F(RootActionTest, leaveAction)
 	ASSERT_EQ(testAction->getEndSequenceNo(), 2);
 }
 
+TEST_F(RootActionTest, leaveActionTakesEndTimeAgainAfterLeavingChildActions)
+{
+	EXPECT_CALL(*mockBeacon, getCurrentTimestamp())
+		.WillOnce(testing::Return((int32_t)42))
+		.WillOnce(testing::Return((int32_t)43))
+		.WillOnce(testing::Return((int32_t)44))
+		.WillOnce(testing::Return((int32_t)45))
+		.WillOnce(testing::Return((int32_t)46));
+	auto testAction = std::make_shared<core::RootAction>(logger, mockBeacon, core::UTF8String("test action"), session);
+	auto childAction = testAction->enterAction("child action");
+
+	// when leaving the root action with an open child action
+	testAction->leaveAction();
+
+	// then the end time of the root action is taken after the child action was left
+	ASSERT_EQ(testAction->getStartTime(), (int64_t)42);
+	ASSERT_EQ(testAction->getEndTime(), (int64_t)46);
+}
+
 TEST_F(RootActionTest, leaveActionTwice)
 {
 	auto testAction = std::make_shared<core::RootAction>(logger, mockBeacon, core::UTF8String("test action"), session);
@@ -692,4 +711,89 @@ TEST_F(RootActionTest, reportErrorDoesNothingIfActionIsLeft)
 	//then
 	ASSERT_TRUE(mockBeacon->isEmpty());
 	ASSERT_EQ(testAction, obtained);
-}
\ No newline at end of file
+}
+
+TEST_F(RootActionTest, enterActionGivesNullActionLeadingBackToRootActionIfCaptureIsOff)
+{
+	// given
+	auto testRootAction = std::make_shared<core::RootAction>(logger, mockBeacon, core::UTF8String("test root action"), session);
+	configuration->disableCapture();
+
+	// when
+	auto childAction = testRootAction->enterAction("child action");
+
+	// then
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::NullAction>(childAction));
+	ASSERT_FALSE(testRootAction->hasOpenChildActions());
+	ASSERT_EQ(childAction->leaveAction(), testRootAction);
+
+	// and the null action is only created once per root action
+	ASSERT_EQ(childAction, testRootAction->enterAction("other child action"));
+}
+
+TEST_F(RootActionTest, nullChildActionDoesNotKeepRootActionAlive)
+{
+	// given
+	auto testRootAction = std::make_shared<core::RootAction>(logger, mockBeacon, core::UTF8String("test root action"), session);
+	configuration->disableCapture();
+	std::weak_ptr<core::RootAction> weakRootAction = testRootAction;
+	testRootAction->enterAction("child action");
+
+	// when
+	testRootAction = nullptr;
+
+	// then
+	ASSERT_TRUE(weakRootAction.expired());
+}
+
+TEST_F(RootActionTest, traceWebRequestGivesNullTracerIfCaptureIsOff)
+{
+	// given
+	auto testRootAction = std::make_shared<core::RootAction>(logger, mockBeacon, core::UTF8String("test root action"), session);
+	configuration->disableCapture();
+
+	// when
+	auto obtained = testRootAction->traceWebRequest("http://example.com/pages/");
+
+	// then
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::NullWebRequestTracer>(obtained));
+}
+
+TEST_F(RootActionTest, reportValuesWithValidValues)
+{
+	openkit::ReportedValue values[] = {
+		openkit::ReportedValue::event("eventName"),
+		openkit::ReportedValue::value("IntegerValue", 42)
+	};
+
+	//verify the following calls
+	EXPECT_CALL(*mockBeacon, reportValues(testing::_, values, size_t(2)))
+		.Times(testing::Exactly(1));
+
+	// create test environment
+	// create action without parent action
+	auto testAction = std::make_shared<core::RootAction>(logger, mockBeacon, core::UTF8String("test action"), session);
+
+	//when
+	auto returnedAction = testAction->reportValues(values, 2);
+
+	ASSERT_EQ(testAction, returnedAction);
+}
+
+TEST_F(RootActionTest, reportValuesDoesNothingIfActionIsLeft)
+{
+	//given
+	auto testAction = std::make_shared<core::RootAction>(logger, mockBeacon, core::UTF8String("test action"), session);
+	testAction->leaveAction();
+	openkit::ReportedValue values[] = { openkit::ReportedValue::value("IntegerValue", 42) };
+
+	//verify the following calls
+	EXPECT_CALL(*mockBeacon, reportValues(testing::_, testing::_, testing::_))
+		.Times(testing::Exactly(0));
+
+	//when
+	auto obtained = testAction->reportValues(values, 1);
+
+	//then
+	ASSERT_EQ(testAction, obtained);
+}
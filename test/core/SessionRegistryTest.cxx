@@ -0,0 +1,198 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "configuration/BeaconConfiguration.h"
+#include "core/SessionRegistry.h"
+#include "core/SessionWrapper.h"
+#include "core/util/DefaultLogger.h"
+
+#include "MockSession.h"
+
+using namespace core;
+
+class SessionRegistryTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<core::util::DefaultLogger>(devNull, openkit::LogLevel::LOG_LEVEL_DEBUG);
+	}
+
+	std::shared_ptr<SessionWrapper> createSessionWrapper()
+	{
+		return std::make_shared<SessionWrapper>(std::make_shared<testing::NiceMock<test::MockSession>>(mLogger));
+	}
+
+	std::ostringstream devNull;
+	std::shared_ptr<openkit::ILogger> mLogger;
+};
+
+TEST_F(SessionRegistryTest, addedSessionsAreNewSessions)
+{
+	// given
+	SessionRegistry target;
+	auto sessionOne = createSessionWrapper();
+	auto sessionTwo = createSessionWrapper();
+
+	// when
+	target.add(sessionOne);
+	target.add(sessionTwo);
+
+	// then
+	ASSERT_EQ(target.size(), size_t(2));
+	ASSERT_EQ(target.getNewSessions(), std::vector<std::shared_ptr<SessionWrapper>>({ sessionOne, sessionTwo }));
+	ASSERT_TRUE(target.getOpenSessions().empty());
+	ASSERT_TRUE(target.getFinishedSessions().empty());
+}
+
+TEST_F(SessionRegistryTest, addingASessionTwiceRegistersItOnce)
+{
+	// given
+	SessionRegistry target;
+	auto session = createSessionWrapper();
+
+	// when
+	target.add(session);
+	target.add(session);
+
+	// then
+	ASSERT_EQ(target.size(), size_t(1));
+}
+
+TEST_F(SessionRegistryTest, findReturnsWrapperOfSession)
+{
+	// given
+	SessionRegistry target;
+	auto sessionOne = createSessionWrapper();
+	auto sessionTwo = createSessionWrapper();
+	target.add(sessionOne);
+	target.add(sessionTwo);
+
+	// then
+	ASSERT_EQ(target.find(sessionOne->getWrappedSession()), sessionOne);
+	ASSERT_EQ(target.find(sessionTwo->getWrappedSession()), sessionTwo);
+	ASSERT_EQ(target.find(createSessionWrapper()->getWrappedSession()), nullptr);
+}
+
+TEST_F(SessionRegistryTest, configuredSessionsMoveToOpenSessionsInOrderOfRegistration)
+{
+	// given
+	SessionRegistry target;
+	auto sessionOne = createSessionWrapper();
+	auto sessionTwo = createSessionWrapper();
+	auto sessionThree = createSessionWrapper();
+	target.add(sessionOne);
+	target.add(sessionTwo);
+	target.add(sessionThree);
+
+	// when
+	sessionThree->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	sessionOne->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+
+	// then
+	ASSERT_EQ(target.getNewSessions(), std::vector<std::shared_ptr<SessionWrapper>>({ sessionTwo }));
+	ASSERT_EQ(target.getOpenSessions(), std::vector<std::shared_ptr<SessionWrapper>>({ sessionOne, sessionThree }));
+	ASSERT_TRUE(target.getFinishedSessions().empty());
+}
+
+TEST_F(SessionRegistryTest, finishingAnOpenSessionMovesItToFinishedSessions)
+{
+	// given
+	SessionRegistry target;
+	auto session = createSessionWrapper();
+	target.add(session);
+	session->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	ASSERT_EQ(target.getOpenSessions().size(), size_t(1));
+
+	// when
+	auto obtained = target.finish(session->getWrappedSession());
+
+	// then
+	ASSERT_EQ(obtained, session);
+	ASSERT_TRUE(session->isSessionFinished());
+	ASSERT_TRUE(target.getOpenSessions().empty());
+	ASSERT_EQ(target.getFinishedSessions(), std::vector<std::shared_ptr<SessionWrapper>>({ session }));
+}
+
+TEST_F(SessionRegistryTest, finishedNewSessionMovesToFinishedSessionsOnceConfigured)
+{
+	// given
+	SessionRegistry target;
+	auto session = createSessionWrapper();
+	target.add(session);
+
+	// when
+	target.finish(session->getWrappedSession());
+
+	// then
+	ASSERT_EQ(target.getNewSessions().size(), size_t(1));
+	ASSERT_TRUE(target.getFinishedSessions().empty());
+
+	// when
+	session->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+
+	// then
+	ASSERT_TRUE(target.getNewSessions().empty());
+	ASSERT_TRUE(target.getOpenSessions().empty());
+	ASSERT_EQ(target.getFinishedSessions(), std::vector<std::shared_ptr<SessionWrapper>>({ session }));
+}
+
+TEST_F(SessionRegistryTest, finishingAnUnknownSessionReturnsNull)
+{
+	// given
+	SessionRegistry target;
+
+	// then
+	ASSERT_EQ(target.finish(createSessionWrapper()->getWrappedSession()), nullptr);
+}
+
+TEST_F(SessionRegistryTest, removeDeletesSessionFromItsBucketAndIndex)
+{
+	// given
+	SessionRegistry target;
+	auto sessionOne = createSessionWrapper();
+	auto sessionTwo = createSessionWrapper();
+	target.add(sessionOne);
+	target.add(sessionTwo);
+	sessionOne->updateBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>());
+	target.finish(sessionOne->getWrappedSession());
+	ASSERT_EQ(target.getFinishedSessions().size(), size_t(1));
+
+	// when
+	auto obtained = target.remove(sessionOne);
+
+	// then
+	ASSERT_TRUE(obtained);
+	ASSERT_EQ(target.size(), size_t(1));
+	ASSERT_EQ(target.find(sessionOne->getWrappedSession()), nullptr);
+	ASSERT_TRUE(target.getFinishedSessions().empty());
+	ASSERT_EQ(target.getAllSessions(), std::vector<std::shared_ptr<SessionWrapper>>({ sessionTwo }));
+}
+
+TEST_F(SessionRegistryTest, removingAnUnknownSessionReturnsFalse)
+{
+	// given
+	SessionRegistry target;
+	target.add(createSessionWrapper());
+
+	// then
+	ASSERT_FALSE(target.remove(createSessionWrapper()));
+	ASSERT_EQ(target.size(), size_t(1));
+}
@@ -446,8 +446,9 @@ TEST_F(SessionTest, endSessionWithOpenRootActions)
 		.Times(testing::Exactly(4));
 	EXPECT_CALL(*mockBeaconSender, startSession(testing::_))
 		.Times(testing::Exactly(1));
+	// root actions without child actions take their end time only once
 	EXPECT_CALL(*mockBeaconStrict, getCurrentTimestamp())
-		.Times(testing::Exactly(7));
+		.Times(testing::Exactly(5));
 	EXPECT_CALL(*mockBeaconStrict, startSession())
 		.Times(testing::Exactly(1));
 	EXPECT_CALL(*mockBeaconStrict, endSession(testing::_))
@@ -697,3 +698,117 @@ TEST_F(SessionTest, traceWebRequestGivesNullTracerIfSessionIsEnded)
 	ASSERT_NE(nullptr, obtained);
 	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::NullWebRequestTracer>(obtained));
 }
+
+TEST_F(SessionTest, actionsAndTracersOfASessionReuseTheSessionsArena)
+{
+	// given
+	auto target = std::make_shared<core::Session>(logger, mockBeaconSender, mockBeaconNice);
+
+	size_t numChunks = 0;
+
+	// when
+	for (int32_t i = 0; i < 1000; i++)
+	{
+		auto rootAction = target->enterAction("root action");
+		auto childAction = rootAction->enterAction("child action");
+		childAction->traceWebRequest("http://example.com/pages/")->stop(200);
+		childAction->leaveAction();
+		rootAction->leaveAction();
+		if (i == 0)
+		{
+			numChunks = target->getObjectArena()->getNumChunks();
+		}
+	}
+
+	// then (no further chunks are taken once the first objects were released)
+	ASSERT_GT(numChunks, size_t(0));
+	ASSERT_EQ(target->getObjectArena()->getNumChunks(), numChunks);
+}
+
+TEST_F(SessionTest, nullObjectsAreSharedBetweenSessions)
+{
+	// given
+	auto target = std::make_shared<core::Session>(logger, mockBeaconSender, mockBeaconNice);
+	auto other = std::make_shared<core::Session>(logger, mockBeaconSender, mockBeaconNice);
+
+	// when
+	auto obtained = target->enterAction("");
+	auto otherObtained = other->enterAction("");
+
+	// then
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::NullRootAction>(obtained));
+	ASSERT_EQ(obtained, otherObtained);
+}
+
+TEST_F(SessionTest, enterActionReturnsNullRootActionWithoutTouchingBeaconIfCaptureIsOff)
+{
+	// given
+	configuration->disableCapture();
+	auto target = std::make_shared<core::Session>(logger, mockBeaconSender, mockBeaconStrict);
+
+	// when
+	auto obtained = target->enterAction("root action");
+
+	// then
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::NullRootAction>(obtained));
+}
+
+TEST_F(SessionTest, enterActionReturnsRootActionBeforeCaptureIsKnown)
+{
+	// given a configuration which did not yet handle a status response
+	std::shared_ptr<configuration::Device> device = std::shared_ptr<configuration::Device>(new configuration::Device(core::UTF8String(""), core::UTF8String(""), core::UTF8String("")));
+	auto startupConfiguration = std::shared_ptr<configuration::Configuration>(new configuration::Configuration(device, configuration::OpenKitType::Type::DYNATRACE,
+		core::UTF8String(APP_NAME), "", APP_ID, 0, "0", "",
+		sessionIDProvider, trustManager, beaconCacheConfiguration, beaconConfiguration));
+	auto startupBeacon = std::make_shared<testing::NiceMock<test::MockBeacon>>(logger, beaconCache, startupConfiguration, nullptr, threadIDProvider, timingProvider);
+	auto target = std::make_shared<core::Session>(logger, mockBeaconSender, startupBeacon);
+
+	// when
+	auto obtained = target->enterAction("root action");
+
+	// then
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::RootAction>(obtained));
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::WebRequestTracer>(target->traceWebRequest("http://example.com/pages/")));
+}
+
+TEST_F(SessionTest, enterActionReturnsRootActionAgainOnceCaptureIsTurnedOn)
+{
+	// given
+	configuration->disableCapture();
+	auto target = std::make_shared<core::Session>(logger, mockBeaconSender, mockBeaconNice);
+	target->enterAction("root action");
+
+	// when
+	configuration->enableCapture();
+	auto obtained = target->enterAction("root action");
+
+	// then
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::RootAction>(obtained));
+}
+
+TEST_F(SessionTest, traceWebRequestReturnsNullTracerIfDataCollectionIsOff)
+{
+	// given
+	auto target = std::make_shared<core::Session>(logger, mockBeaconSender, mockBeaconNice);
+	target->setBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(1, openkit::DataCollectionLevel::OFF, openkit::CrashReportingLevel::OFF));
+
+	// when
+	auto obtained = target->traceWebRequest("http://example.com/pages/");
+
+	// then
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::NullWebRequestTracer>(obtained));
+}
+
+TEST_F(SessionTest, identifyUserDoesNotReportToBeaconIfCaptureIsOff)
+{
+	// given
+	configuration->disableCapture();
+	auto target = std::make_shared<core::Session>(logger, mockBeaconSender, mockBeaconStrict);
+
+	// expect
+	EXPECT_CALL(*mockBeaconStrict, identifyUser(testing::_))
+		.Times(testing::Exactly(0));
+
+	// when
+	target->identifyUser("user");
+}
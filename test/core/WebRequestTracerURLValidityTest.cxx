@@ -106,6 +106,24 @@ TEST_F(WebRequestTracerURLValidityTest, aSchemeIsInvalidIfInvalidCharactersAreEn
 	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("a()[]{}@://some.host"));
 }
 
+TEST_F(WebRequestTracerURLValidityTest, aSchemeMustBeFollowedBySeparatorAndHost)
+{
+	// then
+	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("http"));
+	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("http:"));
+	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("http:/some.host"));
+	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("http://"));
+	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("://some.host"));
+}
+
+TEST_F(WebRequestTracerURLValidityTest, anURLIsInvalidIfItContainsALineTerminator)
+{
+	// then
+	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("http://some.host\n"));
+	ASSERT_FALSE(WebRequestTracer::isValidURLScheme("http://some\r.host"));
+	ASSERT_TRUE(WebRequestTracer::isValidURLScheme("http://some.host/a b\t"));
+}
+
 TEST_F(WebRequestTracerURLValidityTest, anURLIsOnlySetInConstructorIfItIsValid)
 {
 	// given
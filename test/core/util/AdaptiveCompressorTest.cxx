@@ -0,0 +1,114 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "core/util/AdaptiveCompressor.h"
+
+using namespace core::util;
+
+class AdaptiveCompressorTest : public testing::Test
+{
+protected:
+
+	static std::string createPayload(size_t size)
+	{
+		std::string payload;
+		while (payload.size() < size)
+		{
+			payload.append("et=12&na=someAction&it=1&ca=1&pa=0&s0=1&t0=10&s1=2&t1=20&");
+		}
+		payload.resize(size);
+		return payload;
+	}
+};
+
+TEST_F(AdaptiveCompressorTest, payloadsBelowMinimumSizeAreNotCompressed)
+{
+	AdaptiveCompressor target(256, 500);
+	auto payload = createPayload(255);
+
+	std::vector<unsigned char> readBuffer;
+	auto obtained = target.compress(payload.c_str(), payload.size(), readBuffer);
+
+	EXPECT_FALSE(obtained);
+}
+
+TEST_F(AdaptiveCompressorTest, payloadsAboveMinimumSizeAreGzipCompressed)
+{
+	AdaptiveCompressor target(256, 500);
+	auto payload = createPayload(4096);
+
+	std::vector<unsigned char> readBuffer;
+	auto obtained = target.compress(payload.c_str(), payload.size(), readBuffer);
+
+	EXPECT_TRUE(obtained);
+	EXPECT_LT(readBuffer.size(), payload.size());
+	EXPECT_EQ(readBuffer[0], 0x1F);
+	EXPECT_EQ(readBuffer[1], 0x8B);
+}
+
+TEST_F(AdaptiveCompressorTest, defaultCompressionLevelIsUsedInitially)
+{
+	AdaptiveCompressor target;
+
+	EXPECT_EQ(target.getCompressionLevel(), 6);
+	EXPECT_EQ(target.getMinCompressionSize(), AdaptiveCompressor::DEFAULT_MIN_COMPRESSION_SIZE);
+}
+
+TEST_F(AdaptiveCompressorTest, fasterLevelIsChosenIfBytesSavedDoNotOutweighCompressionTime)
+{
+	// cheap transfer - compression time dominates
+	AdaptiveCompressor target(256, 10);
+
+	target.recordCompression(6, 1000, 220, 40000);
+	target.recordCompression(1, 1000, 300, 10000);
+
+	EXPECT_EQ(target.getCompressionLevel(), 1);
+}
+
+TEST_F(AdaptiveCompressorTest, betterLevelIsChosenIfBytesSavedOutweighCompressionTime)
+{
+	// expensive transfer - bytes saved dominate
+	AdaptiveCompressor target(256, 10000);
+
+	target.recordCompression(1, 1000, 300, 10000);
+	target.recordCompression(9, 1000, 200, 150000);
+
+	EXPECT_EQ(target.getCompressionLevel(), 9);
+}
+
+TEST_F(AdaptiveCompressorTest, neighbouringLevelIsProbedPeriodically)
+{
+	// only compression time counts and the default level is made look extremely slow
+	AdaptiveCompressor target(0, 0);
+	target.recordCompression(6, 1000, 220, 1000000000);
+	auto payload = createPayload(1024);
+	std::vector<unsigned char> readBuffer;
+
+	// when, the last compression probes the lower neighbour (level 3)
+	for (uint32_t i = 0; i < AdaptiveCompressor::PROBE_INTERVAL - 1; i++)
+	{
+		target.compress(payload.c_str(), payload.size(), readBuffer);
+		ASSERT_EQ(target.getCompressionLevel(), 6);
+	}
+	target.compress(payload.c_str(), payload.size(), readBuffer);
+
+	// then
+	EXPECT_EQ(target.getCompressionLevel(), 3);
+}
@@ -18,6 +18,8 @@
 
 #include <cstdint>
 #include <gtest/gtest.h>
+#include <string>
+#include <zlib.h>
 
 #include "core/util/Compressor.h"
 
@@ -49,4 +51,103 @@ TEST_F(CompressorTest, gzipCompressHelloWorld)
 	EXPECT_EQ(readBuffer[0], 0x1F);
 	EXPECT_EQ(readBuffer[1], 0x8B);
 	EXPECT_EQ(readBuffer[2], 0x08);
-}
\ No newline at end of file
+}
+
+static std::string gunzip(const std::vector<unsigned char>& data)
+{
+	z_stream strm;
+	strm.zalloc = 0;
+	strm.zfree = 0;
+	strm.opaque = 0;
+	strm.next_in = const_cast<Bytef*>(data.data());
+	strm.avail_in = static_cast<uInt>(data.size());
+	inflateInit2(&strm, 15 | 16);
+
+	std::string result;
+	unsigned char buffer[1024];
+	int res = Z_OK;
+	while (res == Z_OK)
+	{
+		strm.next_out = buffer;
+		strm.avail_out = sizeof(buffer);
+		res = inflate(&strm, Z_NO_FLUSH);
+		result.append(reinterpret_cast<const char*>(buffer), sizeof(buffer) - strm.avail_out);
+	}
+	inflateEnd(&strm);
+
+	return res == Z_STREAM_END ? result : std::string();
+}
+
+TEST_F(CompressorTest, compressedDataCanBeDecompressedForAllLevels)
+{
+	std::string inData;
+	for (int32_t i = 0; i < 2000; i++)
+	{
+		inData.append("et=1&na=action&it=1&ca=").append(std::to_string(i)).append("&");
+	}
+
+	for (int32_t level = Compressor::FASTEST_COMPRESSION_LEVEL; level <= Compressor::BEST_COMPRESSION_LEVEL; level++)
+	{
+		std::vector<unsigned char> readBuffer;
+		Compressor::compressMemory(inData.c_str(), inData.size(), readBuffer, level);
+
+		EXPECT_LT(readBuffer.size(), inData.size());
+		EXPECT_EQ(gunzip(readBuffer), inData);
+	}
+}
+
+TEST_F(CompressorTest, emptyDataCanBeCompressed)
+{
+	std::vector<unsigned char> readBuffer;
+	Compressor::compressMemory("", 0, readBuffer);
+
+	EXPECT_EQ(readBuffer[0], 0x1F);
+	EXPECT_EQ(readBuffer[1], 0x8B);
+	EXPECT_EQ(gunzip(readBuffer), std::string());
+}
+
+TEST_F(CompressorTest, decompressMemoryRestoresCompressedData)
+{
+	std::string inData;
+	for (int32_t i = 0; i < 2000; i++)
+	{
+		inData.append("et=1&na=action&it=1&ca=").append(std::to_string(i)).append("&");
+	}
+	std::vector<unsigned char> compressedData;
+	Compressor::compressMemory(inData.c_str(), inData.size(), compressedData);
+
+	std::vector<unsigned char> outData;
+	auto obtained = Compressor::decompressMemory(compressedData.data(), compressedData.size(), outData);
+
+	EXPECT_TRUE(obtained);
+	EXPECT_EQ(std::string(outData.begin(), outData.end()), inData);
+}
+
+TEST_F(CompressorTest, decompressMemoryRestoresConcatenatedMembers)
+{
+	const std::string firstData = "vv=3&tx=1000";
+	const std::string secondData = "&et=1&na=action";
+	std::vector<unsigned char> compressedData;
+	Compressor::compressMemory(firstData.c_str(), firstData.size(), compressedData);
+	std::vector<unsigned char> secondMember;
+	Compressor::compressMemory(secondData.c_str(), secondData.size(), secondMember);
+	compressedData.insert(compressedData.end(), secondMember.begin(), secondMember.end());
+
+	std::vector<unsigned char> outData;
+	auto obtained = Compressor::decompressMemory(compressedData.data(), compressedData.size(), outData);
+
+	EXPECT_TRUE(obtained);
+	EXPECT_EQ(std::string(outData.begin(), outData.end()), firstData + secondData);
+}
+
+TEST_F(CompressorTest, decompressMemoryFailsForTruncatedData)
+{
+	const char inData[] = "Hello World";
+	std::vector<unsigned char> compressedData;
+	Compressor::compressMemory(inData, sizeof(inData), compressedData);
+
+	std::vector<unsigned char> outData;
+	auto obtained = Compressor::decompressMemory(compressedData.data(), compressedData.size() / 2, outData);
+
+	EXPECT_FALSE(obtained);
+}
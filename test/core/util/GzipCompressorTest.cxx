@@ -0,0 +1,46 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include "core/util/GzipCompressor.h"
+
+using namespace core::util;
+
+class GzipCompressorTest : public testing::Test
+{
+};
+
+TEST_F(GzipCompressorTest, compressAlwaysReturnsGzipData)
+{
+	GzipCompressor target(1);
+	const char inData[] = "a";
+
+	std::vector<unsigned char> readBuffer;
+	auto obtained = target.compress(inData, sizeof(inData) - 1, readBuffer);
+
+	EXPECT_TRUE(obtained);
+	EXPECT_EQ(readBuffer[0], 0x1F);
+	EXPECT_EQ(readBuffer[1], 0x8B);
+	EXPECT_EQ(readBuffer[2], 0x08);
+}
+
+TEST_F(GzipCompressorTest, getCompressionLevelReturnsLevelPassedInConstructor)
+{
+	GzipCompressor target(9);
+
+	EXPECT_EQ(target.getCompressionLevel(), 9);
+}
@@ -0,0 +1,211 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "core/util/ObjectArena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace core::util;
+
+class ObjectArenaTest : public testing::Test
+{
+protected:
+	std::shared_ptr<ObjectArena> arena = std::make_shared<ObjectArena>();
+};
+
+TEST_F(ObjectArenaTest, aNewArenaHasNoChunks)
+{
+	// then
+	ASSERT_EQ(arena->getNumChunks(), size_t(0));
+}
+
+TEST_F(ObjectArenaTest, blocksAreAlignedAndDoNotOverlap)
+{
+	// when
+	auto first = static_cast<unsigned char*>(arena->allocate(24));
+	auto second = static_cast<unsigned char*>(arena->allocate(24));
+
+	// then
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(first) % 16, std::uintptr_t(0));
+	ASSERT_EQ(reinterpret_cast<std::uintptr_t>(second) % 16, std::uintptr_t(0));
+	ASSERT_GE(second - first, 32);
+	ASSERT_EQ(arena->getNumChunks(), size_t(1));
+
+	arena->deallocate(first, 24);
+	arena->deallocate(second, 24);
+}
+
+TEST_F(ObjectArenaTest, releasedBlockIsReusedForSameSizeClass)
+{
+	// given
+	auto block = arena->allocate(100);
+	arena->deallocate(block, 100);
+
+	// when
+	auto obtained = arena->allocate(112);
+
+	// then
+	ASSERT_EQ(obtained, block);
+	arena->deallocate(obtained, 112);
+}
+
+TEST_F(ObjectArenaTest, releasedBlockIsNotReusedForOtherSizeClass)
+{
+	// given
+	auto block = arena->allocate(16);
+	arena->deallocate(block, 16);
+
+	// when
+	auto obtained = arena->allocate(200);
+
+	// then
+	ASSERT_NE(obtained, block);
+	arena->deallocate(obtained, 200);
+}
+
+TEST_F(ObjectArenaTest, largeBlocksAreNotTakenFromChunks)
+{
+	// when
+	auto block = arena->allocate(64 * 1024);
+
+	// then
+	ASSERT_NE(block, nullptr);
+	ASSERT_EQ(arena->getNumChunks(), size_t(0));
+	arena->deallocate(block, 64 * 1024);
+}
+
+TEST_F(ObjectArenaTest, newChunkIsTakenWhenCurrentChunkIsExhausted)
+{
+	// given
+	std::vector<void*> blocks;
+
+	// when
+	for (int32_t i = 0; i < 100; i++)
+	{
+		blocks.push_back(arena->allocate(1024));
+	}
+
+	// then
+	ASSERT_GT(arena->getNumChunks(), size_t(1));
+	for (auto block : blocks)
+	{
+		arena->deallocate(block, 1024);
+	}
+}
+
+TEST_F(ObjectArenaTest, sharedObjectKeepsArenaAlive)
+{
+	// given
+	std::weak_ptr<ObjectArena> weakArena = arena;
+	auto object = allocateShared<std::vector<int32_t>>(arena, 3, 42);
+
+	// when
+	arena = nullptr;
+
+	// then
+	ASSERT_FALSE(weakArena.expired());
+	ASSERT_EQ(*object, std::vector<int32_t>({ 42, 42, 42 }));
+
+	// and when
+	object = nullptr;
+
+	// then
+	ASSERT_TRUE(weakArena.expired());
+}
+
+TEST_F(ObjectArenaTest, allocateSharedWithoutArenaAllocatesOnHeap)
+{
+	// when
+	auto obtained = allocateShared<int32_t>(nullptr, 42);
+
+	// then
+	ASSERT_EQ(*obtained, 42);
+}
+
+TEST_F(ObjectArenaTest, firstChunkIsSmallAndFollowingChunksGrow)
+{
+	// given
+	std::vector<void*> blocks;
+
+	// when
+	blocks.push_back(arena->allocate(24));
+
+	// then
+	ASSERT_EQ(arena->getNumChunkBytes(), ObjectArena::MIN_CHUNK_SIZE);
+
+	// and when
+	for (int32_t i = 0; i < 100; i++)
+	{
+		blocks.push_back(arena->allocate(1024));
+	}
+
+	// then
+	ASSERT_LT(arena->getNumChunks(), size_t(20));
+	for (auto block : blocks)
+	{
+		arena->deallocate(block, 24);
+	}
+}
+
+TEST_F(ObjectArenaTest, chunksOfDestroyedArenaAreReusedByOtherArenas)
+{
+	// given
+	arena->deallocate(arena->allocate(24), 24);
+	auto numPooledChunks = ObjectArena::getNumPooledChunks();
+
+	// when
+	arena = nullptr;
+
+	// then
+	ASSERT_EQ(ObjectArena::getNumPooledChunks(), numPooledChunks + 1);
+
+	// and when
+	auto other = std::make_shared<ObjectArena>();
+	other->deallocate(other->allocate(24), 24);
+
+	// then
+	ASSERT_EQ(ObjectArena::getNumPooledChunks(), numPooledChunks);
+}
+
+TEST_F(ObjectArenaTest, blocksCanBeReleasedByAnotherThread)
+{
+	// given
+	std::vector<void*> blocks;
+	for (int32_t i = 0; i < 100; i++)
+	{
+		blocks.push_back(arena->allocate(64));
+	}
+
+	// when
+	std::thread releaser([this, &blocks]()
+	{
+		for (auto block : blocks)
+		{
+			arena->deallocate(block, 64);
+		}
+	});
+	releaser.join();
+
+	// then
+	auto block = arena->allocate(64);
+	ASSERT_NE(block, nullptr);
+	arena->deallocate(block, 64);
+}
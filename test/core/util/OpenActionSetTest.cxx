@@ -0,0 +1,192 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "core/util/OpenActionSet.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace core::util;
+
+class OpenActionSetTest : public testing::Test
+{
+protected:
+	class TestAction
+	{
+	public:
+		TestAction(int32_t id)
+			: mID(id)
+			, mHook()
+		{
+		}
+
+		OpenActionSet<TestAction>::Hook& getOpenActionHook()
+		{
+			return mHook;
+		}
+
+		int32_t mID;
+		OpenActionSet<TestAction>::Hook mHook;
+	};
+
+	std::shared_ptr<TestAction> actionOne = std::make_shared<TestAction>(1);
+	std::shared_ptr<TestAction> actionTwo = std::make_shared<TestAction>(2);
+	std::shared_ptr<TestAction> actionThree = std::make_shared<TestAction>(3);
+	OpenActionSet<TestAction> openActions;
+};
+
+TEST_F(OpenActionSetTest, aNewSetIsEmpty)
+{
+	// then
+	ASSERT_TRUE(openActions.isEmpty());
+	ASSERT_TRUE(openActions.removeAll().empty());
+}
+
+TEST_F(OpenActionSetTest, insertedActionCanBeRemoved)
+{
+	// given
+	openActions.insert(actionOne);
+
+	// then
+	ASSERT_FALSE(openActions.isEmpty());
+
+	// when
+	auto obtained = openActions.remove(*actionOne);
+
+	// then
+	ASSERT_TRUE(obtained);
+	ASSERT_TRUE(openActions.isEmpty());
+}
+
+TEST_F(OpenActionSetTest, removingAnActionNotInTheSetReturnsFalse)
+{
+	// given
+	openActions.insert(actionOne);
+
+	// then
+	ASSERT_FALSE(openActions.remove(*actionTwo));
+	ASSERT_FALSE(openActions.isEmpty());
+}
+
+TEST_F(OpenActionSetTest, anActionCanOnlyBeRemovedOnce)
+{
+	// given
+	openActions.insert(actionOne);
+
+	// then
+	ASSERT_TRUE(openActions.remove(*actionOne));
+	ASSERT_FALSE(openActions.remove(*actionOne));
+}
+
+TEST_F(OpenActionSetTest, removeOnlyRemovesTheGivenAction)
+{
+	// given
+	openActions.insert(actionOne);
+	openActions.insert(actionTwo);
+	openActions.insert(actionThree);
+
+	// when
+	openActions.remove(*actionTwo);
+
+	// then
+	auto obtained = openActions.removeAll();
+	ASSERT_EQ(obtained, std::vector<std::shared_ptr<TestAction>>({ actionOne, actionThree }));
+}
+
+TEST_F(OpenActionSetTest, removeAllReturnsActionsInInsertionOrder)
+{
+	// given
+	std::vector<std::shared_ptr<TestAction>> actions;
+	for (int32_t i = 0; i < 20; i++)
+	{
+		actions.push_back(std::make_shared<TestAction>(i));
+		openActions.insert(actions.back());
+	}
+
+	// when
+	auto obtained = openActions.removeAll();
+
+	// then
+	ASSERT_EQ(obtained, actions);
+	ASSERT_TRUE(openActions.isEmpty());
+}
+
+TEST_F(OpenActionSetTest, actionsRemovedByRemoveAllCannotBeRemovedAgain)
+{
+	// given
+	openActions.insert(actionOne);
+	openActions.removeAll();
+
+	// then
+	ASSERT_FALSE(openActions.remove(*actionOne));
+	ASSERT_TRUE(openActions.isEmpty());
+}
+
+TEST_F(OpenActionSetTest, setReleasesRemovedActions)
+{
+	// given
+	std::weak_ptr<TestAction> weakAction = actionOne;
+	openActions.insert(actionOne);
+	openActions.remove(*actionOne);
+
+	// when
+	actionOne = nullptr;
+
+	// then
+	ASSERT_TRUE(weakAction.expired());
+}
+
+TEST_F(OpenActionSetTest, concurrentlyInsertedAndRemovedActionsAreTracked)
+{
+	// given
+	const int32_t numThreads = 4;
+	const int32_t numActions = 1000;
+	std::vector<std::vector<std::shared_ptr<TestAction>>> keptActions(numThreads);
+
+	// when
+	std::vector<std::thread> threads;
+	for (int32_t t = 0; t < numThreads; t++)
+	{
+		threads.push_back(std::thread([this, &keptActions, t, numActions]()
+		{
+			for (int32_t i = 0; i < numActions; i++)
+			{
+				auto action = std::make_shared<TestAction>(i);
+				openActions.insert(action);
+				if (i % 2 == 0)
+				{
+					openActions.remove(*action);
+				}
+				else
+				{
+					keptActions[t].push_back(action);
+				}
+			}
+		}));
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	// then
+	ASSERT_EQ(openActions.removeAll().size(), size_t(numThreads * numActions / 2));
+	ASSERT_TRUE(openActions.isEmpty());
+}
@@ -0,0 +1,121 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "core/util/SingleProducerQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+using namespace core::util;
+
+class SingleProducerQueueTest : public testing::Test
+{
+protected:
+	SingleProducerQueue<int32_t> queue;
+};
+
+TEST_F(SingleProducerQueueTest, aNewQueueIsEmpty)
+{
+	// given
+	int32_t item = 0;
+
+	// then
+	ASSERT_TRUE(queue.isEmpty());
+	ASSERT_FALSE(queue.pop(item));
+}
+
+TEST_F(SingleProducerQueueTest, itemsArePoppedInOrderOfPushing)
+{
+	// given
+	queue.push(1);
+	queue.push(2);
+	queue.push(3);
+	int32_t item = 0;
+
+	// then
+	ASSERT_FALSE(queue.isEmpty());
+	ASSERT_TRUE(queue.pop(item));
+	ASSERT_EQ(item, 1);
+	ASSERT_TRUE(queue.pop(item));
+	ASSERT_EQ(item, 2);
+	ASSERT_TRUE(queue.pop(item));
+	ASSERT_EQ(item, 3);
+	ASSERT_TRUE(queue.isEmpty());
+	ASSERT_FALSE(queue.pop(item));
+}
+
+TEST_F(SingleProducerQueueTest, itemsCanBePushedAfterQueueWasEmptied)
+{
+	// given
+	int32_t item = 0;
+	queue.push(1);
+	queue.pop(item);
+
+	// when
+	queue.push(2);
+
+	// then
+	ASSERT_TRUE(queue.pop(item));
+	ASSERT_EQ(item, 2);
+}
+
+TEST_F(SingleProducerQueueTest, moveOnlyItemsCanBeQueued)
+{
+	// given
+	SingleProducerQueue<std::unique_ptr<int32_t>> target;
+	target.push(std::unique_ptr<int32_t>(new int32_t(42)));
+	std::unique_ptr<int32_t> item;
+
+	// then
+	ASSERT_TRUE(target.pop(item));
+	ASSERT_EQ(*item, 42);
+}
+
+TEST_F(SingleProducerQueueTest, consumerReceivesAllItemsOfConcurrentProducerInOrder)
+{
+	// given
+	const int32_t numItems = 100000;
+	std::thread producer([this, numItems]()
+	{
+		for (int32_t i = 0; i < numItems; i++)
+		{
+			queue.push(int32_t(i));
+		}
+	});
+
+	// when
+	int32_t expected = 0;
+	int32_t item = 0;
+	while (expected < numItems)
+	{
+		if (queue.pop(item))
+		{
+			ASSERT_EQ(item, expected);
+			expected++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	// then
+	ASSERT_TRUE(queue.isEmpty());
+}
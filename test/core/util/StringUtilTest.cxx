@@ -435,3 +435,58 @@ TEST_F(StringUtilTest, to64BitHashWithOddString)
 	// then
 	ASSERT_THAT(hash, testing::Gt(0));
 }
+
+// tryParseInt32 tests -------------------------------------------------------------------------------------------------
+
+TEST_F(StringUtilTest, tryParseInt32WithValidNumbers)
+{
+	// given
+	auto string = std::string(" -42&");
+	int32_t result = 0;
+
+	// when, then
+	ASSERT_TRUE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+	ASSERT_THAT(result, testing::Eq(-42));
+
+	string = std::string("+2147483647");
+	ASSERT_TRUE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+	ASSERT_THAT(result, testing::Eq(INT32_MAX));
+
+	string = std::string("-2147483648");
+	ASSERT_TRUE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+	ASSERT_THAT(result, testing::Eq(INT32_MIN));
+}
+
+TEST_F(StringUtilTest, tryParseInt32OnlyConsumesGivenRange)
+{
+	// given
+	auto string = std::string("12345");
+	int32_t result = 0;
+
+	// when
+	auto obtained = StringUtil::tryParseInt32(string.data(), string.data() + 2, result);
+
+	// then
+	ASSERT_TRUE(obtained);
+	ASSERT_THAT(result, testing::Eq(12));
+}
+
+TEST_F(StringUtilTest, tryParseInt32WithInvalidNumbers)
+{
+	// given
+	int32_t result = 17;
+
+	// when, then
+	auto string = std::string("");
+	ASSERT_FALSE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+	string = std::string("-");
+	ASSERT_FALSE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+	string = std::string("abc");
+	ASSERT_FALSE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+	string = std::string("2147483648");
+	ASSERT_FALSE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+	string = std::string("-2147483649");
+	ASSERT_FALSE(StringUtil::tryParseInt32(string.data(), string.data() + string.size(), result));
+
+	ASSERT_THAT(result, testing::Eq(17));
+}
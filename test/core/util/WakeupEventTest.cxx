@@ -0,0 +1,86 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "core/util/WakeupEvent.h"
+
+#include <thread>
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+using namespace core::util;
+
+class WakeupEventTest : public testing::Test
+{
+};
+
+TEST_F(WakeupEventTest, waitTimesOutIfEventIsNotRaised)
+{
+	// given
+	WakeupEvent target;
+
+	// when
+	auto obtained = target.wait(10);
+
+	// then
+	ASSERT_FALSE(obtained);
+}
+
+TEST_F(WakeupEventTest, signalRaisedBeforeWaitIsNotLost)
+{
+	// given
+	WakeupEvent target;
+	target.signal();
+
+	// when
+	auto obtained = target.wait(0);
+
+	// then
+	ASSERT_TRUE(obtained);
+}
+
+TEST_F(WakeupEventTest, eventIsResetAfterWait)
+{
+	// given
+	WakeupEvent target;
+	target.signal();
+	target.wait(0);
+
+	// when
+	auto obtained = target.wait(0);
+
+	// then
+	ASSERT_FALSE(obtained);
+}
+
+TEST_F(WakeupEventTest, signalWakesUpThreadWaitingWithoutTimeout)
+{
+	// given
+	WakeupEvent target;
+	std::thread signaller([&target]
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		target.signal();
+	});
+
+	// when
+	auto obtained = target.wait(-1);
+	signaller.join();
+
+	// then
+	ASSERT_TRUE(obtained);
+}
@@ -0,0 +1,95 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "core/util/WorkStealingThreadPool.h"
+#include "core/util/CountDownLatch.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace core::util;
+
+class WorkStealingThreadPoolTest : public testing::Test
+{
+};
+
+TEST_F(WorkStealingThreadPoolTest, atLeastOneThreadIsStarted)
+{
+	// given
+	WorkStealingThreadPool target(0);
+
+	// then
+	ASSERT_EQ(target.getNumThreads(), uint32_t(1));
+}
+
+TEST_F(WorkStealingThreadPoolTest, allSubmittedTasksAreExecuted)
+{
+	// given
+	std::atomic<uint32_t> numExecutedTasks(0);
+	CountDownLatch latch(100);
+	WorkStealingThreadPool target(4);
+
+	// when
+	for (auto i = 0; i < 100; i++)
+	{
+		target.submit([&numExecutedTasks, &latch] { numExecutedTasks++; latch.countDown(); });
+	}
+	latch.await();
+
+	// then
+	ASSERT_EQ(numExecutedTasks, uint32_t(100));
+}
+
+TEST_F(WorkStealingThreadPoolTest, pendingTasksAreExecutedBeforeThePoolIsDestroyed)
+{
+	// given
+	std::atomic<uint32_t> numExecutedTasks(0);
+
+	// when
+	{
+		WorkStealingThreadPool target(2);
+		for (auto i = 0; i < 10; i++)
+		{
+			target.submit([&numExecutedTasks] { numExecutedTasks++; });
+		}
+	}
+
+	// then
+	ASSERT_EQ(numExecutedTasks, uint32_t(10));
+}
+
+TEST_F(WorkStealingThreadPoolTest, blockedWorkerDoesNotHoldUpTasksQueuedBehindIt)
+{
+	// given
+	CountDownLatch release(1);
+	CountDownLatch done(3);
+	WorkStealingThreadPool target(2);
+
+	// when the first worker is blocked and three more tasks are distributed over both queues
+	target.submit([&release] { release.await(); });
+	for (auto i = 0; i < 3; i++)
+	{
+		target.submit([&done] { done.countDown(); });
+	}
+
+	// then the idle worker steals the task queued behind the blocked one
+	done.await();
+	release.countDown();
+}
@@ -0,0 +1,229 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "protocol/AdaptiveSendingController.h"
+
+#include "../caching/MockBeaconCache.h"
+
+using namespace protocol;
+
+static const int64_t CACHE_SIZE_UPPER_BOUND = 1000;
+static const int64_t SEND_INTERVAL = 120000;
+static const int32_t MAX_BEACON_SIZE = 64 * 1024;
+
+class AdaptiveSendingControllerTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mNumBytesInCache = 0;
+		mMockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+		ON_CALL(*mMockBeaconCache, getNumBytesInCache())
+			.WillByDefault(testing::Invoke([this]() { return mNumBytesInCache; }));
+	}
+
+	std::shared_ptr<AdaptiveSendingController> createController(int64_t slowResponseThreshold)
+	{
+		auto controller = std::make_shared<AdaptiveSendingController>(CACHE_SIZE_UPPER_BOUND, slowResponseThreshold);
+		controller->setBeaconCache(mMockBeaconCache);
+		return controller;
+	}
+
+	int64_t mNumBytesInCache;
+	std::shared_ptr<testing::NiceMock<test::MockBeaconCache>> mMockBeaconCache;
+};
+
+TEST_F(AdaptiveSendingControllerTest, serverValuesAreAppliedIfDisabled)
+{
+	// given
+	auto target = createController(AdaptiveSendingController::DEFAULT_SLOW_RESPONSE_THRESHOLD);
+	mNumBytesInCache = CACHE_SIZE_UPPER_BOUND;
+
+	// when
+	target->evaluate(0, SEND_INTERVAL);
+
+	// then
+	ASSERT_FALSE(target->isEnabled());
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL);
+	ASSERT_EQ(target->getMaxBeaconSize(MAX_BEACON_SIZE), MAX_BEACON_SIZE);
+	ASSERT_FALSE(target->getState(SEND_INTERVAL, MAX_BEACON_SIZE).isCachePressure);
+}
+
+TEST_F(AdaptiveSendingControllerTest, serverValuesAreAppliedWithoutPressure)
+{
+	// given
+	auto target = createController(1000);
+	mNumBytesInCache = 500;
+	target->recordResponseLatency(100);
+
+	// when
+	target->evaluate(0, SEND_INTERVAL);
+
+	// then
+	ASSERT_TRUE(target->isEnabled());
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL);
+	ASSERT_EQ(target->getMaxBeaconSize(MAX_BEACON_SIZE), MAX_BEACON_SIZE);
+}
+
+TEST_F(AdaptiveSendingControllerTest, sendIntervalIsShortenedStepwiseUnderCachePressure)
+{
+	// given
+	auto target = createController(1000);
+	mNumBytesInCache = 750;
+
+	// when, then
+	target->evaluate(0, SEND_INTERVAL);
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL / 2);
+
+	// the next step is taken after the shortened interval at the earliest
+	target->evaluate(SEND_INTERVAL / 2 - 1, SEND_INTERVAL);
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL / 2);
+	target->evaluate(SEND_INTERVAL / 2, SEND_INTERVAL);
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL / 4);
+
+	// the interval is not shortened any further
+	target->evaluate(SEND_INTERVAL, SEND_INTERVAL);
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL / 4);
+
+	// chunks are still filled up to the server's limit
+	ASSERT_EQ(target->getMaxBeaconSize(MAX_BEACON_SIZE), MAX_BEACON_SIZE);
+
+	auto state = target->getState(SEND_INTERVAL, MAX_BEACON_SIZE);
+	ASSERT_TRUE(state.isCachePressure);
+	ASSERT_EQ(state.sendIntervalInMilliseconds, SEND_INTERVAL / 4);
+	ASSERT_EQ(state.numSendIntervalDecreases, int64_t(2));
+	ASSERT_EQ(state.numSendIntervalIncreases, int64_t(0));
+}
+
+TEST_F(AdaptiveSendingControllerTest, shortenedSendIntervalIsBoundedByMinimum)
+{
+	// given
+	auto target = createController(1000);
+	mNumBytesInCache = CACHE_SIZE_UPPER_BOUND;
+
+	// when
+	target->evaluate(0, 3000);
+	target->evaluate(10000, 3000);
+
+	// then
+	ASSERT_EQ(target->getSendInterval(3000), AdaptiveSendingController::MIN_SEND_INTERVAL);
+	ASSERT_EQ(target->getSendInterval(500), int64_t(500));
+}
+
+TEST_F(AdaptiveSendingControllerTest, cachePressureIsLeftAtLowerThreshold)
+{
+	// given
+	auto target = createController(1000);
+	mNumBytesInCache = 800;
+	target->evaluate(0, SEND_INTERVAL);
+
+	// when the usage drops below the entry threshold, but not below the leave threshold
+	mNumBytesInCache = 600;
+	target->evaluate(SEND_INTERVAL, SEND_INTERVAL);
+
+	// then
+	ASSERT_TRUE(target->getState(SEND_INTERVAL, MAX_BEACON_SIZE).isCachePressure);
+
+	// when the usage drops to the leave threshold
+	mNumBytesInCache = 500;
+	target->evaluate(2 * SEND_INTERVAL, SEND_INTERVAL);
+
+	// then the interval returns stepwise to the server's value
+	ASSERT_FALSE(target->getState(SEND_INTERVAL, MAX_BEACON_SIZE).isCachePressure);
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL / 2);
+	target->evaluate(3 * SEND_INTERVAL, SEND_INTERVAL);
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), SEND_INTERVAL);
+}
+
+TEST_F(AdaptiveSendingControllerTest, sendIntervalIsLengthenedAndBeaconSizeReducedForSlowCollector)
+{
+	// given
+	auto target = createController(1000);
+	target->recordResponseLatency(1500);
+
+	// when
+	target->evaluate(0, SEND_INTERVAL);
+
+	// then
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), 2 * SEND_INTERVAL);
+	ASSERT_EQ(target->getMaxBeaconSize(MAX_BEACON_SIZE), MAX_BEACON_SIZE / 2);
+
+	// when
+	target->evaluate(2 * SEND_INTERVAL, SEND_INTERVAL);
+
+	// then
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), 4 * SEND_INTERVAL);
+	ASSERT_EQ(target->getMaxBeaconSize(MAX_BEACON_SIZE), MAX_BEACON_SIZE / 4);
+	ASSERT_EQ(target->getMaxBeaconSize(10000), AdaptiveSendingController::MIN_MAX_BEACON_SIZE);
+	ASSERT_EQ(target->getMaxBeaconSize(4000), 4000);
+
+	auto state = target->getState(SEND_INTERVAL, MAX_BEACON_SIZE);
+	ASSERT_TRUE(state.isLatencyPressure);
+	ASSERT_EQ(state.averageResponseLatencyInMilliseconds, int64_t(1500));
+	ASSERT_EQ(state.numSendIntervalIncreases, int64_t(2));
+}
+
+TEST_F(AdaptiveSendingControllerTest, slowCollectorTakesPrecedenceOverCachePressure)
+{
+	// given
+	auto target = createController(1000);
+	mNumBytesInCache = CACHE_SIZE_UPPER_BOUND;
+	target->recordResponseLatency(2000);
+
+	// when
+	target->evaluate(0, SEND_INTERVAL);
+
+	// then
+	auto state = target->getState(SEND_INTERVAL, MAX_BEACON_SIZE);
+	ASSERT_TRUE(state.isCachePressure);
+	ASSERT_TRUE(state.isLatencyPressure);
+	ASSERT_EQ(state.sendIntervalInMilliseconds, 2 * SEND_INTERVAL);
+}
+
+TEST_F(AdaptiveSendingControllerTest, latencyPressureIsLeftAtHalfOfThreshold)
+{
+	// given
+	auto target = createController(1000);
+	target->recordResponseLatency(1000);
+	target->evaluate(0, SEND_INTERVAL);
+
+	// when the average drops below the threshold, but stays above half of it
+	for (int i = 0; i < 2; i++)
+	{
+		target->recordResponseLatency(500);
+	}
+	target->evaluate(2 * SEND_INTERVAL, SEND_INTERVAL);
+
+	// then
+	ASSERT_TRUE(target->getState(SEND_INTERVAL, MAX_BEACON_SIZE).isLatencyPressure);
+	ASSERT_EQ(target->getSendInterval(SEND_INTERVAL), 4 * SEND_INTERVAL);
+
+	// when the average drops to half of the threshold
+	for (int i = 0; i < 20; i++)
+	{
+		target->recordResponseLatency(100);
+	}
+	target->evaluate(6 * SEND_INTERVAL, SEND_INTERVAL);
+
+	// then the interval steps back towards the server's value
+	auto state = target->getState(SEND_INTERVAL, MAX_BEACON_SIZE);
+	ASSERT_FALSE(state.isLatencyPressure);
+	ASSERT_EQ(state.sendIntervalInMilliseconds, 2 * SEND_INTERVAL);
+	ASSERT_EQ(state.numSendIntervalDecreases, int64_t(1));
+}
@@ -18,6 +18,7 @@
 #include "OpenKit/DataCollectionLevel.h"
 #include "OpenKit/CrashReportingLevel.h"
 #include "caching/BeaconCache.h"
+#include "caching/BeaconChunkStore.h"
 
 #include "core/util/DefaultLogger.h"
 #include "providers/DefaultThreadIDProvider.h"
@@ -27,6 +28,9 @@
 #include "providers/DefaultHTTPClientProvider.h"
 #include "core/BeaconSender.h"
 #include "core/Action.h"
+#include "core/NullWebRequestTracer.h"
+#include "core/RootAction.h"
+#include "core/WebRequestTracer.h"
 #include "configuration/Configuration.h"
 
 #include "../protocol/MockHTTPClient.h"
@@ -40,6 +44,10 @@
 #include "../core/MockSession.h"
 #include "../providers/MockTimingProvider.h"
 
+#include <cstdlib>
+
+#include <unistd.h>
+
 using namespace core;
 using namespace protocol;
 
@@ -72,6 +80,7 @@ protected:
 		randomGeneratorMock = std::make_shared<testing::NiceMock<test::MockPRNGenerator>>();
 		sessionIDProviderMock = std::make_shared<testing::NiceMock<test::MockSessionIDProvider>>();
 		mockTimingProvider = std::make_shared<testing::NiceMock<test::MockTimingProvider>>();
+		valueAggregationInterval = -1;
 	}
 
 	std::shared_ptr<protocol::Beacon> buildBeaconWithDefaultConfig()
@@ -95,7 +104,9 @@ protected:
 
 		configuration = std::make_shared<configuration::Configuration>(device, configuration::OpenKitType::Type::DYNATRACE,
 			core::UTF8String(APP_NAME), "", appID, deviceID, std::to_string(deviceID).c_str(), "",
-			sessionIDProviderMock, trustManager, beaconCacheConfiguration, beaconConfiguration);
+			sessionIDProviderMock, trustManager, beaconCacheConfiguration, beaconConfiguration,
+			nullptr, nullptr, nullptr, configuration::Configuration::DEFAULT_BEACON_SENDING_CONCURRENCY, false, false, 0, adaptiveSendingController,
+			openkit::SendPriorityPolicy::INSERTION_ORDER, nullptr, eventSampler, valueAggregationInterval);
 		configuration->enableCapture();
 
 		return std::make_shared<protocol::Beacon>(logger, beaconCache, configuration, clientIPAddress, threadIDProvider, mockTimingProvider, randomGeneratorMock);
@@ -172,6 +183,9 @@ protected:
 	std::shared_ptr<testing::NiceMock<test::MockSessionIDProvider>> sessionIDProviderMock;
 	std::shared_ptr<configuration::Configuration> configuration;
 	std::shared_ptr<testing::NiceMock<test::MockTimingProvider>> mockTimingProvider;
+	std::shared_ptr<protocol::EventSampler> eventSampler;
+	std::shared_ptr<protocol::AdaptiveSendingController> adaptiveSendingController;
+	int64_t valueAggregationInterval;
 };
 
 TEST_F(BeaconTest, noWebRequestIsReportedForDataCollectionLevel0)
@@ -1075,4 +1089,662 @@ TEST_F(BeaconTest, useInternalBeaconIdForAccessingBeaconCacheWhenSessionNumberRe
 	// when
 	target->clearData();
 
-}
\ No newline at end of file
+}
+TEST_F(BeaconTest, sendThresholdIsReachedWhenEnoughDataWasAdded)
+{
+	// given
+	beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1, 100);
+	auto target = buildBeaconWithDefaultConfig();
+	auto wakeupEvent = std::make_shared<core::util::WakeupEvent>();
+	target->setWakeupEvent(wakeupEvent);
+
+	// when adding the first data
+	target->reportEvent(1, "event");
+
+	// then the sender is woken up to schedule the send interval
+	ASSERT_FALSE(target->isSendThresholdReached());
+	ASSERT_TRUE(wakeupEvent->wait(0));
+
+	// when adding more data below the threshold
+	target->reportEvent(1, "event");
+
+	// then the sender is not woken up
+	ASSERT_FALSE(target->isSendThresholdReached());
+	ASSERT_FALSE(wakeupEvent->wait(0));
+
+	// when exceeding the threshold
+	target->reportEvent(1, std::string(100, 'x').c_str());
+
+	// then
+	ASSERT_TRUE(target->isSendThresholdReached());
+	ASSERT_TRUE(wakeupEvent->wait(0));
+}
+
+TEST_F(BeaconTest, sendThresholdIsResetWhenDataIsCleared)
+{
+	// given
+	beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1, 10);
+	auto target = buildBeaconWithDefaultConfig();
+	target->reportEvent(1, "some event exceeding the threshold");
+	ASSERT_TRUE(target->isSendThresholdReached());
+
+	// when
+	target->clearData();
+
+	// then
+	ASSERT_FALSE(target->isSendThresholdReached());
+}
+
+TEST_F(BeaconTest, sendThresholdIsNeverReachedIfDisabled)
+{
+	// given
+	beaconCacheConfiguration = std::make_shared<configuration::BeaconCacheConfiguration>(-1, -1, -1, 0);
+	auto target = buildBeaconWithDefaultConfig();
+
+	// when
+	target->reportEvent(1, "some event");
+
+	// then
+	ASSERT_FALSE(target->isSendThresholdReached());
+}
+
+static std::vector<std::string> createEventNames(size_t numEvents)
+{
+	std::vector<std::string> eventNames;
+	for (size_t i = 0; i < numEvents; i++)
+	{
+		eventNames.push_back("event" + std::to_string(i) + "y" + std::string(200, 'x'));
+	}
+	return eventNames;
+}
+
+TEST_F(BeaconTest, sendTransmitsAllChunksInOrder)
+{
+	// given
+	auto target = buildBeaconWithDefaultConfig();
+	auto eventNames = createEventNames(500);
+	for (const auto& eventName : eventNames)
+	{
+		target->reportEvent(1, eventName.c_str());
+	}
+
+	std::vector<std::string> sentChunks;
+	ON_CALL(*mockHTTPClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockHTTPClient));
+	ON_CALL(*mockHTTPClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.WillByDefault(testing::Invoke([this, &sentChunks](const core::UTF8String&, const core::UTF8String& beaconData)
+		{
+			sentChunks.push_back(beaconData.getStringData());
+			return new protocol::StatusResponse(logger, core::UTF8String(""), 200, protocol::Response::ResponseHeaders());
+		}));
+
+	// when
+	auto obtained = target->send(mockHTTPClientProvider);
+
+	// then
+	ASSERT_NE(obtained, nullptr);
+	ASSERT_GT(sentChunks.size(), size_t(1));
+	ASSERT_TRUE(target->isEmpty());
+	size_t chunkIndex = 0;
+	size_t position = 0;
+	for (const auto& eventName : eventNames)
+	{
+		auto found = sentChunks[chunkIndex].find("=" + eventName + "&", position);
+		if (found == std::string::npos)
+		{
+			chunkIndex++;
+			ASSERT_LT(chunkIndex, sentChunks.size());
+			found = sentChunks[chunkIndex].find("=" + eventName + "&");
+		}
+		ASSERT_NE(found, std::string::npos);
+		position = found;
+	}
+	ASSERT_EQ(chunkIndex, sentChunks.size() - 1);
+}
+
+TEST_F(BeaconTest, sendDoesNotRecordTimeWaitingForUploadRateLimitAsResponseLatency)
+{
+	// given
+	adaptiveSendingController = std::make_shared<protocol::AdaptiveSendingController>(-1, 1000);
+	auto target = buildBeaconWithDefaultConfig();
+	target->reportEvent(1, "event");
+
+	int64_t currentTime = 0;
+	ON_CALL(*mockTimingProvider, provideTimestampInMilliseconds())
+		.WillByDefault(testing::Invoke([&currentTime]() { return currentTime; }));
+	ON_CALL(*mockHTTPClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockHTTPClient));
+	ON_CALL(*mockHTTPClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.WillByDefault(testing::Invoke([this, &currentTime](const core::UTF8String&, const core::UTF8String&)
+		{
+			// the upload is throttled for 5 seconds, the server responds within 100 milliseconds
+			currentTime += 5100;
+			return new protocol::StatusResponse(logger, core::UTF8String(""), 200, protocol::Response::ResponseHeaders());
+		}));
+	ON_CALL(*mockHTTPClient, getLastRequestThrottledTime())
+		.WillByDefault(testing::Return(5000));
+
+	// when
+	target->send(mockHTTPClientProvider);
+	adaptiveSendingController->evaluate(currentTime, 60000);
+
+	// then
+	auto state = adaptiveSendingController->getState(60000, 150 * 1024);
+	ASSERT_EQ(state.averageResponseLatencyInMilliseconds, int64_t(100));
+	ASSERT_FALSE(state.isLatencyPressure);
+	ASSERT_EQ(state.sendIntervalInMilliseconds, int64_t(60000));
+}
+
+TEST_F(BeaconTest, sendTransmitsAllChunksInOrderWhenChunksAreBuiltByChunkBuilderPool)
+{
+	// given
+	auto chunkBuilderPool = std::make_shared<core::util::WorkStealingThreadPool>(1);
+	auto target = buildBeaconWithDefaultConfig();
+	target->setChunkBuilderPool(chunkBuilderPool);
+	auto eventNames = createEventNames(500);
+	for (const auto& eventName : eventNames)
+	{
+		target->reportEvent(1, eventName.c_str());
+	}
+
+	std::vector<std::string> sentChunks;
+	ON_CALL(*mockHTTPClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockHTTPClient));
+	ON_CALL(*mockHTTPClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.WillByDefault(testing::Invoke([this, &sentChunks](const core::UTF8String&, const core::UTF8String& beaconData)
+		{
+			sentChunks.push_back(beaconData.getStringData());
+			return new protocol::StatusResponse(logger, core::UTF8String(""), 200, protocol::Response::ResponseHeaders());
+		}));
+
+	// when
+	auto obtained = target->send(mockHTTPClientProvider);
+
+	// then
+	ASSERT_NE(obtained, nullptr);
+	ASSERT_GT(sentChunks.size(), size_t(1));
+	ASSERT_TRUE(target->isEmpty());
+	size_t numEventsSent = 0;
+	for (const auto& chunk : sentChunks)
+	{
+		// each chunk continues with the event following the last one of the previous chunk
+		for (size_t position = 0; numEventsSent < eventNames.size(); numEventsSent++)
+		{
+			auto found = chunk.find("=" + eventNames[numEventsSent] + "&", position);
+			if (found == std::string::npos)
+			{
+				break;
+			}
+			position = found;
+		}
+	}
+	ASSERT_EQ(numEventsSent, eventNames.size());
+}
+
+TEST_F(BeaconTest, sendRestoresCurrentAndFollowingChunkIfRequestFails)
+{
+	// given
+	auto target = buildBeaconWithDefaultConfig();
+	auto eventNames = createEventNames(500);
+	for (const auto& eventName : eventNames)
+	{
+		target->reportEvent(1, eventName.c_str());
+	}
+
+	std::vector<std::string> sentChunks;
+	size_t numRequests = 0;
+	ON_CALL(*mockHTTPClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockHTTPClient));
+	ON_CALL(*mockHTTPClient, sendBeaconRequestRawPtrProxy(testing::_, testing::_))
+		.WillByDefault(testing::Invoke([this, &sentChunks, &numRequests](const core::UTF8String&, const core::UTF8String& beaconData)
+		{
+			sentChunks.push_back(beaconData.getStringData());
+			auto responseCode = ++numRequests == 2 ? 500 : 200;
+			return new protocol::StatusResponse(logger, core::UTF8String(""), responseCode, protocol::Response::ResponseHeaders());
+		}));
+
+	// when the second request fails
+	auto obtained = target->send(mockHTTPClientProvider);
+
+	// then only the events of the first chunk are removed from the cache
+	ASSERT_TRUE(obtained->isErroneousResponse());
+	ASSERT_EQ(sentChunks.size(), size_t(2));
+	size_t numEventsSent = 0;
+	for (const auto& eventName : eventNames)
+	{
+		if (sentChunks[0].find("=" + eventName + "&") != std::string::npos)
+		{
+			numEventsSent++;
+		}
+	}
+	auto cache = std::static_pointer_cast<caching::BeaconCache>(beaconCache);
+	auto beaconID = target->getSessionNumber();
+	ASSERT_GT(numEventsSent, size_t(0));
+	ASSERT_EQ(cache->getEvents(beaconID).size(), eventNames.size() - numEventsSent);
+	ASSERT_TRUE(cache->getEventsBeingSent(beaconID).empty());
+	ASSERT_TRUE(cache->getActionsBeingSent(beaconID).empty());
+
+	// and when sending once more
+	sentChunks.clear();
+	target->send(mockHTTPClientProvider);
+
+	// then the remaining events are sent, starting with the failed chunk
+	ASSERT_TRUE(target->isEmpty());
+	ASSERT_NE(sentChunks[0].find("=" + eventNames[numEventsSent] + "&"), std::string::npos);
+}
+
+TEST_F(BeaconTest, storeKeepsTransmissionTimeOutOfStoredChunk)
+{
+	// given
+	char directoryTemplate[] = "/tmp/BeaconTest.XXXXXX";
+	ASSERT_NE(mkdtemp(directoryTemplate), nullptr);
+	caching::BeaconChunkStore chunkStore(logger, directoryTemplate, 1024 * 1024, 0);
+	auto target = buildBeaconWithDefaultConfig();
+	target->reportEvent(1, "storedEvent");
+	ON_CALL(*mockHTTPClientProvider, createClient(testing::_, testing::_))
+		.WillByDefault(testing::Return(mockHTTPClient));
+
+	// when
+	auto obtained = target->store(chunkStore, mockHTTPClientProvider);
+
+	// then the prefix lacks the transmission time, which is added when replaying the chunk
+	ASSERT_TRUE(obtained);
+	ASSERT_TRUE(target->isEmpty());
+	caching::BeaconChunkStore::StoredChunk chunk;
+	ASSERT_TRUE(chunkStore.loadOldest(chunk));
+	auto chunkPrefix = chunk.chunkPrefix.getStringData();
+	auto records = chunk.payload.getBeaconData().getStringData();
+	ASSERT_EQ(chunkPrefix.find("&tx="), std::string::npos);
+	ASSERT_NE(chunkPrefix.find("&tv="), std::string::npos);
+	ASSERT_EQ(records.find("&tx="), std::string::npos);
+	ASSERT_EQ(records.find("&"), size_t(0));
+	ASSERT_NE(records.find("=storedEvent"), std::string::npos);
+
+	chunkStore.remove(chunk.sequenceNumber);
+	rmdir(directoryTemplate);
+}
+
+TEST_F(BeaconTest, beaconIsCapturingIfCaptureIsOnAndDataCollectionIsNotOff)
+{
+	// given
+	auto target = buildBeacon(openkit::DataCollectionLevel::PERFORMANCE, openkit::CrashReportingLevel::OFF, 1, APP_ID);
+
+	// then
+	ASSERT_TRUE(target->isCapturing());
+}
+
+TEST_F(BeaconTest, beaconIsNotCapturingIfCaptureIsOff)
+{
+	// given
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES, 1, APP_ID);
+
+	// when
+	getConfiguration()->disableCapture();
+
+	// then
+	ASSERT_FALSE(target->isCapturing());
+
+	// and when
+	getConfiguration()->enableCapture();
+
+	// then
+	ASSERT_TRUE(target->isCapturing());
+}
+
+TEST_F(BeaconTest, beaconIsNotCapturingIfDataCollectionLevelIsOff)
+{
+	// given
+	auto target = buildBeacon(openkit::DataCollectionLevel::OFF, openkit::CrashReportingLevel::OFF, 1, APP_ID);
+
+	// then
+	ASSERT_FALSE(target->isCapturing());
+}
+
+TEST_F(BeaconTest, capturingFollowsDataCollectionLevelOfUpdatedBeaconConfiguration)
+{
+	// given
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF, 1, APP_ID);
+
+	// when
+	target->setBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(1, openkit::DataCollectionLevel::OFF, openkit::CrashReportingLevel::OFF));
+
+	// then
+	ASSERT_FALSE(target->isCapturing());
+
+	// and when
+	target->setBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(1, openkit::DataCollectionLevel::PERFORMANCE, openkit::CrashReportingLevel::OFF));
+
+	// then
+	ASSERT_TRUE(target->isCapturing());
+}
+
+TEST_F(BeaconTest, crashReportingFollowsCrashReportingLevelOfUpdatedBeaconConfiguration)
+{
+	// given
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF, 1, APP_ID);
+	target->reportCrash(core::UTF8String("OutOfMemory exception"), core::UTF8String("insufficient memory"), core::UTF8String("stacktrace:123"));
+	ASSERT_TRUE(target->isEmpty());
+
+	// when
+	target->setBeaconConfiguration(std::make_shared<configuration::BeaconConfiguration>(1, openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES));
+	target->reportCrash(core::UTF8String("OutOfMemory exception"), core::UTF8String("insufficient memory"), core::UTF8String("stacktrace:123"));
+
+	// then
+	ASSERT_FALSE(target->isEmpty());
+}
+
+TEST_F(BeaconTest, noDataIsAddedToCacheIfCaptureIsOff)
+{
+	// given
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OPT_IN_CRASHES, 1, APP_ID);
+	getConfiguration()->disableCapture();
+
+	// when
+	target->reportEvent(1, "event");
+	target->reportValue(1, "value", 42);
+	target->reportError(1, "error", 42, "reason");
+	target->reportCrash("crash", "reason", "stacktrace");
+	target->identifyUser("user");
+
+	// then
+	ASSERT_TRUE(target->isEmpty());
+}
+
+TEST_F(BeaconTest, reportValuesSerializesSameEventDataAsSingleReports)
+{
+	// given
+	std::vector<core::UTF8String> singleData;
+	auto singleBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*singleBeaconCache, addEventData(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::Invoke([&singleData](int32_t, int64_t, const core::UTF8String& data) { singleData.push_back(data); }));
+	beaconCache = singleBeaconCache;
+	auto singleTarget = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	std::vector<core::UTF8String> batchData;
+	auto batchBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*batchBeaconCache, addEventDataBatch(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::SaveArg<2>(&batchData));
+	beaconCache = batchBeaconCache;
+	auto batchTarget = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	openkit::ReportedValue values[] = {
+		openkit::ReportedValue::event("event"),
+		openkit::ReportedValue::value("int", 42),
+		openkit::ReportedValue::value("double", 3.125),
+		openkit::ReportedValue::value("string", "value")
+	};
+
+	// when
+	singleTarget->reportEvent(1, "event");
+	singleTarget->reportValue(1, "int", 42);
+	singleTarget->reportValue(1, "double", 3.125);
+	singleTarget->reportValue(1, "string", "value");
+	batchTarget->reportValues(1, values, 4);
+
+	// then
+	ASSERT_EQ(batchData.size(), size_t(4));
+	ASSERT_EQ(singleData.size(), batchData.size());
+	for (size_t i = 0; i < batchData.size(); i++)
+	{
+		ASSERT_TRUE(batchData[i].equals(singleData[i]));
+	}
+}
+
+TEST_F(BeaconTest, reportValuesTakesOneTimestampAndOneCacheInsertion)
+{
+	// given
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	beaconCache = mockBeaconCache;
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+	auto timingProviderMock = getTimingProviderMock();
+
+	openkit::ReportedValue values[] = {
+		openkit::ReportedValue::value("a", 1),
+		openkit::ReportedValue::value("b", 2),
+		openkit::ReportedValue::value("c", 3)
+	};
+
+	// expect
+	EXPECT_CALL(*timingProviderMock, provideTimestampInMilliseconds())
+		.Times(1);
+	EXPECT_CALL(*mockBeaconCache, addEventDataBatch(testing::_, testing::_, testing::SizeIs(3)))
+		.Times(1);
+	EXPECT_CALL(*mockBeaconCache, addEventData(testing::_, testing::_, testing::_))
+		.Times(0);
+
+	// when
+	target->reportValues(1, values, 3);
+}
+
+TEST_F(BeaconTest, reportValuesSkipsEntriesWithoutNameAndKeepsSequenceNumbersConsecutive)
+{
+	// given
+	std::vector<core::UTF8String> batchData;
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, addEventDataBatch(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::SaveArg<2>(&batchData));
+	beaconCache = mockBeaconCache;
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	openkit::ReportedValue values[] = {
+		openkit::ReportedValue::event("first"),
+		openkit::ReportedValue::event(nullptr),
+		openkit::ReportedValue::value("", 1),
+		openkit::ReportedValue::event("second")
+	};
+
+	// when
+	target->reportValues(1, values, 4);
+
+	// then
+	ASSERT_EQ(batchData.size(), size_t(2));
+	ASSERT_TRUE(batchData[0].getStringData().find("&s0=1&") != std::string::npos);
+	ASSERT_TRUE(batchData[1].getStringData().find("&s0=2&") != std::string::npos);
+	ASSERT_EQ(target->createSequenceNumber(), 3);
+}
+
+TEST_F(BeaconTest, reportValuesDoesNotReportOnDataCollectionLevel1)
+{
+	// given
+	auto target = buildBeacon(openkit::DataCollectionLevel::PERFORMANCE, openkit::CrashReportingLevel::OFF);
+	openkit::ReportedValue values[] = { openkit::ReportedValue::value("int", 42) };
+
+	// when
+	target->reportValues(1, values, 1);
+
+	// then
+	ASSERT_TRUE(target->isEmpty());
+}
+
+TEST_F(BeaconTest, eventDroppedBySamplingIsNotSerialized)
+{
+	// given
+	eventSampler = std::make_shared<protocol::EventSampler>(std::vector<openkit::SamplingRule>{ { openkit::SampledEventType::NAMED_EVENT, "event", 0.0, 0.0 } }, getTimingProviderMock());
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	// when
+	target->reportEvent(1, "event");
+
+	// then
+	ASSERT_TRUE(target->isEmpty());
+	ASSERT_EQ(target->createSequenceNumber(), 1);
+}
+
+TEST_F(BeaconTest, sampledRecordCarriesSampleRate)
+{
+	// given
+	std::vector<core::UTF8String> eventData;
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, addEventData(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::Invoke([&eventData](int32_t, int64_t, const core::UTF8String& data) { eventData.push_back(data); }));
+	beaconCache = mockBeaconCache;
+	eventSampler = std::make_shared<protocol::EventSampler>(std::vector<openkit::SamplingRule>{ { openkit::SampledEventType::VALUE, "value", 1.0, 2.0 } }, getTimingProviderMock());
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	// when
+	target->reportValue(1, "value", 1);
+	target->reportValue(1, "value", 2);
+	target->reportValue(1, "value", 3);
+	target->reportValue(1, "other", 4);
+
+	// then the third record of the rate limited value is dropped, the other records are kept completely
+	ASSERT_EQ(eventData.size(), size_t(3));
+	ASSERT_EQ(eventData[0].getStringData().find("&sr="), std::string::npos);
+	ASSERT_EQ(eventData[1].getStringData().find("&sr="), std::string::npos);
+	ASSERT_EQ(eventData[2].getStringData().find("&sr="), std::string::npos);
+
+	// and when half a second passed, the next kept record stands for itself and the dropped one
+	ON_CALL(*getTimingProviderMock(), provideTimestampInMilliseconds()).WillByDefault(testing::Return(500));
+	target->reportValue(1, "value", 5);
+
+	// then
+	ASSERT_EQ(eventData.size(), size_t(4));
+	ASSERT_NE(eventData[3].getStringData().find("&vl=5&sr=0.5"), std::string::npos);
+}
+
+TEST_F(BeaconTest, webRequestsAreSampledBeforeTheyAreTraced)
+{
+	// given
+	std::vector<core::UTF8String> eventData;
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, addEventData(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::Invoke([&eventData](int32_t, int64_t, const core::UTF8String& data) { eventData.push_back(data); }));
+	beaconCache = mockBeaconCache;
+	ON_CALL(*getMockedRandomGenerator(), nextInt64(testing::_)).WillByDefault(testing::Return(0));
+	eventSampler = std::make_shared<protocol::EventSampler>(std::vector<openkit::SamplingRule>{
+			{ openkit::SampledEventType::WEB_REQUEST, "http://example.com/dropped", 0.0, 0.0 },
+			{ openkit::SampledEventType::WEB_REQUEST, "http://example.com/sampled", 0.5, 0.0 } },
+		getTimingProviderMock(), getMockedRandomGenerator());
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+	auto rootAction = std::make_shared<core::RootAction>(getLogger(), target, core::UTF8String("root action"), nullptr);
+	auto sequenceNumber = target->createSequenceNumber();
+
+	// when a dropped web request is traced, the rule applying to the URL without query
+	auto dropped = rootAction->traceWebRequest("http://example.com/dropped?query=1");
+
+	// then it gets no tag, no sequence number or anything else of a traced web request
+	ASSERT_NE(nullptr, std::dynamic_pointer_cast<core::NullWebRequestTracer>(dropped));
+	ASSERT_EQ(target->createSequenceNumber(), sequenceNumber + 1);
+
+	// and when a sampled web request is traced and stopped
+	auto sampled = rootAction->traceWebRequest("http://example.com/sampled");
+	auto sampledTracer = std::dynamic_pointer_cast<core::WebRequestTracer>(sampled);
+	ASSERT_NE(nullptr, sampledTracer);
+	ASSERT_EQ(sampledTracer->getSampleRate(), 0.5);
+	sampled->stop(200);
+
+	// then its record carries the rate it was sampled with when it was traced
+	ASSERT_EQ(eventData.size(), size_t(1));
+	ASSERT_NE(eventData[0].getStringData().find("&sr=0.5"), std::string::npos);
+}
+
+TEST_F(BeaconTest, aggregatedValuesAreWrittenAsOneRecordWhenActionIsLeft)
+{
+	// given
+	std::vector<core::UTF8String> eventData;
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, addEventData(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::Invoke([&eventData](int32_t, int64_t, const core::UTF8String& data) { eventData.push_back(data); }));
+	beaconCache = mockBeaconCache;
+	valueAggregationInterval = 0;
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+	auto actionMock = createMockedAction(target);
+	ON_CALL(*actionMock, getID()).WillByDefault(testing::Return(1));
+
+	// when
+	target->reportValue(1, "int", 5);
+	target->reportValue(1, "int", -2);
+	target->reportValue(1, "int", 7);
+	target->reportValue(1, "double", 1.5);
+
+	// then nothing is written while the action is open
+	ASSERT_TRUE(eventData.empty());
+
+	// and when the action is left
+	target->addAction(actionMock);
+
+	// then one record per name is written in the order the names were first reported
+	ASSERT_EQ(eventData.size(), size_t(2));
+	ASSERT_NE(eventData[0].getStringData().find("et=12&na=int&"), std::string::npos);
+	ASSERT_NE(eventData[0].getStringData().find("&pa=1&s0=2&"), std::string::npos);
+	ASSERT_NE(eventData[0].getStringData().find("&vl=7&vc=3&vmn=-2&vmx=7&vs=10"), std::string::npos);
+	ASSERT_NE(eventData[1].getStringData().find("et=13&na=double&"), std::string::npos);
+	ASSERT_NE(eventData[1].getStringData().find("&s0=3&"), std::string::npos);
+	ASSERT_EQ(eventData[1].getStringData().find("&vc="), std::string::npos);
+}
+
+TEST_F(BeaconTest, aggregatedValuesAreWrittenWhenFlushIntervalExpired)
+{
+	// given
+	std::vector<core::UTF8String> eventData;
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, addEventData(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::Invoke([&eventData](int32_t, int64_t, const core::UTF8String& data) { eventData.push_back(data); }));
+	beaconCache = mockBeaconCache;
+	valueAggregationInterval = 1000;
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	// when
+	target->reportValue(1, "double", 1.0);
+	ON_CALL(*getTimingProviderMock(), provideTimestampInMilliseconds()).WillByDefault(testing::Return(999));
+	target->reportValue(1, "double", 3.0);
+
+	// then
+	ASSERT_TRUE(eventData.empty());
+
+	// and when the flush interval expired
+	ON_CALL(*getTimingProviderMock(), provideTimestampInMilliseconds()).WillByDefault(testing::Return(1000));
+	target->reportValue(1, "double", 2.0);
+
+	// then
+	ASSERT_EQ(eventData.size(), size_t(1));
+	ASSERT_NE(eventData[0].getStringData().find("&vl=2.000000&vc=3&vmn=1.000000&vmx=3.000000&vs=6.000000"), std::string::npos);
+}
+
+TEST_F(BeaconTest, valuesOfSampledNamesAreNotAggregated)
+{
+	// given
+	std::vector<core::UTF8String> eventData;
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, addEventData(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::Invoke([&eventData](int32_t, int64_t, const core::UTF8String& data) { eventData.push_back(data); }));
+	beaconCache = mockBeaconCache;
+	ON_CALL(*getMockedRandomGenerator(), nextInt64(testing::_)).WillByDefault(testing::Return(0));
+	eventSampler = std::make_shared<protocol::EventSampler>(std::vector<openkit::SamplingRule>{ { openkit::SampledEventType::VALUE, "sampled", 0.5, 0.0 } },
+		getTimingProviderMock(), getMockedRandomGenerator());
+	valueAggregationInterval = 0;
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	// when
+	target->reportValue(1, "sampled", 1);
+	target->reportValue(1, "aggregated", 1);
+
+	// then
+	ASSERT_EQ(eventData.size(), size_t(1));
+	ASSERT_NE(eventData[0].getStringData().find("na=sampled"), std::string::npos);
+}
+
+TEST_F(BeaconTest, reportValuesAggregatesNumericValues)
+{
+	// given
+	std::vector<core::UTF8String> batchData;
+	auto mockBeaconCache = std::make_shared<testing::NiceMock<test::MockBeaconCache>>();
+	ON_CALL(*mockBeaconCache, addEventDataBatch(testing::_, testing::_, testing::_))
+		.WillByDefault(testing::SaveArg<2>(&batchData));
+	beaconCache = mockBeaconCache;
+	valueAggregationInterval = 0;
+	auto target = buildBeacon(openkit::DataCollectionLevel::USER_BEHAVIOR, openkit::CrashReportingLevel::OFF);
+
+	openkit::ReportedValue values[] = {
+		openkit::ReportedValue::value("int", 42),
+		openkit::ReportedValue::value("double", 4.2),
+		openkit::ReportedValue::value("string", "42")
+	};
+
+	// when
+	target->reportValues(1, values, 3);
+
+	// then only the string value is written right away
+	ASSERT_EQ(batchData.size(), size_t(1));
+	ASSERT_NE(batchData[0].getStringData().find("na=string"), std::string::npos);
+}
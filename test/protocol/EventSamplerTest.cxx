@@ -0,0 +1,190 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "protocol/EventSampler.h"
+
+#include "../providers/MockPRNGenerator.h"
+#include "../providers/MockTimingProvider.h"
+
+#include <string>
+#include <vector>
+
+using namespace protocol;
+
+class EventSamplerTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mCurrentTime = 0;
+		mMockTimingProvider = std::make_shared<testing::NiceMock<test::MockTimingProvider>>();
+		ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+			.WillByDefault(testing::Invoke([this]() { return mCurrentTime; }));
+
+		mMockRandomGenerator = std::make_shared<testing::NiceMock<test::MockPRNGenerator>>();
+		mRandomNumber = 0;
+		ON_CALL(*mMockRandomGenerator, nextInt64(testing::_))
+			.WillByDefault(testing::Invoke([this](int64_t upperBound) { return mRandomNumber * upperBound / 100; }));
+	}
+
+	std::shared_ptr<EventSampler> createSampler(const std::vector<openkit::SamplingRule>& rules)
+	{
+		return std::make_shared<EventSampler>(rules, mMockTimingProvider, mMockRandomGenerator);
+	}
+
+	static openkit::SamplingRule rule(openkit::SampledEventType eventType, const char* name, double sampleRate, double maxEventsPerSecond)
+	{
+		return { eventType, name != nullptr ? name : "", sampleRate, maxEventsPerSecond };
+	}
+
+	int64_t mCurrentTime;
+	// random number in percent of the requested upper bound
+	int64_t mRandomNumber;
+	std::shared_ptr<testing::NiceMock<test::MockTimingProvider>> mMockTimingProvider;
+	std::shared_ptr<testing::NiceMock<test::MockPRNGenerator>> mMockRandomGenerator;
+};
+
+TEST_F(EventSamplerTest, recordsWithoutRuleAreKept)
+{
+	// given
+	auto target = createSampler({ rule(openkit::SampledEventType::VALUE, "value", 0.0, 0.0) });
+
+	// then
+	ASSERT_EQ(target->sample(openkit::SampledEventType::NAMED_EVENT, "value"), 1.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::VALUE, "other value"), 1.0);
+}
+
+TEST_F(EventSamplerTest, recordsAreKeptWithSampleRate)
+{
+	// given
+	auto target = createSampler({ rule(openkit::SampledEventType::NAMED_EVENT, "event", 0.25, 0.0) });
+
+	// when the random number is below the sample rate
+	mRandomNumber = 24;
+
+	// then
+	ASSERT_EQ(target->sample(openkit::SampledEventType::NAMED_EVENT, "event"), 0.25);
+
+	// when the random number is not below the sample rate
+	mRandomNumber = 25;
+
+	// then
+	ASSERT_EQ(target->sample(openkit::SampledEventType::NAMED_EVENT, "event"), 0.0);
+}
+
+TEST_F(EventSamplerTest, ruleWithNameTakesPrecedenceOverRuleWithoutName)
+{
+	// given
+	auto target = createSampler({
+		rule(openkit::SampledEventType::WEB_REQUEST, nullptr, 0.0, 0.0),
+		rule(openkit::SampledEventType::WEB_REQUEST, "http://example.com/", 1.0, 0.0)
+	});
+
+	// then
+	ASSERT_EQ(target->sample(openkit::SampledEventType::WEB_REQUEST, "http://example.com/"), 1.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::WEB_REQUEST, "http://example.com/other"), 0.0);
+}
+
+TEST_F(EventSamplerTest, rateLimitKeepsBurstAndRefillsOverTime)
+{
+	// given
+	auto target = createSampler({ rule(openkit::SampledEventType::REPORTED_ERROR, "error", 1.0, 2.0) });
+
+	// then the bucket holds one second of records
+	ASSERT_EQ(target->sample(openkit::SampledEventType::REPORTED_ERROR, "error"), 1.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::REPORTED_ERROR, "error"), 1.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::REPORTED_ERROR, "error"), 0.0);
+
+	// and when half a second passed
+	mCurrentTime = 500;
+
+	// then one record is kept, which stands for itself and the dropped third record
+	ASSERT_EQ(target->sample(openkit::SampledEventType::REPORTED_ERROR, "error"), 0.5);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::REPORTED_ERROR, "error"), 0.0);
+}
+
+TEST_F(EventSamplerTest, ruleWithoutNameLimitsEachNameSeparately)
+{
+	// given
+	auto target = createSampler({ rule(openkit::SampledEventType::NAMED_EVENT, nullptr, 1.0, 1.0) });
+
+	// then
+	ASSERT_EQ(target->sample(openkit::SampledEventType::NAMED_EVENT, "a"), 1.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::NAMED_EVENT, "a"), 0.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::NAMED_EVENT, "b"), 1.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::NAMED_EVENT, "b"), 0.0);
+}
+
+TEST_F(EventSamplerTest, namesBeyondTableCapacityShareRateLimit)
+{
+	// given
+	auto target = createSampler({ rule(openkit::SampledEventType::VALUE, nullptr, 1.0, 1.0) });
+	for (size_t i = 0; i < EventSampler::MAX_NAMES_PER_RULE; i++)
+	{
+		ASSERT_EQ(target->sample(openkit::SampledEventType::VALUE, "value" + std::to_string(i)), 1.0);
+	}
+
+	// then the first name beyond the capacity takes the shared bucket's token
+	ASSERT_EQ(target->sample(openkit::SampledEventType::VALUE, "overflow1"), 1.0);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::VALUE, "overflow2"), 0.0);
+}
+
+TEST_F(EventSamplerTest, sampleRateAndRateLimitAreCombined)
+{
+	// given
+	auto target = createSampler({ rule(openkit::SampledEventType::VALUE, "value", 0.5, 1.0) });
+	mRandomNumber = 0;
+
+	// then
+	ASSERT_EQ(target->sample(openkit::SampledEventType::VALUE, "value"), 0.5);
+	ASSERT_EQ(target->sample(openkit::SampledEventType::VALUE, "value"), 0.0);
+
+	// and when one second passed
+	mCurrentTime = 1000;
+
+	// then the kept record also stands for the dropped one
+	ASSERT_EQ(target->sample(openkit::SampledEventType::VALUE, "value"), 0.5 / 2);
+}
+
+TEST_F(EventSamplerTest, scalingKeptRecordsUpGivesNumberOfRecordsOfBurst)
+{
+	// given a limit of ten records per second
+	auto target = createSampler({ rule(openkit::SampledEventType::REPORTED_ERROR, "error", 1.0, 10.0) });
+
+	// when a burst of 1000 records is reported after an idle period, and another record a second later
+	double scaledCount = 0.0;
+	size_t numKept = 0;
+	for (int i = 0; i < 1000; i++)
+	{
+		auto rate = target->sample(openkit::SampledEventType::REPORTED_ERROR, "error");
+		if (rate > 0.0)
+		{
+			scaledCount += 1.0 / rate;
+			numKept++;
+		}
+	}
+	mCurrentTime = 1000;
+	auto rate = target->sample(openkit::SampledEventType::REPORTED_ERROR, "error");
+	ASSERT_GT(rate, 0.0);
+	scaledCount += 1.0 / rate;
+
+	// then
+	ASSERT_EQ(numKept, size_t(10));
+	ASSERT_DOUBLE_EQ(scaledCount, 1001.0);
+}
@@ -0,0 +1,125 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+
+#include "configuration/HTTPClientConfiguration.h"
+#include "protocol/HTTPClient.h"
+#include "protocol/UploadRateLimiter.h"
+#include "protocol/ssl/SSLBlindTrustManager.h"
+#include "providers/DefaultTimingProvider.h"
+
+#include "LocalHTTPServer.h"
+#include "NullLogger.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace protocol;
+
+class HTTPClientTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<NullLogger>();
+
+		ASSERT_TRUE(mServer.start());
+		mServer.setResponse(200, "type=m&si=120&id=5");
+
+		mTransferDeadline = std::make_shared<TransferDeadline>();
+		auto retryPolicy = std::make_shared<configuration::RetryPolicy>(1000, 10000, -1, 1000, 1000);
+		auto configuration = std::make_shared<configuration::HTTPClientConfiguration>(core::UTF8String(mServer.getBaseURL().c_str()), 1,
+			core::UTF8String("app-id"), std::make_shared<SSLBlindTrustManager>(), retryPolicy, nullptr, nullptr, mTransferDeadline);
+		mClient = std::make_shared<HTTPClient>(mLogger, configuration);
+	}
+
+	void TearDown()
+	{
+		mServer.stop();
+	}
+
+	std::shared_ptr<openkit::ILogger> mLogger;
+	test::LocalHTTPServer mServer;
+	std::shared_ptr<TransferDeadline> mTransferDeadline;
+	std::shared_ptr<HTTPClient> mClient;
+};
+
+TEST_F(HTTPClientTest, requestIsSentIfNoTransferDeadlineIsSet)
+{
+	// when
+	auto response = mClient->sendStatusRequest();
+
+	// then
+	ASSERT_TRUE(response->isSuccessfulResponse());
+	ASSERT_EQ(mServer.getRequests().size(), size_t(1));
+}
+
+TEST_F(HTTPClientTest, requestIsNotSentOnceTransferDeadlineExpired)
+{
+	// given
+	mTransferDeadline->expireAfter(0);
+
+	// when
+	auto response = mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("et=1"));
+
+	// then
+	ASSERT_TRUE(response->isErroneousResponse());
+	ASSERT_EQ(mServer.getNumConnections(), uint32_t(0));
+}
+
+TEST_F(HTTPClientTest, requestInFlightIsAbortedWhenTransferDeadlineExpires)
+{
+	// given
+	mServer.setResponseDelay(4000);
+	auto start = std::chrono::steady_clock::now();
+	auto request = std::async(std::launch::async, [this]() { return mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("et=1")); });
+	// give the request enough time to be sent, the server delays the response
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+	// when
+	mTransferDeadline->expireAfter(0);
+	auto response = request.get();
+
+	// then
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+	ASSERT_TRUE(response->isErroneousResponse());
+	ASSERT_LT(duration.count(), 3000);
+}
+
+TEST_F(HTTPClientTest, timeWaitingForUploadRateLimitIsReported)
+{
+	// given
+	auto uploadRateLimiter = std::make_shared<UploadRateLimiter>(std::make_shared<providers::DefaultTimingProvider>(), 1000, 1000);
+	auto retryPolicy = std::make_shared<configuration::RetryPolicy>(1000, 10000, -1, 1000, 1000);
+	auto configuration = std::make_shared<configuration::HTTPClientConfiguration>(core::UTF8String(mServer.getBaseURL().c_str()), 1,
+		core::UTF8String("app-id"), std::make_shared<SSLBlindTrustManager>(), retryPolicy, nullptr, uploadRateLimiter);
+	HTTPClient target(mLogger, configuration);
+
+	// when, the uncompressed payload exceeds the burst by 500 bytes
+	auto response = target.sendEncodedBeaconRequest(core::UTF8String(), BeaconPayload(core::UTF8String(std::string(1500, 'x'))));
+
+	// then
+	ASSERT_TRUE(response->isSuccessfulResponse());
+	ASSERT_GE(target.getLastRequestThrottledTime(), int64_t(400));
+
+	// when
+	target.sendStatusRequest();
+
+	// then
+	ASSERT_EQ(target.getLastRequestThrottledTime(), int64_t(0));
+}
@@ -120,7 +120,7 @@ TEST_F(HTTPResponseParserTest, parsingColonSeparatedLineWorks)
 {
 	// given
 	auto target = HTTPResponseParser();
-	auto headerString = std::string("content-length:42");
+	auto headerString = std::string("retry-after:42");
 
 	// when adding the line
 	auto obtained = target.responseHeaderData(headerString.data(), sizeof(std::string::value_type), headerString.length());
@@ -130,15 +130,15 @@ TEST_F(HTTPResponseParserTest, parsingColonSeparatedLineWorks)
 
 	auto obtainedHeaders = target.getResponseHeaders();
 	ASSERT_FALSE(obtainedHeaders.empty());
-	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("content-length"));
-	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("content-length")->second);
+	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("retry-after"));
+	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("retry-after")->second);
 }
 
 TEST_F(HTTPResponseParserTest, keyIsTransformedToLowerCase)
 {
 	// given
 	auto target = HTTPResponseParser();
-	auto headerString = std::string("Content-Length:42");
+	auto headerString = std::string("Retry-After:42");
 
 	// when adding the line
 	auto obtained = target.responseHeaderData(headerString.data(), sizeof(std::string::value_type), headerString.length());
@@ -147,15 +147,15 @@ TEST_F(HTTPResponseParserTest, keyIsTransformedToLowerCase)
 	ASSERT_EQ(headerString.length(), obtained);
 
 	auto obtainedHeaders = target.getResponseHeaders();
-	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("content-length"));
-	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("content-length")->second);
+	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("retry-after"));
+	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("retry-after")->second);
 }
 
 TEST_F(HTTPResponseParserTest, optionalWhitespacheFromValuesAreStripped)
 {
 	// given
 	auto target = HTTPResponseParser();
-	auto headerString = std::string("Content-Length: \t 42\t\t ");
+	auto headerString = std::string("Retry-After: \t 42\t\t ");
 
 	// when adding the line
 	auto obtained = target.responseHeaderData(headerString.data(), sizeof(std::string::value_type), headerString.length());
@@ -164,15 +164,15 @@ TEST_F(HTTPResponseParserTest, optionalWhitespacheFromValuesAreStripped)
 	ASSERT_EQ(headerString.length(), obtained);
 
 	auto obtainedHeaders = target.getResponseHeaders();
-	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("content-length"));
-	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("content-length")->second);
+	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("retry-after"));
+	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("retry-after")->second);
 }
 
 TEST_F(HTTPResponseParserTest, trailingCRLFIsStripped)
 {
 	// given
 	auto target = HTTPResponseParser();
-	auto headerString = std::string("Content-Length: 42\r\n");
+	auto headerString = std::string("Retry-After: 42\r\n");
 
 	// when adding the line
 	auto obtained = target.responseHeaderData(headerString.data(), sizeof(std::string::value_type), headerString.length());
@@ -181,16 +181,16 @@ TEST_F(HTTPResponseParserTest, trailingCRLFIsStripped)
 	ASSERT_EQ(headerString.length(), obtained);
 
 	auto obtainedHeaders = target.getResponseHeaders();
-	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("content-length"));
-	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("content-length")->second);
+	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("retry-after"));
+	ASSERT_EQ(std::vector<std::string>{"42"}, obtainedHeaders.find("retry-after")->second);
 }
 
 TEST_F(HTTPResponseParserTest, multipleLinesWithSimilarKeyMergesValues)
 {
 	// given
 	auto target = HTTPResponseParser();
-	auto headerStringOne = std::string("Set-Cookie:Test=test_value\r\n");
-	auto headerStringTwo = std::string("set-cookie: foo=bar\r\n");
+	auto headerStringOne = std::string("Retry-After:120\r\n");
+	auto headerStringTwo = std::string("retry-after: 60\r\n");
 
 	// when adding the lines
 	auto obtainedOne = target.responseHeaderData(headerStringOne.data(), sizeof(std::string::value_type), headerStringOne.length());
@@ -201,6 +201,37 @@ TEST_F(HTTPResponseParserTest, multipleLinesWithSimilarKeyMergesValues)
 	ASSERT_EQ(headerStringTwo.length(), obtainedTwo);
 
 	auto obtainedHeaders = target.getResponseHeaders();
-	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("set-cookie"));
-	ASSERT_THAT(obtainedHeaders.find("set-cookie")->second, testing::ElementsAre(std::string("Test=test_value"), std::string("foo=bar")));
+	ASSERT_NE(obtainedHeaders.end(), obtainedHeaders.find("retry-after"));
+	ASSERT_THAT(obtainedHeaders.find("retry-after")->second, testing::ElementsAre(std::string("120"), std::string("60")));
+}
+
+TEST_F(HTTPResponseParserTest, headersNotEvaluatedByOpenKitAreSkipped)
+{
+	// given
+	auto target = HTTPResponseParser();
+	auto headerStringOne = std::string("Content-Length: 42\r\n");
+	auto headerStringTwo = std::string("Set-Cookie: foo=bar\r\n");
+
+	// when adding the lines
+	auto obtainedOne = target.responseHeaderData(headerStringOne.data(), sizeof(std::string::value_type), headerStringOne.length());
+	auto obtainedTwo = target.responseHeaderData(headerStringTwo.data(), sizeof(std::string::value_type), headerStringTwo.length());
+
+	// then
+	ASSERT_EQ(headerStringOne.length(), obtainedOne);
+	ASSERT_EQ(headerStringTwo.length(), obtainedTwo);
+	ASSERT_TRUE(target.getResponseHeaders().empty());
+}
+
+TEST_F(HTTPResponseParserTest, headerKeyWhichIsOnlyAPrefixOfARelevantKeyIsSkipped)
+{
+	// given
+	auto target = HTTPResponseParser();
+	auto headerString = std::string("Retry: 42\r\n");
+
+	// when adding the line
+	auto obtained = target.responseHeaderData(headerString.data(), sizeof(std::string::value_type), headerString.length());
+
+	// then
+	ASSERT_EQ(headerString.length(), obtained);
+	ASSERT_TRUE(target.getResponseHeaders().empty());
 }
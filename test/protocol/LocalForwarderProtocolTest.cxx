@@ -0,0 +1,111 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "gtest/gtest.h"
+
+#include "protocol/LocalForwarderProtocol.h"
+
+using namespace protocol;
+
+TEST(LocalForwarderProtocolTest, requestIsDecodedAsEncoded)
+{
+	// given
+	LocalForwarderProtocol::ForwardedRequest request = { LocalForwarderProtocol::RequestType::BEACON, "type=m&srvid=1", "127.0.0.1", std::string("et=1&na=a\0b", 11) };
+	std::string payload;
+
+	// when
+	LocalForwarderProtocol::encodeRequest(request, payload);
+	LocalForwarderProtocol::ForwardedRequest obtained;
+	auto isDecoded = LocalForwarderProtocol::decodeRequest(payload, obtained);
+
+	// then
+	ASSERT_TRUE(isDecoded);
+	ASSERT_EQ(obtained.requestType, LocalForwarderProtocol::RequestType::BEACON);
+	ASSERT_EQ(obtained.query, request.query);
+	ASSERT_EQ(obtained.clientIPAddress, request.clientIPAddress);
+	ASSERT_EQ(obtained.beaconData, request.beaconData);
+}
+
+TEST(LocalForwarderProtocolTest, responseIsDecodedAsEncoded)
+{
+	// given
+	LocalForwarderProtocol::ForwardedResponse response;
+	response.responseCode = 429;
+	response.responseBody = "type=m&si=120";
+	response.responseHeaders["retry-after"] = { "123" };
+	std::string payload;
+
+	// when
+	LocalForwarderProtocol::encodeResponse(response, payload);
+	LocalForwarderProtocol::ForwardedResponse obtained;
+	auto isDecoded = LocalForwarderProtocol::decodeResponse(payload, obtained);
+
+	// then
+	ASSERT_TRUE(isDecoded);
+	ASSERT_EQ(obtained.responseCode, 429);
+	ASSERT_EQ(obtained.responseBody, response.responseBody);
+	ASSERT_EQ(obtained.responseHeaders, response.responseHeaders);
+}
+
+TEST(LocalForwarderProtocolTest, truncatedRequestIsRejected)
+{
+	// given
+	LocalForwarderProtocol::ForwardedRequest request = { LocalForwarderProtocol::RequestType::STATUS, "type=m", "", "" };
+	std::string payload;
+	LocalForwarderProtocol::encodeRequest(request, payload);
+	payload.pop_back();
+
+	// when
+	LocalForwarderProtocol::ForwardedRequest obtained;
+	auto isDecoded = LocalForwarderProtocol::decodeRequest(payload, obtained);
+
+	// then
+	ASSERT_FALSE(isDecoded);
+}
+
+TEST(LocalForwarderProtocolTest, unknownRequestTypeIsRejected)
+{
+	// given
+	LocalForwarderProtocol::ForwardedRequest request = { LocalForwarderProtocol::RequestType::STATUS, "type=m", "", "" };
+	std::string payload;
+	LocalForwarderProtocol::encodeRequest(request, payload);
+	payload[1] = 42;
+
+	// when
+	LocalForwarderProtocol::ForwardedRequest obtained;
+	auto isDecoded = LocalForwarderProtocol::decodeRequest(payload, obtained);
+
+	// then
+	ASSERT_FALSE(isDecoded);
+}
+
+TEST(LocalForwarderProtocolTest, otherProtocolVersionIsRejected)
+{
+	// given
+	LocalForwarderProtocol::ForwardedResponse response;
+	response.responseCode = 200;
+	std::string payload;
+	LocalForwarderProtocol::encodeResponse(response, payload);
+	payload[0] = static_cast<char>(LocalForwarderProtocol::PROTOCOL_VERSION + 1);
+
+	// when
+	LocalForwarderProtocol::ForwardedResponse obtained;
+	auto isDecoded = LocalForwarderProtocol::decodeResponse(payload, obtained);
+
+	// then
+	ASSERT_FALSE(isDecoded);
+}
@@ -0,0 +1,323 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "gtest/gtest.h"
+
+#include "configuration/HTTPClientConfiguration.h"
+#include "protocol/LocalForwarder.h"
+#include "protocol/LocalSocketHTTPClient.h"
+#include "protocol/ssl/SSLBlindTrustManager.h"
+
+#include "LocalHTTPServer.h"
+#include "NullLogger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+using namespace protocol;
+
+static const char SOCKET_PATH[] = "openkit-forwarder-test.sock";
+static const char APPLICATION_ID[] = "app-id";
+
+class LocalForwarderTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mLogger = std::make_shared<NullLogger>();
+
+		ASSERT_TRUE(mServer.start());
+		mServer.setResponse(200, "type=m&si=120&id=5");
+
+		// retry quickly so that tests with a failing server do not take long
+		mForwarder = createForwarder(10);
+
+		auto clientConfiguration = std::make_shared<configuration::HTTPClientConfiguration>(core::UTF8String("http://unused/mbeacon"), 1,
+			core::UTF8String(APPLICATION_ID));
+		mClient = std::make_shared<LocalSocketHTTPClient>(mLogger, clientConfiguration, SOCKET_PATH);
+	}
+
+	std::unique_ptr<LocalForwarder> createForwarder(int64_t retryDelay, int64_t shutdownTimeout = LocalForwarder::DEFAULT_SHUTDOWN_TIMEOUT)
+	{
+		auto retryPolicy = std::make_shared<configuration::RetryPolicy>(1000, 5000, -1, retryDelay, retryDelay);
+		auto forwarderConfiguration = std::make_shared<configuration::HTTPClientConfiguration>(core::UTF8String(mServer.getBaseURL().c_str()), 1,
+			core::UTF8String(), std::make_shared<SSLBlindTrustManager>(), retryPolicy);
+		return std::unique_ptr<LocalForwarder>(new LocalForwarder(mLogger, forwarderConfiguration, SOCKET_PATH, 2, 64, shutdownTimeout));
+	}
+
+	void TearDown()
+	{
+		mForwarder->stop();
+		mServer.stop();
+	}
+
+	std::shared_ptr<openkit::ILogger> mLogger;
+	test::LocalHTTPServer mServer;
+	std::unique_ptr<LocalForwarder> mForwarder;
+	std::shared_ptr<LocalSocketHTTPClient> mClient;
+};
+
+TEST_F(LocalForwarderTest, statusRequestIsRelayedToServer)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+
+	// when
+	auto obtained = mClient->sendStatusRequest();
+
+	// then
+	ASSERT_EQ(obtained->getResponseCode(), 200);
+	ASSERT_EQ(obtained->getSendInterval(), 120 * 1000);
+	ASSERT_EQ(obtained->getServerID(), 5);
+
+	auto requests = mServer.getRequests();
+	ASSERT_EQ(requests.size(), size_t(1));
+	ASSERT_EQ(requests[0].method, "GET");
+	ASSERT_EQ(requests[0].target.find("/mbeacon?type=m&srvid=1&app=app-id"), size_t(0));
+}
+
+TEST_F(LocalForwarderTest, newSessionRequestIsRelayedToServer)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+
+	// when
+	auto obtained = mClient->sendNewSessionRequest();
+
+	// then
+	ASSERT_EQ(obtained->getResponseCode(), 200);
+	auto requests = mServer.getRequests();
+	ASSERT_EQ(requests.size(), size_t(1));
+	ASSERT_NE(requests[0].target.find("&ns=1"), std::string::npos);
+}
+
+TEST_F(LocalForwarderTest, beaconsAreAcknowledgedAndUploadedCompressed)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+	mClient->sendStatusRequest();
+
+	// when
+	auto first = mClient->sendBeaconRequest(core::UTF8String("10.0.0.1"), core::UTF8String("vv=3&et=1&na=first"));
+	auto second = mClient->sendBeaconRequest(core::UTF8String("10.0.0.1"), core::UTF8String("vv=3&et=1&na=second"));
+
+	// then
+	ASSERT_EQ(first->getResponseCode(), 200);
+	ASSERT_EQ(second->getResponseCode(), 200);
+	ASSERT_EQ(second->getSendInterval(), 120 * 1000);
+
+	ASSERT_TRUE(mServer.waitForRequests(3, 5000));
+	auto requests = mServer.getRequests();
+	ASSERT_EQ(requests[1].method, "POST");
+	ASSERT_EQ(requests[1].headers["content-encoding"], "gzip");
+	ASSERT_EQ(requests[1].headers["x-client-ip"], "10.0.0.1");
+	ASSERT_EQ(requests[1].body, "vv=3&et=1&na=first");
+	ASSERT_EQ(requests[2].body, "vv=3&et=1&na=second");
+
+	// status requests and beacon uploads use one reused connection each
+	ASSERT_EQ(mServer.getNumConnections(), uint32_t(2));
+}
+
+TEST_F(LocalForwarderTest, firstBeaconIsAcknowledgedWithoutWaitingForServer)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+
+	// when
+	auto obtained = mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1"));
+
+	// then
+	ASSERT_EQ(obtained->getResponseCode(), 200);
+	ASSERT_TRUE(mServer.waitForRequests(1, 5000));
+	for (int i = 0; i < 500 && mForwarder->getNumForwardedBeacons() == 0; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	ASSERT_EQ(mForwarder->getNumForwardedBeacons(), uint64_t(1));
+}
+
+TEST_F(LocalForwarderTest, requestsDoNotWaitForSlowUploads)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+	mClient->sendStatusRequest();
+	mServer.setResponseDelay(1000);
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1&na=1"));
+	ASSERT_TRUE(mServer.waitForRequests(2, 5000));
+
+	// when the upload of the first beacon is in flight
+	auto start = std::chrono::steady_clock::now();
+	auto beaconResponse = mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1&na=2"));
+	auto statusResponse = mClient->sendStatusRequest();
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	// then
+	ASSERT_EQ(beaconResponse->getResponseCode(), 200);
+	ASSERT_EQ(statusResponse->getResponseCode(), 200);
+	ASSERT_LT(elapsed, std::chrono::milliseconds(500));
+	mServer.setResponseDelay(0);
+}
+
+TEST_F(LocalForwarderTest, forwarderDoesNotReplaceOtherFilesAtSocketPath)
+{
+	// given
+	std::ofstream(SOCKET_PATH) << "not a socket";
+
+	// when
+	auto obtained = mForwarder->start();
+
+	// then
+	ASSERT_FALSE(obtained);
+	std::ifstream file(SOCKET_PATH);
+	std::string content;
+	std::getline(file, content);
+	ASSERT_EQ(content, "not a socket");
+
+	file.close();
+	std::remove(SOCKET_PATH);
+}
+
+TEST_F(LocalForwarderTest, serverErrorsAreRelayedToClient)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+	mServer.setResponse(429, "");
+
+	// when
+	auto obtained = mClient->sendStatusRequest();
+
+	// then
+	ASSERT_EQ(obtained->getResponseCode(), 429);
+	ASSERT_TRUE(obtained->isTooManyRequestsResponse());
+}
+
+TEST_F(LocalForwarderTest, failedUploadsAreRetried)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+	mClient->sendStatusRequest();
+	mServer.setResponse(503, "");
+
+	// when
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1"));
+	ASSERT_TRUE(mServer.waitForRequests(3, 5000));
+	mServer.setResponse(200, "type=m");
+
+	// then
+	for (int i = 0; i < 500 && mForwarder->getNumForwardedBeacons() == 0; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	ASSERT_EQ(mForwarder->getNumForwardedBeacons(), uint64_t(1));
+	ASSERT_EQ(mForwarder->getNumDroppedBeacons(), uint64_t(0));
+	ASSERT_EQ(mServer.getRequests().back().body, "vv=3&et=1");
+}
+
+TEST_F(LocalForwarderTest, beaconsAreRejectedWhileQueueIsFull)
+{
+	// given
+	mForwarder = createForwarder(60000, 100);
+	ASSERT_TRUE(mForwarder->start());
+	mClient->sendStatusRequest();
+	mServer.setResponse(503, "");
+
+	// when
+	// the first beacon's upload fails and it is kept for retry, at most one beacon is in flight
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1&na=1"));
+	ASSERT_TRUE(mServer.waitForRequests(2, 5000));
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1&na=2"));
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1&na=3"));
+	auto obtained = mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1&na=4"));
+
+	// then
+	ASSERT_EQ(obtained->getResponseCode(), 503);
+	ASSERT_GE(mForwarder->getNumRejectedBeacons(), uint64_t(1));
+}
+
+TEST_F(LocalForwarderTest, queuedBeaconsAreUploadedOnStop)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+	mClient->sendStatusRequest();
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1"));
+
+	// when
+	mForwarder->stop();
+
+	// then
+	ASSERT_EQ(mForwarder->getNumForwardedBeacons(), uint64_t(1));
+	ASSERT_EQ(mServer.getRequests().size(), size_t(2));
+}
+
+TEST_F(LocalForwarderTest, failedUploadsAreRetriedOnStop)
+{
+	// given
+	ASSERT_TRUE(mForwarder->start());
+	mClient->sendStatusRequest();
+	mServer.setResponse(503, "");
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1"));
+	ASSERT_TRUE(mServer.waitForRequests(2, 5000));
+
+	// when
+	auto& server = mServer;
+	std::thread recoveringServer([&server]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		server.setResponse(200, "type=m");
+	});
+	mForwarder->stop();
+	recoveringServer.join();
+
+	// then
+	ASSERT_EQ(mForwarder->getNumForwardedBeacons(), uint64_t(1));
+	ASSERT_EQ(mForwarder->getNumDroppedBeacons(), uint64_t(0));
+	ASSERT_EQ(mServer.getRequests().back().body, "vv=3&et=1");
+}
+
+TEST_F(LocalForwarderTest, queuedBeaconsAreDroppedOnceShutdownTimeoutExpires)
+{
+	// given
+	mForwarder = createForwarder(60000, 200);
+	ASSERT_TRUE(mForwarder->start());
+	mClient->sendStatusRequest();
+	mServer.setResponse(503, "");
+	mClient->sendBeaconRequest(core::UTF8String(), core::UTF8String("vv=3&et=1"));
+	ASSERT_TRUE(mServer.waitForRequests(2, 5000));
+
+	// when
+	auto start = std::chrono::steady_clock::now();
+	mForwarder->stop();
+
+	// then
+	ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5000));
+	ASSERT_GE(mServer.getRequests().size(), size_t(3));
+	ASSERT_EQ(mForwarder->getNumForwardedBeacons(), uint64_t(0));
+	ASSERT_EQ(mForwarder->getNumDroppedBeacons(), uint64_t(1));
+}
+
+TEST_F(LocalForwarderTest, clientReportsErrorIfForwarderIsNotRunning)
+{
+	// when
+	auto obtained = mClient->sendStatusRequest();
+
+	// then
+	ASSERT_EQ(obtained->getResponseCode(), std::numeric_limits<int32_t>::max());
+	ASSERT_TRUE(mServer.getRequests().empty());
+}
@@ -0,0 +1,360 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#ifndef _TEST_PROTOCOL_LOCALHTTPSERVER_H
+#define _TEST_PROTOCOL_LOCALHTTPSERVER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+#if defined(_WIN32) || defined(WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace test
+{
+	///
+	/// Minimal HTTP/1.1 server on the loopback interface standing in for the collector.
+	/// It records all requests, decompresses gzip encoded bodies and answers with a fixed response.
+	///
+	class LocalHTTPServer
+	{
+	public:
+
+		struct ReceivedRequest
+		{
+			std::string method;
+			std::string target;
+			std::map<std::string, std::string> headers; ///< header names in lower case
+			std::string body; ///< decompressed body
+		};
+
+		LocalHTTPServer()
+			: mListeningSocket(INVALID)
+			, mPort(0)
+			, mIsRunning(false)
+			, mResponseCode(200)
+			, mResponseBody("type=m")
+			, mNumConnections(0)
+			, mResponseDelay(0)
+			, mStatusResponseDelay(0)
+		{
+		}
+
+		~LocalHTTPServer()
+		{
+			stop();
+		}
+
+		bool start()
+		{
+			mListeningSocket = socket(AF_INET, SOCK_STREAM, 0);
+			sockaddr_in address;
+			memset(&address, 0, sizeof(address));
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			address.sin_port = 0;
+			socklen_t addressLength = sizeof(address);
+			if (mListeningSocket == INVALID
+				|| bind(mListeningSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+				|| listen(mListeningSocket, 16) != 0
+				|| getsockname(mListeningSocket, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0)
+			{
+				return false;
+			}
+			mPort = ntohs(address.sin_port);
+
+			mIsRunning = true;
+			mAcceptThread = std::thread(&LocalHTTPServer::acceptLoop, this);
+			return true;
+		}
+
+		void stop()
+		{
+			if (!mIsRunning.exchange(false))
+			{
+				return;
+			}
+			mAcceptThread.join();
+			for (auto& thread : mConnectionThreads)
+			{
+				thread.join();
+			}
+			closeSocket(mListeningSocket);
+		}
+
+		std::string getBaseURL() const
+		{
+			return "http://127.0.0.1:" + std::to_string(mPort) + "/mbeacon";
+		}
+
+		void setResponse(int32_t responseCode, const std::string& responseBody)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mResponseCode = responseCode;
+			mResponseBody = responseBody;
+		}
+
+		///
+		/// Delays the responses to requests carrying a body (i.e. beacons) to simulate a slow collector.
+		///
+		void setResponseDelay(int64_t delayMillis)
+		{
+			mResponseDelay = delayMillis;
+		}
+
+		///
+		/// Delays the responses to requests without a body (i.e. status and new session requests).
+		///
+		void setStatusResponseDelay(int64_t delayMillis)
+		{
+			mStatusResponseDelay = delayMillis;
+		}
+
+		std::vector<ReceivedRequest> getRequests()
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			return mRequests;
+		}
+
+		bool waitForRequests(size_t numRequests, int64_t timeoutMillis)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			return mCondition.wait_for(lock, std::chrono::milliseconds(timeoutMillis), [this, numRequests]() { return mRequests.size() >= numRequests; });
+		}
+
+		uint32_t getNumConnections() const
+		{
+			return mNumConnections;
+		}
+
+	private:
+
+#if defined(_WIN32) || defined(WIN32)
+		using Socket = SOCKET;
+		static constexpr Socket INVALID = INVALID_SOCKET;
+		static void closeSocket(Socket socket) { closesocket(socket); }
+#else
+		using Socket = int;
+		static constexpr Socket INVALID = -1;
+		static void closeSocket(Socket socket) { close(socket); }
+#endif
+
+		static bool waitReadable(Socket socket)
+		{
+			fd_set readSet;
+			FD_ZERO(&readSet);
+			FD_SET(socket, &readSet);
+			timeval timeout = { 0, 50000 };
+			return select(static_cast<int>(socket + 1), &readSet, nullptr, nullptr, &timeout) > 0;
+		}
+
+		void acceptLoop()
+		{
+			while (mIsRunning)
+			{
+				if (waitReadable(mListeningSocket))
+				{
+					auto connection = accept(mListeningSocket, nullptr, nullptr);
+					if (connection != INVALID)
+					{
+						mNumConnections++;
+						mConnectionThreads.push_back(std::thread(&LocalHTTPServer::handleConnection, this, connection));
+					}
+				}
+			}
+		}
+
+		bool receiveMore(Socket connection, std::string& buffer)
+		{
+			while (mIsRunning)
+			{
+				if (waitReadable(connection))
+				{
+					char chunk[4096];
+					auto received = recv(connection, chunk, sizeof(chunk), 0);
+					if (received <= 0)
+					{
+						return false;
+					}
+					buffer.append(chunk, static_cast<size_t>(received));
+					return true;
+				}
+			}
+			return false;
+		}
+
+		static void sendAll(Socket connection, const std::string& data)
+		{
+			size_t position = 0;
+			while (position < data.size())
+			{
+				auto sent = send(connection, data.data() + position, static_cast<int>(data.size() - position), 0);
+				if (sent <= 0)
+				{
+					return;
+				}
+				position += static_cast<size_t>(sent);
+			}
+		}
+
+		void handleConnection(Socket connection)
+		{
+			std::string buffer;
+			while (true)
+			{
+				// read the request head
+				size_t headEnd;
+				while ((headEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+				{
+					if (!receiveMore(connection, buffer))
+					{
+						closeSocket(connection);
+						return;
+					}
+				}
+
+				ReceivedRequest request;
+				auto head = buffer.substr(0, headEnd);
+				buffer.erase(0, headEnd + 4);
+
+				auto lineEnd = head.find("\r\n");
+				auto requestLine = head.substr(0, lineEnd);
+				auto firstSpace = requestLine.find(' ');
+				auto secondSpace = requestLine.find(' ', firstSpace + 1);
+				request.method = requestLine.substr(0, firstSpace);
+				request.target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+				while (lineEnd != std::string::npos)
+				{
+					auto nextLineEnd = head.find("\r\n", lineEnd + 2);
+					auto line = head.substr(lineEnd + 2, nextLineEnd == std::string::npos ? std::string::npos : nextLineEnd - lineEnd - 2);
+					auto colon = line.find(':');
+					if (colon != std::string::npos)
+					{
+						auto name = line.substr(0, colon);
+						std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+						auto value = line.substr(colon + 1);
+						value.erase(0, value.find_first_not_of(' '));
+						request.headers[name] = value;
+					}
+					lineEnd = nextLineEnd;
+				}
+
+				if (request.headers["expect"] == "100-continue")
+				{
+					sendAll(connection, "HTTP/1.1 100 Continue\r\n\r\n");
+				}
+
+				// read the request body
+				size_t contentLength = request.headers.count("content-length") ? std::stoul(request.headers["content-length"]) : 0;
+				while (buffer.size() < contentLength)
+				{
+					if (!receiveMore(connection, buffer))
+					{
+						closeSocket(connection);
+						return;
+					}
+				}
+				request.body = buffer.substr(0, contentLength);
+				buffer.erase(0, contentLength);
+				if (request.headers["content-encoding"] == "gzip")
+				{
+					request.body = gunzip(request.body);
+				}
+
+				if (!request.body.empty() && mResponseDelay > 0)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(mResponseDelay.load()));
+				}
+				else if (request.body.empty() && mStatusResponseDelay > 0)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(mStatusResponseDelay.load()));
+				}
+
+				std::string response;
+				{
+					std::lock_guard<std::mutex> lock(mMutex);
+					mRequests.push_back(request);
+					response = "HTTP/1.1 " + std::to_string(mResponseCode) + " Stand-In\r\n"
+						+ "Content-Length: " + std::to_string(mResponseBody.size()) + "\r\n\r\n"
+						+ mResponseBody;
+				}
+				mCondition.notify_all();
+				sendAll(connection, response);
+			}
+		}
+
+		static std::string gunzip(const std::string& data)
+		{
+			z_stream strm;
+			memset(&strm, 0, sizeof(strm));
+			strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+			strm.avail_in = static_cast<uInt>(data.size());
+			inflateInit2(&strm, 15 | 16);
+
+			std::string result;
+			unsigned char buffer[1024];
+			int res = Z_OK;
+			while (res == Z_OK)
+			{
+				strm.next_out = buffer;
+				strm.avail_out = sizeof(buffer);
+				res = inflate(&strm, Z_NO_FLUSH);
+				result.append(reinterpret_cast<const char*>(buffer), sizeof(buffer) - strm.avail_out);
+			}
+			inflateEnd(&strm);
+
+			return res == Z_STREAM_END ? result : std::string();
+		}
+
+		Socket mListeningSocket;
+		uint16_t mPort;
+		std::atomic<bool> mIsRunning;
+		std::thread mAcceptThread;
+		std::vector<std::thread> mConnectionThreads;
+
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		int32_t mResponseCode;
+		std::string mResponseBody;
+		std::vector<ReceivedRequest> mRequests;
+		std::atomic<uint32_t> mNumConnections;
+		std::atomic<int64_t> mResponseDelay;
+		std::atomic<int64_t> mStatusResponseDelay;
+	};
+}
+
+#endif
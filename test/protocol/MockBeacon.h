@@ -68,6 +68,7 @@ namespace test {
 		MOCK_METHOD3(reportValueInt32, void(int32_t, const core::UTF8String&, int32_t));
 		MOCK_METHOD3(reportValueDouble, void(int32_t, const core::UTF8String&, double));
 		MOCK_METHOD3(reportValueString, void(int32_t, const core::UTF8String&, const core::UTF8String&));
+		MOCK_METHOD3(reportValues, void(int32_t, const openkit::ReportedValue*, size_t));
 		MOCK_METHOD4(reportError, void(int32_t, const core::UTF8String&, int32_t, const core::UTF8String&));
 		MOCK_METHOD3(reportCrash, void(const core::UTF8String&, const core::UTF8String&, const core::UTF8String&));
 		MOCK_METHOD2(addWebRequest, void(int32_t, std::shared_ptr<core::WebRequestTracer>));
@@ -53,6 +53,8 @@ namespace test {
 		MOCK_METHOD2(sendBeaconRequestRawPtrProxy, protocol::StatusResponse*(const core::UTF8String&, const core::UTF8String&));
 
 		MOCK_METHOD0(sendNewSessionRequestRawPtrProxy, protocol::StatusResponse*());
+
+		MOCK_CONST_METHOD0(getLastRequestThrottledTime, int64_t());
 	private:
 		std::shared_ptr<configuration::HTTPClientConfiguration> mHTTPClientConfiguration;
 	};
@@ -614,3 +614,30 @@ TEST_F(StatusResponseTest, someTypicalStatusResponse)
 	EXPECT_TRUE(statusResponse.isCaptureErrors());
 	EXPECT_FALSE(statusResponse.isCaptureCrashes());
 }
+
+TEST_F(StatusResponseTest, invalidValueKeepsDefault)
+{
+	UTF8String s("cp=0&si=abc&id=7");
+	uint32_t responseCode = 200;
+	StatusResponse statusResponse = StatusResponse(logger, s, responseCode, Response::ResponseHeaders());
+
+	EXPECT_FALSE(statusResponse.isCapture());
+	EXPECT_EQ(-1, statusResponse.getSendInterval());
+	EXPECT_EQ(7, statusResponse.getServerID());
+}
+
+TEST_F(StatusResponseTest, typicalResponseIsParsed)
+{
+	UTF8String s("type=m&si=120&bn=MyName&id=5&bl=150&er=0&cr=0&mp=2&cp=1");
+	uint32_t responseCode = 200;
+	StatusResponse statusResponse = StatusResponse(logger, s, responseCode, Response::ResponseHeaders());
+
+	EXPECT_TRUE(statusResponse.isCapture());
+	EXPECT_EQ(120000, statusResponse.getSendInterval());
+	EXPECT_TRUE(statusResponse.getMonitorName().equals("MyName"));
+	EXPECT_EQ(5, statusResponse.getServerID());
+	EXPECT_EQ(150, statusResponse.getMaxBeaconSize());
+	EXPECT_FALSE(statusResponse.isCaptureErrors());
+	EXPECT_FALSE(statusResponse.isCaptureCrashes());
+	EXPECT_EQ(2, statusResponse.getMultiplicity());
+}
@@ -0,0 +1,73 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+
+#include "protocol/TransferDeadline.h"
+
+using namespace protocol;
+
+TEST(TransferDeadlineTest, aDefaultConstructedDeadlineIsNotSet)
+{
+	// given
+	TransferDeadline target;
+
+	// then
+	ASSERT_FALSE(target.isSet());
+	ASSERT_FALSE(target.isExpired());
+	ASSERT_EQ(target.getRemainingMilliseconds(), int64_t(-1));
+}
+
+TEST(TransferDeadlineTest, aDeadlineInTheFutureIsNotExpired)
+{
+	// given
+	TransferDeadline target;
+
+	// when
+	target.expireAfter(60 * 1000);
+
+	// then
+	ASSERT_TRUE(target.isSet());
+	ASSERT_FALSE(target.isExpired());
+	ASSERT_GT(target.getRemainingMilliseconds(), int64_t(0));
+	ASSERT_LE(target.getRemainingMilliseconds(), int64_t(60 * 1000));
+}
+
+TEST(TransferDeadlineTest, aDeadlineWithoutTimeoutIsExpiredImmediately)
+{
+	// given
+	TransferDeadline target;
+
+	// when
+	target.expireAfter(0);
+
+	// then
+	ASSERT_TRUE(target.isExpired());
+	ASSERT_EQ(target.getRemainingMilliseconds(), int64_t(0));
+}
+
+TEST(TransferDeadlineTest, aNegativeTimeoutIsTreatedAsZero)
+{
+	// given
+	TransferDeadline target;
+
+	// when
+	target.expireAfter(-1000);
+
+	// then
+	ASSERT_TRUE(target.isExpired());
+	ASSERT_EQ(target.getRemainingMilliseconds(), int64_t(0));
+}
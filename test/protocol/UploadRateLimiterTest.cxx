@@ -0,0 +1,159 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "protocol/UploadRateLimiter.h"
+
+#include "../providers/MockTimingProvider.h"
+
+using namespace protocol;
+
+class UploadRateLimiterTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mCurrentTime = 0;
+		mMockTimingProvider = std::make_shared<testing::NiceMock<test::MockTimingProvider>>();
+		ON_CALL(*mMockTimingProvider, provideTimestampInMilliseconds())
+			.WillByDefault(testing::Invoke([this]() { return mCurrentTime; }));
+		// sleeping advances the fake clock
+		ON_CALL(*mMockTimingProvider, sleep(testing::_))
+			.WillByDefault(testing::Invoke([this](int64_t milliseconds) { mCurrentTime += milliseconds; }));
+	}
+
+	int64_t mCurrentTime;
+	std::shared_ptr<testing::NiceMock<test::MockTimingProvider>> mMockTimingProvider;
+};
+
+TEST_F(UploadRateLimiterTest, uploadsAreNotLimitedIfRateIsNotPositive)
+{
+	// given
+	UploadRateLimiter target(nullptr, -1, -1);
+
+	// then
+	ASSERT_FALSE(target.isEnabled());
+	ASSERT_FALSE(target.isThrottled());
+	ASSERT_EQ(target.acquire(1000000), size_t(1000000));
+	ASSERT_EQ(target.getWaitTime(1000000), int64_t(0));
+	ASSERT_EQ(target.getThrottleState().totalUploadedBytes, int64_t(1000000));
+}
+
+TEST_F(UploadRateLimiterTest, burstSizeDefaultsToOneSecondOfUploadRate)
+{
+	// given
+	UploadRateLimiter target(mMockTimingProvider, 1000, 0);
+
+	// then
+	ASSERT_EQ(target.getBurstSize(), int64_t(1000));
+}
+
+TEST_F(UploadRateLimiterTest, burstIsGrantedWithoutDelay)
+{
+	// given
+	UploadRateLimiter target(mMockTimingProvider, 1000, 2000);
+
+	// expect
+	EXPECT_CALL(*mMockTimingProvider, sleep(testing::_))
+		.Times(0);
+
+	// when
+	auto obtained = target.acquire(2000);
+
+	// then
+	ASSERT_EQ(obtained, size_t(2000));
+	ASSERT_TRUE(target.isThrottled());
+}
+
+TEST_F(UploadRateLimiterTest, acquireGrantsAtMostTheAvailableBytes)
+{
+	// given
+	UploadRateLimiter target(mMockTimingProvider, 1000, 500);
+
+	// when
+	auto obtained = target.acquire(2000);
+
+	// then
+	ASSERT_EQ(obtained, size_t(500));
+}
+
+TEST_F(UploadRateLimiterTest, acquireWaitsForBucketToBeRefilled)
+{
+	// given
+	UploadRateLimiter target(mMockTimingProvider, 1000, 1000);
+	target.acquire(1000);
+
+	// when, minimum grant is 1/20th of a second
+	auto obtained = target.acquire(1000);
+
+	// then
+	ASSERT_EQ(obtained, size_t(50));
+	ASSERT_EQ(mCurrentTime, int64_t(50));
+
+	auto state = target.getThrottleState();
+	ASSERT_TRUE(state.isEnabled);
+	ASSERT_EQ(state.totalThrottledTimeInMilliseconds, int64_t(50));
+	ASSERT_EQ(state.totalUploadedBytes, int64_t(1050));
+}
+
+TEST_F(UploadRateLimiterTest, acquireReportsTheTimeWaitedForTheBucketToBeRefilled)
+{
+	// given
+	UploadRateLimiter target(mMockTimingProvider, 1000, 1000);
+	int64_t throttledTime = -1;
+	target.acquire(1000, throttledTime);
+	ASSERT_EQ(throttledTime, int64_t(0));
+
+	// when
+	target.acquire(1000, throttledTime);
+
+	// then
+	ASSERT_EQ(throttledTime, int64_t(50));
+}
+
+TEST_F(UploadRateLimiterTest, bucketIsRefilledOverTimeUpToBurstSize)
+{
+	// given
+	UploadRateLimiter target(mMockTimingProvider, 1000, 1000);
+	target.acquire(1000);
+	ASSERT_TRUE(target.isThrottled());
+
+	// when
+	mCurrentTime += 500;
+
+	// then
+	ASSERT_FALSE(target.isThrottled());
+	ASSERT_EQ(target.getThrottleState().availableBytes, int64_t(500));
+
+	// and when
+	mCurrentTime += 5000;
+
+	// then
+	ASSERT_EQ(target.getThrottleState().availableBytes, int64_t(1000));
+}
+
+TEST_F(UploadRateLimiterTest, waitTimeIsCalculatedFromMissingBytes)
+{
+	// given
+	UploadRateLimiter target(mMockTimingProvider, 1000, 1000);
+	target.acquire(600);
+
+	// then
+	ASSERT_EQ(target.getWaitTime(400), int64_t(0));
+	ASSERT_EQ(target.getWaitTime(1400), int64_t(1000));
+}
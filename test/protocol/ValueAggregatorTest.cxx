@@ -0,0 +1,207 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "protocol/ValueAggregator.h"
+
+#include <string>
+#include <vector>
+
+using namespace protocol;
+
+class ValueAggregatorTest : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+		mSequenceNumber = 0;
+	}
+
+	std::vector<ValueAggregator::Aggregate> add(ValueAggregator& target, int32_t actionID, const char* name, double value, int64_t timestamp)
+	{
+		return target.add(actionID, EventType::VALUE_DOUBLE, core::UTF8String(name), value, timestamp, 1, [this]() { return ++mSequenceNumber; });
+	}
+
+	int32_t mSequenceNumber;
+};
+
+TEST_F(ValueAggregatorTest, valuesWithSameActionAndNameAreFoldedTogether)
+{
+	// given
+	ValueAggregator target(0);
+
+	// when
+	add(target, 1, "value", 3.0, 10);
+	add(target, 1, "value", -1.0, 20);
+	add(target, 1, "value", 4.0, 30);
+
+	// then
+	auto obtained = target.removeAll();
+	ASSERT_EQ(obtained.size(), size_t(1));
+	ASSERT_EQ(obtained[0].actionID, 1);
+	ASSERT_EQ(obtained[0].name, core::UTF8String("value"));
+	ASSERT_EQ(obtained[0].count, 3);
+	ASSERT_EQ(obtained[0].min, -1.0);
+	ASSERT_EQ(obtained[0].max, 4.0);
+	ASSERT_EQ(obtained[0].sum, 6.0);
+	ASSERT_EQ(obtained[0].last, 4.0);
+	ASSERT_EQ(obtained[0].timestamp, 10);
+	ASSERT_EQ(obtained[0].sequenceNumber, 1);
+	ASSERT_EQ(mSequenceNumber, 1);
+}
+
+TEST_F(ValueAggregatorTest, valuesOfDifferentTypesAreNotFoldedTogether)
+{
+	// given
+	ValueAggregator target(0);
+
+	// when
+	target.add(1, EventType::VALUE_INT, core::UTF8String("value"), 1, 0, 1, [this]() { return ++mSequenceNumber; });
+	target.add(1, EventType::VALUE_DOUBLE, core::UTF8String("value"), 1, 0, 1, [this]() { return ++mSequenceNumber; });
+
+	// then
+	ASSERT_EQ(target.size(), size_t(2));
+}
+
+TEST_F(ValueAggregatorTest, removeActionOnlyRemovesAggregatesOfThatAction)
+{
+	// given
+	ValueAggregator target(0);
+	add(target, 1, "b", 1.0, 0);
+	add(target, 2, "a", 1.0, 0);
+	add(target, 1, "a", 1.0, 0);
+
+	// when
+	auto obtained = target.removeAction(1);
+
+	// then aggregates are returned in the order they were started
+	ASSERT_EQ(obtained.size(), size_t(2));
+	ASSERT_EQ(obtained[0].name, core::UTF8String("b"));
+	ASSERT_EQ(obtained[1].name, core::UTF8String("a"));
+	ASSERT_EQ(target.size(), size_t(1));
+	ASSERT_EQ(target.removeAction(2).size(), size_t(1));
+}
+
+TEST_F(ValueAggregatorTest, aggregatesAreNotExpiredWithoutFlushInterval)
+{
+	// given
+	ValueAggregator target(0);
+	add(target, 1, "value", 1.0, 0);
+
+	// when
+	auto obtained = target.removeExpired(1000000);
+
+	// then
+	ASSERT_TRUE(obtained.empty());
+	ASSERT_EQ(target.size(), size_t(1));
+}
+
+TEST_F(ValueAggregatorTest, addReturnsAggregatesWhoseFlushIntervalExpired)
+{
+	// given
+	ValueAggregator target(100);
+	add(target, 1, "first", 1.0, 0);
+	add(target, 1, "second", 1.0, 50);
+
+	// when
+	auto obtained = add(target, 1, "first", 2.0, 100);
+
+	// then
+	ASSERT_EQ(obtained.size(), size_t(1));
+	ASSERT_EQ(obtained[0].name, core::UTF8String("first"));
+	ASSERT_EQ(obtained[0].count, 2);
+	ASSERT_EQ(target.size(), size_t(1));
+
+	// and when the second one expires
+	obtained = target.removeExpired(150);
+
+	// then
+	ASSERT_EQ(obtained.size(), size_t(1));
+	ASSERT_EQ(obtained[0].name, core::UTF8String("second"));
+	ASSERT_EQ(target.size(), size_t(0));
+}
+
+TEST_F(ValueAggregatorTest, tableGrowsBeyondInitialCapacity)
+{
+	// given
+	ValueAggregator target(0);
+
+	// when
+	for (int32_t i = 0; i < 1000; i++)
+	{
+		add(target, i % 10, std::to_string(i / 10).c_str(), i, 0);
+		add(target, i % 10, std::to_string(i / 10).c_str(), i, 0);
+	}
+
+	// then
+	ASSERT_EQ(target.size(), size_t(1000));
+	auto obtained = target.removeAction(3);
+	ASSERT_EQ(obtained.size(), size_t(100));
+	for (const auto& aggregate : obtained)
+	{
+		ASSERT_EQ(aggregate.count, 2);
+	}
+	ASSERT_EQ(target.size(), size_t(900));
+}
+
+TEST_F(ValueAggregatorTest, remainingAggregatesAreFoundAfterRemovingAnAction)
+{
+	// given aggregates of two actions with interleaved probe sequences
+	ValueAggregator target(0);
+	for (int32_t i = 0; i < 100; i++)
+	{
+		add(target, i % 2, std::to_string(i).c_str(), i, 0);
+	}
+
+	// when
+	auto obtained = target.removeAction(0);
+
+	// then the aggregates of the other action are still folded into
+	ASSERT_EQ(obtained.size(), size_t(50));
+	ASSERT_EQ(target.size(), size_t(50));
+	for (int32_t i = 1; i < 100; i += 2)
+	{
+		add(target, 1, std::to_string(i).c_str(), i, 0);
+	}
+	ASSERT_EQ(target.size(), size_t(50));
+	obtained = target.removeAction(1);
+	ASSERT_EQ(obtained.size(), size_t(50));
+	for (const auto& aggregate : obtained)
+	{
+		ASSERT_EQ(aggregate.count, 2);
+	}
+	ASSERT_EQ(target.size(), size_t(0));
+}
+
+TEST_F(ValueAggregatorTest, expiredAggregatesAreNoLongerRemovedWithTheirAction)
+{
+	// given
+	ValueAggregator target(100);
+	add(target, 1, "first", 1.0, 0);
+	add(target, 1, "second", 1.0, 50);
+	ASSERT_EQ(target.removeExpired(100).size(), size_t(1));
+
+	// when
+	auto obtained = target.removeAction(1);
+
+	// then
+	ASSERT_EQ(obtained.size(), size_t(1));
+	ASSERT_EQ(obtained[0].name, core::UTF8String("second"));
+	ASSERT_TRUE(target.removeAction(1).empty());
+}
@@ -0,0 +1,52 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#include "providers/CoarseTimingProvider.h"
+#include "providers/DefaultTimingProvider.h"
+#include <gtest/gtest.h>
+
+using namespace providers;
+
+class CoarseTimingProviderTest : public testing::Test
+{
+protected:
+	CoarseTimingProvider provider;
+};
+
+TEST_F(CoarseTimingProviderTest, timestampIsCloseToSystemClock)
+{
+	//when
+	auto before = DefaultTimingProvider::currentTimestampInMilliseconds();
+	auto timestamp = provider.provideTimestampInMilliseconds();
+	auto after = DefaultTimingProvider::currentTimestampInMilliseconds();
+
+	//verify the coarse clock lags behind by at most a few timer ticks
+	ASSERT_GE(timestamp, before - 100);
+	ASSERT_LE(timestamp, after);
+}
+
+TEST_F(CoarseTimingProviderTest, timestampAdvancesAfterSleep)
+{
+	//given
+	auto timestamp = CoarseTimingProvider::currentTimestampInMilliseconds();
+
+	//when
+	provider.sleep(50);
+
+	//verify
+	ASSERT_GE(CoarseTimingProvider::currentTimestampInMilliseconds(), timestamp + 40);
+}
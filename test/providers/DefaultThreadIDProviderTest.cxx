@@ -75,4 +75,18 @@ TEST_F(DefaultThreadIDProviderTest, convertNativeThreadIDToPositiveIntegerVerify
 
 	//verify
 	ASSERT_EQ(result, 0);
-}
\ No newline at end of file
+}
+
+TEST_F(DefaultThreadIDProviderTest, currentThreadIDIsCachedPerThread)
+{
+	//when
+	int32_t threadID = DefaultThreadIDProvider::currentThreadID();
+	int32_t otherThreadID = threadID;
+	std::thread thread([&otherThreadID]() { otherThreadID = DefaultThreadIDProvider::currentThreadID(); });
+	thread.join();
+
+	//verify
+	ASSERT_EQ(threadID, provider.getThreadID());
+	ASSERT_EQ(threadID, DefaultThreadIDProvider::currentThreadID());
+	ASSERT_NE(threadID, otherThreadID);
+}
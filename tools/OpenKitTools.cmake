@@ -0,0 +1,60 @@
+# Copyright 2018-2019 Dynatrace LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+SET(OPENKIT_FORWARDER_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/forwarder/src/openkit-forwarder.cxx
+)
+
+include(CompilerConfiguration)
+fix_compiler_flags()
+
+function(_build_tool_internal target)
+    find_package(ZLIB)
+    find_package(CURL)
+
+    # tools are built on top of OpenKit internals, which are only accessible when linking the static library
+    set(TOOL_INCLUDE_DIRS
+        ${ZLIB_INCLUDE_DIR}
+        ${CURL_INCLUDE_DIR}
+        ${OpenKit_SOURCE_DIR}/include
+        ${OpenKit_SOURCE_DIR}/src
+        ${OpenKit_BINARY_DIR}/include
+    )
+
+    set(TOOL_LIBS
+        OpenKit
+        ${ZLIB_LIBRARY}
+        ${CURL_LIBRARY}
+    )
+
+    include(CompilerConfiguration)
+    include(BuildFunctions)
+
+    open_kit_build_executable("${target}" "${TOOL_INCLUDE_DIRS}" "${TOOL_LIBS}" ${ARGN})
+    enforce_cxx11_standard("${target}")
+    target_compile_definitions(${target} PRIVATE -DCURL_STATICLIB -DOPENKIT_STATIC_DEFINE)
+    set_target_properties(${target} PROPERTIES FOLDER Tools)
+endfunction()
+
+function(build_open_kit_tools)
+    if (BUILD_SHARED_LIBS)
+        message(INFO "OpenKit is built as shared library - skip building OpenKit tools...")
+        return()
+    endif()
+
+    message("Configuring OpenKit  tools... ")
+
+    _build_tool_internal(openkit-forwarder ${OPENKIT_FORWARDER_SOURCES})
+    source_group("Source Files" FILES ${OPENKIT_FORWARDER_SOURCES})
+endfunction()
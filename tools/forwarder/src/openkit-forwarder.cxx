@@ -0,0 +1,137 @@
+/**
+* Copyright 2018-2019 Dynatrace LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+/// reference implementation of a local forwarder daemon
+/// it receives the requests of all OpenKit instances on the host which are configured
+/// with AbstractOpenKitBuilder::withLocalForwarder and uploads them over shared connections
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "configuration/HTTPClientConfiguration.h"
+#include "core/util/DefaultLogger.h"
+#include "protocol/HTTPClient.h"
+#include "protocol/LocalForwarder.h"
+
+static std::atomic<bool> gIsStopRequested(false);
+
+static void onSignal(int)
+{
+	gIsStopRequested = true;
+}
+
+static void printUsage()
+{
+	std::cerr << "Usage: openkit-forwarder --socket <path> --endpoint <beacon URL> [options]" << std::endl
+		<< "Options:" << std::endl
+		<< "  --max-queued-beacons <n>  beacons waiting for upload before new ones are rejected (default: "
+		<< protocol::LocalForwarder::DEFAULT_MAX_QUEUED_BEACONS << ")" << std::endl
+		<< "  --max-batch-size <n>      beacons uploaded in one batch (default: "
+		<< protocol::LocalForwarder::DEFAULT_MAX_BATCH_SIZE << ")" << std::endl
+		<< "  --shutdown-timeout <ms>   time failed uploads are retried when stopping (default: "
+		<< protocol::LocalForwarder::DEFAULT_SHUTDOWN_TIMEOUT << ")" << std::endl
+		<< "  --verbose                 enable debug output" << std::endl;
+}
+
+int32_t main(int32_t argc, char** argv)
+{
+	std::string socketPath;
+	std::string endpointURL;
+	size_t maxQueuedBeacons = protocol::LocalForwarder::DEFAULT_MAX_QUEUED_BEACONS;
+	size_t maxBatchSize = protocol::LocalForwarder::DEFAULT_MAX_BATCH_SIZE;
+	int64_t shutdownTimeout = protocol::LocalForwarder::DEFAULT_SHUTDOWN_TIMEOUT;
+	auto logLevel = openkit::LogLevel::LOG_LEVEL_INFO;
+
+	for (int32_t i = 1; i < argc; i++)
+	{
+		std::string argument(argv[i]);
+		bool hasValue = i + 1 < argc;
+		if (argument == "--socket" && hasValue)
+		{
+			socketPath = argv[++i];
+		}
+		else if (argument == "--endpoint" && hasValue)
+		{
+			endpointURL = argv[++i];
+		}
+		else if (argument == "--max-queued-beacons" && hasValue)
+		{
+			maxQueuedBeacons = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (argument == "--max-batch-size" && hasValue)
+		{
+			maxBatchSize = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (argument == "--shutdown-timeout" && hasValue)
+		{
+			shutdownTimeout = static_cast<int64_t>(std::strtoll(argv[++i], nullptr, 10));
+		}
+		else if (argument == "--verbose")
+		{
+			logLevel = openkit::LogLevel::LOG_LEVEL_DEBUG;
+		}
+		else
+		{
+			printUsage();
+			return -1;
+		}
+	}
+
+	if (socketPath.empty() || endpointURL.empty())
+	{
+		printUsage();
+		return -1;
+	}
+
+	protocol::HTTPClient::globalInit();
+
+	auto logger = std::make_shared<core::util::DefaultLogger>(logLevel);
+	// the query string of each request carries the server and application ID of the sending process
+	auto configuration = std::make_shared<configuration::HTTPClientConfiguration>(core::UTF8String(endpointURL.c_str()), 1, core::UTF8String());
+
+	int32_t exitCode = 0;
+	{
+		protocol::LocalForwarder forwarder(logger, configuration, socketPath, maxQueuedBeacons, maxBatchSize, shutdownTimeout);
+		if (forwarder.start())
+		{
+			std::signal(SIGINT, onSignal);
+			std::signal(SIGTERM, onSignal);
+			while (!gIsStopRequested)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+
+			forwarder.stop();
+			logger->info("openkit-forwarder - forwarded %llu beacons, rejected %llu, dropped %llu",
+				static_cast<unsigned long long>(forwarder.getNumForwardedBeacons()),
+				static_cast<unsigned long long>(forwarder.getNumRejectedBeacons()),
+				static_cast<unsigned long long>(forwarder.getNumDroppedBeacons()));
+		}
+		else
+		{
+			exitCode = -1;
+		}
+	}
+
+	protocol::HTTPClient::globalDestroy();
+	return exitCode;
+}